@@ -153,6 +153,21 @@ public:
         return mFile.getCurrentOffset();
     }
 
+    /*!
+     *  Read exactly len bytes starting at 'offset' from the beginning of
+     *  the file.  This doesn't use the stream's position, so several
+     *  threads may call it at once.
+     *
+     *  \param offset The offset to read from
+     *  \param buffer Buffer to read into
+     *  \param len The number of bytes to read
+     *  \throw sys::SystemException if the file ends first
+     */
+    void readAt(sys::Off_T offset, void* buffer, size_t len) const
+    {
+        mFile.readAt(offset, buffer, len);
+    }
+
     //!  Close the file
     void close()
     {
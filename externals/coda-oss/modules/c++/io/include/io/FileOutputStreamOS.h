@@ -105,6 +105,20 @@ public:
 
     sys::Off_T tell();
 
+    /*!
+     *  Write len bytes starting at 'offset' from the beginning of the file.
+     *  This doesn't use the stream's position, so threads writing different
+     *  parts of the file may call it at once.
+     *
+     *  \param offset The offset to write to
+     *  \param buffer The bytes to write
+     *  \param len The number of bytes to write
+     */
+    void writeAt(sys::Off_T offset, const void* buffer, size_t len)
+    {
+        mFile.writeAt(offset, buffer, len);
+    }
+
     using OutputStream::write;
 
     /*!
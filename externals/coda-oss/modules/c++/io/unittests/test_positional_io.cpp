@@ -0,0 +1,160 @@
+/* =========================================================================
+ * This file is part of io-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * io-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+
+#include <sys/Conf.h>
+#include <sys/Thread.h>
+#include <mem/SharedPtr.h>
+#include <io/FileInputStream.h>
+#include <io/FileOutputStream.h>
+#include <io/TempFile.h>
+#include "TestCase.h"
+
+namespace
+{
+const size_t CHUNK_SIZE = 4096;
+const size_t NUM_CHUNKS = 16;
+
+sys::ubyte valueAt(size_t offset)
+{
+    return static_cast<sys::ubyte>((offset * 7) ^ (offset >> 8));
+}
+
+void writeChunksOutOfOrder(const std::string& pathname)
+{
+    io::FileOutputStream output(pathname);
+    std::vector<sys::ubyte> chunk(CHUNK_SIZE);
+    for (size_t ii = NUM_CHUNKS; ii > 0; --ii)
+    {
+        const size_t offset = (ii - 1) * CHUNK_SIZE;
+        for (size_t jj = 0; jj < CHUNK_SIZE; ++jj)
+        {
+            chunk[jj] = valueAt(offset + jj);
+        }
+        output.writeAt(offset, &chunk[0], chunk.size());
+    }
+    output.close();
+}
+
+class ReadChunks : public sys::Runnable
+{
+public:
+    ReadChunks(const io::FileInputStream& input,
+               size_t firstChunk,
+               size_t chunkStride,
+               std::vector<sys::ubyte>& contents) :
+        mInput(input),
+        mFirstChunk(firstChunk),
+        mChunkStride(chunkStride),
+        mContents(contents)
+    {
+    }
+
+    virtual void run()
+    {
+        for (size_t ii = mFirstChunk; ii < NUM_CHUNKS; ii += mChunkStride)
+        {
+            const size_t offset = ii * CHUNK_SIZE;
+            mInput.readAt(offset, &mContents[offset], CHUNK_SIZE);
+        }
+    }
+
+private:
+    const io::FileInputStream& mInput;
+    const size_t mFirstChunk;
+    const size_t mChunkStride;
+    std::vector<sys::ubyte>& mContents;
+};
+
+TEST_CASE(testWriteAt)
+{
+    const io::TempFile tempFile;
+    writeChunksOutOfOrder(tempFile.pathname());
+
+    io::FileInputStream input(tempFile.pathname());
+    TEST_ASSERT_EQ(input.available(),
+                   static_cast<sys::Off_T>(NUM_CHUNKS * CHUNK_SIZE));
+    std::vector<sys::ubyte> contents(NUM_CHUNKS * CHUNK_SIZE);
+    input.read(&contents[0], contents.size(), true);
+    for (size_t ii = 0; ii < contents.size(); ++ii)
+    {
+        TEST_ASSERT_EQ(contents[ii], valueAt(ii));
+    }
+}
+
+TEST_CASE(testReadAt)
+{
+    const io::TempFile tempFile;
+    writeChunksOutOfOrder(tempFile.pathname());
+    io::FileInputStream input(tempFile.pathname());
+
+    // Positional reads leave the stream where it was
+    input.seek(10, io::Seekable::START);
+    std::vector<sys::ubyte> buffer(100);
+    input.readAt(CHUNK_SIZE - 50, &buffer[0], buffer.size());
+    for (size_t ii = 0; ii < buffer.size(); ++ii)
+    {
+        TEST_ASSERT_EQ(buffer[ii], valueAt(CHUNK_SIZE - 50 + ii));
+    }
+    TEST_ASSERT_EQ(input.tell(), 10);
+
+    // Reading past the end fails rather than returning less
+    TEST_EXCEPTION(input.readAt(NUM_CHUNKS * CHUNK_SIZE - 50,
+                                &buffer[0],
+                                buffer.size()));
+}
+
+TEST_CASE(testConcurrentReadAt)
+{
+    const io::TempFile tempFile;
+    writeChunksOutOfOrder(tempFile.pathname());
+    const io::FileInputStream input(tempFile.pathname());
+
+    const size_t numThreads = 4;
+    std::vector<sys::ubyte> contents(NUM_CHUNKS * CHUNK_SIZE);
+    std::vector<mem::SharedPtr<sys::Thread> > threads;
+    for (size_t ii = 0; ii < numThreads; ++ii)
+    {
+        threads.push_back(mem::SharedPtr<sys::Thread>(new sys::Thread(
+                new ReadChunks(input, ii, numThreads, contents))));
+        threads.back()->start();
+    }
+    for (size_t ii = 0; ii < threads.size(); ++ii)
+    {
+        threads[ii]->join();
+    }
+
+    for (size_t ii = 0; ii < contents.size(); ++ii)
+    {
+        TEST_ASSERT_EQ(contents[ii], valueAt(ii));
+    }
+}
+}
+
+int main(int, char**)
+{
+    TEST_CHECK(testWriteAt);
+    TEST_CHECK(testReadAt);
+    TEST_CHECK(testConcurrentReadAt);
+    return 0;
+}
@@ -0,0 +1,97 @@
+/* =========================================================================
+ * This file is part of sys-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * sys-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __SYS_BYTE_SWAP_H__
+#define __SYS_BYTE_SWAP_H__
+
+#include <stddef.h>
+
+namespace sys
+{
+/*!
+ *  \struct ByteSwap
+ *  \tparam ElemSize Number of bytes in each element
+ *  \brief Reverses the bytes of every element in a buffer
+ *
+ *  2, 4, and 8 byte elements are specialized to use the CPU's byte swap
+ *  instruction, and SSSE3 or AVX2 shuffles when the CPU supports them.
+ *  Which one is used is decided once at runtime.  Other sizes swap a byte
+ *  at a time.  sys::byteSwap() picks the right one for its elemSize.
+ */
+template <size_t ElemSize>
+struct ByteSwap
+{
+    //! Swaps 'numElems' elements of 'buffer' in place
+    static void swap(void* buffer, size_t numElems)
+    {
+        swap(buffer, numElems, buffer);
+    }
+
+    /*!
+     *  Swaps 'numElems' elements of 'buffer' into 'outputBuffer'.  The
+     *  buffers must either be the same or not overlap.
+     */
+    static void swap(const void* buffer, size_t numElems, void* outputBuffer)
+    {
+        const unsigned char* in = static_cast<const unsigned char*>(buffer);
+        unsigned char* out = static_cast<unsigned char*>(outputBuffer);
+
+        for (size_t ii = 0; ii < numElems;
+             ++ii, in += ElemSize, out += ElemSize)
+        {
+            for (size_t jj = 0; jj < ElemSize / 2; ++jj)
+            {
+                const unsigned char first = in[jj];
+                out[jj] = in[ElemSize - 1 - jj];
+                out[ElemSize - 1 - jj] = first;
+            }
+            if (ElemSize % 2 != 0)
+            {
+                out[ElemSize / 2] = in[ElemSize / 2];
+            }
+        }
+    }
+};
+
+template <>
+struct ByteSwap<2>
+{
+    static void swap(void* buffer, size_t numElems);
+    static void swap(const void* buffer, size_t numElems, void* outputBuffer);
+};
+
+template <>
+struct ByteSwap<4>
+{
+    static void swap(void* buffer, size_t numElems);
+    static void swap(const void* buffer, size_t numElems, void* outputBuffer);
+};
+
+template <>
+struct ByteSwap<8>
+{
+    static void swap(void* buffer, size_t numElems);
+    static void swap(const void* buffer, size_t numElems, void* outputBuffer);
+};
+}
+
+#endif
@@ -45,6 +45,7 @@
 
 #include <memory>
 #include "str/Format.h"
+#include "sys/ByteSwap.h"
 #include "sys/TimeStamp.h"
 
 
@@ -200,7 +201,8 @@ namespace sys
    /*!
      *  Swap bytes in-place.  Note that a complex pixel
      *  is equivalent to two floats so elemSize and numElems
-     *  must be adjusted accordingly.
+     *  must be adjusted accordingly.  2, 4, and 8 byte elements are
+     *  swapped by sys::ByteSwap, which vectorizes them.
      *
      *  \param [inout] buffer to transform
      *  \param elemSize
@@ -214,6 +216,19 @@ namespace sys
         if (!bufferPtr || elemSize < 2 || !numElems)
             return;
 
+        switch (elemSize)
+        {
+        case 2:
+            ByteSwap<2>::swap(buffer, numElems);
+            return;
+        case 4:
+            ByteSwap<4>::swap(buffer, numElems);
+            return;
+        case 8:
+            ByteSwap<8>::swap(buffer, numElems);
+            return;
+        }
+
         unsigned short half = elemSize >> 1;
         size_t offset = 0, innerOff = 0, innerSwap = 0;
 
@@ -232,7 +247,8 @@ namespace sys
     /*!
      *  Swap bytes into output buffer.  Note that a complex pixel
      *  is equivalent to two floats so elemSize and numElems
-     *  must be adjusted accordingly.
+     *  must be adjusted accordingly.  2, 4, and 8 byte elements are
+     *  swapped by sys::ByteSwap, which vectorizes them.
      *
      *  \param buffer to transform
      *  \param elemSize
@@ -252,6 +268,19 @@ namespace sys
             return;
         }
 
+        switch (elemSize)
+        {
+        case 2:
+            ByteSwap<2>::swap(buffer, numElems, outputBuffer);
+            return;
+        case 4:
+            ByteSwap<4>::swap(buffer, numElems, outputBuffer);
+            return;
+        case 8:
+            ByteSwap<8>::swap(buffer, numElems, outputBuffer);
+            return;
+        }
+
         const unsigned short half = elemSize >> 1;
         size_t offset = 0;
 
@@ -265,6 +294,12 @@ namespace sys
                 outputBufferPtr[innerOff] = bufferPtr[innerSwap];
                 outputBufferPtr[innerSwap] = bufferPtr[innerOff];
             }
+
+            // The middle byte of an odd-sized element stays put
+            if (elemSize % 2 != 0)
+            {
+                outputBufferPtr[offset + half] = bufferPtr[offset + half];
+            }
         }
     }
 
@@ -193,6 +193,35 @@ public:
     void writeFrom(const void* buffer,
                    size_t size);
 
+    /*!
+     *  Read 'size' bytes starting at 'offset' from the beginning of the
+     *  file.  This doesn't use the current offset, so several threads can
+     *  read from the same File at once.  On Windows, the current offset is
+     *  left just past the bytes read; elsewhere it's unchanged.
+     *  Blocks.
+     *  If size is 0, no OS level read operation occurs.
+     *  If the file ends before 'size' bytes, an exception is thrown.
+     *
+     *  \param offset The offset to read from
+     *  \param buffer The buffer to put to
+     *  \param size The number of bytes
+     */
+    void readAt(sys::Off_T offset, void* buffer, size_t size) const;
+
+    /*!
+     *  Write 'size' bytes from a buffer starting at 'offset' from the
+     *  beginning of the file.  Like readAt(), this doesn't use the current
+     *  offset, so threads writing different parts of the file can share
+     *  one File.
+     *  Blocks.
+     *  If size is 0, no OS level write operation occurs.
+     *
+     *  \param offset The offset to write to
+     *  \param buffer The buffer to read from
+     *  \param size The number of bytes to write out
+     */
+    void writeAt(sys::Off_T offset, const void* buffer, size_t size);
+
     /*!
      *  Seek to the specified offset, relative to 'whence.'
      *  Valid values are FROM_START, FROM_CURRENT, FROM_END.
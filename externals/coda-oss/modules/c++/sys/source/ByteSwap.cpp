@@ -0,0 +1,246 @@
+/* =========================================================================
+ * This file is part of sys-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * sys-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string.h>
+
+#include "sys/ByteSwap.h"
+#include "sys/Conf.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#   define SYS_BYTE_SWAP_X86 1
+#   include <immintrin.h>
+#elif defined(_MSC_VER)
+#   include <stdlib.h>
+#endif
+
+namespace
+{
+inline sys::Uint16_T swapValue(sys::Uint16_T value)
+{
+#if defined(__GNUC__)
+    return __builtin_bswap16(value);
+#elif defined(_MSC_VER)
+    return _byteswap_ushort(value);
+#else
+    return static_cast<sys::Uint16_T>((value >> 8) | (value << 8));
+#endif
+}
+
+inline sys::Uint32_T swapValue(sys::Uint32_T value)
+{
+#if defined(__GNUC__)
+    return __builtin_bswap32(value);
+#elif defined(_MSC_VER)
+    return _byteswap_ulong(value);
+#else
+    return (value >> 24) | ((value >> 8) & 0x0000FF00) |
+            ((value << 8) & 0x00FF0000) | (value << 24);
+#endif
+}
+
+inline sys::Uint64_T swapValue(sys::Uint64_T value)
+{
+#if defined(__GNUC__)
+    return __builtin_bswap64(value);
+#elif defined(_MSC_VER)
+    return _byteswap_uint64(value);
+#else
+    return (static_cast<sys::Uint64_T>(
+                    swapValue(static_cast<sys::Uint32_T>(value))) << 32) |
+            swapValue(static_cast<sys::Uint32_T>(value >> 32));
+#endif
+}
+
+// Buffers aren't necessarily aligned, so go through memcpy
+template <typename T>
+void swapScalar(const sys::ubyte* in, size_t numElems, sys::ubyte* out)
+{
+    for (size_t ii = 0; ii < numElems;
+         ++ii, in += sizeof(T), out += sizeof(T))
+    {
+        T value;
+        memcpy(&value, in, sizeof(T));
+        value = swapValue(value);
+        memcpy(out, &value, sizeof(T));
+    }
+}
+
+#ifdef SYS_BYTE_SWAP_X86
+// Shuffles that reverse each element in a 16 byte lane
+const unsigned char SHUFFLE_2[16] =
+        { 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14 };
+const unsigned char SHUFFLE_4[16] =
+        { 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 };
+const unsigned char SHUFFLE_8[16] =
+        { 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8 };
+
+// Each of these swaps as many whole vectors as fit in 'numBytes' and
+// returns how many bytes that was
+__attribute__((target("ssse3")))
+size_t swapSSSE3(const sys::ubyte* in,
+                 size_t numBytes,
+                 sys::ubyte* out,
+                 const unsigned char* shuffle)
+{
+    const __m128i mask =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(shuffle));
+
+    size_t offset = 0;
+    for (; offset + 16 <= numBytes; offset += 16)
+    {
+        const __m128i value = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(in + offset));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + offset),
+                         _mm_shuffle_epi8(value, mask));
+    }
+    return offset;
+}
+
+__attribute__((target("avx2")))
+size_t swapAVX2(const sys::ubyte* in,
+                size_t numBytes,
+                sys::ubyte* out,
+                const unsigned char* shuffle)
+{
+    // The shuffle works within each 16 byte lane
+    const __m256i mask = _mm256_broadcastsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(shuffle)));
+
+    size_t offset = 0;
+    for (; offset + 64 <= numBytes; offset += 64)
+    {
+        const __m256i value0 = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(in + offset));
+        const __m256i value1 = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(in + offset + 32));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + offset),
+                            _mm256_shuffle_epi8(value0, mask));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + offset + 32),
+                            _mm256_shuffle_epi8(value1, mask));
+    }
+    for (; offset + 32 <= numBytes; offset += 32)
+    {
+        const __m256i value = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(in + offset));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + offset),
+                            _mm256_shuffle_epi8(value, mask));
+    }
+    return offset;
+}
+
+enum SIMDLevel
+{
+    SIMD_NONE,
+    SIMD_SSSE3,
+    SIMD_AVX2
+};
+
+SIMDLevel detectSIMDLevel()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return SIMD_AVX2;
+    }
+    if (__builtin_cpu_supports("ssse3"))
+    {
+        return SIMD_SSSE3;
+    }
+    return SIMD_NONE;
+}
+
+const SIMDLevel SIMD_LEVEL = detectSIMDLevel();
+#endif
+
+template <typename T>
+void swapBuffer(const void* buffer, size_t numElems, void* outputBuffer)
+{
+    const sys::ubyte* in = static_cast<const sys::ubyte*>(buffer);
+    sys::ubyte* out = static_cast<sys::ubyte*>(outputBuffer);
+    if (!in || !out || !numElems)
+    {
+        return;
+    }
+
+#ifdef SYS_BYTE_SWAP_X86
+    const unsigned char* const shuffle = sizeof(T) == 2 ? SHUFFLE_2 :
+            sizeof(T) == 4 ? SHUFFLE_4 : SHUFFLE_8;
+    const size_t numBytes = numElems * sizeof(T);
+    size_t numSwapped = 0;
+    switch (SIMD_LEVEL)
+    {
+    case SIMD_AVX2:
+        numSwapped = swapAVX2(in, numBytes, out, shuffle);
+        break;
+    case SIMD_SSSE3:
+        numSwapped = swapSSSE3(in, numBytes, out, shuffle);
+        break;
+    case SIMD_NONE:
+        break;
+    }
+    in += numSwapped;
+    out += numSwapped;
+    numElems -= numSwapped / sizeof(T);
+#endif
+
+    swapScalar<T>(in, numElems, out);
+}
+}
+
+namespace sys
+{
+void ByteSwap<2>::swap(void* buffer, size_t numElems)
+{
+    swapBuffer<Uint16_T>(buffer, numElems, buffer);
+}
+
+void ByteSwap<2>::swap(const void* buffer,
+                       size_t numElems,
+                       void* outputBuffer)
+{
+    swapBuffer<Uint16_T>(buffer, numElems, outputBuffer);
+}
+
+void ByteSwap<4>::swap(void* buffer, size_t numElems)
+{
+    swapBuffer<Uint32_T>(buffer, numElems, buffer);
+}
+
+void ByteSwap<4>::swap(const void* buffer,
+                       size_t numElems,
+                       void* outputBuffer)
+{
+    swapBuffer<Uint32_T>(buffer, numElems, outputBuffer);
+}
+
+void ByteSwap<8>::swap(void* buffer, size_t numElems)
+{
+    swapBuffer<Uint64_T>(buffer, numElems, buffer);
+}
+
+void ByteSwap<8>::swap(const void* buffer,
+                       size_t numElems,
+                       void* outputBuffer)
+{
+    swapBuffer<Uint64_T>(buffer, numElems, outputBuffer);
+}
+}
@@ -112,6 +112,66 @@ void sys::File::writeFrom(const void* buffer, size_t size)
     while (bytesActuallyWritten < size);
 }
 
+void sys::File::readAt(sys::Off_T offset, void* buffer, size_t size) const
+{
+    sys::byte* const bufferPtr = static_cast<sys::byte*>(buffer);
+    size_t totalBytesRead = 0;
+
+    for (int i = 1; totalBytesRead < size && i <= _SYS_MAX_READ_ATTEMPTS; i++)
+    {
+        const SSize_T bytesRead =
+                ::pread(mHandle,
+                        bufferPtr + totalBytesRead,
+                        size - totalBytesRead,
+                        offset + static_cast<sys::Off_T>(totalBytesRead));
+        if (bytesRead == -1)
+        {
+            if (errno != EINTR && errno != EAGAIN)
+            {
+                throw sys::SystemException(Ctxt("While reading from file"));
+            }
+        }
+        else if (bytesRead == 0)
+        {
+            throw sys::SystemException(Ctxt("Unexpected end of file"));
+        }
+        else
+        {
+            totalBytesRead += bytesRead;
+        }
+    }
+
+    if (totalBytesRead < size)
+    {
+        throw sys::SystemException(Ctxt("Unknown read state"));
+    }
+}
+
+void sys::File::writeAt(sys::Off_T offset, const void* buffer, size_t size)
+{
+    const sys::byte* const bufferPtr = static_cast<const sys::byte*>(buffer);
+    size_t bytesActuallyWritten = 0;
+
+    while (bytesActuallyWritten < size)
+    {
+        const SSize_T bytesThisWrite =
+                ::pwrite(mHandle,
+                         bufferPtr + bytesActuallyWritten,
+                         size - bytesActuallyWritten,
+                         offset + static_cast<sys::Off_T>(
+                                 bytesActuallyWritten));
+        if (bytesThisWrite == -1)
+        {
+            if (errno == EINTR || errno == EAGAIN)
+            {
+                continue;
+            }
+            throw sys::SystemException(Ctxt("Writing to file"));
+        }
+        bytesActuallyWritten += bytesThisWrite;
+    }
+}
+
 sys::Off_T sys::File::seekTo(sys::Off_T offset, int whence)
 {
     sys::Off_T off = ::lseek(mHandle, offset, whence);
@@ -24,6 +24,7 @@
 
 #include <limits>
 #include <cmath>
+#include <string.h>
 #include "sys/File.h"
 
 void sys::File::create(const std::string& str,
@@ -122,6 +123,85 @@ void sys::File::writeFrom(const void* buffer, size_t size)
     }
 }
 
+namespace
+{
+OVERLAPPED makeOverlapped(sys::Off_T offset)
+{
+    // For a synchronous handle, ReadFile() and WriteFile() read and write
+    // at this offset rather than at the file pointer
+    OVERLAPPED overlapped;
+    memset(&overlapped, 0, sizeof(overlapped));
+    const sys::Uint64_T uoffset = static_cast<sys::Uint64_T>(offset);
+    overlapped.Offset = static_cast<DWORD>(uoffset & 0xFFFFFFFF);
+    overlapped.OffsetHigh = static_cast<DWORD>(uoffset >> 32);
+    return overlapped;
+}
+}
+
+void sys::File::readAt(sys::Off_T offset, void* buffer, size_t size) const
+{
+    static const size_t MAX_READ_SIZE = std::numeric_limits<DWORD>::max();
+    size_t bytesRead = 0;
+
+    sys::byte* bufferPtr = static_cast<sys::byte*>(buffer);
+
+    while (bytesRead < size)
+    {
+        const DWORD bytesToRead = static_cast<DWORD>(
+                std::min(MAX_READ_SIZE, size - bytesRead));
+
+        OVERLAPPED overlapped = makeOverlapped(
+                offset + static_cast<sys::Off_T>(bytesRead));
+        DWORD bytesThisRead = 0;
+        if (!ReadFile(mHandle,
+                      bufferPtr + bytesRead,
+                      bytesToRead,
+                      &bytesThisRead,
+                      &overlapped))
+        {
+            if (GetLastError() == ERROR_HANDLE_EOF)
+            {
+                throw sys::SystemException(Ctxt("Unexpected end of file"));
+            }
+            throw sys::SystemException(Ctxt("Error reading from file"));
+        }
+        else if (bytesThisRead == 0)
+        {
+            throw sys::SystemException(Ctxt("Unexpected end of file"));
+        }
+
+        bytesRead += bytesThisRead;
+    }
+}
+
+void sys::File::writeAt(sys::Off_T offset, const void* buffer, size_t size)
+{
+    static const size_t MAX_WRITE_SIZE = std::numeric_limits<DWORD>::max();
+    size_t bytesWritten = 0;
+
+    const sys::byte* bufferPtr = static_cast<const sys::byte*>(buffer);
+
+    while (bytesWritten < size)
+    {
+        const DWORD bytesToWrite = static_cast<DWORD>(
+                std::min(MAX_WRITE_SIZE, size - bytesWritten));
+
+        OVERLAPPED overlapped = makeOverlapped(
+                offset + static_cast<sys::Off_T>(bytesWritten));
+        DWORD bytesThisWrite = 0;
+        if (!WriteFile(mHandle,
+                       bufferPtr + bytesWritten,
+                       bytesToWrite,
+                       &bytesThisWrite,
+                       &overlapped))
+        {
+            throw sys::SystemException(Ctxt("Writing from file"));
+        }
+
+        bytesWritten += bytesThisWrite;
+    }
+}
+
 sys::Off_T sys::File::seekTo(sys::Off_T offset, int whence)
 {
     /* Ahhh!!! */
@@ -0,0 +1,186 @@
+/* =========================================================================
+ * This file is part of sys-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * sys-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Times sys::byteSwap() for 2, 4, and 8 byte elements, in place and into
+ * another buffer, on buffers from 4 KB up to 1 GB.  Each is compared
+ * against swapping a byte at a time, which is how byteSwap() used to work.
+ *
+ * Usage: byteSwapBenchmark [max buffer size in MB]
+ */
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <except/Exception.h>
+#include <str/Convert.h>
+#include <sys/Conf.h>
+#include <sys/StopWatch.h>
+
+namespace
+{
+// Bytes to swap for each measurement, so small buffers get repeated
+const size_t BYTES_PER_TRIAL = 1024 * 1024 * 1024;
+
+void swapBytewise(void* buffer, unsigned short elemSize, size_t numElems)
+{
+    sys::byte* bufferPtr = static_cast<sys::byte*>(buffer);
+    const unsigned short half = elemSize >> 1;
+    size_t offset = 0;
+
+    for (size_t ii = 0; ii < numElems; ++ii, offset += elemSize)
+    {
+        for (unsigned short jj = 0; jj < half; ++jj)
+        {
+            std::swap(bufferPtr[offset + jj],
+                      bufferPtr[offset + elemSize - 1 - jj]);
+        }
+    }
+}
+
+void swapBytewise(const void* buffer,
+                  unsigned short elemSize,
+                  size_t numElems,
+                  void* outputBuffer)
+{
+    const sys::byte* bufferPtr = static_cast<const sys::byte*>(buffer);
+    sys::byte* outputBufferPtr = static_cast<sys::byte*>(outputBuffer);
+    const unsigned short half = elemSize >> 1;
+    size_t offset = 0;
+
+    for (size_t ii = 0; ii < numElems; ++ii, offset += elemSize)
+    {
+        for (unsigned short jj = 0; jj < half; ++jj)
+        {
+            const size_t innerOff = offset + jj;
+            const size_t innerSwap = offset + elemSize - 1 - jj;
+            outputBufferPtr[innerOff] = bufferPtr[innerSwap];
+            outputBufferPtr[innerSwap] = bufferPtr[innerOff];
+        }
+    }
+}
+
+// Returns GB/s for swapping 'numBytes' of 'input'
+double time(bool bytewise,
+            bool inPlace,
+            unsigned short elemSize,
+            size_t numBytes,
+            std::vector<sys::ubyte>& input,
+            std::vector<sys::ubyte>& output)
+{
+    const size_t numElems = numBytes / elemSize;
+    const size_t numTrials = std::max<size_t>(BYTES_PER_TRIAL / numBytes, 1);
+
+    sys::RealTimeStopWatch stopWatch;
+    stopWatch.start();
+    for (size_t ii = 0; ii < numTrials; ++ii)
+    {
+        if (bytewise && inPlace)
+        {
+            swapBytewise(&input[0], elemSize, numElems);
+        }
+        else if (bytewise)
+        {
+            swapBytewise(&input[0], elemSize, numElems, &output[0]);
+        }
+        else if (inPlace)
+        {
+            sys::byteSwap(&input[0], elemSize, numElems);
+        }
+        else
+        {
+            sys::byteSwap(&input[0], elemSize, numElems, &output[0]);
+        }
+    }
+    const double seconds = stopWatch.stop() / 1000;
+    return numTrials * static_cast<double>(numBytes) / seconds / 1.0e9;
+}
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        if (argc > 2)
+        {
+            std::cerr << "Usage: " << argv[0]
+                      << " [max buffer size in MB]\n";
+            return 1;
+        }
+        const size_t maxBytes = (argc == 2) ?
+                str::toType<size_t>(argv[1]) * 1024 * 1024 :
+                static_cast<size_t>(1024) * 1024 * 1024;
+
+        std::vector<sys::ubyte> input(maxBytes);
+        std::vector<sys::ubyte> output(maxBytes);
+        for (size_t ii = 0; ii < input.size(); ++ii)
+        {
+            input[ii] = static_cast<sys::ubyte>(ii * 7);
+        }
+
+        std::cout << "All rates are in GB/s\n"
+                  << std::setw(6) << "Elem" << std::setw(14) << "Bytes"
+                  << std::setw(14) << "Bytewise"
+                  << std::setw(14) << "In place"
+                  << std::setw(14) << "Bytewise out"
+                  << std::setw(14) << "Out of place" << std::endl;
+
+        const unsigned short elemSizes[] = { 2, 4, 8 };
+        for (size_t ii = 0; ii < 3; ++ii)
+        {
+            const unsigned short elemSize = elemSizes[ii];
+            for (size_t numBytes = 4096; numBytes <= maxBytes; numBytes *= 4)
+            {
+                std::cout << std::fixed << std::setprecision(2)
+                          << std::setw(6) << elemSize
+                          << std::setw(14) << numBytes
+                          << std::setw(14)
+                          << time(true, true, elemSize, numBytes,
+                                  input, output)
+                          << std::setw(14)
+                          << time(false, true, elemSize, numBytes,
+                                  input, output)
+                          << std::setw(14)
+                          << time(true, false, elemSize, numBytes,
+                                  input, output)
+                          << std::setw(14)
+                          << time(false, false, elemSize, numBytes,
+                                  input, output)
+                          << std::endl;
+            }
+        }
+        return 0;
+    }
+    catch (const except::Exception& ex)
+    {
+        std::cerr << ex.toString() << std::endl;
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+    }
+    return 1;
+}
@@ -20,11 +20,90 @@
  *
  */
 
+#include <vector>
+
 #include "TestCase.h"
+#include <sys/ByteSwap.h>
 #include <sys/Conf.h>
 
 namespace
 {
+// Swaps a byte at a time, as byteSwap() used to
+void referenceByteSwap(const sys::ubyte* in,
+                       unsigned short elemSize,
+                       size_t numElems,
+                       sys::ubyte* out)
+{
+    for (size_t ii = 0; ii < numElems * elemSize; ii += elemSize)
+    {
+        for (unsigned short jj = 0; jj < elemSize; ++jj)
+        {
+            out[ii + jj] = in[ii + elemSize - 1 - jj];
+        }
+    }
+}
+
+// Swaps every length up to a few vectors, plus a long buffer, starting at
+// each offset into a vector so the loads aren't aligned
+bool testElemSize(unsigned short elemSize)
+{
+    std::vector<size_t> lengths;
+    for (size_t length = 0; length <= 40; ++length)
+    {
+        lengths.push_back(length);
+    }
+    lengths.push_back(10007);
+
+    for (size_t ii = 0; ii < lengths.size(); ++ii)
+    {
+        const size_t numElems = lengths[ii];
+        for (size_t offset = 0; offset < 32; offset += 3)
+        {
+            const size_t numBytes = numElems * elemSize;
+            std::vector<sys::ubyte> input(numBytes + offset + 1);
+            for (size_t jj = 0; jj < input.size(); ++jj)
+            {
+                input[jj] = static_cast<sys::ubyte>(::rand());
+            }
+            const sys::ubyte* const in = &input[offset];
+
+            std::vector<sys::ubyte> expected(numBytes + 1);
+            referenceByteSwap(in, elemSize, numElems, &expected[0]);
+
+            std::vector<sys::ubyte> inPlace(in, in + numBytes);
+            inPlace.push_back(0);
+            sys::byteSwap(&inPlace[0], elemSize, numElems);
+
+            std::vector<sys::ubyte> outOfPlace(numBytes + 1);
+            sys::byteSwap(in, elemSize, numElems, &outOfPlace[0]);
+
+            // The byte past the end is untouched
+            if (inPlace != expected || outOfPlace != expected)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <size_t ElemSize>
+bool testByteSwapT()
+{
+    std::vector<sys::ubyte> input(ElemSize * 101);
+    for (size_t ii = 0; ii < input.size(); ++ii)
+    {
+        input[ii] = static_cast<sys::ubyte>(::rand());
+    }
+    std::vector<sys::ubyte> expected(input.size());
+    referenceByteSwap(&input[0], ElemSize, 101, &expected[0]);
+
+    std::vector<sys::ubyte> output(input.size());
+    sys::ByteSwap<ElemSize>::swap(&input[0], 101, &output[0]);
+    sys::ByteSwap<ElemSize>::swap(&input[0], 101);
+    return output == expected && input == expected;
+}
+
 TEST_CASE(testByteSwap)
 {
     ::srand(334);
@@ -54,10 +133,30 @@ TEST_CASE(testByteSwap)
         TEST_ASSERT_EQ(values1[ii], swappedValues2[ii]);
     }
 }
+
+TEST_CASE(testByteSwapSizes)
+{
+    ::srand(335);
+
+    TEST_ASSERT(testElemSize(2));
+    TEST_ASSERT(testElemSize(4));
+    TEST_ASSERT(testElemSize(8));
+
+    // Sizes without a specialization
+    TEST_ASSERT(testElemSize(3));
+    TEST_ASSERT(testElemSize(16));
+
+    TEST_ASSERT(testByteSwapT<2>());
+    TEST_ASSERT(testByteSwapT<4>());
+    TEST_ASSERT(testByteSwapT<8>());
+    TEST_ASSERT(testByteSwapT<3>());
+    TEST_ASSERT(testByteSwapT<16>());
+}
 }
 
 int main(int /*argc*/, char** /*argv*/)
 {
     TEST_CHECK(testByteSwap);
+    TEST_CHECK(testByteSwapSizes);
     return 0;
 }
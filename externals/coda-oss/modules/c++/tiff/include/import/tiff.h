@@ -24,6 +24,7 @@
 #define __IMPORT_TIFF_H__
 
 #include "tiff/Common.h"
+#include "tiff/Compression.h"
 #include "tiff/Header.h"
 #include "tiff/GenericType.h"
 #include "tiff/IFDEntry.h"
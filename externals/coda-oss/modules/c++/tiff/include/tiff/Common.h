@@ -82,6 +82,12 @@ public:
             SRATIONAL,
             FLOAT,
             DOUBLE,
+            IFD,
+
+            // BigTIFF only
+            LONG8 = 16,
+            SLONG8,
+            IFD8,
             MAX
         };
     };
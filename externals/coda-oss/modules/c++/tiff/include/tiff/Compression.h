@@ -0,0 +1,134 @@
+/* =========================================================================
+ * This file is part of tiff-c++ 
+ * =========================================================================
+ * 
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * tiff-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public 
+ * License along with this program; If not, 
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __TIFF_COMPRESSION_H__
+#define __TIFF_COMPRESSION_H__
+
+#include <vector>
+#include <sys/Conf.h>
+
+namespace tiff
+{
+
+/**
+ *********************************************************************
+ * @class Compression
+ * @brief Lossless codecs for TIFF image data
+ *
+ * Implements TIFF LZW compression (Compression = 5) and the horizontal
+ * differencing predictor (Predictor = 2) that usually accompanies it.
+ * Each call works on a single strip or tile, so independent chunks can
+ * be compressed or decompressed on separate threads.
+ *********************************************************************/
+class Compression
+{
+public:
+    /**
+     *****************************************************************
+     * LZW compresses a buffer, using the MSB-first code packing
+     * defined by the TIFF 6.0 specification.
+     *
+     * @param input
+     *   the data to compress
+     * @param numBytes
+     *   the number of bytes in input
+     * @param output
+     *   replaced with the compressed data
+     *****************************************************************/
+    static void lzwEncode(const unsigned char *input,
+                          size_t numBytes,
+                          std::vector<unsigned char>& output);
+
+    /**
+     *****************************************************************
+     * Decompresses LZW data into a buffer of known size.
+     *
+     * @param input
+     *   the compressed data
+     * @param numBytes
+     *   the number of bytes in input
+     * @param output
+     *   the buffer to decompress into.  Any part of the buffer the
+     *   compressed data does not cover is zero filled.
+     * @param outputSize
+     *   the size of output in bytes
+     * @throw except::Exception if the data is corrupt or decompresses
+     *   to more than outputSize bytes
+     *****************************************************************/
+    static void lzwDecode(const unsigned char *input,
+                          size_t numBytes,
+                          unsigned char *output,
+                          size_t outputSize);
+
+    /**
+     *****************************************************************
+     * Applies horizontal differencing in place.  Each sample is
+     * replaced by its difference from the same sample of the pixel
+     * to its left.  Samples must be in native byte order.
+     *
+     * @param data
+     *   the rows of pixels to difference
+     * @param numRows
+     *   the number of rows in data
+     * @param numCols
+     *   the number of pixels in each row
+     * @param samplesPerPixel
+     *   the number of samples in each pixel
+     * @param bytesPerSample
+     *   the size of each sample, either 1 or 2 bytes
+     *****************************************************************/
+    static void applyPredictor(unsigned char *data,
+                               size_t numRows,
+                               size_t numCols,
+                               size_t samplesPerPixel,
+                               size_t bytesPerSample);
+
+    /**
+     *****************************************************************
+     * Reverses applyPredictor() in place.
+     *
+     * @see applyPredictor
+     *****************************************************************/
+    static void undoPredictor(unsigned char *data,
+                              size_t numRows,
+                              size_t numCols,
+                              size_t samplesPerPixel,
+                              size_t bytesPerSample);
+
+    /**
+     *****************************************************************
+     * Returns true if applyPredictor() supports samples of this size.
+     *****************************************************************/
+    static bool isPredictorSupported(size_t bytesPerSample)
+    {
+        return bytesPerSample == 1 || bytesPerSample == 2;
+    }
+
+private:
+    Compression()
+    {
+    }
+};
+
+}
+
+#endif // __TIFF_COMPRESSION_H__
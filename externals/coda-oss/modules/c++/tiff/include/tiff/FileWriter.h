@@ -47,7 +47,7 @@ public:
 
     //! Constructor
     FileWriter() :
-        mIFDOffset(0)
+        mIFDOffset(0), mBigTIFF(false)
     {
     }
 
@@ -59,7 +59,7 @@ public:
      *   the file to open for writing
      *****************************************************************/
     FileWriter(const std::string& fileName) :
-        mIFDOffset(0)
+        mIFDOffset(0), mBigTIFF(false)
     {
         openFile(fileName);
     }
@@ -116,6 +116,22 @@ public:
      *****************************************************************/
     void writeHeader();
 
+    /**
+     *****************************************************************
+     * Selects whether to write a BigTIFF file, which uses 64 bit
+     * offsets and so can exceed 4GB.  Must be called before
+     * writeHeader().  The default is a classic TIFF file.
+     *
+     * @param bigTIFF
+     *   true to write a BigTIFF file
+     *****************************************************************/
+    void setBigTIFF(bool bigTIFF);
+
+    //! Returns true if this writes a BigTIFF file
+    bool isBigTIFF() const
+    {
+        return mBigTIFF;
+    }
 
 private:
     // Noncopyable
@@ -124,7 +140,10 @@ private:
 
 private:
     //! The position to write the offset to the first IFD to
-    sys::Uint32_T mIFDOffset;
+    sys::Uint64_T mIFDOffset;
+
+    //! Whether to write a BigTIFF file
+    bool mBigTIFF;
 
     //! The output stream
     io::FileOutputStream mOutput;
@@ -39,21 +39,28 @@ class Header : public io::Serializable
 public:
     enum ByteOrder { MM, II };
 
+    //! Identifier of a classic TIFF file
+    static const unsigned short CLASSIC_ID = 42;
+
+    //! Identifier of a BigTIFF file, which has 64-bit offsets
+    static const unsigned short BIGTIFF_ID = 43;
+
     /**
      *****************************************************************
      * Constructor.  Allows the user to set the values in the header
      * and also provides resonable defaults.
      *
      * @param id
-     *   the TIFF identifier, always "42"
+     *   the TIFF identifier, "42" for classic TIFF or "43" for BigTIFF
      * @param byteOrder
      *   the byte order of the file "MM" for Big Endian, "II" 
      *   for Little Endian
      * @param ifdOffset
      *   the offset to the first IFD
      *****************************************************************/
-    Header(const unsigned short id = 42, const char byteOrder[2] = "  ",
-            const sys::Uint32_T ifdOffset = 8) :
+    Header(const unsigned short id = CLASSIC_ID,
+            const char byteOrder[2] = "  ",
+            const sys::Uint64_T ifdOffset = 8) :
         mId(id), mIFDOffset(ifdOffset)
     {
         bool isBigEndian = sys::isBigEndianSystem();
@@ -109,11 +116,17 @@ public:
      * @return
      *   the IFD offset
      *****************************************************************/
-    sys::Uint32_T getIFDOffset() const
+    sys::Uint64_T getIFDOffset() const
     {
         return mIFDOffset;
     }
 
+    //! \return True if this is a BigTIFF header
+    bool isBigTIFF() const
+    {
+        return mId == BIGTIFF_ID;
+    }
+
     ByteOrder getByteOrder() const
     {
         if (mByteOrder[0] == 'M' && mByteOrder[1] == 'M')
@@ -136,7 +149,7 @@ private:
     unsigned short mId;
 
     //! The IFD offset
-    sys::Uint32_T mIFDOffset;
+    sys::Uint64_T mIFDOffset;
     
     bool mDifferentByteOrdering;
     
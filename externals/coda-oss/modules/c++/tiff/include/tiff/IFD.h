@@ -194,6 +194,18 @@ public:
      *****************************************************************/
     void serialize(io::OutputStream& output);
 
+    /**
+     *****************************************************************
+     * Writes the complete IFD to the specified output stream, in
+     * either classic TIFF or BigTIFF layout.
+     *
+     * @param output
+     *   the output stream to write the IFD to
+     * @param bigTIFF
+     *   true to write a BigTIFF IFD
+     *****************************************************************/
+    void serialize(io::OutputStream& output, const bool bigTIFF);
+
     /**
      *****************************************************************
      * Reads the complete IFD from the specified input stream.
@@ -203,6 +215,8 @@ public:
      *****************************************************************/
     void deserialize(io::InputStream& input);
     void deserialize(io::InputStream& input, const bool reverseBytes);
+    void deserialize(io::InputStream& input, const bool reverseBytes,
+                     const bool bigTIFF);
 
     /**
      *****************************************************************
@@ -234,7 +248,7 @@ public:
      * @return 
      *   the calculated image size in bytes
      *****************************************************************/
-    sys::Uint32_T getImageSize();
+    sys::Uint64_T getImageSize();
 
     /**
      *****************************************************************
@@ -277,7 +291,7 @@ public:
      * @return
      *   the offset to write the next IFD offset to
      *****************************************************************/
-    sys::Uint32_T getNextIFDOffsetPosition()
+    sys::Uint64_T getNextIFDOffsetPosition()
     {
         return mNextIFDOffsetPosition;
     }
@@ -297,13 +311,13 @@ private:
      *   the highest overflow offset calculated, this marks the
      *   potential beginning of the next image.
      *****************************************************************/
-    sys::Uint32_T finalize(const sys::Uint32_T offset);
+    sys::Uint64_T finalize(const sys::Uint64_T offset, const bool bigTIFF);
 
     //! The IFD entries
     IFDType mIFD;
 
     //! Offset where the next IFD offset can be written to
-    sys::Uint32_T mNextIFDOffsetPosition;
+    sys::Uint64_T mNextIFDOffsetPosition;
 };
 
 } // End namespace.
@@ -122,6 +122,18 @@ public:
      *****************************************************************/
     void serialize(io::OutputStream& output);
 
+    /**
+     *****************************************************************
+     * Writes the IFD entry to the specified output stream, in
+     * either classic TIFF or BigTIFF layout.
+     *
+     * @param output
+     *   the output stream to write the entry to
+     * @param bigTIFF
+     *   true to write a BigTIFF entry
+     *****************************************************************/
+    void serialize(io::OutputStream& output, const bool bigTIFF);
+
     /**
      *****************************************************************
      * Reads the IFD entry from the specified input stream.
@@ -131,6 +143,8 @@ public:
      *****************************************************************/
     void deserialize(io::InputStream& input);
     void deserialize(io::InputStream& input, const bool reverseBytes);
+    void deserialize(io::InputStream& input, const bool reverseBytes,
+                     const bool bigTIFF);
 
     /**
      *****************************************************************
@@ -197,7 +211,7 @@ public:
      * @return
      *  the value offset
      *****************************************************************/
-    sys::Uint32_T getOffset() const
+    sys::Uint64_T getOffset() const
     {
         return mOffset;
     }
@@ -340,6 +354,21 @@ public:
      *****************************************************************/
     sys::Uint32_T finalize(const sys::Uint32_T offset);
 
+    /**
+     *****************************************************************
+     * Same as above, except that BigTIFF entries hold up to 8 bytes
+     * of values before they overflow.
+     *
+     * @param offset
+     *   the next free file offset that the values will can be
+     *   written to
+     * @param bigTIFF
+     *   true if the entry will be written as a BigTIFF entry
+     * @return
+     *   the next free file offset
+     *****************************************************************/
+    sys::Uint64_T finalize(const sys::Uint64_T offset, const bool bigTIFF);
+
     /**
      *****************************************************************
      * According to the TIFF 6.0 spec, the size of an IFD entry is 12
@@ -356,6 +385,49 @@ public:
         return 12;
     }
 
+    /**
+     *****************************************************************
+     * Returns the size of an IFD entry, which is 20 bytes in BigTIFF
+     * since the count and value offset are 8 bytes each.
+     *
+     * @param bigTIFF
+     *   true for the size of a BigTIFF entry
+     * @return
+     *   the size of an IFD entry
+     *****************************************************************/
+    static unsigned short sizeOf(const bool bigTIFF)
+    {
+        return bigTIFF ? 20 : sizeOf();
+    }
+
+    /**
+     *****************************************************************
+     * Returns the number of bytes of values that fit in the entry
+     * itself rather than being written elsewhere in the file.
+     *
+     * @param bigTIFF
+     *   true for a BigTIFF entry
+     * @return
+     *   the size of the value field of an IFD entry
+     *****************************************************************/
+    static unsigned short valueFieldSize(const bool bigTIFF)
+    {
+        return bigTIFF ? sizeof(sys::Uint64_T) : sizeof(sys::Uint32_T);
+    }
+
+    /**
+     *****************************************************************
+     * Returns the value at the specified index as an unsigned
+     * integer, whether it is stored as a SHORT, LONG or LONG8.
+     * Offsets and sizes can be stored as any of these.
+     *
+     * @param index
+     *   the index that indicates which value to retrieve
+     * @return
+     *   the value at the specified index
+     *****************************************************************/
+    sys::Uint64_T getUnsignedValue(const sys::Uint32_T index) const;
+
 private:
 
     /**
@@ -380,7 +452,7 @@ private:
     sys::Uint32_T mCount;
 
     //! The file offset to values for the IFD entry
-    sys::Uint32_T mOffset;
+    sys::Uint64_T mOffset;
 
     //! The name of the IFD entry (i.e. "ImageWidth")
     std::string mName;
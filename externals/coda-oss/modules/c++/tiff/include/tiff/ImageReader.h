@@ -23,6 +23,7 @@
 #ifndef __TIFF_IMAGE_READER_H__
 #define __TIFF_IMAGE_READER_H__
 
+#include <vector>
 #include <import/io.h>
 
 #include "tiff/IFDEntry.h"
@@ -53,7 +54,8 @@ public:
     ImageReader(io::FileInputStream *input) :
         mIFD(), mStripByteCounts(NULL), mStripOffsets(NULL), mInput(input),
                 mNextOffset(0), mBytePosition(0), mStripIndex(0),
-                mElementSize(0), mReverseBytes(false)
+                mElementSize(0), mReverseBytes(false), mCompression(0),
+                mPredictor(false), mTileRow(0), mTileRowLoaded(false)
     {
     }
 
@@ -66,8 +68,13 @@ public:
      *****************************************************************
      * Processes the image from the file.  Reads the image's IFD
      * and stores it for later use.
+     *
+     * @param reverseBytes
+     *   whether the file's byte order differs from the system's
+     * @param bigTIFF
+     *   whether the file is a BigTIFF
      *****************************************************************/
-    void process(const bool reverseBytes = false);
+    void process(const bool reverseBytes = false, const bool bigTIFF = false);
 
     /**
      *****************************************************************
@@ -122,7 +129,7 @@ public:
      * @return
      *   the next IFD offset
      *****************************************************************/
-    sys::Uint32_T getNextOffset() const
+    sys::Uint64_T getNextOffset() const
     {
         return mNextOffset;
     }
@@ -153,6 +160,31 @@ private:
      *****************************************************************/
     void getTileData(unsigned char *buffer, sys::Uint32_T numElementsToRead);
 
+    /**
+     *****************************************************************
+     * Reads and decompresses a tile, caching it along with the rest
+     * of its row of tiles so that reading the image a line at a time
+     * only decompresses each tile once.
+     *
+     * @param tileRow
+     *   the row of the tile
+     * @param tileColumn
+     *   the column of the tile
+     * @param tilesAcross
+     *   the number of tiles in each row
+     * @param tileByteWidth
+     *   the width of a tile in bytes
+     * @param tileLength
+     *   the number of rows in a tile
+     * @return
+     *   the decompressed tile
+     *****************************************************************/
+    const unsigned char *loadTile(size_t tileRow,
+                                  size_t tileColumn,
+                                  size_t tilesAcross,
+                                  size_t tileByteWidth,
+                                  size_t tileLength);
+
     //! Contains the IFD for this image.
     tiff::IFD mIFD;
 
@@ -166,10 +198,10 @@ private:
     io::FileInputStream *mInput;
 
     //! The offset to the next IFD.
-    sys::Uint32_T mNextOffset;
+    sys::Uint64_T mNextOffset;
 
     //! Used to keep track of the current read position in the file.
-    sys::Uint32_T mBytePosition;
+    sys::Uint64_T mBytePosition;
     
     sys::Uint32_T mStripIndex;
 
@@ -178,6 +210,21 @@ private:
 
     //! Whether to reverse bytes when reading.
     bool mReverseBytes;
+
+    //! The compression type from the IFD.
+    unsigned short mCompression;
+
+    //! Whether horizontal differencing was applied to the data.
+    bool mPredictor;
+
+    //! Decompressed tiles from the most recently read row of tiles.
+    std::vector<std::vector<unsigned char> > mTiles;
+
+    //! The row of tiles held in mTiles.
+    size_t mTileRow;
+
+    //! Whether mTiles holds a row of tiles.
+    bool mTileRowLoaded;
 };
 
 } // End namespace.
@@ -23,6 +23,7 @@
 #ifndef __TIFF_IMAGE_WRITER_H__
 #define __TIFF_IMAGE_WRITER_H__
 
+#include <vector>
 #include <import/io.h>
 
 #include "tiff/Common.h"
@@ -39,6 +40,10 @@ namespace tiff
  *
  * Writes a TIFF image to a stream.  Contains functions for writing
  * the image's IFD, and for putting data to a stream.
+ *
+ * Tiled images may be LZW compressed by setting the Compression
+ * entry (and optionally Predictor) in the IFD.  Tiles are buffered a
+ * row of tiles at a time and compressed in parallel.
  *********************************************************************/
 class ImageWriter
 {
@@ -60,13 +65,19 @@ public:
      *   the output stream to write the image to
      * @param ifdOffset
      *   the offset to the beginning of the IFD for this image
+     * @param bigTIFF
+     *   true if the image is part of a BigTIFF file
      *****************************************************************/
-    ImageWriter(io::FileOutputStream *output, const sys::Uint32_T ifdOffset) :
+    ImageWriter(io::FileOutputStream *output, const sys::Uint64_T ifdOffset,
+                const bool bigTIFF = false) :
         mStripByteCounts(NULL),
-                mTileOffsets(NULL),
+                mTileOffsets(NULL), mTileWidth(NULL), mTileLength(NULL),
+                mTileByteCounts(NULL),
                 mOutput(output), mIFDOffset(ifdOffset),
                 mIdealChunkSize(CHUNK_SIZE), mBytePosition(0), mElementSize(0),
-                mValidated(false), mFormat(STRIPPED)
+                mValidated(false), mFormat(STRIPPED), mBigTIFF(bigTIFF),
+                mCompression(tiff::Const::CompressionType::NO_COMPRESSION),
+                mPredictor(false), mNumThreads(0), mTileRowSize(0)
     {
     }
 
@@ -117,7 +128,7 @@ public:
      * @return
      *   the position to write the next IFD offset to
      *****************************************************************/
-    sys::Uint32_T getNextIFDOffset() const
+    sys::Uint64_T getNextIFDOffset() const
     {
         return mIFDOffset;
     }
@@ -163,6 +174,20 @@ public:
         return mFormat;
     }
 
+    /**
+     *****************************************************************
+     * Sets the number of threads used to compress tiles.  Has no
+     * effect on uncompressed or stripped images.
+     *
+     * @param numThreads
+     *   the number of tiles to compress at once.  If 0, uses the
+     *   number of CPUs available.
+     *****************************************************************/
+    void setNumThreads(size_t numThreads)
+    {
+        mNumThreads = numThreads;
+    }
+
 
     /**
      *****************************************************************
@@ -213,6 +238,20 @@ private:
     void putTileData(const unsigned char *buffer,
                      sys::Uint32_T numElementsToWrite);
 
+    /**
+     *****************************************************************
+     * Cuts the buffered row of tiles into tiles, compresses them if
+     * needed, and writes them to the file.
+     *****************************************************************/
+    void writeTileRow();
+
+    /**
+     *****************************************************************
+     * Adds a 32 or 64 bit file offset to the entry, depending on
+     * whether this is a BigTIFF.
+     *****************************************************************/
+    void addOffset(tiff::IFDEntry *entry, const sys::Uint64_T offset);
+
     //! The TIFF IFD for this image
     tiff::IFD mIFD;
 
@@ -235,13 +274,13 @@ private:
     io::FileOutputStream *mOutput;
 
     //! The position to write the next IFD to
-    sys::Uint32_T mIFDOffset;
+    sys::Uint64_T mIFDOffset;
 
     //! The ideal size of a tile
     sys::Uint32_T mIdealChunkSize;
 
     //! Used to determine the position in the image
-    sys::Uint32_T mBytePosition;
+    sys::Uint64_T mBytePosition;
 
     //! The image's element size.  Stored here to prevent frequent IFD access
     unsigned short mElementSize;
@@ -251,6 +290,24 @@ private:
 
     //! The format of the file, either TILED or STRIPPED
     ImageFormat mFormat;
+
+    //! Whether offsets are written as 64 bit BigTIFF offsets
+    bool mBigTIFF;
+
+    //! The compression type from the IFD
+    unsigned short mCompression;
+
+    //! Whether horizontal differencing is applied before compression
+    bool mPredictor;
+
+    //! The number of tiles to compress at once
+    size_t mNumThreads;
+
+    //! Holds a row of tiles in raster format until it is complete
+    std::vector<unsigned char> mTileRow;
+
+    //! The number of bytes of the current row of tiles that are filled
+    size_t mTileRowSize;
 };
 
 } // End namespace.
@@ -27,7 +27,7 @@
 
 //! Initialize the byte count values for each TIFF type.
 short tiff::Const::mTypeSizes[tiff::Const::Type::MAX] =
-{ 0, 1, 1, 2, 4, 8, 1, 1, 2, 4, 8, 4, 8 };
+{ 0, 1, 1, 2, 4, 8, 1, 1, 2, 4, 8, 4, 8, 4, 0, 0, 8, 8, 8 };
 
 std::string tiff::RationalPrintStrategy::toString(const sys::Uint32_T data)
 {
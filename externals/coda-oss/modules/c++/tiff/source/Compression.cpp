@@ -0,0 +1,366 @@
+/* =========================================================================
+ * This file is part of tiff-c++ 
+ * =========================================================================
+ * 
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * tiff-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public 
+ * License along with this program; If not, 
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "tiff/Compression.h"
+
+#include <string.h>
+#include <algorithm>
+#include <import/except.h>
+
+namespace
+{
+const unsigned int CODE_CLEAR = 256;
+const unsigned int CODE_EOI = 257;
+const unsigned int CODE_FIRST = 258;
+const unsigned int BITS_MIN = 9;
+const unsigned int BITS_MAX = 12;
+const unsigned int CODE_MAX = (1 << BITS_MAX) - 1;
+
+inline unsigned int maxCode(unsigned int numBits)
+{
+    return (1 << numBits) - 1;
+}
+
+// Packs variable width codes most significant bit first
+class CodeWriter
+{
+public:
+    CodeWriter(std::vector<unsigned char>& output) :
+        mOutput(output), mData(0), mNumBits(0)
+    {
+    }
+
+    void put(unsigned int code, unsigned int numBits)
+    {
+        mData = (mData << numBits) | code;
+        mNumBits += numBits;
+        while (mNumBits >= 8)
+        {
+            mNumBits -= 8;
+            mOutput.push_back(static_cast<unsigned char>(mData >> mNumBits));
+        }
+        mData &= (1 << mNumBits) - 1;
+    }
+
+    void flush()
+    {
+        if (mNumBits)
+        {
+            mOutput.push_back(
+                    static_cast<unsigned char>(mData << (8 - mNumBits)));
+            mData = 0;
+            mNumBits = 0;
+        }
+    }
+
+private:
+    std::vector<unsigned char>& mOutput;
+    sys::Uint32_T mData;
+    unsigned int mNumBits;
+};
+
+// Maps (prefix code, next byte) pairs to codes while encoding
+class StringTable
+{
+public:
+    StringTable() :
+        mKeys(TABLE_SIZE), mCodes(TABLE_SIZE)
+    {
+        clear();
+    }
+
+    void clear()
+    {
+        std::fill(mKeys.begin(), mKeys.end(), EMPTY);
+    }
+
+    // Returns the code for the pair, or adds it as newCode and returns
+    // CODE_CLEAR if it was not already present
+    unsigned int findOrAdd(unsigned int prefix,
+                           unsigned char c,
+                           unsigned int newCode)
+    {
+        const sys::Uint32_T key = (prefix << 8) | c;
+        size_t slot = (key * 2654435761U) >> (32 - TABLE_BITS);
+        while (mKeys[slot] != EMPTY)
+        {
+            if (mKeys[slot] == key)
+            {
+                return mCodes[slot];
+            }
+            slot = (slot + 1) & (TABLE_SIZE - 1);
+        }
+        mKeys[slot] = key;
+        mCodes[slot] = static_cast<unsigned short>(newCode);
+        return CODE_CLEAR;
+    }
+
+private:
+    static const size_t TABLE_BITS = 13;
+    static const size_t TABLE_SIZE = 1 << TABLE_BITS;
+    static const sys::Uint32_T EMPTY = 0xFFFFFFFF;
+
+    std::vector<sys::Uint32_T> mKeys;
+    std::vector<unsigned short> mCodes;
+};
+
+template <typename T>
+void applyPredictorImpl(T *data, size_t numRows, size_t numCols,
+                        size_t samplesPerPixel)
+{
+    const size_t rowSize = numCols * samplesPerPixel;
+    if (numCols < 2)
+        return;
+
+    for (size_t row = 0; row < numRows; ++row, data += rowSize)
+    {
+        for (size_t ii = rowSize - 1; ii >= samplesPerPixel; --ii)
+        {
+            data[ii] = static_cast<T>(data[ii] - data[ii - samplesPerPixel]);
+        }
+    }
+}
+
+template <typename T>
+void undoPredictorImpl(T *data, size_t numRows, size_t numCols,
+                       size_t samplesPerPixel)
+{
+    const size_t rowSize = numCols * samplesPerPixel;
+    for (size_t row = 0; row < numRows; ++row, data += rowSize)
+    {
+        for (size_t ii = samplesPerPixel; ii < rowSize; ++ii)
+        {
+            data[ii] = static_cast<T>(data[ii] + data[ii - samplesPerPixel]);
+        }
+    }
+}
+}
+
+void tiff::Compression::lzwEncode(const unsigned char *input,
+                                  size_t numBytes,
+                                  std::vector<unsigned char>& output)
+{
+    output.clear();
+    output.reserve(numBytes / 2 + 16);
+
+    CodeWriter writer(output);
+    StringTable table;
+    unsigned int numBits = BITS_MIN;
+    unsigned int nextCode = CODE_FIRST;
+
+    writer.put(CODE_CLEAR, numBits);
+    if (numBytes == 0)
+    {
+        writer.put(CODE_EOI, numBits);
+        writer.flush();
+        return;
+    }
+
+    unsigned int prefix = input[0];
+    for (size_t ii = 1; ii < numBytes; ++ii)
+    {
+        const unsigned char c = input[ii];
+        const unsigned int code = table.findOrAdd(prefix, c, nextCode);
+        if (code != CODE_CLEAR)
+        {
+            prefix = code;
+            continue;
+        }
+
+        writer.put(prefix, numBits);
+        prefix = c;
+
+        // The table stops one short of 4095 codes so that readers using
+        // the "early change" code widths never need a 13th bit
+        if (++nextCode == CODE_MAX - 1)
+        {
+            writer.put(CODE_CLEAR, numBits);
+            table.clear();
+            numBits = BITS_MIN;
+            nextCode = CODE_FIRST;
+        }
+        else if (nextCode > maxCode(numBits))
+        {
+            ++numBits;
+        }
+    }
+
+    // Decoders add an entry for the final code too, which may widen the
+    // end-of-information code
+    writer.put(prefix, numBits);
+    if (++nextCode == CODE_MAX - 1)
+    {
+        writer.put(CODE_CLEAR, numBits);
+        numBits = BITS_MIN;
+    }
+    else if (nextCode > maxCode(numBits))
+    {
+        ++numBits;
+    }
+    writer.put(CODE_EOI, numBits);
+    writer.flush();
+}
+
+void tiff::Compression::lzwDecode(const unsigned char *input,
+                                  size_t numBytes,
+                                  unsigned char *output,
+                                  size_t outputSize)
+{
+    // Each code is stored as its prefix code plus a final byte
+    std::vector<unsigned short> prefixes(CODE_MAX + 1);
+    std::vector<unsigned char> suffixes(CODE_MAX + 1);
+    std::vector<unsigned char> firstBytes(CODE_MAX + 1);
+    std::vector<unsigned short> lengths(CODE_MAX + 1);
+    for (unsigned int code = 0; code < 256; ++code)
+    {
+        suffixes[code] = firstBytes[code] = static_cast<unsigned char>(code);
+        lengths[code] = 1;
+    }
+
+    unsigned int numBits = BITS_MIN;
+    unsigned int nextCode = CODE_FIRST;
+    unsigned int oldCode = CODE_CLEAR;
+
+    sys::Uint32_T data = 0;
+    unsigned int bitsAvailable = 0;
+    size_t inputPos = 0;
+    size_t outputPos = 0;
+    while (true)
+    {
+        while (bitsAvailable < numBits && inputPos < numBytes)
+        {
+            data = (data << 8) | input[inputPos++];
+            bitsAvailable += 8;
+        }
+
+        // Some writers leave off the end-of-information code
+        if (bitsAvailable < numBits)
+            break;
+
+        bitsAvailable -= numBits;
+        const unsigned int code = (data >> bitsAvailable) & maxCode(numBits);
+        data &= (1 << bitsAvailable) - 1;
+
+        if (code == CODE_EOI)
+            break;
+
+        if (code == CODE_CLEAR)
+        {
+            numBits = BITS_MIN;
+            nextCode = CODE_FIRST;
+            oldCode = CODE_CLEAR;
+            continue;
+        }
+
+        if (oldCode == CODE_CLEAR)
+        {
+            if (code > 255)
+                throw except::Exception(Ctxt("Corrupt LZW data"));
+            if (outputPos >= outputSize)
+                throw except::Exception(Ctxt("LZW data exceeds the buffer size"));
+            output[outputPos++] = static_cast<unsigned char>(code);
+            oldCode = code;
+            continue;
+        }
+
+        // A code one past the end of the table is the previous string
+        // followed by its own first byte
+        unsigned int stringCode = code;
+        if (code == nextCode)
+            stringCode = oldCode;
+        else if (code > nextCode)
+            throw except::Exception(Ctxt("Corrupt LZW data"));
+
+        const size_t length = lengths[stringCode] + (code == nextCode ? 1 : 0);
+        if (length > outputSize - outputPos)
+            throw except::Exception(Ctxt("LZW data exceeds the buffer size"));
+
+        // Strings are stored back to front, so fill in from the end
+        unsigned char *const string = output + outputPos;
+        size_t pos = lengths[stringCode];
+        if (code == nextCode)
+            string[pos] = firstBytes[oldCode];
+        for (unsigned int ii = stringCode; pos > 0; ii = prefixes[ii])
+        {
+            string[--pos] = suffixes[ii];
+        }
+        outputPos += length;
+
+        if (nextCode <= CODE_MAX)
+        {
+            prefixes[nextCode] = static_cast<unsigned short>(oldCode);
+            suffixes[nextCode] = string[0];
+            firstBytes[nextCode] = firstBytes[oldCode];
+            lengths[nextCode] = static_cast<unsigned short>(lengths[oldCode] + 1);
+            ++nextCode;
+            if (nextCode >= maxCode(numBits) && numBits < BITS_MAX)
+                ++numBits;
+        }
+        oldCode = code;
+    }
+
+    memset(output + outputPos, 0, outputSize - outputPos);
+}
+
+void tiff::Compression::applyPredictor(unsigned char *data,
+                                       size_t numRows,
+                                       size_t numCols,
+                                       size_t samplesPerPixel,
+                                       size_t bytesPerSample)
+{
+    switch (bytesPerSample)
+    {
+    case 1:
+        applyPredictorImpl(data, numRows, numCols, samplesPerPixel);
+        break;
+    case 2:
+        applyPredictorImpl(reinterpret_cast<sys::Uint16_T *>(data),
+                           numRows, numCols, samplesPerPixel);
+        break;
+    default:
+        throw except::Exception(Ctxt(FmtX(
+                "Predictor is not supported for %d byte samples",
+                static_cast<int>(bytesPerSample))));
+    }
+}
+
+void tiff::Compression::undoPredictor(unsigned char *data,
+                                      size_t numRows,
+                                      size_t numCols,
+                                      size_t samplesPerPixel,
+                                      size_t bytesPerSample)
+{
+    switch (bytesPerSample)
+    {
+    case 1:
+        undoPredictorImpl(data, numRows, numCols, samplesPerPixel);
+        break;
+    case 2:
+        undoPredictorImpl(reinterpret_cast<sys::Uint16_T *>(data),
+                          numRows, numCols, samplesPerPixel);
+        break;
+    default:
+        throw except::Exception(Ctxt(FmtX(
+                "Predictor is not supported for %d byte samples",
+                static_cast<int>(bytesPerSample))));
+    }
+}
@@ -50,13 +50,13 @@ void tiff::FileReader::openFile(const std::string& fileName)
     mHeader.deserialize(mInput);
     
     mReverseBytes = mHeader.isDifferentByteOrdering();
-    sys::Uint32_T offset = mHeader.getIFDOffset();
+    sys::Uint64_T offset = mHeader.getIFDOffset();
     while (offset != 0)
     {
         tiff::ImageReader *imageReader = new tiff::ImageReader(&mInput);
 
         mInput.seek(offset, io::Seekable::START);
-        imageReader->process(mReverseBytes);
+        imageReader->process(mReverseBytes, mHeader.isBigTIFF());
         mImages.push_back(imageReader);
 
         offset = imageReader->getNextOffset();
@@ -65,7 +65,7 @@ void tiff::FileReader::openFile(const std::string& fileName)
 
 void tiff::FileReader::close()
 {
-    memset(&mHeader, 0, sizeof(mHeader));
+    mHeader = tiff::Header();
 
     mInput.close();
 
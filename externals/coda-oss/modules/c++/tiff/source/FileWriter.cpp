@@ -60,7 +60,7 @@ void tiff::FileWriter::openFile(const std::string& fileName)
 void tiff::FileWriter::close()
 {
     mIFDOffset = 0;
-    memset(&mHeader, 0, sizeof(mHeader));
+    mHeader = tiff::Header();
 
     mOutput.close();
 
@@ -95,18 +95,28 @@ tiff::ImageWriter *tiff::FileWriter::addImage()
         mIFDOffset = mImages.back()->getNextIFDOffset();
 
     std::auto_ptr<tiff::ImageWriter>
-        image(new tiff::ImageWriter(&mOutput, mIFDOffset));
+        image(new tiff::ImageWriter(&mOutput, mIFDOffset, mBigTIFF));
     mImages.push_back(image.get());
     tiff::ImageWriter* const writer = image.release();
 
     return writer;
 }
 
+void tiff::FileWriter::setBigTIFF(bool bigTIFF)
+{
+    if (mOutput.isOpen() && mOutput.tell() > 0)
+        throw except::Exception(Ctxt("setBigTIFF() must be called before writeHeader()"));
+
+    mBigTIFF = bigTIFF;
+}
+
 void tiff::FileWriter::writeHeader()
 {
+    mHeader = tiff::Header(mBigTIFF ? tiff::Header::BIGTIFF_ID :
+                                      tiff::Header::CLASSIC_ID);
     mHeader.serialize(mOutput);
 
     // Have to rewind a few bytes to write out the actual IFD offset.
     mIFDOffset = mOutput.tell();
-    mIFDOffset -= (int)sizeof(sys::Uint32_T);
+    mIFDOffset -= mBigTIFF ? sizeof(sys::Uint64_T) : sizeof(sys::Uint32_T);
 }
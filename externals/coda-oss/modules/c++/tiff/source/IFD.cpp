@@ -90,20 +90,43 @@ void tiff::IFD::deserialize(io::InputStream& input)
 
 void tiff::IFD::deserialize(io::InputStream& input, const bool reverseBytes)
 {
-    unsigned short ifdEntryCount;
-    input.read((sys::byte *)&ifdEntryCount, sizeof(ifdEntryCount));
-    if (reverseBytes)
-        ifdEntryCount = sys::byteSwap(ifdEntryCount);
+    deserialize(input, reverseBytes, false);
+}
+
+void tiff::IFD::deserialize(io::InputStream& input,
+                            const bool reverseBytes,
+                            const bool bigTIFF)
+{
+    sys::Uint64_T ifdEntryCount;
+    if (bigTIFF)
+    {
+        input.read((sys::byte *)&ifdEntryCount, sizeof(ifdEntryCount));
+        if (reverseBytes)
+            ifdEntryCount = sys::byteSwap(ifdEntryCount);
+    }
+    else
+    {
+        unsigned short count;
+        input.read((sys::byte *)&count, sizeof(count));
+        if (reverseBytes)
+            count = sys::byteSwap(count);
+        ifdEntryCount = count;
+    }
 
-    for (unsigned short i = 0; i < ifdEntryCount; i++)
+    for (sys::Uint64_T i = 0; i < ifdEntryCount; i++)
     {
         tiff::IFDEntry *entry = new tiff::IFDEntry();
-        entry->deserialize(input, reverseBytes);
+        entry->deserialize(input, reverseBytes, bigTIFF);
         mIFD[entry->getTagID()] = entry;
     }
 }
 
 void tiff::IFD::serialize(io::OutputStream& output)
+{
+    serialize(output, false);
+}
+
+void tiff::IFD::serialize(io::OutputStream& output, const bool bigTIFF)
 {
     io::Seekable *seekable =
             dynamic_cast<io::Seekable *>(&output);
@@ -113,17 +136,25 @@ void tiff::IFD::serialize(io::OutputStream& output)
     // Makes sure all data offsets are defined for each entry.
     // Keep the offset just past the end of the IFD.  This offset
     // is where the next potential image could be written.
-    sys::Uint32_T endOffset = finalize(seekable->tell());
+    sys::Uint64_T endOffset = finalize(seekable->tell(), bigTIFF);
 
     // Write out IFD entry count.
-    unsigned short ifdEntryCount = mIFD.size();
-    output.write((sys::byte *)&ifdEntryCount, sizeof(ifdEntryCount));
+    if (bigTIFF)
+    {
+        sys::Uint64_T ifdEntryCount = mIFD.size();
+        output.write((sys::byte *)&ifdEntryCount, sizeof(ifdEntryCount));
+    }
+    else
+    {
+        unsigned short ifdEntryCount = mIFD.size();
+        output.write((sys::byte *)&ifdEntryCount, sizeof(ifdEntryCount));
+    }
 
     // Write out each IFD entry.
     for (IFDType::const_iterator i = mIFD.begin(); i != mIFD.end(); ++i)
     {
         tiff::IFDEntry *entry = i->second;
-        entry->serialize(output);
+        entry->serialize(output, bigTIFF);
     }
 
     // Remember the current position in case there is another IFD after
@@ -131,8 +162,9 @@ void tiff::IFD::serialize(io::OutputStream& output)
     mNextIFDOffsetPosition = seekable->tell();
 
     // Write out the default next IFD location.
-    sys::Uint32_T nextOffset = 0;
-    output.write((sys::byte *)&nextOffset, sizeof(sys::Uint32_T));
+    const sys::Uint64_T nextOffset = 0;
+    output.write((sys::byte *)&nextOffset,
+                 tiff::IFDEntry::valueFieldSize(bigTIFF));
 
     // Seek the end of the IFD, the next image can begin here.
     seekable->seek(endOffset, io::Seekable::START);
@@ -177,10 +209,10 @@ sys::Uint32_T tiff::IFD::getImageLength()
     return *(tiff::GenericType<unsigned short> *)(*imageLength)[0];
 }
 
-sys::Uint32_T tiff::IFD::getImageSize()
+sys::Uint64_T tiff::IFD::getImageSize()
 {
-    sys::Uint32_T width = getImageWidth();
-    sys::Uint32_T length = getImageLength();
+    sys::Uint64_T width = getImageWidth();
+    sys::Uint64_T length = getImageLength();
     unsigned short elementSize = getElementSize();
 
     return width * length * elementSize;
@@ -210,21 +242,24 @@ unsigned short tiff::IFD::getElementSize()
     return bytesPerSample * getNumBands();
 }
 
-sys::Uint32_T tiff::IFD::finalize(const sys::Uint32_T offset)
+sys::Uint64_T tiff::IFD::finalize(const sys::Uint64_T offset,
+                                  const bool bigTIFF)
 {
     // Find the beginning offset to extra IFD data.  The IFD length is
     // the size of an IFD entry multiplied by the number of entries, plus
     // 4 bytes to hold the offset to the next IFD, and 2 bytes to hold the
-    // IFD entry count.
-    sys::Uint32_T dataOffset = offset + sizeof(short) + (mIFD.size()
-            * tiff::IFDEntry::sizeOf()) + sizeof(sys::Uint32_T);
+    // IFD entry count.  In BigTIFF, the offset and count are 8 bytes each.
+    const size_t countSize = bigTIFF ? sizeof(sys::Uint64_T) : sizeof(short);
+    sys::Uint64_T dataOffset = offset + countSize + (mIFD.size()
+            * tiff::IFDEntry::sizeOf(bigTIFF)) +
+            tiff::IFDEntry::valueFieldSize(bigTIFF);
 
     for (IFDType::iterator i = mIFD.begin(); i != mIFD.end(); ++i)
     {
         // Send in the current offset.  If the value size of the IFD entry
         // requires that data be placed outside the IFD entry, the offset that
         // is returned will be adjusted to compensate for that data.
-        dataOffset = i->second->finalize(dataOffset);
+        dataOffset = i->second->finalize(dataOffset, bigTIFF);
     }
 
     return dataOffset;
@@ -34,6 +34,11 @@
 
 
 void tiff::IFDEntry::serialize(io::OutputStream& output)
+{
+    serialize(output, false);
+}
+
+void tiff::IFDEntry::serialize(io::OutputStream& output, const bool bigTIFF)
 {
     io::Seekable *seekable =
             dynamic_cast<io::Seekable *>(&output);
@@ -42,14 +47,21 @@ void tiff::IFDEntry::serialize(io::OutputStream& output)
 
     output.write((sys::byte *)&mTag, sizeof(mTag));
     output.write((sys::byte *)&mType, sizeof(mType));
-    output.write((sys::byte *)&mCount, sizeof(mCount));
+    if (bigTIFF)
+    {
+        const sys::Uint64_T count = mCount;
+        output.write((sys::byte *)&count, sizeof(count));
+    }
+    else
+        output.write((sys::byte *)&mCount, sizeof(mCount));
 
+    const unsigned short fieldSize = valueFieldSize(bigTIFF);
     sys::Uint32_T size = mCount * tiff::Const::sizeOf(mType);
 
-    if (size > 4)
+    if (size > fieldSize)
     {
         // Keep the current position and jump to the write position.
-        sys::Uint32_T current = seekable->tell();
+        sys::Off_T current = seekable->tell();
         seekable->seek(mOffset, io::Seekable::START);
 
         // Write the values out at the current cursor position
@@ -61,20 +73,26 @@ void tiff::IFDEntry::serialize(io::OutputStream& output)
         seekable->seek(current, io::Seekable::START);
 
         // Write out the data offset.
-        output.write((sys::byte *)&mOffset, sizeof(mOffset));
+        if (bigTIFF)
+            output.write((sys::byte *)&mOffset, sizeof(mOffset));
+        else
+        {
+            const sys::Uint32_T offset = static_cast<sys::Uint32_T>(mOffset);
+            output.write((sys::byte *)&offset, sizeof(offset));
+        }
     }
     else
     {
-        for (sys::Uint32_T i = 0; i < mCount; ++i)
+        // The values are left-justified in the value field, which is
+        // padded out with zeros.
+        sys::byte field[sizeof(sys::Uint64_T)];
+        memset(field, 0, sizeof(field));
+        for (sys::Uint32_T i = 0, pos = 0; i < mCount; ++i)
         {
-            // The value must take up four bytes.  If the number of bytes is
-            // less than four, duplicate the value until you hit 4 bytes in length.
-            unsigned short iterations = (4 / mCount) / mValues[i]->size();
-
-            for (int j = 0; j < iterations; ++j)
-                output.write((sys::byte *)mValues[i]->data(),
-                        mValues[i]->size());
+            memcpy(field + pos, mValues[i]->data(), mValues[i]->size());
+            pos += mValues[i]->size();
         }
+        output.write(field, fieldSize);
     }
 }
 
@@ -84,6 +102,13 @@ void tiff::IFDEntry::deserialize(io::InputStream& input)
 }
 
 void tiff::IFDEntry::deserialize(io::InputStream& input, const bool reverseBytes)
+{
+    deserialize(input, reverseBytes, false);
+}
+
+void tiff::IFDEntry::deserialize(io::InputStream& input,
+                                 const bool reverseBytes,
+                                 const bool bigTIFF)
 {
     io::Seekable *seekable =
             dynamic_cast<io::Seekable*>(&input);
@@ -92,23 +117,54 @@ void tiff::IFDEntry::deserialize(io::InputStream& input, const bool reverseBytes
 
     input.read((char *)&mTag, sizeof(mTag));
     input.read((char *)&mType, sizeof(mType));
-    input.read((char *)&mCount, sizeof(mCount));
-    input.read((char *)&mOffset, sizeof(mOffset));
+    if (bigTIFF)
+    {
+        sys::Uint64_T count;
+        input.read((char *)&count, sizeof(count));
+        if (reverseBytes)
+            count = sys::byteSwap(count);
+        mCount = static_cast<sys::Uint32_T>(count);
+    }
+    else
+    {
+        input.read((char *)&mCount, sizeof(mCount));
+        if (reverseBytes)
+            mCount = sys::byteSwap(mCount);
+    }
+
+    // The value field holds either the values themselves or the offset
+    // to them
+    const unsigned short fieldSize = valueFieldSize(bigTIFF);
+    sys::byte field[sizeof(sys::Uint64_T)];
+    input.read(field, fieldSize);
 
     if (reverseBytes)
     {
         mTag = sys::byteSwap(mTag);
         mType =  sys::byteSwap(mType);
-        mCount = sys::byteSwap(mCount);
-        mOffset = sys::byteSwap(mOffset);
     }
 
     sys::Uint32_T size = mCount * tiff::Const::sizeOf(mType);
 
-    if (size > 4)
+    if (size > fieldSize)
     {
+        if (bigTIFF)
+        {
+            memcpy(&mOffset, field, sizeof(mOffset));
+            if (reverseBytes)
+                mOffset = sys::byteSwap(mOffset);
+        }
+        else
+        {
+            sys::Uint32_T offset;
+            memcpy(&offset, field, sizeof(offset));
+            if (reverseBytes)
+                offset = sys::byteSwap(offset);
+            mOffset = offset;
+        }
+
         // Keep the current position and jump to the read position.
-        sys::Uint32_T current = seekable->tell();
+        sys::Off_T current = seekable->tell();
         seekable->seek(mOffset, io::Seekable::START);
 
         // Read in the value(s);
@@ -137,15 +193,14 @@ void tiff::IFDEntry::deserialize(io::InputStream& input, const bool reverseBytes
     }
     else
     {
+        mOffset = 0;
         if (reverseBytes)
         {
-            // Re-reverse because a value may be less than 4 bytes.
-            mOffset = sys::byteSwap(mOffset);
             unsigned short elementSize = tiff::Const::sizeOf(mType);
-            sys::byteSwap((sys::byte*)&mOffset, elementSize, sizeof(mOffset)
-              / elementSize);
+            if (elementSize > 1)
+                sys::byteSwap(field, elementSize, fieldSize / elementSize);
         }
-        parseValues((unsigned char *)&mOffset);
+        parseValues((unsigned char *)field);
     }
 
     //try to retrieve the name as well
@@ -220,11 +275,17 @@ void tiff::IFDEntry::parseValues(const unsigned char *buffer)
 }
 
 sys::Uint32_T tiff::IFDEntry::finalize(const sys::Uint32_T offset)
+{
+    return static_cast<sys::Uint32_T>(finalize(offset, false));
+}
+
+sys::Uint64_T tiff::IFDEntry::finalize(const sys::Uint64_T offset,
+                                       const bool bigTIFF)
 {
     mCount = mValues.size();
 
     sys::Uint32_T size = mCount * tiff::Const::sizeOf(mType);
-    if (size > 4)
+    if (size > valueFieldSize(bigTIFF))
     {
         mOffset = offset;
         return offset + size;
@@ -232,3 +293,27 @@ sys::Uint32_T tiff::IFDEntry::finalize(const sys::Uint32_T offset)
 
     return offset;
 }
+
+sys::Uint64_T tiff::IFDEntry::getUnsignedValue(const sys::Uint32_T index) const
+{
+    if (index >= mValues.size())
+        throw except::Exception(Ctxt(FmtX(
+                "Index %d out of range for entry %s", index, mName.c_str())));
+
+    switch (mType)
+    {
+    case tiff::Const::Type::BYTE:
+        return *(tiff::GenericType<unsigned char> *)mValues[index];
+    case tiff::Const::Type::SHORT:
+        return *(tiff::GenericType<unsigned short> *)mValues[index];
+    case tiff::Const::Type::LONG:
+    case tiff::Const::Type::IFD:
+        return *(tiff::GenericType<sys::Uint32_T> *)mValues[index];
+    case tiff::Const::Type::LONG8:
+    case tiff::Const::Type::IFD8:
+        return *(tiff::GenericType<sys::Uint64_T> *)mValues[index];
+    default:
+        throw except::Exception(Ctxt(FmtX(
+                "Entry %s is not an unsigned integer", mName.c_str())));
+    }
+}
@@ -22,28 +22,51 @@
 
 #include "tiff/ImageReader.h"
 
+#include <algorithm>
 #include <sstream>
+#include <string.h>
 #include <import/io.h>
 #include <import/except.h>
 #include "tiff/Common.h"
+#include "tiff/Compression.h"
 #include "tiff/GenericType.h"
 #include "tiff/IFDEntry.h"
 
-void tiff::ImageReader::process(const bool reverseBytes)
+void tiff::ImageReader::process(const bool reverseBytes, const bool bigTIFF)
 {
     mReverseBytes = reverseBytes;
 
-    mIFD.deserialize(*mInput, mReverseBytes);
+    mIFD.deserialize(*mInput, mReverseBytes, bigTIFF);
 
-    mInput->read((sys::byte *)&mNextOffset, sizeof(mNextOffset));
-    if (mReverseBytes)
-        mNextOffset = sys::byteSwap(mNextOffset);
+    if (bigTIFF)
+    {
+        mInput->read((sys::byte *)&mNextOffset, sizeof(mNextOffset));
+        if (mReverseBytes)
+            mNextOffset = sys::byteSwap(mNextOffset);
+    }
+    else
+    {
+        sys::Uint32_T nextOffset;
+        mInput->read((sys::byte *)&nextOffset, sizeof(nextOffset));
+        if (mReverseBytes)
+            nextOffset = sys::byteSwap(nextOffset);
+        mNextOffset = nextOffset;
+    }
 
     // Done here to lower the number of calls to it later.
     mElementSize = mIFD.getElementSize();
 
     mStripByteCounts = mIFD["StripByteCounts"];
     mStripOffsets = mIFD["StripOffsets"];
+
+    tiff::IFDEntry *compression = mIFD["Compression"];
+    mCompression = compression ?
+            *(tiff::GenericType<unsigned short> *)(*compression)[0] :
+            (unsigned short)tiff::Const::CompressionType::NO_COMPRESSION;
+
+    tiff::IFDEntry *predictor = mIFD["Predictor"];
+    mPredictor = predictor &&
+            *(tiff::GenericType<unsigned short> *)(*predictor)[0] == 2;
 }
 
 void tiff::ImageReader::print(io::OutputStream &output) const
@@ -59,13 +82,13 @@ void tiff::ImageReader::print(io::OutputStream &output) const
 void tiff::ImageReader::getData(unsigned char *buffer,
         const sys::Uint32_T numElementsToRead)
 {
-    //see if it is uncompressed
-    tiff::IFDEntry *compression = mIFD["Compression"];
-    if (compression)
+    //see if it is uncompressed, or LZW compressed tiles
+    if (mCompression != tiff::Const::CompressionType::NO_COMPRESSION &&
+        !(mCompression == tiff::Const::CompressionType::LZW &&
+          mIFD["TileOffsets"]))
     {
-        unsigned short c = *(tiff::GenericType<unsigned short> *)(*compression)[0];
-        if (c != tiff::Const::CompressionType::NO_COMPRESSION)
-            throw except::Exception(Ctxt(FmtX("Unsupported compression type: %d", c)));
+        throw except::Exception(Ctxt(FmtX("Unsupported compression type: %d",
+                                          mCompression)));
     }
     
     if (mIFD["StripOffsets"])
@@ -82,38 +105,38 @@ void tiff::ImageReader::getData(unsigned char *buffer,
 void tiff::ImageReader::getStripData(unsigned char *buffer,
         sys::Uint32_T numElementsToRead)
 {
-    sys::Uint32_T bufferOffset = 0;
+    size_t bufferOffset = 0;
     
     //figure out how far we are in the current strip
-    sys::Uint32_T stripOffset = 0;
+    sys::Uint64_T stripOffset = 0;
     for (size_t i = 0; i < mStripIndex; ++i)
-        stripOffset += *(tiff::GenericType<sys::Uint32_T> *)(*mStripByteCounts)[i];
-    sys::Uint32_T stripPosition = mBytePosition - stripOffset;
+        stripOffset += mStripByteCounts->getUnsignedValue(i);
+    sys::Uint64_T stripPosition = mBytePosition - stripOffset;
     
     //how many bytes do we need to read?
-    sys::Uint32_T numBytesToRead = numElementsToRead * mElementSize;
+    size_t numBytesToRead = static_cast<size_t>(numElementsToRead) * mElementSize;
 
     while (numBytesToRead)
     {
         if (mStripIndex >= mStripOffsets->getCount())
             throw except::Exception(Ctxt("Invalid strip offset index"));
 
-        sys::Uint32_T stripSize = *(tiff::GenericType<sys::Uint32_T> *)(*mStripByteCounts)[mStripIndex];
+        sys::Uint64_T stripSize = mStripByteCounts->getUnsignedValue(mStripIndex);
 
         // Calculate what remains to be read in the current strip.
-        sys::Uint32_T remainingBytesInStrip = stripSize - stripPosition;
+        sys::Uint64_T remainingBytesInStrip = stripSize - stripPosition;
 
         // Seek to the strip offset plus the last read position.
-        sys::Uint32_T seekPos = (*(tiff::GenericType<sys::Uint32_T> *)(*mStripOffsets)[mStripIndex]) + stripPosition;
+        sys::Uint64_T seekPos = mStripOffsets->getUnsignedValue(mStripIndex) + stripPosition;
 
         
-        sys::Uint32_T thisRead = numBytesToRead;
+        size_t thisRead = numBytesToRead;
         
         // If the total number of bytes to read exceeds the bytes remaining
         // in the current strip, just read what can be read from the current strip.
         if (numBytesToRead > remainingBytesInStrip)
         {
-            thisRead = remainingBytesInStrip;
+            thisRead = static_cast<size_t>(remainingBytesInStrip);
             mStripIndex++; //increment the strip index for next time
         }
         
@@ -137,73 +160,67 @@ void tiff::ImageReader::getTileData(unsigned char*buffer,
         sys::Uint32_T numElementsToRead)
 {
     // Get the image width and length.
-    sys::Uint32_T imageElemWidth = mIFD.getImageWidth();
-    sys::Uint32_T imageByteWidth = imageElemWidth * mElementSize;
-
-    // Get the tile width.
-    tiff::IFDEntry *tileWidth = mIFD["TileWidth"];
-    sys::Uint32_T tileElemWidth = 0;
-    if (tileWidth->getType() == tiff::Const::Type::LONG)
-        tileElemWidth = *(tiff::GenericType<sys::Uint32_T> *)(*tileWidth)[0];
-    else
-        tileElemWidth = *(tiff::GenericType<unsigned short> *)(*tileWidth)[0];
-    sys::Uint32_T tileByteWidth = tileElemWidth * mElementSize;
-
-    // Get the tile length.
-    tiff::IFDEntry *tileLength = mIFD["TileLength"];
-    sys::Uint32_T tileElemLength = 0;
-    if (tileLength->getType() == tiff::Const::Type::LONG)
-        tileElemLength = *(tiff::GenericType<sys::Uint32_T> *)(*tileLength)[0];
-    else
-        tileElemLength = *(tiff::GenericType<unsigned short> *)(*tileLength)[0];
+    size_t imageElemWidth = mIFD.getImageWidth();
+    size_t imageByteWidth = imageElemWidth * mElementSize;
+
+    // Get the tile width and length, which may be SHORT or LONG.
+    size_t tileElemWidth = static_cast<size_t>(mIFD["TileWidth"]->getUnsignedValue(0));
+    size_t tileByteWidth = tileElemWidth * mElementSize;
+    size_t tileElemLength = static_cast<size_t>(mIFD["TileLength"]->getUnsignedValue(0));
 
     // Compute the number of tiles wide the image is.
-    sys::Uint32_T tilesAcross = (imageElemWidth + tileElemWidth - 1)
-            / tileElemWidth;
+    size_t tilesAcross = (imageElemWidth + tileElemWidth - 1) / tileElemWidth;
 
-    // Determine how many bytes were used to pad the right edge.
-    sys::Uint32_T widthPadding = (tileByteWidth * tilesAcross) - imageByteWidth;
-    sys::Uint32_T bufferOffset = 0;
+    tiff::IFDEntry *tileOffsets = mIFD["TileOffsets"];
+    size_t bufferOffset = 0;
 
     while (numElementsToRead)
     {
-        sys::Uint32_T bytesToRead = mElementSize * numElementsToRead;
+        size_t bytesToRead = static_cast<size_t>(numElementsToRead) * mElementSize;
 
         // Compute the row in image, row in tile, and tile row.
-        sys::Uint32_T row = mBytePosition / imageByteWidth;
-        sys::Uint32_T tileRow = row / tileElemLength;
-        sys::Uint32_T rowInTile = row % tileElemLength;
+        size_t row = static_cast<size_t>(mBytePosition / imageByteWidth);
+        size_t tileRow = row / tileElemLength;
+        size_t rowInTile = row % tileElemLength;
 
         // Compute the column in image, column in tile, and tile column.
-        sys::Uint32_T column = mBytePosition - (row * imageByteWidth);
-        sys::Uint32_T tileColumn = column / tileByteWidth;
-        sys::Uint32_T colInTile = column % tileByteWidth;
+        size_t column = static_cast<size_t>(mBytePosition - (static_cast<sys::Uint64_T>(row) * imageByteWidth));
+        size_t tileColumn = column / tileByteWidth;
+        size_t colInTile = column % tileByteWidth;
 
         // Compute the 1D tile index from the tile row and tile column.
-        sys::Uint32_T tileIndex = (tileRow * tilesAcross) + tileColumn;
+        size_t tileIndex = (tileRow * tilesAcross) + tileColumn;
 
-        sys::Uint32_T paddedBytes = ((tileColumn + 1) / tilesAcross)
-                * widthPadding;
-
-        sys::Uint32_T remainingBytesThisLine = tileByteWidth - (paddedBytes
-                + (column % tileByteWidth));
+        // The last tile in a row may be padded past the image's edge.
+        size_t remainingBytesThisLine = std::min(tileByteWidth,
+                imageByteWidth - tileColumn * tileByteWidth) - colInTile;
 
         // If the total number of bytes to read exceeds the bytes remaining
         // in the current line of the current tile, just read what can be 
         // read from the current tile.
-        if (bytesToRead> remainingBytesThisLine)
+        if (bytesToRead > remainingBytesThisLine)
             bytesToRead = remainingBytesThisLine;
 
-        // Seek to the tile offset plus the last read position.
-        tiff::IFDEntry *tileOffsets = mIFD["TileOffsets"];
-        sys::Uint32_T seekPos = (*(tiff::GenericType<sys::Uint32_T> *)(*tileOffsets)[tileIndex]) + (rowInTile * tileByteWidth)
-                + colInTile;
+        if (mCompression == tiff::Const::CompressionType::NO_COMPRESSION)
+        {
+            // Seek to the tile offset plus the last read position.
+            sys::Uint64_T seekPos = tileOffsets->getUnsignedValue(tileIndex) +
+                    (rowInTile * tileByteWidth) + colInTile;
 
-        // Go to the offset.
-        mInput->seek(seekPos, io::Seekable::START);
+            // Go to the offset.
+            mInput->seek(seekPos, io::Seekable::START);
 
-        // Read the data.
-        mInput->read((sys::byte *)buffer + bufferOffset, bytesToRead);
+            // Read the data.
+            mInput->read((sys::byte *)buffer + bufferOffset, bytesToRead);
+        }
+        else
+        {
+            const unsigned char *tile = loadTile(tileRow, tileColumn,
+                    tilesAcross, tileByteWidth, tileElemLength);
+            memcpy(buffer + bufferOffset,
+                   tile + (rowInTile * tileByteWidth) + colInTile,
+                   bytesToRead);
+        }
 
         // Update the strip position in bytes.
         mBytePosition += bytesToRead;
@@ -213,3 +230,63 @@ void tiff::ImageReader::getTileData(unsigned char*buffer,
         numElementsToRead -= (bytesToRead / mElementSize);
     }
 }
+
+const unsigned char *tiff::ImageReader::loadTile(size_t tileRow,
+                                                 size_t tileColumn,
+                                                 size_t tilesAcross,
+                                                 size_t tileByteWidth,
+                                                 size_t tileLength)
+{
+    if (!mTileRowLoaded || mTileRow != tileRow)
+    {
+        mTiles.clear();
+        mTiles.resize(tilesAcross);
+        mTileRow = tileRow;
+        mTileRowLoaded = true;
+    }
+
+    std::vector<unsigned char>& tile = mTiles[tileColumn];
+    if (!tile.empty())
+        return &tile[0];
+
+    const size_t tileIndex = tileRow * tilesAcross + tileColumn;
+    tiff::IFDEntry *tileOffsets = mIFD["TileOffsets"];
+    tiff::IFDEntry *tileByteCounts = mIFD["TileByteCounts"];
+    if (!tileByteCounts || tileIndex >= tileOffsets->getCount() ||
+        tileIndex >= tileByteCounts->getCount())
+        throw except::Exception(Ctxt("Invalid tile index"));
+
+    std::vector<unsigned char> compressed(static_cast<size_t>(
+            tileByteCounts->getUnsignedValue(tileIndex)));
+    if (!compressed.empty())
+    {
+        mInput->seek(tileOffsets->getUnsignedValue(tileIndex),
+                     io::Seekable::START);
+        mInput->read((sys::byte *)&compressed[0], compressed.size());
+    }
+
+    const size_t tileSize = tileByteWidth * tileLength;
+    tile.resize(tileSize);
+    tiff::Compression::lzwDecode(compressed.empty() ? NULL : &compressed[0],
+                                 compressed.size(), &tile[0], tile.size());
+
+    if (mPredictor)
+    {
+        // Differences are taken between samples in native byte order
+        const size_t samplesPerPixel = mIFD.getNumBands();
+        const size_t bytesPerSample = mElementSize / samplesPerPixel;
+        const size_t numSamples = tileSize / bytesPerSample;
+        const bool swap = mReverseBytes && bytesPerSample > 1;
+        if (swap)
+            sys::byteSwap((sys::byte *)&tile[0], bytesPerSample, numSamples);
+
+        tiff::Compression::undoPredictor(&tile[0], tileLength,
+                                         tileByteWidth / mElementSize,
+                                         samplesPerPixel, bytesPerSample);
+
+        if (swap)
+            sys::byteSwap((sys::byte *)&tile[0], bytesPerSample, numSamples);
+    }
+
+    return &tile[0];
+}
@@ -22,13 +22,115 @@
 
 #include "tiff/ImageWriter.h"
 
+#include <algorithm>
 #include <sstream>
 #include <cmath>
+#include <string.h>
 #include <import/except.h>
+#include <mt/ThreadGroup.h>
+#include <sys/AtomicCounter.h>
+#include <sys/OS.h>
+#include <sys/Runnable.h>
 
 #include "tiff/Common.h"
+#include "tiff/Compression.h"
 #include "tiff/GenericType.h"
 #include "tiff/IFDEntry.h"
+#include "tiff/KnownTags.h"
+#include "tiff/TypeFactory.h"
+
+namespace
+{
+// Adds an empty offsets entry, which holds 64 bit values in a BigTIFF
+void addOffsetsEntry(tiff::IFD& ifd, const std::string& name, bool bigTIFF)
+{
+    if (!bigTIFF)
+    {
+        ifd.addEntry(name);
+        return;
+    }
+
+    tiff::IFDEntry *knownEntry = tiff::KnownTagsRegistry::getInstance()[name];
+    const tiff::IFDEntry entry(knownEntry->getTagID(),
+                               tiff::Const::Type::LONG8, name);
+    ifd.addEntry(&entry);
+}
+
+// Cuts tiles out of a row of tiles and compresses them
+class TileCompressor : public sys::Runnable
+{
+public:
+    TileCompressor(const unsigned char *tileRow,
+                   size_t imageByteWidth,
+                   size_t numRows,
+                   size_t tileByteWidth,
+                   size_t tileLength,
+                   unsigned short elementSize,
+                   size_t samplesPerPixel,
+                   bool predictor,
+                   sys::AtomicCounter& nextTile,
+                   std::vector<std::vector<unsigned char> >& tiles) :
+        mTileRow(tileRow),
+        mImageByteWidth(imageByteWidth),
+        mNumRows(numRows),
+        mTileByteWidth(tileByteWidth),
+        mTileLength(tileLength),
+        mElementSize(elementSize),
+        mSamplesPerPixel(samplesPerPixel),
+        mPredictor(predictor),
+        mNextTile(nextTile),
+        mTiles(tiles)
+    {
+    }
+
+    virtual void run()
+    {
+        std::vector<unsigned char> tile(mTileByteWidth * mTileLength);
+        while (true)
+        {
+            const size_t index =
+                    static_cast<size_t>(mNextTile.getThenIncrement());
+            if (index >= mTiles.size())
+                break;
+
+            // Copy the tile out of the row, zero padding the right and
+            // bottom edges
+            std::fill(tile.begin(), tile.end(), 0);
+            const size_t startByte = index * mTileByteWidth;
+            const size_t numBytes = std::min(mTileByteWidth,
+                                             mImageByteWidth - startByte);
+            for (size_t row = 0; row < mNumRows; ++row)
+            {
+                memcpy(&tile[row * mTileByteWidth],
+                       mTileRow + row * mImageByteWidth + startByte,
+                       numBytes);
+            }
+
+            if (mPredictor)
+            {
+                tiff::Compression::applyPredictor(
+                        &tile[0], mTileLength,
+                        mTileByteWidth / mElementSize, mSamplesPerPixel,
+                        mElementSize / mSamplesPerPixel);
+            }
+            tiff::Compression::lzwEncode(&tile[0], tile.size(),
+                                         mTiles[index]);
+        }
+    }
+
+private:
+    const unsigned char * const mTileRow;
+    const size_t mImageByteWidth;
+    const size_t mNumRows;
+    const size_t mTileByteWidth;
+    const size_t mTileLength;
+    const unsigned short mElementSize;
+    const size_t mSamplesPerPixel;
+    const bool mPredictor;
+    sys::AtomicCounter& mNextTile;
+    std::vector<std::vector<unsigned char> >& mTiles;
+};
+}
 
 const unsigned short tiff::ImageWriter::CHUNK_SIZE = 8192;
 
@@ -50,17 +152,26 @@ void tiff::ImageWriter::putData(const unsigned char *buffer,
 void tiff::ImageWriter::writeIFD()
 {
     // Retain the current file offset.
-    sys::Uint32_T offset = mOutput->tell();
+    const sys::Uint64_T offset = mOutput->tell();
 
     // Seek to the position to write the current offset to.
     mOutput->seek(mIFDOffset, io::Seekable::START);
 
     // Write the current offset.
-    mOutput->write((sys::byte *)&offset, sizeof(offset));
+    if (mBigTIFF)
+        mOutput->write((sys::byte *)&offset, sizeof(offset));
+    else
+    {
+        if (offset > 0xFFFFFFFF)
+            throw except::Exception(Ctxt("TIFF files larger than 4GB must be written as BigTIFF"));
+
+        const sys::Uint32_T classicOffset = static_cast<sys::Uint32_T>(offset);
+        mOutput->write((sys::byte *)&classicOffset, sizeof(classicOffset));
+    }
 
     // Reseek to the current offset and write out the IFD.
     mOutput->seek(offset, io::Seekable::START);
-    mIFD.serialize(*mOutput);
+    mIFD.serialize(*mOutput, mBigTIFF);
 
     // Keep the position in the file that the offset to the next
     // IFD can be written to, in case there is another IFD.
@@ -88,7 +199,13 @@ void tiff::ImageWriter::validate()
         mIFD.addEntry("Compression", (unsigned short) 1);
     else
     {
-        if (*(tiff::GenericType<unsigned short> *)(*compression)[0] != 1)
+        mCompression = *(tiff::GenericType<unsigned short> *)(*compression)[0];
+        if (mCompression == tiff::Const::CompressionType::LZW)
+        {
+            if (mFormat != TILED)
+                throw except::Exception(Ctxt("Compression is only supported for tiled images"));
+        }
+        else if (mCompression != tiff::Const::CompressionType::NO_COMPRESSION)
             throw except::Exception(Ctxt("Unsupported compression type"));
     }
 
@@ -203,6 +320,30 @@ void tiff::ImageWriter::validate()
 
     mElementSize = mIFD.getElementSize();
 
+    // Predictor
+    tiff::IFDEntry *predictor = mIFD["Predictor"];
+    if (predictor)
+    {
+        unsigned short value = *(tiff::GenericType<unsigned short> *)(*predictor)[0];
+        if (value == 2)
+        {
+            if (mCompression != tiff::Const::CompressionType::LZW)
+                throw except::Exception(Ctxt("Predictor requires LZW compression"));
+
+            tiff::IFDEntry *sampleFormat = mIFD["SampleFormat"];
+            if (sampleFormat && *(tiff::GenericType<unsigned short> *)(*sampleFormat)[0] ==
+                    tiff::Const::SampleFormatType::IEEE_FLOAT)
+                throw except::Exception(Ctxt("Predictor is not supported for floating point samples"));
+
+            if (!tiff::Compression::isPredictorSupported(mElementSize / mIFD.getNumBands()))
+                throw except::Exception(Ctxt("Predictor is only supported for 8 and 16 bit samples"));
+
+            mPredictor = true;
+        }
+        else if (value != 1)
+            throw except::Exception(Ctxt("Unsupported predictor"));
+    }
+
     if (mFormat == TILED)
         initTiles();
     else
@@ -228,6 +369,25 @@ void tiff::ImageWriter::validate()
     mValidated = true;
 }
 
+void tiff::ImageWriter::addOffset(tiff::IFDEntry *entry,
+                                  const sys::Uint64_T offset)
+{
+    if (mBigTIFF)
+    {
+        entry->addValue(tiff::TypeFactory::create((unsigned char *)&offset,
+                                                  entry->getType()));
+    }
+    else
+    {
+        if (offset > 0xFFFFFFFF)
+            throw except::Exception(Ctxt("TIFF files larger than 4GB must be written as BigTIFF"));
+
+        const sys::Uint32_T classicOffset = static_cast<sys::Uint32_T>(offset);
+        entry->addValue(tiff::TypeFactory::create(
+                (unsigned char *)&classicOffset, entry->getType()));
+    }
+}
+
 void tiff::ImageWriter::initTiles()
 {
     sys::Uint32_T root = (sys::Uint32_T)sqrt((double)mIdealChunkSize
@@ -238,30 +398,20 @@ void tiff::ImageWriter::initTiles()
     mIFD.addEntry("TileWidth", (sys::Uint32_T) tileSize);
     mIFD.addEntry("TileLength", (sys::Uint32_T) tileSize);
 
-    sys::Uint32_T fileOffset = mOutput->tell();
-    sys::Uint32_T tilesAcross = (mIFD.getImageWidth() + tileSize - 1)
-            / tileSize;
-    sys::Uint32_T tilesDown = (mIFD.getImageLength() + tileSize - 1) / tileSize;
-
-    unsigned short elementSize = mIFD.getElementSize();
-
+    // Offsets and byte counts are added as each tile is written, since
+    // compressed tiles vary in size.
     mIFD.addEntry("TileByteCounts");
-    mIFD.addEntry("TileOffsets");
-    for (sys::Uint32_T y = 0; y < tilesDown; ++y)
-    {
-        for (sys::Uint32_T x = 0; x < tilesAcross; ++x)
-        {
-            sys::Uint32_T byteCount = tileSize * tileSize * elementSize;
-            mIFD.addEntryValue("TileOffsets", (sys::Uint32_T) fileOffset);
-            mIFD.addEntryValue("TileByteCounts", (sys::Uint32_T) byteCount);
-            fileOffset += byteCount;
-        }
-    }
+    addOffsetsEntry(mIFD, "TileOffsets", mBigTIFF);
 
     mTileOffsets = mIFD["TileOffsets"];
     mTileWidth = mIFD["TileWidth"];
     mTileLength = mIFD["TileLength"];
     mTileByteCounts = mIFD["TileByteCounts"];
+
+    const size_t imageByteWidth =
+            static_cast<size_t>(mIFD.getImageWidth()) * mElementSize;
+    mTileRow.resize(imageByteWidth * tileSize);
+    mTileRowSize = 0;
 }
 
 void tiff::ImageWriter::initStrips()
@@ -286,25 +436,27 @@ void tiff::ImageWriter::initStrips()
             (sys::Uint32_T)floor(static_cast<double>(length + rowsPerStrip - 1)
                     / static_cast<double>(rowsPerStrip));
 
-    sys::Uint32_T offset = mOutput->tell();
+    sys::Uint64_T offset = mOutput->tell();
 
     // Add counts and offsets for all but the last strip.
-    mIFD.addEntry("StripOffsets");
+    addOffsetsEntry(mIFD, "StripOffsets", mBigTIFF);
     mIFD.addEntry("StripByteCounts");
+    tiff::IFDEntry *stripOffsets = mIFD["StripOffsets"];
     for (sys::Uint32_T i = 0; i < stripsPerImage - 1; ++i)
     {
-        mIFD.addEntryValue("StripOffsets", (sys::Uint32_T) offset);
+        addOffset(stripOffsets, offset);
         mIFD.addEntryValue("StripByteCounts", (sys::Uint32_T) stripByteCount);
         offset += stripByteCount;
     }
 
     // Add the last offset.
-    mIFD.addEntryValue("StripOffsets", (sys::Uint32_T) offset);
+    addOffset(stripOffsets, offset);
 
     // The last byte count can be less than the previous counts.  This occurs
     // (for example) if RowsPerStrip is even, and ImageLength is odd.
-    sys::Uint32_T remainingBytes = mIFD.getImageSize() - ((stripsPerImage - 1)
-            * stripByteCount);
+    sys::Uint32_T remainingBytes = static_cast<sys::Uint32_T>(
+            mIFD.getImageSize() - (static_cast<sys::Uint64_T>(stripsPerImage - 1)
+                    * stripByteCount));
 
     // Add the last byteCount.
     mIFD.addEntryValue("StripByteCounts", remainingBytes);
@@ -314,162 +466,118 @@ void tiff::ImageWriter::initStrips()
 void tiff::ImageWriter::putTileData(const unsigned char *buffer,
                                     sys::Uint32_T numElementsToWrite)
 {
-    sys::Uint32_T imageElemWidth = mIFD.getImageWidth();
-    sys::Uint32_T imageByteWidth = imageElemWidth * mElementSize;
-
-    sys::Uint32_T tileElemWidth = *(tiff::GenericType<sys::Uint32_T> *)(*mTileWidth)[0];
-    sys::Uint32_T tileByteWidth = tileElemWidth * mElementSize;
-
-    unsigned short tileElemLength = *(tiff::GenericType<sys::Uint32_T> *)(*mTileLength)[0];
-
-    // Compute the number of tiles wide the image is.
-    sys::Uint32_T tilesAcross = (imageElemWidth + tileElemWidth - 1)
-            / tileElemWidth;
-
-    // Determine how many bytes were used to pad the right edge.
-    sys::Uint32_T widthPadding = (tileByteWidth * tilesAcross) - imageByteWidth;
-    sys::Uint32_T globalReadOffset = 0;
-    sys::Uint32_T tempBytePosition = mBytePosition;
-    sys::Uint32_T numBytesToWrite = numElementsToWrite * mElementSize;
-    sys::Uint32_T currentNumBytesRead = 0;
-    sys::Uint32_T remainingElementsToWrite = numElementsToWrite;
-    while (remainingElementsToWrite)
+    const sys::Uint64_T imageSize = mIFD.getImageSize();
+    const size_t numBytesToWrite =
+            static_cast<size_t>(numElementsToWrite) * mElementSize;
+    if (mBytePosition + numBytesToWrite > imageSize)
+        throw except::Exception(Ctxt("Cannot write past the end of the image"));
+
+    // Fill the row of tiles, writing it out each time it is complete
+    size_t bufferOffset = 0;
+    while (bufferOffset < numBytesToWrite)
     {
-        if (((mBytePosition + currentNumBytesRead) / imageByteWidth)
-                / tileElemLength > (tempBytePosition / imageByteWidth)
-                / tileElemLength)
-        {
-            tempBytePosition = mBytePosition + currentNumBytesRead;
-            globalReadOffset = currentNumBytesRead;
-        }
-
-        // Compute the row and tile row.
-        sys::Uint32_T row = tempBytePosition / imageByteWidth;
-        sys::Uint32_T tileRow = row / tileElemLength;
-
-        // Compute the column and tile column.
-        sys::Uint32_T column = tempBytePosition - (row * imageByteWidth);
-        sys::Uint32_T tileColumn = column / tileByteWidth;
-
-        // Compute the 1D tile index from the tile row and tile column.
-        sys::Uint32_T tileIndex = (tileRow * tilesAcross) + tileColumn;
-
-        sys::Uint32_T tileByteCount = *(tiff::GenericType<sys::Uint32_T> *)(*mTileByteCounts)[tileIndex];
-
-        sys::Uint32_T rowInTile = row % tileElemLength;
-        sys::Uint32_T paddedBytes = ((tileColumn + 1) / tilesAcross)
-                * widthPadding;
-
-        sys::Uint32_T remainingBytesInTile = tileByteCount - (tileElemLength
-                * paddedBytes) - (rowInTile * (tileByteWidth - paddedBytes)
-                + (column % tileByteWidth));
-
-        tempBytePosition += tileByteWidth - (paddedBytes + (column
-                % tileByteWidth));
+        const size_t numBytes = std::min(numBytesToWrite - bufferOffset,
+                                         mTileRow.size() - mTileRowSize);
+        memcpy(&mTileRow[mTileRowSize], buffer + bufferOffset, numBytes);
+        mTileRowSize += numBytes;
+        bufferOffset += numBytes;
+        mBytePosition += numBytes;
+
+        if (mTileRowSize == mTileRow.size() || mBytePosition == imageSize)
+            writeTileRow();
+    }
+}
 
-        sys::byte *copyBuffer = new sys::byte[tileByteWidth * tileElemLength];
-        memset(copyBuffer, 0, tileByteWidth * tileElemLength);
-        sys::Uint32_T copyOffset = 0;
-        sys::Uint32_T readOffset = 0;
-        sys::Uint32_T tempColumn = column;
-        unsigned short iteration = 0;
-        while (readOffset < numBytesToWrite)
+void tiff::ImageWriter::writeTileRow()
+{
+    const size_t imageByteWidth =
+            static_cast<size_t>(mIFD.getImageWidth()) * mElementSize;
+    const size_t tileByteWidth = static_cast<size_t>(
+            *(tiff::GenericType<sys::Uint32_T> *)(*mTileWidth)[0]) * mElementSize;
+    const size_t tileLength =
+            *(tiff::GenericType<sys::Uint32_T> *)(*mTileLength)[0];
+    const size_t tilesAcross =
+            (imageByteWidth + tileByteWidth - 1) / tileByteWidth;
+
+    // The last row of tiles may be only partially filled
+    const size_t numRows = mTileRowSize / imageByteWidth;
+
+    std::vector<std::vector<unsigned char> > tiles(tilesAcross);
+    if (mCompression == tiff::Const::CompressionType::NO_COMPRESSION)
+    {
+        for (size_t ii = 0; ii < tilesAcross; ++ii)
         {
-            sys::Uint32_T remainingBytesThisLine = tileByteWidth - (paddedBytes
-                    + (tempColumn % tileByteWidth));
-
-            sys::Uint32_T numBytesToCopy = remainingBytesThisLine;
+            std::vector<unsigned char>& tile = tiles[ii];
+            tile.resize(tileByteWidth * tileLength);
 
-            if (!remainingBytesInTile)
-                break;
-
-            if (iteration == 0)
-            {
-                iteration++;
-                readOffset = globalReadOffset;
-                globalReadOffset += numBytesToCopy;
-            }
-
-            if (numBytesToCopy > numBytesToWrite - readOffset)
-                numBytesToCopy = numBytesToWrite - readOffset;
-
-            if (paddedBytes)
+            const size_t startByte = ii * tileByteWidth;
+            const size_t numBytes = std::min(tileByteWidth,
+                                             imageByteWidth - startByte);
+            for (size_t row = 0; row < numRows; ++row)
             {
-                if (((tempColumn % tileByteWidth) + numBytesToCopy)
-                        / (tileByteWidth - paddedBytes) == 0)
-                    paddedBytes = 0;
+                memcpy(&tile[row * tileByteWidth],
+                       &mTileRow[row * imageByteWidth + startByte],
+                       numBytes);
             }
-
-            memcpy(copyBuffer + copyOffset, buffer + readOffset, numBytesToCopy);
-            copyOffset += (numBytesToCopy + paddedBytes);
-            readOffset += (imageByteWidth - (tempColumn % tileByteWidth));
-            tempColumn -= (tempColumn % tileByteWidth);
-            remainingBytesInTile -= numBytesToCopy;
-            remainingElementsToWrite -= (numBytesToCopy / mElementSize);
-            currentNumBytesRead += numBytesToCopy;
         }
-
-        sys::Uint32_T seekPos = *(tiff::GenericType<sys::Uint32_T> *)(*mTileOffsets)[tileIndex];
-        seekPos += (row % tileElemLength) * tileByteWidth;
-        seekPos += (column % tileByteWidth);
-        mOutput->seek(seekPos, io::Seekable::START);
-        mOutput->write(copyBuffer, copyOffset);
-        delete [] copyBuffer;
     }
-
-    mBytePosition += numBytesToWrite;
-
-    // All of the real data is in, just have to pad the bottom of the file.
-    if (mBytePosition == mIFD.getImageSize())
+    else
     {
-        sys::Uint32_T imageElemLength = mIFD.getImageLength();
-        sys::Uint32_T tilesDown = (imageElemLength + tileElemLength - 1)
-                / tileElemLength;
-        sys::Uint32_T startIndex = (tilesDown - 1) * tilesAcross;
-        sys::Uint32_T paddingStartLine = imageElemLength % tileElemLength;
-        if (paddingStartLine)
+        const size_t samplesPerPixel = mIFD.getNumBands();
+        const size_t numThreads = std::min(
+                mNumThreads == 0 ? sys::OS().getNumCPUsAvailable() :
+                                   mNumThreads,
+                tilesAcross);
+
+        sys::AtomicCounter nextTile;
+        if (numThreads <= 1)
         {
-            sys::Uint32_T paddedLines = tileElemLength - paddingStartLine;
-
-            sys::byte *padBuffer = new sys::byte[paddedLines * tileByteWidth];
-            memset(padBuffer, 0, paddedLines * tileByteWidth);
-
-            for (sys::Uint32_T i = 0; i < tilesAcross; ++i)
-            {
-                sys::Uint32_T seekPos = *(tiff::GenericType<sys::Uint32_T> *)(*mTileOffsets)[startIndex + i];
-                seekPos += paddingStartLine * tileByteWidth;
-                mOutput->seek(seekPos, io::Seekable::START);
-                mOutput->write(padBuffer, paddedLines * tileByteWidth);
-            }
-
-            delete [] padBuffer;
+            TileCompressor(&mTileRow[0], imageByteWidth, numRows,
+                           tileByteWidth, tileLength, mElementSize,
+                           samplesPerPixel, mPredictor, nextTile,
+                           tiles).run();
         }
-
-        // If no padding, seek the end of the image.  This is so that 
-        // when the IFD is written, it doesn't try to write it into the
-        // middle of the file.  This is a patch and a better solution
-        // should probably be found.
         else
         {
-            sys::Uint32_T lastTileIndex = mTileOffsets->getValues().size() - 1;
-            sys::Uint32_T seekPos = *(tiff::GenericType<sys::Uint32_T> *)(*mTileOffsets)[lastTileIndex];
-            seekPos += *(tiff::GenericType<sys::Uint32_T> *)(*mTileByteCounts)[lastTileIndex];
-            mOutput->seek(seekPos, io::Seekable::START);
+            mt::ThreadGroup threads;
+            for (size_t ii = 0; ii < numThreads; ++ii)
+            {
+                std::auto_ptr<sys::Runnable> runnable(new TileCompressor(
+                        &mTileRow[0], imageByteWidth, numRows,
+                        tileByteWidth, tileLength, mElementSize,
+                        samplesPerPixel, mPredictor, nextTile, tiles));
+                threads.createThread(runnable);
+            }
+            threads.joinAll();
         }
     }
+
+    // Tiles are written in order, so each begins where the last ended
+    for (size_t ii = 0; ii < tilesAcross; ++ii)
+    {
+        const std::vector<unsigned char>& tile = tiles[ii];
+        addOffset(mTileOffsets, mOutput->tell());
+        mIFD.addEntryValue("TileByteCounts",
+                           static_cast<sys::Uint32_T>(tile.size()));
+        mOutput->write((const sys::byte *)&tile[0], tile.size());
+    }
+
+    memset(&mTileRow[0], 0, mTileRow.size());
+    mTileRowSize = 0;
 }
 
 void tiff::ImageWriter::putStripData(const unsigned char *buffer,
                                      sys::Uint32_T numElementsToWrite)
 {
     sys::Uint32_T stripSize = *(tiff::GenericType<sys::Uint32_T> *)(*mStripByteCounts)[0];
-    sys::Uint32_T bufferIndex = 0;
+    size_t bufferIndex = 0;
 
     while (numElementsToWrite)
     {
         sys::Uint32_T bytesToWrite = mElementSize * numElementsToWrite;
-        sys::Uint32_T stripIndex = mBytePosition / stripSize;
-        sys::Uint32_T stripPosition = mBytePosition % stripSize;
+        size_t stripIndex = static_cast<size_t>(mBytePosition / stripSize);
+        sys::Uint32_T stripPosition =
+                static_cast<sys::Uint32_T>(mBytePosition % stripSize);
 
         // Calculate what remains to be written in the current strip.
         sys::Uint32_T remainingBytesInStrip =
@@ -0,0 +1,270 @@
+/* =========================================================================
+ * This file is part of tiff-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2016, MDA Information Systems LLC
+ *
+ * tiff-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string.h>
+#include <vector>
+
+#include <io/FileInputStream.h>
+#include <io/TempFile.h>
+#include <tiff/Compression.h>
+#include <tiff/FileReader.h>
+#include <tiff/FileWriter.h>
+#include "TestCase.h"
+
+namespace
+{
+// Smooth enough to compress, with some noise so the LZW table fills up
+std::vector<unsigned char> createData(size_t numBytes)
+{
+    std::vector<unsigned char> data(numBytes);
+    unsigned int seed = 1;
+    for (size_t ii = 0; ii < numBytes; ++ii)
+    {
+        seed = seed * 1103515245 + 12345;
+        data[ii] = static_cast<unsigned char>(ii / 64 + ((seed >> 16) & 3));
+    }
+    return data;
+}
+
+bool lzwRoundTrips(const std::vector<unsigned char>& data)
+{
+    std::vector<unsigned char> compressed;
+    tiff::Compression::lzwEncode(data.empty() ? NULL : &data[0],
+                                 data.size(), compressed);
+
+    std::vector<unsigned char> decompressed(data.size() + 1, 0xFF);
+    tiff::Compression::lzwDecode(&compressed[0], compressed.size(),
+                                 &decompressed[0], decompressed.size());
+
+    // Anything past the decompressed data is zero filled
+    return std::equal(data.begin(), data.end(), decompressed.begin()) &&
+            decompressed.back() == 0;
+}
+
+void writeImage(const std::string& pathname,
+                const std::vector<unsigned char>& image,
+                size_t numRows,
+                size_t numCols,
+                unsigned short bitsPerSample,
+                unsigned short numBands,
+                bool tiled,
+                bool compress,
+                bool bigTIFF)
+{
+    tiff::FileWriter writer(pathname);
+    writer.setBigTIFF(bigTIFF);
+    writer.writeHeader();
+
+    tiff::ImageWriter *imageWriter = writer.addImage();
+    tiff::IFD *ifd = imageWriter->getIFD();
+    ifd->addEntry(tiff::KnownTags::IMAGE_WIDTH,
+                  static_cast<sys::Uint32_T>(numCols));
+    ifd->addEntry(tiff::KnownTags::IMAGE_LENGTH,
+                  static_cast<sys::Uint32_T>(numRows));
+    ifd->addEntry(tiff::KnownTags::PHOTOMETRIC_INTERPRETATION,
+                  (unsigned short)tiff::Const::PhotoInterpType::BLACK_IS_ZERO);
+    ifd->addEntry(tiff::KnownTags::BITS_PER_SAMPLE, bitsPerSample);
+    if (numBands > 1)
+    {
+        ifd->addEntry(tiff::KnownTags::SAMPLES_PER_PIXEL, numBands);
+        for (unsigned short band = 1; band < numBands; ++band)
+        {
+            ifd->addEntryValue(tiff::KnownTags::BITS_PER_SAMPLE,
+                               bitsPerSample);
+        }
+    }
+    if (compress)
+    {
+        ifd->addEntry(tiff::KnownTags::COMPRESSION,
+                      (unsigned short)tiff::Const::CompressionType::LZW);
+        ifd->addEntry("Predictor", (unsigned short)2);
+    }
+
+    if (tiled)
+    {
+        imageWriter->setImageFormat(tiff::ImageWriter::TILED);
+        imageWriter->setIdealChunkSize(64 * 64 * bitsPerSample / 8 * numBands);
+        imageWriter->setNumThreads(3);
+    }
+
+    // Write a few rows at a time, not lined up with the tiles
+    const size_t numBytesPerRow = numCols * numBands * bitsPerSample / 8;
+    const size_t numRowsPerWrite = 7;
+    for (size_t row = 0; row < numRows; row += numRowsPerWrite)
+    {
+        const size_t numRowsThisWrite =
+                std::min(numRowsPerWrite, numRows - row);
+        imageWriter->putData(&image[row * numBytesPerRow],
+                             static_cast<sys::Uint32_T>(
+                                     numRowsThisWrite * numCols));
+    }
+    imageWriter->writeIFD();
+    writer.close();
+}
+
+bool readMatches(const std::string& pathname,
+                 const std::vector<unsigned char>& image,
+                 size_t numRows,
+                 size_t numCols)
+{
+    tiff::FileReader reader(pathname);
+    if (reader.getImageCount() != 1)
+        return false;
+
+    // Read one row at a time
+    const size_t numBytesPerRow = image.size() / numRows;
+    std::vector<unsigned char> buffer(image.size());
+    for (size_t row = 0; row < numRows; ++row)
+    {
+        reader.getData(&buffer[row * numBytesPerRow],
+                       static_cast<sys::Uint32_T>(numCols));
+    }
+    return buffer == image;
+}
+
+bool roundTrips(unsigned short bitsPerSample,
+                unsigned short numBands,
+                bool tiled,
+                bool compress,
+                bool bigTIFF)
+{
+    const size_t numRows = 150;
+    const size_t numCols = 133;
+    const std::vector<unsigned char> image =
+            createData(numRows * numCols * numBands * bitsPerSample / 8);
+
+    const io::TempFile tempFile;
+    writeImage(tempFile.pathname(), image, numRows, numCols, bitsPerSample,
+               numBands, tiled, compress, bigTIFF);
+    return readMatches(tempFile.pathname(), image, numRows, numCols);
+}
+
+TEST_CASE(testLZWRoundTrip)
+{
+    TEST_ASSERT(lzwRoundTrips(std::vector<unsigned char>()));
+    TEST_ASSERT(lzwRoundTrips(std::vector<unsigned char>(1, 42)));
+    TEST_ASSERT(lzwRoundTrips(std::vector<unsigned char>(100000, 7)));
+    TEST_ASSERT(lzwRoundTrips(createData(3)));
+
+    // Enough data for the table to fill and be cleared several times
+    TEST_ASSERT(lzwRoundTrips(createData(1000000)));
+}
+
+TEST_CASE(testLZWKnownEncoding)
+{
+    // Clear, 'A', 'B', 258 ("AB"), 260 ("ABA"), 'A', end of information
+    const unsigned char expected[] =
+    {
+        0x80, 0x10, 0x48, 0x50, 0x28, 0x21, 0x06, 0x02
+    };
+    const unsigned char input[] = "ABABABAA";
+
+    std::vector<unsigned char> compressed;
+    tiff::Compression::lzwEncode(input, 8, compressed);
+    TEST_ASSERT_EQ(compressed.size(), sizeof(expected));
+    TEST_ASSERT(std::equal(compressed.begin(), compressed.end(), expected));
+}
+
+TEST_CASE(testCorruptLZW)
+{
+    // Clear, then a code that is not in the table yet
+    const unsigned char corrupt[] = { 0x80, 0x7F, 0xC0 };
+    std::vector<unsigned char> buffer(16);
+    TEST_EXCEPTION(tiff::Compression::lzwDecode(corrupt, sizeof(corrupt),
+                                                &buffer[0], buffer.size()));
+
+    // Decompresses to more than the buffer holds
+    const std::vector<unsigned char> data(100, 1);
+    std::vector<unsigned char> compressed;
+    tiff::Compression::lzwEncode(&data[0], data.size(), compressed);
+    TEST_EXCEPTION(tiff::Compression::lzwDecode(&compressed[0],
+                                                compressed.size(),
+                                                &buffer[0], buffer.size()));
+}
+
+TEST_CASE(testPredictorRoundTrip)
+{
+    const std::vector<unsigned char> data = createData(40 * 30 * 3 * 2);
+    for (size_t bytesPerSample = 1; bytesPerSample <= 2; ++bytesPerSample)
+    {
+        std::vector<unsigned char> differenced(data);
+        tiff::Compression::applyPredictor(&differenced[0], 30,
+                                          40 * 2 / bytesPerSample, 3,
+                                          bytesPerSample);
+        TEST_ASSERT(differenced != data);
+
+        tiff::Compression::undoPredictor(&differenced[0], 30,
+                                         40 * 2 / bytesPerSample, 3,
+                                         bytesPerSample);
+        TEST_ASSERT(differenced == data);
+    }
+
+    std::vector<unsigned char> buffer(data);
+    TEST_EXCEPTION(tiff::Compression::applyPredictor(&buffer[0], 1, 1, 1, 4));
+}
+
+TEST_CASE(testTiledRoundTrip)
+{
+    TEST_ASSERT(roundTrips(8, 1, true, false, false));
+    TEST_ASSERT(roundTrips(8, 1, true, true, false));
+    TEST_ASSERT(roundTrips(16, 1, true, true, false));
+    TEST_ASSERT(roundTrips(8, 3, true, true, false));
+}
+
+TEST_CASE(testBigTIFFRoundTrip)
+{
+    TEST_ASSERT(roundTrips(8, 1, false, false, true));
+    TEST_ASSERT(roundTrips(16, 1, true, false, true));
+    TEST_ASSERT(roundTrips(8, 3, true, true, true));
+
+    const io::TempFile tempFile;
+    writeImage(tempFile.pathname(), createData(16), 4, 4, 8, 1,
+               false, false, true);
+
+    // "II" or "MM", then 43 for BigTIFF and 8 byte offsets
+    io::FileInputStream input(tempFile.pathname());
+    unsigned short header[3];
+    input.read((sys::byte *)header, sizeof(header));
+    TEST_ASSERT_EQ(header[1], tiff::Header::BIGTIFF_ID);
+    TEST_ASSERT_EQ(header[2], 8);
+}
+
+TEST_CASE(testStrippedCompression)
+{
+    // Compression is only supported for tiled images
+    const io::TempFile tempFile;
+    TEST_EXCEPTION(writeImage(tempFile.pathname(), createData(16), 4, 4, 8,
+                              1, false, true, false));
+}
+}
+
+int main(int, char**)
+{
+    TEST_CHECK(testLZWRoundTrip);
+    TEST_CHECK(testLZWKnownEncoding);
+    TEST_CHECK(testCorruptLZW);
+    TEST_CHECK(testPredictorRoundTrip);
+    TEST_CHECK(testTiledRoundTrip);
+    TEST_CHECK(testBigTIFFRoundTrip);
+    TEST_CHECK(testStrippedCompression);
+    return 0;
+}
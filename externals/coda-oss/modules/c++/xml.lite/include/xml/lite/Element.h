@@ -228,7 +228,7 @@ public:
      *  Returns the character data of this element.
      *  \return the charater data
      */
-    std::string getCharacterData() const
+    const std::string& getCharacterData() const
     {
         return mCharacterData;
     }
@@ -255,7 +255,7 @@ public:
      *  Returns the local name of this element.
      *  \return the local name
      */
-    std::string getLocalName() const
+    const std::string& getLocalName() const
     {
         return mName.getName();
     }
@@ -291,7 +291,7 @@ public:
      *  Returns the URI of this element.
      *  \return the URI
      */
-    std::string getUri() const
+    const std::string& getUri() const
     {
         return mName.getAssociatedUri();
     }
@@ -348,6 +348,12 @@ protected:
 
     void depthPrint(io::OutputStream& stream, int depth,
                     const std::string& formatter) const;
+
+    void depthPrint(std::string& buffer, int depth,
+                    const std::string& formatter) const;
+
+    //! Append the prefixed name of this element to buffer
+    void appendName(std::string& buffer) const;
     
     Element* mParent;
     //! The children of this element
@@ -118,7 +118,7 @@ public:
      *
      */
     void setName(const std::string& str);
-    std::string getName() const;
+    const std::string& getName() const;
     /*!
      *  If this is a fully-qualified name, set it,
      *  otherwise, set the local name.
@@ -138,7 +138,7 @@ public:
      *  \return The prefix
      *
      */
-    std::string getPrefix() const;
+    const std::string& getPrefix() const;
 
     /*!
      *  Retrieve the qname as a string.  If you have no prefix/uri
@@ -159,7 +159,7 @@ public:
      *  \return The Associated URI
      *
      */
-    std::string getAssociatedUri() const;
+    const std::string& getAssociatedUri() const;
 
 protected:
     /*  Assignment operator  */
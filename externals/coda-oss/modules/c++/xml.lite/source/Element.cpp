@@ -158,50 +158,73 @@ void xml::lite::Element::depthPrint(io::OutputStream& stream,
                                     int depth,
                                     const std::string& formatter) const
 {
-    std::string prefix = "";
+    // Building the whole subtree in one buffer is much faster than a
+    // (virtual) write per tag and avoids the temporaries of concatenating
+    // each tag on its own
+    std::string buffer;
+    depthPrint(buffer, depth, formatter);
+    stream.write(buffer);
+}
+
+void xml::lite::Element::depthPrint(std::string& buffer,
+                                    int depth,
+                                    const std::string& formatter) const
+{
     for (int i = 0; i < depth; ++i)
-        prefix += formatter;
+        buffer += formatter;
 
     // Printing in XML form, recursively
-    std::string lBrack = "<";
-    std::string rBrack = ">";
-
-    std::string acc = prefix + lBrack + mName.toString();
+    buffer += '<';
+    appendName(buffer);
 
     for (int i = 0; i < mAttributes.getLength(); i++)
     {
-        acc += std::string(" ");
-        acc += mAttributes.getQName(i);
-        acc += std::string("=\"");
-        acc += mAttributes.getValue(i);
-        acc += std::string("\"");
+        buffer += ' ';
+        buffer += mAttributes.getQName(i);
+        buffer += "=\"";
+        buffer += mAttributes.getValue(i);
+        buffer += '"';
     }
 
     if (mCharacterData.empty()&& mChildren.empty())
     {
         //simple type - just end it here
-        stream.write(acc + "/" + rBrack);
+        buffer += "/>";
     }
     else
     {
-        stream.write(acc + rBrack);
-        stream.write(mCharacterData);
+        buffer += '>';
+        buffer += mCharacterData;
 
         for (unsigned int i = 0; i < mChildren.size(); i++)
         {
             if (!formatter.empty())
-                stream.write("\n");
-            mChildren[i]->depthPrint(stream, depth + 1, formatter);
+                buffer += '\n';
+            mChildren[i]->depthPrint(buffer, depth + 1, formatter);
         }
 
         if (!mChildren.empty() && !formatter.empty())
         {
-            stream.write("\n" + prefix);
+            buffer += '\n';
+            for (int i = 0; i < depth; ++i)
+                buffer += formatter;
         }
 
-        lBrack += "/";
-        stream.write(lBrack + mName.toString() + rBrack);
+        buffer += "</";
+        appendName(buffer);
+        buffer += '>';
+    }
+}
+
+void xml::lite::Element::appendName(std::string& buffer) const
+{
+    const std::string& prefix = mName.getPrefix();
+    if (!prefix.empty())
+    {
+        buffer += prefix;
+        buffer += ':';
     }
+    buffer += mName.getName();
 }
 
 void xml::lite::Element::addChild(xml::lite::Element * node)
@@ -45,7 +45,7 @@ void xml::lite::MinidomHandler::characters(const char *value, int length)
 {
     // Append new data
     if (length)
-        currentCharacterData += std::string(value, length);
+        currentCharacterData.append(value, length);
 
     // Append number of bytes added to this node's stack value
     assert(bytesForElement.size());
@@ -24,7 +24,7 @@
 
 
 
-std::string xml::lite::QName::getName() const
+const std::string& xml::lite::QName::getName() const
 {
     return mLocalName;
 }
@@ -48,7 +48,7 @@ void xml::lite::QName::setPrefix( const std::string& prefix )
     mPrefix = prefix;
 }
 
-std::string xml::lite::QName::getPrefix() const
+const std::string& xml::lite::QName::getPrefix() const
 {
     return mPrefix;
 }
@@ -75,7 +75,7 @@ void xml::lite::QName::setAssociatedUri( const std::string& str )
     mAssocUri = str;
 }
 
-std::string xml::lite::QName::getAssociatedUri() const
+const std::string& xml::lite::QName::getAssociatedUri() const
 {
     return mAssocUri;
 }
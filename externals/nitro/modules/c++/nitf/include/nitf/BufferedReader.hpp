@@ -103,6 +103,9 @@ protected:
 
     virtual void closeImpl();
 
+    //! Reads straight from the file, bypassing the buffer
+    virtual void readAtImpl(nitf::Off offset, void* buf, size_t size) const;
+
 private:
     void readNextBuffer();
 
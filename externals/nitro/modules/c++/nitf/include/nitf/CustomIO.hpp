@@ -51,6 +51,15 @@ protected:
 
     virtual void closeImpl() = 0;
 
+    /*!
+     *  Positional reads and writes, which must not use or move the current
+     *  offset and must be safe to call from several threads at once.  By
+     *  default, these throw.
+     */
+    virtual void readAtImpl(nitf::Off offset, void* buf, size_t size) const;
+
+    virtual void writeAtImpl(nitf::Off offset, const void* buf, size_t size);
+
 private:
     static
     nitf_IOInterface* createInterface(CustomIO* me);
@@ -81,6 +90,14 @@ private:
 
     static
     void adapterDestruct(NRT_DATA* data);
+
+    static
+    NRT_BOOL adapterReadAt(NRT_DATA* data, nrt_Off offset, void* buf,
+                           size_t size, nrt_Error* error);
+
+    static
+    NRT_BOOL adapterWriteAt(NRT_DATA* data, nrt_Off offset, const void* buf,
+                            size_t size, nrt_Error* error);
 };
 }
 
@@ -76,6 +76,25 @@ public:
 
     void write(const void* buf, size_t size);
 
+    /*!
+     *  Read 'size' bytes at 'offset' without using or moving the current
+     *  offset.  Safe to call from several threads at once.
+     *
+     *  \throws nitf::NITFException if the interface doesn't support
+     *  positional reads or the read fails
+     */
+    void readAt(nitf::Off offset, void* buf, size_t size) const;
+
+    /*!
+     *  Write 'size' bytes at 'offset' without using or moving the current
+     *  offset.  Safe to call from several threads at once as long as they
+     *  write different bytes.
+     *
+     *  \throws nitf::NITFException if the interface doesn't support
+     *  positional writes or the write fails
+     */
+    void writeAt(nitf::Off offset, const void* buf, size_t size);
+
     bool canSeek() const;
 
     nitf::Off seek(nitf::Off offset, int whence);
@@ -247,6 +247,17 @@ public:
                          nitf::Uint32 fillDir);
 
 private:
+    /*!
+     * Drops our references to the C++ handlers wrapping 'handlers[index]'.
+     * The C library destroys a handler when it's replaced, so the wrappers
+     * have to let go of it first.  Otherwise the handle registry keeps an
+     * entry for freed memory, which a later object allocated at the same
+     * address would pick up.
+     */
+    void releaseWriteHandler(nitf_WriteHandler** handlers,
+                             int numHandlers,
+                             int index);
+
     nitf_Error error;
 
     //! c++ write handlers need to be kept in scope
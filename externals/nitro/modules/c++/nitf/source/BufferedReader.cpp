@@ -177,8 +177,11 @@ nitf::Off BufferedReader::seekImpl(nitf::Off offset, int whence)
     }
     else
     {
-        // Need to do a legit read
-        const sys::Off_T newOffset = mFile.seekTo(offset, whence);
+        // Need to do a legit read.  desiredPos is used rather than
+        // offset since the file position is at the end of the buffer,
+        // not at our logical position.
+        const sys::Off_T newOffset =
+                mFile.seekTo(desiredPos, sys::File::FROM_START);
         readNextBuffer();
         return newOffset;
     }
@@ -203,4 +206,15 @@ void BufferedReader::closeImpl()
 {
     mFile.close();
 }
+
+void BufferedReader::readAtImpl(nitf::Off offset, void* buf, size_t size) const
+{
+    if (offset < 0 || offset + static_cast<nitf::Off>(size) > mFileLen)
+    {
+        throw except::Exception(Ctxt(
+                "Attempting to read past the end of a buffered reader."));
+    }
+
+    mFile.readAt(offset, buf, size);
+}
 }
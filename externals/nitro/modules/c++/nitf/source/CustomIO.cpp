@@ -58,7 +58,9 @@ nitf_IOInterface* CustomIO::createInterface(CustomIO* me)
         &CustomIO::adapterGetSize,
         &CustomIO::adapterGetMode,
         &CustomIO::adapterClose,
-        &CustomIO::adapterDestruct
+        &CustomIO::adapterDestruct,
+        &CustomIO::adapterReadAt,
+        &CustomIO::adapterWriteAt
     };
 
     nitf_IOInterface* const impl =
@@ -74,6 +76,18 @@ nitf_IOInterface* CustomIO::createInterface(CustomIO* me)
     return impl;
 }
 
+void CustomIO::readAtImpl(nitf::Off , void* , size_t ) const
+{
+    throw except::NotImplementedException(Ctxt(
+            "This IO interface doesn't support positional reads"));
+}
+
+void CustomIO::writeAtImpl(nitf::Off , const void* , size_t )
+{
+    throw except::NotImplementedException(Ctxt(
+            "This IO interface doesn't support positional writes"));
+}
+
 NRT_BOOL CustomIO::adapterRead(NRT_DATA* data,
                                void* buf,
                                size_t size,
@@ -313,4 +327,66 @@ NRT_BOOL CustomIO::adapterClose(NRT_DATA* data,
 void CustomIO::adapterDestruct(NRT_DATA* data)
 {
 }
+
+NRT_BOOL CustomIO::adapterReadAt(NRT_DATA* data,
+                                 nrt_Off offset,
+                                 void* buf,
+                                 size_t size,
+                                 nrt_Error* error)
+{
+    try
+    {
+        reinterpret_cast<CustomIO*>(data)->readAtImpl(offset, buf, size);
+        return NRT_SUCCESS;
+    }
+    catch (const except::Exception& ex)
+    {
+        nrt_Error_init(error, ex.getMessage().c_str(), NRT_CTXT,
+                       NRT_ERR_READING_FROM_FILE);
+        return NRT_FAILURE;
+    }
+    catch (const std::exception& ex)
+    {
+        nrt_Error_init(error, ex.what(), NRT_CTXT,
+                       NRT_ERR_READING_FROM_FILE);
+        return NRT_FAILURE;
+    }
+    catch (...)
+    {
+        nrt_Error_init(error, "Unknown error", NRT_CTXT,
+                       NRT_ERR_READING_FROM_FILE);
+        return NRT_FAILURE;
+    }
+}
+
+NRT_BOOL CustomIO::adapterWriteAt(NRT_DATA* data,
+                                  nrt_Off offset,
+                                  const void* buf,
+                                  size_t size,
+                                  nrt_Error* error)
+{
+    try
+    {
+        reinterpret_cast<CustomIO*>(data)->writeAtImpl(offset, buf, size);
+        return NRT_SUCCESS;
+    }
+    catch (const except::Exception& ex)
+    {
+        nrt_Error_init(error, ex.getMessage().c_str(), NRT_CTXT,
+                       NRT_ERR_WRITING_TO_FILE);
+        return NRT_FAILURE;
+    }
+    catch (const std::exception& ex)
+    {
+        nrt_Error_init(error, ex.what(), NRT_CTXT,
+                       NRT_ERR_WRITING_TO_FILE);
+        return NRT_FAILURE;
+    }
+    catch (...)
+    {
+        nrt_Error_init(error, "Unknown error", NRT_CTXT,
+                       NRT_ERR_WRITING_TO_FILE);
+        return NRT_FAILURE;
+    }
+}
 }
@@ -48,6 +48,27 @@ void nitf::IOInterface::write(const void* buf, size_t size)
         throw nitf::NITFException(&error);
 }
 
+void nitf::IOInterface::readAt(nitf::Off offset, void* buf, size_t size) const
+{
+    // 'error' is shared, so use our own to stay thread-safe
+    nitf_Error readError;
+    if (!nitf_IOInterface_readAt(getNativeOrThrow(), offset, buf, size,
+                                 &readError))
+    {
+        throw nitf::NITFException(&readError);
+    }
+}
+
+void nitf::IOInterface::writeAt(nitf::Off offset, const void* buf, size_t size)
+{
+    nitf_Error writeError;
+    if (!nitf_IOInterface_writeAt(getNativeOrThrow(), offset, buf, size,
+                                  &writeError))
+    {
+        throw nitf::NITFException(&writeError);
+    }
+}
+
 bool nitf::IOInterface::canSeek() const
 {
     nitf_IOInterface *io = getNativeOrThrow();
@@ -78,6 +78,11 @@ Writer::~Writer()
 void Writer::write()
 {
     NITF_BOOL x = nitf_Writer_write(getNativeOrThrow(), &error);
+
+    // The C library destroys the handlers once it's written, whether or not
+    // that succeeded, so let go of the wrappers before their native memory
+    // gets reused
+    mWriteHandlers.clear();
     if (!x)
         throw nitf::NITFException(&error);
 }
@@ -89,6 +94,9 @@ void Writer::prepare(nitf::IOHandle & io, nitf::Record & record)
 
 void Writer::prepareIO(nitf::IOInterface & io, nitf::Record & record)
 {
+    // Any handlers from a previous write are about to be destroyed
+    mWriteHandlers.clear();
+
     NITF_BOOL x = nitf_Writer_prepareIO(getNativeOrThrow(), record.getNative(),
                                         io.getNative(), &error);
 
@@ -179,10 +187,26 @@ void Writer::setDEWriteHandlers(nitf::IOHandle& io, nitf::Record& record)
     }
 }
 
+void Writer::releaseWriteHandler(nitf_WriteHandler** handlers,
+                                 int numHandlers,
+                                 int index)
+{
+    if (index < 0 || index >= numHandlers || !handlers[index])
+        return;
+
+    for (size_t ii = mWriteHandlers.size(); ii > 0; --ii)
+    {
+        if (mWriteHandlers[ii - 1]->getNative() == handlers[index])
+            mWriteHandlers.erase(mWriteHandlers.begin() + (ii - 1));
+    }
+}
+
 void Writer::setImageWriteHandler(int index,
                                   mem::SharedPtr<WriteHandler> writeHandler)
 {
-    if (!nitf_Writer_setImageWriteHandler(getNativeOrThrow(), index,
+    nitf_Writer* const writer = getNativeOrThrow();
+    releaseWriteHandler(writer->imageWriters, writer->numImageWriters, index);
+    if (!nitf_Writer_setImageWriteHandler(writer, index,
                                           writeHandler->getNative(), &error))
         throw nitf::NITFException(&error);
     writeHandler->setManaged(true);
@@ -192,7 +216,10 @@ void Writer::setImageWriteHandler(int index,
 void Writer::setGraphicWriteHandler(int index,
                                     mem::SharedPtr<WriteHandler> writeHandler)
 {
-    if (!nitf_Writer_setGraphicWriteHandler(getNativeOrThrow(), index,
+    nitf_Writer* const writer = getNativeOrThrow();
+    releaseWriteHandler(writer->graphicWriters,
+                        writer->numGraphicWriters, index);
+    if (!nitf_Writer_setGraphicWriteHandler(writer, index,
                                             writeHandler->getNative(), &error))
         throw nitf::NITFException(&error);
     writeHandler->setManaged(true);
@@ -202,7 +229,9 @@ void Writer::setGraphicWriteHandler(int index,
 void Writer::setTextWriteHandler(int index,
                                  mem::SharedPtr<WriteHandler> writeHandler)
 {
-    if (!nitf_Writer_setTextWriteHandler(getNativeOrThrow(), index,
+    nitf_Writer* const writer = getNativeOrThrow();
+    releaseWriteHandler(writer->textWriters, writer->numTextWriters, index);
+    if (!nitf_Writer_setTextWriteHandler(writer, index,
                                          writeHandler->getNative(), &error))
         throw nitf::NITFException(&error);
     writeHandler->setManaged(true);
@@ -212,7 +241,10 @@ void Writer::setTextWriteHandler(int index,
 void Writer::setDEWriteHandler(int index,
                                mem::SharedPtr<WriteHandler> writeHandler)
 {
-    if (!nitf_Writer_setDEWriteHandler(getNativeOrThrow(), index,
+    nitf_Writer* const writer = getNativeOrThrow();
+    releaseWriteHandler(writer->dataExtensionWriters,
+                        writer->numDataExtensionWriters, index);
+    if (!nitf_Writer_setDEWriteHandler(writer, index,
                                        writeHandler->getNative(), &error))
         throw nitf::NITFException(&error);
     writeHandler->setManaged(true);
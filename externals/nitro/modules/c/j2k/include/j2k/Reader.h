@@ -37,6 +37,9 @@ typedef nrt_Uint64      (*J2K_IREADER_READ_REGION)(J2K_USER_DATA*, nrt_Uint32 x0
                                                   nrt_Error*);
 typedef j2k_Container*  (*J2K_IREADER_GET_CONTAINER)(J2K_USER_DATA*, nrt_Error*);
 typedef void            (*J2K_IREADER_DESTRUCT)(J2K_USER_DATA *);
+typedef J2K_BOOL        (*J2K_IREADER_SET_RESOLUTION_REDUCTION)(J2K_USER_DATA*,
+                                                              nrt_Uint32,
+                                                              nrt_Error*);
 
 typedef struct _j2k_IReader
 {
@@ -45,6 +48,10 @@ typedef struct _j2k_IReader
     J2K_IREADER_READ_REGION     readRegion;
     J2K_IREADER_GET_CONTAINER   getContainer;
     J2K_IREADER_DESTRUCT        destruct;
+
+    /* Optional - NULL if the implementation can't decode at reduced
+     * resolutions */
+    J2K_IREADER_SET_RESOLUTION_REDUCTION setResolutionReduction;
 } j2k_IReader;
 
 typedef struct _j2k_Reader
@@ -83,6 +90,18 @@ J2KAPI(nrt_Uint64) j2k_Reader_readRegion(j2k_Reader*, nrt_Uint32 x0,
                                           nrt_Uint32 y1, nrt_Uint8 **buf,
                                           nrt_Error*);
 
+/**
+ * Sets the number of resolution levels to discard when decoding.  Each
+ * level halves the width and height, rounding up.  Tiles and regions read
+ * afterward are at the reduced resolution and are packed with no padding,
+ * even for partial tiles.  The container still describes the full
+ * resolution image.  Fails if the implementation doesn't support this;
+ * reads fail if the codestream doesn't have that many levels.
+ */
+J2KAPI(J2K_BOOL) j2k_Reader_setResolutionReduction(j2k_Reader*,
+                                                   nrt_Uint32 numLevels,
+                                                   nrt_Error*);
+
 /**
  * Returns the associated container (the Reader will still own it)
  */
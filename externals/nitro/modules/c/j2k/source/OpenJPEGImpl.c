@@ -57,6 +57,7 @@ typedef struct _OpenJPEGReaderImpl
     int ownIO;
     j2k_Container *container;
     IOControl userData;
+    nrt_Uint32 reduction;
 } OpenJPEGReaderImpl;
 
 typedef struct _OpenJPEGWriterImpl
@@ -92,12 +93,16 @@ J2KPRIV( nrt_Uint64)     OpenJPEGReader_readRegion(J2K_USER_DATA *, nrt_Uint32,
                                                    nrt_Error *);
 J2KPRIV( j2k_Container*) OpenJPEGReader_getContainer(J2K_USER_DATA *, nrt_Error *);
 J2KPRIV(void)            OpenJPEGReader_destruct(J2K_USER_DATA *);
+J2KPRIV( NRT_BOOL)       OpenJPEGReader_setResolutionReduction(J2K_USER_DATA *,
+                                                               nrt_Uint32,
+                                                               nrt_Error *);
 
 static j2k_IReader ReaderInterface = {&OpenJPEGReader_canReadTiles,
                                       &OpenJPEGReader_readTile,
                                       &OpenJPEGReader_readRegion,
                                       &OpenJPEGReader_getContainer,
-                                      &OpenJPEGReader_destruct };
+                                      &OpenJPEGReader_destruct,
+                                      &OpenJPEGReader_setResolutionReduction };
 
 J2KPRIV( NRT_BOOL)       OpenJPEGWriter_setTile(J2K_USER_DATA *,
                                                 nrt_Uint32, nrt_Uint32,
@@ -118,6 +123,13 @@ J2KPRIV(void) OpenJPEG_cleanup(opj_stream_t **, opj_codec_t **, opj_image_t **);
 J2KPRIV( J2K_BOOL) OpenJPEG_initImage(OpenJPEGWriterImpl *, j2k_WriterOptions *,
                                       nrt_Error *);
 
+/* Coordinate on the reference grid to coordinate at a reduced resolution */
+J2KPRIV(nrt_Uint32) OpenJPEG_reduce(nrt_Uint32 coord, nrt_Uint32 reduction)
+{
+    const nrt_Uint64 scale = (nrt_Uint64)1 << reduction;
+    return (nrt_Uint32)((coord + scale - 1) >> reduction);
+}
+
 J2KPRIV(void) OpenJPEG_errorHandler(const char* msg, void* data)
 {
     nrt_Error* error = (nrt_Error*)data;
@@ -306,6 +318,7 @@ OpenJPEG_setup(OpenJPEGReaderImpl *impl, opj_stream_t **stream,
     }
 
     opj_set_default_decoder_parameters(&impl->parameters);
+    impl->parameters.cp_reduce = impl->reduction;
 
     if (!opj_setup_decoder(*codec, &impl->parameters))
     {
@@ -727,7 +740,9 @@ OpenJPEGReader_readTile(J2K_USER_DATA *data, nrt_Uint32 tileX, nrt_Uint32 tileY,
              */
             const OPJ_UINT32 thisTileWidth = tileX1 - tileX0;
             const OPJ_UINT32 thisTileHeight = tileY1 - tileY0;
-            if (thisTileWidth < tileWidth)
+
+            /* Reduced resolution tiles are always returned packed */
+            if (thisTileWidth < tileWidth && impl->reduction == 0)
             {
                 /* TODO: The current approach below only works for single band
                  *       imagery.  For RGB data, I believe it is stored as all
@@ -772,7 +787,7 @@ OpenJPEGReader_readTile(J2K_USER_DATA *data, nrt_Uint32 tileX, nrt_Uint32 tileY,
                 goto CATCH_ERROR;
             }
 
-            if (thisTileWidth < tileWidth)
+            if (thisTileWidth < tileWidth && impl->reduction == 0)
             {
                 /* We have a tile that isn't as wide as it "should" be
                  * Need to add in the extra columns ourselves.  By marching
@@ -853,7 +868,11 @@ OpenJPEGReader_readRegion(J2K_USER_DATA *data, nrt_Uint32 x0, nrt_Uint32 y0,
 
     nComponents = j2k_Container_getNumComponents(impl->container, error);
     componentBytes = (j2k_Container_getPrecision(impl->container, error) - 1) / 8 + 1;
-    bufSize = (nrt_Uint64)(x1 - x0) * (y1 - y0) * componentBytes * nComponents;
+    bufSize = (nrt_Uint64)(OpenJPEG_reduce(x1, impl->reduction) -
+                           OpenJPEG_reduce(x0, impl->reduction)) *
+              (OpenJPEG_reduce(y1, impl->reduction) -
+               OpenJPEG_reduce(y0, impl->reduction)) *
+              componentBytes * nComponents;
     if (buf && !*buf)
     {
         *buf = (nrt_Uint8*)J2K_MALLOC(bufSize);
@@ -910,6 +929,16 @@ OpenJPEGReader_readRegion(J2K_USER_DATA *data, nrt_Uint32 x0, nrt_Uint32 y0,
     return bufSize;
 }
 
+J2KPRIV( NRT_BOOL)
+OpenJPEGReader_setResolutionReduction(J2K_USER_DATA *data,
+                                      nrt_Uint32 numLevels,
+                                      nrt_Error *error)
+{
+    OpenJPEGReaderImpl *impl = (OpenJPEGReaderImpl*) data;
+    impl->reduction = numLevels;
+    return NRT_SUCCESS;
+}
+
 J2KPRIV( j2k_Container*)
 OpenJPEGReader_getContainer(J2K_USER_DATA *data, nrt_Error *error)
 {
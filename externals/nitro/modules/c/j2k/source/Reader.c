@@ -44,6 +44,21 @@ J2KAPI(nrt_Uint64) j2k_Reader_readRegion(j2k_Reader *reader,
     return reader->iface->readRegion(reader->data, x0, y0, x1, y1, buf, error);
 }
 
+J2KAPI(J2K_BOOL) j2k_Reader_setResolutionReduction(j2k_Reader *reader,
+                                                   nrt_Uint32 numLevels,
+                                                   nrt_Error *error)
+{
+    if (reader->iface->setResolutionReduction)
+        return reader->iface->setResolutionReduction(reader->data, numLevels,
+                                                     error);
+    if (numLevels == 0)
+        return NRT_SUCCESS;
+
+    nrt_Error_init(error, "Decoding at a reduced resolution is not supported",
+                   NRT_CTXT, NRT_ERR_INVALID_OBJECT);
+    return NRT_FAILURE;
+}
+
 J2KAPI(j2k_Container*) j2k_Reader_getContainer(j2k_Reader *reader,
                                                nrt_Error *error)
 {
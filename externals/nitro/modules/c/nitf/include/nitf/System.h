@@ -229,6 +229,8 @@ typedef nrt_Directory                   nitf_Directory;
 #define nitf_IOHandle_create    nrt_IOHandle_create
 #define nitf_IOHandle_read      nrt_IOHandle_read
 #define nitf_IOHandle_write     nrt_IOHandle_write
+#define nitf_IOHandle_readAt    nrt_IOHandle_readAt
+#define nitf_IOHandle_writeAt   nrt_IOHandle_writeAt
 #define nitf_IOHandle_seek      nrt_IOHandle_seek
 #define nitf_IOHandle_tell      nrt_IOHandle_tell
 #define nitf_IOHandle_getSize   nrt_IOHandle_getSize
@@ -249,12 +251,16 @@ typedef NRT_IO_INTERFACE_GET_SIZE       NITF_IO_INTERFACE_GET_SIZE;
 typedef NRT_IO_INTERFACE_GET_MODE       NITF_IO_INTERFACE_GET_MODE;
 typedef NRT_IO_INTERFACE_CLOSE          NITF_IO_INTERFACE_CLOSE;
 typedef NRT_IO_INTERFACE_DESTRUCT       NITF_IO_INTERFACE_DESTRUCT;
+typedef NRT_IO_INTERFACE_READ_AT        NITF_IO_INTERFACE_READ_AT;
+typedef NRT_IO_INTERFACE_WRITE_AT       NITF_IO_INTERFACE_WRITE_AT;
 
 typedef nrt_IIOInterface                nitf_IIOInterface;
 typedef nrt_IOInterface                 nitf_IOInterface;
 
 #define nitf_IOInterface_read           nrt_IOInterface_read
 #define nitf_IOInterface_write          nrt_IOInterface_write
+#define nitf_IOInterface_readAt         nrt_IOInterface_readAt
+#define nitf_IOInterface_writeAt        nrt_IOInterface_writeAt
 #define nitf_IOInterface_canSeek        nrt_IOInterface_canSeek
 #define nitf_IOInterface_seek           nrt_IOInterface_seek
 #define nitf_IOInterface_tell           nrt_IOInterface_tell
@@ -80,6 +80,41 @@ NRTAPI(NRT_BOOL) nrt_IOHandle_read(nrt_IOHandle handle, void* buf, size_t size,
 NRTAPI(NRT_BOOL) nrt_IOHandle_write(nrt_IOHandle handle, const void* buf,
                                     size_t size, nrt_Error * error);
 
+/*!
+ *  Read from the IO handle at an absolute offset, without using or moving
+ *  the handle's file position on POSIX systems.  Like nrt_IOHandle_read(),
+ *  this reads all of the requested bytes or fails.  Any number of threads
+ *  may call this on the same handle at once.  On Windows, the handle's file
+ *  position is left at the end of the bytes read.
+ *
+ *  \param handle The handle to read from
+ *  \param offset The offset from the beginning of the file
+ *  \param buf    The buffer to read into
+ *  \param size   The number of bytes to read
+ *  \param error  Populated if function returns 0
+ *  \return       1 on success and 0 otherwise
+ */
+NRTAPI(NRT_BOOL) nrt_IOHandle_readAt(nrt_IOHandle handle, nrt_Off offset,
+                                     void* buf, size_t size,
+                                     nrt_Error * error);
+
+/*!
+ *  Write to the IO handle at an absolute offset, without using or moving
+ *  the handle's file position on POSIX systems.  Concurrent calls are safe
+ *  as long as they write to different parts of the file.  On Windows, the
+ *  handle's file position is left at the end of the bytes written.
+ *
+ *  \param handle The handle to write to
+ *  \param offset The offset from the beginning of the file
+ *  \param buf    The buffer to write from
+ *  \param size   The number of bytes to write
+ *  \param error  The error, only if !NRT_IO_SUCCESS()
+ *  \return NRT_SUCCESS if the method succeeds, NRT_FAILURE on failure.
+ */
+NRTAPI(NRT_BOOL) nrt_IOHandle_writeAt(nrt_IOHandle handle, nrt_Off offset,
+                                      const void* buf, size_t size,
+                                      nrt_Error * error);
+
 /*!
  *  Seek into the handle at this point.  Basically
  *  has the same usage as lseek().  If whence is SEEK_SET, the seek
@@ -39,6 +39,11 @@ typedef nrt_Off(*NRT_IO_INTERFACE_GET_SIZE) (NRT_DATA *, nrt_Error *);
 typedef int (*NRT_IO_INTERFACE_GET_MODE) (NRT_DATA *, nrt_Error *);
 typedef NRT_BOOL(*NRT_IO_INTERFACE_CLOSE) (NRT_DATA *, nrt_Error *);
 typedef void (*NRT_IO_INTERFACE_DESTRUCT) (NRT_DATA *);
+typedef NRT_BOOL(*NRT_IO_INTERFACE_READ_AT) (NRT_DATA *, nrt_Off, void *,
+                                             size_t, nrt_Error *);
+typedef NRT_BOOL(*NRT_IO_INTERFACE_WRITE_AT) (NRT_DATA *, nrt_Off,
+                                              const void *, size_t,
+                                              nrt_Error *);
 
 typedef struct _NRT_IIOInterface
 {
@@ -51,6 +56,13 @@ typedef struct _NRT_IIOInterface
     NRT_IO_INTERFACE_GET_MODE getMode;
     NRT_IO_INTERFACE_CLOSE close;
     NRT_IO_INTERFACE_DESTRUCT destruct;
+
+    /* Positional I/O.  These are last so that interfaces written before
+     * they existed leave them NULL, in which case
+     * nrt_IOInterface_readAt()/writeAt() fail.
+     */
+    NRT_IO_INTERFACE_READ_AT readAt;
+    NRT_IO_INTERFACE_WRITE_AT writeAt;
 } nrt_IIOInterface;
 
 typedef struct _NRT_IOInterface
@@ -71,6 +83,24 @@ NRTAPI(NRT_BOOL) nrt_IOInterface_read(nrt_IOInterface *, void* buf, size_t size,
 NRTAPI(NRT_BOOL) nrt_IOInterface_write(nrt_IOInterface * io, const void* buf,
                                        size_t size, nrt_Error * error);
 
+/**
+ * Reads data from an absolute offset without using or moving the current
+ * offset, so it can be called from several threads at once.  Fails if the
+ * interface doesn't support positional reads.
+ */
+NRTAPI(NRT_BOOL) nrt_IOInterface_readAt(nrt_IOInterface * io, nrt_Off offset,
+                                        void* buf, size_t size,
+                                        nrt_Error * error);
+
+/**
+ * Writes data to an absolute offset without using or moving the current
+ * offset.  Concurrent calls are safe if they write to different bytes.
+ * Fails if the interface doesn't support positional writes.
+ */
+NRTAPI(NRT_BOOL) nrt_IOInterface_writeAt(nrt_IOInterface * io, nrt_Off offset,
+                                         const void* buf, size_t size,
+                                         nrt_Error * error);
+
 /**
  * Returns whether the interface is seekable
  */
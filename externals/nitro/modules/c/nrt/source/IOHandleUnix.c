@@ -126,6 +126,78 @@ NRTAPI(NRT_BOOL) nrt_IOHandle_write(nrt_IOHandle handle, const void *buf,
     return NRT_SUCCESS;
 }
 
+NRTAPI(NRT_BOOL) nrt_IOHandle_readAt(nrt_IOHandle handle, nrt_Off offset,
+                                     void* buf, size_t size,
+                                     nrt_Error * error)
+{
+    size_t totalBytesRead = 0;
+    int i;
+
+    for (i = 1; totalBytesRead < size && i <= NRT_MAX_READ_ATTEMPTS; i++)
+    {
+        const ssize_t bytesRead = pread(handle,
+                                        (nrt_Uint8*)buf + totalBytesRead,
+                                        size - totalBytesRead,
+                                        (off_t)(offset + totalBytesRead));
+        if (bytesRead == -1)
+        {
+            if (errno != EINTR && errno != EAGAIN)
+            {
+                nrt_Error_init(error, strerror(errno), NRT_CTXT,
+                               NRT_ERR_READING_FROM_FILE);
+                return NRT_FAILURE;
+            }
+        }
+        else if (bytesRead == 0)
+        {
+            nrt_Error_init(error, "Unexpected end of file", NRT_CTXT,
+                           NRT_ERR_READING_FROM_FILE);
+            return NRT_FAILURE;
+        }
+        else
+        {
+            totalBytesRead += (size_t) bytesRead;
+        }
+    }
+
+    if (totalBytesRead < size)
+    {
+        nrt_Error_init(error, strerror(errno), NRT_CTXT,
+                       NRT_ERR_READING_FROM_FILE);
+        return NRT_FAILURE;
+    }
+    return NRT_SUCCESS;
+}
+
+NRTAPI(NRT_BOOL) nrt_IOHandle_writeAt(nrt_IOHandle handle, nrt_Off offset,
+                                      const void* buf, size_t size,
+                                      nrt_Error * error)
+{
+    size_t bytesActuallyWritten = 0;
+
+    while (bytesActuallyWritten < size)
+    {
+        const ssize_t bytesThisWrite =
+            pwrite(handle,
+                   (const nrt_Uint8*)buf + bytesActuallyWritten,
+                   size - bytesActuallyWritten,
+                   (off_t)(offset + bytesActuallyWritten));
+        if (bytesThisWrite == -1)
+        {
+            if (errno == EINTR || errno == EAGAIN)
+            {
+                continue;
+            }
+            nrt_Error_init(error, strerror(errno), NRT_CTXT,
+                           NRT_ERR_WRITING_TO_FILE);
+            return NRT_FAILURE;
+        }
+        bytesActuallyWritten += (size_t) bytesThisWrite;
+    }
+
+    return NRT_SUCCESS;
+}
+
 NRTAPI(nrt_Off) nrt_IOHandle_seek(nrt_IOHandle handle, nrt_Off offset,
                                   int whence, nrt_Error * error)
 {
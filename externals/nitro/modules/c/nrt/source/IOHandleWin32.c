@@ -133,6 +133,98 @@ NRTAPI(NRT_BOOL) nrt_IOHandle_write(nrt_IOHandle handle, const void *buf,
     return NRT_SUCCESS;
 }
 
+/*
+ *  ReadFile() and WriteFile() take the offset in an OVERLAPPED structure.
+ *  For a synchronous handle they still move the file pointer, but they
+ *  don't depend on it, so concurrent calls don't interfere.
+ */
+NRTPRIV(void) setOverlappedOffset(OVERLAPPED* overlapped, nrt_Uint64 offset)
+{
+    memset(overlapped, 0, sizeof(OVERLAPPED));
+    overlapped->Offset = (DWORD)(offset & 0xFFFFFFFF);
+    overlapped->OffsetHigh = (DWORD)(offset >> 32);
+}
+
+NRTAPI(NRT_BOOL) nrt_IOHandle_readAt(nrt_IOHandle handle, nrt_Off offset,
+                                     void* buf, size_t size,
+                                     nrt_Error * error)
+{
+    static const DWORD MAX_READ_SIZE = (DWORD)-1;
+    size_t bytesRead = 0;
+
+    while (bytesRead < size)
+    {
+        const size_t bytesRemaining = size - bytesRead;
+        const DWORD bytesToRead = (bytesRemaining > MAX_READ_SIZE) ?
+            MAX_READ_SIZE : (DWORD)bytesRemaining;
+        DWORD bytesThisRead = 0;
+        OVERLAPPED overlapped;
+        setOverlappedOffset(&overlapped, (nrt_Uint64)offset + bytesRead);
+
+        if (!ReadFile(handle,
+                      (nrt_Uint8*)buf + bytesRead,
+                      bytesToRead,
+                      &bytesThisRead,
+                      &overlapped))
+        {
+            if (GetLastError() == ERROR_HANDLE_EOF)
+            {
+                nrt_Error_init(error, "Unexpected end of file", NRT_CTXT,
+                               NRT_ERR_READING_FROM_FILE);
+            }
+            else
+            {
+                nrt_Error_init(error, NRT_STRERROR(NRT_ERRNO), NRT_CTXT,
+                               NRT_ERR_READING_FROM_FILE);
+            }
+            return NRT_FAILURE;
+        }
+        else if (bytesThisRead == 0)
+        {
+            nrt_Error_init(error, "Unexpected end of file", NRT_CTXT,
+                           NRT_ERR_READING_FROM_FILE);
+            return NRT_FAILURE;
+        }
+
+        bytesRead += bytesThisRead;
+    }
+
+    return NRT_SUCCESS;
+}
+
+NRTAPI(NRT_BOOL) nrt_IOHandle_writeAt(nrt_IOHandle handle, nrt_Off offset,
+                                      const void* buf, size_t size,
+                                      nrt_Error * error)
+{
+    static const DWORD MAX_WRITE_SIZE = (DWORD)-1;
+    size_t bytesWritten = 0;
+
+    while (bytesWritten < size)
+    {
+        const size_t bytesRemaining = size - bytesWritten;
+        const DWORD bytesToWrite = (bytesRemaining > MAX_WRITE_SIZE) ?
+            MAX_WRITE_SIZE : (DWORD)bytesRemaining;
+        DWORD bytesThisWrite = 0;
+        OVERLAPPED overlapped;
+        setOverlappedOffset(&overlapped, (nrt_Uint64)offset + bytesWritten);
+
+        if (!WriteFile(handle,
+                       (const nrt_Uint8*)buf + bytesWritten,
+                       bytesToWrite,
+                       &bytesThisWrite,
+                       &overlapped))
+        {
+            nrt_Error_init(error, NRT_STRERROR(NRT_ERRNO), NRT_CTXT,
+                           NRT_ERR_WRITING_TO_FILE);
+            return NRT_FAILURE;
+        }
+
+        bytesWritten += bytesThisWrite;
+    }
+
+    return NRT_SUCCESS;
+}
+
 NRTAPI(nrt_Off) nrt_IOHandle_seek(nrt_IOHandle handle, nrt_Off offset,
                                   int whence, nrt_Error * error)
 {
@@ -50,6 +50,45 @@ NRTAPI(NRT_BOOL) nrt_IOInterface_write(nrt_IOInterface * io, const void* buf,
     return io->iface->write(io->data, buf, size, error);
 }
 
+NRTAPI(NRT_BOOL) nrt_IOInterface_readAt(nrt_IOInterface * io, nrt_Off offset,
+                                        void* buf, size_t size,
+                                        nrt_Error * error)
+{
+    if (!io->iface->readAt)
+    {
+        nrt_Error_init(error, "IO Interface does not support positional reads",
+                       NRT_CTXT, NRT_ERR_INVALID_OBJECT);
+        return NRT_FAILURE;
+    }
+    if (offset < 0)
+    {
+        nrt_Error_init(error, "Invalid offset", NRT_CTXT,
+                       NRT_ERR_INVALID_PARAMETER);
+        return NRT_FAILURE;
+    }
+    return io->iface->readAt(io->data, offset, buf, size, error);
+}
+
+NRTAPI(NRT_BOOL) nrt_IOInterface_writeAt(nrt_IOInterface * io, nrt_Off offset,
+                                         const void* buf, size_t size,
+                                         nrt_Error * error)
+{
+    if (!io->iface->writeAt)
+    {
+        nrt_Error_init(error,
+                       "IO Interface does not support positional writes",
+                       NRT_CTXT, NRT_ERR_INVALID_OBJECT);
+        return NRT_FAILURE;
+    }
+    if (offset < 0)
+    {
+        nrt_Error_init(error, "Invalid offset", NRT_CTXT,
+                       NRT_ERR_INVALID_PARAMETER);
+        return NRT_FAILURE;
+    }
+    return io->iface->writeAt(io->data, offset, buf, size, error);
+}
+
 NRTAPI(NRT_BOOL) nrt_IOInterface_canSeek(nrt_IOInterface * io,
                                          nrt_Error * error)
 {
@@ -122,6 +161,22 @@ NRTPRIV(NRT_BOOL) IOHandleAdapter_write(NRT_DATA * data, const void *buf,
     return nrt_IOHandle_write(control->handle, buf, size, error);
 }
 
+NRTPRIV(NRT_BOOL) IOHandleAdapter_readAt(NRT_DATA * data, nrt_Off offset,
+                                         void *buf, size_t size,
+                                         nrt_Error * error)
+{
+    IOHandleControl *control = (IOHandleControl *) data;
+    return nrt_IOHandle_readAt(control->handle, offset, buf, size, error);
+}
+
+NRTPRIV(NRT_BOOL) IOHandleAdapter_writeAt(NRT_DATA * data, nrt_Off offset,
+                                          const void *buf, size_t size,
+                                          nrt_Error * error)
+{
+    IOHandleControl *control = (IOHandleControl *) data;
+    return nrt_IOHandle_writeAt(control->handle, offset, buf, size, error);
+}
+
 NRTPRIV(NRT_BOOL) IOHandleAdapter_canSeek(NRT_DATA * data, nrt_Error * error)
 {
     /* Silence compiler warnings about unused variables */
@@ -230,6 +285,52 @@ NRTPRIV(NRT_BOOL) BufferAdapter_write(NRT_DATA * data, const void *buf,
     return NRT_SUCCESS;
 }
 
+NRTPRIV(NRT_BOOL) BufferAdapter_readAt(NRT_DATA * data, nrt_Off offset,
+                                       void *buf, size_t size,
+                                       nrt_Error * error)
+{
+    const BufferIOControl *control = (const BufferIOControl *) data;
+
+    if ((nrt_Uint64) offset > control->size ||
+        size > control->size - (size_t) offset)
+    {
+        nrt_Error_init(error, "Invalid size requested - EOF", NRT_CTXT,
+                       NRT_ERR_MEMORY);
+        return NRT_FAILURE;
+    }
+
+    if (size > 0)
+    {
+        memcpy(buf, control->buf + offset, size);
+    }
+    return NRT_SUCCESS;
+}
+
+/*
+ *  Unlike BufferAdapter_write(), this doesn't touch bytesWritten, so
+ *  concurrent calls only share the bytes they write.
+ */
+NRTPRIV(NRT_BOOL) BufferAdapter_writeAt(NRT_DATA * data, nrt_Off offset,
+                                        const void *buf, size_t size,
+                                        nrt_Error * error)
+{
+    BufferIOControl *control = (BufferIOControl *) data;
+
+    if ((nrt_Uint64) offset > control->size ||
+        size > control->size - (size_t) offset)
+    {
+        nrt_Error_init(error, "Invalid size requested - EOF", NRT_CTXT,
+                       NRT_ERR_MEMORY);
+        return NRT_FAILURE;
+    }
+
+    if (size > 0)
+    {
+        memcpy(control->buf + offset, buf, size);
+    }
+    return NRT_SUCCESS;
+}
+
 NRTPRIV(NRT_BOOL) BufferAdapter_canSeek(NRT_DATA * data, nrt_Error * error)
 {
     /* Silence compiler warnings about unused variables */
@@ -323,7 +424,9 @@ NRTAPI(nrt_IOInterface *) nrt_IOHandleAdapter_construct(nrt_IOHandle handle,
         &IOHandleAdapter_getSize,
         &IOHandleAdapter_getMode,
         &IOHandleAdapter_close,
-        &IOHandleAdapter_destruct
+        &IOHandleAdapter_destruct,
+        &IOHandleAdapter_readAt,
+        &IOHandleAdapter_writeAt
     };
     nrt_IOInterface *impl = NULL;
     IOHandleControl *control = NULL;
@@ -397,7 +500,9 @@ NRTAPI(nrt_IOInterface *) nrt_BufferAdapter_construct(char *buf, size_t size,
         &BufferAdapter_getSize,
         &BufferAdapter_getMode,
         &BufferAdapter_close,
-        &BufferAdapter_destruct
+        &BufferAdapter_destruct,
+        &BufferAdapter_readAt,
+        &BufferAdapter_writeAt
     };
     nrt_IOInterface *impl = NULL;
     BufferIOControl *control = NULL;
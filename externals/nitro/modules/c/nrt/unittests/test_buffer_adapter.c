@@ -104,6 +104,73 @@ TEST_CASE(testWriteOutOfBounds)
     TEST_ASSERT(!success);
 }
 
+TEST_CASE(testReadAt)
+{
+    char buffer[TEST_BUF_SIZE];
+    char output[4];
+    nrt_Error error;
+    size_t ii;
+    NRT_BOOL success;
+
+    for (ii = 0; ii < TEST_BUF_SIZE; ++ii)
+    {
+        buffer[ii] = (char)ii;
+    }
+
+    nrt_IOInterface* reader = nrt_BufferAdapter_construct(
+        buffer, TEST_BUF_SIZE, 0, &error);
+
+    /* Positional reads don't move the mark */
+    nrt_IOInterface_seek(reader, 2, NRT_SEEK_SET, &error);
+    success = nrt_IOInterface_readAt(reader, 5, output, sizeof(output),
+                                     &error);
+    TEST_ASSERT(success);
+    for (ii = 0; ii < sizeof(output); ++ii)
+    {
+        TEST_ASSERT(output[ii] == (char)(ii + 5));
+    }
+    TEST_ASSERT(nrt_IOInterface_tell(reader, &error) == 2);
+
+    success = nrt_IOInterface_readAt(reader, 7, output, sizeof(output),
+                                     &error);
+    TEST_ASSERT(!success);
+    success = nrt_IOInterface_readAt(reader, TEST_BUF_SIZE + 1, output, 0,
+                                     &error);
+    TEST_ASSERT(!success);
+    success = nrt_IOInterface_readAt(reader, -1, output, 1, &error);
+    TEST_ASSERT(!success);
+
+    nrt_IOInterface_destruct(&reader);
+}
+
+TEST_CASE(testWriteAt)
+{
+    char buffer[TEST_BUF_SIZE];
+    char input[3];
+    nrt_Error error;
+    NRT_BOOL success;
+
+    memset(buffer, 0, sizeof(buffer));
+    memset(input, 7, sizeof(input));
+
+    nrt_IOInterface* writer = nrt_BufferAdapter_construct(
+        buffer, TEST_BUF_SIZE, 0, &error);
+
+    success = nrt_IOInterface_writeAt(writer, 6, input, sizeof(input),
+                                      &error);
+    TEST_ASSERT(success);
+    TEST_ASSERT(buffer[5] == 0);
+    TEST_ASSERT(buffer[6] == 7 && buffer[7] == 7 && buffer[8] == 7);
+    TEST_ASSERT(buffer[9] == 0);
+    TEST_ASSERT(nrt_IOInterface_tell(writer, &error) == 0);
+
+    success = nrt_IOInterface_writeAt(writer, 8, input, sizeof(input),
+                                      &error);
+    TEST_ASSERT(!success);
+
+    nrt_IOInterface_destruct(&writer);
+}
+
 int main(int argc, char **argv)
 {
     (void) argc;
@@ -112,5 +179,7 @@ int main(int argc, char **argv)
     CHECK(testReadPastEnd);
     CHECK(testReadOutOfBounds);
     CHECK(testWriteOutOfBounds);
+    CHECK(testReadAt);
+    CHECK(testWriteAt);
     return 0;
 }
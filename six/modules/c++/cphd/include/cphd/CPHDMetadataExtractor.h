@@ -0,0 +1,61 @@
+/* =========================================================================
+ * This file is part of cphd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * cphd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __CPHD_CPHD_METADATA_EXTRACTOR_H__
+#define __CPHD_CPHD_METADATA_EXTRACTOR_H__
+
+#include <string>
+#include <vector>
+
+#include <six/MetadataExtractor.h>
+
+namespace cphd
+{
+/*
+ *  \class CPHDMetadataExtractor
+ *
+ *  \brief Summarizes CPHD 1.x files for six::extractMetadata()
+ *
+ *  Only the file header and XML block are read; the support arrays, PVPs,
+ *  and signal block are skipped entirely.
+ */
+class CPHDMetadataExtractor : public six::MetadataExtractor
+{
+public:
+    /*
+     *  \func CPHDMetadataExtractor constructor
+     *
+     *  \param schemaPaths (Optional) XML schemas for validation
+     */
+    CPHDMetadataExtractor(const std::vector<std::string>& schemaPaths =
+                                  std::vector<std::string>());
+
+    bool supports(const std::string& pathname) const override;
+
+    void extract(const std::string& pathname,
+                 six::MetadataSummary& summary) const override;
+
+private:
+    const std::vector<std::string> mSchemaPaths;
+};
+}
+
+#endif
@@ -65,7 +65,9 @@ public:
      *  \func CPHDReader constructor
      *  \brief Construct CPHDReader from a file pathname
      *
-     *  \param fromFile File path of CPHD file
+     *  \param fromFile File path of CPHD file.  Signal and support arrays
+     *  are read from it with one six::AsyncFile, shared by the Wideband and
+     *  the SupportBlock.
      *  \param numThreads Number of threads for parallelization
      *  \param schemaPaths (Optional) XML schemas for validation
      *  \param logger (Optional) Provide custom log
@@ -159,7 +161,9 @@ private:
     void initialize(std::shared_ptr<io::SeekableInputStream> inStream,
                     size_t numThreads,
                     std::shared_ptr<logging::Logger> logger,
-                    const std::vector<std::string>& schemaPaths);
+                    const std::vector<std::string>& schemaPaths,
+                    std::shared_ptr<six::AsyncFile> asyncFile =
+                            std::shared_ptr<six::AsyncFile>());
 };
 }
 
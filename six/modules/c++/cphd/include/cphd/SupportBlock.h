@@ -23,6 +23,7 @@
 #define __CPHD_SUPPORT_BLOCK_H__
 
 #include <iostream>
+#include <memory>
 #include <string>
 #include <complex>
 #include <unordered_map>
@@ -33,6 +34,7 @@
 
 #include <mem/ScopedArray.h>
 #include <mem/BufferView.h>
+#include <six/AsyncFile.h>
 
 #include <cphd/Data.h>
 #include <cphd/Utilities.h>
@@ -54,7 +56,8 @@ public:
      *
      *  \brief Constructor initializes book keeping information
      *
-     *  \param pathname Input CPHD pathname to initialize a file input stream
+     *  \param pathname Input CPHD pathname to initialize a file input stream.
+     *  Support arrays are read from it with a six::AsyncFile.
      *  \param data Data section from CPHD
      *  \param startSupport CPHD header keyword "SUPPORT_BLOCK_BYTE_OFFSET"
      *  \param sizeSupport CPHD header keyword "SUPPORT_BLOCK_SIZE"
@@ -73,11 +76,16 @@ public:
      *  \param data Data section from CPHD
      *  \param startSupport CPHD header keyword "SUPPORT_BLOCK_BYTE_OFFSET"
      *  \param sizeSupport CPHD header keyword "SUPPORT_BLOCK_SIZE"
+     *  \param asyncFile (Optional) The same file opened for batched reads.
+     *  If given, support arrays are read from it instead of the stream, and
+     *  readAll() reads every array at once.
      */
     SupportBlock(std::shared_ptr<io::SeekableInputStream> inStream,
                  const cphd::Data& data,
                  sys::Off_T startSupport,
-                 sys::Off_T sizeSupport);
+                 sys::Off_T sizeSupport,
+                 std::shared_ptr<six::AsyncFile> asyncFile =
+                         std::shared_ptr<six::AsyncFile>());
 
     /*
      *  \func getFileOffset
@@ -147,6 +155,11 @@ private:
     // both for uncompressed and compressed data
     void initialize();
 
+    //! Swap a support array that's been read to native byte order
+    void swapToNative(const std::string& id,
+                      size_t numThreads,
+                      void* data) const;
+
 private:
     // Noncopyable
     SupportBlock(const SupportBlock& ) = delete;
@@ -154,6 +167,7 @@ private:
 
 private:
     const std::shared_ptr<io::SeekableInputStream> mInStream;
+    const std::shared_ptr<six::AsyncFile> mAsyncFile;
     cphd::Data mData;
     const sys::Off_T mSupportOffset;       // offset in bytes to start of SupportBlock
     const size_t mSupportSize;             // total size in bytes of SupportBlock
@@ -23,6 +23,7 @@
 #define __CPHD_WIDEBAND_H__
 
 #include <complex>
+#include <memory>
 #include <string>
 
 #include <cphd/MetadataBase.h>
@@ -31,6 +32,7 @@
 #include <io/SeekableStreams.h>
 #include <mem/BufferView.h>
 #include <mem/ScopedArray.h>
+#include <six/AsyncFile.h>
 #include <sys/Conf.h>
 #include <types/RowCol.h>
 
@@ -52,7 +54,8 @@ public:
      *
      *  \brief Constructor initializes signal block book keeping
      *
-     *  \param pathname Input CPHD pathname
+     *  \param pathname Input CPHD pathname.  Signal arrays are read from it
+     *  with a six::AsyncFile.
      *  \param metadata Metadata section of CPHD file
      *  \param startWB CPHD header keyword "CPHD_BYTE_OFFSET"
      *  \param sizeWB CPHD header keyword "CPHD_DATA_SIZE"
@@ -71,11 +74,17 @@ public:
      *  \param metadata Metadata section of CPHD file
      *  \param startWB CPHD header keyword "cphd_BYTE_OFFSET"
      *  \param sizeWB CPHD header keyword "cphd_DATA_SIZE"
+     *  \param asyncFile (Optional) The same file opened for batched reads.
+     *  If given, signal arrays are read from it instead of the stream,
+     *  with a read per vector in flight at once when reading only some
+     *  samples.
      */
     Wideband(std::shared_ptr<io::SeekableInputStream> inStream,
              const cphd::MetadataBase& metadata,
              sys::Off_T startWB,
-             sys::Off_T sizeWB);
+             sys::Off_T sizeWB,
+             std::shared_ptr<six::AsyncFile> asyncFile =
+                     std::shared_ptr<six::AsyncFile>());
 
     /*!
      *  \func getFileOffset
@@ -410,6 +419,7 @@ private:
 
 private:
     const std::shared_ptr<io::SeekableInputStream> mInStream;
+    const std::shared_ptr<six::AsyncFile> mAsyncFile;
     const cphd::MetadataBase& mMetadata;  // pointer to data metadata
     const sys::Off_T mWBOffset;  // offset in bytes to start of wideband
     const size_t mWBSize;  // total size in bytes of wideband
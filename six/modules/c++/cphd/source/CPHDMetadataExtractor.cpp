@@ -0,0 +1,97 @@
+/* =========================================================================
+ * This file is part of cphd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * cphd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <memory>
+
+#include <io/FileInputStream.h>
+#include <logging/NullLogger.h>
+#include <str/Manip.h>
+#include <xml/lite/MinidomParser.h>
+#include <six/Utilities.h>
+#include <cphd/CPHDMetadataExtractor.h>
+#include <cphd/CPHDXMLControl.h>
+#include <cphd/FileHeader.h>
+#include <cphd/Metadata.h>
+
+namespace cphd
+{
+CPHDMetadataExtractor::CPHDMetadataExtractor(
+        const std::vector<std::string>& schemaPaths) :
+    mSchemaPaths(schemaPaths)
+{
+}
+
+bool CPHDMetadataExtractor::supports(const std::string& pathname) const
+{
+    try
+    {
+        io::FileInputStream inStream(pathname);
+
+        // CPHD 0.3 has a different layout and is read by cphd03
+        return !str::startsWith(BaseFileHeader::readVersion(inStream), "0.");
+    }
+    catch (const except::Exception&)
+    {
+        return false;
+    }
+}
+
+void CPHDMetadataExtractor::extract(const std::string& pathname,
+                                    six::MetadataSummary& summary) const
+{
+    io::FileInputStream inStream(pathname);
+
+    FileHeader fileHeader;
+    fileHeader.read(inStream);
+
+    inStream.seek(fileHeader.getXMLBlockByteOffset(), io::Seekable::START);
+    xml::lite::MinidomParser xmlParser;
+    xmlParser.preserveCharacterData(true);
+    xmlParser.parse(inStream, fileHeader.getXMLBlockSize());
+
+    logging::NullLogger logger;
+    const std::unique_ptr<Metadata> metadata =
+            CPHDXMLControl(&logger, false).fromXML(xmlParser.getDocument(),
+                                                   mSchemaPaths);
+
+    summary.fileType = "CPHD";
+    summary.version = fileHeader.getVersion();
+    summary.name = metadata->collectionID.coreName;
+    summary.classification =
+            metadata->collectionID.getClassificationLevel();
+    summary.collectionStart =
+            six::toString(metadata->global.timeline.collectionStart);
+    if (metadata->productInfo.get() &&
+        !metadata->productInfo->creationInfo.empty())
+    {
+        summary.creationTime = six::toString(
+                metadata->productInfo->creationInfo[0].dateTime);
+    }
+    summary.numImages = metadata->getNumChannels();
+    if (summary.numImages > 0)
+    {
+        summary.numRows = metadata->getNumVectors(0);
+        summary.numCols = metadata->getNumSamples(0);
+    }
+    summary.pixelType = metadata->data.getSampleType().toString();
+    summary.corners = metadata->sceneCoordinates.imageAreaCorners;
+}
+}
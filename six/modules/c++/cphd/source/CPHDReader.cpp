@@ -45,13 +45,15 @@ CPHDReader::CPHDReader(const std::string& fromFile,
                        std::shared_ptr<logging::Logger> logger)
 {
     initialize(std::shared_ptr<io::SeekableInputStream>(
-        new io::FileInputStream(fromFile)), numThreads, logger, schemaPaths);
+        new io::FileInputStream(fromFile)), numThreads, logger, schemaPaths,
+        std::shared_ptr<six::AsyncFile>(new six::AsyncFile(fromFile)));
 }
 
 void CPHDReader::initialize(std::shared_ptr<io::SeekableInputStream> inStream,
                             size_t numThreads,
                             std::shared_ptr<logging::Logger> logger,
-                            const std::vector<std::string>& schemaPaths)
+                            const std::vector<std::string>& schemaPaths,
+                            std::shared_ptr<six::AsyncFile> asyncFile)
 {
     mFileHeader.read(*inStream);
 
@@ -71,7 +73,8 @@ void CPHDReader::initialize(std::shared_ptr<io::SeekableInputStream> inStream,
 
     mSupportBlock.reset(new SupportBlock(inStream, mMetadata->data,
                         mFileHeader.getSupportBlockByteOffset(),
-                        mFileHeader.getSupportBlockSize()));
+                        mFileHeader.getSupportBlockSize(),
+                        asyncFile));
 
     // Load the PVPBlock into memory
     mPVPBlock.reset(new PVPBlock(mMetadata->pvp, mMetadata->data));
@@ -83,6 +86,7 @@ void CPHDReader::initialize(std::shared_ptr<io::SeekableInputStream> inStream,
     // Setup for wideband reading
     mWideband.reset(new Wideband(inStream, *mMetadata,
                                  mFileHeader.getSignalBlockByteOffset(),
-                                 mFileHeader.getSignalBlockSize()));
+                                 mFileHeader.getSignalBlockSize(),
+                                 asyncFile));
 }
 }
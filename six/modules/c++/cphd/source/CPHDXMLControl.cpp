@@ -129,7 +129,17 @@ std::unique_ptr<Metadata> CPHDXMLControl::fromXML(const std::string& xmlString,
     stringStream.write(xmlString.c_str(), xmlString.size());
     xml::lite::MinidomParser parser;
     parser.parse(stringStream);
-    return fromXML(parser.getDocument(), schemaPaths);
+    const xml::lite::Document* doc = parser.getDocument();
+
+    // Validate the original string rather than re-serializing the DOM
+    if(!schemaPaths.empty())
+    {
+        six::XMLControl::validate(xmlString,
+                                  doc->getRootElement()->getUri(),
+                                  schemaPaths,
+                                  mLog);
+    }
+    return fromXML(doc, std::vector<std::string>());
 }
 
 std::unique_ptr<Metadata> CPHDXMLControl::fromXML(const xml::lite::Document* doc,
@@ -156,46 +156,40 @@ void PVPBlock::PVPSet::write(const PVPBlock& pvpBlock, const Pvp& p, const sys::
         {
             double val;
             ::setData(input + it->second.getByteOffset(), val);
-            addedPVP[it->first] = six::Parameter();
-            addedPVP.find(it->first)->second.setValue(val);
+            addedPVP[it->first].setValue(val);
         }
         else if (it->second.getFormat() == "U1" || it->second.getFormat() == "U2" ||
                  it->second.getFormat() == "U4" || it->second.getFormat() == "U8")
         {
             unsigned int val;
             ::setData(input + it->second.getByteOffset(), val);
-            addedPVP[it->first] = six::Parameter();
-            addedPVP.find(it->first)->second.setValue(val);
+            addedPVP[it->first].setValue(val);
         }
         else if (it->second.getFormat() == "I1" || it->second.getFormat() == "I2" ||
                  it->second.getFormat() == "I4" || it->second.getFormat() == "I8")
         {
             int val;
             ::setData(input + it->second.getByteOffset(), val);
-            addedPVP[it->first] = six::Parameter();
-            addedPVP.find(it->first)->second.setValue(val);
+            addedPVP[it->first].setValue(val);
         }
         else if (it->second.getFormat() == "CI2" || it->second.getFormat() == "CI4" ||
                  it->second.getFormat() == "CI8" || it->second.getFormat() == "CI16")
         {
             std::complex<int> val;
             ::setData(input + it->second.getByteOffset(), val);
-            addedPVP[it->first] = six::Parameter();
-            addedPVP.find(it->first)->second.setValue(val);
+            addedPVP[it->first].setValue(val);
         }
         else if (it->second.getFormat() == "CF8" || it->second.getFormat() == "CF16")
         {
             std::complex<double> val;
             ::setData(input + it->second.getByteOffset(), val);
-            addedPVP[it->first] = six::Parameter();
-            addedPVP.find(it->first)->second.setValue(val);
+            addedPVP[it->first].setValue(val);
         }
         else
         {
             std::string val;
             val.assign(input + it->second.getByteOffset(), it->second.getByteSize());
-            addedPVP[it->first] = six::Parameter();
-            addedPVP.find(it->first)->second.setValue(val);
+            addedPVP[it->first].setValue(val);
         }
     }
 }
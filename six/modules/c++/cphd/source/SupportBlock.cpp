@@ -22,6 +22,7 @@
 
 #include <limits>
 #include <sstream>
+#include <vector>
 
 #include <sys/Conf.h>
 #include <mt/ThreadGroup.h>
@@ -39,6 +40,7 @@ SupportBlock::SupportBlock(const std::string& pathname,
                            sys::Off_T startSupport,
                            sys::Off_T sizeSupport) :
     mInStream(new io::FileInputStream(pathname)),
+    mAsyncFile(new six::AsyncFile(pathname)),
     mData(data),
     mSupportOffset(startSupport),
     mSupportSize(sizeSupport)
@@ -49,8 +51,10 @@ SupportBlock::SupportBlock(const std::string& pathname,
 SupportBlock::SupportBlock(std::shared_ptr<io::SeekableInputStream> inStream,
                            const cphd::Data& data,
                            sys::Off_T startSupport,
-                           sys::Off_T sizeSupport) :
+                           sys::Off_T sizeSupport,
+                           std::shared_ptr<six::AsyncFile> asyncFile) :
     mInStream(inStream),
+    mAsyncFile(asyncFile),
     mData(data),
     mSupportOffset(startSupport),
     mSupportSize(sizeSupport)
@@ -94,13 +98,27 @@ void SupportBlock::read(const std::string& id,
     // First to the start of the first support array we're going to read
     sys::Off_T inOffset = getFileOffset(id);
     sys::byte* dataPtr = reinterpret_cast<sys::byte*>(data.data);
-    mInStream->seek(inOffset, io::FileInputStream::START);
     size_t size = mData.getSupportArrayById(id).getSize();
-    mInStream->read(dataPtr, size);
+    if (mAsyncFile.get())
+    {
+        mAsyncFile->read(inOffset, size, dataPtr);
+    }
+    else
+    {
+        mInStream->seek(inOffset, io::FileInputStream::START);
+        mInStream->read(dataPtr, size);
+    }
+
+    swapToNative(id, numThreads, data.data);
+}
 
+void SupportBlock::swapToNative(const std::string& id,
+                                size_t numThreads,
+                                void* data) const
+{
     if (!sys::isBigEndianSystem() && mData.getElementSize(id) > 1)
     {
-        cphd::byteSwap(data.data, mData.getElementSize(id),
+        cphd::byteSwap(data, mData.getElementSize(id),
                        mData.getSupportArrayById(id).numRows *
                        mData.getSupportArrayById(id).numCols,
                        numThreads);
@@ -111,10 +129,32 @@ void SupportBlock::readAll(size_t numThreads,
                            mem::ScopedArray<sys::ubyte>& data) const
 {
     data.reset(new sys::ubyte[mSupportSize]);
-    for (auto it = mData.supportArrayMap.begin(); it != mData.supportArrayMap.end(); ++it)
+    if (mAsyncFile.get())
     {
-        const size_t bufSize = it->second.getSize();
-        read(it->first, numThreads, mem::BufferView<sys::ubyte>(&data[it->second.arrayByteOffset], bufSize));
+        // Read every array in one batch, then swap them
+        std::vector<six::AsyncFile::Request> requests;
+        for (auto it = mData.supportArrayMap.begin(); it != mData.supportArrayMap.end(); ++it)
+        {
+            requests.push_back(six::AsyncFile::Request(
+                    getFileOffset(it->first),
+                    it->second.getSize(),
+                    &data[it->second.arrayByteOffset]));
+        }
+        mAsyncFile->read(requests);
+
+        for (auto it = mData.supportArrayMap.begin(); it != mData.supportArrayMap.end(); ++it)
+        {
+            swapToNative(it->first, numThreads,
+                         &data[it->second.arrayByteOffset]);
+        }
+    }
+    else
+    {
+        for (auto it = mData.supportArrayMap.begin(); it != mData.supportArrayMap.end(); ++it)
+        {
+            const size_t bufSize = it->second.getSize();
+            read(it->first, numThreads, mem::BufferView<sys::ubyte>(&data[it->second.arrayByteOffset], bufSize));
+        }
     }
 }
 
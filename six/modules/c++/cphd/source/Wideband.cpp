@@ -22,6 +22,7 @@
 
 #include <limits>
 #include <sstream>
+#include <vector>
 
 #include <cphd/ByteSwap.h>
 #include <cphd/Wideband.h>
@@ -240,6 +241,7 @@ Wideband::Wideband(const std::string& pathname,
                    sys::Off_T startWB,
                    sys::Off_T sizeWB) :
     mInStream(new io::FileInputStream(pathname)),
+    mAsyncFile(new six::AsyncFile(pathname)),
     mMetadata(metadata),
     mWBOffset(startWB),
     mWBSize(sizeWB),
@@ -252,8 +254,10 @@ Wideband::Wideband(const std::string& pathname,
 Wideband::Wideband(std::shared_ptr<io::SeekableInputStream> inStream,
                    const cphd::MetadataBase& metadata,
                    sys::Off_T startWB,
-                   sys::Off_T sizeWB) :
+                   sys::Off_T sizeWB,
+                   std::shared_ptr<six::AsyncFile> asyncFile) :
     mInStream(inStream),
+    mAsyncFile(asyncFile),
     mMetadata(metadata),
     mWBOffset(startWB),
     mWBSize(sizeWB),
@@ -410,8 +414,16 @@ void Wideband::readImpl(size_t channel,
     if (dims.col == mMetadata.getNumSamples(channel))
     {
         // Life is easy - can do a single seek and read
-        mInStream->seek(inOffset, io::FileInputStream::START);
-        mInStream->read(dataPtr, dims.row * dims.col * mElementSize);
+        const size_t numBytes = dims.row * dims.col * mElementSize;
+        if (mAsyncFile.get())
+        {
+            mAsyncFile->read(inOffset, numBytes, dataPtr);
+        }
+        else
+        {
+            mInStream->seek(inOffset, io::FileInputStream::START);
+            mInStream->read(dataPtr, numBytes);
+        }
     }
     else
     {
@@ -421,12 +433,28 @@ void Wideband::readImpl(size_t channel,
         const size_t bytesPerVectorFile =
                 mMetadata.getNumSamples(channel) * mElementSize;
 
-        for (size_t row = 0; row < dims.row; ++row)
+        if (mAsyncFile.get())
         {
-            mInStream->seek(inOffset, io::FileInputStream::START);
-            mInStream->read(dataPtr, bytesPerVectorAOI);
-            dataPtr += bytesPerVectorAOI;
-            inOffset += bytesPerVectorFile;
+            // But the rows can all be in flight at once
+            std::vector<six::AsyncFile::Request> requests(dims.row);
+            for (size_t row = 0; row < dims.row; ++row)
+            {
+                requests[row] = six::AsyncFile::Request(
+                        inOffset, bytesPerVectorAOI, dataPtr);
+                dataPtr += bytesPerVectorAOI;
+                inOffset += bytesPerVectorFile;
+            }
+            mAsyncFile->read(requests);
+        }
+        else
+        {
+            for (size_t row = 0; row < dims.row; ++row)
+            {
+                mInStream->seek(inOffset, io::FileInputStream::START);
+                mInStream->read(dataPtr, bytesPerVectorAOI);
+                dataPtr += bytesPerVectorAOI;
+                inOffset += bytesPerVectorFile;
+            }
         }
     }
 }
@@ -438,8 +466,15 @@ void Wideband::readImpl(size_t channel, void* data) const
     sys::Off_T inOffset = getFileOffset(channel);
 
     sys::byte* dataPtr = static_cast<sys::byte*>(data);
-    mInStream->seek(inOffset, io::FileInputStream::START);
-    mInStream->read(dataPtr, getBytesRequiredForRead(channel));
+    if (mAsyncFile.get())
+    {
+        mAsyncFile->read(inOffset, getBytesRequiredForRead(channel), dataPtr);
+    }
+    else
+    {
+        mInStream->seek(inOffset, io::FileInputStream::START);
+        mInStream->read(dataPtr, getBytesRequiredForRead(channel));
+    }
 }
 
 void Wideband::read(size_t channel,
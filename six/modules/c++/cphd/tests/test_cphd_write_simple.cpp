@@ -0,0 +1,110 @@
+/* =========================================================================
+ * This file is part of cphd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2020, MDA Information Systems LLC
+ *
+ * cphd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <complex>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cli/ArgumentParser.h>
+#include <cphd/CPHDWriter.h>
+#include <cphd/Metadata.h>
+#include <cphd/PVPBlock.h>
+#include <cphd/TestDataGenerator.h>
+#include <types/RowCol.h>
+
+/*!
+ * Writes a single channel CPHD 1.0 with the minimal metadata from
+ * TestDataGenerator, random per vector parameters, and a ramp of signal data
+ */
+int main(int argc, char** argv)
+{
+    try
+    {
+        // Parse the command line
+        cli::ArgumentParser parser;
+        parser.setDescription("Create a sample CPHD file.");
+        parser.addArgument("-t --threads",
+                           "Specify the number of threads to use",
+                           cli::STORE,
+                           "threads",
+                           "NUM")->setDefault(sys::OS().getNumCPUs());
+        parser.addArgument("--rows",
+                           "Specify the number of vectors",
+                           cli::STORE,
+                           "rows",
+                           "NUM")->setDefault(128);
+        parser.addArgument("--cols",
+                           "Specify the number of samples per vector",
+                           cli::STORE,
+                           "cols",
+                           "NUM")->setDefault(128);
+        parser.addArgument("output", "Output pathname", cli::STORE, "output",
+                           "CPHD", 1, 1);
+        const std::unique_ptr<cli::Results> options(parser.parse(argc, argv));
+
+        const types::RowCol<size_t> dims(options->get<size_t>("rows"),
+                                         options->get<size_t>("cols"));
+        const std::string outPathname(options->get<std::string>("output"));
+        const size_t numThreads(options->get<size_t>("threads"));
+
+        std::vector<std::complex<float> > data(dims.area());
+        for (size_t ii = 0; ii < data.size(); ++ii)
+        {
+            data[ii] = std::complex<float>(static_cast<float>(ii),
+                                           -static_cast<float>(ii));
+        }
+
+        cphd::Metadata metadata;
+        cphd::setUpData(metadata, dims, data);
+        cphd::setPVPXML(metadata.pvp);
+
+        cphd::PVPBlock pvpBlock(metadata.pvp, metadata.data);
+        for (size_t ii = 0; ii < dims.row; ++ii)
+        {
+            cphd::setVectorParameters(0, ii, pvpBlock);
+        }
+
+        cphd::CPHDWriter writer(metadata, outPathname,
+                                std::vector<std::string>(), numThreads);
+        writer.writeMetadata(pvpBlock);
+        writer.writePVPData(pvpBlock);
+        writer.writeCPHDData(data.data(), dims.area());
+
+        std::cout << "Successfully wrote CPHD file: " << outPathname << "\n";
+        return 0;
+    }
+    catch (const except::Exception& ex)
+    {
+        std::cerr << ex.toString() << std::endl;
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+    }
+    catch (...)
+    {
+        std::cerr << "Unknown exception\n";
+    }
+    return 1;
+}
@@ -23,6 +23,8 @@
 #include <cphd/Metadata.h>
 #include <cphd/Wideband.h>
 #include <io/ByteStream.h>
+#include <io/FileOutputStream.h>
+#include <io/TempFile.h>
 #include "TestCase.h"
 
 namespace
@@ -144,6 +146,41 @@ TEST_CASE(testReadChannelSubset)
     TEST_ASSERT_EQ(readData[7], 'G');
 }
 
+TEST_CASE(testReadChannelSubsetFromFile)
+{
+    cphd::Metadata metadata;
+    metadata.data.channels.resize(1);
+    metadata.data.channels[0].numSamples = 3;
+    metadata.data.channels[0].numVectors = 4;
+    metadata.data.signalArrayFormat = cphd::SignalArrayFormat::CI2;
+
+    // Read from the file itself, so vectors are read as a batch
+    const io::TempFile tempFile;
+    {
+        io::FileOutputStream output(tempFile.pathname());
+        output.write("xx");
+        output.write("0A1B2C");
+        output.write("3D4E5F");
+        output.write("6G7H8I");
+        output.write("9J0K1L");
+        output.close();
+    }
+    cphd::Wideband wideband(tempFile.pathname(), metadata, 2, 24);
+    mem::ScopedArray<sys::ubyte> readData;
+
+    wideband.read(0, 0, cphd::Wideband::ALL, 1, 2, 1, readData);
+    const std::string expected("1B2C4E5F7H8I0K1L");
+    TEST_ASSERT_EQ(std::string(readData.get(),
+                               readData.get() + expected.size()),
+                   expected);
+
+    wideband.read(0, 2, 3, 0, cphd::Wideband::ALL, 1, readData);
+    const std::string expectedVectors("6G7H8I9J0K1L");
+    TEST_ASSERT_EQ(std::string(readData.get(),
+                               readData.get() + expectedVectors.size()),
+                   expectedVectors);
+}
+
 TEST_CASE(testCannotDoPartialReadOfCompressedChannel)
 {
     auto input = std::make_shared<io::ByteStream>();
@@ -171,6 +208,7 @@ int main(int, char**)
     TEST_CHECK(testReadCompressedChannel);
     TEST_CHECK(testReadUncompressedChannel);
     TEST_CHECK(testReadChannelSubset);
+    TEST_CHECK(testReadChannelSubsetFromFile);
     TEST_CHECK(testCannotDoPartialReadOfCompressedChannel);
     return 0;
 }
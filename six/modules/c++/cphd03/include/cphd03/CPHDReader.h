@@ -132,7 +132,9 @@ private:
 
     void initialize(std::shared_ptr<io::SeekableInputStream> inStream,
                     size_t numThreads,
-                    std::shared_ptr<logging::Logger> logger);
+                    std::shared_ptr<logging::Logger> logger,
+                    std::shared_ptr<six::AsyncFile> asyncFile =
+                            std::shared_ptr<six::AsyncFile>());
 
 };
 }
@@ -44,12 +44,14 @@ CPHDReader::CPHDReader(const std::string& fromFile,
                        std::shared_ptr<logging::Logger> logger)
 {
     initialize(std::shared_ptr<io::SeekableInputStream>(
-        new io::FileInputStream(fromFile)), numThreads, logger);
+        new io::FileInputStream(fromFile)), numThreads, logger,
+        std::shared_ptr<six::AsyncFile>(new six::AsyncFile(fromFile)));
 }
 
 void CPHDReader::initialize(std::shared_ptr<io::SeekableInputStream> inStream,
                             size_t numThreads,
-                            std::shared_ptr<logging::Logger> logger)
+                            std::shared_ptr<logging::Logger> logger,
+                            std::shared_ptr<six::AsyncFile> asyncFile)
 {
     mFileHeader.read(*inStream);
 
@@ -78,6 +80,7 @@ void CPHDReader::initialize(std::shared_ptr<io::SeekableInputStream> inStream,
     // Setup for wideband reading
     mWideband.reset(new cphd::Wideband(inStream, *mMetadata,
                                  mFileHeader.getCPHDoffset(),
-                                 mFileHeader.getCPHDsize()));
+                                 mFileHeader.getCPHDsize(),
+                                 asyncFile));
 }
 }
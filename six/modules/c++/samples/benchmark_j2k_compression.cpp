@@ -0,0 +1,222 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Times J2KCompressor on a synthetic SIDD image at several thread counts.
+ * Optionally writes the last result out as a compressed SIDD through
+ * CompressedSIDDByteProvider.
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+
+#include <import/cli.h>
+#include <import/six.h>
+#include <import/six/sidd.h>
+#include <io/FileOutputStream.h>
+#include <nitf/NITFBufferList.hpp>
+#include <sys/StopWatch.h>
+#include <six/sidd/CompressedSIDDByteProvider.h>
+#include <six/sidd/J2KCompressor.h>
+
+namespace
+{
+// Terrain-like values so the compression ratio is somewhat realistic
+std::vector<sys::ubyte> createImage(const types::RowCol<size_t>& dims,
+                                    size_t numBytesPerPixel)
+{
+    std::vector<sys::ubyte> image(dims.area() * numBytesPerPixel);
+    size_t idx = 0;
+    for (size_t row = 0; row < dims.row; ++row)
+    {
+        for (size_t col = 0; col < dims.col; ++col)
+        {
+            const size_t value = (row * 7 + col * 3) / 16 +
+                    ((row * 31 + col * 17) % 13);
+            for (size_t byte = 0; byte < numBytesPerPixel; ++byte)
+            {
+                image[idx++] = static_cast<sys::ubyte>(value >> (8 * byte));
+            }
+        }
+    }
+    return image;
+}
+
+void writeSIDD(const std::string& pathname,
+               const six::sidd::DerivedData& data,
+               const std::vector<sys::ubyte>& compressed,
+               const std::vector<std::vector<size_t> >& bytesPerBlock,
+               size_t blockSize)
+{
+    const six::sidd::CompressedSIDDByteProvider byteProvider(
+            data, std::vector<std::string>(), bytesPerBlock, true,
+            blockSize, blockSize);
+
+    nitf::Off fileOffset;
+    nitf::NITFBufferList buffers;
+    byteProvider.getBytes(&compressed[0], 0, data.getNumRows(),
+                          fileOffset, buffers);
+
+    io::FileOutputStream outStream(pathname);
+    for (size_t ii = 0; ii < buffers.mBuffers.size(); ++ii)
+    {
+        outStream.write(
+                static_cast<const sys::byte*>(buffers.mBuffers[ii].mData),
+                buffers.mBuffers[ii].mNumBytes);
+    }
+    outStream.close();
+}
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        cli::ArgumentParser parser;
+        parser.setDescription(
+            "Times lossless J2K compression of a synthetic SIDD image at "
+            "several thread counts");
+        parser.addArgument("--rows", "Number of rows", cli::STORE, "rows",
+                           "INT", 1, 1, false)->setDefault(8192);
+        parser.addArgument("--cols", "Number of columns", cli::STORE, "cols",
+                           "INT", 1, 1, false)->setDefault(8192);
+        parser.addArgument("-b --block", "Rows and columns per block (0 for "
+                           "no blocking)", cli::STORE, "block", "INT",
+                           1, 1, false)->setDefault(1024);
+        parser.addArgument("--bits", "Bits per pixel", cli::STORE, "bits",
+                           "INT", 1, 1, false)->setDefault(8)
+                           ->addChoice("8")->addChoice("16");
+        parser.addArgument("-t --threads", "Thread counts to time (0 for one "
+                           "per CPU; defaults to 1 and 0)", cli::STORE,
+                           "threads", "INT", 1);
+        parser.addArgument("-n --iterations", "Number of times to compress "
+                           "at each thread count", cli::STORE, "iterations",
+                           "INT", 1, 1, false)->setDefault(1);
+        parser.addArgument("-o --output", "Write the compressed image to "
+                           "this SIDD", cli::STORE, "output", "FILE");
+
+        const std::auto_ptr<cli::Results>
+            options(parser.parse(argc, (const char**) argv));
+        const types::RowCol<size_t> dims(options->get<size_t>("rows"),
+                                         options->get<size_t>("cols"));
+        const size_t blockSize = options->get<size_t>("block");
+        const size_t numIterations = options->get<size_t>("iterations");
+        const bool is16Bit = (options->get<size_t>("bits") == 16);
+        const size_t numBytesPerPixel = is16Bit ? 2 : 1;
+
+        std::vector<size_t> threadCounts;
+        if (options->hasValue("threads"))
+        {
+            const cli::Value* const threads = options->getValue("threads");
+            for (size_t ii = 0; ii < threads->size(); ++ii)
+            {
+                threadCounts.push_back(threads->get<size_t>(ii));
+            }
+        }
+        else
+        {
+            threadCounts.push_back(1);
+            threadCounts.push_back(0);
+        }
+
+        if (!six::sidd::J2KCompressor::isAvailable())
+        {
+            std::cerr << "SIX was built without J2K support" << std::endl;
+            return 1;
+        }
+
+        std::auto_ptr<six::sidd::DerivedData> data =
+                six::sidd::Utilities::createFakeDerivedData();
+        data->setNumRows(dims.row);
+        data->setNumCols(dims.col);
+        data->setPixelType(is16Bit ? six::PixelType::MONO16I :
+                                     six::PixelType::MONO8I);
+
+        const std::vector<sys::ubyte> image =
+                createImage(dims, numBytesPerPixel);
+        const double imageMB = image.size() / (1024.0 * 1024.0);
+
+        std::cout << std::setw(10) << "Threads"
+                  << std::setw(12) << "Seconds"
+                  << std::setw(12) << "MB/s"
+                  << std::setw(10) << "Speedup"
+                  << std::setw(10) << "Ratio" << std::endl;
+
+        std::vector<sys::ubyte> compressed;
+        std::vector<std::vector<size_t> > bytesPerBlock;
+        double firstSeconds = 0;
+        for (size_t ii = 0; ii < threadCounts.size(); ++ii)
+        {
+            const six::sidd::J2KCompressor compressor(threadCounts[ii]);
+
+            sys::RealTimeStopWatch sw;
+            sw.start();
+            for (size_t jj = 0; jj < numIterations; ++jj)
+            {
+                compressor.compress(*data, &image[0], blockSize, blockSize,
+                                    0, compressed, bytesPerBlock);
+            }
+            const double seconds = sw.stop() / 1000 / numIterations;
+            if (ii == 0)
+            {
+                firstSeconds = seconds;
+            }
+
+            const size_t numThreads = (threadCounts[ii] == 0) ?
+                    sys::OS().getNumCPUsAvailable() : threadCounts[ii];
+            std::cout << std::setw(10) << numThreads
+                      << std::fixed << std::setprecision(3)
+                      << std::setw(12) << seconds
+                      << std::setprecision(1)
+                      << std::setw(12) << imageMB / seconds
+                      << std::setprecision(2)
+                      << std::setw(9) << firstSeconds / seconds << "x"
+                      << std::setw(10)
+                      << static_cast<double>(image.size()) / compressed.size()
+                      << std::endl;
+        }
+
+        if (options->hasValue("output"))
+        {
+            writeSIDD(options->get<std::string>("output"), *data,
+                      compressed, bytesPerBlock, blockSize);
+        }
+
+        return 0;
+    }
+    catch (const except::Exception& ex)
+    {
+        std::cerr << ex.toString() << std::endl;
+        return 1;
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+    catch (...)
+    {
+        std::cerr << "Unknown exception" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,239 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Times LUTRemapper on a synthetic image at several thread counts, against
+ * a straightforward per-pixel lookup.  8-bit input is remapped through an
+ * RGB LUT (RGB8LU --> RGB24I); 16-bit input goes through a 16-bit to 8-bit
+ * LUT, optionally after a chain of other 16-bit LUTs.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+#include <import/cli.h>
+#include <import/six.h>
+#include <sys/StopWatch.h>
+#include <six/sidd/LUTRemapper.h>
+
+namespace
+{
+std::vector<sys::ubyte> createImage(size_t numPixels,
+                                    size_t numBytesPerPixel)
+{
+    std::vector<sys::ubyte> image(numPixels * numBytesPerPixel);
+    for (size_t ii = 0; ii < image.size(); ++ii)
+    {
+        image[ii] = static_cast<sys::ubyte>((ii * 31) ^ (ii >> 9));
+    }
+    return image;
+}
+
+six::LUT createLUT(size_t numEntries, size_t elementSize)
+{
+    six::LUT lut(numEntries, elementSize);
+    for (size_t ii = 0; ii < lut.table.size(); ++ii)
+    {
+        lut.table[ii] = static_cast<sys::ubyte>(ii * 7 + ii / 3);
+    }
+    return lut;
+}
+
+// What callers did before LUTRemapper: one LUT at a time, a pixel at a time
+void naiveRemap(const std::vector<six::LUT>& luts,
+                const sys::ubyte* input,
+                size_t numPixels,
+                size_t numInputBytes,
+                sys::ubyte* output)
+{
+    for (size_t ii = 0; ii < numPixels; ++ii)
+    {
+        size_t value = input[ii * numInputBytes];
+        if (numInputBytes == 2)
+        {
+            sys::Uint16_T sample;
+            std::memcpy(&sample, &input[ii * 2], sizeof(sample));
+            value = sample;
+        }
+
+        for (size_t jj = 0; jj + 1 < luts.size(); ++jj)
+        {
+            sys::Uint16_T sample;
+            std::memcpy(&sample,
+                        luts[jj][std::min(value, luts[jj].numEntries - 1)],
+                        sizeof(sample));
+            value = sample;
+        }
+
+        const six::LUT& last = luts.back();
+        std::memcpy(&output[ii * last.elementSize],
+                    last[std::min(value, last.numEntries - 1)],
+                    last.elementSize);
+    }
+}
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        cli::ArgumentParser parser;
+        parser.setDescription(
+            "Times applying SIDD LUTs to a synthetic image at several "
+            "thread counts");
+        parser.addArgument("--rows", "Number of rows", cli::STORE, "rows",
+                           "INT", 1, 1, false)->setDefault(8192);
+        parser.addArgument("--cols", "Number of columns", cli::STORE, "cols",
+                           "INT", 1, 1, false)->setDefault(8192);
+        parser.addArgument("--bits", "Bits per input pixel", cli::STORE,
+                           "bits", "INT", 1, 1, false)->setDefault(8)
+                           ->addChoice("8")->addChoice("16");
+        parser.addArgument("--chain", "Number of 16-bit LUTs to apply "
+                           "before the 16-bit to 8-bit one", cli::STORE,
+                           "chain", "INT", 1, 1, false)->setDefault(0);
+        parser.addArgument("-t --threads", "Thread counts to time (0 for one "
+                           "per CPU; defaults to 1 and 0)", cli::STORE,
+                           "threads", "INT", 1);
+        parser.addArgument("-n --iterations", "Number of times to remap "
+                           "at each thread count", cli::STORE, "iterations",
+                           "INT", 1, 1, false)->setDefault(1);
+
+        const std::auto_ptr<cli::Results>
+            options(parser.parse(argc, (const char**) argv));
+        const size_t numPixels =
+                options->get<size_t>("rows") * options->get<size_t>("cols");
+        const size_t numIterations = options->get<size_t>("iterations");
+        const bool is16Bit = (options->get<size_t>("bits") == 16);
+        const size_t chainLength = options->get<size_t>("chain");
+
+        std::vector<size_t> threadCounts;
+        if (options->hasValue("threads"))
+        {
+            const cli::Value* const threads = options->getValue("threads");
+            for (size_t ii = 0; ii < threads->size(); ++ii)
+            {
+                threadCounts.push_back(threads->get<size_t>(ii));
+            }
+        }
+        else
+        {
+            threadCounts.push_back(1);
+            threadCounts.push_back(0);
+        }
+
+        std::vector<six::LUT> luts;
+        if (is16Bit)
+        {
+            for (size_t ii = 0; ii < chainLength; ++ii)
+            {
+                luts.push_back(createLUT(65536, 2));
+            }
+            luts.push_back(createLUT(65536, 1));
+        }
+        else
+        {
+            luts.push_back(createLUT(256, 3));
+        }
+
+        const size_t numInputBytes = is16Bit ? 2 : 1;
+        const std::vector<sys::ubyte> image =
+                createImage(numPixels, numInputBytes);
+        std::vector<sys::ubyte> expected(numPixels *
+                                         luts.back().elementSize);
+        std::vector<sys::ubyte> output(expected.size());
+        const double imageMB = image.size() / (1024.0 * 1024.0);
+
+        std::cout << std::setw(10) << "Threads"
+                  << std::setw(12) << "Seconds"
+                  << std::setw(12) << "MB/s"
+                  << std::setw(10) << "Speedup" << std::endl;
+
+        sys::RealTimeStopWatch sw;
+        sw.start();
+        for (size_t ii = 0; ii < numIterations; ++ii)
+        {
+            naiveRemap(luts, &image[0], numPixels, numInputBytes,
+                       &expected[0]);
+        }
+        const double naiveSeconds = sw.stop() / 1000 / numIterations;
+        std::cout << std::setw(10) << "naive"
+                  << std::fixed << std::setprecision(3)
+                  << std::setw(12) << naiveSeconds
+                  << std::setprecision(1)
+                  << std::setw(12) << imageMB / naiveSeconds
+                  << std::setprecision(2)
+                  << std::setw(9) << 1.0 << "x" << std::endl;
+
+        for (size_t ii = 0; ii < threadCounts.size(); ++ii)
+        {
+            six::sidd::LUTRemapper remapper(luts[0], threadCounts[ii]);
+            for (size_t jj = 1; jj < luts.size(); ++jj)
+            {
+                remapper.append(luts[jj]);
+            }
+
+            sw.clear();
+            sw.start();
+            for (size_t jj = 0; jj < numIterations; ++jj)
+            {
+                remapper.remap(&image[0], numPixels, &output[0]);
+            }
+            const double seconds = sw.stop() / 1000 / numIterations;
+
+            if (output != expected)
+            {
+                std::cerr << "Remapped pixels don't match" << std::endl;
+                return 1;
+            }
+
+            const size_t numThreads = (threadCounts[ii] == 0) ?
+                    sys::OS().getNumCPUsAvailable() : threadCounts[ii];
+            std::cout << std::setw(10) << numThreads
+                      << std::fixed << std::setprecision(3)
+                      << std::setw(12) << seconds
+                      << std::setprecision(1)
+                      << std::setw(12) << imageMB / seconds
+                      << std::setprecision(2)
+                      << std::setw(9) << naiveSeconds / seconds << "x"
+                      << std::endl;
+        }
+
+        return 0;
+    }
+    catch (const except::Exception& ex)
+    {
+        std::cerr << ex.toString() << std::endl;
+        return 1;
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+    catch (...)
+    {
+        std::cerr << "Unknown exception" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,145 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Compares the time to open SICDs/SIDDs with NITFReadControl::load() against
+ * NITFReadControl::loadMetadata().  Each file is opened repeatedly so the
+ * times reflect a warm file cache, which is the typical case when indexing
+ * a catalog.
+ */
+
+#include <iomanip>
+#include <iostream>
+
+#include <import/cli.h>
+#include <import/six.h>
+#include <import/six/sicd.h>
+#include <import/six/sidd.h>
+#include <logging/NullLogger.h>
+#include <sys/StopWatch.h>
+#include "utils.h"
+
+namespace
+{
+double timeLoad(six::NITFReadControl& reader,
+                const std::string& pathname,
+                const std::vector<std::string>& schemaPaths,
+                size_t numIterations,
+                bool metadataOnly)
+{
+    sys::RealTimeStopWatch sw;
+    sw.start();
+    for (size_t ii = 0; ii < numIterations; ++ii)
+    {
+        if (metadataOnly)
+        {
+            reader.loadMetadata(pathname, schemaPaths);
+        }
+        else
+        {
+            reader.load(pathname, schemaPaths);
+        }
+    }
+    return sw.stop() / numIterations;
+}
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        cli::ArgumentParser parser;
+        parser.setDescription(
+            "Times opening SICDs/SIDDs with NITFReadControl::load() and "
+            "NITFReadControl::loadMetadata()");
+        parser.addArgument("-n --iterations", "Number of times to open each "
+                           "file", cli::STORE, "iterations", "INT",
+                           1, 1, false)->setDefault(100);
+        parser.addArgument("-s --schema",
+                           "Specify a schema or directory of schemas",
+                           cli::STORE, "schema", "FILE");
+        parser.addArgument("input", "Input SICD/SIDD files", cli::STORE,
+                           "input", "INPUT", 1);
+
+        const std::auto_ptr<cli::Results>
+            options(parser.parse(argc, (const char**) argv));
+        const size_t numIterations = options->get<size_t>("iterations");
+        const cli::Value* const inputs = options->getValue("input");
+        std::vector<std::string> schemaPaths;
+        getSchemaPaths(*options, "--schema", "schema", schemaPaths);
+
+        six::XMLControlRegistry xmlRegistry;
+        xmlRegistry.addCreator(six::DataType::COMPLEX,
+                               new six::XMLControlCreatorT<
+                                       six::sicd::ComplexXMLControl>());
+        xmlRegistry.addCreator(six::DataType::DERIVED,
+                               new six::XMLControlCreatorT<
+                                       six::sidd::DerivedXMLControl>());
+
+        logging::NullLogger log;
+        six::NITFReadControl reader;
+        reader.setLogger(&log);
+        reader.setXMLControlRegistry(&xmlRegistry);
+
+        std::cout << std::setw(40) << std::left << "File (ms per open)"
+                  << std::right
+                  << std::setw(12) << "load"
+                  << std::setw(14) << "loadMetadata"
+                  << std::setw(10) << "Speedup" << std::endl;
+
+        for (size_t ii = 0; ii < inputs->size(); ++ii)
+        {
+            const std::string pathname = inputs->get<std::string>(ii);
+
+            const double fullMs = timeLoad(reader, pathname, schemaPaths,
+                                           numIterations, false);
+            const double metadataMs = timeLoad(reader, pathname, schemaPaths,
+                                               numIterations, true);
+
+            std::cout << std::setw(40) << std::left
+                      << sys::Path::basename(pathname)
+                      << std::right << std::fixed << std::setprecision(4)
+                      << std::setw(12) << fullMs
+                      << std::setw(14) << metadataMs
+                      << std::setprecision(2)
+                      << std::setw(9) << fullMs / metadataMs << "x"
+                      << std::endl;
+        }
+
+        return 0;
+    }
+    catch (const except::Exception& ex)
+    {
+        std::cerr << ex.toString() << std::endl;
+        return 1;
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+    catch (...)
+    {
+        std::cerr << "Unknown exception" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,191 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Summarizes the metadata of many SICDs, SIDDs, and CPHDs as CSV, reading
+ * several files at once.  Only headers and XML are read, so this is
+ * typically bound by file open latency; use more threads than CPUs when
+ * the files are on network storage.
+ */
+
+#include <fstream>
+#include <iostream>
+
+#include <import/cli.h>
+#include <import/six.h>
+#include <import/six/sicd.h>
+#include <import/six/sidd.h>
+#include <cphd/CPHDMetadataExtractor.h>
+#include <sys/StopWatch.h>
+#include "utils.h"
+
+namespace
+{
+void addPathnames(const std::string& input,
+                  std::vector<std::string>& pathnames)
+{
+    const sys::Path path(input);
+    if (!path.isDirectory())
+    {
+        pathnames.push_back(input);
+        return;
+    }
+
+    const std::vector<std::string> listing = path.list();
+    for (size_t ii = 0; ii < listing.size(); ++ii)
+    {
+        const sys::Path entry(path, listing[ii]);
+        if (entry.isFile())
+        {
+            pathnames.push_back(entry.getPath());
+        }
+    }
+}
+
+void readFileList(const std::string& listPathname,
+                  std::vector<std::string>& pathnames)
+{
+    std::ifstream listFile(listPathname.c_str());
+    if (!listFile)
+    {
+        throw except::FileNotFoundException(Ctxt(listPathname));
+    }
+
+    std::string line;
+    while (std::getline(listFile, line))
+    {
+        str::trim(line);
+        if (!line.empty())
+        {
+            pathnames.push_back(line);
+        }
+    }
+}
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        cli::ArgumentParser parser;
+        parser.setDescription(
+            "Summarize the metadata of SICD, SIDD, and CPHD files as CSV. "
+            "Directories are searched (non-recursively) for files.");
+        parser.addArgument("-l --list", "File containing one input pathname "
+                           "per line", cli::STORE, "list", "FILE");
+        parser.addArgument("-t --threads", "Number of files to read at once "
+                           "(0 for one per CPU)", cli::STORE, "threads",
+                           "INT", 1, 1, false)->setDefault(0);
+        parser.addArgument("-o --output", "Output CSV pathname (default is "
+                           "standard out)", cli::STORE, "output", "FILE");
+        parser.addArgument("-s --schema",
+                           "Specify a schema or directory of schemas",
+                           cli::STORE, "schema", "FILE");
+        parser.addArgument("input", "Input files or directories",
+                           cli::STORE, "input", "INPUT", 0);
+
+        const std::auto_ptr<cli::Results>
+            options(parser.parse(argc, (const char**) argv));
+        const size_t numThreads = options->get<size_t>("threads");
+        std::vector<std::string> schemaPaths;
+        getSchemaPaths(*options, "--schema", "schema", schemaPaths);
+
+        std::vector<std::string> pathnames;
+        if (options->hasValue("list"))
+        {
+            readFileList(options->get<std::string>("list"), pathnames);
+        }
+        if (options->hasValue("input"))
+        {
+            const cli::Value* const inputs = options->getValue("input");
+            for (size_t ii = 0; ii < inputs->size(); ++ii)
+            {
+                addPathnames(inputs->get<std::string>(ii), pathnames);
+            }
+        }
+        if (pathnames.empty())
+        {
+            throw except::Exception(Ctxt("No input files given"));
+        }
+
+        six::XMLControlRegistry xmlRegistry;
+        xmlRegistry.addCreator(six::DataType::COMPLEX,
+                               new six::XMLControlCreatorT<
+                                       six::sicd::ComplexXMLControl>());
+        xmlRegistry.addCreator(six::DataType::DERIVED,
+                               new six::XMLControlCreatorT<
+                                       six::sidd::DerivedXMLControl>());
+
+        const six::NITFMetadataExtractor nitfExtractor(&xmlRegistry,
+                                                       schemaPaths);
+        const cphd::CPHDMetadataExtractor cphdExtractor(schemaPaths);
+        std::vector<const six::MetadataExtractor*> extractors;
+        extractors.push_back(&nitfExtractor);
+        extractors.push_back(&cphdExtractor);
+
+        sys::RealTimeStopWatch sw;
+        sw.start();
+        std::vector<six::MetadataSummary> summaries;
+        six::extractMetadata(pathnames, extractors, numThreads, summaries);
+        const double elapsedMs = sw.stop();
+
+        if (options->hasValue("output"))
+        {
+            std::ofstream outFile(
+                    options->get<std::string>("output").c_str());
+            six::writeMetadataCSV(summaries, outFile);
+        }
+        else
+        {
+            six::writeMetadataCSV(summaries, std::cout);
+        }
+
+        size_t numFailed = 0;
+        for (size_t ii = 0; ii < summaries.size(); ++ii)
+        {
+            if (!summaries[ii].success)
+            {
+                ++numFailed;
+            }
+        }
+        std::cerr << "Summarized " << summaries.size() << " files ("
+                  << numFailed << " failed) in " << elapsedMs << " ms"
+                  << std::endl;
+
+        return (numFailed == 0) ? 0 : 1;
+    }
+    catch (const except::Exception& ex)
+    {
+        std::cerr << ex.toString() << std::endl;
+        return 1;
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+    catch (...)
+    {
+        std::cerr << "Unknown exception" << std::endl;
+        return 1;
+    }
+}
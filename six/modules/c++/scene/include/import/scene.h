@@ -24,10 +24,13 @@
 
 #include <scene/AdjustableParams.h>
 #include <scene/CoordinateTransform.h>
+#include <scene/DEMTileCache.h>
+#include <scene/DEMTileSource.h>
 #include <scene/ECEFToLLATransform.h>
 #include <scene/EllipsoidModel.h>
 #include <scene/Errors.h>
 #include <scene/FrameType.h>
+#include <scene/InverseProjectionCache.h>
 #include <scene/LLAToECEFTransform.h>
 #include <scene/LocalCoordinateTransform.h>
 #include <scene/GridECEFTransform.h>
@@ -37,5 +40,6 @@
 #include <scene/Utilities.h>
 #include <scene/ProjectionModel.h>
 #include <scene/ProjectionPolynomialFitter.h>
+#include <scene/TerrainProjector.h>
 
 #endif
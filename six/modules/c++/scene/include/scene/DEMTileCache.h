@@ -0,0 +1,123 @@
+/* =========================================================================
+ * This file is part of scene-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * scene-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SCENE_DEM_TILE_CACHE_H__
+#define __SCENE_DEM_TILE_CACHE_H__
+
+#include <map>
+#include <utility>
+
+#include <mem/SharedPtr.h>
+#include <sys/ConditionVar.h>
+#include <sys/Mutex.h>
+#include <scene/DEMTileSource.h>
+
+namespace scene
+{
+/*!
+ * \class DEMTileCache
+ * \brief Thread-safe, least-recently-used cache of DEM tiles
+ *
+ * Tiles are loaded from the DEMTileSource the first time a height inside
+ * of them is requested and are evicted once more than maxNumTiles are
+ * resident.  Heights are bilinearly interpolated between posts.
+ *
+ * Tiles are loaded without holding the cache lock, so lookups of tiles
+ * that are already resident never wait on disk I/O.  Threads that need a
+ * tile another thread is loading wait for that load rather than
+ * repeating it.
+ */
+class DEMTileCache
+{
+public:
+    /*!
+     * \param source Source to load tiles from.  Must outlive the cache.
+     * \param maxNumTiles Maximum number of tiles to keep in memory
+     * \param fillHeight Height (meters HAE) to use outside of the DEM
+     * coverage and in voids
+     */
+    DEMTileCache(const DEMTileSource& source,
+                 size_t maxNumTiles = 64,
+                 double fillHeight = 0.0);
+
+    const DEMTileSource& getSource() const
+    {
+        return mSource;
+    }
+
+    /*!
+     * \param latLon Location to look up (degrees)
+     * \return Interpolated height (meters HAE) at latLon
+     */
+    double getHeight(const LatLon& latLon) const;
+
+    //! \return Number of tiles currently resident
+    size_t getNumCachedTiles() const;
+
+    //! \return Number of times a tile had to be loaded from the source
+    size_t getNumTileLoads() const;
+
+    //! Drops all cached tiles
+    void clear();
+
+private:
+    typedef std::pair<size_t, size_t> TileKey;
+
+    struct CacheEntry
+    {
+        CacheEntry() :
+            lastUsed(0),
+            isLoading(false)
+        {
+        }
+
+        mem::SharedPtr<const DEMTile> tile;
+        size_t lastUsed;
+
+        //! Set while a thread is loading this tile outside of the lock
+        bool isLoading;
+    };
+
+    mem::SharedPtr<const DEMTile>
+    getTile(const types::RowCol<size_t>& tileIndex) const;
+
+    //! Evicts least recently used tiles.  Must hold mMutex.
+    void evict(const TileKey& keep) const;
+
+    bool isValid(float height) const
+    {
+        return height != mSource.getGeometry().noDataValue;
+    }
+
+private:
+    const DEMTileSource& mSource;
+    const size_t mMaxNumTiles;
+    const double mFillHeight;
+
+    mutable sys::Mutex mMutex;
+    mutable sys::ConditionVar mTileLoaded;
+    mutable std::map<TileKey, CacheEntry> mTiles;
+    mutable size_t mAccessCount;
+    mutable size_t mNumTileLoads;
+};
+}
+
+#endif
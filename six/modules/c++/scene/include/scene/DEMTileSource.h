@@ -0,0 +1,252 @@
+/* =========================================================================
+ * This file is part of scene-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * scene-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SCENE_DEM_TILE_SOURCE_H__
+#define __SCENE_DEM_TILE_SOURCE_H__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <io/FileInputStream.h>
+#include <sys/Mutex.h>
+#include <types/RowCol.h>
+#include <scene/Types.h>
+
+namespace scene
+{
+/*!
+ * \struct DEMGridGeometry
+ * \brief Describes a DEM posted on a regular latitude/longitude grid
+ *
+ * Row 0, column 0 is the north-west post.  Latitude decreases with
+ * increasing row and longitude increases with increasing column, which is
+ * the layout used by DTED and by north-up GeoTIFF elevation products.
+ * Heights are expected to be meters above the WGS-84 ellipsoid (HAE); if
+ * the source is referenced to a geoid, the caller is responsible for
+ * applying the geoid separation before handing it to SIX.
+ */
+struct DEMGridGeometry
+{
+    DEMGridGeometry();
+
+    /*!
+     * \param origin Latitude/longitude (degrees) of the north-west post
+     * \param spacing Latitude/longitude post spacing (degrees).  Both
+     * values are positive.
+     * \param dims Number of posts in the latitude (row) and longitude (col)
+     * directions
+     * \param noDataValue Heights equal to this value are treated as voids
+     *
+     * \throws except::Exception if the spacing or dims aren't positive
+     */
+    DEMGridGeometry(const LatLon& origin,
+                    const LatLon& spacing,
+                    const types::RowCol<size_t>& dims,
+                    float noDataValue = -32767.0f);
+
+    //! Converts a lat/lon to a fractional post location
+    types::RowCol<double> latLonToRowCol(const LatLon& latLon) const;
+
+    //! Converts a fractional post location to a lat/lon
+    LatLon rowColToLatLon(const types::RowCol<double>& rowCol) const;
+
+    LatLon origin;
+    LatLon spacing;
+    types::RowCol<size_t> dims;
+    float noDataValue;
+};
+
+/*!
+ * \class DEMTile
+ * \brief A rectangular block of DEM posts held in memory
+ *
+ * Tiles overlap their neighbors by one post in each direction so that
+ * bilinear interpolation never needs to look outside of a single tile.
+ */
+class DEMTile
+{
+public:
+    DEMTile(const types::RowCol<size_t>& offset,
+            const types::RowCol<size_t>& dims);
+
+    const types::RowCol<size_t>& getOffset() const
+    {
+        return mOffset;
+    }
+
+    const types::RowCol<size_t>& getDims() const
+    {
+        return mDims;
+    }
+
+    //! \return The height of the post at (row, col) relative to the tile
+    float operator()(size_t row, size_t col) const
+    {
+        return mHeights[row * mDims.col + col];
+    }
+
+    float* getHeights()
+    {
+        return mHeights.empty() ? NULL : &mHeights[0];
+    }
+
+    const float* getHeights() const
+    {
+        return mHeights.empty() ? NULL : &mHeights[0];
+    }
+
+private:
+    const types::RowCol<size_t> mOffset;
+    const types::RowCol<size_t> mDims;
+    std::vector<float> mHeights;
+};
+
+/*!
+ * \class DEMTileSource
+ * \brief Provides tiles of a DEM on request
+ *
+ * Implementations only need to know how to read a rectangular block of
+ * posts; the tiling scheme is handled here.  loadTile() may be called
+ * concurrently from multiple threads, so implementations must make
+ * readHeights() thread-safe.
+ */
+class DEMTileSource
+{
+public:
+    /*!
+     * \param geometry Grid geometry of the full DEM
+     * \param tileDims Number of posts in each tile (not counting the
+     * one post overlap)
+     */
+    DEMTileSource(const DEMGridGeometry& geometry,
+                  const types::RowCol<size_t>& tileDims);
+
+    virtual ~DEMTileSource();
+
+    const DEMGridGeometry& getGeometry() const
+    {
+        return mGeometry;
+    }
+
+    const types::RowCol<size_t>& getTileDims() const
+    {
+        return mTileDims;
+    }
+
+    //! \return The number of tiles in each direction
+    types::RowCol<size_t> getNumTiles() const;
+
+    /*!
+     * \param tileIndex Index of the tile to load
+     * \return Newly allocated tile
+     * \throws except::Exception if tileIndex is out of bounds
+     */
+    std::auto_ptr<DEMTile>
+    loadTile(const types::RowCol<size_t>& tileIndex) const;
+
+protected:
+    /*!
+     * Reads a rectangular block of posts, stored contiguously in row-major
+     * order, into 'heights'
+     *
+     * \param offset Starting post
+     * \param dims Number of posts to read
+     * \param heights [output] Must hold dims.area() values
+     */
+    virtual void readHeights(const types::RowCol<size_t>& offset,
+                             const types::RowCol<size_t>& dims,
+                             float* heights) const = 0;
+
+private:
+    const DEMGridGeometry mGeometry;
+    const types::RowCol<size_t> mTileDims;
+};
+
+/*!
+ * \class MemoryDEMTileSource
+ * \brief DEM that's already in memory
+ *
+ * The heights are not copied, so they must outlive this object.
+ */
+class MemoryDEMTileSource : public DEMTileSource
+{
+public:
+    /*!
+     * \param geometry Grid geometry of the DEM
+     * \param heights geometry.dims.area() heights in row-major order
+     * \param tileDims Number of posts in each tile
+     */
+    MemoryDEMTileSource(const DEMGridGeometry& geometry,
+                        const float* heights,
+                        const types::RowCol<size_t>& tileDims =
+                                types::RowCol<size_t>(256, 256));
+
+protected:
+    virtual void readHeights(const types::RowCol<size_t>& offset,
+                             const types::RowCol<size_t>& dims,
+                             float* heights) const;
+
+private:
+    const float* const mHeights;
+};
+
+/*!
+ * \class RawGridDEMTileSource
+ * \brief DEM stored on disk as a headerless grid of 32-bit floats
+ *
+ * This is the simplest format most GIS tools can export a DEM to (i.e.
+ * gdal_translate -of ENVI or -of EHdr) and is read in tiles on demand so
+ * that the entire DEM never needs to be resident.
+ */
+class RawGridDEMTileSource : public DEMTileSource
+{
+public:
+    /*!
+     * \param pathname Pathname of the raw grid
+     * \param geometry Grid geometry of the DEM
+     * \param isBigEndian Whether the heights are stored big-endian
+     * \param headerBytes Number of bytes to skip at the start of the file
+     * \param tileDims Number of posts in each tile
+     */
+    RawGridDEMTileSource(const std::string& pathname,
+                         const DEMGridGeometry& geometry,
+                         bool isBigEndian = false,
+                         sys::Off_T headerBytes = 0,
+                         const types::RowCol<size_t>& tileDims =
+                                 types::RowCol<size_t>(256, 256));
+
+protected:
+    virtual void readHeights(const types::RowCol<size_t>& offset,
+                             const types::RowCol<size_t>& dims,
+                             float* heights) const;
+
+private:
+    const bool mSwapBytes;
+    const sys::Off_T mHeaderBytes;
+
+    // The stream position is shared, so reads are serialized
+    mutable sys::Mutex mMutex;
+    mutable io::FileInputStream mInStream;
+};
+}
+
+#endif
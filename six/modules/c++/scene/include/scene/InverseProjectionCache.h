@@ -0,0 +1,176 @@
+/* =========================================================================
+ * This file is part of scene-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * scene-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SCENE_INVERSE_PROJECTION_CACHE_H__
+#define __SCENE_INVERSE_PROJECTION_CACHE_H__
+
+#include <vector>
+
+#include <scene/ProjectionModel.h>
+
+namespace scene
+{
+/*!
+ * \struct InverseProjectionErrors
+ * \brief Interpolation error of an InverseProjectionCache
+ *
+ * Errors are the distance (meters in the image grid) between the cached
+ * and exact sceneToImage() results, measured at the centers of the grid
+ * cells where interpolation is least accurate.
+ */
+struct InverseProjectionErrors
+{
+    InverseProjectionErrors() :
+        numSamples(0),
+        meanError(0.0),
+        rmsError(0.0),
+        maxError(0.0)
+    {
+    }
+
+    size_t numSamples;
+    double meanError;
+    double rmsError;
+    double maxError;
+};
+
+/*!
+ * \class InverseProjectionCache
+ * \brief Lookup table approximation of ProjectionModel::sceneToImage()
+ *
+ * The exact sceneToImage() is evaluated once on a regular grid spanning a
+ * box in an east/north/up frame centered on a reference point.  Queries
+ * inside of the box are answered by trilinear interpolation; queries
+ * outside of it fall back to the exact solver.  The grid is refined at
+ * construction until the interpolation error is within the requested
+ * tolerance or the maximum grid size is reached; check
+ * getErrorStatistics() to see what was achieved.
+ *
+ * The cache is built with zero adjustable parameter deltas and is
+ * read-only afterwards, so it may be queried concurrently.
+ */
+class InverseProjectionCache
+{
+public:
+    /*!
+     * \param model Projection model.  Must outlive this object.
+     * \param center ECEF center of the cached region, typically the SCP
+     * \param halfExtent Distance (meters) east/west and north/south of
+     * center to cache
+     * \param minHeight Lowest height (meters) above center to cache
+     * \param maxHeight Highest height (meters) above center to cache.  Must
+     * be greater than minHeight.
+     * \param tolerance Desired maximum interpolation error (meters in the
+     * image grid)
+     * \param maxPointsPerDim Maximum number of grid points to use along
+     * each axis
+     */
+    InverseProjectionCache(const ProjectionModel& model,
+                           const Vector3& center,
+                           double halfExtent,
+                           double minHeight,
+                           double maxHeight,
+                           double tolerance = 0.001,
+                           size_t maxPointsPerDim = 129);
+
+    /*!
+     * \param scenePoint ECEF scene point
+     * \param oTimeCOA [output] An optional ptr to the timeCOA, which, if
+     * NULL is not set.
+     * \return Image grid point (meters), interpolated if scenePoint is in
+     * the cached region and computed exactly otherwise
+     */
+    types::RowCol<double> sceneToImage(const Vector3& scenePoint,
+                                       double* oTimeCOA = NULL) const;
+
+    //! \return True if scenePoint is answered from the cache
+    bool contains(const Vector3& scenePoint) const;
+
+    //! \return Interpolation error of the final grid
+    const InverseProjectionErrors& getErrorStatistics() const
+    {
+        return mErrors;
+    }
+
+    //! \return Number of grid points along each horizontal axis and in
+    //! height
+    void getGridDims(size_t& numPointsXY, size_t& numPointsHeight) const
+    {
+        numPointsXY = mNumPointsXY;
+        numPointsHeight = mNumPointsHeight;
+    }
+
+    const ProjectionModel& getProjectionModel() const
+    {
+        return mModel;
+    }
+
+private:
+    struct Node
+    {
+        double row;
+        double col;
+        double timeCOA;
+    };
+
+    Vector3 toECEF(double x, double y, double height) const;
+
+    Vector3 toLocal(const Vector3& scenePoint) const;
+
+    bool isInside(const Vector3& local) const;
+
+    void build();
+
+    Node interpolate(const Vector3& local) const;
+
+    Node computeExact(const Vector3& ecef) const;
+
+    // Accumulates errors at the cell centers in the horizontal directions
+    // and between height layers, returning the max of each
+    void measureErrors(double& maxErrorXY, double& maxErrorHeight);
+
+    const Node& node(size_t hh, size_t yy, size_t xx) const
+    {
+        return mNodes[(hh * mNumPointsXY + yy) * mNumPointsXY + xx];
+    }
+
+private:
+    const ProjectionModel& mModel;
+    const Vector3 mCenter;
+    const double mHalfExtent;
+    const double mMinHeight;
+    const double mMaxHeight;
+
+    Vector3 mEast;
+    Vector3 mNorth;
+    Vector3 mUp;
+
+    size_t mNumPointsXY;
+    size_t mNumPointsHeight;
+    double mSpacingXY;
+    double mSpacingHeight;
+    std::vector<Node> mNodes;
+
+    InverseProjectionErrors mErrors;
+};
+}
+
+#endif
@@ -204,6 +204,52 @@ public:
                          double heightThreshold = 1.0,
                          size_t maxNumIters = 3) const;
 
+    /*!
+     * Computes the R/Rdot contour for an image grid point along with the
+     * ARP position and velocity at timeCOA, applying the adjustable
+     * parameters.  This is the first half of imageToScene(); callers
+     * that project the same image point onto several surfaces (i.e. a
+     * DEM) can compute this once and reuse it.
+     *
+     *  \param imageGridPoint A point (meters) in the image surface
+     *  \param delta Delta values to apply for the adjustable parameters
+     *  \param r [output] Range to the contour
+     *  \param rDot [output] Range rate of the contour
+     *  \param arpCOA [output] ARP position at timeCOA
+     *  \param velCOA [output] ARP velocity at timeCOA
+     *  \param oTimeCOA [output] optional evaluation of TimeCOAPoly at
+     *                  imageGridPoint.row, imageGridPoint.col
+     */
+    void computeAdjustedContour(const types::RowCol<double>& imageGridPoint,
+                                const AdjustableParams& delta,
+                                double& r,
+                                double& rDot,
+                                Vector3& arpCOA,
+                                Vector3& velCOA,
+                                double* oTimeCOA = NULL) const;
+
+    /*!
+     * Projects a precomputed R/Rdot contour to a constant HAE surface.
+     * See imageToScene(imageGridPoint, height, ...) for a description of
+     * the algorithm and of the heightThreshold and maxNumIters parameters.
+     *
+     *  \param r Range to the contour
+     *  \param rDot Range rate of the contour
+     *  \param arpCOA ARP position at timeCOA
+     *  \param velCOA ARP velocity at timeCOA
+     *  \param height Surface height (meters) above the WGS-84 reference
+     *  ellipsoid
+     *
+     *  \return A scene (ground) point in 3 space at the desired height
+     */
+    Vector3 contourToHAESurface(double r,
+                                double rDot,
+                                const Vector3& arpCOA,
+                                const Vector3& velCOA,
+                                double height,
+                                double heightThreshold = 1.0,
+                                size_t maxNumIters = 3) const;
+
     math::linear::MatrixMxN<2, 2> slantToImagePartials(
             const types::RowCol<double>& imageGridPoint,
             double delta = 0.0001) const;
@@ -323,6 +369,11 @@ public:
         return mErrors;
     }
 
+    const Vector3& getSCP() const
+    {
+        return mSCP;
+    }
+
 protected:
     // Inheriting classes must initialize mImagePlaneNormal and mScaleFactor
     // in their constructors
@@ -0,0 +1,127 @@
+/* =========================================================================
+ * This file is part of scene-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * scene-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SCENE_TERRAIN_PROJECTOR_H__
+#define __SCENE_TERRAIN_PROJECTOR_H__
+
+#include <vector>
+
+#include <scene/AdjustableParams.h>
+#include <scene/DEMTileCache.h>
+#include <scene/ProjectionModel.h>
+
+namespace scene
+{
+/*!
+ * \class TerrainProjector
+ * \brief Projects image points onto a DEM
+ *
+ * This extends the constant HAE projection of
+ * ProjectionModel::imageToScene() to a terrain surface.  The R/Rdot
+ * contour is computed once per image point and is then intersected with
+ * constant HAE surfaces whose height is refined (via the secant method on
+ * DEM height minus surface height) until the contour point lies on the
+ * DEM.  Batch projections run in parallel and seed each point with the
+ * height found for its predecessor, which for neighboring pixels is
+ * usually within a meter or two of the answer.
+ */
+class TerrainProjector
+{
+public:
+    /*!
+     * \param model Projection model.  Must outlive this object.
+     * \param dem DEM cache.  Must outlive this object.
+     * \param heightThreshold Convergence threshold (meters) between the
+     * contour point height and the DEM height below it
+     * \param maxNumIters Maximum number of height refinements per point
+     */
+    TerrainProjector(const ProjectionModel& model,
+                     const DEMTileCache& dem,
+                     double heightThreshold = 0.1,
+                     size_t maxNumIters = 20);
+
+    /*!
+     * Projects a single image point onto the DEM
+     *
+     * \param imageGridPoint A point (meters) in the image surface
+     * \param initialHeight Height (meters HAE) to start iterating from
+     * \param delta Delta values to apply for the adjustable parameters
+     *
+     * \return The ECEF location where the R/Rdot contour intersects the
+     * DEM
+     * \throws except::Exception if the projection does not converge
+     */
+    Vector3 imageToScene(const types::RowCol<double>& imageGridPoint,
+                         double initialHeight,
+                         const AdjustableParams& delta =
+                                 AdjustableParams()) const;
+
+    // Same as above, starting from the DEM height at the SCP
+    Vector3 imageToScene(const types::RowCol<double>& imageGridPoint) const
+    {
+        return imageToScene(imageGridPoint, mSCPHeight);
+    }
+
+    /*!
+     * Projects a batch of image points onto the DEM in parallel
+     *
+     * \param imageGridPoints Points (meters) in the image surface
+     * \param numPoints Number of points
+     * \param[out] scenePoints ECEF locations.  Must hold numPoints values.
+     * \param numThreads Number of threads to use.  If 0, the number of
+     * available CPUs is used.
+     *
+     * \throws except::Exception if any projection does not converge
+     */
+    void imageToScene(const types::RowCol<double>* imageGridPoints,
+                      size_t numPoints,
+                      Vector3* scenePoints,
+                      size_t numThreads = 0) const;
+
+    // Same as above, resizing scenePoints as needed
+    void imageToScene(
+            const std::vector<types::RowCol<double> >& imageGridPoints,
+            std::vector<Vector3>& scenePoints,
+            size_t numThreads = 0) const;
+
+    const ProjectionModel& getProjectionModel() const
+    {
+        return mModel;
+    }
+
+    const DEMTileCache& getDEM() const
+    {
+        return mDEM;
+    }
+
+private:
+    double getDEMHeight(const Vector3& ecef) const;
+
+private:
+    const ProjectionModel& mModel;
+    const DEMTileCache& mDEM;
+    const double mHeightThreshold;
+    const size_t mMaxNumIters;
+    double mSCPHeight;
+};
+}
+
+#endif
@@ -0,0 +1,212 @@
+/* =========================================================================
+ * This file is part of scene-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * scene-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <algorithm>
+#include <cmath>
+
+#include <except/Exception.h>
+#include <mt/CriticalSection.h>
+#include <scene/DEMTileCache.h>
+
+namespace scene
+{
+DEMTileCache::DEMTileCache(const DEMTileSource& source,
+                           size_t maxNumTiles,
+                           double fillHeight) :
+    mSource(source),
+    mMaxNumTiles(maxNumTiles),
+    mFillHeight(fillHeight),
+    mTileLoaded(&mMutex),
+    mAccessCount(0),
+    mNumTileLoads(0)
+{
+    if (mMaxNumTiles == 0)
+    {
+        throw except::Exception(Ctxt("DEM cache must hold at least one tile"));
+    }
+}
+
+double DEMTileCache::getHeight(const LatLon& latLon) const
+{
+    const DEMGridGeometry& geometry(mSource.getGeometry());
+    const types::RowCol<double> post(geometry.latLonToRowCol(latLon));
+
+    if (post.row < 0.0 || post.col < 0.0 ||
+        post.row > static_cast<double>(geometry.dims.row - 1) ||
+        post.col > static_cast<double>(geometry.dims.col - 1))
+    {
+        return mFillHeight;
+    }
+
+    // Interpolate from the post to the upper-left.  On the last row/col
+    // of the DEM, back off by one so we still have a 2x2 neighborhood.
+    size_t row = static_cast<size_t>(post.row);
+    size_t col = static_cast<size_t>(post.col);
+    if (row + 1 >= geometry.dims.row && row > 0)
+    {
+        --row;
+    }
+    if (col + 1 >= geometry.dims.col && col > 0)
+    {
+        --col;
+    }
+
+    const types::RowCol<size_t>& tileDims(mSource.getTileDims());
+    const mem::SharedPtr<const DEMTile> tile =
+            getTile(types::RowCol<size_t>(row / tileDims.row,
+                                          col / tileDims.col));
+
+    const size_t tileRow = row - tile->getOffset().row;
+    const size_t tileCol = col - tile->getOffset().col;
+    const size_t nextRow = std::min(tileRow + 1, tile->getDims().row - 1);
+    const size_t nextCol = std::min(tileCol + 1, tile->getDims().col - 1);
+
+    const float h00 = (*tile)(tileRow, tileCol);
+    const float h01 = (*tile)(tileRow, nextCol);
+    const float h10 = (*tile)(nextRow, tileCol);
+    const float h11 = (*tile)(nextRow, nextCol);
+
+    if (!isValid(h00) || !isValid(h01) || !isValid(h10) || !isValid(h11))
+    {
+        return mFillHeight;
+    }
+
+    const double dRow = post.row - static_cast<double>(row);
+    const double dCol = post.col - static_cast<double>(col);
+
+    return (1.0 - dRow) * ((1.0 - dCol) * h00 + dCol * h01) +
+            dRow * ((1.0 - dCol) * h10 + dCol * h11);
+}
+
+mem::SharedPtr<const DEMTile>
+DEMTileCache::getTile(const types::RowCol<size_t>& tileIndex) const
+{
+    const TileKey key(tileIndex.row, tileIndex.col);
+
+    mt::CriticalSection<sys::Mutex> crit(&mMutex);
+    while (true)
+    {
+        // Look the entry up again after every wait since it may have been
+        // erased if another thread's load failed
+        CacheEntry& entry = mTiles[key];
+        entry.lastUsed = ++mAccessCount;
+
+        if (entry.tile.get() != NULL)
+        {
+            return entry.tile;
+        }
+        if (!entry.isLoading)
+        {
+            entry.isLoading = true;
+            break;
+        }
+        mTileLoaded.wait();
+    }
+
+    evict(key);
+
+    // Load without the lock so that other threads can keep using the tiles
+    // that are already resident.  Readers holding a reference to an
+    // evicted tile keep it alive through the SharedPtr.
+    crit.manualUnlock();
+    mem::SharedPtr<const DEMTile> tile;
+    try
+    {
+        tile.reset(mSource.loadTile(tileIndex).release());
+    }
+    catch (...)
+    {
+        crit.manualLock();
+        mTiles.erase(key);
+        mTileLoaded.broadcast();
+        throw;
+    }
+    crit.manualLock();
+
+    CacheEntry& entry = mTiles[key];
+    entry.tile = tile;
+    entry.isLoading = false;
+    ++mNumTileLoads;
+    mTileLoaded.broadcast();
+
+    return tile;
+}
+
+void DEMTileCache::evict(const TileKey& keep) const
+{
+    // The cache is small enough that a linear search is cheaper than
+    // maintaining a separate ordering.  Tiles that are still loading are
+    // skipped, so the cache can briefly exceed its size while many threads
+    // load at once.
+    while (mTiles.size() > mMaxNumTiles)
+    {
+        std::map<TileKey, CacheEntry>::iterator oldest = mTiles.end();
+        for (std::map<TileKey, CacheEntry>::iterator iter = mTiles.begin();
+             iter != mTiles.end();
+             ++iter)
+        {
+            if (iter->first != keep && !iter->second.isLoading &&
+                (oldest == mTiles.end() ||
+                 iter->second.lastUsed < oldest->second.lastUsed))
+            {
+                oldest = iter;
+            }
+        }
+
+        if (oldest == mTiles.end())
+        {
+            break;
+        }
+        mTiles.erase(oldest);
+    }
+}
+
+size_t DEMTileCache::getNumCachedTiles() const
+{
+    mt::CriticalSection<sys::Mutex> crit(&mMutex);
+    return mTiles.size();
+}
+
+size_t DEMTileCache::getNumTileLoads() const
+{
+    mt::CriticalSection<sys::Mutex> crit(&mMutex);
+    return mNumTileLoads;
+}
+
+void DEMTileCache::clear()
+{
+    // Entries being loaded are kept so that the threads waiting on them
+    // don't start loads of their own
+    mt::CriticalSection<sys::Mutex> crit(&mMutex);
+    std::map<TileKey, CacheEntry>::iterator iter = mTiles.begin();
+    while (iter != mTiles.end())
+    {
+        if (iter->second.isLoading)
+        {
+            ++iter;
+        }
+        else
+        {
+            mTiles.erase(iter++);
+        }
+    }
+}
+}
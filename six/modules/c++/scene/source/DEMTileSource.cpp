@@ -0,0 +1,201 @@
+/* =========================================================================
+ * This file is part of scene-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * scene-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <algorithm>
+#include <cstring>
+
+#include <sys/Conf.h>
+#include <except/Exception.h>
+#include <mt/CriticalSection.h>
+#include <scene/DEMTileSource.h>
+
+namespace scene
+{
+DEMGridGeometry::DEMGridGeometry() :
+    dims(0, 0),
+    noDataValue(-32767.0f)
+{
+}
+
+DEMGridGeometry::DEMGridGeometry(const LatLon& origin_,
+                                 const LatLon& spacing_,
+                                 const types::RowCol<size_t>& dims_,
+                                 float noDataValue_) :
+    origin(origin_),
+    spacing(spacing_),
+    dims(dims_),
+    noDataValue(noDataValue_)
+{
+    if (spacing.getLat() <= 0.0 || spacing.getLon() <= 0.0)
+    {
+        throw except::Exception(Ctxt("DEM post spacing must be positive"));
+    }
+    if (dims.row == 0 || dims.col == 0)
+    {
+        throw except::Exception(Ctxt("DEM grid dimensions must be positive"));
+    }
+}
+
+types::RowCol<double>
+DEMGridGeometry::latLonToRowCol(const LatLon& latLon) const
+{
+    return types::RowCol<double>(
+            (origin.getLat() - latLon.getLat()) / spacing.getLat(),
+            (latLon.getLon() - origin.getLon()) / spacing.getLon());
+}
+
+LatLon DEMGridGeometry::rowColToLatLon(
+        const types::RowCol<double>& rowCol) const
+{
+    return LatLon(origin.getLat() - rowCol.row * spacing.getLat(),
+                  origin.getLon() + rowCol.col * spacing.getLon());
+}
+
+DEMTile::DEMTile(const types::RowCol<size_t>& offset,
+                 const types::RowCol<size_t>& dims) :
+    mOffset(offset),
+    mDims(dims),
+    mHeights(dims.area())
+{
+}
+
+DEMTileSource::DEMTileSource(const DEMGridGeometry& geometry,
+                             const types::RowCol<size_t>& tileDims) :
+    mGeometry(geometry),
+    mTileDims(tileDims)
+{
+    if (mGeometry.dims.row == 0 || mGeometry.dims.col == 0)
+    {
+        throw except::Exception(Ctxt("DEM grid dimensions must be positive"));
+    }
+    if (mTileDims.row == 0 || mTileDims.col == 0)
+    {
+        throw except::Exception(Ctxt("DEM tile dimensions must be positive"));
+    }
+}
+
+DEMTileSource::~DEMTileSource()
+{
+}
+
+types::RowCol<size_t> DEMTileSource::getNumTiles() const
+{
+    return types::RowCol<size_t>(
+            (mGeometry.dims.row + mTileDims.row - 1) / mTileDims.row,
+            (mGeometry.dims.col + mTileDims.col - 1) / mTileDims.col);
+}
+
+std::auto_ptr<DEMTile>
+DEMTileSource::loadTile(const types::RowCol<size_t>& tileIndex) const
+{
+    const types::RowCol<size_t> numTiles(getNumTiles());
+    if (tileIndex.row >= numTiles.row || tileIndex.col >= numTiles.col)
+    {
+        throw except::Exception(Ctxt(
+                "DEM tile (" + str::toString(tileIndex.row) + ", " +
+                str::toString(tileIndex.col) + ") is out of bounds"));
+    }
+
+    // Grab one extra post in each direction (when there is one) so that
+    // interpolation between tiles can be done from a single tile
+    const types::RowCol<size_t> offset(tileIndex.row * mTileDims.row,
+                                       tileIndex.col * mTileDims.col);
+    const types::RowCol<size_t> dims(
+            std::min(mTileDims.row + 1, mGeometry.dims.row - offset.row),
+            std::min(mTileDims.col + 1, mGeometry.dims.col - offset.col));
+
+    std::auto_ptr<DEMTile> tile(new DEMTile(offset, dims));
+    readHeights(offset, dims, tile->getHeights());
+    return tile;
+}
+
+MemoryDEMTileSource::MemoryDEMTileSource(
+        const DEMGridGeometry& geometry,
+        const float* heights,
+        const types::RowCol<size_t>& tileDims) :
+    DEMTileSource(geometry, tileDims),
+    mHeights(heights)
+{
+    if (mHeights == NULL)
+    {
+        throw except::Exception(Ctxt("Null DEM heights"));
+    }
+}
+
+void MemoryDEMTileSource::readHeights(const types::RowCol<size_t>& offset,
+                                      const types::RowCol<size_t>& dims,
+                                      float* heights) const
+{
+    const size_t numCols = getGeometry().dims.col;
+    const float* src = mHeights + offset.row * numCols + offset.col;
+    for (size_t row = 0; row < dims.row; ++row, src += numCols)
+    {
+        ::memcpy(heights + row * dims.col, src, dims.col * sizeof(float));
+    }
+}
+
+RawGridDEMTileSource::RawGridDEMTileSource(
+        const std::string& pathname,
+        const DEMGridGeometry& geometry,
+        bool isBigEndian,
+        sys::Off_T headerBytes,
+        const types::RowCol<size_t>& tileDims) :
+    DEMTileSource(geometry, tileDims),
+    mSwapBytes(isBigEndian != sys::isBigEndianSystem()),
+    mHeaderBytes(headerBytes),
+    mInStream(pathname)
+{
+    const sys::Off_T expectedSize = mHeaderBytes +
+            static_cast<sys::Off_T>(geometry.dims.area() * sizeof(float));
+    if (mInStream.available() < expectedSize)
+    {
+        throw except::Exception(Ctxt(
+                "DEM file " + pathname + " is smaller than the " +
+                str::toString(expectedSize) + " bytes its geometry requires"));
+    }
+}
+
+void RawGridDEMTileSource::readHeights(const types::RowCol<size_t>& offset,
+                                       const types::RowCol<size_t>& dims,
+                                       float* heights) const
+{
+    const size_t numCols = getGeometry().dims.col;
+    const size_t rowBytes = dims.col * sizeof(float);
+
+    {
+        mt::CriticalSection<sys::Mutex> crit(&mMutex);
+        for (size_t row = 0; row < dims.row; ++row)
+        {
+            const sys::Off_T fileOffset = mHeaderBytes +
+                    static_cast<sys::Off_T>(
+                            ((offset.row + row) * numCols + offset.col) *
+                            sizeof(float));
+            mInStream.seek(fileOffset, io::Seekable::START);
+            mInStream.read(heights + row * dims.col, rowBytes, true);
+        }
+    }
+
+    if (mSwapBytes)
+    {
+        sys::byteSwap(heights, sizeof(float), dims.area());
+    }
+}
+}
@@ -0,0 +1,346 @@
+/* =========================================================================
+ * This file is part of scene-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * scene-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <algorithm>
+#include <cmath>
+
+#include <except/Exception.h>
+#include <scene/ECEFToLLATransform.h>
+#include <scene/InverseProjectionCache.h>
+#include <scene/LocalCoordinateTransform.h>
+
+namespace
+{
+// Measuring error at every cell center would double the construction cost
+// on large grids, so sample at most this many cells along each axis
+const size_t MAX_ERROR_SAMPLES_1D = 32;
+
+size_t getErrorStride(size_t numCells)
+{
+    return std::max<size_t>(numCells / MAX_ERROR_SAMPLES_1D, 1);
+}
+
+void locate(double pos,
+            double spacing,
+            size_t numPoints,
+            size_t& index,
+            double& frac)
+{
+    const double scaled = pos / spacing;
+    index = std::min(static_cast<size_t>(std::max(scaled, 0.0)),
+                     numPoints - 2);
+    frac = scaled - static_cast<double>(index);
+}
+}
+
+namespace scene
+{
+InverseProjectionCache::InverseProjectionCache(const ProjectionModel& model,
+                                               const Vector3& center,
+                                               double halfExtent,
+                                               double minHeight,
+                                               double maxHeight,
+                                               double tolerance,
+                                               size_t maxPointsPerDim) :
+    mModel(model),
+    mCenter(center),
+    mHalfExtent(halfExtent),
+    mMinHeight(minHeight),
+    mMaxHeight(maxHeight),
+    mNumPointsXY(std::min<size_t>(9, maxPointsPerDim)),
+    mNumPointsHeight(2),
+    mSpacingXY(0.0),
+    mSpacingHeight(0.0)
+{
+    if (mHalfExtent <= 0.0)
+    {
+        throw except::Exception(Ctxt("Extent must be positive"));
+    }
+    if (mMaxHeight <= mMinHeight)
+    {
+        throw except::Exception(Ctxt(
+                "Max height must be greater than min height"));
+    }
+    if (tolerance <= 0.0)
+    {
+        throw except::Exception(Ctxt("Tolerance must be positive"));
+    }
+    if (maxPointsPerDim < 2)
+    {
+        throw except::Exception(Ctxt(
+                "Need at least two grid points per dimension"));
+    }
+
+    LatLonAlt centerLLA = ECEFToLLATransform().transform(mCenter);
+    ENUCoordinateTransform enu(centerLLA);
+    mEast = enu.getUnitVectorX();
+    mNorth = enu.getUnitVectorY();
+    mUp = enu.getUnitVectorZ();
+
+    // Start coarse and refine whichever direction is out of tolerance.
+    // The image coordinates curve very differently across the horizontal
+    // than they do with height, so the two rarely need the same density.
+    while (true)
+    {
+        build();
+
+        double maxErrorXY;
+        double maxErrorHeight;
+        measureErrors(maxErrorXY, maxErrorHeight);
+
+        if (mErrors.maxError <= tolerance)
+        {
+            break;
+        }
+
+        // Each direction can be within tolerance on its own while their
+        // combination isn't; refine the worse of the two in that case
+        bool refineXY = (maxErrorXY > tolerance);
+        bool refineHeight = (maxErrorHeight > tolerance);
+        if (!refineXY && !refineHeight)
+        {
+            refineXY = (maxErrorXY >= maxErrorHeight);
+            refineHeight = !refineXY;
+        }
+
+        const bool canRefineXY = (mNumPointsXY < maxPointsPerDim);
+        const bool canRefineHeight = (mNumPointsHeight < maxPointsPerDim);
+        if (refineXY && !canRefineXY)
+        {
+            refineHeight = true;
+        }
+        if (refineHeight && !canRefineHeight)
+        {
+            refineXY = true;
+        }
+
+        bool refined = false;
+        if (refineXY && canRefineXY)
+        {
+            mNumPointsXY = std::min(2 * mNumPointsXY - 1, maxPointsPerDim);
+            refined = true;
+        }
+        if (refineHeight && canRefineHeight)
+        {
+            mNumPointsHeight = std::min(2 * mNumPointsHeight - 1,
+                                        maxPointsPerDim);
+            refined = true;
+        }
+
+        if (!refined)
+        {
+            break;
+        }
+    }
+}
+
+Vector3 InverseProjectionCache::toECEF(double x, double y, double height) const
+{
+    return mCenter + mEast * x + mNorth * y + mUp * height;
+}
+
+Vector3 InverseProjectionCache::toLocal(const Vector3& scenePoint) const
+{
+    const Vector3 diff = scenePoint - mCenter;
+
+    Vector3 local;
+    local[0] = diff.dot(mEast);
+    local[1] = diff.dot(mNorth);
+    local[2] = diff.dot(mUp);
+    return local;
+}
+
+bool InverseProjectionCache::isInside(const Vector3& local) const
+{
+    return (std::abs(local[0]) <= mHalfExtent &&
+            std::abs(local[1]) <= mHalfExtent &&
+            local[2] >= mMinHeight &&
+            local[2] <= mMaxHeight);
+}
+
+InverseProjectionCache::Node
+InverseProjectionCache::computeExact(const Vector3& ecef) const
+{
+    Node node;
+    const types::RowCol<double> imagePt =
+            mModel.sceneToImage(ecef, &node.timeCOA);
+    node.row = imagePt.row;
+    node.col = imagePt.col;
+    return node;
+}
+
+void InverseProjectionCache::build()
+{
+    mSpacingXY = 2.0 * mHalfExtent / (mNumPointsXY - 1);
+    mSpacingHeight = (mMaxHeight - mMinHeight) / (mNumPointsHeight - 1);
+
+    mNodes.resize(mNumPointsHeight * mNumPointsXY * mNumPointsXY);
+    std::vector<Node>::iterator nodeIter = mNodes.begin();
+    for (size_t hh = 0; hh < mNumPointsHeight; ++hh)
+    {
+        const double height = mMinHeight + hh * mSpacingHeight;
+        for (size_t yy = 0; yy < mNumPointsXY; ++yy)
+        {
+            const double y = -mHalfExtent + yy * mSpacingXY;
+            for (size_t xx = 0; xx < mNumPointsXY; ++xx, ++nodeIter)
+            {
+                const double x = -mHalfExtent + xx * mSpacingXY;
+                *nodeIter = computeExact(toECEF(x, y, height));
+            }
+        }
+    }
+}
+
+InverseProjectionCache::Node
+InverseProjectionCache::interpolate(const Vector3& local) const
+{
+    size_t xx;
+    size_t yy;
+    size_t hh;
+    double tx;
+    double ty;
+    double th;
+    locate(local[0] + mHalfExtent, mSpacingXY, mNumPointsXY, xx, tx);
+    locate(local[1] + mHalfExtent, mSpacingXY, mNumPointsXY, yy, ty);
+    locate(local[2] - mMinHeight, mSpacingHeight, mNumPointsHeight, hh, th);
+
+    const double weights[8] = {
+        (1 - th) * (1 - ty) * (1 - tx),
+        (1 - th) * (1 - ty) * tx,
+        (1 - th) * ty * (1 - tx),
+        (1 - th) * ty * tx,
+        th * (1 - ty) * (1 - tx),
+        th * (1 - ty) * tx,
+        th * ty * (1 - tx),
+        th * ty * tx
+    };
+    const Node* const corners[8] = {
+        &node(hh, yy, xx),
+        &node(hh, yy, xx + 1),
+        &node(hh, yy + 1, xx),
+        &node(hh, yy + 1, xx + 1),
+        &node(hh + 1, yy, xx),
+        &node(hh + 1, yy, xx + 1),
+        &node(hh + 1, yy + 1, xx),
+        &node(hh + 1, yy + 1, xx + 1)
+    };
+
+    Node result;
+    result.row = 0.0;
+    result.col = 0.0;
+    result.timeCOA = 0.0;
+    for (size_t ii = 0; ii < 8; ++ii)
+    {
+        result.row += weights[ii] * corners[ii]->row;
+        result.col += weights[ii] * corners[ii]->col;
+        result.timeCOA += weights[ii] * corners[ii]->timeCOA;
+    }
+    return result;
+}
+
+void InverseProjectionCache::measureErrors(double& maxErrorXY,
+                                           double& maxErrorHeight)
+{
+    maxErrorXY = 0.0;
+    maxErrorHeight = 0.0;
+    double maxErrorCenter = 0.0;
+
+    double sumError = 0.0;
+    double sumSquaredError = 0.0;
+    size_t numSamples = 0;
+
+    const size_t strideXY = getErrorStride(mNumPointsXY - 1);
+    const size_t strideHeight = getErrorStride(mNumPointsHeight - 1);
+
+    // Horizontal cell centers on each height layer, midpoints between
+    // height layers above each horizontal grid point, and finally the full
+    // cell centers where both sources of error combine
+    for (size_t pass = 0; pass < 3; ++pass)
+    {
+        const bool centerXY = (pass != 1);
+        const bool centerHeight = (pass != 0);
+        const size_t numH = centerHeight ? mNumPointsHeight - 1 :
+                                           mNumPointsHeight;
+        const size_t numXY = centerXY ? mNumPointsXY - 1 : mNumPointsXY;
+        const double offsetXY = centerXY ? 0.5 * mSpacingXY : 0.0;
+        const double offsetH = centerHeight ? 0.5 * mSpacingHeight : 0.0;
+        double& maxError = (pass == 0) ? maxErrorXY :
+                (pass == 1) ? maxErrorHeight : maxErrorCenter;
+
+        for (size_t hh = 0; hh < numH; hh += strideHeight)
+        {
+            const double height = mMinHeight + hh * mSpacingHeight + offsetH;
+            for (size_t yy = 0; yy < numXY; yy += strideXY)
+            {
+                const double y = -mHalfExtent + yy * mSpacingXY + offsetXY;
+                for (size_t xx = 0; xx < numXY; xx += strideXY)
+                {
+                    const double x =
+                            -mHalfExtent + xx * mSpacingXY + offsetXY;
+                    const Vector3 ecef = toECEF(x, y, height);
+
+                    const Node exact = computeExact(ecef);
+                    const Node approx = interpolate(toLocal(ecef));
+                    const double error =
+                            std::sqrt((exact.row - approx.row) *
+                                              (exact.row - approx.row) +
+                                      (exact.col - approx.col) *
+                                              (exact.col - approx.col));
+
+                    maxError = std::max(maxError, error);
+                    sumError += error;
+                    sumSquaredError += error * error;
+                    ++numSamples;
+                }
+            }
+        }
+    }
+
+    mErrors.numSamples = numSamples;
+    mErrors.meanError = sumError / numSamples;
+    mErrors.rmsError = std::sqrt(sumSquaredError / numSamples);
+    mErrors.maxError =
+            std::max(std::max(maxErrorXY, maxErrorHeight), maxErrorCenter);
+}
+
+bool InverseProjectionCache::contains(const Vector3& scenePoint) const
+{
+    return isInside(toLocal(scenePoint));
+}
+
+types::RowCol<double>
+InverseProjectionCache::sceneToImage(const Vector3& scenePoint,
+                                     double* oTimeCOA) const
+{
+    const Vector3 local = toLocal(scenePoint);
+    if (!isInside(local))
+    {
+        return mModel.sceneToImage(scenePoint, oTimeCOA);
+    }
+
+    const Node result = interpolate(local);
+    if (oTimeCOA)
+    {
+        *oTimeCOA = result.timeCOA;
+    }
+    return types::RowCol<double>(result.row, result.col);
+}
+}
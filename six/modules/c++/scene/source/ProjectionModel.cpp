@@ -255,6 +255,50 @@ Vector3 ProjectionModel::imageToScene(
         const AdjustableParams& delta,
         double heightThreshold,
         size_t maxNumIters) const
+{
+    // Compute contour just once
+    double r;
+    double rDot;
+    Vector3 arpCOA;
+    Vector3 velCOA;
+    computeAdjustedContour(imageGridPoint, delta, r, rDot, arpCOA, velCOA);
+
+    return contourToHAESurface(r, rDot, arpCOA, velCOA, height,
+                               heightThreshold, maxNumIters);
+}
+
+void ProjectionModel::computeAdjustedContour(
+        const types::RowCol<double>& imageGridPoint,
+        const AdjustableParams& delta,
+        double& r,
+        double& rDot,
+        Vector3& arpCOA,
+        Vector3& velCOA,
+        double* oTimeCOA) const
+{
+    const double timeCOA = mTimeCOAPoly(imageGridPoint.row,
+                                        imageGridPoint.col);
+    if (oTimeCOA != NULL)
+    {
+        *oTimeCOA = timeCOA;
+    }
+
+    arpCOA = mARPPoly(timeCOA);
+    velCOA = mARPVelPoly(timeCOA);
+    computeContour(arpCOA, velCOA, timeCOA, imageGridPoint, &r, &rDot);
+
+    // Adjustable parameters are applied after computing R/Rdot contours
+    // Adjustable parameters do not affect Rdot
+    imageToSceneAdjustment(delta, timeCOA, r, arpCOA, velCOA);
+}
+
+Vector3 ProjectionModel::contourToHAESurface(double r,
+                                             double rDot,
+                                             const Vector3& arpCOA,
+                                             const Vector3& velCOA,
+                                             double height,
+                                             double heightThreshold,
+                                             size_t maxNumIters) const
 {
     // Sanity checks
     if (heightThreshold <= 0)
@@ -279,19 +323,6 @@ Vector3 ProjectionModel::imageToScene(
     Vector3 groundRefPoint =
             mSCP + (height - scpLatLon.getAlt()) * groundPlaneNormal;
 
-    // Compute contour just once
-    double r;
-    double rDot;
-    const double timeCOA = mTimeCOAPoly(imageGridPoint.row,
-                                        imageGridPoint.col);
-    Vector3 arpCOA = mARPPoly(timeCOA);
-    Vector3 velCOA = mARPVelPoly(timeCOA);
-    computeContour(arpCOA, velCOA, timeCOA, imageGridPoint, &r, &rDot);
-
-    // Adjustable parameters are applied after computing R/Rdot contours
-    // Adjustable parameters do not affect Rdot
-    imageToSceneAdjustment(delta, timeCOA, r, arpCOA, velCOA);
-
     Vector3 gppECEF;
     Vector3 uUP;
     double deltaHeight(std::numeric_limits<double>::max());
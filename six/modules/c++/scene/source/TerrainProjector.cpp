@@ -0,0 +1,216 @@
+/* =========================================================================
+ * This file is part of scene-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * scene-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <cmath>
+
+#include <except/Exception.h>
+#include <math/Utilities.h>
+#include <mt/ThreadGroup.h>
+#include <mt/ThreadPlanner.h>
+#include <sys/OS.h>
+#include <scene/ECEFToLLATransform.h>
+#include <scene/TerrainProjector.h>
+
+namespace
+{
+class TerrainProjectionRunnable : public sys::Runnable
+{
+public:
+    TerrainProjectionRunnable(const scene::TerrainProjector& projector,
+                              const types::RowCol<double>* imageGridPoints,
+                              size_t numPoints,
+                              double initialHeight,
+                              scene::Vector3* scenePoints) :
+        mProjector(projector),
+        mImageGridPoints(imageGridPoints),
+        mNumPoints(numPoints),
+        mInitialHeight(initialHeight),
+        mScenePoints(scenePoints)
+    {
+    }
+
+    virtual void run()
+    {
+        const scene::ECEFToLLATransform ecefToLatLon;
+        double height = mInitialHeight;
+        for (size_t ii = 0; ii < mNumPoints; ++ii)
+        {
+            mScenePoints[ii] =
+                    mProjector.imageToScene(mImageGridPoints[ii], height);
+
+            // Neighboring points are usually at similar heights
+            height = ecefToLatLon.transform(mScenePoints[ii]).getAlt();
+        }
+    }
+
+private:
+    const scene::TerrainProjector& mProjector;
+    const types::RowCol<double>* const mImageGridPoints;
+    const size_t mNumPoints;
+    const double mInitialHeight;
+    scene::Vector3* const mScenePoints;
+};
+}
+
+namespace scene
+{
+TerrainProjector::TerrainProjector(const ProjectionModel& model,
+                                   const DEMTileCache& dem,
+                                   double heightThreshold,
+                                   size_t maxNumIters) :
+    mModel(model),
+    mDEM(dem),
+    mHeightThreshold(heightThreshold),
+    mMaxNumIters(maxNumIters)
+{
+    if (mHeightThreshold <= 0)
+    {
+        throw except::Exception(Ctxt("Height threshold must be positive"));
+    }
+
+    if (mMaxNumIters < 1)
+    {
+        throw except::Exception(Ctxt(
+                "Max number of iterations must be positive"));
+    }
+
+    mSCPHeight = getDEMHeight(mModel.getSCP());
+}
+
+double TerrainProjector::getDEMHeight(const Vector3& ecef) const
+{
+    const LatLonAlt latLon = ECEFToLLATransform().transform(ecef);
+    return mDEM.getHeight(LatLon(latLon.getLat(), latLon.getLon()));
+}
+
+Vector3 TerrainProjector::imageToScene(
+        const types::RowCol<double>& imageGridPoint,
+        double initialHeight,
+        const AdjustableParams& delta) const
+{
+    // The contour doesn't depend on the surface, so only compute it once
+    double r;
+    double rDot;
+    Vector3 arpCOA;
+    Vector3 velCOA;
+    mModel.computeAdjustedContour(imageGridPoint, delta,
+                                  r, rDot, arpCOA, velCOA);
+
+    // Solve f(h) = DEM(P(h)) - h = 0 where P(h) is the intersection of the
+    // contour with the constant HAE surface at height h.  Over flat terrain
+    // the first fixed-point step lands on the answer; elsewhere the secant
+    // method takes over, which also copes with slopes steep enough to make
+    // plain fixed-point iteration diverge.
+    double prevHeight = initialHeight;
+    Vector3 scenePoint = mModel.contourToHAESurface(r, rDot, arpCOA, velCOA,
+                                                    prevHeight);
+    double prevResidual = getDEMHeight(scenePoint) - prevHeight;
+    if (std::abs(prevResidual) < mHeightThreshold)
+    {
+        return scenePoint;
+    }
+
+    double height = prevHeight + prevResidual;
+    for (size_t iter = 0; iter < mMaxNumIters; ++iter)
+    {
+        scenePoint = mModel.contourToHAESurface(r, rDot, arpCOA, velCOA,
+                                                height);
+        const double residual = getDEMHeight(scenePoint) - height;
+        if (std::abs(residual) < mHeightThreshold)
+        {
+            return scenePoint;
+        }
+
+        const double slope = (residual - prevResidual) / (height - prevHeight);
+        prevHeight = height;
+        prevResidual = residual;
+
+        if (slope != 0.0 && !math::isNaN(slope))
+        {
+            height -= residual / slope;
+        }
+        else
+        {
+            height += residual;
+        }
+    }
+
+    throw except::Exception(Ctxt(
+            "Terrain projection failed to converge for image point (" +
+            str::toString(imageGridPoint.row) + ", " +
+            str::toString(imageGridPoint.col) + ")"));
+}
+
+void TerrainProjector::imageToScene(
+        const types::RowCol<double>* imageGridPoints,
+        size_t numPoints,
+        Vector3* scenePoints,
+        size_t numThreads) const
+{
+    if (numThreads == 0)
+    {
+        numThreads = sys::OS().getNumCPUsAvailable();
+    }
+
+    if (numThreads <= 1)
+    {
+        TerrainProjectionRunnable(*this, imageGridPoints, numPoints,
+                                  mSCPHeight, scenePoints).run();
+    }
+    else
+    {
+        mt::ThreadGroup threads;
+        const mt::ThreadPlanner planner(numPoints, numThreads);
+
+        size_t threadNum(0);
+        size_t startPoint(0);
+        size_t numPointsThisThread(0);
+        while (planner.getThreadInfo(threadNum++,
+                                     startPoint,
+                                     numPointsThisThread))
+        {
+            std::auto_ptr<sys::Runnable> projector(
+                    new TerrainProjectionRunnable(
+                            *this,
+                            imageGridPoints + startPoint,
+                            numPointsThisThread,
+                            mSCPHeight,
+                            scenePoints + startPoint));
+            threads.createThread(projector);
+        }
+
+        threads.joinAll();
+    }
+}
+
+void TerrainProjector::imageToScene(
+        const std::vector<types::RowCol<double> >& imageGridPoints,
+        std::vector<Vector3>& scenePoints,
+        size_t numThreads) const
+{
+    scenePoints.resize(imageGridPoints.size());
+    if (!imageGridPoints.empty())
+    {
+        imageToScene(&imageGridPoints[0], imageGridPoints.size(),
+                     &scenePoints[0], numThreads);
+    }
+}
+}
@@ -26,6 +26,8 @@
 #include "six/convert/ConverterProviderRegistry.h"
 #include "six/convert/ConverterProvider.h"
 #include "six/convert/ConvertingReadControl.h"
+#include "six/convert/AmplitudeRemap.h"
+#include "six/convert/SIDDProductGenerator.h"
 
 #endif
 
@@ -0,0 +1,196 @@
+/* =========================================================================
+ * This file is part of six.convert-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.convert-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_CONVERT_AMPLITUDE_REMAP_H__
+#define __SIX_CONVERT_AMPLITUDE_REMAP_H__
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <six/Types.h>
+
+namespace six
+{
+namespace convert
+{
+/*!
+ * \class AmplitudeRemap
+ * \brief Remaps detected SAR amplitudes to 8-bit pixels
+ *
+ * Some remaps are driven by statistics of the whole scene.  Those return
+ * true from needsStatistics(), and whoever is remapping the scene must call
+ * setStatistics() before remapping any pixels.
+ */
+class AmplitudeRemap
+{
+public:
+    virtual ~AmplitudeRemap();
+
+    //! \return Whether setStatistics() must be called before remap()
+    virtual bool needsStatistics() const;
+
+    /*!
+     * Sets the statistics of the scene being remapped.  The default
+     * implementation ignores them.
+     *
+     * \param meanAmplitude Mean amplitude of the scene
+     * \param maxAmplitude Maximum amplitude of the scene
+     */
+    virtual void setStatistics(double meanAmplitude, double maxAmplitude);
+
+    /*!
+     * Remaps amplitudes to 8-bit pixels
+     *
+     * \param amplitudes Amplitudes to remap
+     * \param numPixels Number of amplitudes
+     * \param[out] output Remapped pixels.  Must hold numPixels values.
+     */
+    virtual void remap(const float* amplitudes,
+                       size_t numPixels,
+                       UByte* output) const = 0;
+};
+
+/*!
+ * \class LinearRemap
+ * \brief Scales amplitudes linearly so [0, maxAmplitude] spans [0, 255]
+ */
+class LinearRemap : public AmplitudeRemap
+{
+public:
+    /*!
+     * \param maxAmplitude Amplitude that maps to 255.  If 0, the maximum
+     * amplitude of the scene is used.
+     */
+    explicit LinearRemap(double maxAmplitude = 0.0);
+
+    virtual bool needsStatistics() const;
+
+    virtual void setStatistics(double meanAmplitude, double maxAmplitude);
+
+    virtual void remap(const float* amplitudes,
+                       size_t numPixels,
+                       UByte* output) const;
+
+private:
+    const bool mUseStatistics;
+    double mMaxAmplitude;
+};
+
+/*!
+ * \class LogRemap
+ * \brief Scales log(1 + amplitude) so [0, maxAmplitude] spans [0, 255]
+ */
+class LogRemap : public AmplitudeRemap
+{
+public:
+    /*!
+     * \param maxAmplitude Amplitude that maps to 255.  If 0, the maximum
+     * amplitude of the scene is used.
+     */
+    explicit LogRemap(double maxAmplitude = 0.0);
+
+    virtual bool needsStatistics() const;
+
+    virtual void setStatistics(double meanAmplitude, double maxAmplitude);
+
+    virtual void remap(const float* amplitudes,
+                       size_t numPixels,
+                       UByte* output) const;
+
+private:
+    const bool mUseStatistics;
+    double mScale;
+};
+
+/*!
+ * \class DensityRemap
+ * \brief Maps amplitudes to optical densities relative to the scene mean
+ *
+ * An amplitude of 0.8 * mean maps to minDensity and one of
+ * 0.8 * mean * maxMultiplier maps to 255, logarithmically in between.
+ * This brings out detail in the clutter rather than letting a few bright
+ * scatterers set the scale.
+ */
+class DensityRemap : public AmplitudeRemap
+{
+public:
+    /*!
+     * \param meanAmplitude Mean amplitude of the scene.  If 0, it's taken
+     * from the scene's statistics.
+     * \param minDensity Density of the low end of the clutter
+     * \param maxMultiplier Ratio of the amplitudes mapping to 255 and to
+     * minDensity
+     */
+    explicit DensityRemap(double meanAmplitude = 0.0,
+                          double minDensity = 30.0,
+                          double maxMultiplier = 40.0);
+
+    virtual bool needsStatistics() const;
+
+    virtual void setStatistics(double meanAmplitude, double maxAmplitude);
+
+    virtual void remap(const float* amplitudes,
+                       size_t numPixels,
+                       UByte* output) const;
+
+protected:
+    //! \return Density of 'amplitude', which may fall outside [0, 255]
+    double getDensity(float amplitude) const
+    {
+        return mSlope * std::log10(std::max(amplitude, 1e-5f)) + mConstant;
+    }
+
+private:
+    void setMeanAmplitude(double meanAmplitude);
+
+private:
+    const bool mUseStatistics;
+    const double mMinDensity;
+    const double mMaxMultiplier;
+    double mSlope;
+    double mConstant;
+};
+
+/*!
+ * \class PEDFRemap
+ * \brief Piecewise extended density format
+ *
+ * A density remap whose upper half is compressed by a factor of two, so
+ * bright returns keep some of their contrast instead of saturating.
+ */
+class PEDFRemap : public DensityRemap
+{
+public:
+    //! See DensityRemap
+    explicit PEDFRemap(double meanAmplitude = 0.0,
+                       double minDensity = 30.0,
+                       double maxMultiplier = 40.0);
+
+    virtual void remap(const float* amplitudes,
+                       size_t numPixels,
+                       UByte* output) const;
+};
+}
+}
+
+#endif
@@ -0,0 +1,171 @@
+/* =========================================================================
+ * This file is part of six.convert-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.convert-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_CONVERT_SIDD_PRODUCT_GENERATOR_H__
+#define __SIX_CONVERT_SIDD_PRODUCT_GENERATOR_H__
+
+#include <complex>
+#include <string>
+#include <vector>
+
+#include <io/OutputStream.h>
+#include <io/SeekableStreams.h>
+#include <types/RowCol.h>
+#include <six/NITFReadControl.h>
+#include <six/sicd/ComplexData.h>
+#include <six/convert/AmplitudeRemap.h>
+#include <six/sidd/DerivedData.h>
+
+namespace six
+{
+namespace convert
+{
+/*!
+ * \class SIDDProductGenerator
+ * \brief Generates a detected, remapped, output plane SIDD image from a SICD
+ *
+ * The output plane image is produced a block of rows at a time.  Each block
+ * is split into tiles; for each tile, the slant plane window it projects
+ * into is read from the SICD, detected, resampled with bilinear
+ * interpolation and remapped to 8 bits.  Only one tile's worth of slant
+ * plane pixels and one block of output rows are ever in memory, so a whole
+ * scene can be converted regardless of its size.  Projection, detection
+ * and resampling are done in parallel.
+ *
+ * Output plane pixels are mapped to the slant plane with polynomials fit
+ * over the SICD's area plane, which is derived if the SICD doesn't have
+ * one.  Output pixels that fall outside the SICD are 0.
+ *
+ * If the remap needs scene statistics, the SICD is read one extra time,
+ * again a block of rows at a time, to compute them.
+ */
+class SIDDProductGenerator
+{
+public:
+    //! Default number of output rows generated at once
+    static const size_t DEFAULT_ROWS_PER_BLOCK;
+
+    //! Default number of output columns in each tile of a block
+    static const size_t DEFAULT_COLS_PER_TILE;
+
+    /*!
+     * \param reader Reader loaded with a SICD
+     * \param remap Remap from amplitude to 8-bit pixels
+     * \param numThreads Number of threads to use.  If 0, uses the number
+     * of CPUs available.
+     * \param polyOrderX Order of the output to slant plane polynomials in
+     * the row direction
+     * \param polyOrderY Order of the output to slant plane polynomials in
+     * the column direction
+     *
+     * NOTE: reader and remap are stored by reference.  Make sure they
+     *       outlive this object.
+     *
+     * \throws except::Exception if the reader doesn't contain a SICD
+     */
+    SIDDProductGenerator(NITFReadControl& reader,
+                         AmplitudeRemap& remap,
+                         size_t numThreads = 0,
+                         size_t polyOrderX = 3,
+                         size_t polyOrderY = 3);
+
+    //! \return The SICD's metadata
+    const sicd::ComplexData& getComplexData() const
+    {
+        return mComplexData;
+    }
+
+    //! \return Dimensions of the output plane image
+    const types::RowCol<size_t>& getOutputDims() const
+    {
+        return mOutputDims;
+    }
+
+    /*!
+     * Sets how much of the output plane is generated at once
+     *
+     * \param numRowsPerBlock Number of output rows per block
+     * \param numColsPerTile Number of output columns in each tile
+     */
+    void setBlockSize(size_t numRowsPerBlock, size_t numColsPerTile);
+
+    /*!
+     * Generates the output plane image as MONO8I pixels.  Each block of
+     * rows is passed to a single output.write() call.
+     *
+     * \param output Stream to write the image to
+     */
+    void generate(io::OutputStream& output);
+
+    /*!
+     * Generates the output plane image and writes it as a SIDD through a
+     * SIDDByteProvider, a block of rows at a time
+     *
+     * \param data Metadata for the SIDD.  It must be MONO8I with the
+     * dimensions of the output plane.
+     * \param schemaPaths Directories or files of schema locations
+     * \param output Stream to write the SIDD to
+     *
+     * \throws except::Exception if 'data' doesn't match the output image
+     */
+    void generate(const sidd::DerivedData& data,
+                  const std::vector<std::string>& schemaPaths,
+                  io::SeekableOutputStream& output);
+
+private:
+    //! Computes the scene statistics and passes them to the remap
+    void computeStatistics();
+
+    void generateTile(size_t startRow,
+                      size_t numRows,
+                      size_t startCol,
+                      size_t numCols,
+                      UByte* block);
+
+    // Noncopyable
+    SIDDProductGenerator(const SIDDProductGenerator& );
+    const SIDDProductGenerator& operator=(const SIDDProductGenerator& );
+
+private:
+    NITFReadControl& mReader;
+    AmplitudeRemap& mRemap;
+    const size_t mNumThreads;
+    const sicd::ComplexData& mComplexData;
+    const types::RowCol<size_t> mSlantDims;
+
+    types::RowCol<size_t> mOutputDims;
+    size_t mNumRowsPerBlock;
+    size_t mNumColsPerTile;
+
+    //! Slant plane row and column as polynomials of (col, row) in the
+    //! output plane, so atY(row) gives the polynomial along a row
+    Poly2D mOutputToSlantRow;
+    Poly2D mOutputToSlantCol;
+
+    //! Scratch space, reused from tile to tile
+    std::vector<types::RowCol<double> > mSlantPixels;
+    std::vector<std::complex<float> > mWindow;
+    std::vector<float> mAmplitudes;
+};
+}
+}
+
+#endif
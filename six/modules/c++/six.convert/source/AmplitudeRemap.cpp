@@ -0,0 +1,223 @@
+/* =========================================================================
+ * This file is part of six.convert-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.convert-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cmath>
+#include <limits>
+#include <string>
+
+#include <except/Exception.h>
+#include <six/convert/AmplitudeRemap.h>
+
+namespace
+{
+six::UByte toPixel(double value)
+{
+    if (!(value > 0.0))
+    {
+        // Also catches NaN
+        return 0;
+    }
+    if (value >= 255.0)
+    {
+        return 255;
+    }
+    return static_cast<six::UByte>(value + 0.5);
+}
+
+void checkPositive(double value, const std::string& name)
+{
+    if (!(value > 0.0) || value == std::numeric_limits<double>::infinity())
+    {
+        throw except::Exception(Ctxt(
+                name + " must be positive and finite for an amplitude remap"));
+    }
+}
+}
+
+namespace six
+{
+namespace convert
+{
+AmplitudeRemap::~AmplitudeRemap()
+{
+}
+
+bool AmplitudeRemap::needsStatistics() const
+{
+    return false;
+}
+
+void AmplitudeRemap::setStatistics(double /*meanAmplitude*/,
+                                   double /*maxAmplitude*/)
+{
+}
+
+LinearRemap::LinearRemap(double maxAmplitude) :
+    mUseStatistics(maxAmplitude == 0.0),
+    mMaxAmplitude(maxAmplitude)
+{
+    if (!mUseStatistics)
+    {
+        checkPositive(maxAmplitude, "Max amplitude");
+    }
+}
+
+bool LinearRemap::needsStatistics() const
+{
+    return mUseStatistics;
+}
+
+void LinearRemap::setStatistics(double /*meanAmplitude*/,
+                                double maxAmplitude)
+{
+    if (mUseStatistics)
+    {
+        // A scene of zeros remaps to zeros
+        mMaxAmplitude = (maxAmplitude > 0.0) ? maxAmplitude : 1.0;
+    }
+}
+
+void LinearRemap::remap(const float* amplitudes,
+                        size_t numPixels,
+                        UByte* output) const
+{
+    const double scale = 255.0 / mMaxAmplitude;
+    for (size_t ii = 0; ii < numPixels; ++ii)
+    {
+        output[ii] = toPixel(amplitudes[ii] * scale);
+    }
+}
+
+LogRemap::LogRemap(double maxAmplitude) :
+    mUseStatistics(maxAmplitude == 0.0),
+    mScale(0.0)
+{
+    if (!mUseStatistics)
+    {
+        checkPositive(maxAmplitude, "Max amplitude");
+        mScale = 255.0 / std::log(1.0 + maxAmplitude);
+    }
+}
+
+bool LogRemap::needsStatistics() const
+{
+    return mUseStatistics;
+}
+
+void LogRemap::setStatistics(double /*meanAmplitude*/, double maxAmplitude)
+{
+    if (mUseStatistics)
+    {
+        mScale = 255.0 / std::log(
+                1.0 + (maxAmplitude > 0.0 ? maxAmplitude : 1.0));
+    }
+}
+
+void LogRemap::remap(const float* amplitudes,
+                     size_t numPixels,
+                     UByte* output) const
+{
+    for (size_t ii = 0; ii < numPixels; ++ii)
+    {
+        output[ii] = toPixel(
+                std::log(1.0 + std::max(amplitudes[ii], 0.0f)) * mScale);
+    }
+}
+
+DensityRemap::DensityRemap(double meanAmplitude,
+                           double minDensity,
+                           double maxMultiplier) :
+    mUseStatistics(meanAmplitude == 0.0),
+    mMinDensity(minDensity),
+    mMaxMultiplier(maxMultiplier),
+    mSlope(0.0),
+    mConstant(0.0)
+{
+    if (!(minDensity >= 0.0 && minDensity < 255.0))
+    {
+        throw except::Exception(Ctxt("Min density must be in [0, 255)"));
+    }
+    if (!(maxMultiplier > 1.0))
+    {
+        throw except::Exception(Ctxt("Max multiplier must be greater than 1"));
+    }
+    if (!mUseStatistics)
+    {
+        checkPositive(meanAmplitude, "Mean amplitude");
+        setMeanAmplitude(meanAmplitude);
+    }
+}
+
+bool DensityRemap::needsStatistics() const
+{
+    return mUseStatistics;
+}
+
+void DensityRemap::setStatistics(double meanAmplitude,
+                                 double /*maxAmplitude*/)
+{
+    if (mUseStatistics)
+    {
+        setMeanAmplitude(meanAmplitude > 0.0 ? meanAmplitude : 1.0);
+    }
+}
+
+void DensityRemap::setMeanAmplitude(double meanAmplitude)
+{
+    const double lowAmplitude = 0.8 * meanAmplitude;
+    mSlope = (255.0 - mMinDensity) / std::log10(mMaxMultiplier);
+    mConstant = mMinDensity - mSlope * std::log10(lowAmplitude);
+}
+
+void DensityRemap::remap(const float* amplitudes,
+                         size_t numPixels,
+                         UByte* output) const
+{
+    for (size_t ii = 0; ii < numPixels; ++ii)
+    {
+        output[ii] = toPixel(getDensity(amplitudes[ii]));
+    }
+}
+
+PEDFRemap::PEDFRemap(double meanAmplitude,
+                     double minDensity,
+                     double maxMultiplier) :
+    DensityRemap(meanAmplitude, minDensity, maxMultiplier)
+{
+}
+
+void PEDFRemap::remap(const float* amplitudes,
+                      size_t numPixels,
+                      UByte* output) const
+{
+    for (size_t ii = 0; ii < numPixels; ++ii)
+    {
+        double density = std::min(getDensity(amplitudes[ii]), 255.0);
+        if (density > 127.5)
+        {
+            density = 0.5 * (density + 127.5);
+        }
+        output[ii] = toPixel(density);
+    }
+}
+}
+}
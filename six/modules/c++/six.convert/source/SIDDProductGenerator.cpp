@@ -0,0 +1,589 @@
+/* =========================================================================
+ * This file is part of six.convert-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.convert-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <memory>
+
+#include <except/Exception.h>
+#include <mt/ThreadGroup.h>
+#include <nitf/NITFBufferList.hpp>
+#include <scene/ProjectionPolynomialFitter.h>
+#include <str/Convert.h>
+#include <sys/AtomicCounter.h>
+#include <sys/OS.h>
+#include <sys/Runnable.h>
+#include <six/convert/SIDDProductGenerator.h>
+#include <six/sicd/Utilities.h>
+#include <six/sidd/SIDDByteProvider.h>
+
+namespace
+{
+const six::sicd::ComplexData& getComplexData(six::NITFReadControl& reader)
+{
+    const mem::SharedPtr<six::Container> container = reader.getContainer();
+    if (container.get() == NULL ||
+        container->getDataType() != six::DataType::COMPLEX ||
+        container->getNumData() == 0)
+    {
+        throw except::Exception(Ctxt(
+                "Reader must be loaded with a SICD to generate a SIDD"));
+    }
+    return *static_cast<const six::sicd::ComplexData*>(container->getData(0));
+}
+
+/*!
+ * Runs 'op' on rows [0, numRows).  Each thread gets its own copy of the
+ * op, so it's free to keep scratch space, and claims rows with 'nextRow'.
+ */
+template <typename OpT>
+class RowRunnable : public sys::Runnable
+{
+public:
+    RowRunnable(const OpT& op, size_t numRows, sys::AtomicCounter& nextRow) :
+        mOp(op),
+        mNumRows(numRows),
+        mNextRow(nextRow)
+    {
+    }
+
+    virtual void run()
+    {
+        while (true)
+        {
+            const size_t row =
+                    static_cast<size_t>(mNextRow.getThenIncrement());
+            if (row >= mNumRows)
+            {
+                break;
+            }
+            mOp(row);
+        }
+    }
+
+private:
+    OpT mOp;
+    const size_t mNumRows;
+    sys::AtomicCounter& mNextRow;
+};
+
+template <typename OpT>
+void forEachRow(const OpT& op, size_t numRows, size_t numThreads)
+{
+    numThreads = std::min(numThreads, numRows);
+    sys::AtomicCounter nextRow;
+    if (numThreads <= 1)
+    {
+        RowRunnable<OpT>(op, numRows, nextRow).run();
+    }
+    else
+    {
+        mt::ThreadGroup threads;
+        for (size_t ii = 0; ii < numThreads; ++ii)
+        {
+            std::auto_ptr<sys::Runnable> runnable(
+                    new RowRunnable<OpT>(op, numRows, nextRow));
+            threads.createThread(runnable);
+        }
+        threads.joinAll();
+    }
+}
+
+//! Sums and finds the max of the amplitudes of each row
+class StatisticsOp
+{
+public:
+    StatisticsOp(const std::complex<float>* pixels,
+                 size_t numCols,
+                 double* sums,
+                 double* maxes) :
+        mPixels(pixels),
+        mNumCols(numCols),
+        mSums(sums),
+        mMaxes(maxes)
+    {
+    }
+
+    void operator()(size_t row) const
+    {
+        const std::complex<float>* const pixels = mPixels + row * mNumCols;
+        double sum = 0.0;
+        double maxAmplitude = 0.0;
+        for (size_t col = 0; col < mNumCols; ++col)
+        {
+            const double amplitude = std::abs(pixels[col]);
+            sum += amplitude;
+            maxAmplitude = std::max(maxAmplitude, amplitude);
+        }
+        mSums[row] = sum;
+        mMaxes[row] = maxAmplitude;
+    }
+
+private:
+    const std::complex<float>* mPixels;
+    size_t mNumCols;
+    double* mSums;
+    double* mMaxes;
+};
+
+//! Maps a row of a tile to the slant plane
+class ProjectOp
+{
+public:
+    ProjectOp(const six::Poly2D& outputToSlantRow,
+              const six::Poly2D& outputToSlantCol,
+              size_t startRow,
+              size_t startCol,
+              size_t numCols,
+              types::RowCol<double>* slantPixels) :
+        mOutputToSlantRow(outputToSlantRow),
+        mOutputToSlantCol(outputToSlantCol),
+        mStartRow(startRow),
+        mStartCol(startCol),
+        mNumCols(numCols),
+        mSlantPixels(slantPixels)
+    {
+    }
+
+    void operator()(size_t row) const
+    {
+        const double outputRow = static_cast<double>(mStartRow + row);
+        const six::Poly1D rowPoly = mOutputToSlantRow.atY(outputRow);
+        const six::Poly1D colPoly = mOutputToSlantCol.atY(outputRow);
+
+        types::RowCol<double>* const slantPixels =
+                mSlantPixels + row * mNumCols;
+        for (size_t col = 0; col < mNumCols; ++col)
+        {
+            const double outputCol = static_cast<double>(mStartCol + col);
+            slantPixels[col].row = rowPoly(outputCol);
+            slantPixels[col].col = colPoly(outputCol);
+        }
+    }
+
+private:
+    const six::Poly2D& mOutputToSlantRow;
+    const six::Poly2D& mOutputToSlantCol;
+    const size_t mStartRow;
+    const size_t mStartCol;
+    const size_t mNumCols;
+    types::RowCol<double>* mSlantPixels;
+};
+
+//! Detects a row of the slant plane window
+class DetectOp
+{
+public:
+    DetectOp(const std::complex<float>* pixels,
+             size_t numCols,
+             float* amplitudes) :
+        mPixels(pixels),
+        mNumCols(numCols),
+        mAmplitudes(amplitudes)
+    {
+    }
+
+    void operator()(size_t row) const
+    {
+        const size_t offset = row * mNumCols;
+        for (size_t col = 0; col < mNumCols; ++col)
+        {
+            mAmplitudes[offset + col] = std::abs(mPixels[offset + col]);
+        }
+    }
+
+private:
+    const std::complex<float>* mPixels;
+    size_t mNumCols;
+    float* mAmplitudes;
+};
+
+/*!
+ * Resamples a row of a tile from the detected slant plane window and
+ * remaps it into the output block
+ */
+class ResampleOp
+{
+public:
+    ResampleOp(const types::RowCol<double>* slantPixels,
+               size_t numCols,
+               const types::RowCol<size_t>& slantDims,
+               const types::RowCol<size_t>& windowOffset,
+               const types::RowCol<size_t>& windowDims,
+               const float* amplitudes,
+               const six::convert::AmplitudeRemap& remap,
+               six::UByte* output,
+               size_t outputStride) :
+        mSlantPixels(slantPixels),
+        mNumCols(numCols),
+        mSlantDims(slantDims),
+        mWindowOffset(windowOffset),
+        mWindowDims(windowDims),
+        mAmplitudes(amplitudes),
+        mRemap(remap),
+        mOutput(output),
+        mOutputStride(outputStride),
+        mRow(numCols)
+    {
+    }
+
+    void operator()(size_t row)
+    {
+        const types::RowCol<double>* const slantPixels =
+                mSlantPixels + row * mNumCols;
+        for (size_t col = 0; col < mNumCols; ++col)
+        {
+            mRow[col] = interpolate(slantPixels[col]);
+        }
+
+        six::UByte* const output = mOutput + row * mOutputStride;
+        mRemap.remap(&mRow[0], mNumCols, output);
+
+        for (size_t col = 0; col < mNumCols; ++col)
+        {
+            if (!isInside(slantPixels[col], mSlantDims))
+            {
+                output[col] = 0;
+            }
+        }
+    }
+
+    //! \return Whether 'pixel' is within half a pixel of the image
+    static bool isInside(const types::RowCol<double>& pixel,
+                         const types::RowCol<size_t>& dims)
+    {
+        return pixel.row >= -0.5 && pixel.row <= dims.row - 0.5 &&
+               pixel.col >= -0.5 && pixel.col <= dims.col - 0.5;
+    }
+
+    //! \return Upper left slant plane pixel used to interpolate 'value'
+    static size_t getFirstPixel(double value, size_t size)
+    {
+        const double clamped =
+                std::min(std::max(value, 0.0), static_cast<double>(size - 1));
+        return static_cast<size_t>(clamped);
+    }
+
+private:
+    float interpolate(const types::RowCol<double>& pixel) const
+    {
+        if (!isInside(pixel, mSlantDims))
+        {
+            return 0.0f;
+        }
+
+        const size_t row0 = getFirstPixel(pixel.row, mSlantDims.row);
+        const size_t col0 = getFirstPixel(pixel.col, mSlantDims.col);
+        const size_t row1 = std::min(row0 + 1, mSlantDims.row - 1);
+        const size_t col1 = std::min(col0 + 1, mSlantDims.col - 1);
+        const double rowFrac = std::min(std::max(pixel.row - row0, 0.0), 1.0);
+        const double colFrac = std::min(std::max(pixel.col - col0, 0.0), 1.0);
+
+        const float* const top = mAmplitudes +
+                (row0 - mWindowOffset.row) * mWindowDims.col;
+        const float* const bottom = mAmplitudes +
+                (row1 - mWindowOffset.row) * mWindowDims.col;
+        const size_t left = col0 - mWindowOffset.col;
+        const size_t right = col1 - mWindowOffset.col;
+        const double topValue =
+                top[left] + colFrac * (top[right] - top[left]);
+        const double bottomValue =
+                bottom[left] + colFrac * (bottom[right] - bottom[left]);
+        return static_cast<float>(
+                topValue + rowFrac * (bottomValue - topValue));
+    }
+
+private:
+    const types::RowCol<double>* mSlantPixels;
+    size_t mNumCols;
+    types::RowCol<size_t> mSlantDims;
+    types::RowCol<size_t> mWindowOffset;
+    types::RowCol<size_t> mWindowDims;
+    const float* mAmplitudes;
+    const six::convert::AmplitudeRemap& mRemap;
+    six::UByte* mOutput;
+    size_t mOutputStride;
+    std::vector<float> mRow;
+};
+
+/*!
+ * Hands each block of rows written to it to a byte provider and writes the
+ * resulting NITF bytes where they belong in the file
+ */
+class ByteProviderStream : public io::OutputStream
+{
+public:
+    ByteProviderStream(const six::ByteProvider& provider,
+                       size_t numCols,
+                       io::SeekableOutputStream& output) :
+        mProvider(provider),
+        mNumCols(numCols),
+        mOutput(output),
+        mNextRow(0)
+    {
+    }
+
+    virtual void write(const void* buffer, size_t len)
+    {
+        const size_t numRows = len / mNumCols;
+        nitf::Off fileOffset(0);
+        nitf::NITFBufferList buffers;
+        mProvider.getBytes(buffer, mNextRow, numRows, fileOffset, buffers);
+        mNextRow += numRows;
+
+        mOutput.seek(fileOffset, io::Seekable::START);
+        for (size_t ii = 0; ii < buffers.mBuffers.size(); ++ii)
+        {
+            mOutput.write(buffers.mBuffers[ii].mData,
+                          buffers.mBuffers[ii].mNumBytes);
+        }
+    }
+
+private:
+    const six::ByteProvider& mProvider;
+    const size_t mNumCols;
+    io::SeekableOutputStream& mOutput;
+    size_t mNextRow;
+};
+}
+
+namespace six
+{
+namespace convert
+{
+const size_t SIDDProductGenerator::DEFAULT_ROWS_PER_BLOCK = 256;
+const size_t SIDDProductGenerator::DEFAULT_COLS_PER_TILE = 1024;
+
+SIDDProductGenerator::SIDDProductGenerator(NITFReadControl& reader,
+                                           AmplitudeRemap& remap,
+                                           size_t numThreads,
+                                           size_t polyOrderX,
+                                           size_t polyOrderY) :
+    mReader(reader),
+    mRemap(remap),
+    mNumThreads(numThreads == 0 ?
+            sys::OS().getNumCPUsAvailable() : numThreads),
+    mComplexData(::getComplexData(reader)),
+    mSlantDims(mComplexData.getNumRows(), mComplexData.getNumCols()),
+    mNumRowsPerBlock(DEFAULT_ROWS_PER_BLOCK),
+    mNumColsPerTile(DEFAULT_COLS_PER_TILE)
+{
+    std::auto_ptr<scene::SceneGeometry> geometry;
+    std::auto_ptr<scene::ProjectionModel> projectionModel;
+    sicd::AreaPlane areaPlane;
+    sicd::Utilities::getModelComponents(mComplexData,
+                                        geometry,
+                                        projectionModel,
+                                        areaPlane);
+
+    types::RowCol<size_t> outputOffset;
+    mComplexData.getOutputPlaneOffsetAndExtent(areaPlane,
+                                               outputOffset,
+                                               mOutputDims);
+
+    const std::auto_ptr<scene::ProjectionPolynomialFitter> fitter(
+            sicd::Utilities::getPolynomialFitter(mComplexData));
+    const types::RowCol<size_t> slantOffset(mComplexData.imageData->firstRow,
+                                            mComplexData.imageData->firstCol);
+    const types::RowCol<double> slantSampleSpacing(
+            mComplexData.grid->row->sampleSpacing,
+            mComplexData.grid->col->sampleSpacing);
+    Poly2D outputToSlantRow;
+    Poly2D outputToSlantCol;
+    fitter->fitOutputToSlantPolynomials(slantOffset,
+                                        mComplexData.imageData->scpPixel,
+                                        mComplexData.imageData->scpPixel,
+                                        slantSampleSpacing,
+                                        polyOrderX,
+                                        polyOrderY,
+                                        outputToSlantRow,
+                                        outputToSlantCol);
+    mOutputToSlantRow = outputToSlantRow.flipXY();
+    mOutputToSlantCol = outputToSlantCol.flipXY();
+}
+
+void SIDDProductGenerator::setBlockSize(size_t numRowsPerBlock,
+                                        size_t numColsPerTile)
+{
+    if (numRowsPerBlock == 0 || numColsPerTile == 0)
+    {
+        throw except::Exception(Ctxt("Block size must be nonzero"));
+    }
+    mNumRowsPerBlock = numRowsPerBlock;
+    mNumColsPerTile = numColsPerTile;
+}
+
+void SIDDProductGenerator::computeStatistics()
+{
+    double sum = 0.0;
+    double maxAmplitude = 0.0;
+    std::vector<double> rowSums(mNumRowsPerBlock);
+    std::vector<double> rowMaxes(mNumRowsPerBlock);
+    for (size_t startRow = 0;
+         startRow < mSlantDims.row;
+         startRow += mNumRowsPerBlock)
+    {
+        const size_t numRows =
+                std::min(mNumRowsPerBlock, mSlantDims.row - startRow);
+        sicd::Utilities::getWidebandData(
+                mReader,
+                mComplexData,
+                types::RowCol<size_t>(startRow, 0),
+                types::RowCol<size_t>(numRows, mSlantDims.col),
+                mWindow);
+
+        forEachRow(StatisticsOp(&mWindow[0], mSlantDims.col,
+                                &rowSums[0], &rowMaxes[0]),
+                   numRows, mNumThreads);
+        for (size_t row = 0; row < numRows; ++row)
+        {
+            sum += rowSums[row];
+            maxAmplitude = std::max(maxAmplitude, rowMaxes[row]);
+        }
+    }
+
+    const size_t numPixels = mSlantDims.area();
+    mRemap.setStatistics(numPixels == 0 ? 0.0 : sum / numPixels,
+                         maxAmplitude);
+}
+
+void SIDDProductGenerator::generate(io::OutputStream& output)
+{
+    if (mRemap.needsStatistics())
+    {
+        computeStatistics();
+    }
+
+    const size_t numRowsPerBlock =
+            std::min(mNumRowsPerBlock, mOutputDims.row);
+    std::vector<UByte> block(numRowsPerBlock * mOutputDims.col);
+    for (size_t startRow = 0;
+         startRow < mOutputDims.row;
+         startRow += numRowsPerBlock)
+    {
+        const size_t numRows =
+                std::min(numRowsPerBlock, mOutputDims.row - startRow);
+        for (size_t startCol = 0;
+             startCol < mOutputDims.col;
+             startCol += mNumColsPerTile)
+        {
+            const size_t numCols =
+                    std::min(mNumColsPerTile, mOutputDims.col - startCol);
+            generateTile(startRow, numRows, startCol, numCols,
+                         &block[startCol]);
+        }
+        output.write(&block[0], numRows * mOutputDims.col);
+    }
+
+    // Don't hold on to a tile's worth of scratch space
+    std::vector<types::RowCol<double> >().swap(mSlantPixels);
+    std::vector<std::complex<float> >().swap(mWindow);
+    std::vector<float>().swap(mAmplitudes);
+}
+
+void SIDDProductGenerator::generate(
+        const sidd::DerivedData& data,
+        const std::vector<std::string>& schemaPaths,
+        io::SeekableOutputStream& output)
+{
+    if (data.getPixelType() != PixelType::MONO8I)
+    {
+        throw except::Exception(Ctxt(
+                "Generated SIDDs are MONO8I, not " +
+                data.getPixelType().toString()));
+    }
+    if (data.getNumRows() != mOutputDims.row ||
+        data.getNumCols() != mOutputDims.col)
+    {
+        throw except::Exception(Ctxt(
+                "SIDD is " + str::toString(data.getNumRows()) + " x " +
+                str::toString(data.getNumCols()) +
+                " but the output plane is " +
+                str::toString(mOutputDims.row) + " x " +
+                str::toString(mOutputDims.col)));
+    }
+
+    const sidd::SIDDByteProvider provider(data, schemaPaths);
+    ByteProviderStream stream(provider, mOutputDims.col, output);
+    generate(stream);
+}
+
+void SIDDProductGenerator::generateTile(size_t startRow,
+                                        size_t numRows,
+                                        size_t startCol,
+                                        size_t numCols,
+                                        UByte* block)
+{
+    const size_t numPixels = numRows * numCols;
+    mSlantPixels.resize(numPixels);
+    forEachRow(ProjectOp(mOutputToSlantRow, mOutputToSlantCol,
+                         startRow, startCol, numCols, &mSlantPixels[0]),
+               numRows, mNumThreads);
+
+    // Find the slant plane window the tile needs
+    types::RowCol<size_t> windowStart(mSlantDims);
+    types::RowCol<size_t> windowEnd(0, 0);
+    for (size_t ii = 0; ii < numPixels; ++ii)
+    {
+        const types::RowCol<double>& pixel = mSlantPixels[ii];
+        if (ResampleOp::isInside(pixel, mSlantDims))
+        {
+            const size_t row =
+                    ResampleOp::getFirstPixel(pixel.row, mSlantDims.row);
+            const size_t col =
+                    ResampleOp::getFirstPixel(pixel.col, mSlantDims.col);
+            windowStart.row = std::min(windowStart.row, row);
+            windowStart.col = std::min(windowStart.col, col);
+            windowEnd.row = std::max(windowEnd.row,
+                                     std::min(row + 2, mSlantDims.row));
+            windowEnd.col = std::max(windowEnd.col,
+                                     std::min(col + 2, mSlantDims.col));
+        }
+    }
+
+    if (windowEnd.row <= windowStart.row)
+    {
+        // Entirely outside of the SICD
+        for (size_t row = 0; row < numRows; ++row)
+        {
+            std::memset(block + row * mOutputDims.col, 0, numCols);
+        }
+        return;
+    }
+
+    const types::RowCol<size_t> windowDims(windowEnd.row - windowStart.row,
+                                           windowEnd.col - windowStart.col);
+    sicd::Utilities::getWidebandData(mReader, mComplexData,
+                                     windowStart, windowDims, mWindow);
+    mAmplitudes.resize(windowDims.area());
+    forEachRow(DetectOp(&mWindow[0], windowDims.col, &mAmplitudes[0]),
+               windowDims.row, mNumThreads);
+
+    forEachRow(ResampleOp(&mSlantPixels[0], numCols, mSlantDims,
+                          windowStart, windowDims, &mAmplitudes[0], mRemap,
+                          block, mOutputDims.col),
+               numRows, mNumThreads);
+}
+}
+}
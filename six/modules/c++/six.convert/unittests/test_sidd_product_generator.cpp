@@ -0,0 +1,272 @@
+/* =========================================================================
+ * This file is part of six.convert-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.convert-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "TestCase.h"
+
+#include <io/ByteStream.h>
+#include <io/FileOutputStream.h>
+#include <io/TempFile.h>
+#include <logging/NullLogger.h>
+#include <six/NITFReadControl.h>
+#include <six/XMLControlFactory.h>
+#include <six/convert/AmplitudeRemap.h>
+#include <six/convert/SIDDProductGenerator.h>
+#include <six/sicd/ComplexXMLControl.h>
+#include <six/sidd/DerivedXMLControl.h>
+#include <six/sidd/Utilities.h>
+#include <sys/Path.h>
+
+namespace
+{
+typedef six::convert::SIDDProductGenerator SIDDProductGenerator;
+
+sys::Path exePath;
+
+std::string findSixHome()
+{
+    sys::Path sixHome = exePath.join("..");
+    do
+    {
+        const sys::Path croppedNitfs = sixHome.join("croppedNitfs");
+        if (sys::OS().isDirectory(croppedNitfs.getAbsolutePath()))
+        {
+            return sixHome;
+        }
+        sixHome = sixHome.join("..");
+    } while (sixHome.getAbsolutePath() != sixHome.join("..").getAbsolutePath());
+    return "";
+}
+
+std::string getNITFPathname(const std::string& type,
+                            const std::string& filename)
+{
+    const std::string sixHome = findSixHome();
+    if (sixHome.empty())
+    {
+        throw except::Exception(Ctxt(
+                "Environment error: Cannot determine source tree root"));
+    }
+    return sys::Path(sixHome).join("croppedNitfs").join(type).
+            join(filename).getAbsolutePath();
+}
+
+class Reader
+{
+public:
+    Reader(const std::string& pathname)
+    {
+        mXMLRegistry.addCreator(six::DataType::COMPLEX,
+                                new six::XMLControlCreatorT<
+                                        six::sicd::ComplexXMLControl>());
+        mXMLRegistry.addCreator(six::DataType::DERIVED,
+                                new six::XMLControlCreatorT<
+                                        six::sidd::DerivedXMLControl>());
+        mReader.setLogger(&mLog);
+        mReader.setXMLControlRegistry(&mXMLRegistry);
+        mReader.load(pathname, std::vector<std::string>());
+    }
+
+    six::NITFReadControl& get()
+    {
+        return mReader;
+    }
+
+private:
+    logging::NullLogger mLog;
+    six::XMLControlRegistry mXMLRegistry;
+    six::NITFReadControl mReader;
+};
+
+std::vector<six::UByte> generate(SIDDProductGenerator& generator)
+{
+    io::ByteStream stream;
+    generator.generate(stream);
+
+    std::vector<six::UByte> image(generator.getOutputDims().area());
+    stream.seek(0, io::Seekable::START);
+    stream.read(&image[0], image.size(), true);
+    return image;
+}
+
+std::vector<six::UByte> remap(const six::convert::AmplitudeRemap& remap,
+                              const std::vector<float>& amplitudes)
+{
+    std::vector<six::UByte> output(amplitudes.size());
+    remap.remap(&amplitudes[0], amplitudes.size(), &output[0]);
+    return output;
+}
+
+TEST_CASE(testLinearAndLogRemaps)
+{
+    std::vector<float> amplitudes;
+    amplitudes.push_back(0.0f);
+    amplitudes.push_back(60.0f);
+    amplitudes.push_back(100.0f);
+    amplitudes.push_back(200.0f);
+
+    const six::convert::LinearRemap linear(100.0);
+    TEST_ASSERT(!linear.needsStatistics());
+    std::vector<six::UByte> output = remap(linear, amplitudes);
+    TEST_ASSERT_EQ(output[0], 0);
+    TEST_ASSERT_EQ(output[1], 153);
+    TEST_ASSERT_EQ(output[2], 255);
+    TEST_ASSERT_EQ(output[3], 255);
+
+    // The scene's max gives the same result
+    six::convert::LinearRemap sceneLinear;
+    TEST_ASSERT(sceneLinear.needsStatistics());
+    sceneLinear.setStatistics(10.0, 100.0);
+    TEST_ASSERT(remap(sceneLinear, amplitudes) == output);
+
+    const six::convert::LogRemap log(100.0);
+    output = remap(log, amplitudes);
+    TEST_ASSERT_EQ(output[0], 0);
+    TEST_ASSERT_EQ(output[1], 227);
+    TEST_ASSERT_EQ(output[2], 255);
+    TEST_ASSERT_EQ(output[3], 255);
+
+    TEST_EXCEPTION(six::convert::LinearRemap(-1.0));
+    TEST_EXCEPTION(six::convert::LogRemap(-1.0));
+}
+
+TEST_CASE(testDensityRemaps)
+{
+    // Mean of 10 puts the low clutter at 8 and saturation at 320
+    std::vector<float> amplitudes;
+    amplitudes.push_back(0.0f);
+    amplitudes.push_back(8.0f);
+    amplitudes.push_back(80.0f);
+    amplitudes.push_back(320.0f);
+    amplitudes.push_back(1000.0f);
+
+    six::convert::DensityRemap density;
+    TEST_ASSERT(density.needsStatistics());
+    density.setStatistics(10.0, 1000.0);
+    std::vector<six::UByte> output = remap(density, amplitudes);
+    TEST_ASSERT_EQ(output[0], 0);
+    TEST_ASSERT_EQ(output[1], 30);
+    TEST_ASSERT_EQ(output[2], 170);
+    TEST_ASSERT_EQ(output[3], 255);
+    TEST_ASSERT_EQ(output[4], 255);
+
+    // Same curve, with the top half compressed
+    const six::convert::PEDFRemap pedf(10.0);
+    TEST_ASSERT(!pedf.needsStatistics());
+    output = remap(pedf, amplitudes);
+    TEST_ASSERT_EQ(output[0], 0);
+    TEST_ASSERT_EQ(output[1], 30);
+    TEST_ASSERT_EQ(output[2], 149);
+    TEST_ASSERT_EQ(output[3], 191);
+    TEST_ASSERT_EQ(output[4], 191);
+
+    TEST_EXCEPTION(six::convert::DensityRemap(10.0, 300.0));
+    TEST_EXCEPTION(six::convert::DensityRemap(10.0, 30.0, 1.0));
+}
+
+TEST_CASE(testBlockSizeDoesNotMatter)
+{
+    Reader reader(getNITFPathname("SICD", "cropped_sicd_110.nitf"));
+
+    six::convert::DensityRemap remap;
+    SIDDProductGenerator serial(reader.get(), remap, 1);
+    const types::RowCol<size_t> dims = serial.getOutputDims();
+    TEST_ASSERT(dims.row > 0);
+    TEST_ASSERT(dims.col > 0);
+    const std::vector<six::UByte> expected(generate(serial));
+
+    // Something should have landed in the output plane
+    TEST_ASSERT(std::count(expected.begin(), expected.end(), 0) <
+                static_cast<ptrdiff_t>(expected.size() / 2));
+
+    SIDDProductGenerator parallel(reader.get(), remap, 3);
+    parallel.setBlockSize(2, 3);
+    TEST_ASSERT(generate(parallel) == expected);
+
+    TEST_EXCEPTION(parallel.setBlockSize(0, 3));
+}
+
+TEST_CASE(testWriteSIDD)
+{
+    Reader reader(getNITFPathname("SICD", "cropped_sicd_110.nitf"));
+
+    six::convert::LinearRemap remap;
+    SIDDProductGenerator generator(reader.get(), remap);
+    generator.setBlockSize(4, 1024);
+    const types::RowCol<size_t> dims = generator.getOutputDims();
+    const std::vector<six::UByte> expected(generate(generator));
+
+    std::auto_ptr<six::sidd::DerivedData> data =
+            six::sidd::Utilities::createFakeDerivedData();
+    data->setNumRows(dims.row);
+    data->setNumCols(dims.col);
+
+    // Wrong pixel type, then wrong size
+    data->setPixelType(six::PixelType::MONO16I);
+    const io::TempFile file;
+    {
+        io::FileOutputStream output(file.pathname());
+        TEST_EXCEPTION(generator.generate(*data, std::vector<std::string>(),
+                                          output));
+        data->setPixelType(six::PixelType::MONO8I);
+        data->setNumRows(dims.row + 1);
+        TEST_EXCEPTION(generator.generate(*data, std::vector<std::string>(),
+                                          output));
+        data->setNumRows(dims.row);
+        generator.generate(*data, std::vector<std::string>(), output);
+    }
+
+    Reader siddReader(file.pathname());
+    const six::Data* const siddData =
+            siddReader.get().getContainer()->getData(0);
+    TEST_ASSERT_EQ(siddData->getNumRows(), dims.row);
+    TEST_ASSERT_EQ(siddData->getNumCols(), dims.col);
+
+    std::vector<six::UByte> image(dims.area());
+    six::Region region;
+    region.setBuffer(&image[0]);
+    siddReader.get().interleaved(region, 0);
+    TEST_ASSERT(image == expected);
+}
+
+TEST_CASE(testRequiresSICD)
+{
+    Reader reader(getNITFPathname("SIDD", "cropped_sidd.nitf"));
+    six::convert::LinearRemap remap;
+    TEST_EXCEPTION(SIDDProductGenerator(reader.get(), remap));
+}
+}
+
+int main(int, char** argv)
+{
+    exePath = sys::Path(argv[0]).getAbsolutePath();
+    TEST_CHECK(testLinearAndLogRemaps);
+    TEST_CHECK(testDensityRemaps);
+    TEST_CHECK(testBlockSizeDoesNotMatter);
+    TEST_CHECK(testWriteSIDD);
+    TEST_CHECK(testRequiresSICD);
+    return 0;
+}
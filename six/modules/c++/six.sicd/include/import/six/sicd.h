@@ -26,6 +26,7 @@
 
 #include "six/sicd/Antenna.h"
 #include "six/sicd/AreaPlaneUtility.h"
+#include "six/sicd/ChipExtractor.h"
 #include "six/sicd/ComplexData.h"
 #include "six/sicd/ComplexDataBuilder.h"
 #include "six/sicd/ComplexXMLControl.h"
@@ -35,6 +36,7 @@
 #include "six/sicd/Grid.h"
 #include "six/sicd/ImageData.h"
 #include "six/sicd/ImageFormation.h"
+#include "six/sicd/OutputPlaneProjector.h"
 #include "six/sicd/PFA.h"
 #include "six/sicd/Position.h"
 #include "six/sicd/RadarCollection.h"
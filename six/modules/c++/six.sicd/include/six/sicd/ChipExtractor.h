@@ -0,0 +1,83 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_SICD_CHIP_EXTRACTOR_H__
+#define __SIX_SICD_CHIP_EXTRACTOR_H__
+
+#include <memory>
+
+#include <scene/ProjectionModel.h>
+#include <scene/SceneGeometry.h>
+#include <six/ChipExtractor.h>
+#include <six/NITFReadControl.h>
+#include <six/sicd/ComplexData.h>
+
+namespace six
+{
+namespace sicd
+{
+/*!
+ * \class ChipExtractor
+ * \brief Cuts many chips out of one open SICD
+ *
+ * The scene geometry and projection model are built once and shared by
+ * every chip.  Each chip's metadata is updated the same way cropSICD()
+ * updates it.
+ */
+class ChipExtractor : public six::ChipExtractor
+{
+public:
+    /*!
+     * \param reader Reader for the SICD.  NITFReadControl::load() must be
+     * called prior to this.
+     * \param numThreads Number of threads to use.  If 0, uses the number
+     * of CPUs available.
+     * \param blockSize Maximum number of bytes of pixels to read at once
+     *
+     * \throws except::Exception if the reader doesn't hold a SICD
+     */
+    ChipExtractor(NITFReadControl& reader,
+                  size_t numThreads = 0,
+                  size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+    //! \return The SICD's metadata
+    const ComplexData& getComplexData() const
+    {
+        return mData;
+    }
+
+    //! \return Projection model shared by every chip
+    const scene::ProjectionModel& getProjectionModel() const
+    {
+        return *mProjection;
+    }
+
+    virtual std::auto_ptr<Data> cropMetadata(const Chip& chip) const;
+
+private:
+    const ComplexData& mData;
+    const std::auto_ptr<const scene::SceneGeometry> mGeometry;
+    const std::auto_ptr<const scene::ProjectionModel> mProjection;
+};
+}
+}
+
+#endif
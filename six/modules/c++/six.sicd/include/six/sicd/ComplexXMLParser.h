@@ -46,6 +46,9 @@ public:
 
     ComplexData* fromXML(const xml::lite::Document* doc) const;
 
+    //! Also applies to the common SICD/SIDD parser
+    virtual void setFullPrecisionNumbers(bool fullPrecision);
+
 protected:
 
     virtual XMLElem convertGeoInfoToXML(const GeoInfo *obj,
@@ -23,12 +23,16 @@
 #ifndef __SIX_SICD_CROP_UTILS_H__
 #define __SIX_SICD_CROP_UTILS_H__
 
+#include <memory>
 #include <string>
 #include <vector>
 
 #include <types/RowCol.h>
+#include <scene/ProjectionModel.h>
+#include <scene/SceneGeometry.h>
 #include <scene/Types.h>
 #include <six/NITFReadControl.h>
+#include <six/sicd/ChipExtractor.h>
 #include <six/sicd/ComplexData.h>
 
 namespace six
@@ -37,7 +41,8 @@ namespace sicd
 {
 /*
  * Reads in an AOI from a SICD and creates a cropped SICD, updating the
- * metadata as appropriate to reflect this
+ * metadata as appropriate to reflect this.  The AOI is streamed through
+ * a SICDCropper, so the whole image is never held in memory.
  *
  * \param inPathname Input SICD pathname
  * \param schemaPaths Schema paths to use for reading and writing
@@ -131,6 +136,95 @@ std::auto_ptr<six::sicd::ComplexData>
 cropMetaData(const six::sicd::ComplexData& complexData,
              const types::RowCol<size_t>& aoiOffset,
              const types::RowCol<size_t>& aoiDims);
+
+/*
+ * Same as above but uses geometry already built from complexData, to
+ * avoid rebuilding it when cropping many AOIs.
+ */
+std::auto_ptr<six::sicd::ComplexData>
+cropMetaData(const six::sicd::ComplexData& complexData,
+             const scene::SceneGeometry& geometry,
+             const scene::ProjectionModel& projection,
+             const types::RowCol<size_t>& aoiOffset,
+             const types::RowCol<size_t>& aoiDims);
+
+/*!
+ * \class SICDCropper
+ * \brief Cuts AOIs out of an open SICD
+ *
+ * Each AOI is cut by a ChipExtractor and written as its own cropped SICD,
+ * so AOIs are streamed from the input with no byte swapping when its
+ * pixels are unblocked and uncompressed, and many AOIs from the same
+ * reader share one set of geometry.  See six::ChipExtractor.  The
+ * cropSICD() functions above use this.
+ */
+class SICDCropper
+{
+public:
+    //! Default maximum number of bytes of pixels read at once
+    static const size_t DEFAULT_BLOCK_SIZE;
+
+    /*!
+     * \param reader Reader for the SICD.  NITFReadControl::load() must be
+     * called prior to this.
+     * \param schemaPaths Schema paths to use for writing
+     * \param blockSize Maximum number of bytes of pixels to read at once.
+     * At least one row of an AOI is always read.
+     *
+     * \throws except::Exception if the reader doesn't hold a SICD
+     */
+    SICDCropper(six::NITFReadControl& reader,
+                const std::vector<std::string>& schemaPaths,
+                size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+    //! \return The SICD's metadata
+    const ComplexData& getData() const
+    {
+        return mExtractor.getComplexData();
+    }
+
+    /*!
+     * Writes an AOI as a cropped SICD
+     *
+     * \param aoiOffset Upper left corner of AOI
+     * \param aoiDims Size of AOI
+     * \param outPathname Output cropped SICD pathname
+     *
+     * \throws except::Exception if the AOI is empty or out of bounds
+     */
+    void crop(const types::RowCol<size_t>& aoiOffset,
+              const types::RowCol<size_t>& aoiDims,
+              const std::string& outPathname) const;
+
+    /*!
+     * Writes an AOI exscribed from four ECEF corners as a cropped SICD.
+     * See the cropSICD() overload with the same parameters.
+     */
+    void crop(const std::vector<scene::Vector3>& corners,
+              const std::string& outPathname,
+              bool trimCornersIfNeeded = true) const;
+
+    /*!
+     * Writes several AOIs, each as its own cropped SICD.  AOIs that are
+     * close together in the input are read together and written in
+     * parallel.
+     *
+     * \param aoiOffsets Upper left corner of each AOI
+     * \param aoiDims Size of each AOI
+     * \param outPathnames Output pathname of each AOI
+     *
+     * \throws except::Exception if the lists aren't the same size or any
+     * AOI is empty or out of bounds.  AOIs are checked before any are
+     * written.
+     */
+    void crop(const std::vector<types::RowCol<size_t> >& aoiOffsets,
+              const std::vector<types::RowCol<size_t> >& aoiDims,
+              const std::vector<std::string>& outPathnames) const;
+
+private:
+    const std::vector<std::string> mSchemaPaths;
+    const ChipExtractor mExtractor;
+};
 }
 }
 
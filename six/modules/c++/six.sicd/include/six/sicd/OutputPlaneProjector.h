@@ -0,0 +1,158 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_SICD_OUTPUT_PLANE_PROJECTOR_H__
+#define __SIX_SICD_OUTPUT_PLANE_PROJECTOR_H__
+
+#include <memory>
+#include <vector>
+
+#include <types/RowCol.h>
+#include <scene/GridECEFTransform.h>
+#include <scene/ProjectionModel.h>
+#include <scene/SceneGeometry.h>
+#include <six/sicd/ComplexData.h>
+
+namespace six
+{
+namespace sicd
+{
+/*!
+ *  \class OutputPlaneProjector
+ *  \brief Projects pixels between the slant plane and the output plane
+ *
+ *  The scene geometry, projection model and area plane are built once at
+ *  construction, so this should be preferred over
+ *  Utilities::projectPixelsToOutputPlane() and
+ *  Utilities::projectPixelsToSlantPlane() when projecting repeatedly.
+ *  All projection methods are const and may be called concurrently.
+ */
+class OutputPlaneProjector
+{
+public:
+    /*!
+     *  \param data Complex metadata.  If there is no area plane, one is
+     *  derived.
+     *
+     *  NOTE: data is stored by reference.  Make sure it outlives this
+     *        object.
+     */
+    OutputPlaneProjector(const ComplexData& data);
+
+    /*!
+     *  \param spPixel Slant plane pixel (row, col)
+     *  \return Output plane pixel (row, col)
+     */
+    types::RowCol<double>
+    slantToOutput(const types::RowCol<double>& spPixel) const;
+
+    /*!
+     *  \param opPixel Output plane pixel (row, col)
+     *  \return Slant plane pixel (row, col)
+     */
+    types::RowCol<double>
+    outputToSlant(const types::RowCol<double>& opPixel) const;
+
+    /*!
+     *  Project slant plane pixels to the output plane
+     *
+     *  \param spPixels Slant plane pixels
+     *  \param numPixels Number of pixels
+     *  \param[out] opPixels Output plane pixels.  Must hold numPixels
+     *  values.
+     *  \param numThreads Number of threads to use.  If 0, the number of
+     *  available CPUs is used.
+     */
+    void projectToOutputPlane(const types::RowCol<double>* spPixels,
+                              size_t numPixels,
+                              types::RowCol<double>* opPixels,
+                              size_t numThreads = 0) const;
+
+    // Same as above, resizing opPixels as needed
+    void projectToOutputPlane(
+            const std::vector<types::RowCol<double> >& spPixels,
+            std::vector<types::RowCol<double> >& opPixels,
+            size_t numThreads = 0) const;
+
+    /*!
+     *  Project output plane pixels to the slant plane
+     *
+     *  \param opPixels Output plane pixels
+     *  \param numPixels Number of pixels
+     *  \param[out] spPixels Slant plane pixels.  Must hold numPixels
+     *  values.
+     *  \param numThreads Number of threads to use.  If 0, the number of
+     *  available CPUs is used.
+     */
+    void projectToSlantPlane(const types::RowCol<double>* opPixels,
+                             size_t numPixels,
+                             types::RowCol<double>* spPixels,
+                             size_t numThreads = 0) const;
+
+    // Same as above, resizing spPixels as needed
+    void projectToSlantPlane(
+            const std::vector<types::RowCol<double> >& opPixels,
+            std::vector<types::RowCol<double> >& spPixels,
+            size_t numThreads = 0) const;
+
+    const scene::ProjectionModel& getProjectionModel() const
+    {
+        return *mProjectionModel;
+    }
+
+    const AreaPlane& getAreaPlane() const
+    {
+        return mAreaPlane;
+    }
+
+private:
+    typedef types::RowCol<double>
+    (OutputPlaneProjector::*ProjectFunc)(const types::RowCol<double>&) const;
+
+    void project(ProjectFunc func,
+                 const types::RowCol<double>* input,
+                 size_t numPixels,
+                 types::RowCol<double>* output,
+                 size_t numThreads) const;
+
+    // Noncopyable
+    OutputPlaneProjector(const OutputPlaneProjector& );
+    const OutputPlaneProjector& operator=(const OutputPlaneProjector& );
+
+private:
+    const ComplexData& mData;
+    std::auto_ptr<scene::SceneGeometry> mGeometry;
+    std::auto_ptr<scene::ProjectionModel> mProjectionModel;
+    AreaPlane mAreaPlane;
+
+    types::RowCol<double> mOPSampleSpacing;
+    types::RowCol<double> mOPCenterPixel;
+    Vector3 mORP;
+    Vector3 mGroundPlaneNormal;
+    std::auto_ptr<scene::PlanarGridECEFTransform> mECEFTransform;
+
+    types::RowCol<double> mSPSampleSpacing;
+    types::RowCol<double> mSPOffset;
+};
+}
+}
+
+#endif
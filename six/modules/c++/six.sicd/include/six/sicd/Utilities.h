@@ -29,6 +29,7 @@
 
 #include <scene/SceneGeometry.h>
 #include <scene/ProjectionModel.h>
+#include <scene/DEMTileCache.h>
 #include <six/sicd/ComplexData.h>
 #include <six/sicd/SICDMesh.h>
 #include <six/NITFReadControl.h>
@@ -571,11 +572,17 @@ public:
      * \param complexData Complex metadata.
      * \param spPixels Slant plane pixel coordinates.
      * \param opPixels Output plane pixel coordinates.
+     * \param numThreads Number of threads to use.  If 0, the number of
+     *  available CPUs is used.
+     *
+     * This rebuilds the projection model on every call.  Use
+     * OutputPlaneProjector directly when projecting repeatedly.
      */
     static void projectPixelsToOutputPlane(
         const six::sicd::ComplexData& complexData,
         const std::vector<types::RowCol<double> >& spPixels,
-        std::vector<types::RowCol<double> >& opPixels);
+        std::vector<types::RowCol<double> >& opPixels,
+        size_t numThreads = 1);
 
     /*!
      * Project slant plane valid data polygon pixel locations to output
@@ -592,11 +599,55 @@ public:
      * \param complexData Complex metadata.
      * \param opPixels Output plane pixel coordinates.
      * \param spPixels Slant plane pixel coordinates.
+     * \param numThreads Number of threads to use.  If 0, the number of
+     *  available CPUs is used.
+     *
+     * This rebuilds the projection model on every call.  Use
+     * OutputPlaneProjector directly when projecting repeatedly.
      */
     static void projectPixelsToSlantPlane(
         const six::sicd::ComplexData& complexData,
         const std::vector<types::RowCol<double> >& opPixels,
-        std::vector<types::RowCol<double> >& spPixels);
+        std::vector<types::RowCol<double> >& spPixels,
+        size_t numThreads = 1);
+
+    /*!
+     * Project slant plane pixel locations onto a DEM.
+     * \param complexData Complex metadata.
+     * \param dem DEM to project onto.
+     * \param spPixels Slant plane pixel coordinates.
+     * \param[out] scenePoints ECEF locations on the DEM.
+     * \param numThreads Number of threads to use.  If 0, the number of
+     *  available CPUs is used.
+     * \throws except::Exception if a pixel can't be projected onto the DEM
+     */
+    static void projectPixelsToTerrain(
+        const six::sicd::ComplexData& complexData,
+        const scene::DEMTileCache& dem,
+        const std::vector<types::RowCol<double> >& spPixels,
+        std::vector<scene::Vector3>& scenePoints,
+        size_t numThreads = 0);
+
+    /*!
+     * Build a terrain-corrected orthorectification grid by sampling the
+     * slant plane image at a regular pixel spacing and projecting each
+     * sample onto a DEM.  The last row and column of the image are always
+     * sampled so the grid covers the whole image.
+     * \param complexData Complex metadata.
+     * \param dem DEM to project onto.
+     * \param gridSpacing Spacing in slant plane pixels between samples.
+     * \param[out] grid Lat/lon/HAE of each sample in row-major order.
+     * \param numThreads Number of threads to use.  If 0, the number of
+     *  available CPUs is used.
+     * \return The number of samples in each direction.
+     * \throws except::Exception if a pixel can't be projected onto the DEM
+     */
+    static types::RowCol<size_t> getTerrainOrthoGrid(
+        const six::sicd::ComplexData& complexData,
+        const scene::DEMTileCache& dem,
+        const types::RowCol<size_t>& gridSpacing,
+        std::vector<scene::LatLonAlt>& grid,
+        size_t numThreads = 0);
 };
 }
 }
@@ -0,0 +1,60 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <except/Exception.h>
+#include <six/sicd/ChipExtractor.h>
+#include <six/sicd/CropUtils.h>
+#include <six/sicd/Utilities.h>
+
+namespace
+{
+const six::sicd::ComplexData& toComplexData(const six::Data& data)
+{
+    if (data.getDataType() != six::DataType::COMPLEX)
+    {
+        throw except::Exception(Ctxt("Input is not a SICD"));
+    }
+    return static_cast<const six::sicd::ComplexData&>(data);
+}
+}
+
+namespace six
+{
+namespace sicd
+{
+ChipExtractor::ChipExtractor(NITFReadControl& reader,
+                             size_t numThreads,
+                             size_t blockSize) :
+    six::ChipExtractor(reader, 0, numThreads, blockSize),
+    mData(toComplexData(getData())),
+    mGeometry(Utilities::getSceneGeometry(&mData)),
+    mProjection(Utilities::getProjectionModel(&mData, mGeometry.get()))
+{
+}
+
+std::auto_ptr<Data> ChipExtractor::cropMetadata(const Chip& chip) const
+{
+    return std::auto_ptr<Data>(cropMetaData(
+            mData, *mGeometry, *mProjection, chip.offset, chip.dims));
+}
+}
+}
@@ -50,7 +50,10 @@ xml::lite::Document* ComplexXMLControl::toXMLImpl(const Data* data)
     }
 
     const ComplexData* const sicd(reinterpret_cast<const ComplexData*>(data));
-    return getParser(data->getVersion())->toXML(sicd);
+    const std::auto_ptr<ComplexXMLParser> parser(
+            getParser(data->getVersion()));
+    parser->setFullPrecisionNumbers(mFullPrecisionNumbers);
+    return parser->toXML(sicd);
 }
 
 std::auto_ptr<ComplexXMLParser>
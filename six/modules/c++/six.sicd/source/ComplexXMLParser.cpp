@@ -44,6 +44,12 @@ ComplexXMLParser::ComplexXMLParser(const std::string& version,
 {
 }
 
+void ComplexXMLParser::setFullPrecisionNumbers(bool fullPrecision)
+{
+    XMLParser::setFullPrecisionNumbers(fullPrecision);
+    mCommon->setFullPrecisionNumbers(fullPrecision);
+}
+
 ComplexData* ComplexXMLParser::fromXML(const xml::lite::Document* doc) const
 {
     ComplexDataBuilder builder;
@@ -26,8 +26,6 @@
 #include <sys/Conf.h>
 #include <except/Exception.h>
 #include <str/Convert.h>
-#include <mem/ScopedArray.h>
-#include <six/NITFWriteControl.h>
 #include <six/sicd/CropUtils.h>
 #include <six/sicd/Utilities.h>
 #include <six/sicd/SlantPlanePixelTransformer.h>
@@ -81,145 +79,55 @@ six::sicd::ComplexData* const updateMetadata(
 
     return aoiData;
 }
-
-void cropSICD(six::NITFReadControl& reader,
-              const std::vector<std::string>& schemaPaths,
-              const six::sicd::ComplexData& data,
-              const scene::SceneGeometry& geom,
-              const scene::ProjectionModel& projection,
-              const types::RowCol<size_t>& aoiOffset,
-              const types::RowCol<size_t>& aoiDims,
-              const std::string& outPathname)
-{
-    // Make sure the AOI is in bounds
-    const types::RowCol<size_t> origDims(data.getNumRows(),
-                                         data.getNumCols());
-
-    if (aoiOffset.row + aoiDims.row > origDims.row ||
-        aoiOffset.col + aoiDims.col > origDims.col)
-    {
-        throw except::Exception(Ctxt("AOI dimensions are out of bounds"));
-    }
-
-    if (aoiDims.row < 1 || aoiDims.col < 1)
-    {
-        throw except::Exception(Ctxt("AOI must be non-empty"));
-    }
-
-    // Read in the AOI
-    const size_t numBytesPerPixel(data.getNumBytesPerPixel());
-    const size_t numBytes(origDims.row * origDims.col * numBytesPerPixel);
-    const mem::ScopedArray<sys::ubyte> buffer(new sys::ubyte[numBytes]);
-
-    six::Region region;
-    region.setStartRow(aoiOffset.row);
-    region.setStartCol(aoiOffset.col);
-    region.setNumRows(aoiDims.row);
-    region.setNumCols(aoiDims.col);
-    region.setBuffer(buffer.get());
-    reader.interleaved(region, 0);
-
-    six::sicd::ComplexData* const aoiData = updateMetadata(
-            data, geom,  projection,
-            aoiOffset, aoiDims);
-    std::auto_ptr<six::Data> scopedData(aoiData);
-
-    // Write the AOI SICD out
-    mem::SharedPtr<six::Container> container(new six::Container(
-            six::DataType::COMPLEX));
-    container->addData(scopedData);
-    six::NITFWriteControl writer(container);
-    six::BufferList images(1, buffer.get());
-    writer.save(images, outPathname, schemaPaths);
-}
-
 }
 
 namespace six
 {
 namespace sicd
 {
+const size_t SICDCropper::DEFAULT_BLOCK_SIZE = 32 * 1024 * 1024;
 
-std::auto_ptr<six::sicd::ComplexData> cropMetaData(
-        const six::sicd::ComplexData& complexData,
-        const types::RowCol<size_t>& aoiOffset,
-        const types::RowCol<size_t>& aoiDims)
+SICDCropper::SICDCropper(six::NITFReadControl& reader,
+                         const std::vector<std::string>& schemaPaths,
+                         size_t blockSize) :
+    mSchemaPaths(schemaPaths),
+    mExtractor(reader, 0, blockSize)
 {
-    // Build up the geometry info
-    std::auto_ptr<const scene::SceneGeometry> geom(
-            six::sicd::Utilities::getSceneGeometry(&complexData));
-
-    std::auto_ptr<const scene::ProjectionModel> projection(
-            six::sicd::Utilities::getProjectionModel(&complexData, geom.get()));
-
-    six::sicd::ComplexData* const aoiData = updateMetadata(
-            complexData,
-            *geom,
-            *projection,
-            aoiOffset,
-            aoiDims);
-
-    return std::auto_ptr<six::sicd::ComplexData>(aoiData);
 }
 
-void cropSICD(const std::string& inPathname,
-              const std::vector<std::string>& schemaPaths,
-              const types::RowCol<size_t>& aoiOffset,
-              const types::RowCol<size_t>& aoiDims,
-              const std::string& outPathname)
+void SICDCropper::crop(const types::RowCol<size_t>& aoiOffset,
+                       const types::RowCol<size_t>& aoiDims,
+                       const std::string& outPathname) const
 {
-    six::NITFReadControl reader;
-    reader.load(inPathname, schemaPaths);
-    cropSICD(reader, schemaPaths, aoiOffset, aoiDims, outPathname);
+    const std::vector<ChipExtractor::Chip> chips(
+            1, ChipExtractor::Chip(aoiOffset, aoiDims));
+    mExtractor.extract(chips, std::vector<std::string>(1, outPathname),
+                       mSchemaPaths);
 }
 
-void cropSICD(six::NITFReadControl& reader,
-              const std::vector<std::string>& schemaPaths,
-              const types::RowCol<size_t>& aoiOffset,
-              const types::RowCol<size_t>& aoiDims,
-              const std::string& outPathname)
+void SICDCropper::crop(
+        const std::vector<types::RowCol<size_t> >& aoiOffsets,
+        const std::vector<types::RowCol<size_t> >& aoiDims,
+        const std::vector<std::string>& outPathnames) const
 {
-    // Make sure it's a SICD
-    const mem::SharedPtr<const six::Container> container = reader.getContainer();
-
-    const six::Data* const dataPtr = container->getData(0);
-    if (container->getDataType() != six::DataType::COMPLEX ||
-        dataPtr->getDataType() != six::DataType::COMPLEX)
+    if (aoiOffsets.size() != aoiDims.size() ||
+        aoiOffsets.size() != outPathnames.size())
     {
-        throw except::Exception(Ctxt("Input is not a SICD"));
+        throw except::Exception(Ctxt(
+                "Need the same number of AOI offsets, sizes, and pathnames"));
     }
 
-    const ComplexData* const data =
-            reinterpret_cast<const ComplexData*>(dataPtr);
-
-    // Build up the geometry info
-    std::auto_ptr<const scene::SceneGeometry> geom(
-            six::sicd::Utilities::getSceneGeometry(data));
-
-    std::auto_ptr<const scene::ProjectionModel> projection(
-            six::sicd::Utilities::getProjectionModel(data, geom.get()));
-
-    // Actually do the cropping
-    ::cropSICD(reader, schemaPaths, *data, *geom, *projection,
-               aoiOffset, aoiDims, outPathname);
-}
-
-void cropSICD(const std::string& inPathname,
-              const std::vector<std::string>& schemaPaths,
-              const std::vector<scene::Vector3>& corners,
-              const std::string& outPathname,
-              bool trimCornersIfNeeded)
-{
-    six::NITFReadControl reader;
-    reader.load(inPathname, schemaPaths);
-    cropSICD(reader, schemaPaths, corners, outPathname, trimCornersIfNeeded);
+    std::vector<ChipExtractor::Chip> chips;
+    for (size_t ii = 0; ii < aoiOffsets.size(); ++ii)
+    {
+        chips.push_back(ChipExtractor::Chip(aoiOffsets[ii], aoiDims[ii]));
+    }
+    mExtractor.extract(chips, outPathnames, mSchemaPaths);
 }
 
-void cropSICD(six::NITFReadControl& reader,
-              const std::vector<std::string>& schemaPaths,
-              const std::vector<scene::Vector3>& corners,
-              const std::string& outPathname,
-              bool trimCornersIfNeeded)
+void SICDCropper::crop(const std::vector<scene::Vector3>& corners,
+                       const std::string& outPathname,
+                       bool trimCornersIfNeeded) const
 {
     if (corners.size() != 4)
     {
@@ -227,18 +135,7 @@ void cropSICD(six::NITFReadControl& reader,
                 str::toString(corners.size())));
     }
 
-    // Make sure it's a SICD
-    const mem::SharedPtr<const six::Container> container = reader.getContainer();
-
-    const six::Data* const dataPtr = container->getData(0);
-    if (container->getDataType() != six::DataType::COMPLEX ||
-        dataPtr->getDataType() != six::DataType::COMPLEX)
-    {
-        throw except::Exception(Ctxt("Input is not a SICD"));
-    }
-
-    const six::sicd::ComplexData* const data =
-            reinterpret_cast<const six::sicd::ComplexData*>(dataPtr);
+    const six::sicd::ComplexData* const data = &getData();
 
     // Convert ECEF corners to slant pixel pixels
     const ImageData& imageData(*data->imageData);
@@ -249,19 +146,14 @@ void cropSICD(six::NITFReadControl& reader,
             imageData.scpPixel.row - aoiOffset.row,
             imageData.scpPixel.col - aoiOffset.col);
 
-    std::auto_ptr<const scene::SceneGeometry> geom(
-            six::sicd::Utilities::getSceneGeometry(data));
-
-    std::auto_ptr<const scene::ProjectionModel> projection(
-            six::sicd::Utilities::getProjectionModel(data, geom.get()));
-
     types::RowCol<double> minPixel(static_cast<double>(data->getNumRows()),
                                    static_cast<double>(data->getNumCols()));
     types::RowCol<double> maxPixel(0.0, 0.0);
     for (size_t ii = 0; ii < corners.size(); ++ii)
     {
         const types::RowCol<double> imagePt =
-                projection->sceneToImage(corners[ii], NULL);
+                mExtractor.getProjectionModel().sceneToImage(
+                        corners[ii], NULL);
 
         const types::RowCol<double> spPixel(
                 (imagePt.row / data->grid->row->sampleSpacing) + offset.row,
@@ -310,8 +202,80 @@ void cropSICD(six::NITFReadControl& reader,
                                         lowerRight.col - upperLeft.col + 1);
 
     // Actually do the cropping
-    ::cropSICD(reader, schemaPaths, *data, *geom, *projection,
-               upperLeft, aoiDims, outPathname);
+    crop(upperLeft, aoiDims, outPathname);
+}
+
+std::auto_ptr<six::sicd::ComplexData> cropMetaData(
+        const six::sicd::ComplexData& complexData,
+        const types::RowCol<size_t>& aoiOffset,
+        const types::RowCol<size_t>& aoiDims)
+{
+    // Build up the geometry info
+    std::auto_ptr<const scene::SceneGeometry> geom(
+            six::sicd::Utilities::getSceneGeometry(&complexData));
+
+    std::auto_ptr<const scene::ProjectionModel> projection(
+            six::sicd::Utilities::getProjectionModel(&complexData, geom.get()));
+
+    return cropMetaData(complexData, *geom, *projection, aoiOffset, aoiDims);
+}
+
+std::auto_ptr<six::sicd::ComplexData> cropMetaData(
+        const six::sicd::ComplexData& complexData,
+        const scene::SceneGeometry& geometry,
+        const scene::ProjectionModel& projection,
+        const types::RowCol<size_t>& aoiOffset,
+        const types::RowCol<size_t>& aoiDims)
+{
+    six::sicd::ComplexData* const aoiData = updateMetadata(
+            complexData,
+            geometry,
+            projection,
+            aoiOffset,
+            aoiDims);
+
+    return std::auto_ptr<six::sicd::ComplexData>(aoiData);
+}
+
+void cropSICD(const std::string& inPathname,
+              const std::vector<std::string>& schemaPaths,
+              const types::RowCol<size_t>& aoiOffset,
+              const types::RowCol<size_t>& aoiDims,
+              const std::string& outPathname)
+{
+    six::NITFReadControl reader;
+    reader.load(inPathname, schemaPaths);
+    cropSICD(reader, schemaPaths, aoiOffset, aoiDims, outPathname);
+}
+
+void cropSICD(six::NITFReadControl& reader,
+              const std::vector<std::string>& schemaPaths,
+              const types::RowCol<size_t>& aoiOffset,
+              const types::RowCol<size_t>& aoiDims,
+              const std::string& outPathname)
+{
+    SICDCropper(reader, schemaPaths).crop(aoiOffset, aoiDims, outPathname);
+}
+
+void cropSICD(const std::string& inPathname,
+              const std::vector<std::string>& schemaPaths,
+              const std::vector<scene::Vector3>& corners,
+              const std::string& outPathname,
+              bool trimCornersIfNeeded)
+{
+    six::NITFReadControl reader;
+    reader.load(inPathname, schemaPaths);
+    cropSICD(reader, schemaPaths, corners, outPathname, trimCornersIfNeeded);
+}
+
+void cropSICD(six::NITFReadControl& reader,
+              const std::vector<std::string>& schemaPaths,
+              const std::vector<scene::Vector3>& corners,
+              const std::string& outPathname,
+              bool trimCornersIfNeeded)
+{
+    SICDCropper(reader, schemaPaths).crop(corners, outPathname,
+                                          trimCornersIfNeeded);
 }
 
 void cropSICD(const std::string& inPathname,
@@ -0,0 +1,226 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <mt/ThreadGroup.h>
+#include <mt/ThreadPlanner.h>
+#include <sys/OS.h>
+#include <sys/Runnable.h>
+#include <six/sicd/OutputPlaneProjector.h>
+#include <six/sicd/Utilities.h>
+
+namespace
+{
+template <typename ProjectFuncT>
+class ProjectPixelsRunnable : public sys::Runnable
+{
+public:
+    ProjectPixelsRunnable(const six::sicd::OutputPlaneProjector& projector,
+                          ProjectFuncT func,
+                          const types::RowCol<double>* input,
+                          size_t numPixels,
+                          types::RowCol<double>* output) :
+        mProjector(projector),
+        mFunc(func),
+        mInput(input),
+        mNumPixels(numPixels),
+        mOutput(output)
+    {
+    }
+
+    virtual void run()
+    {
+        for (size_t ii = 0; ii < mNumPixels; ++ii)
+        {
+            mOutput[ii] = (mProjector.*mFunc)(mInput[ii]);
+        }
+    }
+
+private:
+    const six::sicd::OutputPlaneProjector& mProjector;
+    const ProjectFuncT mFunc;
+    const types::RowCol<double>* const mInput;
+    const size_t mNumPixels;
+    types::RowCol<double>* const mOutput;
+};
+}
+
+namespace six
+{
+namespace sicd
+{
+OutputPlaneProjector::OutputPlaneProjector(const ComplexData& data) :
+    mData(data)
+{
+    Utilities::getModelComponents(mData,
+                                  mGeometry,
+                                  mProjectionModel,
+                                  mAreaPlane);
+
+    mOPSampleSpacing = types::RowCol<double>(mAreaPlane.xDirection->spacing,
+                                             mAreaPlane.yDirection->spacing);
+    mOPCenterPixel = types::RowCol<double>(
+            static_cast<double>(mAreaPlane.xDirection->elements / 2 + 1),
+            static_cast<double>(mAreaPlane.yDirection->elements / 2 + 1));
+    mORP = mAreaPlane.referencePoint.ecef;
+    mGroundPlaneNormal = Utilities::getGroundPlaneNormal(mData);
+
+    mECEFTransform.reset(new scene::PlanarGridECEFTransform(
+            mOPSampleSpacing,
+            mAreaPlane.referencePoint.rowCol,
+            mAreaPlane.xDirection->unitVector,
+            mAreaPlane.yDirection->unitVector,
+            mORP));
+
+    mSPSampleSpacing = types::RowCol<double>(mData.grid->row->sampleSpacing,
+                                             mData.grid->col->sampleSpacing);
+    const types::RowCol<double> spOrigOffset(
+            static_cast<double>(mData.imageData->firstRow),
+            static_cast<double>(mData.imageData->firstCol));
+    const types::RowCol<double> spSCP(mData.imageData->scpPixel);
+    mSPOffset = types::RowCol<double>(spSCP.row - spOrigOffset.row,
+                                      spSCP.col - spOrigOffset.col);
+}
+
+types::RowCol<double> OutputPlaneProjector::slantToOutput(
+        const types::RowCol<double>& spPixel) const
+{
+    const types::RowCol<double> spXY(mData.pixelToImagePoint(spPixel));
+
+    // Convert to output plane ECEF.
+    const Vector3 opECEF =
+            mProjectionModel->imageToScene(spXY, mORP, mGroundPlaneNormal);
+
+    // Convert ECEF to output distance to the output plane ORP.
+    const Vector3 diffECEF = opECEF - mORP;
+    const double opX = diffECEF.dot(mAreaPlane.xDirection->unitVector);
+    const double opY = diffECEF.dot(mAreaPlane.yDirection->unitVector);
+
+    // Convert XY to pixels.
+    return types::RowCol<double>(opX / mOPSampleSpacing.row +
+                                         mOPCenterPixel.row,
+                                 opY / mOPSampleSpacing.col +
+                                         mOPCenterPixel.col);
+}
+
+types::RowCol<double> OutputPlaneProjector::outputToSlant(
+        const types::RowCol<double>& opPixel) const
+{
+    // Convert output plane pixel to ECEF.
+    const scene::Vector3 ecef = mECEFTransform->rowColToECEF(opPixel);
+
+    // Convert ECEF to slant plane distance from SCP.
+    double timeCOA = 0.0;
+    const types::RowCol<double> spXY =
+            mProjectionModel->sceneToImage(ecef, &timeCOA);
+
+    // Convert to slant plane pixel.
+    return (spXY / mSPSampleSpacing + mSPOffset);
+}
+
+void OutputPlaneProjector::project(ProjectFunc func,
+                                   const types::RowCol<double>* input,
+                                   size_t numPixels,
+                                   types::RowCol<double>* output,
+                                   size_t numThreads) const
+{
+    if (numThreads == 0)
+    {
+        numThreads = sys::OS().getNumCPUsAvailable();
+    }
+
+    if (numThreads <= 1)
+    {
+        ProjectPixelsRunnable<ProjectFunc>(
+                *this, func, input, numPixels, output).run();
+    }
+    else
+    {
+        mt::ThreadGroup threads;
+        const mt::ThreadPlanner planner(numPixels, numThreads);
+
+        size_t threadNum(0);
+        size_t startPixel(0);
+        size_t numPixelsThisThread(0);
+        while (planner.getThreadInfo(threadNum++,
+                                     startPixel,
+                                     numPixelsThisThread))
+        {
+            std::auto_ptr<sys::Runnable> projector(
+                    new ProjectPixelsRunnable<ProjectFunc>(
+                            *this,
+                            func,
+                            input + startPixel,
+                            numPixelsThisThread,
+                            output + startPixel));
+            threads.createThread(projector);
+        }
+
+        threads.joinAll();
+    }
+}
+
+void OutputPlaneProjector::projectToOutputPlane(
+        const types::RowCol<double>* spPixels,
+        size_t numPixels,
+        types::RowCol<double>* opPixels,
+        size_t numThreads) const
+{
+    project(&OutputPlaneProjector::slantToOutput,
+            spPixels, numPixels, opPixels, numThreads);
+}
+
+void OutputPlaneProjector::projectToOutputPlane(
+        const std::vector<types::RowCol<double> >& spPixels,
+        std::vector<types::RowCol<double> >& opPixels,
+        size_t numThreads) const
+{
+    opPixels.resize(spPixels.size());
+    if (!spPixels.empty())
+    {
+        projectToOutputPlane(&spPixels[0], spPixels.size(), &opPixels[0],
+                             numThreads);
+    }
+}
+
+void OutputPlaneProjector::projectToSlantPlane(
+        const types::RowCol<double>* opPixels,
+        size_t numPixels,
+        types::RowCol<double>* spPixels,
+        size_t numThreads) const
+{
+    project(&OutputPlaneProjector::outputToSlant,
+            opPixels, numPixels, spPixels, numThreads);
+}
+
+void OutputPlaneProjector::projectToSlantPlane(
+        const std::vector<types::RowCol<double> >& opPixels,
+        std::vector<types::RowCol<double> >& spPixels,
+        size_t numThreads) const
+{
+    spPixels.resize(opPixels.size());
+    if (!opPixels.empty())
+    {
+        projectToSlantPlane(&opPixels[0], opPixels.size(), &spPixels[0],
+                            numThreads);
+    }
+}
+}
+}
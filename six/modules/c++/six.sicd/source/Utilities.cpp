@@ -19,6 +19,7 @@
  * see <http://www.gnu.org/licenses/>.
  *
  */
+#include <algorithm>
 #include <map>
 
 #include <except/Exception.h>
@@ -26,9 +27,12 @@
 #include <math/Utilities.h>
 #include <math/poly/Fit.h>
 #include <mem/ScopedAlignedArray.h>
+#include <scene/ECEFToLLATransform.h>
+#include <scene/TerrainProjector.h>
 #include <six/NITFReadControl.h>
 #include <six/Utilities.h>
 #include <six/sicd/ComplexXMLControl.h>
+#include <six/sicd/OutputPlaneProjector.h>
 #include <six/sicd/SICDMesh.h>
 #include <six/sicd/Utilities.h>
 #include <str/Manip.h>
@@ -1139,49 +1143,11 @@ void Utilities::fitXYProjectionPolys(
 void Utilities::projectPixelsToOutputPlane(
         const six::sicd::ComplexData& complexData,
         const std::vector<types::RowCol<double>>& spPixels,
-        std::vector<types::RowCol<double>>& opPixels)
+        std::vector<types::RowCol<double>>& opPixels,
+        size_t numThreads)
 {
-    std::auto_ptr<scene::SceneGeometry> geometry;
-    std::auto_ptr<scene::ProjectionModel> projectionModel;
-    AreaPlane areaPlane;
-
-    Utilities::getModelComponents(complexData,
-                                  geometry,
-                                  projectionModel,
-                                  areaPlane);
-
-    const types::RowCol<double> opSampleSpacing(areaPlane.xDirection->spacing,
-                                                areaPlane.yDirection->spacing);
-
-    const types::RowCol<double> opCenterPixel(
-            static_cast<double>(areaPlane.xDirection->elements / 2 + 1),
-            static_cast<double>(areaPlane.yDirection->elements / 2 + 1));
-
-    const six::Vector3 opORPECEF = areaPlane.referencePoint.ecef;
-    const six::Vector3 opZ = Utilities::getGroundPlaneNormal(complexData);
-
-    // Project slant plane pixels to output plane pixels.
-    opPixels.resize(spPixels.size());
-    for (size_t ii = 0; ii < spPixels.size(); ++ii)
-    {
-        const types::RowCol<double> spXY(
-                complexData.pixelToImagePoint(spPixels[ii]));
-
-        // Convert to output plane ECEF.
-        const six::Vector3 opECEF =
-                projectionModel->imageToScene(spXY, opORPECEF, opZ);
-
-        // Convert ECEF to output distance to the output plane ORP.
-        const six::Vector3 diffECEF = opECEF - opORPECEF;
-        const double opX = diffECEF.dot(areaPlane.xDirection->unitVector);
-        const double opY = diffECEF.dot(areaPlane.yDirection->unitVector);
-
-        // Convert XY to pixels.
-        opPixels[ii] = types::RowCol<double>(opX / opSampleSpacing.row +
-                                                     opCenterPixel.row,
-                                             opY / opSampleSpacing.col +
-                                                     opCenterPixel.col);
-    }
+    const OutputPlaneProjector projector(complexData);
+    projector.projectToOutputPlane(spPixels, opPixels, numThreads);
 }
 
 void Utilities::projectValidDataPolygonToOutputPlane(
@@ -1218,50 +1184,93 @@ void Utilities::projectValidDataPolygonToOutputPlane(
 void Utilities::projectPixelsToSlantPlane(
         const six::sicd::ComplexData& complexData,
         const std::vector<types::RowCol<double>>& opPixels,
-        std::vector<types::RowCol<double>>& spPixels)
+        std::vector<types::RowCol<double>>& spPixels,
+        size_t numThreads)
 {
-    std::auto_ptr<scene::SceneGeometry> geometry;
-    std::auto_ptr<scene::ProjectionModel> projectionModel;
-    AreaPlane areaPlane;
+    const OutputPlaneProjector projector(complexData);
+    projector.projectToSlantPlane(opPixels, spPixels, numThreads);
+}
 
-    Utilities::getModelComponents(complexData,
-                                  geometry,
-                                  projectionModel,
-                                  areaPlane);
+void Utilities::projectPixelsToTerrain(
+        const six::sicd::ComplexData& complexData,
+        const scene::DEMTileCache& dem,
+        const std::vector<types::RowCol<double> >& spPixels,
+        std::vector<scene::Vector3>& scenePoints,
+        size_t numThreads)
+{
+    std::auto_ptr<scene::SceneGeometry> geometry(
+            getSceneGeometry(&complexData));
+    std::auto_ptr<scene::ProjectionModel> projectionModel(
+            getProjectionModel(&complexData, geometry.get()));
 
-    const types::RowCol<double> opSampleSpacing(areaPlane.xDirection->spacing,
-                                                areaPlane.yDirection->spacing);
-    const scene::PlanarGridECEFTransform ecefTransform(
-            opSampleSpacing,
-            areaPlane.referencePoint.rowCol,
-            areaPlane.xDirection->unitVector,
-            areaPlane.yDirection->unitVector,
-            areaPlane.referencePoint.ecef);
-    const types::RowCol<double> spSampleSpacing(
-            complexData.grid->row->sampleSpacing,
-            complexData.grid->col->sampleSpacing);
-    const types::RowCol<double> spOrigOffset(
-            static_cast<double>(complexData.imageData->firstRow),
-            static_cast<double>(complexData.imageData->firstCol));
-    const types::RowCol<double> spSCP(complexData.imageData->scpPixel);
-    const types::RowCol<double> spOffset(spSCP.row - spOrigOffset.row,
-                                         spSCP.col - spOrigOffset.col);
-
-    // Project output plane pixels to slant plane pixels.
-    spPixels.resize(opPixels.size());
-    for (size_t ii = 0; ii < opPixels.size(); ++ii)
+    std::vector<types::RowCol<double> > imagePoints(spPixels.size());
+    for (size_t ii = 0; ii < spPixels.size(); ++ii)
+    {
+        imagePoints[ii] = complexData.pixelToImagePoint(spPixels[ii]);
+    }
+
+    const scene::TerrainProjector projector(*projectionModel, dem);
+    projector.imageToScene(imagePoints, scenePoints, numThreads);
+}
+
+types::RowCol<size_t> Utilities::getTerrainOrthoGrid(
+        const six::sicd::ComplexData& complexData,
+        const scene::DEMTileCache& dem,
+        const types::RowCol<size_t>& gridSpacing,
+        std::vector<scene::LatLonAlt>& grid,
+        size_t numThreads)
+{
+    if (gridSpacing.row == 0 || gridSpacing.col == 0)
+    {
+        throw except::Exception(Ctxt("Grid spacing must be positive"));
+    }
+
+    const types::RowCol<size_t> imageDims(complexData.getNumRows(),
+                                          complexData.getNumCols());
+    if (imageDims.row == 0 || imageDims.col == 0)
     {
-        // Convert output plane pixel to ECEF.
-        const scene::Vector3 ecef = ecefTransform.rowColToECEF(opPixels[ii]);
+        throw except::Exception(Ctxt("SICD has no pixels"));
+    }
 
-        // Convert ECEF to slant plane distance from SCP.
-        double timeCOA = 0.0;
-        const types::RowCol<double> spXY =
-                projectionModel->sceneToImage(ecef, &timeCOA);
+    // Sample every gridSpacing pixels, always including the last row/col
+    const types::RowCol<size_t> gridDims(
+            (imageDims.row - 1 + gridSpacing.row - 1) / gridSpacing.row + 1,
+            (imageDims.col - 1 + gridSpacing.col - 1) / gridSpacing.col + 1);
 
-        // Convert to slant plane pixel.
-        spPixels[ii] = (spXY / spSampleSpacing + spOffset);
+    // Walk the grid in a serpentine so consecutive samples (which seed
+    // each other's starting height) are always neighbors
+    std::vector<types::RowCol<double> > spPixels;
+    spPixels.reserve(gridDims.area());
+    for (size_t row = 0; row < gridDims.row; ++row)
+    {
+        const double spRow = static_cast<double>(
+                std::min(row * gridSpacing.row, imageDims.row - 1));
+        for (size_t ii = 0; ii < gridDims.col; ++ii)
+        {
+            const size_t col = (row % 2 == 0) ? ii : gridDims.col - 1 - ii;
+            const double spCol = static_cast<double>(
+                    std::min(col * gridSpacing.col, imageDims.col - 1));
+            spPixels.push_back(types::RowCol<double>(spRow, spCol));
+        }
     }
+
+    std::vector<scene::Vector3> scenePoints;
+    projectPixelsToTerrain(complexData, dem, spPixels, scenePoints,
+                           numThreads);
+
+    const scene::ECEFToLLATransform ecefToLatLon;
+    grid.resize(gridDims.area());
+    for (size_t row = 0, idx = 0; row < gridDims.row; ++row)
+    {
+        for (size_t ii = 0; ii < gridDims.col; ++ii, ++idx)
+        {
+            const size_t col = (row % 2 == 0) ? ii : gridDims.col - 1 - ii;
+            grid[row * gridDims.col + col] =
+                    ecefToLatLon.transform(scenePoints[idx]);
+        }
+    }
+
+    return gridDims;
 }
 }
 }
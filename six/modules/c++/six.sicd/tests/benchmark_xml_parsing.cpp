@@ -0,0 +1,151 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Times SICD metadata deserialization, split into building the DOM and
+ * converting the DOM into ComplexData, so changes to either half can be
+ * measured.  Typical usage is to run it over the sample XMLs:
+ *
+ *   benchmark_xml_parsing six.sicd/tests/sample_xml/sicd*.xml
+ *
+ * Schema validation still runs if SIX_SCHEMA_PATH is set; unset it to time
+ * deserialization alone.
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <import/cli.h>
+#include <import/io.h>
+#include <import/six.h>
+#include <import/six/sicd.h>
+#include <logging/NullLogger.h>
+#include <sys/StopWatch.h>
+#include <xml/lite/MinidomParser.h>
+
+namespace
+{
+std::string readFile(const std::string& pathname)
+{
+    io::FileInputStream inStream(pathname);
+    io::StringStream stringStream;
+    inStream.streamTo(stringStream);
+    return stringStream.stream().str();
+}
+
+std::auto_ptr<xml::lite::Document> parse(const std::string& xml)
+{
+    io::StringStream xmlStream;
+    xmlStream.write(xml.c_str(), xml.length());
+    xml::lite::MinidomParser parser;
+    parser.preserveCharacterData(true);
+    parser.parse(xmlStream);
+
+    std::auto_ptr<xml::lite::Document> doc(parser.getDocument(true));
+    return doc;
+}
+
+void benchmark(const std::string& pathname, size_t numIterations)
+{
+    const std::string xml = readFile(pathname);
+    const std::vector<std::string> schemaPaths;
+    logging::NullLogger log;
+
+    // The stop watch only has millisecond resolution, so time each half
+    // over all iterations rather than accumulating per-iteration times
+    sys::RealTimeStopWatch parseWatch;
+    parseWatch.start();
+    for (size_t ii = 0; ii < numIterations; ++ii)
+    {
+        parse(xml);
+    }
+    const double parseMs = parseWatch.stop() / numIterations;
+
+    const std::auto_ptr<xml::lite::Document> doc(parse(xml));
+    sys::RealTimeStopWatch convertWatch;
+    convertWatch.start();
+    for (size_t ii = 0; ii < numIterations; ++ii)
+    {
+        six::sicd::ComplexXMLControl control(&log);
+        const std::auto_ptr<six::Data> data(
+                control.fromXML(doc.get(), schemaPaths));
+    }
+    const double convertMs = convertWatch.stop() / numIterations;
+
+    std::cout << std::setw(40) << std::left << sys::Path::basename(pathname)
+              << std::right << std::fixed << std::setprecision(4)
+              << std::setw(12) << parseMs
+              << std::setw(12) << convertMs
+              << std::setw(12) << parseMs + convertMs << std::endl;
+}
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        cli::ArgumentParser parser;
+        parser.setDescription(
+            "Times parsing SICD XML into a DOM and converting the DOM "
+            "into ComplexData.");
+        parser.addArgument("-n --iterations", "Number of times to parse each "
+                           "file", cli::STORE, "iterations", "INT",
+                           1, 1, false)->setDefault(1000);
+        parser.addArgument("xml", "SICD XML files", cli::STORE, "xml",
+                           "XML", 1);
+
+        const std::auto_ptr<cli::Results> options(parser.parse(argc, argv));
+        const size_t numIterations = options->get<size_t>("iterations");
+        const cli::Value* const xmlFiles = options->getValue("xml");
+
+        std::cout << std::setw(40) << std::left << "File (ms per parse)"
+                  << std::right
+                  << std::setw(12) << "DOM"
+                  << std::setw(12) << "Convert"
+                  << std::setw(12) << "Total" << std::endl;
+
+        for (size_t ii = 0; ii < xmlFiles->size(); ++ii)
+        {
+            benchmark(xmlFiles->get<std::string>(ii), numIterations);
+        }
+
+        return 0;
+    }
+    catch (const except::Exception& e)
+    {
+        std::cerr << e.getMessage() << std::endl;
+        return 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    catch (...)
+    {
+        std::cerr << "Unknown exception" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,87 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_SICD_TEST_UTILITIES_H__
+#define __SIX_SICD_TEST_UTILITIES_H__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <except/Exception.h>
+#include <sys/OS.h>
+#include <sys/Path.h>
+#include <six/sicd/ComplexData.h>
+#include <six/sicd/Utilities.h>
+
+// Helpers shared by the six.sicd unit tests for finding the sample data
+namespace test
+{
+/*!
+ * \param exePath Path to the test executable
+ * \return The first directory above exePath that holds croppedNitfs, or ""
+ * if there isn't one
+ */
+inline std::string findSixHome(const sys::Path& exePath)
+{
+    sys::Path sixHome = exePath.join("..");
+    do
+    {
+        const sys::Path croppedNitfs = sixHome.join("croppedNitfs");
+        if (sys::OS().isDirectory(croppedNitfs.getAbsolutePath()))
+        {
+            return sixHome;
+        }
+        sixHome = sixHome.join("..");
+    } while (sixHome.getAbsolutePath() != sixHome.join("..").getAbsolutePath());
+    return "";
+}
+
+/*!
+ * \param exePath Path to the test executable
+ * \return Path to the SICD sample most tests run against
+ * \throws except::Exception if the source tree root can't be found
+ */
+inline std::string getSampleSICDPathname(const sys::Path& exePath)
+{
+    const std::string sixHome = findSixHome(exePath);
+    if (sixHome.empty())
+    {
+        throw except::Exception(Ctxt(
+                "Environment error: Cannot determine source tree root"));
+    }
+
+    return sys::Path(sixHome).
+        join("croppedNitfs").
+        join("SICD").
+        join("cropped_sicd_110.nitf").getAbsolutePath();
+}
+
+//! Reads the metadata of the sample SICD
+inline std::auto_ptr<six::sicd::ComplexData>
+loadComplexData(const sys::Path& exePath)
+{
+    return six::sicd::Utilities::getComplexData(getSampleSICDPathname(exePath),
+                                                std::vector<std::string>());
+}
+}
+
+#endif
@@ -0,0 +1,224 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "TestCase.h"
+#include "TestUtilities.h"
+#include <io/FileInputStream.h>
+#include <io/TempFile.h>
+#include <sys/OS.h>
+#include <sys/Path.h>
+#include <six/NITFReadControl.h>
+#include <six/XMLControlFactory.h>
+#include <six/sicd/ChipExtractor.h>
+#include <six/sicd/ComplexXMLControl.h>
+#include <six/sicd/CropUtils.h>
+
+namespace
+{
+typedef six::ChipExtractor::Chip Chip;
+
+std::string globalSICDDir;
+
+std::string getPathname(const std::string& filename)
+{
+    return sys::Path(globalSICDDir).join(filename).getAbsolutePath();
+}
+
+std::vector<six::UByte> readChip(six::NITFReadControl& reader,
+                                 const Chip& chip)
+{
+    const size_t numBytesPerPixel =
+            reader.getContainer()->getData(0)->getNumBytesPerPixel();
+    std::vector<six::UByte> buffer(chip.dims.area() * numBytesPerPixel);
+
+    six::Region region;
+    region.setStartRow(chip.offset.row);
+    region.setStartCol(chip.offset.col);
+    region.setNumRows(chip.dims.row);
+    region.setNumCols(chip.dims.col);
+    region.setBuffer(&buffer[0]);
+    reader.interleaved(region, 0);
+    return buffer;
+}
+
+std::vector<Chip> getChips()
+{
+    // Out of order and overlapping
+    std::vector<Chip> chips;
+    chips.push_back(Chip(types::RowCol<size_t>(3, 0),
+                         types::RowCol<size_t>(2, 5)));
+    chips.push_back(Chip(types::RowCol<size_t>(0, 0),
+                         types::RowCol<size_t>(5, 5)));
+    chips.push_back(Chip(types::RowCol<size_t>(1, 3),
+                         types::RowCol<size_t>(1, 1)));
+    chips.push_back(Chip(types::RowCol<size_t>(1, 1),
+                         types::RowCol<size_t>(3, 2)));
+    chips.push_back(Chip(types::RowCol<size_t>(4, 2),
+                         types::RowCol<size_t>(1, 3)));
+    return chips;
+}
+
+TEST_CASE(testExtractToMemory)
+{
+    six::NITFReadControl reader;
+    reader.load(getPathname("cropped_sicd_110.nitf"),
+                std::vector<std::string>());
+    const std::vector<Chip> chips = getChips();
+
+    // From a row at a time up to everything at once
+    const size_t blockSizes[] = { 1, 100, 250,
+                                  six::ChipExtractor::DEFAULT_BLOCK_SIZE };
+    for (size_t ii = 0; ii < 4; ++ii)
+    {
+        for (size_t numThreads = 1; numThreads <= 3; numThreads += 2)
+        {
+            const six::sicd::ChipExtractor extractor(reader, numThreads,
+                                                     blockSizes[ii]);
+            std::vector<std::vector<six::UByte> > buffers;
+            extractor.extract(chips, buffers);
+            TEST_ASSERT_EQ(buffers.size(), chips.size());
+            for (size_t jj = 0; jj < chips.size(); ++jj)
+            {
+                TEST_ASSERT(buffers[jj] == readChip(reader, chips[jj]));
+            }
+        }
+    }
+}
+
+TEST_CASE(testExtractToFiles)
+{
+    const std::vector<std::string> schemaPaths;
+    six::NITFReadControl reader;
+    reader.load(getPathname("cropped_sicd_110.nitf"), schemaPaths);
+    const std::vector<Chip> chips = getChips();
+
+    std::vector<mem::SharedPtr<io::TempFile> > files;
+    std::vector<std::string> pathnames;
+    for (size_t ii = 0; ii < chips.size(); ++ii)
+    {
+        files.push_back(mem::SharedPtr<io::TempFile>(new io::TempFile()));
+        pathnames.push_back(files.back()->pathname());
+    }
+
+    const six::sicd::ChipExtractor extractor(reader, 0, 100);
+    extractor.extract(chips, pathnames, schemaPaths);
+
+    // Same as cropping each chip on its own
+    for (size_t ii = 0; ii < chips.size(); ++ii)
+    {
+        const io::TempFile cropped;
+        six::sicd::cropSICD(reader, schemaPaths, chips[ii].offset,
+                            chips[ii].dims, cropped.pathname());
+
+        six::NITFReadControl chipReader;
+        chipReader.load(pathnames[ii], schemaPaths);
+        six::NITFReadControl croppedReader;
+        croppedReader.load(cropped.pathname(), schemaPaths);
+
+        TEST_ASSERT(*chipReader.getContainer()->getData(0) ==
+                    *croppedReader.getContainer()->getData(0));
+        const Chip wholeChip(types::RowCol<size_t>(0, 0), chips[ii].dims);
+        TEST_ASSERT(readChip(chipReader, wholeChip) ==
+                    readChip(reader, chips[ii]));
+    }
+}
+
+TEST_CASE(testExtractFromStream)
+{
+    // Without a pathname, raw pixels are read through the reader's stream
+    const std::string pathname = getPathname("cropped_sicd_110.nitf");
+    io::FileInputStream stream(pathname);
+    six::NITFReadControl streamReader;
+    streamReader.load(stream, std::vector<std::string>());
+    TEST_ASSERT(streamReader.getPathname().empty());
+
+    six::NITFReadControl reader;
+    reader.load(pathname, std::vector<std::string>());
+    TEST_ASSERT_EQ(reader.getPathname(), pathname);
+
+    const std::vector<Chip> chips = getChips();
+    const six::sicd::ChipExtractor extractor(streamReader, 1, 100);
+    std::vector<std::vector<six::UByte> > buffers;
+    extractor.extract(chips, buffers);
+    for (size_t ii = 0; ii < chips.size(); ++ii)
+    {
+        TEST_ASSERT(buffers[ii] == readChip(reader, chips[ii]));
+    }
+}
+
+TEST_CASE(testBadChips)
+{
+    const std::vector<std::string> schemaPaths;
+    six::NITFReadControl reader;
+    reader.load(getPathname("cropped_sicd_110.nitf"), schemaPaths);
+    const six::sicd::ChipExtractor extractor(reader);
+
+    std::vector<Chip> chips = getChips();
+    std::vector<std::vector<six::UByte> > buffers;
+    const io::TempFile file;
+    TEST_EXCEPTION(extractor.extract(
+            chips, std::vector<std::string>(1, file.pathname()),
+            schemaPaths));
+
+    chips.push_back(Chip(types::RowCol<size_t>(4, 4),
+                         types::RowCol<size_t>(1, 2)));
+    TEST_EXCEPTION(extractor.extract(chips, buffers));
+
+    chips.back().dims.col = 0;
+    TEST_EXCEPTION(extractor.extract(chips, buffers));
+
+    // Nothing's read if any chip is bad
+    TEST_ASSERT(buffers.empty());
+}
+}
+
+int main(int argc, char** argv)
+{
+    if (argc == 0)
+    {
+        std::cerr << "This test makes assumptions about the directory structure."
+            << " Make sure to call with the executable name as argv[0] so "
+            << " we can find the necessary files.\n";
+        return 1;
+    }
+
+    const std::string sixHome = test::findSixHome(sys::Path(argv[0]));
+    if (sixHome.empty())
+    {
+        std::cerr << "Environment error: Cannot determine source tree root\n";
+        return 1;
+    }
+    globalSICDDir = sys::Path(sixHome).join("croppedNitfs").join("SICD");
+
+    six::XMLControlFactory::getInstance().addCreator(
+            six::DataType::COMPLEX,
+            new six::XMLControlCreatorT<six::sicd::ComplexXMLControl>());
+
+    TEST_CHECK(testExtractToMemory);
+    TEST_CHECK(testExtractToFiles);
+    TEST_CHECK(testExtractFromStream);
+    TEST_CHECK(testBadChips);
+    return 0;
+}
@@ -0,0 +1,231 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "TestCase.h"
+#include "TestUtilities.h"
+#include <io/TempFile.h>
+#include <sys/OS.h>
+#include <sys/Path.h>
+#include <six/NITFReadControl.h>
+#include <six/NITFWriteControl.h>
+#include <six/XMLControlFactory.h>
+#include <six/sicd/ComplexXMLControl.h>
+#include <six/sicd/CropUtils.h>
+
+namespace
+{
+std::string globalSICDDir;
+
+std::string getPathname(const std::string& filename)
+{
+    return sys::Path(globalSICDDir).join(filename).getAbsolutePath();
+}
+
+std::vector<six::UByte> readAOI(six::NITFReadControl& reader,
+                                const types::RowCol<size_t>& aoiOffset,
+                                const types::RowCol<size_t>& aoiDims)
+{
+    const size_t numBytesPerPixel =
+            reader.getContainer()->getData(0)->getNumBytesPerPixel();
+    std::vector<six::UByte> buffer(aoiDims.area() * numBytesPerPixel);
+
+    six::Region region;
+    region.setStartRow(aoiOffset.row);
+    region.setStartCol(aoiOffset.col);
+    region.setNumRows(aoiDims.row);
+    region.setNumCols(aoiDims.col);
+    region.setBuffer(&buffer[0]);
+    reader.interleaved(region, 0);
+    return buffer;
+}
+
+bool cropMatches(six::NITFReadControl& origReader,
+                 const types::RowCol<size_t>& aoiOffset,
+                 const types::RowCol<size_t>& aoiDims,
+                 const std::string& cropPathname)
+{
+    six::NITFReadControl cropReader;
+    cropReader.load(cropPathname, std::vector<std::string>());
+    const six::Data& cropData = *cropReader.getContainer()->getData(0);
+    if (cropData.getNumRows() != aoiDims.row ||
+        cropData.getNumCols() != aoiDims.col)
+    {
+        return false;
+    }
+
+    return readAOI(cropReader, types::RowCol<size_t>(0, 0), aoiDims) ==
+            readAOI(origReader, aoiOffset, aoiDims);
+}
+
+// Rewrites the SICD with each image segment holding a couple of rows
+void writeSegmented(six::NITFReadControl& reader,
+                    const std::string& pathname)
+{
+    const six::Data& data = *reader.getContainer()->getData(0);
+    const types::RowCol<size_t> dims(data.getNumRows(), data.getNumCols());
+    std::vector<six::UByte> image =
+            readAOI(reader, types::RowCol<size_t>(0, 0), dims);
+
+    mem::SharedPtr<six::Container> container(new six::Container(
+            six::DataType::COMPLEX));
+    container->addData(data.clone());
+    six::Options options;
+    options.setParameter(six::NITFHeaderCreator::OPT_MAX_PRODUCT_SIZE,
+                         2 * dims.col * data.getNumBytesPerPixel() + 1);
+    six::NITFWriteControl writer(options, container);
+    six::BufferList buffers(1, &image[0]);
+    writer.save(buffers, pathname, std::vector<std::string>());
+}
+
+TEST_CASE(testCropAOI)
+{
+    const std::vector<std::string> schemaPaths;
+    six::NITFReadControl reader;
+    reader.load(getPathname("cropped_sicd_110.nitf"), schemaPaths);
+
+    // A tiny block size so the AOI is streamed a row at a time
+    const six::sicd::SICDCropper cropper(reader, schemaPaths, 1);
+    const io::TempFile output;
+
+    const types::RowCol<size_t> aoiOffset(1, 2);
+    const types::RowCol<size_t> aoiDims(3, 2);
+    cropper.crop(aoiOffset, aoiDims, output.pathname());
+    TEST_ASSERT(cropMatches(reader, aoiOffset, aoiDims,
+                            output.pathname()));
+
+    six::NITFReadControl cropReader;
+    cropReader.load(output.pathname(), schemaPaths);
+    const six::sicd::ComplexData& cropData =
+            *reinterpret_cast<const six::sicd::ComplexData*>(
+                    cropReader.getContainer()->getData(0));
+    TEST_ASSERT_EQ(cropData.imageData->firstRow,
+                   cropper.getData().imageData->firstRow + aoiOffset.row);
+    TEST_ASSERT_EQ(cropData.imageData->firstCol,
+                   cropper.getData().imageData->firstCol + aoiOffset.col);
+
+    // Whole rows are read together
+    const types::RowCol<size_t> fullWidthOffset(2, 0);
+    const types::RowCol<size_t> fullWidthDims(
+            3, cropper.getData().getNumCols());
+    const six::sicd::SICDCropper bigBlockCropper(reader, schemaPaths);
+    bigBlockCropper.crop(fullWidthOffset, fullWidthDims,
+                         output.pathname());
+    TEST_ASSERT(cropMatches(reader, fullWidthOffset, fullWidthDims,
+                            output.pathname()));
+}
+
+TEST_CASE(testCropSegmented)
+{
+    const std::vector<std::string> schemaPaths;
+    six::NITFReadControl origReader;
+    origReader.load(getPathname("cropped_sicd_110.nitf"), schemaPaths);
+    const io::TempFile segmented;
+    writeSegmented(origReader, segmented.pathname());
+
+    six::NITFReadControl reader;
+    reader.load(segmented.pathname(), schemaPaths);
+    TEST_ASSERT(reader.getInfos()[0]->getImageSegments().size() > 1);
+
+    const io::TempFile output;
+    const types::RowCol<size_t> aoiOffset(1, 1);
+    const types::RowCol<size_t> aoiDims(4, 3);
+    for (size_t blockSize = 1; blockSize < 200; blockSize *= 3)
+    {
+        six::sicd::SICDCropper(reader, schemaPaths, blockSize).crop(
+                aoiOffset, aoiDims, output.pathname());
+        TEST_ASSERT(cropMatches(origReader, aoiOffset, aoiDims,
+                                output.pathname()));
+    }
+}
+
+TEST_CASE(testCropMany)
+{
+    const std::vector<std::string> schemaPaths;
+    six::NITFReadControl reader;
+    reader.load(getPathname("cropped_sicd_110.nitf"), schemaPaths);
+    const six::sicd::SICDCropper cropper(reader, schemaPaths);
+
+    std::vector<types::RowCol<size_t> > aoiOffsets;
+    std::vector<types::RowCol<size_t> > aoiDims;
+    const io::TempFile first;
+    const io::TempFile second;
+    std::vector<std::string> pathnames;
+    aoiOffsets.push_back(types::RowCol<size_t>(0, 0));
+    aoiDims.push_back(types::RowCol<size_t>(2, 2));
+    pathnames.push_back(first.pathname());
+    aoiOffsets.push_back(types::RowCol<size_t>(3, 1));
+    aoiDims.push_back(types::RowCol<size_t>(2, 4));
+    pathnames.push_back(second.pathname());
+    cropper.crop(aoiOffsets, aoiDims, pathnames);
+    for (size_t ii = 0; ii < pathnames.size(); ++ii)
+    {
+        TEST_ASSERT(cropMatches(reader, aoiOffsets[ii], aoiDims[ii],
+                                pathnames[ii]));
+    }
+
+    // Nothing's written if any AOI is bad
+    const io::TempFile third;
+    aoiOffsets.push_back(types::RowCol<size_t>(4, 4));
+    aoiDims.push_back(types::RowCol<size_t>(2, 1));
+    pathnames[0] = third.pathname();
+    pathnames.push_back(third.pathname());
+    TEST_EXCEPTION(cropper.crop(aoiOffsets, aoiDims, pathnames));
+    TEST_ASSERT_EQ(sys::OS().getSize(third.pathname()), 0);
+
+    pathnames.pop_back();
+    TEST_EXCEPTION(cropper.crop(aoiOffsets, aoiDims, pathnames));
+    TEST_EXCEPTION(cropper.crop(types::RowCol<size_t>(0, 0),
+                                types::RowCol<size_t>(0, 1),
+                                third.pathname()));
+}
+}
+
+int main(int argc, char** argv)
+{
+    if (argc == 0)
+    {
+        std::cerr << "This test makes assumptions about the directory structure."
+            << " Make sure to call with the executable name as argv[0] so "
+            << " we can find the necessary files.\n";
+        return 1;
+    }
+
+    const std::string sixHome = test::findSixHome(sys::Path(argv[0]));
+    if (sixHome.empty())
+    {
+        std::cerr << "Environment error: Cannot determine source tree root\n";
+        return 1;
+    }
+    globalSICDDir = sys::Path(sixHome).join("croppedNitfs").join("SICD");
+
+    six::XMLControlFactory::getInstance().addCreator(
+            six::DataType::COMPLEX,
+            new six::XMLControlCreatorT<six::sicd::ComplexXMLControl>());
+
+    TEST_CHECK(testCropAOI);
+    TEST_CHECK(testCropSegmented);
+    TEST_CHECK(testCropMany);
+    return 0;
+}
@@ -0,0 +1,168 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "TestCase.h"
+#include "TestUtilities.h"
+#include <six/MetadataExtractor.h>
+#include <six/NITFReadControl.h>
+#include <six/XMLControlFactory.h>
+#include <six/sicd/ComplexXMLControl.h>
+
+namespace
+{
+std::string globalSICDDir;
+
+std::vector<std::string> getPathnames()
+{
+    std::vector<std::string> pathnames;
+    const std::vector<std::string> listing = sys::Path::list(globalSICDDir);
+    for (size_t ii = 0; ii < listing.size(); ++ii)
+    {
+        if (str::endsWith(listing[ii], ".nitf"))
+        {
+            pathnames.push_back(
+                    sys::Path(globalSICDDir).join(listing[ii]).getPath());
+        }
+    }
+    return pathnames;
+}
+
+TEST_CASE(testMatchesLoadMetadata)
+{
+    const std::vector<std::string> pathnames = getPathnames();
+    TEST_ASSERT_FALSE(pathnames.empty());
+
+    const six::NITFMetadataExtractor extractor;
+    const std::vector<const six::MetadataExtractor*> extractors(1,
+                                                                &extractor);
+    std::vector<six::MetadataSummary> summaries;
+    six::extractMetadata(pathnames, extractors, 4, summaries);
+    TEST_ASSERT_EQ(summaries.size(), pathnames.size());
+
+    for (size_t ii = 0; ii < pathnames.size(); ++ii)
+    {
+        const six::MetadataSummary& summary = summaries[ii];
+        TEST_ASSERT_EQ(summary.pathname, pathnames[ii]);
+        TEST_ASSERT(summary.success);
+        TEST_ASSERT(summary.error.empty());
+        TEST_ASSERT_EQ(summary.fileType, "SICD");
+        TEST_ASSERT_EQ(summary.numImages, 1);
+
+        six::NITFReadControl reader;
+        reader.loadMetadata(pathnames[ii], std::vector<std::string>());
+        const six::Data& data = *reader.getContainer()->getData(0);
+        TEST_ASSERT_EQ(summary.version, data.getVersion());
+        TEST_ASSERT_EQ(summary.name, data.getName());
+        TEST_ASSERT_EQ(summary.numRows, data.getNumRows());
+        TEST_ASSERT_EQ(summary.numCols, data.getNumCols());
+        TEST_ASSERT_EQ(summary.pixelType, data.getPixelType().toString());
+        TEST_ASSERT(summary.corners == data.getImageCorners());
+    }
+}
+
+TEST_CASE(testThreadCountDoesNotMatter)
+{
+    const std::vector<std::string> pathnames = getPathnames();
+    const six::NITFMetadataExtractor extractor;
+    const std::vector<const six::MetadataExtractor*> extractors(1,
+                                                                &extractor);
+
+    std::vector<six::MetadataSummary> serial;
+    six::extractMetadata(pathnames, extractors, 1, serial);
+
+    // More threads than files
+    std::vector<six::MetadataSummary> parallel;
+    six::extractMetadata(pathnames, extractors, 2 * pathnames.size(),
+                         parallel);
+
+    std::ostringstream serialCSV;
+    six::writeMetadataCSV(serial, serialCSV);
+    std::ostringstream parallelCSV;
+    six::writeMetadataCSV(parallel, parallelCSV);
+    TEST_ASSERT_EQ(serialCSV.str(), parallelCSV.str());
+}
+
+TEST_CASE(testFailuresAreRecorded)
+{
+    std::vector<std::string> pathnames;
+    pathnames.push_back(sys::Path(globalSICDDir).join("missing.nitf").getPath());
+    pathnames.push_back(getPathnames().front());
+
+    const six::NITFMetadataExtractor extractor;
+    const std::vector<const six::MetadataExtractor*> extractors(1,
+                                                                &extractor);
+    std::vector<six::MetadataSummary> summaries;
+    six::extractMetadata(pathnames, extractors, 2, summaries);
+
+    TEST_ASSERT_FALSE(summaries[0].success);
+    TEST_ASSERT_FALSE(summaries[0].error.empty());
+    TEST_ASSERT(summaries[1].success);
+
+    // Every row has the same number of columns, failed or not
+    std::ostringstream csv;
+    six::writeMetadataCSV(summaries, csv);
+    const std::vector<std::string> lines = str::split(csv.str(), "\n");
+    TEST_ASSERT_EQ(lines.size(), 3);
+    const size_t numColumns = str::split(lines[0], ",").size();
+    TEST_ASSERT_EQ(numColumns, 21);
+    for (size_t ii = 1; ii < lines.size(); ++ii)
+    {
+        TEST_ASSERT_EQ(static_cast<size_t>(std::count(lines[ii].begin(),
+                                                      lines[ii].end(), ',')),
+                       numColumns - 1);
+    }
+}
+}
+
+int main(int argc, char** argv)
+{
+    if (argc == 0)
+    {
+        std::cerr << "This test makes assumptions about the directory structure."
+            << " Make sure to call with the executable name as argv[0] so "
+            << " we can find the necessary files.\n";
+        return 1;
+    }
+
+    const std::string sixHome = test::findSixHome(sys::Path(argv[0]));
+    if (sixHome.empty())
+    {
+        std::cerr << "Environment error: Cannot determine source tree root\n";
+        return 1;
+    }
+    globalSICDDir = sys::Path(sixHome).join("croppedNitfs").join("SICD").
+            getAbsolutePath();
+
+    six::XMLControlFactory::getInstance().addCreator(
+            six::DataType::COMPLEX,
+            new six::XMLControlCreatorT<six::sicd::ComplexXMLControl>());
+
+    TEST_CHECK(testMatchesLoadMetadata);
+    TEST_CHECK(testThreadCountDoesNotMatter);
+    TEST_CHECK(testFailuresAreRecorded);
+    return 0;
+}
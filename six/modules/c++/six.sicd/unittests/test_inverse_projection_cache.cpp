@@ -0,0 +1,148 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "TestCase.h"
+#include "TestUtilities.h"
+#include <scene/InverseProjectionCache.h>
+#include <six/sicd/ComplexData.h>
+#include <six/sicd/Utilities.h>
+
+namespace
+{
+std::auto_ptr<six::sicd::ComplexData> globalData;
+
+struct Models
+{
+    Models()
+    {
+        geometry.reset(six::sicd::Utilities::getSceneGeometry(
+                globalData.get()));
+        model.reset(six::sicd::Utilities::getProjectionModel(
+                globalData.get(), geometry.get()));
+    }
+
+    std::auto_ptr<scene::SceneGeometry> geometry;
+    std::auto_ptr<scene::ProjectionModel> model;
+};
+
+TEST_CASE(testMatchesExact)
+{
+    const Models models;
+    const scene::Vector3 scp = globalData->geoData->scp.ecf;
+    const double tolerance = 1e-3;
+    const scene::InverseProjectionCache cache(*models.model, scp, 500.0,
+                                              -100.0, 100.0, tolerance);
+
+    const scene::InverseProjectionErrors& errors =
+            cache.getErrorStatistics();
+    TEST_ASSERT(errors.numSamples > 0);
+    TEST_ASSERT(errors.maxError <= tolerance);
+    TEST_ASSERT(errors.meanError <= errors.rmsError);
+    TEST_ASSERT(errors.rmsError <= errors.maxError);
+
+    // Spot check points that aren't on the grid or at the cell centers
+    for (double x = -450.0; x <= 450.0; x += 137.0)
+    {
+        for (double h = -90.0; h <= 90.0; h += 61.0)
+        {
+            scene::Vector3 offset;
+            offset[0] = x;
+            offset[1] = -0.7 * x;
+            offset[2] = h;
+            const scene::Vector3 point = scp + offset;
+            if (!cache.contains(point))
+            {
+                continue;
+            }
+
+            double expectedTime;
+            double actualTime;
+            const types::RowCol<double> expected =
+                    models.model->sceneToImage(point, &expectedTime);
+            const types::RowCol<double> actual =
+                    cache.sceneToImage(point, &actualTime);
+            TEST_ASSERT_ALMOST_EQ_EPS(actual.row, expected.row, tolerance);
+            TEST_ASSERT_ALMOST_EQ_EPS(actual.col, expected.col, tolerance);
+            TEST_ASSERT_ALMOST_EQ_EPS(actualTime, expectedTime, 1e-6);
+        }
+    }
+}
+
+TEST_CASE(testFallback)
+{
+    const Models models;
+    const scene::Vector3 scp = globalData->geoData->scp.ecf;
+    const scene::InverseProjectionCache cache(*models.model, scp, 100.0,
+                                              -10.0, 10.0);
+
+    scene::Vector3 offset;
+    offset[0] = 0.0;
+    offset[1] = 0.0;
+    offset[2] = 1000.0;
+    const scene::Vector3 point = scp + offset;
+    TEST_ASSERT(!cache.contains(point));
+    TEST_ASSERT(cache.contains(scp));
+
+    const types::RowCol<double> expected = models.model->sceneToImage(point);
+    const types::RowCol<double> actual = cache.sceneToImage(point);
+    TEST_ASSERT_EQ(actual.row, expected.row);
+    TEST_ASSERT_EQ(actual.col, expected.col);
+}
+
+TEST_CASE(testInvalidArgs)
+{
+    const Models models;
+    const scene::Vector3 scp = globalData->geoData->scp.ecf;
+    TEST_EXCEPTION(scene::InverseProjectionCache(*models.model, scp, 100.0,
+                                                 10.0, 10.0));
+    TEST_EXCEPTION(scene::InverseProjectionCache(*models.model, scp, 0.0,
+                                                 -10.0, 10.0));
+}
+}
+
+int main(int argc, char** argv)
+{
+    if (argc == 0)
+    {
+        std::cerr << "This test makes assumptions about the directory structure."
+            << " Make sure to call with the executable name as argv[0] so "
+            << " we can find the necessary files.\n";
+        return 1;
+    }
+
+    try
+    {
+        globalData = test::loadComplexData(std::string(argv[0]));
+    }
+    catch (const except::Exception& ex)
+    {
+        std::cerr << ex.toString() << "\n";
+        return 1;
+    }
+    TEST_CHECK(testMatchesExact);
+    TEST_CHECK(testFallback);
+    TEST_CHECK(testInvalidArgs);
+    return 0;
+}
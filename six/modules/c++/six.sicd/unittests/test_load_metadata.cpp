@@ -0,0 +1,129 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "TestCase.h"
+#include "TestUtilities.h"
+#include <six/NITFReadControl.h>
+#include <six/XMLControlFactory.h>
+#include <six/sicd/ComplexXMLControl.h>
+
+namespace
+{
+std::string globalSICDDir;
+
+std::string getPathname(const std::string& filename)
+{
+    return sys::Path(globalSICDDir).join(filename).getAbsolutePath();
+}
+
+TEST_CASE(testMatchesFullLoad)
+{
+    const std::string pathname = getPathname("cropped_sicd_110.nitf");
+    const std::vector<std::string> schemaPaths;
+
+    six::NITFReadControl fullReader;
+    fullReader.load(pathname, schemaPaths);
+    TEST_ASSERT_FALSE(fullReader.isMetadataOnly());
+
+    six::NITFReadControl metadataReader;
+    metadataReader.loadMetadata(pathname, schemaPaths);
+    TEST_ASSERT(metadataReader.isMetadataOnly());
+
+    const mem::SharedPtr<six::Container> fullContainer =
+            fullReader.getContainer();
+    const mem::SharedPtr<six::Container> metadataContainer =
+            metadataReader.getContainer();
+    TEST_ASSERT_EQ(metadataContainer->getDataType(),
+                   six::DataType::COMPLEX);
+    TEST_ASSERT_EQ(metadataContainer->getNumData(), 1);
+    TEST_ASSERT(*metadataContainer->getData(0) == *fullContainer->getData(0));
+}
+
+TEST_CASE(testSkipsOtherDES)
+{
+    const std::string pathname = getPathname("cropped_sicd_extra_des.nitf");
+    const std::vector<std::string> schemaPaths;
+
+    six::NITFReadControl fullReader;
+    fullReader.load(pathname, schemaPaths);
+    TEST_ASSERT_FALSE(fullReader.getContainer()->getDESSources().empty());
+
+    six::NITFReadControl metadataReader;
+    metadataReader.loadMetadata(pathname, schemaPaths);
+    TEST_ASSERT(metadataReader.getContainer()->getDESSources().empty());
+    TEST_ASSERT_EQ(metadataReader.getContainer()->getNumData(), 1);
+}
+
+TEST_CASE(testNoPixelAccess)
+{
+    const std::string pathname = getPathname("cropped_sicd_110.nitf");
+    const std::vector<std::string> schemaPaths;
+
+    six::NITFReadControl reader;
+    reader.loadMetadata(pathname, schemaPaths);
+
+    six::Region region;
+    TEST_EXCEPTION(reader.interleaved(region, 0));
+
+    // A full load afterwards makes the pixels available again
+    reader.load(pathname, schemaPaths);
+    TEST_ASSERT_FALSE(reader.isMetadataOnly());
+
+    region.setNumRows(1);
+    region.setNumCols(1);
+    std::vector<six::UByte> buffer(
+            reader.getContainer()->getData(0)->getNumBytesPerPixel());
+    region.setBuffer(&buffer[0]);
+    reader.interleaved(region, 0);
+}
+}
+
+int main(int argc, char** argv)
+{
+    if (argc == 0)
+    {
+        std::cerr << "This test makes assumptions about the directory structure."
+            << " Make sure to call with the executable name as argv[0] so "
+            << " we can find the necessary files.\n";
+        return 1;
+    }
+
+    const std::string sixHome = test::findSixHome(sys::Path(argv[0]));
+    if (sixHome.empty())
+    {
+        std::cerr << "Environment error: Cannot determine source tree root\n";
+        return 1;
+    }
+    globalSICDDir = sys::Path(sixHome).join("croppedNitfs").join("SICD");
+
+    six::XMLControlFactory::getInstance().addCreator(
+            six::DataType::COMPLEX,
+            new six::XMLControlCreatorT<six::sicd::ComplexXMLControl>());
+
+    TEST_CHECK(testMatchesFullLoad);
+    TEST_CHECK(testSkipsOtherDES);
+    TEST_CHECK(testNoPixelAccess);
+    return 0;
+}
@@ -0,0 +1,127 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "TestCase.h"
+#include "TestUtilities.h"
+#include <six/sicd/ComplexData.h>
+#include <six/sicd/OutputPlaneProjector.h>
+#include <six/sicd/Utilities.h>
+
+namespace
+{
+std::auto_ptr<six::sicd::ComplexData> globalData;
+
+std::vector<types::RowCol<double> >
+getTestPixels(const six::sicd::ComplexData& data)
+{
+    const size_t numRows = data.getNumRows();
+    const size_t numCols = data.getNumCols();
+    const size_t stride = 7;
+
+    std::vector<types::RowCol<double> > pixels;
+    for (size_t row = 0; row < numRows; row += stride)
+    {
+        for (size_t col = 0; col < numCols; col += stride)
+        {
+            pixels.push_back(types::RowCol<double>(row, col));
+        }
+    }
+    return pixels;
+}
+
+TEST_CASE(testBatchMatchesSerial)
+{
+    const six::sicd::OutputPlaneProjector projector(*globalData);
+    const std::vector<types::RowCol<double> > spPixels =
+            getTestPixels(*globalData);
+
+    std::vector<types::RowCol<double> > opPixels;
+    projector.projectToOutputPlane(spPixels, opPixels, 3);
+    TEST_ASSERT_EQ(opPixels.size(), spPixels.size());
+
+    std::vector<types::RowCol<double> > expected;
+    six::sicd::Utilities::projectPixelsToOutputPlane(*globalData, spPixels,
+                                                     expected);
+    for (size_t ii = 0; ii < spPixels.size(); ++ii)
+    {
+        TEST_ASSERT_EQ(opPixels[ii].row, expected[ii].row);
+        TEST_ASSERT_EQ(opPixels[ii].col, expected[ii].col);
+    }
+}
+
+TEST_CASE(testSlantPlaneBatchMatchesSerial)
+{
+    const six::sicd::OutputPlaneProjector projector(*globalData);
+    const std::vector<types::RowCol<double> > opPixels =
+            getTestPixels(*globalData);
+
+    std::vector<types::RowCol<double> > spPixels;
+    projector.projectToSlantPlane(opPixels, spPixels, 0);
+    TEST_ASSERT_EQ(spPixels.size(), opPixels.size());
+
+    std::vector<types::RowCol<double> > expected;
+    six::sicd::Utilities::projectPixelsToSlantPlane(*globalData, opPixels,
+                                                    expected);
+    for (size_t ii = 0; ii < opPixels.size(); ++ii)
+    {
+        TEST_ASSERT_EQ(spPixels[ii].row, expected[ii].row);
+        TEST_ASSERT_EQ(spPixels[ii].col, expected[ii].col);
+    }
+}
+
+TEST_CASE(testEmpty)
+{
+    const six::sicd::OutputPlaneProjector projector(*globalData);
+    std::vector<types::RowCol<double> > opPixels(3);
+    projector.projectToOutputPlane(std::vector<types::RowCol<double> >(),
+                                   opPixels);
+    TEST_ASSERT(opPixels.empty());
+}
+}
+
+int main(int argc, char** argv)
+{
+    if (argc == 0)
+    {
+        std::cerr << "This test makes assumptions about the directory structure."
+            << " Make sure to call with the executable name as argv[0] so "
+            << " we can find the necessary files.\n";
+        return 1;
+    }
+
+    try
+    {
+        globalData = test::loadComplexData(std::string(argv[0]));
+    }
+    catch (const except::Exception& ex)
+    {
+        std::cerr << ex.toString() << "\n";
+        return 1;
+    }
+    TEST_CHECK(testBatchMatchesSerial);
+    TEST_CHECK(testSlantPlaneBatchMatchesSerial);
+    TEST_CHECK(testEmpty);
+    return 0;
+}
@@ -3,6 +3,7 @@
 #include <vector>
 
 #include "TestCase.h"
+#include "TestUtilities.h"
 #include "scene/ProjectionPolynomialFitter.h"
 #include "scene/ProjectionModel.h"
 #include "six/sicd/ComplexData.h"
@@ -10,25 +11,10 @@
 
 namespace
 {
-std::string findSixHome(const sys::Path& exePath)
-{
-    sys::Path sixHome = exePath.join("..");
-    do
-    {
-        const sys::Path croppedNitfs = sixHome.join("croppedNitfs");
-        if (sys::OS().isDirectory(croppedNitfs.getAbsolutePath()))
-        {
-            return sixHome;
-        }
-        sixHome = sixHome.join("..");
-    } while (sixHome.getAbsolutePath() != sixHome.join("..").getAbsolutePath());
-    return "";
-}
-
 std::auto_ptr<scene::ProjectionPolynomialFitter>
 loadPolynomialFitter(const sys::Path& exePath)
 {
-    const std::string sixHome = findSixHome(exePath);
+    const std::string sixHome = test::findSixHome(exePath);
     if (sixHome.empty())
     {
         std::ostringstream oss;
@@ -0,0 +1,277 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "TestCase.h"
+#include "TestUtilities.h"
+#include <mt/ThreadGroup.h>
+#include <scene/DEMTileCache.h>
+#include <scene/ECEFToLLATransform.h>
+#include <scene/TerrainProjector.h>
+#include <six/sicd/ComplexData.h>
+#include <six/sicd/Utilities.h>
+
+namespace
+{
+std::auto_ptr<six::sicd::ComplexData> globalData;
+
+// A DEM centered on the SCP with 'slope' meters of rise per degree of
+// latitude
+struct TestDEM
+{
+    TestDEM(const six::sicd::ComplexData& data,
+            double baseHeight,
+            double slope)
+    {
+        const scene::LatLonAlt& scp(data.geoData->scp.llh);
+        const types::RowCol<size_t> dims(201, 201);
+        geometry = scene::DEMGridGeometry(
+                scene::LatLon(scp.getLat() + 0.1, scp.getLon() - 0.1),
+                scene::LatLon(0.001, 0.001),
+                dims);
+
+        heights.resize(dims.area());
+        for (size_t row = 0; row < dims.row; ++row)
+        {
+            const double lat = geometry.rowColToLatLon(
+                    types::RowCol<double>(row, 0)).getLat();
+            for (size_t col = 0; col < dims.col; ++col)
+            {
+                heights[row * dims.col + col] = static_cast<float>(
+                        baseHeight + slope * (lat - scp.getLat()));
+            }
+        }
+    }
+
+    scene::DEMGridGeometry geometry;
+    std::vector<float> heights;
+};
+
+// Makes tile loads slow enough that concurrent lookups overlap them
+class SlowDEMTileSource : public scene::MemoryDEMTileSource
+{
+public:
+    SlowDEMTileSource(const scene::DEMGridGeometry& geometry,
+                      const float* heights,
+                      const types::RowCol<size_t>& tileDims) :
+        scene::MemoryDEMTileSource(geometry, heights, tileDims)
+    {
+    }
+
+protected:
+    virtual void readHeights(const types::RowCol<size_t>& offset,
+                             const types::RowCol<size_t>& dims,
+                             float* heights) const
+    {
+        sys::OS().millisleep(20);
+        scene::MemoryDEMTileSource::readHeights(offset, dims, heights);
+    }
+};
+
+class GetHeight : public sys::Runnable
+{
+public:
+    GetHeight(const scene::DEMTileCache& cache,
+              const scene::LatLon& latLon,
+              double& height) :
+        mCache(cache),
+        mLatLon(latLon),
+        mHeight(height)
+    {
+    }
+
+    virtual void run()
+    {
+        mHeight = mCache.getHeight(mLatLon);
+    }
+
+private:
+    const scene::DEMTileCache& mCache;
+    const scene::LatLon mLatLon;
+    double& mHeight;
+};
+
+std::vector<types::RowCol<double> >
+getTestPixels(const six::sicd::ComplexData& data)
+{
+    const double lastRow = static_cast<double>(data.getNumRows() - 1);
+    const double lastCol = static_cast<double>(data.getNumCols() - 1);
+
+    std::vector<types::RowCol<double> > pixels;
+    pixels.push_back(types::RowCol<double>(0, 0));
+    pixels.push_back(types::RowCol<double>(0, lastCol));
+    pixels.push_back(types::RowCol<double>(lastRow / 2, lastCol / 2));
+    pixels.push_back(types::RowCol<double>(lastRow, 0));
+    pixels.push_back(types::RowCol<double>(lastRow, lastCol));
+    return pixels;
+}
+
+TEST_CASE(testFlatTerrainMatchesHAE)
+{
+    const double height = 350.0;
+    const TestDEM dem(*globalData, height, 0.0);
+    const scene::MemoryDEMTileSource source(dem.geometry, &dem.heights[0],
+                                            types::RowCol<size_t>(32, 32));
+    const scene::DEMTileCache cache(source);
+
+    std::auto_ptr<scene::SceneGeometry> geometry(
+            six::sicd::Utilities::getSceneGeometry(globalData.get()));
+    std::auto_ptr<scene::ProjectionModel> model(
+            six::sicd::Utilities::getProjectionModel(globalData.get(),
+                                                     geometry.get()));
+    const scene::TerrainProjector projector(*model, cache);
+
+    const std::vector<types::RowCol<double> > pixels =
+            getTestPixels(*globalData);
+    for (size_t ii = 0; ii < pixels.size(); ++ii)
+    {
+        const types::RowCol<double> imagePt =
+                globalData->pixelToImagePoint(pixels[ii]);
+        const scene::Vector3 expected = model->imageToScene(imagePt, height);
+        const scene::Vector3 actual = projector.imageToScene(imagePt, 0.0);
+        TEST_ASSERT_ALMOST_EQ_EPS((expected - actual).norm(), 0.0, 1e-3);
+    }
+}
+
+TEST_CASE(testSlopedTerrain)
+{
+    const TestDEM dem(*globalData, 500.0, 20000.0);
+    const scene::MemoryDEMTileSource source(dem.geometry, &dem.heights[0],
+                                            types::RowCol<size_t>(32, 32));
+    const scene::DEMTileCache cache(source, 4);
+
+    std::vector<scene::Vector3> scenePoints;
+    six::sicd::Utilities::projectPixelsToTerrain(
+            *globalData, cache, getTestPixels(*globalData), scenePoints, 2);
+
+    const scene::ECEFToLLATransform ecefToLatLon;
+    for (size_t ii = 0; ii < scenePoints.size(); ++ii)
+    {
+        const scene::LatLonAlt lla = ecefToLatLon.transform(scenePoints[ii]);
+        const double demHeight =
+                cache.getHeight(scene::LatLon(lla.getLat(), lla.getLon()));
+        TEST_ASSERT_ALMOST_EQ_EPS(lla.getAlt(), demHeight, 0.1);
+    }
+    TEST_ASSERT(cache.getNumCachedTiles() <= 4);
+}
+
+TEST_CASE(testConcurrentTileLoads)
+{
+    const TestDEM dem(*globalData, 100.0, 1000.0);
+    const SlowDEMTileSource source(dem.geometry, &dem.heights[0],
+                                   types::RowCol<size_t>(32, 32));
+    const scene::DEMTileCache cache(source);
+
+    // Every thread needs the same tile, which should only be loaded once
+    const scene::LatLon latLon = dem.geometry.rowColToLatLon(
+            types::RowCol<double>(10.5, 10.5));
+    const size_t numThreads = 8;
+    std::vector<double> heights(numThreads);
+    mt::ThreadGroup threads;
+    for (size_t ii = 0; ii < numThreads; ++ii)
+    {
+        threads.createThread(new GetHeight(cache, latLon, heights[ii]));
+    }
+    threads.joinAll();
+
+    TEST_ASSERT_EQ(cache.getNumTileLoads(), static_cast<size_t>(1));
+    for (size_t ii = 0; ii < numThreads; ++ii)
+    {
+        TEST_ASSERT_EQ(heights[ii], cache.getHeight(latLon));
+    }
+}
+
+TEST_CASE(testEmptyGrid)
+{
+    const scene::LatLon origin(10.0, 20.0);
+    const scene::LatLon spacing(0.001, 0.001);
+    TEST_EXCEPTION(scene::DEMGridGeometry(origin, spacing,
+                                          types::RowCol<size_t>(0, 10)));
+    TEST_EXCEPTION(scene::DEMGridGeometry(origin, spacing,
+                                          types::RowCol<size_t>(10, 0)));
+
+    // A default constructed geometry has no posts to read
+    const float height = 0.0f;
+    TEST_EXCEPTION(scene::MemoryDEMTileSource(scene::DEMGridGeometry(),
+                                              &height));
+}
+
+TEST_CASE(testOrthoGrid)
+{
+    const TestDEM dem(*globalData, 200.0, 5000.0);
+    const scene::MemoryDEMTileSource source(dem.geometry, &dem.heights[0]);
+    const scene::DEMTileCache cache(source);
+
+    const types::RowCol<size_t> spacing(
+            std::max<size_t>(globalData->getNumRows() / 4, 1),
+            std::max<size_t>(globalData->getNumCols() / 3, 1));
+    std::vector<scene::LatLonAlt> grid;
+    const types::RowCol<size_t> gridDims =
+            six::sicd::Utilities::getTerrainOrthoGrid(*globalData, cache,
+                                                      spacing, grid);
+    TEST_ASSERT_EQ(grid.size(), gridDims.area());
+
+    // Corners of the grid are the corners of the image
+    std::vector<types::RowCol<double> > corners(1,
+            types::RowCol<double>(globalData->getNumRows() - 1,
+                                  globalData->getNumCols() - 1));
+    std::vector<scene::Vector3> cornerPoints;
+    six::sicd::Utilities::projectPixelsToTerrain(*globalData, cache, corners,
+                                                 cornerPoints);
+    const scene::LatLonAlt expected =
+            scene::ECEFToLLATransform().transform(cornerPoints[0]);
+    const scene::LatLonAlt& actual = grid.back();
+    TEST_ASSERT_ALMOST_EQ_EPS(actual.getLat(), expected.getLat(), 1e-5);
+    TEST_ASSERT_ALMOST_EQ_EPS(actual.getLon(), expected.getLon(), 1e-5);
+    TEST_ASSERT_ALMOST_EQ_EPS(actual.getAlt(), expected.getAlt(), 0.2);
+}
+}
+
+int main(int argc, char** argv)
+{
+    if (argc == 0)
+    {
+        std::cerr << "This test makes assumptions about the directory structure."
+            << " Make sure to call with the executable name as argv[0] so "
+            << " we can find the necessary files.\n";
+        return 1;
+    }
+
+    try
+    {
+        globalData = test::loadComplexData(std::string(argv[0]));
+    }
+    catch (const except::Exception& ex)
+    {
+        std::cerr << ex.toString() << "\n";
+        return 1;
+    }
+    TEST_CHECK(testFlatTerrainMatchesHAE);
+    TEST_CHECK(testSlopedTerrain);
+    TEST_CHECK(testConcurrentTileLoads);
+    TEST_CHECK(testEmptyGrid);
+    TEST_CHECK(testOrthoGrid);
+    return 0;
+}
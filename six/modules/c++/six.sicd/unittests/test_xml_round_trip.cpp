@@ -0,0 +1,152 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "TestCase.h"
+#include "TestUtilities.h"
+#include <logging/NullLogger.h>
+#include <six/NITFReadControl.h>
+#include <six/XMLControlFactory.h>
+#include <six/sicd/ComplexData.h>
+#include <six/sicd/ComplexXMLControl.h>
+#include <six/sicd/Utilities.h>
+
+namespace
+{
+std::string globalSICDPathname;
+
+std::auto_ptr<six::sicd::ComplexData> createData()
+{
+    six::NITFReadControl reader;
+    reader.loadMetadata(globalSICDPathname, std::vector<std::string>());
+
+    std::auto_ptr<six::sicd::ComplexData> data(
+            static_cast<six::sicd::ComplexData*>(
+                    reader.getContainer()->getData(0)->clone()));
+    return data;
+}
+
+std::auto_ptr<six::sicd::ComplexData> roundTrip(
+        const six::sicd::ComplexData& data)
+{
+    const std::vector<std::string> schemaPaths;
+    logging::NullLogger log;
+    const std::string xml =
+            six::sicd::Utilities::toXMLString(data, schemaPaths, &log);
+    return six::sicd::Utilities::parseDataFromString(xml, schemaPaths, log);
+}
+
+TEST_CASE(testDataRoundTrips)
+{
+    const std::auto_ptr<six::sicd::ComplexData> data(createData());
+    const std::auto_ptr<six::sicd::ComplexData> parsed(roundTrip(*data));
+    TEST_ASSERT(*parsed == *data);
+}
+
+TEST_CASE(testFullPrecisionRoundTrips)
+{
+    // Values that need every significant digit, values that have no exact
+    // decimal representation, and values at the extremes of the exponent
+    // range all have to come back bit for bit
+    std::auto_ptr<six::sicd::ComplexData> data(createData());
+    data->position->arpPoly[0][0] = 0.1 + 0.2;
+    data->grid->timeCOAPoly[0][0] = 1.0 / 3.0;
+    data->scpcoa->slantRange = -2.0 / 3.0;
+    data->scpcoa->groundRange = 1.0e-300;
+    data->scpcoa->dopplerConeAngle = 1.0e300;
+    data->scpcoa->scpTime = 0.0;
+    data->grid->row->sampleSpacing = 0.3;
+    data->grid->col->impulseResponseWidth = 1.0 / 7.0;
+
+    const std::auto_ptr<six::sicd::ComplexData> parsed(roundTrip(*data));
+    TEST_ASSERT(*parsed == *data);
+    TEST_ASSERT_EQ(parsed->position->arpPoly[0][0], 0.1 + 0.2);
+    TEST_ASSERT_EQ(parsed->scpcoa->groundRange, 1.0e-300);
+    TEST_ASSERT_EQ(parsed->grid->col->impulseResponseWidth, 1.0 / 7.0);
+}
+
+TEST_CASE(testFullPrecisionOption)
+{
+    std::auto_ptr<six::sicd::ComplexData> data(createData());
+    data->scpcoa->scpTime = 1.0;
+
+    const std::vector<std::string> schemaPaths;
+    logging::NullLogger log;
+    const std::string shortest =
+            six::toValidXMLString(data.get(), schemaPaths, &log);
+    TEST_ASSERT(shortest.find("<SCPTime>1E00</SCPTime>") != std::string::npos);
+
+    const std::string fullPrecision =
+            six::toValidXMLString(data.get(), schemaPaths, &log, NULL, true);
+    TEST_ASSERT(fullPrecision.find(
+            "<SCPTime>1.00000000000000000E00</SCPTime>") != std::string::npos);
+
+    const std::auto_ptr<six::sicd::ComplexData> parsed(
+            six::sicd::Utilities::parseDataFromString(
+                    fullPrecision, schemaPaths, log));
+    TEST_ASSERT(*parsed == *data);
+}
+
+TEST_CASE(testSerializationIsStable)
+{
+    // Writing what was read has to produce the same document
+    const std::auto_ptr<six::sicd::ComplexData> data(createData());
+    const std::auto_ptr<six::sicd::ComplexData> parsed(roundTrip(*data));
+
+    logging::NullLogger log;
+    TEST_ASSERT_EQ(six::sicd::Utilities::toXMLString(*data,
+                           std::vector<std::string>(), &log),
+                   six::sicd::Utilities::toXMLString(*parsed,
+                           std::vector<std::string>(), &log));
+}
+}
+
+int main(int argc, char** argv)
+{
+    if (argc == 0)
+    {
+        std::cerr << "This test makes assumptions about the directory structure."
+            << " Make sure to call with the executable name as argv[0] so "
+            << " we can find the necessary files.\n";
+        return 1;
+    }
+
+    if (test::findSixHome(sys::Path(argv[0])).empty())
+    {
+        std::cerr << "Environment error: Cannot determine source tree root\n";
+        return 1;
+    }
+    globalSICDPathname = test::getSampleSICDPathname(sys::Path(argv[0]));
+
+    six::XMLControlFactory::getInstance().addCreator(
+            six::DataType::COMPLEX,
+            new six::XMLControlCreatorT<six::sicd::ComplexXMLControl>());
+
+    TEST_CHECK(testDataRoundTrips);
+    TEST_CHECK(testFullPrecisionRoundTrips);
+    TEST_CHECK(testFullPrecisionOption);
+    TEST_CHECK(testSerializationIsStable);
+    return 0;
+}
@@ -0,0 +1,79 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_SIDD_CHIP_EXTRACTOR_H__
+#define __SIX_SIDD_CHIP_EXTRACTOR_H__
+
+#include <memory>
+
+#include <scene/GridECEFTransform.h>
+#include <six/ChipExtractor.h>
+#include <six/NITFReadControl.h>
+#include <six/sidd/DerivedData.h>
+
+namespace six
+{
+namespace sidd
+{
+/*!
+ * \class ChipExtractor
+ * \brief Cuts many chips out of one product of an open SIDD
+ *
+ * The grid transform is built once and shared by every chip.  Each chip's
+ * metadata is updated the same way cropSIDD() updates it, including its
+ * GeometricChip.  If the product is already a chip, the new chip's
+ * coordinates are still relative to the full image.
+ */
+class ChipExtractor : public six::ChipExtractor
+{
+public:
+    /*!
+     * \param reader Reader for the SIDD.  NITFReadControl::load() must be
+     * called prior to this.
+     * \param imageNumber Which product to cut chips from
+     * \param numThreads Number of threads to use.  If 0, uses the number
+     * of CPUs available.
+     * \param blockSize Maximum number of bytes of pixels to read at once
+     *
+     * \throws except::Exception if the reader doesn't hold a SIDD or
+     * there's no such product
+     */
+    ChipExtractor(NITFReadControl& reader,
+                  size_t imageNumber = 0,
+                  size_t numThreads = 0,
+                  size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+    virtual std::auto_ptr<Data> cropMetadata(const Chip& chip) const;
+
+private:
+    types::RowCol<double> chipToFull(size_t row, size_t col) const;
+
+    LatLon toLatLon(size_t row, size_t col) const;
+
+private:
+    const DerivedData& mData;
+    const std::auto_ptr<const GeometricChip> mChip;
+    const std::auto_ptr<const scene::GridECEFTransform> mGridTransform;
+};
+}
+}
+
+#endif
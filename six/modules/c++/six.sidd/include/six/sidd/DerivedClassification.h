@@ -41,6 +41,11 @@ namespace sidd
 class DerivedClassification: public Classification
 {
 public:
+    DerivedClassification() :
+        desVersion(0)
+    {
+    }
+
     virtual std::string getLevel() const
     {
         return classification;
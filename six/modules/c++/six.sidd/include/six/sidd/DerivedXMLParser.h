@@ -43,6 +43,9 @@ public:
 
     virtual DerivedData* fromXML(const xml::lite::Document* doc) const = 0;
 
+    //! Also applies to the common SICD/SIDD parser
+    virtual void setFullPrecisionNumbers(bool fullPrecision);
+
 protected:
     virtual void parseDerivedClassificationFromXML(
             const XMLElem classificationElem,
@@ -40,16 +40,15 @@ namespace sidd
  *  \class GeoTIFFWriteControl
  *  \brief Write a SIDD GeoTIFF
  *
- *  This class uses the tiff-c++ library to write out a GeoTIFF that
- *  can be up to 4GB.  If the imagery exceeds the limit, this instance
- *  of WriteControl will throw an exception.
+ *  This class uses the tiff-c++ library to write out a GeoTIFF.  If the
+ *  imagery could exceed 4GB, a BigTIFF is written instead.
  *
- *  Image is currently stripped, and contains the required TIFF, GeoTIFF and
- *  private SICD/SIDD keys described in the File Format Description document.
+ *  Images are tiled and, by default, LZW compressed with tiles compressed
+ *  in parallel (see OPT_COMPRESS and OPT_NUM_THREADS).  They contain the
+ *  required TIFF, GeoTIFF and private SICD/SIDD keys described in the File
+ *  Format Description document.
  *
  *  Containers must represent derived products!
- *
- *  \todo Support tiles using Options?
  */
 class GeoTIFFWriteControl : public WriteControl
 {
@@ -57,6 +56,18 @@ class GeoTIFFWriteControl : public WriteControl
     std::vector<Data*> mComplexData;
     std::vector<Data*> mDerivedData;
 public:
+    /*!
+     *  Whether to LZW compress the image, as an integer flag.  Defaults
+     *  to 1.  Compression is lossless.
+     */
+    static const char OPT_COMPRESS[];
+
+    /*!
+     *  Number of threads to compress tiles with.  Defaults to 0, which
+     *  uses the number of CPUs available.
+     */
+    static const char OPT_NUM_THREADS[];
+
     GeoTIFFWriteControl();
 
 
@@ -105,6 +116,22 @@ private:
                         const std::string &str,
                         int tiffType = tiff::Const::Type::ASCII);
 
+    //! \return True if the images should be LZW compressed
+    bool isCompressed() const;
+
+    //! \return True if the file could exceed 4GB and needs to be a BigTIFF
+    bool isBigTIFF() const;
+
+    //! Creates the file and its header
+    void createFile(tiff::FileWriter& tiffWriter,
+                    const std::string& toFile) const;
+
+    //! Adds an image and sets up its IFD and tiling
+    tiff::ImageWriter* addImage(tiff::FileWriter& tiffWriter,
+                                const DerivedData* data,
+                                const std::string& toFile,
+                                const std::vector<std::string>& schemaPaths);
+
     void setupIFD(const DerivedData* data,
                   tiff::IFD* ifd,
                   const std::string& toFilePrefix,
@@ -0,0 +1,124 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_SIDD_J2K_COMPRESSOR_H__
+#define __SIX_SIDD_J2K_COMPRESSOR_H__
+
+#include <vector>
+
+#include <sys/Conf.h>
+#include <types/RowCol.h>
+#include <six/sidd/DerivedData.h>
+
+namespace six
+{
+namespace sidd
+{
+/*!
+ * \class J2KCompressor
+ * \brief Losslessly compresses SIDD pixel data to JPEG 2000 for use with
+ * CompressedSIDDByteProvider
+ *
+ * Each NITF image segment becomes one J2K codestream whose tiles are the
+ * segment's NITF blocks, which is the layout NITRO's J2K decompression
+ * plug-in expects.  Compression is done through NITRO's j2k_Writer.
+ *
+ * With more than one thread, each block is compressed on its own and the
+ * compressed tiles are stitched together into the segment's codestream.
+ * This only produces the same codestream as compressing the whole segment
+ * at once if the tiles start on the same code-block and wavelet boundaries
+ * either way, so it's used when every dimension that is split into more
+ * than one block has a block size that is a power of two.  Otherwise, or
+ * if a partial block at the edge is too small to compress on its own,
+ * segments are compressed whole and only separate segments are compressed
+ * in parallel.
+ *
+ * Only available if SIX was built with J2K support; see isAvailable().
+ */
+class J2KCompressor
+{
+public:
+    /*!
+     * \param numThreads Number of blocks to compress at once.  If 0, uses
+     * the number of CPUs available.
+     */
+    J2KCompressor(size_t numThreads = 0);
+
+    //! \return True if SIX was built with J2K support
+    static bool isAvailable();
+
+    /*!
+     * Compress a single image segment into one J2K codestream.
+     *
+     * \param imageData Pixels of the segment in row-major order with no
+     * blocking, in native byte order.
+     * \param dims Number of rows and columns in the segment
+     * \param numBytesPerPixel 1 or 2
+     * \param blockDims Rows and columns per NITF block.  0 means the
+     * segment isn't blocked in that direction.
+     * \param[out] compressed The codestream
+     * \param[out] bytesPerBlock Number of bytes of the codestream for each
+     * block, in row-major block order.  The main header is counted in the
+     * first block and the end of codestream marker in the last.
+     */
+    void compress(const sys::ubyte* imageData,
+                  const types::RowCol<size_t>& dims,
+                  size_t numBytesPerPixel,
+                  const types::RowCol<size_t>& blockDims,
+                  std::vector<sys::ubyte>& compressed,
+                  std::vector<size_t>& bytesPerBlock) const;
+
+    /*!
+     * Compress a SIDD image, splitting it into image segments the same way
+     * CompressedSIDDByteProvider will.  Pass the outputs and the same
+     * blocking and product size to CompressedSIDDByteProvider, marking the
+     * data as numerically lossless, to write the NITF.
+     *
+     * \param data SIDD metadata.  Pixel type must be MONO8I, MONO8LU,
+     * RGB8LU, or MONO16I.
+     * \param imageData All of the image's pixels in row-major order with no
+     * blocking, in native byte order.
+     * \param numRowsPerBlock The number of rows per block.  0 means no
+     * blocking.
+     * \param numColsPerBlock The number of columns per block.  0 means no
+     * blocking.
+     * \param maxProductSize The max number of bytes in an image segment.
+     * 0 uses the NITF limit.
+     * \param[out] compressed The codestreams of each segment, back to back.
+     * This is the image data to pass to getBytes().
+     * \param[out] bytesPerBlock A vector for each image segment with the
+     * compressed size of each of its blocks
+     */
+    void compress(const DerivedData& data,
+                  const sys::ubyte* imageData,
+                  size_t numRowsPerBlock,
+                  size_t numColsPerBlock,
+                  size_t maxProductSize,
+                  std::vector<sys::ubyte>& compressed,
+                  std::vector<std::vector<size_t> >& bytesPerBlock) const;
+
+private:
+    const size_t mNumThreads;
+};
+}
+}
+
+#endif
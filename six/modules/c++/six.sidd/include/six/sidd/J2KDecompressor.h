@@ -0,0 +1,137 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_SIDD_J2K_DECOMPRESSOR_H__
+#define __SIX_SIDD_J2K_DECOMPRESSOR_H__
+
+#include <string>
+#include <vector>
+
+#include <sys/Conf.h>
+#include <types/RowCol.h>
+#include <six/NITFReadControl.h>
+#include <six/Region.h>
+
+namespace six
+{
+namespace sidd
+{
+/*!
+ * \class J2KDecompressor
+ * \brief Reads regions of J2K compressed (IC=C8) SIDD images, decoding
+ * tiles in parallel
+ *
+ * NITFReadControl::interleaved() decodes one block at a time on the
+ * calling thread.  This finds the J2K tiles that intersect the region
+ * and decodes them concurrently, each thread with its own file handle.
+ *
+ * Images can also be read at reduced resolutions using the codestream's
+ * resolution levels, which only decodes the data needed at that
+ * resolution.  Level 0 is full resolution and each level after that
+ * halves the rows and columns of each image segment, rounding up.
+ *
+ * Only available if SIX was built with J2K support; see isAvailable().
+ */
+class J2KDecompressor
+{
+public:
+    /*!
+     * \param reader A NITFReadControl that has had load() called on it
+     * \param pathname The file the reader loaded
+     * \param numThreads Number of tiles to decode at once.  If 0, uses the
+     * number of CPUs available.
+     *
+     * \throws except::Exception if any image isn't J2K compressed
+     */
+    J2KDecompressor(const NITFReadControl& reader,
+                    const std::string& pathname,
+                    size_t numThreads = 0);
+
+    //! \return True if SIX was built with J2K support
+    static bool isAvailable();
+
+    //! \return Number of resolution levels available for the image
+    size_t getNumResolutionLevels(size_t imageNumber) const;
+
+    /*!
+     * \param imageNumber Index of the image
+     * \param resolutionLevel Resolution level
+     *
+     * \return Rows and columns of the image at this resolution level
+     */
+    types::RowCol<size_t> getDims(size_t imageNumber,
+                                  size_t resolutionLevel = 0) const;
+
+    /*!
+     * Read section of image data specified by region
+     *
+     * \param region Rows and columns of the image to read, at this
+     * resolution level.  If the number of rows and/or number of columns is
+     * set to -1, this indicates to read the entirety of the image in that
+     * dimension.  In this case, this parameter will be updated with the
+     * actual number of rows and/or columns that were read.
+     * \param imageNumber Index of the image to read
+     * \param resolutionLevel Resolution level to read at
+     *
+     * \return Buffer of image data, in native byte order.  This is simply
+     * a pointer to the buffer that is held by 'region'.  If it is NULL in
+     * the incoming region, the memory is allocated and the region's buffer
+     * is updated.  In this case it is up to the caller to delete the
+     * memory.
+     */
+    UByte* read(Region& region,
+                size_t imageNumber,
+                size_t resolutionLevel = 0) const;
+
+    //! Location and codestream parameters of one image segment
+    struct Segment
+    {
+        Segment();
+
+        //! Offset of the codestream in the file
+        nitf::Off fileOffset;
+
+        //! First row of the segment in the full resolution image
+        size_t firstRow;
+
+        types::RowCol<size_t> dims;
+        types::RowCol<size_t> tileDims;
+        size_t numResolutionLevels;
+    };
+
+private:
+    struct Image
+    {
+        size_t numBytesPerPixel;
+        std::vector<Segment> segments;
+    };
+
+    const Image& getImage(size_t imageNumber) const;
+
+private:
+    const std::string mPathname;
+    const size_t mNumThreads;
+    std::vector<Image> mImages;
+};
+}
+}
+
+#endif
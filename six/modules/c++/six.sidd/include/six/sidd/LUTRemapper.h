@@ -0,0 +1,174 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_SIDD_LUT_REMAPPER_H__
+#define __SIX_SIDD_LUT_REMAPPER_H__
+
+#include <vector>
+
+#include <io/InputStream.h>
+#include <io/OutputStream.h>
+#include <six/Types.h>
+#include <six/sidd/DerivedData.h>
+#include <six/sidd/LookupTable.h>
+
+namespace six
+{
+namespace sidd
+{
+/*!
+ * \class LUTRemapper
+ * \brief Applies SIDD lookup tables to pixels
+ *
+ * Handles a single LUT, such as the display LUT that turns RGB8LU pixels
+ * into RGB24I or a 16-bit to 8-bit remap, as well as chains of LUTs like
+ * band equalization followed by data remapping and a tonal transfer
+ * curve.  Chains are composed into one table per band when they're set
+ * up, so remapping is a single lookup per sample no matter how many LUTs
+ * there are.  Pixels are remapped in parallel.
+ *
+ * Input samples are 8-bit if the first LUT has at most 256 entries and
+ * 16-bit otherwise.  Values past the end of a LUT use its last entry.
+ * 2-byte LUT entries are unsigned 16-bit values in native byte order, which
+ * is how SIX stores them when reading them from XML or a NITF.  An entry
+ * of 3 bytes (an RGB color) can only come from the last LUT in a chain.
+ */
+class LUTRemapper
+{
+public:
+    //! Default number of rows remapRows() reads at once
+    static const size_t DEFAULT_ROWS_PER_BLOCK;
+
+    /*!
+     * Remaps one band with 'lut'
+     *
+     * \param lut LUT to apply
+     * \param numThreads Number of threads to use.  If 0, uses the number
+     * of CPUs available.
+     */
+    explicit LUTRemapper(const LUT& lut, size_t numThreads = 0);
+
+    /*!
+     * Remaps each band with the corresponding LUT of a custom SIDD lookup
+     * table
+     *
+     * \param lookupTable Custom lookup table with one LUT per band
+     * \param numThreads Number of threads to use.  If 0, uses the number
+     * of CPUs available.
+     *
+     * \throws except::Exception if the lookup table isn't custom
+     */
+    explicit LUTRemapper(const LookupTable& lookupTable,
+                         size_t numThreads = 0);
+
+    /*!
+     * Remaps a SIDD's pixels with its display LUT, which comes from
+     * RemapInformation in SIDD 1.0 and from the NITF in SIDD 2.0
+     *
+     * \param data SIDD with a display LUT
+     * \param numThreads Number of threads to use.  If 0, uses the number
+     * of CPUs available.
+     *
+     * \throws except::Exception if there's no display LUT
+     */
+    explicit LUTRemapper(const DerivedData& data, size_t numThreads = 0);
+
+    /*!
+     * Applies 'lut' to every band after the LUTs already added
+     *
+     * \throws except::Exception if the current output isn't 1 or 2 bytes
+     */
+    void append(const LUT& lut);
+
+    /*!
+     * Applies a custom lookup table after the LUTs already added.  If it
+     * has a single LUT, that's applied to every band.  Otherwise, it must
+     * have one LUT per band.
+     */
+    void append(const LookupTable& lookupTable);
+
+    //! \return Number of interleaved bands in each pixel
+    size_t getNumBands() const
+    {
+        return mTables.size();
+    }
+
+    //! \return Bytes per input pixel
+    size_t getNumInputBytesPerPixel() const
+    {
+        return mNumInputBytes * mTables.size();
+    }
+
+    //! \return Bytes per output pixel
+    size_t getNumOutputBytesPerPixel() const
+    {
+        return mNumOutputBytes * mTables.size();
+    }
+
+    /*!
+     * Remaps a buffer of pixels
+     *
+     * \param input Pixels to remap, with bands interleaved
+     * \param numPixels Number of pixels
+     * \param[out] output Remapped pixels.  Must hold
+     * numPixels * getNumOutputBytesPerPixel() bytes.  It can't overlap the
+     * input.
+     */
+    void remap(const UByte* input, size_t numPixels, UByte* output) const;
+
+    /*!
+     * Remaps an image from a stream a block of rows at a time, so only
+     * one block of input and output is held in memory
+     *
+     * \param input Stream to read the image from
+     * \param numRows Number of rows to remap
+     * \param numCols Number of columns in the image
+     * \param output Stream to write the remapped image to
+     * \param numRowsPerBlock Number of rows to remap at once
+     */
+    void remapRows(io::InputStream& input,
+                   size_t numRows,
+                   size_t numCols,
+                   io::OutputStream& output,
+                   size_t numRowsPerBlock = DEFAULT_ROWS_PER_BLOCK) const;
+
+private:
+    void append(const std::vector<const LUT*>& luts);
+
+    //! \return Table covering every input value, for a band without one
+    std::vector<UByte> composeFirst(const LUT& lut);
+
+    std::vector<UByte> compose(const std::vector<UByte>& table,
+                               const LUT& lut) const;
+
+private:
+    const size_t mNumThreads;
+
+    //! Composed LUT for each band, with an entry for every input value
+    std::vector<std::vector<UByte> > mTables;
+
+    size_t mNumInputBytes;
+    size_t mNumOutputBytes;
+};
+}
+}
+
+#endif
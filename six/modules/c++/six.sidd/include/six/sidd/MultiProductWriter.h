@@ -0,0 +1,227 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_SIDD_MULTI_PRODUCT_WRITER_H__
+#define __SIX_SIDD_MULTI_PRODUCT_WRITER_H__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <io/InputStream.h>
+#include <io/NullStreams.h>
+#include <io/OutputStream.h>
+#include <mem/SharedPtr.h>
+#include <types/RowCol.h>
+#include <six/NITFWriteControl.h>
+#include <six/Types.h>
+#include <six/sidd/OverviewPyramid.h>
+
+namespace six
+{
+namespace sidd
+{
+/*!
+ * \class MultiProductWriter
+ * \brief Writes a multi-product SIDD from a single pass over its source
+ *
+ * NITFWriteControl::save() writes the products one after another, so
+ * products derived from the same image need the image read once for
+ * each of them or need to be staged somewhere.  Instead, this writes the
+ * NITF headers and XML first, leaving room for the pixels, and then reads
+ * the source one block of rows at a time.  Each block is handed to every
+ * product at once, with one thread per product, and each product writes
+ * its pixels straight to its image segments.  The next block is read
+ * while the products work on the current one.
+ *
+ * Only unblocked, uncompressed products are supported.
+ */
+class MultiProductWriter
+{
+public:
+    //! Default number of source rows read at once
+    static const size_t DEFAULT_ROWS_PER_BLOCK;
+
+    /*!
+     * \class Product
+     * \brief Turns rows of the source into one product's pixels
+     */
+    class Product
+    {
+    public:
+        virtual ~Product()
+        {
+        }
+
+        /*!
+         * Called before any source rows are written
+         *
+         * \param output Where the product's pixels go, row by row in
+         * order and in native byte order
+         */
+        virtual void start(io::OutputStream& output) = 0;
+
+        /*!
+         * Consumes the next block of source rows
+         *
+         * \param rows Whole rows of the source
+         * \param numBytes Number of bytes in 'rows'
+         */
+        virtual void write(const UByte* rows, size_t numBytes) = 0;
+    };
+
+    //! Writes the source as is
+    class FullResolution : public Product
+    {
+    public:
+        FullResolution();
+
+        virtual void start(io::OutputStream& output);
+
+        virtual void write(const UByte* rows, size_t numBytes);
+
+    private:
+        io::OutputStream* mOutput;
+    };
+
+    /*!
+     * \class Overviews
+     * \brief Writes overview levels of the source, all from one
+     * OverviewPyramid
+     *
+     * Each level is its own Product, from getLevel().  Whichever level is
+     * started first feeds the pyramid on its thread and every other level
+     * just receives its rows.  Levels that aren't written still have to be
+     * computed for the ones below them.  The levels can be used by one
+     * save() at a time.  Use OverviewPyramid::createOverviewData() for
+     * their metadata.
+     */
+    class Overviews
+    {
+    public:
+        /*!
+         * \param dims Rows and columns of the source
+         * \param pixelType Pixel type of the source
+         * \param numLevels Number of overview levels to build
+         * \param filter Filter to use for all levels
+         * \param numThreads Number of threads to filter with.  Each
+         * product already has a thread of its own, so this defaults to 1.
+         * If 0, uses the number of CPUs available.
+         *
+         * \throws except::Exception if 'numLevels' is 0 or more than the
+         * source has room for, or the pixel type isn't supported
+         */
+        Overviews(const types::RowCol<size_t>& dims,
+                  PixelType pixelType,
+                  size_t numLevels,
+                  OverviewPyramid::Filter filter = OverviewPyramid::BOX,
+                  size_t numThreads = 1);
+
+        /*!
+         * \param level Overview level, starting at 1
+         *
+         * \return Product that writes this level.  It belongs to this
+         * object.
+         *
+         * \throws except::Exception if there's no such level
+         */
+        Product& getLevel(size_t level);
+
+    private:
+        Overviews(const Overviews&);
+        Overviews& operator=(const Overviews&);
+
+        class Level : public Product
+        {
+        public:
+            Level(Overviews& overviews, size_t level);
+
+            virtual void start(io::OutputStream& output);
+
+            virtual void write(const UByte* rows, size_t numBytes);
+
+        private:
+            Overviews& mOverviews;
+            const size_t mLevel;
+        };
+
+        void start(size_t level, io::OutputStream& output);
+
+        void write(size_t level, const UByte* rows, size_t numBytes);
+
+        void reset();
+
+    private:
+        const types::RowCol<size_t> mDims;
+        const PixelType mPixelType;
+        const OverviewPyramid::Filter mFilter;
+        const size_t mNumThreads;
+        std::vector<mem::SharedPtr<Level> > mLevels;
+
+        //! Where each level goes.  Levels that aren't started go nowhere.
+        std::vector<io::OutputStream*> mOutputs;
+        io::NullOutputStream mNullOutput;
+
+        //! Level that feeds the pyramid, or 0 if none has started
+        size_t mFirstStarted;
+        std::auto_ptr<OverviewPyramid> mPyramid;
+    };
+
+    /*!
+     * \param writer Writer to use.  It must already be initialized with
+     * the products' metadata, one DerivedData per product, and its options
+     * should already be set.
+     * \param numRowsPerBlock Number of source rows to read at once
+     */
+    MultiProductWriter(NITFWriteControl& writer,
+                       size_t numRowsPerBlock = DEFAULT_ROWS_PER_BLOCK);
+
+    /*!
+     * Writes the SIDD
+     *
+     * \param source Image to derive the products from, in native byte
+     * order
+     * \param dims Rows and columns of the source
+     * \param numBytesPerPixel Bytes per pixel of the source
+     * \param products How to derive each product, in the same order as the
+     * writer's metadata
+     * \param pathname File to write
+     * \param schemaPaths Directories or files of schema locations
+     *
+     * \throws except::Exception if the number of products doesn't match
+     * the metadata or a product doesn't write as many pixels as its
+     * metadata says it has
+     */
+    void save(io::InputStream& source,
+              const types::RowCol<size_t>& dims,
+              size_t numBytesPerPixel,
+              const std::vector<Product*>& products,
+              const std::string& pathname,
+              const std::vector<std::string>& schemaPaths);
+
+private:
+    NITFWriteControl& mWriter;
+    const size_t mNumRowsPerBlock;
+};
+}
+}
+
+#endif
@@ -0,0 +1,226 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_SIDD_OVERVIEW_PYRAMID_H__
+#define __SIX_SIDD_OVERVIEW_PYRAMID_H__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <io/InputStream.h>
+#include <io/OutputStream.h>
+#include <types/RowCol.h>
+#include <six/Enums.h>
+#include <six/WriteControl.h>
+#include <six/sidd/DerivedData.h>
+
+namespace six
+{
+namespace sidd
+{
+/*!
+ * \class OverviewPyramid
+ * \brief Builds reduced resolution overviews of an image in one pass
+ *
+ * Rows of the full resolution image are written to this stream in order,
+ * in native byte order.  Level 1 halves the rows and columns (rounding
+ * up), level 2 halves those again, and so on.  Each level's rows are
+ * written to its own output stream as soon as the input rows they depend
+ * on have arrived, and then feed the next level, so only a few rows of
+ * each level are ever held in memory.  Rows are filtered in parallel, by
+ * threads started the first time they're needed and kept until the
+ * pyramid is destroyed.
+ *
+ * MONO8I, MONO16I, and RGB24I images keep their pixel type.  Complex
+ * (RE32F_IM32F and RE16I_IM16I) images are detected, and since SIDD has no
+ * floating point pixel type, their overviews are MONO16I magnitudes,
+ * rounded and clamped to 65535.
+ */
+class OverviewPyramid : public io::OutputStream
+{
+public:
+    //! How each overview pixel is computed from the level above it
+    enum Filter
+    {
+        //! Average of the 2x2 pixels it covers
+        BOX,
+
+        //! Separable [1 3 3 1] / 8 binomial weights over 4x4 pixels
+        GAUSSIAN,
+
+        //! Largest of the 2x2 pixels it covers, which keeps point targets
+        MAX
+    };
+
+    /*!
+     * \param dims Rows and columns of the full resolution image
+     * \param pixelType Pixel type of the full resolution image
+     * \param levels Where to write each overview level, starting with
+     * level 1.  These must stay valid until the last row has been written.
+     * \param filter Filter to use for all levels
+     * \param numThreads Number of threads to use.  If 0, uses the number
+     * of CPUs available.
+     *
+     * \throws except::Exception if the pixel type isn't supported or the
+     * image is too small for this many levels
+     */
+    OverviewPyramid(const types::RowCol<size_t>& dims,
+                    PixelType pixelType,
+                    const std::vector<io::OutputStream*>& levels,
+                    Filter filter = BOX,
+                    size_t numThreads = 0);
+
+    ~OverviewPyramid();
+
+    /*!
+     * Adds bytes of the full resolution image.  These don't need to line
+     * up with row boundaries.
+     *
+     * \throws except::Exception if more bytes than the image holds are
+     * written
+     */
+    virtual void write(const void* buffer, size_t len);
+
+    using io::OutputStream::write;
+
+    //! \return True once every row of the image has been written
+    bool isComplete() const;
+
+    //! \return Number of overview levels being built
+    size_t getNumLevels() const
+    {
+        return mLevels.size();
+    }
+
+    /*!
+     * \param dims Rows and columns of the full resolution image
+     * \param level Overview level, where 0 is full resolution
+     *
+     * \return Rows and columns of the image at this level
+     */
+    static types::RowCol<size_t> getDims(const types::RowCol<size_t>& dims,
+                                         size_t level);
+
+    //! \return Number of levels that are at least 2x2 pixels
+    static size_t getMaxNumLevels(const types::RowCol<size_t>& dims);
+
+    //! \return Pixel type of the overviews of an image of this pixel type
+    static PixelType getOverviewPixelType(PixelType pixelType);
+
+    //! \return Bytes per pixel of the overviews of this pixel type
+    static size_t getNumBytesPerPixel(PixelType pixelType);
+
+    /*!
+     * Creates the metadata for one overview level of a SIDD.  The overview
+     * is described as a GeometricChip of the original product, so the
+     * projection and exploitation metadata still refer to the full
+     * resolution image.
+     *
+     * \param data Metadata of the full resolution image
+     * \param level Overview level, starting at 1
+     *
+     * \return Copy of the metadata with the overview's size, chip, and
+     * pixel type
+     */
+    static std::auto_ptr<DerivedData>
+    createOverviewData(const DerivedData& data, size_t level);
+
+    /*!
+     * Writes a SIDD along with overview levels of it, reading the image
+     * only once.  The overviews are written as additional products after
+     * the full resolution one, which become extra image segments for
+     * NITFWriteControl and extra IFDs for GeoTIFFWriteControl.  They are
+     * staged in temporary files while the full resolution image is
+     * written.
+     *
+     * \param data Metadata of the full resolution image
+     * \param image Full resolution image, in native byte order
+     * \param numLevels Number of overview levels to write
+     * \param writer Writer to use.  Its options should already be set.
+     * \param pathname File to write
+     * \param schemaPaths Directories or files of schema locations
+     * \param filter Filter to use for all levels
+     * \param numThreads Number of threads to use.  If 0, uses the number
+     * of CPUs available.
+     */
+    static void save(const DerivedData& data,
+                     io::InputStream& image,
+                     size_t numLevels,
+                     WriteControl& writer,
+                     const std::string& pathname,
+                     const std::vector<std::string>& schemaPaths,
+                     Filter filter = BOX,
+                     size_t numThreads = 0);
+
+private:
+    OverviewPyramid(const OverviewPyramid&);
+    OverviewPyramid& operator=(const OverviewPyramid&);
+
+private:
+    class Workers;
+
+    //! Sample type of one level's pixels
+    enum SampleType
+    {
+        UINT8,
+        UINT16
+    };
+
+    struct Level
+    {
+        types::RowCol<size_t> inputDims;
+        types::RowCol<size_t> outputDims;
+        io::OutputStream* output;
+
+        //! Input rows still needed, starting at row 'firstRow'
+        std::vector<float> rows;
+        size_t firstRow;
+        size_t numRows;
+
+        //! Next output row to compute
+        size_t nextRow;
+    };
+
+    void convertRows(const UByte* data, size_t numRows);
+
+    void addRows(size_t level, const float* rows, size_t numRows);
+
+private:
+    const types::RowCol<size_t> mDims;
+    const PixelType mPixelType;
+    const Filter mFilter;
+    const size_t mNumThreads;
+    size_t mNumChannels;
+    SampleType mSampleType;
+    std::vector<Level> mLevels;
+
+    //! Bytes of a row that hasn't been completely written yet
+    std::vector<UByte> mPartialRow;
+    size_t mNumPartialBytes;
+    size_t mNumRowsWritten;
+
+    std::auto_ptr<Workers> mWorkers;
+};
+}
+}
+
+#endif
@@ -23,6 +23,10 @@
 #ifndef __SIX_SIDD_SIDD_BYTE_PROVIDER_H__
 #define __SIX_SIDD_SIDD_BYTE_PROVIDER_H__
 
+#include <vector>
+
+#include <mem/SharedPtr.h>
+#include <nitf/ImageBlocker.hpp>
 #include <six/ByteProvider.h>
 #include <six/sidd/DerivedData.h>
 
@@ -78,6 +82,66 @@ public:
      */
     SIDDByteProvider(const NITFWriteControl& writer,
                      const std::vector<std::string>& schemaPaths);
+
+    //! \return Whether the image is blocked, so pixels need to be reordered
+    bool isBlocked() const;
+
+    /*!
+     * \param startRow Start row.  This must start on a block boundary.
+     * \param numRows Number of rows.  This must be a multiple of the block
+     * size unless it's at the end of a segment.
+     *
+     * \return The number of bytes getBlockedBytes() needs for the blocked
+     * pixels of these rows, or 0 if the image isn't blocked
+     */
+    size_t getNumBlockedBytes(size_t startRow, size_t numRows) const;
+
+    /*!
+     * Same as getBytes(), except 'imageData' is in row-major order, not
+     * blocked.  The pixels are blocked into 'blockedData' in parallel, and
+     * the buffers point into that instead.  If the image isn't blocked,
+     * 'imageData' is used directly.
+     *
+     * \param imageData The image data pixels to write, in big endian order
+     * \param startRow The global start row in pixels.  This must start on a
+     * block boundary.
+     * \param numRows The number of rows in 'imageData'.  This must be a
+     * multiple of the block size unless it's at the end of a segment.
+     * \param[out] blockedData Caller-owned space for the blocked pixels.
+     * Must hold getNumBlockedBytes(startRow, numRows) bytes and outlive
+     * 'buffers'.  It can be reused from one call to the next.
+     * \param[out] fileOffset The offset in bytes in the NITF where these
+     * buffers should be written
+     * \param[out] buffers One or more pointers to raw bytes of data
+     * \param numThreads Number of threads to use.  If 0, uses the number of
+     * CPUs available.
+     */
+    void getBlockedBytes(const void* imageData,
+                         size_t startRow,
+                         size_t numRows,
+                         void* blockedData,
+                         nitf::Off& fileOffset,
+                         nitf::NITFBufferList& buffers,
+                         size_t numThreads = 0) const;
+
+    /*!
+     * Same as above, but grows 'blockedData' as needed.  It's never shrunk,
+     * so reusing it across calls only allocates when a call needs more
+     * space than any before it.
+     */
+    void getBlockedBytes(const void* imageData,
+                         size_t startRow,
+                         size_t numRows,
+                         std::vector<sys::byte>& blockedData,
+                         nitf::Off& fileOffset,
+                         nitf::NITFBufferList& buffers,
+                         size_t numThreads = 0) const;
+
+private:
+    void initializeBlocker();
+
+private:
+    mem::SharedPtr<const nitf::ImageBlocker> mImageBlocker;
 };
 }
 }
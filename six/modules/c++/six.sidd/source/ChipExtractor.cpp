@@ -0,0 +1,127 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <except/Exception.h>
+#include <scene/Utilities.h>
+#include <six/sidd/ChipExtractor.h>
+#include <six/sidd/Utilities.h>
+
+namespace
+{
+const six::sidd::DerivedData& getDerivedData(const six::Data& data)
+{
+    if (data.getDataType() != six::DataType::DERIVED)
+    {
+        throw except::Exception(Ctxt("Input is not a SIDD"));
+    }
+    return static_cast<const six::sidd::DerivedData&>(data);
+}
+
+const six::sidd::GeometricChip*
+getGeometricChip(const six::sidd::DerivedData& data)
+{
+    if (data.downstreamReprocessing.get() &&
+        data.downstreamReprocessing->geometricChip.get())
+    {
+        return new six::sidd::GeometricChip(
+                *data.downstreamReprocessing->geometricChip);
+    }
+    return NULL;
+}
+}
+
+namespace six
+{
+namespace sidd
+{
+ChipExtractor::ChipExtractor(NITFReadControl& reader,
+                             size_t imageNumber,
+                             size_t numThreads,
+                             size_t blockSize) :
+    six::ChipExtractor(reader, imageNumber, numThreads, blockSize),
+    mData(getDerivedData(getData())),
+    mChip(getGeometricChip(mData)),
+    mGridTransform(Utilities::getGridECEFTransform(&mData))
+{
+}
+
+types::RowCol<double> ChipExtractor::chipToFull(size_t row, size_t col) const
+{
+    const types::RowCol<double> pos(static_cast<double>(row),
+                                    static_cast<double>(col));
+    return mChip.get() ? mChip->getFullImageCoordinateFromChip(pos) : pos;
+}
+
+LatLon ChipExtractor::toLatLon(size_t row, size_t col) const
+{
+    const scene::Vector3 ecef =
+            mGridTransform->rowColToECEF(chipToFull(row, col));
+
+    const scene::LatLonAlt latLon(scene::Utilities::ecefToLatLon(ecef));
+    return LatLon(latLon.getLat(), latLon.getLon());
+}
+
+std::auto_ptr<Data> ChipExtractor::cropMetadata(const Chip& chip) const
+{
+    std::auto_ptr<Data> aoiData(mData.clone());
+    DerivedData& data = static_cast<DerivedData&>(*aoiData);
+
+    // Reflect the new GeometricChip
+    // Note that it's possible this SIDD is already a chip itself,
+    // so we need to convert all coordinates in the current SIDD back
+    // to full image coordinates via chipToFull()
+    GeometricChip geometricChip;
+    geometricChip.chipSize.row = chip.dims.row;
+    geometricChip.chipSize.col = chip.dims.col;
+    const size_t firstRow = chip.offset.row;
+    const size_t firstCol = chip.offset.col;
+    const size_t lastRow = firstRow + chip.dims.row - 1;
+    const size_t lastCol = firstCol + chip.dims.col - 1;
+
+    geometricChip.originalUpperLeftCoordinate = chipToFull(firstRow, firstCol);
+    geometricChip.originalUpperRightCoordinate = chipToFull(firstRow, lastCol);
+    geometricChip.originalLowerRightCoordinate = chipToFull(lastRow, lastCol);
+    geometricChip.originalLowerLeftCoordinate = chipToFull(lastRow, firstCol);
+
+    if (data.downstreamReprocessing.get() == NULL)
+    {
+        data.downstreamReprocessing.reset(new DownstreamReprocessing());
+    }
+    if (data.downstreamReprocessing->geometricChip.get() == NULL)
+    {
+        data.downstreamReprocessing->geometricChip.reset(new GeometricChip());
+    }
+    *data.downstreamReprocessing->geometricChip = geometricChip;
+
+    data.measurement->pixelFootprint.row = chip.dims.row;
+    data.measurement->pixelFootprint.col = chip.dims.col;
+
+    LatLonCorners corners;
+    corners.upperLeft = toLatLon(firstRow, firstCol);
+    corners.upperRight = toLatLon(firstRow, lastCol);
+    corners.lowerRight = toLatLon(lastRow, lastCol);
+    corners.lowerLeft = toLatLon(lastRow, firstCol);
+    data.setImageCorners(corners);
+
+    return aoiData;
+}
+}
+}
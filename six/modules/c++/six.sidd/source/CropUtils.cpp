@@ -24,108 +24,12 @@
 
 #include <sys/Conf.h>
 #include <except/Exception.h>
-#include <mem/ScopedArray.h>
 #include <six/NITFReadControl.h>
 #include <six/NITFWriteControl.h>
-#include <six/sidd/Utilities.h>
+#include <six/sidd/ChipExtractor.h>
 #include <six/sidd/CropUtils.h>
 #include <six/sidd/DerivedData.h>
 
-namespace
-{
-class Buffers
-{
-public:
-    Buffers()
-    {
-    }
-
-    ~Buffers()
-    {
-        for (size_t ii = 0; ii < mBuffers.size(); ++ii)
-        {
-            delete[] mBuffers[ii];
-        }
-    }
-
-    sys::ubyte* add(size_t numBytes)
-    {
-        mem::ScopedArray<sys::ubyte> buffer(new sys::ubyte[numBytes]);
-        mBuffers.push_back(buffer.get());
-        return buffer.release();
-    }
-
-    std::vector<sys::ubyte*> get() const
-    {
-        return mBuffers;
-    }
-
-private:
-    std::vector<sys::ubyte*> mBuffers;
-};
-
-class ChipCoordinateToFullImageCoordinate
-{
-public:
-    ChipCoordinateToFullImageCoordinate(const six::sidd::DerivedData& data)
-    {
-        if (data.downstreamReprocessing.get() &&
-            data.downstreamReprocessing->geometricChip.get())
-        {
-            mChip.reset(new six::sidd::GeometricChip(
-                    *data.downstreamReprocessing->geometricChip));
-        }
-    }
-
-    types::RowCol<double> operator()(const types::RowCol<double>& pos) const
-    {
-        if (mChip.get())
-        {
-            return mChip->getFullImageCoordinateFromChip(pos);
-        }
-        else
-        {
-            return pos;
-        }
-    }
-
-    types::RowCol<double> operator()(size_t row, size_t col) const
-    {
-        return operator()(types::RowCol<double>(
-                static_cast<double>(row),
-                static_cast<double>(col)));
-    }
-
-private:
-    std::auto_ptr<const six::sidd::GeometricChip> mChip;
-};
-
-class PixelToLatLon
-{
-public:
-    PixelToLatLon(const six::sidd::DerivedData& data) :
-        mGridTransform(six::sidd::Utilities::getGridECEFTransform(&data)),
-        mRefPoint(data.measurement->projection->referencePoint.rowCol),
-        mChipToFull(data)
-    {
-    }
-
-    scene::LatLon operator()(size_t row, size_t col) const
-    {
-        const scene::Vector3 ecef =
-                mGridTransform->rowColToECEF(mChipToFull(row, col));
-
-        const scene::LatLonAlt latLon(scene::Utilities::ecefToLatLon(ecef));
-        return scene::LatLon(latLon.getLat(), latLon.getLon());
-    }
-
-private:
-    const std::auto_ptr<scene::GridECEFTransform> mGridTransform;
-    const types::RowCol<double> mRefPoint;
-    const ChipCoordinateToFullImageCoordinate mChipToFull;
-};
-}
-
 namespace six
 {
 namespace sidd
@@ -146,99 +50,39 @@ void cropSIDD(const std::string& inPathname,
         throw except::Exception(Ctxt(inPathname + " is not a SIDD"));
     }
 
-    Buffers buffers;
+    const ChipExtractor::Chip chip(aoiOffset, aoiDims);
+    const std::vector<ChipExtractor::Chip> chips(1, chip);
+    std::vector<std::vector<sys::ubyte> > images;
     for (size_t ii = 0, imageNum = 0; ii < container->getNumData(); ++ii)
     {
         six::Data* const dataPtr = container->getData(ii);
         if (dataPtr->getDataType() == six::DataType::DERIVED)
         {
-            six::sidd::DerivedData* const data =
-                    reinterpret_cast<six::sidd::DerivedData*>(dataPtr);
-
-            // Make sure the AOI is in bounds
-            const types::RowCol<size_t> origDims(data->getNumRows(),
-                                                 data->getNumCols());
-            if (aoiOffset.row + aoiDims.row > origDims.row ||
-                aoiOffset.col + aoiDims.col > origDims.col)
-            {
-                throw except::Exception(Ctxt(
-                        "AOI dimensions are out of bounds"));
-            }
-
-            if (aoiDims.row < 1 || aoiDims.col < 1)
-            {
-                throw except::Exception(Ctxt("AOI must be non-empty"));
-            }
-
-            // Read in the AOI
-            const size_t numBytesPerPixel(data->getNumBytesPerPixel());
-            const size_t numBytes =
-                    origDims.row * origDims.col * numBytesPerPixel;
-            sys::ubyte* const buffer = buffers.add(numBytes);
-
-            six::Region region;
-            region.setStartRow(aoiOffset.row);
-            region.setStartCol(aoiOffset.col);
-            region.setNumRows(aoiDims.row);
-            region.setNumCols(aoiDims.col);
-            region.setBuffer(buffer);
-            reader.interleaved(region, imageNum++);
-
-            // Update to reflect the AOI in the SIX metadata
-            // Construct the pixel --> lat/lon functor first so updating this
-            // metadata won't affect its calculations
-            const PixelToLatLon pixelToLatLon(*data);
-
-            // Reflect the new GeometricChip
-            // Note that it's possible this SIDD is already a chip itself,
-            // so we need to convert all coordinates in the current SIDD back
-            // to full image coordinates via chipToFull()
-            const ChipCoordinateToFullImageCoordinate chipToFull(*data);
-
-            GeometricChip chip;
-            chip.chipSize.row = aoiDims.row;
-            chip.chipSize.col = aoiDims.col;
-            const size_t lastRow = aoiOffset.row + aoiDims.row - 1;
-            const size_t lastCol = aoiOffset.col + aoiDims.col - 1;
-
-            chip.originalUpperLeftCoordinate =
-                    chipToFull(aoiOffset.row, aoiOffset.col);
-
-            chip.originalUpperRightCoordinate =
-                    chipToFull(aoiOffset.row, lastCol);
-
-            chip.originalLowerRightCoordinate = chipToFull(lastRow, lastCol);
-
-            chip.originalLowerLeftCoordinate =
-                    chipToFull(lastRow, aoiOffset.col);
-
-            if (data->downstreamReprocessing.get() == NULL)
-            {
-                data->downstreamReprocessing.reset(
-                        new six::sidd::DownstreamReprocessing());
-            }
-            if (data->downstreamReprocessing->geometricChip.get() == NULL)
+            // Read in the AOI and update to reflect it in the SIX metadata.
+            // The metadata is updated in place to keep the product's legend.
+            std::vector<std::vector<sys::ubyte> > buffers;
+            std::auto_ptr<six::Data> aoiData;
             {
-                data->downstreamReprocessing->geometricChip.reset(
-                        new six::sidd::GeometricChip());
+                const ChipExtractor extractor(reader, imageNum++, 1);
+                extractor.extract(chips, buffers);
+                aoiData = extractor.cropMetadata(chip);
             }
-            *data->downstreamReprocessing->geometricChip = chip;
-
-            data->measurement->pixelFootprint.row = aoiDims.row;
-            data->measurement->pixelFootprint.col = aoiDims.col;
 
-            six::LatLonCorners corners;
-            corners.upperLeft = pixelToLatLon(aoiOffset.row, aoiOffset.col);
-            corners.upperRight = pixelToLatLon(aoiOffset.row, lastCol);
-            corners.lowerRight = pixelToLatLon(lastRow, lastCol);
-            corners.lowerLeft = pixelToLatLon(lastRow, aoiOffset.col);
-            data->setImageCorners(corners);
+            *reinterpret_cast<six::sidd::DerivedData*>(dataPtr) =
+                    *reinterpret_cast<six::sidd::DerivedData*>(aoiData.get());
+            images.push_back(std::vector<sys::ubyte>());
+            images.back().swap(buffers[0]);
         }
     }
 
     // Write the AOI SIDD out
+    six::BufferList buffers;
+    for (size_t ii = 0; ii < images.size(); ++ii)
+    {
+        buffers.push_back(&images[ii][0]);
+    }
     six::NITFWriteControl writer(container);
-    writer.save(buffers.get(), outPathname, schemaPaths);
+    writer.save(buffers, outPathname, schemaPaths);
 }
 }
 }
@@ -62,7 +62,10 @@ xml::lite::Document* DerivedXMLControl::toXMLImpl(const Data* data)
     }
 
     const DerivedData* const sidd(reinterpret_cast<const DerivedData*>(data));
-    return getParser(data->getVersion())->toXML(sidd);
+    const std::auto_ptr<DerivedXMLParser> parser(
+            getParser(data->getVersion()));
+    parser->setFullPrecisionNumbers(mFullPrecisionNumbers);
+    return parser->toXML(sidd);
 }
 
 std::auto_ptr<DerivedXMLParser>
@@ -51,6 +51,12 @@ DerivedXMLParser::DerivedXMLParser(
 {
 }
 
+void DerivedXMLParser::setFullPrecisionNumbers(bool fullPrecision)
+{
+    XMLParser::setFullPrecisionNumbers(fullPrecision);
+    mCommon->setFullPrecisionNumbers(fullPrecision);
+}
+
 void DerivedXMLParser::getAttributeList(
         const xml::lite::Attributes& attributes,
         const std::string& attributeName,
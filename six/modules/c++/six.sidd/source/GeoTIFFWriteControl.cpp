@@ -20,6 +20,7 @@
  *
  */
 
+#include <algorithm>
 #include <sstream>
 
 #include "io/FileOutputStream.h"
@@ -33,6 +34,24 @@
 using namespace six;
 using namespace six::sidd;
 
+namespace
+{
+// Width and length of the tiles
+const size_t TILE_SIZE = 256;
+
+// Room to leave for the XML and IFDs when deciding whether a file can be
+// stored as a classic TIFF
+const sys::Uint64_T METADATA_ALLOWANCE = 64 * 1024 * 1024;
+
+size_t padToTiles(size_t numElements)
+{
+    return (numElements + TILE_SIZE - 1) / TILE_SIZE * TILE_SIZE;
+}
+}
+
+const char GeoTIFFWriteControl::OPT_COMPRESS[] = "GeoTIFFCompress";
+const char GeoTIFFWriteControl::OPT_NUM_THREADS[] = "GeoTIFFNumThreads";
+
 GeoTIFFWriteControl::GeoTIFFWriteControl()
 {
     tiff::KnownTagsRegistry::getInstance().addEntry(Constants::GT_XML_KEY,
@@ -48,26 +67,13 @@ void GeoTIFFWriteControl::initialize(mem::SharedPtr<Container> container)
     // There still could be complex data in the container though, so we
     // will keep those around for later
 
-    sys::Uint64_T length = 0;
     for (size_t ii = 0; ii < container->getNumData(); ++ii)
     {
         Data* data = container->getData(ii);
         if (data->getDataType() == DataType::COMPLEX)
             mComplexData.push_back(data);
         else if (data->getDataType() == DataType::DERIVED)
-        {
-            //length = ??
-            length += (sys::Uint64_T) data->getNumBytesPerPixel()
-                    * (sys::Uint64_T) data->getNumRows()
-                    * (sys::Uint64_T) data->getNumCols();
-
-            if (length > Constants::GT_SIZE_MAX)
-                throw except::Exception(Ctxt(
-                        "Data segments are too large to be stored in " \
-                        "GeoTIFF format"));
-
             mDerivedData.push_back(data);
-        }
         else
             throw except::Exception(Ctxt(FmtX(
                     "Data element at position [%d] in container is undefined",
@@ -76,36 +82,88 @@ void GeoTIFFWriteControl::initialize(mem::SharedPtr<Container> container)
 
 }
 
+bool GeoTIFFWriteControl::isCompressed() const
+{
+    return static_cast<sys::Uint32_T>(
+            getOptions().getParameter(OPT_COMPRESS, Parameter(1))) != 0;
+}
+
+bool GeoTIFFWriteControl::isBigTIFF() const
+{
+    // Tiles are padded out to full size, and LZW can grow incompressible
+    // data by up to half since it writes 12 bit codes for 8 bit bytes
+    sys::Uint64_T length = 0;
+    for (size_t ii = 0; ii < mDerivedData.size(); ++ii)
+    {
+        const Data* const data = mDerivedData[ii];
+        length += (sys::Uint64_T) data->getNumBytesPerPixel()
+                * (sys::Uint64_T) padToTiles(data->getNumRows())
+                * (sys::Uint64_T) padToTiles(data->getNumCols());
+    }
+    if (isCompressed())
+        length += length / 2;
+
+    return length + METADATA_ALLOWANCE > Constants::GT_SIZE_MAX;
+}
+
+void GeoTIFFWriteControl::createFile(tiff::FileWriter& tiffWriter,
+                                     const std::string& toFile) const
+{
+    tiffWriter.openFile(toFile);
+    tiffWriter.setBigTIFF(isBigTIFF());
+    tiffWriter.writeHeader();
+}
+
+tiff::ImageWriter* GeoTIFFWriteControl::addImage(
+        tiff::FileWriter& tiffWriter,
+        const DerivedData* data,
+        const std::string& toFile,
+        const std::vector<std::string>& schemaPaths)
+{
+    tiff::ImageWriter* const imageWriter = tiffWriter.addImage();
+    setupIFD(data, imageWriter->getIFD(), sys::Path::splitExt(toFile).first,
+             schemaPaths);
+
+    imageWriter->setImageFormat(tiff::ImageWriter::TILED);
+    imageWriter->setIdealChunkSize(static_cast<sys::Uint32_T>(
+            TILE_SIZE * TILE_SIZE * data->getNumBytesPerPixel()));
+    imageWriter->setNumThreads(static_cast<sys::Uint32_T>(
+            getOptions().getParameter(OPT_NUM_THREADS, Parameter(0))));
+    return imageWriter;
+}
+
 void GeoTIFFWriteControl::save(const SourceList& sources,
                                const std::string& toFile,
                                const std::vector<std::string>& schemaPaths)
 {
-    tiff::FileWriter tiffWriter(toFile);
-
-    tiffWriter.writeHeader();
     if (sources.size() != mDerivedData.size())
         throw except::Exception(Ctxt(FmtX(
                 "Meta-data count [%d] does not match source list [%d]",
                 mDerivedData.size(), sources.size())));
 
+    tiff::FileWriter tiffWriter;
+    createFile(tiffWriter, toFile);
+
     std::vector<unsigned char> buf;
     for (size_t ii = 0; ii < sources.size(); ++ii)
     {
-        tiff::ImageWriter* const imageWriter = tiffWriter.addImage();
         const DerivedData* const data =
             reinterpret_cast<DerivedData*>(mDerivedData[ii]);
+        tiff::ImageWriter* const imageWriter =
+            addImage(tiffWriter, data, toFile, schemaPaths);
         const size_t oneRow =
             data->getNumCols() * data->getNumBytesPerPixel();
-        tiff::IFD* ifd = imageWriter->getIFD();
-        setupIFD(data, ifd, sys::Path::splitExt(toFile).first, schemaPaths);
-        buf.resize(oneRow);
         const size_t numRows = data->getNumRows();
         const size_t numCols = data->getNumCols();
 
-        for (size_t row = 0; row < numRows; ++row)
+        // Read a row of tiles at a time
+        buf.resize(oneRow * std::min(TILE_SIZE, numRows));
+        for (size_t row = 0; row < numRows; row += TILE_SIZE)
         {
-            sources[ii]->read((sys::byte*)&buf[0], oneRow);
-            imageWriter->putData(&buf[0], numCols);
+            const size_t numRowsToWrite = std::min(TILE_SIZE, numRows - row);
+            sources[ii]->read((sys::byte*)&buf[0], oneRow * numRowsToWrite);
+            imageWriter->putData(&buf[0], static_cast<sys::Uint32_T>(
+                    numRowsToWrite * numCols));
         }
         imageWriter->writeIFD();
     }
@@ -193,8 +251,23 @@ void GeoTIFFWriteControl::setupIFD(const DerivedData* data,
                    "Artist",
                    data->productCreation->processorInformation.site);
 
-    ifd->addEntry(tiff::KnownTags::COMPRESSION,
-                  (unsigned short) tiff::Const::CompressionType::NO_COMPRESSION);
+    if (isCompressed())
+    {
+        ifd->addEntry(tiff::KnownTags::COMPRESSION,
+                      (unsigned short) tiff::Const::CompressionType::LZW);
+
+        // Differencing neighboring lookup table indices doesn't help
+        if (pixelType != PixelType::RGB8LU)
+        {
+            unsigned short predictor(2);
+            ifd->addEntry("Predictor", predictor);
+        }
+    }
+    else
+    {
+        ifd->addEntry(tiff::KnownTags::COMPRESSION,
+                      (unsigned short) tiff::Const::CompressionType::NO_COMPRESSION);
+    }
 
     // Only GGD pixel space is supported
     if (!data->measurement.get() || !data->measurement->projection.get())
@@ -228,12 +301,18 @@ void GeoTIFFWriteControl::setupIFD(const DerivedData* data,
     }
     tiff::IFDEntry* const xmlEntry = (*ifd)[Constants::GT_XML_TAG];
 
-    xmlEntry->addValues(six::toValidXMLString(data, schemaPaths, mLog));
+    const bool fullPrecisionNumbers = static_cast<int>(
+            getOptions().getParameter(
+                    six::WriteControl::OPT_FULL_PRECISION_NUMBERS,
+                    Parameter(0))) != 0;
+    xmlEntry->addValues(six::toValidXMLString(data, schemaPaths, mLog, NULL,
+                                              fullPrecisionNumbers));
 
     for (size_t jj = 0; jj < mComplexData.size(); ++jj)
     {
         xmlEntry->addValues(six::toValidXMLString(mComplexData[jj],
-                                                  schemaPaths, mLog));
+                                                  schemaPaths, mLog, NULL,
+                                                  fullPrecisionNumbers));
     }
 }
 
@@ -241,26 +320,32 @@ void GeoTIFFWriteControl::save(const BufferList& sources,
                                const std::string& toFile,
                                const std::vector<std::string>& schemaPaths)
 {
-    tiff::FileWriter tiffWriter(toFile);
-
-    tiffWriter.writeHeader();
     if (sources.size() != mDerivedData.size())
         throw except::Exception(Ctxt(FmtX(
                 "Meta-data count [%d] does not match source list [%d]",
                 mDerivedData.size(), sources.size())));
 
+    tiff::FileWriter tiffWriter;
+    createFile(tiffWriter, toFile);
+
     for (size_t ii = 0; ii < sources.size(); ++ii)
     {
+        const DerivedData* const data = (DerivedData*) mDerivedData[ii];
+        tiff::ImageWriter* const imageWriter =
+            addImage(tiffWriter, data, toFile, schemaPaths);
+        const size_t oneRow =
+            data->getNumCols() * data->getNumBytesPerPixel();
+        const size_t numRows = data->getNumRows();
+        const size_t numCols = data->getNumCols();
 
-        tiff::ImageWriter* imageWriter = tiffWriter.addImage();
-        tiff::IFD* ifd = imageWriter->getIFD();
-
-        DerivedData* data = (DerivedData*) mDerivedData[ii];
-        setupIFD(data, ifd, sys::Path::splitExt(toFile).first, schemaPaths);
-        // Now we hack to write
-
-        imageWriter->putData(sources[ii], data->getNumRows()
-                * data->getNumCols());
+        // Write a row of tiles at a time so the element count fits
+        for (size_t row = 0; row < numRows; row += TILE_SIZE)
+        {
+            const size_t numRowsToWrite = std::min(TILE_SIZE, numRows - row);
+            imageWriter->putData(sources[ii] + row * oneRow,
+                                 static_cast<sys::Uint32_T>(
+                                         numRowsToWrite * numCols));
+        }
 
         imageWriter->writeIFD();
     }
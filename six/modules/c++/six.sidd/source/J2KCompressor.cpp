@@ -0,0 +1,860 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <sstream>
+
+#include <except/Exception.h>
+#include <mt/ThreadGroup.h>
+#include <nitf/ImageSegmentComputer.h>
+#include <sys/AtomicCounter.h>
+#include <sys/OS.h>
+#include <sys/Runnable.h>
+#include <str/Convert.h>
+#include <six/Types.h>
+#include <six/sidd/J2KCompressor.h>
+
+#ifdef HAVE_J2K_H
+#include <import/j2k.h>
+#endif
+
+namespace
+{
+// Codestream markers we need to find our way around.  All markers are two
+// bytes, the first of which is always 0xFF.
+const sys::ubyte MARKER_PREFIX = 0xFF;
+const sys::ubyte SOC = 0x4F;
+const sys::ubyte SIZ = 0x51;
+const sys::ubyte SOT = 0x90;
+const sys::ubyte EOC = 0xD9;
+
+// Offsets of fields we patch, relative to the start of their marker
+const size_t SIZ_XSIZ_OFFSET = 6;
+const size_t SIZ_YSIZ_OFFSET = 10;
+const size_t SIZ_XTSIZ_OFFSET = 22;
+const size_t SIZ_YTSIZ_OFFSET = 26;
+const size_t SIZ_LENGTH = 38;
+const size_t SOT_ISOT_OFFSET = 4;
+const size_t SOT_PSOT_OFFSET = 6;
+const size_t SOT_LENGTH = 12;
+
+// OpenJPEG's default code-blocks are 64x64
+const size_t CODE_BLOCK_LOG2 = 6;
+
+// OpenJPEG's default of 6 resolutions
+const size_t MAX_DECOMPOSITION_LEVELS = 5;
+
+// Marks a job that compresses a whole segment
+const size_t ALL_BLOCKS = static_cast<size_t>(-1);
+
+size_t readUint16(const sys::ubyte* ptr)
+{
+    return (static_cast<size_t>(ptr[0]) << 8) | ptr[1];
+}
+
+size_t readUint32(const sys::ubyte* ptr)
+{
+    return (readUint16(ptr) << 16) | readUint16(ptr + 2);
+}
+
+void writeUint16(size_t value, sys::ubyte* ptr)
+{
+    ptr[0] = static_cast<sys::ubyte>(value >> 8);
+    ptr[1] = static_cast<sys::ubyte>(value);
+}
+
+void writeUint32(size_t value, sys::ubyte* ptr)
+{
+    writeUint16(value >> 16, ptr);
+    writeUint16(value & 0xFFFF, ptr + 2);
+}
+
+bool isMarker(const std::vector<sys::ubyte>& codestream,
+              size_t offset,
+              sys::ubyte marker)
+{
+    return offset + 2 <= codestream.size() &&
+           codestream[offset] == MARKER_PREFIX &&
+           codestream[offset + 1] == marker;
+}
+
+struct TilePart
+{
+    size_t offset;
+    size_t numBytes;
+    size_t tileIndex;
+};
+
+/*
+ * Locates the main header, the tile-parts, and the end of codestream marker
+ * in a codestream
+ */
+struct CodestreamLayout
+{
+    explicit CodestreamLayout(const std::vector<sys::ubyte>& codestream) :
+        numHeaderBytes(0),
+        sizOffset(0),
+        numTrailerBytes(0)
+    {
+        if (!isMarker(codestream, 0, SOC))
+        {
+            throw except::Exception(Ctxt(
+                    "J2K codestream doesn't begin with an SOC marker"));
+        }
+
+        // Marker segments in the main header are each followed by their
+        // length, which doesn't include the marker itself
+        size_t offset = 2;
+        while (!isMarker(codestream, offset, SOT))
+        {
+            if (offset + 4 > codestream.size() ||
+                codestream[offset] != MARKER_PREFIX)
+            {
+                throw except::Exception(Ctxt(
+                        "Malformed J2K main header"));
+            }
+            if (codestream[offset + 1] == SIZ)
+            {
+                sizOffset = offset;
+            }
+            offset += 2 + readUint16(&codestream[offset + 2]);
+        }
+        if (sizOffset == 0 || sizOffset + SIZ_LENGTH > offset)
+        {
+            throw except::Exception(Ctxt(
+                    "J2K main header has no SIZ marker"));
+        }
+        numHeaderBytes = offset;
+
+        // Each tile-part's length includes its SOT marker.  A length of 0
+        // means it runs to the end of the codestream.
+        while (isMarker(codestream, offset, SOT))
+        {
+            if (offset + SOT_LENGTH > codestream.size())
+            {
+                throw except::Exception(Ctxt("Truncated J2K tile-part"));
+            }
+
+            TilePart tilePart;
+            tilePart.offset = offset;
+            tilePart.tileIndex =
+                    readUint16(&codestream[offset + SOT_ISOT_OFFSET]);
+            tilePart.numBytes =
+                    readUint32(&codestream[offset + SOT_PSOT_OFFSET]);
+            if (tilePart.numBytes == 0)
+            {
+                tilePart.numBytes = codestream.size() - 2 - offset;
+            }
+            if (tilePart.numBytes < SOT_LENGTH ||
+                offset + tilePart.numBytes > codestream.size())
+            {
+                throw except::Exception(Ctxt("Truncated J2K tile-part"));
+            }
+
+            tileParts.push_back(tilePart);
+            offset += tilePart.numBytes;
+        }
+
+        if (!isMarker(codestream, offset, EOC))
+        {
+            throw except::Exception(Ctxt(
+                    "J2K codestream doesn't end with an EOC marker"));
+        }
+        numTrailerBytes = codestream.size() - offset;
+    }
+
+    //! Adds up the tile-parts of each tile
+    void countBytesPerTile(size_t numTiles,
+                           std::vector<size_t>& bytesPerTile) const
+    {
+        bytesPerTile.assign(numTiles, 0);
+        for (size_t ii = 0; ii < tileParts.size(); ++ii)
+        {
+            const TilePart& tilePart = tileParts[ii];
+
+            // Blocks are read back by offset, so each tile's tile-parts
+            // need to be together and in order
+            if (tilePart.tileIndex >= numTiles ||
+                (ii > 0 && tilePart.tileIndex < tileParts[ii - 1].tileIndex))
+            {
+                std::ostringstream ostr;
+                ostr << "Unexpected J2K tile " << tilePart.tileIndex
+                     << " in a codestream with " << numTiles << " tiles";
+                throw except::Exception(Ctxt(ostr.str()));
+            }
+            bytesPerTile[tilePart.tileIndex] += tilePart.numBytes;
+        }
+
+        for (size_t ii = 0; ii < numTiles; ++ii)
+        {
+            if (bytesPerTile[ii] == 0)
+            {
+                throw except::Exception(Ctxt(
+                        "J2K codestream is missing tile " +
+                        str::toString(ii)));
+            }
+        }
+    }
+
+    size_t numHeaderBytes;
+    size_t sizOffset;
+    std::vector<TilePart> tileParts;
+    size_t numTrailerBytes;
+};
+
+size_t floorLog2(size_t value)
+{
+    size_t log2 = 0;
+    while ((value >> (log2 + 1)) != 0)
+    {
+        ++log2;
+    }
+    return log2;
+}
+
+bool isPowerOfTwo(size_t value)
+{
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+//! One image segment to compress
+struct Segment
+{
+    Segment(const sys::ubyte* segmentData,
+            const types::RowCol<size_t>& segmentDims,
+            const types::RowCol<size_t>& requestedBlockDims) :
+        imageData(segmentData),
+        dims(segmentDims),
+        blockDims(requestedBlockDims.row == 0 ? segmentDims.row :
+                          requestedBlockDims.row,
+                  requestedBlockDims.col == 0 ? segmentDims.col :
+                          requestedBlockDims.col),
+        numBlocks((dims.row + blockDims.row - 1) / blockDims.row,
+                  (dims.col + blockDims.col - 1) / blockDims.col),
+        compressBlocksSeparately(false)
+    {
+        // Tiles only come out the same compressed separately if they start
+        // on a code-block boundary in every subband, and if there's more
+        // than one tile, on a multiple of 2^levels so the wavelet transform
+        // splits them the same way.  Powers of two meet both as long as
+        // there are few enough decomposition levels.
+        const bool isSplit[] = {numBlocks.row > 1, numBlocks.col > 1};
+        const size_t blockSizes[] = {blockDims.row, blockDims.col};
+        const size_t imageSizes[] = {dims.row, dims.col};
+
+        size_t numLevels = MAX_DECOMPOSITION_LEVELS;
+        for (size_t ii = 0; ii < 2; ++ii)
+        {
+            size_t maxLevels = floorLog2(imageSizes[ii]);
+            if (isSplit[ii])
+            {
+                const size_t log2 = floorLog2(blockSizes[ii]);
+                maxLevels = (log2 > CODE_BLOCK_LOG2) ?
+                        log2 - CODE_BLOCK_LOG2 : 0;
+            }
+            numLevels = std::min(numLevels, maxLevels);
+        }
+        numResolutions = numLevels + 1;
+
+        canCompressBlocksSeparately =
+                numBlocks.area() > 1 &&
+                (!isSplit[0] || isPowerOfTwo(blockDims.row)) &&
+                (!isSplit[1] || isPowerOfTwo(blockDims.col));
+    }
+
+    //! \return Actual size of a block after trimming at the image edge
+    types::RowCol<size_t> getBlockDims(size_t blockIndex) const
+    {
+        const size_t firstRow = (blockIndex / numBlocks.col) * blockDims.row;
+        const size_t firstCol = (blockIndex % numBlocks.col) * blockDims.col;
+        return types::RowCol<size_t>(
+                std::min(blockDims.row, dims.row - firstRow),
+                std::min(blockDims.col, dims.col - firstCol));
+    }
+
+    /*!
+     * Copies a block to the start of a buffer with room for a whole block,
+     * padding with zeros at the image edge
+     */
+    void copyBlock(size_t blockIndex,
+                   size_t numBytesPerPixel,
+                   std::vector<sys::ubyte>& buffer) const
+    {
+        const size_t firstRow = (blockIndex / numBlocks.col) * blockDims.row;
+        const size_t firstCol = (blockIndex % numBlocks.col) * blockDims.col;
+        const types::RowCol<size_t> trimmedDims = getBlockDims(blockIndex);
+
+        const size_t inStride = dims.col * numBytesPerPixel;
+        const size_t outStride = blockDims.col * numBytesPerPixel;
+        const size_t numBytesToCopy = trimmedDims.col * numBytesPerPixel;
+
+        buffer.resize(blockDims.area() * numBytesPerPixel);
+        if (trimmedDims.row < blockDims.row ||
+            trimmedDims.col < blockDims.col)
+        {
+            std::fill(buffer.begin(), buffer.end(), 0);
+        }
+
+        const sys::ubyte* in = imageData + firstRow * inStride +
+                firstCol * numBytesPerPixel;
+        sys::ubyte* out = &buffer[0];
+        for (size_t row = 0; row < trimmedDims.row;
+             ++row, in += inStride, out += outStride)
+        {
+            std::memcpy(out, in, numBytesToCopy);
+        }
+    }
+
+    const sys::ubyte* imageData;
+    types::RowCol<size_t> dims;
+    types::RowCol<size_t> blockDims;
+    types::RowCol<size_t> numBlocks;
+    size_t numResolutions;
+    bool canCompressBlocksSeparately;
+    bool compressBlocksSeparately;
+
+    //! One per block if compressed separately, otherwise just one
+    std::vector<std::vector<sys::ubyte> > codestreams;
+};
+
+#ifdef HAVE_J2K_H
+void throwJ2KError(const std::string& what, const nrt_Error& error)
+{
+    throw except::Exception(Ctxt(what + ": " + error.message));
+}
+
+//! Owns the J2K objects used to compress one codestream
+class J2KWriter
+{
+public:
+    J2KWriter(const types::RowCol<size_t>& dims,
+              const types::RowCol<size_t>& tileDims,
+              size_t numBytesPerPixel,
+              size_t numResolutions) :
+        mContainer(NULL),
+        mWriter(NULL),
+        mMaxCodestreamBytes(getMaxCodestreamBytes(dims, tileDims,
+                                                  numBytesPerPixel))
+    {
+        nrt_Error error = nrt_Error();
+
+        // The container takes ownership of the components
+        j2k_Component** const components = static_cast<j2k_Component**>(
+                J2K_MALLOC(sizeof(j2k_Component*)));
+        if (!components)
+        {
+            throw except::Exception(Ctxt("Unable to allocate J2K component"));
+        }
+
+        components[0] = j2k_Component_construct(
+                static_cast<nrt_Uint32>(dims.col),
+                static_cast<nrt_Uint32>(dims.row),
+                static_cast<nrt_Uint32>(numBytesPerPixel * 8),
+                NRT_FALSE, 0, 0, 1, 1, &error);
+        if (components[0])
+        {
+            mContainer = j2k_Container_construct(
+                    static_cast<nrt_Uint32>(dims.col),
+                    static_cast<nrt_Uint32>(dims.row),
+                    1, components,
+                    static_cast<nrt_Uint32>(tileDims.col),
+                    static_cast<nrt_Uint32>(tileDims.row),
+                    J2K_TYPE_MONO, &error);
+        }
+        if (!mContainer)
+        {
+            if (components[0])
+            {
+                j2k_Component_destruct(&components[0]);
+            }
+            J2K_FREE(components);
+            throwJ2KError("Unable to create J2K container", error);
+        }
+
+        j2k_WriterOptions options;
+        std::memset(&options, 0, sizeof(options));
+        options.numResolutions = static_cast<nrt_Uint32>(numResolutions);
+
+        mWriter = j2k_Writer_construct(mContainer, &options, &error);
+        if (!mWriter)
+        {
+            j2k_Container_destruct(&mContainer);
+            throwJ2KError("Unable to create J2K writer", error);
+        }
+    }
+
+    ~J2KWriter()
+    {
+        j2k_Writer_destruct(&mWriter);
+        j2k_Container_destruct(&mContainer);
+    }
+
+    //! Tiles must be set in order
+    void setTile(size_t tileIndex,
+                 size_t numTilesPerRow,
+                 const std::vector<sys::ubyte>& tile)
+    {
+        nrt_Error error = nrt_Error();
+        if (!j2k_Writer_setTile(mWriter,
+                                static_cast<nrt_Uint32>(
+                                        tileIndex % numTilesPerRow),
+                                static_cast<nrt_Uint32>(
+                                        tileIndex / numTilesPerRow),
+                                &tile[0],
+                                static_cast<nrt_Uint32>(tile.size()),
+                                &error))
+        {
+            throwJ2KError("Unable to compress J2K tile", error);
+        }
+    }
+
+    void write(std::vector<sys::ubyte>& codestream)
+    {
+        codestream.resize(mMaxCodestreamBytes);
+
+        nrt_Error error = nrt_Error();
+        nrt_IOInterface* io = nrt_BufferAdapter_construct(
+                reinterpret_cast<char*>(&codestream[0]),
+                codestream.size(), NRT_FALSE, &error);
+        if (!io)
+        {
+            throwJ2KError("Unable to create J2K output buffer", error);
+        }
+
+        const bool written = j2k_Writer_write(mWriter, io, &error);
+        const nrt_Off numBytes = written ? nrt_IOInterface_tell(io, &error) :
+                                           -1;
+        nrt_IOInterface_destruct(&io);
+        if (!NRT_IO_SUCCESS(numBytes))
+        {
+            throwJ2KError("Unable to write J2K codestream", error);
+        }
+        codestream.resize(static_cast<size_t>(numBytes));
+    }
+
+private:
+    J2KWriter(const J2KWriter&);
+    J2KWriter& operator=(const J2KWriter&);
+
+    /*
+     * Small or incompressible images can come out bigger than their pixels
+     * once the main header, tile-part headers and packet headers are
+     * added.  Leave room for all of them, plus some expansion of the data
+     * itself, so that valid input never overflows the output buffer.
+     */
+    static size_t getMaxCodestreamBytes(const types::RowCol<size_t>& dims,
+                                        const types::RowCol<size_t>& tileDims,
+                                        size_t numBytesPerPixel)
+    {
+        const size_t numUncompressedBytes = dims.area() * numBytesPerPixel;
+        const size_t numTiles =
+                ((dims.row + tileDims.row - 1) / tileDims.row) *
+                ((dims.col + tileDims.col - 1) / tileDims.col);
+        return numUncompressedBytes + numUncompressedBytes / 16 +
+                numTiles * TILE_HEADER_MARGIN + MAIN_HEADER_MARGIN;
+    }
+
+    static const size_t MAIN_HEADER_MARGIN = 16384;
+    static const size_t TILE_HEADER_MARGIN = 1024;
+
+private:
+    j2k_Container* mContainer;
+    j2k_Writer* mWriter;
+    const size_t mMaxCodestreamBytes;
+};
+
+/*
+ * Compress either a single block as a codestream of its own, or the whole
+ * segment
+ */
+void compressCodestream(const Segment& segment,
+                        size_t numBytesPerPixel,
+                        size_t blockIndex,
+                        std::vector<sys::ubyte>& codestream)
+{
+    const bool isWholeSegment = (blockIndex == ALL_BLOCKS);
+    const size_t firstBlock = isWholeSegment ? 0 : blockIndex;
+    const size_t endBlock = isWholeSegment ? segment.numBlocks.area() :
+                                             blockIndex + 1;
+    const size_t numTilesPerRow = isWholeSegment ? segment.numBlocks.col : 1;
+
+    // The tile size stays the same for a lone block so that partial blocks
+    // at the image edge are trimmed the same way
+    J2KWriter writer(isWholeSegment ? segment.dims :
+                                      segment.getBlockDims(blockIndex),
+                     segment.blockDims,
+                     numBytesPerPixel,
+                     segment.numResolutions);
+
+    std::vector<sys::ubyte> block;
+    for (size_t ii = firstBlock; ii < endBlock; ++ii)
+    {
+        segment.copyBlock(ii, numBytesPerPixel, block);
+        writer.setTile(ii - firstBlock, numTilesPerRow, block);
+    }
+    writer.write(codestream);
+}
+#else
+void compressCodestream(const Segment& ,
+                        size_t ,
+                        size_t ,
+                        std::vector<sys::ubyte>& )
+{
+    throw except::Exception(Ctxt("SIX was built without J2K support"));
+}
+#endif
+
+struct Job
+{
+    Job(size_t segmentIndex, size_t blockIndex) :
+        segment(segmentIndex),
+        block(blockIndex)
+    {
+    }
+
+    size_t segment;
+    size_t block;
+};
+
+class CompressRunnable : public sys::Runnable
+{
+public:
+    CompressRunnable(const std::vector<Job>& jobs,
+                     size_t numBytesPerPixel,
+                     sys::AtomicCounter& nextJob,
+                     std::vector<Segment>& segments) :
+        mJobs(jobs),
+        mNumBytesPerPixel(numBytesPerPixel),
+        mNextJob(nextJob),
+        mSegments(segments)
+    {
+    }
+
+    virtual void run()
+    {
+        while (true)
+        {
+            const size_t index =
+                    static_cast<size_t>(mNextJob.getThenIncrement());
+            if (index >= mJobs.size())
+            {
+                break;
+            }
+
+            const Job& job = mJobs[index];
+            Segment& segment = mSegments[job.segment];
+            if (job.block == ALL_BLOCKS)
+            {
+                compressCodestream(segment, mNumBytesPerPixel, job.block,
+                                   segment.codestreams[0]);
+                continue;
+            }
+
+            // If a block can't be compressed on its own, leave it empty and
+            // the whole segment gets compressed instead
+            std::vector<sys::ubyte>& codestream =
+                    segment.codestreams[job.block];
+            try
+            {
+                compressCodestream(segment, mNumBytesPerPixel, job.block,
+                                   codestream);
+            }
+            catch (const except::Exception&)
+            {
+                codestream.clear();
+            }
+        }
+    }
+
+private:
+    const std::vector<Job>& mJobs;
+    const size_t mNumBytesPerPixel;
+    sys::AtomicCounter& mNextJob;
+    std::vector<Segment>& mSegments;
+};
+
+/*
+ * Joins separately compressed blocks into one codestream.  The main header
+ * comes from the first block with the image size patched in, and every
+ * tile-part is renumbered with its block's index.
+ */
+void stitchCodestream(const Segment& segment,
+                      std::vector<sys::ubyte>& compressed,
+                      std::vector<size_t>& bytesPerBlock)
+{
+    const size_t numBlocks = segment.codestreams.size();
+    bytesPerBlock.resize(numBlocks);
+
+    const std::vector<sys::ubyte>& first = segment.codestreams[0];
+    const CodestreamLayout firstLayout(first);
+    const size_t headerOffset = compressed.size();
+    compressed.insert(compressed.end(), first.begin(),
+                      first.begin() + firstLayout.numHeaderBytes);
+
+    sys::ubyte* const siz = &compressed[headerOffset + firstLayout.sizOffset];
+    writeUint32(segment.dims.col, siz + SIZ_XSIZ_OFFSET);
+    writeUint32(segment.dims.row, siz + SIZ_YSIZ_OFFSET);
+    writeUint32(segment.blockDims.col, siz + SIZ_XTSIZ_OFFSET);
+    writeUint32(segment.blockDims.row, siz + SIZ_YTSIZ_OFFSET);
+
+    for (size_t ii = 0; ii < numBlocks; ++ii)
+    {
+        const std::vector<sys::ubyte>& codestream = segment.codestreams[ii];
+        const CodestreamLayout layout(codestream);
+
+        std::vector<size_t> bytesPerTile;
+        layout.countBytesPerTile(1, bytesPerTile);
+        bytesPerBlock[ii] = bytesPerTile[0];
+
+        for (size_t jj = 0; jj < layout.tileParts.size(); ++jj)
+        {
+            const TilePart& tilePart = layout.tileParts[jj];
+            const size_t offset = compressed.size();
+            compressed.insert(
+                    compressed.end(),
+                    codestream.begin() + tilePart.offset,
+                    codestream.begin() + tilePart.offset + tilePart.numBytes);
+            writeUint16(ii, &compressed[offset + SOT_ISOT_OFFSET]);
+        }
+    }
+
+    compressed.push_back(MARKER_PREFIX);
+    compressed.push_back(EOC);
+
+    bytesPerBlock.front() += firstLayout.numHeaderBytes;
+    bytesPerBlock.back() += 2;
+}
+
+void splitCodestream(const Segment& segment,
+                     std::vector<sys::ubyte>& compressed,
+                     std::vector<size_t>& bytesPerBlock)
+{
+    const std::vector<sys::ubyte>& codestream = segment.codestreams[0];
+    const CodestreamLayout layout(codestream);
+    layout.countBytesPerTile(segment.numBlocks.area(), bytesPerBlock);
+    bytesPerBlock.front() += layout.numHeaderBytes;
+    bytesPerBlock.back() += layout.numTrailerBytes;
+
+    compressed.insert(compressed.end(), codestream.begin(), codestream.end());
+}
+
+void runJobs(const std::vector<Job>& jobs,
+             size_t numBytesPerPixel,
+             size_t numThreads,
+             std::vector<Segment>& segments)
+{
+    numThreads = std::min(numThreads, jobs.size());
+
+    sys::AtomicCounter nextJob;
+    if (numThreads <= 1)
+    {
+        CompressRunnable(jobs, numBytesPerPixel, nextJob, segments).run();
+    }
+    else
+    {
+        mt::ThreadGroup threads;
+        for (size_t ii = 0; ii < numThreads; ++ii)
+        {
+            std::auto_ptr<sys::Runnable> runnable(new CompressRunnable(
+                    jobs, numBytesPerPixel, nextJob, segments));
+            threads.createThread(runnable);
+        }
+        threads.joinAll();
+    }
+}
+
+void compressSegments(std::vector<Segment>& segments,
+                      size_t numBytesPerPixel,
+                      size_t numThreads,
+                      std::vector<sys::ubyte>& compressed,
+                      std::vector<std::vector<size_t> >& bytesPerBlock)
+{
+    if (!six::sidd::J2KCompressor::isAvailable())
+    {
+        throw except::Exception(Ctxt("SIX was built without J2K support"));
+    }
+    if (numBytesPerPixel != 1 && numBytesPerPixel != 2)
+    {
+        throw except::Exception(Ctxt(
+                "J2K compression supports 1 or 2 bytes per pixel, not " +
+                str::toString(numBytesPerPixel)));
+    }
+
+    if (numThreads == 0)
+    {
+        numThreads = sys::OS().getNumCPUsAvailable();
+    }
+
+    // Whole segments go first since they take the longest
+    std::vector<Job> jobs;
+    for (size_t ii = 0; ii < segments.size(); ++ii)
+    {
+        Segment& segment = segments[ii];
+        segment.compressBlocksSeparately =
+                numThreads > 1 && segment.canCompressBlocksSeparately;
+        if (!segment.compressBlocksSeparately)
+        {
+            segment.codestreams.resize(1);
+            jobs.push_back(Job(ii, ALL_BLOCKS));
+        }
+    }
+    for (size_t ii = 0; ii < segments.size(); ++ii)
+    {
+        Segment& segment = segments[ii];
+        if (segment.compressBlocksSeparately)
+        {
+            segment.codestreams.resize(segment.numBlocks.area());
+            for (size_t block = 0; block < segment.codestreams.size(); ++block)
+            {
+                jobs.push_back(Job(ii, block));
+            }
+        }
+    }
+    runJobs(jobs, numBytesPerPixel, numThreads, segments);
+
+    // Fall back to compressing the whole segment wherever a block
+    // couldn't be compressed on its own
+    jobs.clear();
+    for (size_t ii = 0; ii < segments.size(); ++ii)
+    {
+        Segment& segment = segments[ii];
+        if (segment.compressBlocksSeparately)
+        {
+            for (size_t block = 0; block < segment.codestreams.size(); ++block)
+            {
+                if (segment.codestreams[block].empty())
+                {
+                    segment.compressBlocksSeparately = false;
+                    segment.codestreams.resize(1);
+                    jobs.push_back(Job(ii, ALL_BLOCKS));
+                    break;
+                }
+            }
+        }
+    }
+    runJobs(jobs, numBytesPerPixel, numThreads, segments);
+
+    compressed.clear();
+    bytesPerBlock.resize(segments.size());
+    for (size_t ii = 0; ii < segments.size(); ++ii)
+    {
+        Segment& segment = segments[ii];
+        if (segment.compressBlocksSeparately)
+        {
+            stitchCodestream(segment, compressed, bytesPerBlock[ii]);
+        }
+        else
+        {
+            splitCodestream(segment, compressed, bytesPerBlock[ii]);
+        }
+
+        // Free each segment's pieces as we go so we don't hold two copies
+        // of the whole compressed image
+        std::vector<std::vector<sys::ubyte> >().swap(segment.codestreams);
+    }
+}
+}
+
+namespace six
+{
+namespace sidd
+{
+J2KCompressor::J2KCompressor(size_t numThreads) :
+    mNumThreads(numThreads)
+{
+}
+
+bool J2KCompressor::isAvailable()
+{
+#ifdef HAVE_J2K_H
+    return true;
+#else
+    return false;
+#endif
+}
+
+void J2KCompressor::compress(const sys::ubyte* imageData,
+                             const types::RowCol<size_t>& dims,
+                             size_t numBytesPerPixel,
+                             const types::RowCol<size_t>& blockDims,
+                             std::vector<sys::ubyte>& compressed,
+                             std::vector<size_t>& bytesPerBlock) const
+{
+    std::vector<Segment> segments(1, Segment(imageData, dims, blockDims));
+    std::vector<std::vector<size_t> > bytesPerBlockPerSegment;
+    compressSegments(segments, numBytesPerPixel, mNumThreads,
+                     compressed, bytesPerBlockPerSegment);
+    bytesPerBlock.swap(bytesPerBlockPerSegment[0]);
+}
+
+void J2KCompressor::compress(
+        const DerivedData& data,
+        const sys::ubyte* imageData,
+        size_t numRowsPerBlock,
+        size_t numColsPerBlock,
+        size_t maxProductSize,
+        std::vector<sys::ubyte>& compressed,
+        std::vector<std::vector<size_t> >& bytesPerBlock) const
+{
+    const PixelType pixelType = data.getPixelType();
+    if (pixelType != PixelType::MONO8I && pixelType != PixelType::MONO8LU &&
+        pixelType != PixelType::RGB8LU && pixelType != PixelType::MONO16I)
+    {
+        throw except::Exception(Ctxt(
+                "J2K compression of " + pixelType.toString() +
+                " is not supported"));
+    }
+
+    // Match the layout ByteProvider will give NITFWriteControl
+    const size_t numBytesPerPixel = data.getNumBytesPerPixel();
+    const types::RowCol<size_t> dims(data.getNumRows(), data.getNumCols());
+    const types::RowCol<size_t> blockDims(
+            std::min(numRowsPerBlock, dims.row),
+            std::min(numColsPerBlock, dims.col));
+    const nitf::ImageSegmentComputer segmentComputer(
+            dims.row, dims.col, numBytesPerPixel,
+            Constants::ILOC_MAX,
+            maxProductSize == 0 ? Constants::IS_SIZE_MAX : maxProductSize,
+            blockDims.row, blockDims.col);
+
+    const std::vector<nitf::ImageSegmentComputer::Segment>& imageSegments =
+            segmentComputer.getSegments();
+    const size_t rowStride = dims.col * numBytesPerPixel;
+
+    std::vector<Segment> segments;
+    for (size_t ii = 0; ii < imageSegments.size(); ++ii)
+    {
+        // Blocks don't shrink to fit a short last segment
+        const nitf::ImageSegmentComputer::Segment& imageSegment =
+                imageSegments[ii];
+        segments.push_back(Segment(
+                imageData + imageSegment.firstRow * rowStride,
+                types::RowCol<size_t>(imageSegment.numRows, dims.col),
+                blockDims));
+    }
+
+    compressSegments(segments, numBytesPerPixel, mNumThreads,
+                     compressed, bytesPerBlock);
+}
+}
+}
@@ -0,0 +1,662 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include <mt/ThreadGroup.h>
+#include <nitf/IOHandle.hpp>
+#include <nitf/ImageSegment.hpp>
+#include <str/Manip.h>
+#include <sys/AtomicCounter.h>
+#include <sys/OS.h>
+#include <sys/Runnable.h>
+#include <six/NITFImageInfo.h>
+#include <six/sidd/J2KDecompressor.h>
+
+#ifdef HAVE_J2K_H
+#include <j2k/Reader.h>
+#endif
+
+namespace
+{
+typedef six::sidd::J2KDecompressor::Segment Segment;
+
+const sys::ubyte MARKER_PREFIX = 0xFF;
+const sys::ubyte SOC = 0x4F;
+const sys::ubyte SIZ = 0x51;
+const sys::ubyte COD = 0x52;
+const sys::ubyte SOT = 0x90;
+
+// Offsets of the marker segment fields we need, from the start of the
+// marker
+const size_t SIZ_XSIZ_OFFSET = 6;
+const size_t SIZ_YSIZ_OFFSET = 10;
+const size_t SIZ_XOSIZ_OFFSET = 14;
+const size_t SIZ_YOSIZ_OFFSET = 18;
+const size_t SIZ_XTSIZ_OFFSET = 22;
+const size_t SIZ_YTSIZ_OFFSET = 26;
+const size_t SIZ_XTOSIZ_OFFSET = 30;
+const size_t SIZ_YTOSIZ_OFFSET = 34;
+const size_t SIZ_CSIZ_OFFSET = 38;
+const size_t SIZ_SSIZ_OFFSET = 40;
+const size_t SIZ_MIN_LENGTH = 43;
+const size_t COD_DECOMPOSITION_LEVELS_OFFSET = 9;
+
+size_t readUint16(const sys::ubyte* bytes)
+{
+    return (static_cast<size_t>(bytes[0]) << 8) | bytes[1];
+}
+
+size_t readUint32(const sys::ubyte* bytes)
+{
+    return (readUint16(bytes) << 16) | readUint16(bytes + 2);
+}
+
+//! Value on the full resolution grid to value at a resolution level
+size_t reduce(size_t value, size_t resolutionLevel)
+{
+    const size_t scale = static_cast<size_t>(1) << resolutionLevel;
+    return (value + scale - 1) / scale;
+}
+
+/*
+ * Reads the codestream's main header, up to the first tile-part, to get
+ * the layout of the tiles and the number of resolution levels
+ */
+void readMainHeader(nitf::IOInterface& io,
+                    size_t numBytesPerPixel,
+                    Segment& segment)
+{
+    sys::ubyte soc[2];
+    io.read(soc, sizeof(soc));
+    if (soc[0] != MARKER_PREFIX || soc[1] != SOC)
+    {
+        throw except::Exception(Ctxt(
+                "Image segment doesn't start with a J2K codestream"));
+    }
+
+    bool foundSIZ = false;
+    bool foundCOD = false;
+    std::vector<sys::ubyte> marker(4);
+    while (true)
+    {
+        io.read(&marker[0], 4);
+        if (marker[0] != MARKER_PREFIX)
+        {
+            throw except::Exception(Ctxt("Invalid J2K main header"));
+        }
+        if (marker[1] == SOT)
+        {
+            break;
+        }
+
+        // The length includes itself but not the marker
+        const size_t length = readUint16(&marker[2]);
+        if (length < 2)
+        {
+            throw except::Exception(Ctxt("Invalid J2K main header"));
+        }
+        marker.resize(length + 2);
+        if (length > 2)
+        {
+            io.read(&marker[4], length - 2);
+        }
+
+        if (marker[1] == SIZ)
+        {
+            if (marker.size() < SIZ_MIN_LENGTH)
+            {
+                throw except::Exception(Ctxt("Invalid J2K SIZ marker"));
+            }
+            if (readUint32(&marker[SIZ_XOSIZ_OFFSET]) != 0 ||
+                readUint32(&marker[SIZ_YOSIZ_OFFSET]) != 0 ||
+                readUint32(&marker[SIZ_XTOSIZ_OFFSET]) != 0 ||
+                readUint32(&marker[SIZ_YTOSIZ_OFFSET]) != 0)
+            {
+                throw except::Exception(Ctxt(
+                        "J2K image and tile offsets are not supported"));
+            }
+            if (readUint16(&marker[SIZ_CSIZ_OFFSET]) != 1)
+            {
+                throw except::Exception(Ctxt(
+                        "Only single component J2K images are supported"));
+            }
+            const size_t numBits = (marker[SIZ_SSIZ_OFFSET] & 0x7F) + 1;
+            if ((numBits + 7) / 8 != numBytesPerPixel)
+            {
+                throw except::Exception(Ctxt(
+                        "J2K precision of " + str::toString(numBits) +
+                        " bits doesn't match the pixel type"));
+            }
+
+            segment.dims.row = readUint32(&marker[SIZ_YSIZ_OFFSET]);
+            segment.dims.col = readUint32(&marker[SIZ_XSIZ_OFFSET]);
+            segment.tileDims.row = readUint32(&marker[SIZ_YTSIZ_OFFSET]);
+            segment.tileDims.col = readUint32(&marker[SIZ_XTSIZ_OFFSET]);
+            if (segment.tileDims.row == 0 || segment.tileDims.col == 0)
+            {
+                throw except::Exception(Ctxt("Invalid J2K tile size"));
+            }
+            foundSIZ = true;
+        }
+        else if (marker[1] == COD)
+        {
+            if (marker.size() <= COD_DECOMPOSITION_LEVELS_OFFSET)
+            {
+                throw except::Exception(Ctxt("Invalid J2K COD marker"));
+            }
+            segment.numResolutionLevels =
+                    marker[COD_DECOMPOSITION_LEVELS_OFFSET] + 1;
+            foundCOD = true;
+        }
+        marker.resize(4);
+    }
+
+    if (!foundSIZ || !foundCOD)
+    {
+        throw except::Exception(Ctxt("J2K main header is incomplete"));
+    }
+}
+
+#ifdef HAVE_J2K_H
+void throwJ2KError(const std::string& what, const nrt_Error& error)
+{
+    throw except::Exception(Ctxt(what + ": " + error.message));
+}
+
+/*
+ * Decodes tiles of any of an image's segments.  J2K readers are opened as
+ * they're needed and all share one file handle since they seek before
+ * every read.
+ */
+class TileDecoder
+{
+public:
+    TileDecoder(const std::string& pathname,
+                const std::vector<Segment>& segments,
+                size_t resolutionLevel) :
+        mHandle(pathname),
+        mSegments(segments),
+        mResolutionLevel(resolutionLevel),
+        mReaders(segments.size(), static_cast<j2k_Reader*>(NULL))
+    {
+    }
+
+    ~TileDecoder()
+    {
+        for (size_t ii = 0; ii < mReaders.size(); ++ii)
+        {
+            j2k_Reader_destruct(&mReaders[ii]);
+        }
+    }
+
+    //! \return Number of bytes decoded into buffer
+    size_t decode(size_t segmentIndex,
+                  const types::RowCol<size_t>& tile,
+                  sys::ubyte* buffer)
+    {
+        nrt_Error error = nrt_Error();
+        j2k_Reader*& reader = mReaders[segmentIndex];
+        if (!reader)
+        {
+            mHandle.seek(mSegments[segmentIndex].fileOffset, NITF_SEEK_SET);
+            reader = j2k_Reader_openIO(mHandle.getNative(), &error);
+            if (!reader)
+            {
+                throwJ2KError("Unable to open J2K codestream", error);
+            }
+            if (!j2k_Reader_setResolutionReduction(
+                    reader, static_cast<nrt_Uint32>(mResolutionLevel),
+                    &error))
+            {
+                throwJ2KError("Unable to set J2K resolution", error);
+            }
+        }
+
+        nrt_Uint8* tileBuffer = buffer;
+        const nrt_Uint64 numBytes = j2k_Reader_readTile(
+                reader,
+                static_cast<nrt_Uint32>(tile.col),
+                static_cast<nrt_Uint32>(tile.row),
+                &tileBuffer,
+                &error);
+        if (numBytes == 0)
+        {
+            throwJ2KError("Unable to decode J2K tile", error);
+        }
+        return static_cast<size_t>(numBytes);
+    }
+
+private:
+    TileDecoder(const TileDecoder&);
+    TileDecoder& operator=(const TileDecoder&);
+
+private:
+    nitf::IOHandle mHandle;
+    const std::vector<Segment>& mSegments;
+    const size_t mResolutionLevel;
+    std::vector<j2k_Reader*> mReaders;
+};
+#else
+class TileDecoder
+{
+public:
+    TileDecoder(const std::string& ,
+                const std::vector<Segment>& ,
+                size_t )
+    {
+        throw except::Exception(Ctxt("SIX was built without J2K support"));
+    }
+
+    size_t decode(size_t ,
+                  const types::RowCol<size_t>& ,
+                  sys::ubyte* )
+    {
+        return 0;
+    }
+};
+#endif
+
+//! Tile of a segment, and where it lands in the image being read
+struct Job
+{
+    size_t segment;
+    types::RowCol<size_t> tile;
+
+    //! Position and size of the tile at this resolution level, in the
+    //! whole image
+    types::RowCol<size_t> offset;
+    types::RowCol<size_t> dims;
+};
+
+class DecodeRunnable : public sys::Runnable
+{
+public:
+    DecodeRunnable(const std::string& pathname,
+                   const std::vector<Segment>& segments,
+                   const std::vector<Job>& jobs,
+                   size_t numBytesPerPixel,
+                   size_t resolutionLevel,
+                   const types::RowCol<size_t>& regionOffset,
+                   const types::RowCol<size_t>& regionDims,
+                   sys::AtomicCounter& nextJob,
+                   six::UByte* buffer) :
+        mPathname(pathname),
+        mSegments(segments),
+        mJobs(jobs),
+        mNumBytesPerPixel(numBytesPerPixel),
+        mResolutionLevel(resolutionLevel),
+        mRegionOffset(regionOffset),
+        mRegionDims(regionDims),
+        mNextJob(nextJob),
+        mBuffer(buffer)
+    {
+    }
+
+    virtual void run()
+    {
+        TileDecoder decoder(mPathname, mSegments, mResolutionLevel);
+
+        // Big enough for any tile at full resolution
+        size_t maxTileBytes = 0;
+        for (size_t ii = 0; ii < mSegments.size(); ++ii)
+        {
+            maxTileBytes = std::max(maxTileBytes,
+                                    mSegments[ii].tileDims.area());
+        }
+        std::vector<sys::ubyte> tile(maxTileBytes * mNumBytesPerPixel);
+
+        const size_t outStride = mRegionDims.col * mNumBytesPerPixel;
+        while (true)
+        {
+            const size_t index =
+                    static_cast<size_t>(mNextJob.getThenIncrement());
+            if (index >= mJobs.size())
+            {
+                break;
+            }
+
+            const Job& job = mJobs[index];
+            const size_t numBytes =
+                    decoder.decode(job.segment, job.tile, &tile[0]);
+
+            // Partial tiles may come back padded out to the full tile width
+            const size_t tileStride = numBytes / job.dims.row;
+            if (tileStride < job.dims.col * mNumBytesPerPixel ||
+                tileStride * job.dims.row > tile.size())
+            {
+                throw except::Exception(Ctxt(
+                        "Decoded J2K tile is the wrong size"));
+            }
+
+            // Copy the part of the tile inside the region
+            const size_t firstRow = std::max(job.offset.row,
+                                             mRegionOffset.row);
+            const size_t endRow = std::min(job.offset.row + job.dims.row,
+                                           mRegionOffset.row +
+                                                   mRegionDims.row);
+            const size_t firstCol = std::max(job.offset.col,
+                                             mRegionOffset.col);
+            const size_t endCol = std::min(job.offset.col + job.dims.col,
+                                           mRegionOffset.col +
+                                                   mRegionDims.col);
+            const size_t numBytesPerRow =
+                    (endCol - firstCol) * mNumBytesPerPixel;
+
+            const sys::ubyte* src = &tile[0] +
+                    (firstRow - job.offset.row) * tileStride +
+                    (firstCol - job.offset.col) * mNumBytesPerPixel;
+            six::UByte* dest = mBuffer +
+                    (firstRow - mRegionOffset.row) * outStride +
+                    (firstCol - mRegionOffset.col) * mNumBytesPerPixel;
+            for (size_t row = firstRow;
+                 row < endRow;
+                 ++row, src += tileStride, dest += outStride)
+            {
+                std::memcpy(dest, src, numBytesPerRow);
+            }
+        }
+    }
+
+private:
+    const std::string& mPathname;
+    const std::vector<Segment>& mSegments;
+    const std::vector<Job>& mJobs;
+    const size_t mNumBytesPerPixel;
+    const size_t mResolutionLevel;
+    const types::RowCol<size_t> mRegionOffset;
+    const types::RowCol<size_t> mRegionDims;
+    sys::AtomicCounter& mNextJob;
+    six::UByte* const mBuffer;
+};
+
+bool overlaps(size_t start1, size_t length1, size_t start2, size_t length2)
+{
+    return start1 < start2 + length2 && start2 < start1 + length1;
+}
+}
+
+namespace six
+{
+namespace sidd
+{
+J2KDecompressor::Segment::Segment() :
+    fileOffset(0),
+    firstRow(0),
+    numResolutionLevels(0)
+{
+}
+
+J2KDecompressor::J2KDecompressor(const NITFReadControl& reader,
+                                 const std::string& pathname,
+                                 size_t numThreads) :
+    mPathname(pathname),
+    mNumThreads(numThreads == 0 ? sys::OS().getNumCPUsAvailable() :
+                                  numThreads)
+{
+    if (!isAvailable())
+    {
+        throw except::Exception(Ctxt("SIX was built without J2K support"));
+    }
+
+    const std::vector<NITFImageInfo*>& infos = reader.getInfos();
+    if (infos.empty())
+    {
+        throw except::Exception(Ctxt(
+                "No images were loaded; call load() on the reader first"));
+    }
+
+    nitf::Record record = reader.getRecord();
+    nitf::List nitfImages = record.getImages();
+    nitf::IOHandle handle(mPathname);
+
+    mImages.resize(infos.size());
+    for (size_t ii = 0; ii < infos.size(); ++ii)
+    {
+        const NITFImageInfo& info = *infos[ii];
+        const Data& data = *info.getData();
+        if (data.getPixelType() == PixelType::RGB24I)
+        {
+            throw except::Exception(Ctxt(
+                    "J2K decompression of RGB24I is not supported"));
+        }
+
+        Image& image = mImages[ii];
+        image.numBytesPerPixel = data.getNumBytesPerPixel();
+
+        // Legends come after the image's segments
+        const std::vector<NITFSegmentInfo>& infoSegments =
+                info.getImageSegments();
+        for (size_t jj = 0;
+             jj < infoSegments.size() &&
+                     infoSegments[jj].firstRow < data.getNumRows();
+             ++jj)
+        {
+            nitf::ImageSegment nitfSegment(
+                    nitfImages[info.getStartIndex() + jj]);
+            std::string compression =
+                    nitfSegment.getSubheader().getImageCompression()
+                            .toString();
+            str::trim(compression);
+            if (compression != "C8")
+            {
+                throw except::Exception(Ctxt(
+                        "Image " + str::toString(ii) + " is compressed "
+                        "with IC=" + compression + ", not C8"));
+            }
+
+            Segment segment;
+            segment.fileOffset =
+                    static_cast<nitf::Off>(nitfSegment.getImageOffset());
+            segment.firstRow = infoSegments[jj].firstRow;
+
+            handle.seek(segment.fileOffset, NITF_SEEK_SET);
+            readMainHeader(handle, image.numBytesPerPixel, segment);
+            if (segment.dims.row != infoSegments[jj].numRows ||
+                segment.dims.col != data.getNumCols())
+            {
+                throw except::Exception(Ctxt(
+                        "J2K image size doesn't match the image segment"));
+            }
+            image.segments.push_back(segment);
+        }
+    }
+}
+
+bool J2KDecompressor::isAvailable()
+{
+#ifdef HAVE_J2K_H
+    return true;
+#else
+    return false;
+#endif
+}
+
+const J2KDecompressor::Image&
+J2KDecompressor::getImage(size_t imageNumber) const
+{
+    if (imageNumber >= mImages.size())
+    {
+        throw except::Exception(Ctxt(
+                "Image " + str::toString(imageNumber) + " is out of bounds"));
+    }
+    return mImages[imageNumber];
+}
+
+size_t J2KDecompressor::getNumResolutionLevels(size_t imageNumber) const
+{
+    const std::vector<Segment>& segments = getImage(imageNumber).segments;
+    size_t numLevels = segments[0].numResolutionLevels;
+    for (size_t ii = 1; ii < segments.size(); ++ii)
+    {
+        numLevels = std::min(numLevels, segments[ii].numResolutionLevels);
+    }
+    return numLevels;
+}
+
+types::RowCol<size_t> J2KDecompressor::getDims(size_t imageNumber,
+                                               size_t resolutionLevel) const
+{
+    const std::vector<Segment>& segments = getImage(imageNumber).segments;
+
+    // Segments are reduced separately, so their rows don't necessarily add
+    // up to the reduced rows of the whole image
+    types::RowCol<size_t> dims(0, reduce(segments[0].dims.col,
+                                         resolutionLevel));
+    for (size_t ii = 0; ii < segments.size(); ++ii)
+    {
+        dims.row += reduce(segments[ii].dims.row, resolutionLevel);
+    }
+    return dims;
+}
+
+UByte* J2KDecompressor::read(Region& region,
+                             size_t imageNumber,
+                             size_t resolutionLevel) const
+{
+    const Image& image = getImage(imageNumber);
+    if (resolutionLevel >= getNumResolutionLevels(imageNumber))
+    {
+        throw except::Exception(Ctxt(
+                "Image " + str::toString(imageNumber) + " only has " +
+                str::toString(getNumResolutionLevels(imageNumber)) +
+                " resolution levels"));
+    }
+
+    const types::RowCol<size_t> imageDims =
+            getDims(imageNumber, resolutionLevel);
+    if (region.getNumRows() == -1)
+    {
+        region.setNumRows(imageDims.row);
+    }
+    if (region.getNumCols() == -1)
+    {
+        region.setNumCols(imageDims.col);
+    }
+
+    const types::RowCol<size_t> offset(region.getStartRow(),
+                                       region.getStartCol());
+    const types::RowCol<size_t> dims(region.getNumRows(),
+                                     region.getNumCols());
+    if (region.getStartRow() < 0 || offset.row + dims.row > imageDims.row)
+    {
+        throw except::Exception(Ctxt(
+                "Too many rows requested [" + str::toString(dims.row) +
+                "]"));
+    }
+    if (region.getStartCol() < 0 || offset.col + dims.col > imageDims.col)
+    {
+        throw except::Exception(Ctxt(
+                "Too many cols requested [" + str::toString(dims.col) +
+                "]"));
+    }
+
+    UByte* buffer = region.getBuffer();
+    if (buffer == NULL)
+    {
+        buffer = new UByte[dims.area() * image.numBytesPerPixel];
+        region.setBuffer(buffer);
+    }
+
+    // Find the tiles the region touches
+    std::vector<Job> jobs;
+    size_t segmentFirstRow = 0;
+    for (size_t ii = 0; ii < image.segments.size(); ++ii)
+    {
+        const Segment& segment = image.segments[ii];
+        const size_t numRows = reduce(segment.dims.row, resolutionLevel);
+        if (overlaps(segmentFirstRow, numRows, offset.row, dims.row))
+        {
+            const types::RowCol<size_t> numTiles(
+                    (segment.dims.row + segment.tileDims.row - 1) /
+                            segment.tileDims.row,
+                    (segment.dims.col + segment.tileDims.col - 1) /
+                            segment.tileDims.col);
+
+            Job job;
+            job.segment = ii;
+            for (job.tile.row = 0; job.tile.row < numTiles.row; ++job.tile.row)
+            {
+                const size_t tileRow = job.tile.row * segment.tileDims.row;
+                const size_t tileEndRow = std::min(
+                        tileRow + segment.tileDims.row, segment.dims.row);
+                job.offset.row = segmentFirstRow +
+                        reduce(tileRow, resolutionLevel);
+                job.dims.row = segmentFirstRow +
+                        reduce(tileEndRow, resolutionLevel) - job.offset.row;
+                if (!overlaps(job.offset.row, job.dims.row,
+                              offset.row, dims.row))
+                {
+                    continue;
+                }
+
+                for (job.tile.col = 0;
+                     job.tile.col < numTiles.col;
+                     ++job.tile.col)
+                {
+                    const size_t tileCol =
+                            job.tile.col * segment.tileDims.col;
+                    const size_t tileEndCol = std::min(
+                            tileCol + segment.tileDims.col,
+                            segment.dims.col);
+                    job.offset.col = reduce(tileCol, resolutionLevel);
+                    job.dims.col = reduce(tileEndCol, resolutionLevel) -
+                            job.offset.col;
+                    if (job.dims.row > 0 && job.dims.col > 0 &&
+                        overlaps(job.offset.col, job.dims.col,
+                                 offset.col, dims.col))
+                    {
+                        jobs.push_back(job);
+                    }
+                }
+            }
+        }
+        segmentFirstRow += numRows;
+    }
+
+    const size_t numThreads = std::min(mNumThreads, jobs.size());
+    sys::AtomicCounter nextJob;
+    if (numThreads <= 1)
+    {
+        DecodeRunnable(mPathname, image.segments, jobs,
+                       image.numBytesPerPixel, resolutionLevel,
+                       offset, dims, nextJob, buffer).run();
+    }
+    else
+    {
+        mt::ThreadGroup threads;
+        for (size_t ii = 0; ii < numThreads; ++ii)
+        {
+            std::auto_ptr<sys::Runnable> runnable(new DecodeRunnable(
+                    mPathname, image.segments, jobs,
+                    image.numBytesPerPixel, resolutionLevel,
+                    offset, dims, nextJob, buffer));
+            threads.createThread(runnable);
+        }
+        threads.joinAll();
+    }
+
+    return buffer;
+}
+}
+}
@@ -0,0 +1,419 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include <mt/ThreadGroup.h>
+#include <sys/AtomicCounter.h>
+#include <sys/OS.h>
+#include <sys/Runnable.h>
+#include <six/sidd/LUTRemapper.h>
+
+namespace
+{
+// Pixels each thread remaps at a time
+const size_t PIXELS_PER_JOB = 64 * 1024;
+
+size_t getValue(const six::UByte* entry, size_t numBytes)
+{
+    if (numBytes == 1)
+    {
+        return *entry;
+    }
+
+    sys::Uint16_T value;
+    std::memcpy(&value, entry, sizeof(value));
+    return value;
+}
+
+template <typename InputT, size_t NumOutputBytes>
+void remapPixels(const six::UByte* input,
+                 size_t numPixels,
+                 const std::vector<const six::UByte*>& tables,
+                 six::UByte* output)
+{
+    const size_t numBands = tables.size();
+    if (numBands == 1)
+    {
+        // Tables cover every input value, so there's nothing to check
+        const six::UByte* const table = tables[0];
+        for (size_t ii = 0; ii < numPixels; ++ii, input += sizeof(InputT))
+        {
+            InputT value;
+            std::memcpy(&value, input, sizeof(InputT));
+            std::memcpy(output + ii * NumOutputBytes,
+                        table + value * NumOutputBytes,
+                        NumOutputBytes);
+        }
+        return;
+    }
+
+    for (size_t ii = 0; ii < numPixels; ++ii)
+    {
+        for (size_t band = 0; band < numBands; ++band)
+        {
+            InputT value;
+            std::memcpy(&value, input, sizeof(InputT));
+            std::memcpy(output, tables[band] + value * NumOutputBytes,
+                        NumOutputBytes);
+            input += sizeof(InputT);
+            output += NumOutputBytes;
+        }
+    }
+}
+
+typedef void (*RemapFunction)(const six::UByte*,
+                              size_t,
+                              const std::vector<const six::UByte*>&,
+                              six::UByte*);
+
+RemapFunction getRemapFunction(size_t numInputBytes, size_t numOutputBytes)
+{
+    if (numInputBytes == 1)
+    {
+        switch (numOutputBytes)
+        {
+        case 1:
+            return &remapPixels<sys::ubyte, 1>;
+        case 2:
+            return &remapPixels<sys::ubyte, 2>;
+        default:
+            return &remapPixels<sys::ubyte, 3>;
+        }
+    }
+
+    switch (numOutputBytes)
+    {
+    case 1:
+        return &remapPixels<sys::Uint16_T, 1>;
+    case 2:
+        return &remapPixels<sys::Uint16_T, 2>;
+    default:
+        return &remapPixels<sys::Uint16_T, 3>;
+    }
+}
+
+class RemapRunnable : public sys::Runnable
+{
+public:
+    RemapRunnable(RemapFunction remapFunction,
+                  const std::vector<const six::UByte*>& tables,
+                  const six::UByte* input,
+                  size_t numInputBytesPerPixel,
+                  size_t numPixels,
+                  size_t numOutputBytesPerPixel,
+                  sys::AtomicCounter& nextJob,
+                  six::UByte* output) :
+        mRemapFunction(remapFunction),
+        mTables(tables),
+        mInput(input),
+        mNumInputBytesPerPixel(numInputBytesPerPixel),
+        mNumPixels(numPixels),
+        mNumOutputBytesPerPixel(numOutputBytesPerPixel),
+        mNextJob(nextJob),
+        mOutput(output)
+    {
+    }
+
+    virtual void run()
+    {
+        while (true)
+        {
+            const size_t firstPixel = PIXELS_PER_JOB *
+                    static_cast<size_t>(mNextJob.getThenIncrement());
+            if (firstPixel >= mNumPixels)
+            {
+                break;
+            }
+
+            mRemapFunction(mInput + firstPixel * mNumInputBytesPerPixel,
+                           std::min(PIXELS_PER_JOB, mNumPixels - firstPixel),
+                           mTables,
+                           mOutput + firstPixel * mNumOutputBytesPerPixel);
+        }
+    }
+
+private:
+    const RemapFunction mRemapFunction;
+    const std::vector<const six::UByte*>& mTables;
+    const six::UByte* const mInput;
+    const size_t mNumInputBytesPerPixel;
+    const size_t mNumPixels;
+    const size_t mNumOutputBytesPerPixel;
+    sys::AtomicCounter& mNextJob;
+    six::UByte* const mOutput;
+};
+
+void validate(const six::LUT& lut)
+{
+    if (lut.numEntries == 0 || lut.numEntries > 65536 ||
+        lut.elementSize == 0 || lut.elementSize > 3 ||
+        lut.table.size() != lut.numEntries * lut.elementSize)
+    {
+        std::ostringstream ostr;
+        ostr << "Can't remap with a LUT of " << lut.numEntries
+             << " entries of " << lut.elementSize << " bytes";
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+}
+
+std::vector<const six::LUT*> getLUTs(const six::sidd::LookupTable& table)
+{
+    if (table.custom.get() == NULL || table.custom->lutValues.empty())
+    {
+        throw except::Exception(Ctxt(
+                "Only custom lookup tables can be applied"));
+    }
+
+    std::vector<const six::LUT*> luts;
+    for (size_t ii = 0; ii < table.custom->lutValues.size(); ++ii)
+    {
+        luts.push_back(&table.custom->lutValues[ii]);
+    }
+    return luts;
+}
+
+const six::LUT& getDisplayLUT(const six::sidd::DerivedData& data)
+{
+    const six::LUT* lut = NULL;
+    if (data.getVersion() == "1.0.0")
+    {
+        if (data.display.get() && data.display->remapInformation.get())
+        {
+            lut = data.display->remapInformation->remapLUT.get();
+        }
+    }
+    else
+    {
+        lut = data.nitfLUT.get();
+    }
+
+    if (lut == NULL)
+    {
+        throw except::Exception(Ctxt("SIDD has no display LUT"));
+    }
+    return *lut;
+}
+}
+
+namespace six
+{
+namespace sidd
+{
+const size_t LUTRemapper::DEFAULT_ROWS_PER_BLOCK = 256;
+
+LUTRemapper::LUTRemapper(const LUT& lut, size_t numThreads) :
+    mNumThreads(numThreads == 0 ? sys::OS().getNumCPUsAvailable() :
+                                  numThreads),
+    mNumInputBytes(0),
+    mNumOutputBytes(0)
+{
+    append(std::vector<const LUT*>(1, &lut));
+}
+
+LUTRemapper::LUTRemapper(const LookupTable& lookupTable,
+                         size_t numThreads) :
+    mNumThreads(numThreads == 0 ? sys::OS().getNumCPUsAvailable() :
+                                  numThreads),
+    mNumInputBytes(0),
+    mNumOutputBytes(0)
+{
+    append(getLUTs(lookupTable));
+}
+
+LUTRemapper::LUTRemapper(const DerivedData& data, size_t numThreads) :
+    mNumThreads(numThreads == 0 ? sys::OS().getNumCPUsAvailable() :
+                                  numThreads),
+    mNumInputBytes(0),
+    mNumOutputBytes(0)
+{
+    append(std::vector<const LUT*>(1, &getDisplayLUT(data)));
+}
+
+void LUTRemapper::append(const LUT& lut)
+{
+    append(std::vector<const LUT*>(1, &lut));
+}
+
+void LUTRemapper::append(const LookupTable& lookupTable)
+{
+    append(getLUTs(lookupTable));
+}
+
+void LUTRemapper::append(const std::vector<const LUT*>& luts)
+{
+    for (size_t ii = 0; ii < luts.size(); ++ii)
+    {
+        validate(*luts[ii]);
+        if (luts[ii]->elementSize != luts[0]->elementSize)
+        {
+            throw except::Exception(Ctxt(
+                    "All bands' LUTs must have the same size entries"));
+        }
+    }
+
+    if (mTables.empty())
+    {
+        // The largest LUT decides how big input samples are
+        size_t maxNumEntries = 0;
+        for (size_t ii = 0; ii < luts.size(); ++ii)
+        {
+            maxNumEntries = std::max(maxNumEntries, luts[ii]->numEntries);
+        }
+        mNumInputBytes = (maxNumEntries <= 256) ? 1 : 2;
+
+        for (size_t ii = 0; ii < luts.size(); ++ii)
+        {
+            mTables.push_back(composeFirst(*luts[ii]));
+        }
+    }
+    else
+    {
+        if (mNumOutputBytes > 2)
+        {
+            throw except::Exception(Ctxt(
+                    "Can't apply a LUT after one that outputs colors"));
+        }
+
+        // A band-wise table applied to a single band splits it up
+        if (mTables.size() == 1 && luts.size() > 1)
+        {
+            const std::vector<UByte> table(mTables[0]);
+            mTables.resize(luts.size(), table);
+        }
+        if (luts.size() != 1 && luts.size() != mTables.size())
+        {
+            std::ostringstream ostr;
+            ostr << "Can't apply " << luts.size() << " LUTs to "
+                 << mTables.size() << " bands";
+            throw except::Exception(Ctxt(ostr.str()));
+        }
+
+        for (size_t ii = 0; ii < mTables.size(); ++ii)
+        {
+            const LUT& lut(*luts[luts.size() == 1 ? 0 : ii]);
+            mTables[ii] = compose(mTables[ii], lut);
+        }
+    }
+    mNumOutputBytes = luts[0]->elementSize;
+}
+
+std::vector<UByte> LUTRemapper::composeFirst(const LUT& lut)
+{
+    const size_t numValues = (mNumInputBytes == 1) ? 256 : 65536;
+    std::vector<UByte> table(numValues * lut.elementSize);
+    for (size_t ii = 0; ii < numValues; ++ii)
+    {
+        std::memcpy(&table[ii * lut.elementSize],
+                    lut[std::min(ii, lut.numEntries - 1)],
+                    lut.elementSize);
+    }
+    return table;
+}
+
+std::vector<UByte> LUTRemapper::compose(const std::vector<UByte>& table,
+                                        const LUT& lut) const
+{
+    const size_t numValues = table.size() / mNumOutputBytes;
+    std::vector<UByte> composed(numValues * lut.elementSize);
+    for (size_t ii = 0; ii < numValues; ++ii)
+    {
+        const size_t value = getValue(&table[ii * mNumOutputBytes],
+                                      mNumOutputBytes);
+        std::memcpy(&composed[ii * lut.elementSize],
+                    lut[std::min(value, lut.numEntries - 1)],
+                    lut.elementSize);
+    }
+    return composed;
+}
+
+void LUTRemapper::remap(const UByte* input,
+                        size_t numPixels,
+                        UByte* output) const
+{
+    std::vector<const UByte*> tables(mTables.size());
+    for (size_t ii = 0; ii < mTables.size(); ++ii)
+    {
+        tables[ii] = &mTables[ii][0];
+    }
+    const RemapFunction remapFunction =
+            getRemapFunction(mNumInputBytes, mNumOutputBytes);
+
+    const size_t numJobs = (numPixels + PIXELS_PER_JOB - 1) / PIXELS_PER_JOB;
+    const size_t numThreads = std::min(mNumThreads, numJobs);
+    sys::AtomicCounter nextJob;
+    if (numThreads <= 1)
+    {
+        RemapRunnable(remapFunction, tables, input,
+                      getNumInputBytesPerPixel(), numPixels,
+                      getNumOutputBytesPerPixel(), nextJob, output).run();
+    }
+    else
+    {
+        mt::ThreadGroup threads;
+        for (size_t ii = 0; ii < numThreads; ++ii)
+        {
+            std::auto_ptr<sys::Runnable> runnable(new RemapRunnable(
+                    remapFunction, tables, input,
+                    getNumInputBytesPerPixel(), numPixels,
+                    getNumOutputBytesPerPixel(), nextJob, output));
+            threads.createThread(runnable);
+        }
+        threads.joinAll();
+    }
+}
+
+void LUTRemapper::remapRows(io::InputStream& input,
+                            size_t numRows,
+                            size_t numCols,
+                            io::OutputStream& output,
+                            size_t numRowsPerBlock) const
+{
+    if (numRowsPerBlock == 0)
+    {
+        throw except::Exception(Ctxt("Need at least one row per block"));
+    }
+
+    const size_t rowsPerBlock = std::min(numRowsPerBlock, numRows);
+    std::vector<UByte> inputBlock(
+            rowsPerBlock * numCols * getNumInputBytesPerPixel());
+    std::vector<UByte> outputBlock(
+            rowsPerBlock * numCols * getNumOutputBytesPerPixel());
+    for (size_t row = 0; row < numRows; row += rowsPerBlock)
+    {
+        const size_t numPixels =
+                std::min(rowsPerBlock, numRows - row) * numCols;
+        if (numPixels == 0)
+        {
+            break;
+        }
+
+        input.read(&inputBlock[0], numPixels * getNumInputBytesPerPixel(),
+                   true);
+        remap(&inputBlock[0], numPixels, &outputBlock[0]);
+        output.write(&outputBlock[0],
+                     numPixels * getNumOutputBytesPerPixel());
+    }
+}
+}
+}
@@ -0,0 +1,406 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <algorithm>
+#include <sstream>
+
+#include <except/Exception.h>
+#include <mt/ThreadGroup.h>
+#include <sys/Conf.h>
+#include <sys/File.h>
+#include <sys/Runnable.h>
+#include <six/sidd/MultiProductWriter.h>
+
+namespace
+{
+/*
+ * Writes one product's pixels to the room left for them in its image
+ * segments, byte swapping them along the way.  Each product has its own
+ * file handle so they can all write at once.
+ */
+class ProductStream : public io::OutputStream
+{
+public:
+    //! File offset and size of the pixels of one image segment
+    typedef std::pair<nitf::Off, size_t> Segment;
+
+    ProductStream(const std::string& pathname,
+                  const std::vector<Segment>& segments,
+                  size_t elementSize,
+                  bool doByteSwap) :
+        // Opening the file write-only would truncate it
+        mFile(pathname, sys::File::READ_AND_WRITE, sys::File::EXISTING),
+        mSegments(segments),
+        mElementSize(doByteSwap ? elementSize : 1),
+        mNumBytesBuffered(0),
+        mSegment(0),
+        mSegmentPos(0)
+    {
+        // Whole elements, so they can be byte swapped
+        mBuffer.resize(BUFFER_SIZE - BUFFER_SIZE % mElementSize);
+    }
+
+    virtual void write(const void* buffer, size_t len)
+    {
+        const sys::byte* bytes = static_cast<const sys::byte*>(buffer);
+        while (len > 0)
+        {
+            const size_t numBytes =
+                    std::min(len, mBuffer.size() - mNumBytesBuffered);
+            std::copy(bytes, bytes + numBytes, &mBuffer[mNumBytesBuffered]);
+            mNumBytesBuffered += numBytes;
+            bytes += numBytes;
+            len -= numBytes;
+
+            if (mNumBytesBuffered == mBuffer.size())
+            {
+                flush();
+            }
+        }
+    }
+
+    using io::OutputStream::write;
+
+    virtual void flush()
+    {
+        const size_t numBytes =
+                mNumBytesBuffered - mNumBytesBuffered % mElementSize;
+        if (mElementSize > 1)
+        {
+            sys::byteSwap(&mBuffer[0],
+                          static_cast<unsigned short>(mElementSize),
+                          numBytes / mElementSize);
+        }
+
+        const sys::byte* bytes = &mBuffer[0];
+        size_t remaining = numBytes;
+        while (remaining > 0)
+        {
+            if (mSegment == mSegments.size())
+            {
+                throw except::Exception(Ctxt(
+                        "Product has more pixels than its metadata"));
+            }
+
+            const Segment& segment = mSegments[mSegment];
+            const size_t toWrite =
+                    std::min(remaining, segment.second - mSegmentPos);
+            mFile.seekTo(segment.first + mSegmentPos, sys::File::FROM_START);
+            mFile.writeFrom(bytes, toWrite);
+            bytes += toWrite;
+            remaining -= toWrite;
+            mSegmentPos += toWrite;
+
+            if (mSegmentPos == segment.second)
+            {
+                ++mSegment;
+                mSegmentPos = 0;
+            }
+        }
+
+        // Keep a partial element for next time
+        std::copy(&mBuffer[0] + numBytes, &mBuffer[0] + mNumBytesBuffered,
+                  &mBuffer[0]);
+        mNumBytesBuffered -= numBytes;
+    }
+
+    virtual void close()
+    {
+        flush();
+        while (mSegment < mSegments.size() && mSegments[mSegment].second == 0)
+        {
+            ++mSegment;
+        }
+        if (mNumBytesBuffered != 0 || mSegment != mSegments.size())
+        {
+            throw except::Exception(Ctxt(
+                    "Product has fewer pixels than its metadata"));
+        }
+        mFile.close();
+    }
+
+private:
+    static const size_t BUFFER_SIZE = 4 * 1024 * 1024;
+
+    sys::File mFile;
+    const std::vector<Segment> mSegments;
+    const size_t mElementSize;
+
+    std::vector<sys::byte> mBuffer;
+    size_t mNumBytesBuffered;
+
+    //! Segment and position within it where the next byte goes
+    size_t mSegment;
+    size_t mSegmentPos;
+};
+
+//! Hands one block of source rows to one product
+class ProductRunnable : public sys::Runnable
+{
+public:
+    ProductRunnable(six::sidd::MultiProductWriter::Product& product,
+                    const six::UByte* rows,
+                    size_t numBytes) :
+        mProduct(product),
+        mRows(rows),
+        mNumBytes(numBytes)
+    {
+    }
+
+    virtual void run()
+    {
+        mProduct.write(mRows, mNumBytes);
+    }
+
+private:
+    six::sidd::MultiProductWriter::Product& mProduct;
+    const six::UByte* const mRows;
+    const size_t mNumBytes;
+};
+}
+
+namespace six
+{
+namespace sidd
+{
+const size_t MultiProductWriter::DEFAULT_ROWS_PER_BLOCK = 256;
+
+MultiProductWriter::FullResolution::FullResolution() :
+    mOutput(NULL)
+{
+}
+
+void MultiProductWriter::FullResolution::start(io::OutputStream& output)
+{
+    mOutput = &output;
+}
+
+void MultiProductWriter::FullResolution::write(const UByte* rows,
+                                               size_t numBytes)
+{
+    mOutput->write(rows, numBytes);
+}
+
+MultiProductWriter::Overviews::Level::Level(Overviews& overviews,
+                                            size_t level) :
+    mOverviews(overviews),
+    mLevel(level)
+{
+}
+
+void MultiProductWriter::Overviews::Level::start(io::OutputStream& output)
+{
+    mOverviews.start(mLevel, output);
+}
+
+void MultiProductWriter::Overviews::Level::write(const UByte* rows,
+                                                 size_t numBytes)
+{
+    mOverviews.write(mLevel, rows, numBytes);
+}
+
+MultiProductWriter::Overviews::Overviews(const types::RowCol<size_t>& dims,
+                                         PixelType pixelType,
+                                         size_t numLevels,
+                                         OverviewPyramid::Filter filter,
+                                         size_t numThreads) :
+    mDims(dims),
+    mPixelType(pixelType),
+    mFilter(filter),
+    mNumThreads(numThreads),
+    mOutputs(numLevels, &mNullOutput),
+    mFirstStarted(0)
+{
+    if (numLevels == 0)
+    {
+        throw except::Exception(Ctxt("Need at least one overview level"));
+    }
+
+    // The pyramid isn't built until the rows start coming in, so check
+    // now what it would
+    OverviewPyramid::getNumBytesPerPixel(pixelType);
+    if (numLevels > OverviewPyramid::getMaxNumLevels(dims))
+    {
+        std::ostringstream ostr;
+        ostr << "A " << dims.row << "x" << dims.col << " image can have "
+             << "at most " << OverviewPyramid::getMaxNumLevels(dims)
+             << " overview levels";
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+
+    for (size_t level = 1; level <= numLevels; ++level)
+    {
+        mLevels.push_back(mem::SharedPtr<Level>(new Level(*this, level)));
+    }
+}
+
+MultiProductWriter::Product&
+MultiProductWriter::Overviews::getLevel(size_t level)
+{
+    if (level == 0 || level > mLevels.size())
+    {
+        std::ostringstream ostr;
+        ostr << "Overview level " << level << " isn't one of levels 1 to "
+             << mLevels.size() << ".  Use FullResolution for level 0.";
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+    return *mLevels[level - 1];
+}
+
+void MultiProductWriter::Overviews::start(size_t level,
+                                          io::OutputStream& output)
+{
+    // Whatever is left over from the last save()
+    if (mPyramid.get() || mOutputs[level - 1] != &mNullOutput)
+    {
+        reset();
+    }
+
+    mOutputs[level - 1] = &output;
+    if (mFirstStarted == 0)
+    {
+        mFirstStarted = level;
+    }
+}
+
+void MultiProductWriter::Overviews::write(size_t level,
+                                          const UByte* rows,
+                                          size_t numBytes)
+{
+    // Every product is started before any rows are written, so by now all
+    // the outputs are known.  Only one level's thread touches the pyramid.
+    if (level != mFirstStarted)
+    {
+        return;
+    }
+
+    if (mPyramid.get() == NULL)
+    {
+        mPyramid.reset(new OverviewPyramid(mDims, mPixelType, mOutputs,
+                                           mFilter, mNumThreads));
+    }
+    mPyramid->write(rows, numBytes);
+}
+
+void MultiProductWriter::Overviews::reset()
+{
+    mPyramid.reset();
+    std::fill(mOutputs.begin(), mOutputs.end(), &mNullOutput);
+    mFirstStarted = 0;
+}
+
+MultiProductWriter::MultiProductWriter(NITFWriteControl& writer,
+                                       size_t numRowsPerBlock) :
+    mWriter(writer),
+    mNumRowsPerBlock(numRowsPerBlock)
+{
+    if (mNumRowsPerBlock == 0)
+    {
+        throw except::Exception(Ctxt("Need at least one row per block"));
+    }
+}
+
+void MultiProductWriter::save(io::InputStream& source,
+                              const types::RowCol<size_t>& dims,
+                              size_t numBytesPerPixel,
+                              const std::vector<Product*>& products,
+                              const std::string& pathname,
+                              const std::vector<std::string>& schemaPaths)
+{
+    const std::vector<mem::SharedPtr<NITFImageInfo> > infos =
+            mWriter.getInfos();
+    if (infos.size() != products.size())
+    {
+        std::ostringstream ostr;
+        ostr << "Require " << infos.size() << " products, received "
+             << products.size();
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+
+    const std::vector<nitf::Off> offsets =
+            mWriter.saveWithoutImageData(pathname, schemaPaths);
+    const bool doByteSwap = mWriter.shouldByteSwap();
+
+    std::vector<mem::SharedPtr<ProductStream> > streams;
+    for (size_t ii = 0; ii < infos.size(); ++ii)
+    {
+        const NITFImageInfo& info = *(infos[ii]);
+        const Data& data = *info.getData();
+        const std::vector<NITFSegmentInfo> imageSegments =
+                info.getImageSegments();
+        const size_t numBytesPerRow =
+                data.getNumCols() * data.getNumBytesPerPixel();
+
+        std::vector<ProductStream::Segment> segments;
+        for (size_t jj = 0; jj < imageSegments.size(); ++jj)
+        {
+            segments.push_back(ProductStream::Segment(
+                    offsets[info.getStartIndex() + jj],
+                    imageSegments[jj].numRows * numBytesPerRow));
+        }
+
+        streams.push_back(mem::SharedPtr<ProductStream>(new ProductStream(
+                pathname, segments,
+                data.getNumBytesPerPixel() / data.getNumChannels(),
+                doByteSwap)));
+        products[ii]->start(*streams.back());
+    }
+
+    // Read the next block while the products work on this one
+    const size_t numBytesPerRow = dims.col * numBytesPerPixel;
+    std::vector<UByte> blocks[2];
+    size_t numRowsRead = std::min(mNumRowsPerBlock, dims.row);
+    blocks[0].resize(numRowsRead * numBytesPerRow);
+    if (!blocks[0].empty())
+    {
+        source.read(&blocks[0][0], blocks[0].size(), true);
+    }
+
+    for (size_t block = 0; !blocks[block % 2].empty(); ++block)
+    {
+        const std::vector<UByte>& current = blocks[block % 2];
+        mt::ThreadGroup threads;
+        for (size_t ii = 0; ii < products.size(); ++ii)
+        {
+            threads.createThread(new ProductRunnable(
+                    *products[ii], &current[0], current.size()));
+        }
+
+        std::vector<UByte>& next = blocks[(block + 1) % 2];
+        const size_t numRows =
+                std::min(mNumRowsPerBlock, dims.row - numRowsRead);
+        next.resize(numRows * numBytesPerRow);
+        if (!next.empty())
+        {
+            source.read(&next[0], next.size(), true);
+        }
+        numRowsRead += numRows;
+
+        threads.joinAll();
+    }
+
+    for (size_t ii = 0; ii < streams.size(); ++ii)
+    {
+        streams[ii]->close();
+    }
+}
+}
+}
@@ -0,0 +1,897 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+#include <io/FileInputStream.h>
+#include <io/FileOutputStream.h>
+#include <io/TempFile.h>
+#include <mem/SharedPtr.h>
+#include <mt/CriticalSection.h>
+#include <mt/ThreadGroup.h>
+#include <sys/AtomicCounter.h>
+#include <sys/ConditionVar.h>
+#include <sys/Mutex.h>
+#include <sys/OS.h>
+#include <sys/Path.h>
+#include <sys/Runnable.h>
+#include <six/Container.h>
+#include <six/sidd/OverviewPyramid.h>
+
+namespace
+{
+//! Filter taps for one output row or column, relative to twice its index
+struct Taps
+{
+    Taps(six::sidd::OverviewPyramid::Filter filter)
+    {
+        if (filter == six::sidd::OverviewPyramid::GAUSSIAN)
+        {
+            first = -1;
+            weights.push_back(0.125f);
+            weights.push_back(0.375f);
+            weights.push_back(0.375f);
+            weights.push_back(0.125f);
+        }
+        else
+        {
+            first = 0;
+            weights.assign(2, 0.5f);
+        }
+    }
+
+    //! \return Input index of tap 'tap' for output index 'index', clamped
+    //! to the edges of the input
+    size_t getIndex(size_t index, size_t tap, size_t numInputs) const
+    {
+        const sys::SSize_T pos = static_cast<sys::SSize_T>(2 * index) +
+                first + static_cast<sys::SSize_T>(tap);
+        if (pos < 0)
+        {
+            return 0;
+        }
+        return std::min(static_cast<size_t>(pos), numInputs - 1);
+    }
+
+    //! \return Last input index output index 'index' needs
+    size_t getLastIndex(size_t index, size_t numInputs) const
+    {
+        return getIndex(index, weights.size() - 1, numInputs);
+    }
+
+    //! \return First input index output index 'index' needs
+    size_t getFirstIndex(size_t index, size_t numInputs) const
+    {
+        return getIndex(index, 0, numInputs);
+    }
+
+    sys::SSize_T first;
+    std::vector<float> weights;
+};
+
+float quantize(float value, float maxValue)
+{
+    if (maxValue == 0)
+    {
+        return value;
+    }
+    return std::min(std::max(std::floor(value + 0.5f), 0.0f), maxValue);
+}
+
+/*
+ * Filters a range of output rows of one level.  Several threads may call
+ * run() at once.  They claim rows with 'nextRow', so each row is computed
+ * by exactly one of them.
+ */
+class FilterRunnable : public sys::Runnable
+{
+public:
+    FilterRunnable(const float* rows,
+                   size_t firstInputRow,
+                   const types::RowCol<size_t>& inputDims,
+                   const types::RowCol<size_t>& outputDims,
+                   size_t numChannels,
+                   six::sidd::OverviewPyramid::Filter filter,
+                   float maxValue,
+                   size_t firstRow,
+                   size_t numRows,
+                   sys::AtomicCounter& nextRow,
+                   float* output) :
+        mRows(rows),
+        mFirstInputRow(firstInputRow),
+        mInputDims(inputDims),
+        mOutputDims(outputDims),
+        mNumChannels(numChannels),
+        mIsMax(filter == six::sidd::OverviewPyramid::MAX),
+        mTaps(filter),
+        mMaxValue(maxValue),
+        mFirstRow(firstRow),
+        mNumRows(numRows),
+        mNextRow(nextRow),
+        mOutput(output)
+    {
+    }
+
+    virtual void run()
+    {
+        const size_t inputStride = mInputDims.col * mNumChannels;
+        const size_t outputStride = mOutputDims.col * mNumChannels;
+        const size_t numTaps = mTaps.weights.size();
+        std::vector<float> column(inputStride);
+
+        while (true)
+        {
+            const size_t index =
+                    static_cast<size_t>(mNextRow.getThenIncrement());
+            if (index >= mNumRows)
+            {
+                break;
+            }
+            const size_t row = mFirstRow + index;
+
+            // Filter down the columns first...
+            for (size_t tap = 0; tap < numTaps; ++tap)
+            {
+                const float* const input = mRows +
+                        (mTaps.getIndex(row, tap, mInputDims.row) -
+                         mFirstInputRow) * inputStride;
+                const float weight = mTaps.weights[tap];
+                for (size_t ii = 0; ii < inputStride; ++ii)
+                {
+                    if (tap == 0)
+                    {
+                        column[ii] = mIsMax ? input[ii] : weight * input[ii];
+                    }
+                    else if (mIsMax)
+                    {
+                        column[ii] = std::max(column[ii], input[ii]);
+                    }
+                    else
+                    {
+                        column[ii] += weight * input[ii];
+                    }
+                }
+            }
+
+            // ...and then across the row
+            float* const output = mOutput + index * outputStride;
+            for (size_t col = 0; col < mOutputDims.col; ++col)
+            {
+                for (size_t channel = 0; channel < mNumChannels; ++channel)
+                {
+                    float value = 0;
+                    for (size_t tap = 0; tap < numTaps; ++tap)
+                    {
+                        const float input = column[
+                                mTaps.getIndex(col, tap, mInputDims.col) *
+                                mNumChannels + channel];
+                        if (mIsMax)
+                        {
+                            value = (tap == 0) ? input :
+                                                 std::max(value, input);
+                        }
+                        else
+                        {
+                            value += mTaps.weights[tap] * input;
+                        }
+                    }
+                    output[col * mNumChannels + channel] =
+                            quantize(value, mMaxValue);
+                }
+            }
+        }
+    }
+
+private:
+    const float* const mRows;
+    const size_t mFirstInputRow;
+    const types::RowCol<size_t> mInputDims;
+    const types::RowCol<size_t> mOutputDims;
+    const size_t mNumChannels;
+    const bool mIsMax;
+    const Taps mTaps;
+    const float mMaxValue;
+    const size_t mFirstRow;
+    const size_t mNumRows;
+    sys::AtomicCounter& mNextRow;
+    float* const mOutput;
+};
+
+template <typename T>
+void writeSamples(const float* samples,
+                  size_t numSamples,
+                  io::OutputStream& output)
+{
+    std::vector<T> buffer(numSamples);
+    for (size_t ii = 0; ii < numSamples; ++ii)
+    {
+        buffer[ii] = static_cast<T>(samples[ii]);
+    }
+    output.write(reinterpret_cast<const sys::byte*>(&buffer[0]),
+                 numSamples * sizeof(T));
+}
+
+template <typename T>
+void readSamples(const six::UByte* data, size_t numSamples, float* samples)
+{
+    for (size_t ii = 0; ii < numSamples; ++ii, data += sizeof(T))
+    {
+        T value;
+        std::memcpy(&value, data, sizeof(T));
+        samples[ii] = static_cast<float>(value);
+    }
+}
+
+template <typename T>
+void detectSamples(const six::UByte* data, size_t numPixels, float* samples)
+{
+    for (size_t ii = 0; ii < numPixels; ++ii, data += 2 * sizeof(T))
+    {
+        T value[2];
+        std::memcpy(value, data, sizeof(value));
+        const float real = static_cast<float>(value[0]);
+        const float imag = static_cast<float>(value[1]);
+        samples[ii] = std::sqrt(real * real + imag * imag);
+    }
+}
+
+size_t getNumInputBytesPerPixel(six::PixelType pixelType)
+{
+    switch (pixelType)
+    {
+    case six::PixelType::MONO8I:
+        return 1;
+    case six::PixelType::MONO16I:
+        return 2;
+    case six::PixelType::RGB24I:
+        return 3;
+    case six::PixelType::RE16I_IM16I:
+        return 4;
+    case six::PixelType::RE32F_IM32F:
+        return 8;
+    default:
+        throw except::Exception(Ctxt(
+                "Overviews can't be built for pixel type " +
+                pixelType.toString()));
+    }
+}
+
+/*
+ * Reads one overview level back once its temporary file is complete.  The
+ * file is written while the full resolution image is read, which always
+ * finishes before the writer gets to the overviews.
+ */
+class LevelStream : public io::InputStream
+{
+public:
+    LevelStream(const std::string& dirname) :
+        mFile(dirname),
+        mOutput(new io::FileOutputStream(mFile.pathname()))
+    {
+    }
+
+    io::OutputStream& getOutput()
+    {
+        return *mOutput;
+    }
+
+    virtual sys::Off_T available()
+    {
+        return getInput().available();
+    }
+
+protected:
+    virtual sys::SSize_T readImpl(void* buffer, size_t len)
+    {
+        return getInput().read(buffer, len);
+    }
+
+private:
+    io::InputStream& getInput()
+    {
+        if (mInput.get() == NULL)
+        {
+            mOutput->close();
+            mOutput.reset();
+            mInput.reset(new io::FileInputStream(mFile.pathname()));
+        }
+        return *mInput;
+    }
+
+private:
+    const io::TempFile mFile;
+    std::auto_ptr<io::FileOutputStream> mOutput;
+    std::auto_ptr<io::FileInputStream> mInput;
+};
+
+//! Passes everything read from 'input' on to 'output' as well
+class TeeInputStream : public io::InputStream
+{
+public:
+    TeeInputStream(io::InputStream& input, io::OutputStream& output) :
+        mInput(input),
+        mOutput(output)
+    {
+    }
+
+    virtual sys::Off_T available()
+    {
+        return mInput.available();
+    }
+
+protected:
+    virtual sys::SSize_T readImpl(void* buffer, size_t len)
+    {
+        const sys::SSize_T numBytes = mInput.read(buffer, len);
+        if (numBytes > 0)
+        {
+            mOutput.write(buffer, static_cast<size_t>(numBytes));
+        }
+        return numBytes;
+    }
+
+private:
+    io::InputStream& mInput;
+    io::OutputStream& mOutput;
+};
+}
+
+namespace six
+{
+namespace sidd
+{
+/*
+ * Filter threads that wait between batches of rows instead of being
+ * started for each one.  run() has up to 'numWorkers' of them, along with
+ * the calling thread, call the same Runnable, which divides the rows up
+ * itself.
+ */
+class OverviewPyramid::Workers
+{
+public:
+    Workers(size_t numThreads) :
+        mWorkReady(&mMutex),
+        mWorkDone(&mMutex),
+        mRunnable(NULL),
+        mNumToStart(0),
+        mNumRunning(0),
+        mFailed(false),
+        mShutdown(false)
+    {
+        try
+        {
+            for (size_t ii = 0; ii < numThreads; ++ii)
+            {
+                mThreads.createThread(new Worker(*this));
+            }
+        }
+        catch (...)
+        {
+            shutdown();
+            throw;
+        }
+    }
+
+    ~Workers()
+    {
+        shutdown();
+    }
+
+    void run(sys::Runnable& runnable, size_t numWorkers)
+    {
+        {
+            mt::CriticalSection<sys::Mutex> crit(&mMutex);
+            mRunnable = &runnable;
+            mNumToStart = numWorkers;
+            mFailed = false;
+            mWorkReady.broadcast();
+        }
+
+        except::Exception error;
+        const bool succeeded = runSafely(runnable, error);
+
+        mt::CriticalSection<sys::Mutex> crit(&mMutex);
+
+        // Every row has been claimed by now, so workers that haven't
+        // started have nothing left to do
+        mNumToStart = 0;
+        while (mNumRunning > 0)
+        {
+            mWorkDone.wait();
+        }
+        mRunnable = NULL;
+
+        if (!succeeded)
+        {
+            throw error;
+        }
+        if (mFailed)
+        {
+            throw mError;
+        }
+    }
+
+private:
+    class Worker : public sys::Runnable
+    {
+    public:
+        Worker(Workers& workers) :
+            mWorkers(workers)
+        {
+        }
+
+        virtual void run()
+        {
+            mWorkers.work();
+        }
+
+    private:
+        Workers& mWorkers;
+    };
+
+    static bool runSafely(sys::Runnable& runnable, except::Exception& error)
+    {
+        try
+        {
+            runnable.run();
+            return true;
+        }
+        catch (const except::Exception& ex)
+        {
+            error = ex;
+        }
+        catch (const std::exception& ex)
+        {
+            error = except::Exception(Ctxt(ex.what()));
+        }
+        catch (...)
+        {
+            error = except::Exception(Ctxt("Unknown error filtering rows"));
+        }
+        return false;
+    }
+
+    void work()
+    {
+        mt::CriticalSection<sys::Mutex> crit(&mMutex);
+        while (true)
+        {
+            while (!mShutdown && mNumToStart == 0)
+            {
+                mWorkReady.wait();
+            }
+            if (mShutdown)
+            {
+                return;
+            }
+            --mNumToStart;
+            ++mNumRunning;
+            sys::Runnable& runnable = *mRunnable;
+
+            crit.manualUnlock();
+            except::Exception error;
+            const bool succeeded = runSafely(runnable, error);
+            crit.manualLock();
+
+            if (!succeeded && !mFailed)
+            {
+                mFailed = true;
+                mError = error;
+            }
+            if (--mNumRunning == 0)
+            {
+                mWorkDone.broadcast();
+            }
+        }
+    }
+
+    void shutdown()
+    {
+        {
+            mt::CriticalSection<sys::Mutex> crit(&mMutex);
+            mShutdown = true;
+            mWorkReady.broadcast();
+        }
+        mThreads.joinAll();
+    }
+
+private:
+    mt::ThreadGroup mThreads;
+    sys::Mutex mMutex;
+    sys::ConditionVar mWorkReady;
+    sys::ConditionVar mWorkDone;
+    sys::Runnable* mRunnable;
+    size_t mNumToStart;
+    size_t mNumRunning;
+    bool mFailed;
+    except::Exception mError;
+    bool mShutdown;
+};
+
+OverviewPyramid::OverviewPyramid(const types::RowCol<size_t>& dims,
+                                 PixelType pixelType,
+                                 const std::vector<io::OutputStream*>& levels,
+                                 Filter filter,
+                                 size_t numThreads) :
+    mDims(dims),
+    mPixelType(pixelType),
+    mFilter(filter),
+    mNumThreads(numThreads == 0 ? sys::OS().getNumCPUsAvailable() :
+                                  numThreads),
+    mNumChannels(1),
+    mSampleType(UINT8),
+    mPartialRow(dims.col * getNumInputBytesPerPixel(pixelType)),
+    mNumPartialBytes(0),
+    mNumRowsWritten(0)
+{
+    switch (pixelType)
+    {
+    case PixelType::MONO8I:
+        break;
+    case PixelType::MONO16I:
+        mSampleType = UINT16;
+        break;
+    case PixelType::RGB24I:
+        mNumChannels = 3;
+        break;
+    default:
+        // Complex, which getNumInputBytesPerPixel() has already checked
+        mSampleType = UINT16;
+        break;
+    }
+
+    if (levels.size() > getMaxNumLevels(dims))
+    {
+        std::ostringstream ostr;
+        ostr << "A " << dims.row << "x" << dims.col << " image can have "
+             << "at most " << getMaxNumLevels(dims) << " overview levels";
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+
+    mLevels.resize(levels.size());
+    for (size_t ii = 0; ii < levels.size(); ++ii)
+    {
+        Level& level(mLevels[ii]);
+        level.inputDims = getDims(dims, ii);
+        level.outputDims = getDims(dims, ii + 1);
+        level.output = levels[ii];
+        level.firstRow = 0;
+        level.numRows = 0;
+        level.nextRow = 0;
+    }
+}
+
+OverviewPyramid::~OverviewPyramid()
+{
+}
+
+void OverviewPyramid::write(const void* buffer, size_t len)
+{
+    const UByte* data = static_cast<const UByte*>(buffer);
+    const size_t rowSize = mPartialRow.size();
+    const size_t numRowsLeft = mDims.row - mNumRowsWritten;
+    if (mNumPartialBytes + len > numRowsLeft * rowSize)
+    {
+        throw except::Exception(Ctxt(
+                "Wrote past the end of the image"));
+    }
+
+    // Finish off a row that was started by the last write
+    if (mNumPartialBytes > 0)
+    {
+        const size_t numBytes = std::min(rowSize - mNumPartialBytes, len);
+        std::memcpy(&mPartialRow[mNumPartialBytes], data, numBytes);
+        mNumPartialBytes += numBytes;
+        data += numBytes;
+        len -= numBytes;
+
+        if (mNumPartialBytes < rowSize)
+        {
+            return;
+        }
+        convertRows(&mPartialRow[0], 1);
+        mNumPartialBytes = 0;
+    }
+
+    const size_t numRows = len / rowSize;
+    if (numRows > 0)
+    {
+        convertRows(data, numRows);
+    }
+
+    mNumPartialBytes = len - numRows * rowSize;
+    if (mNumPartialBytes > 0)
+    {
+        std::memcpy(&mPartialRow[0], data + numRows * rowSize,
+                    mNumPartialBytes);
+    }
+}
+
+bool OverviewPyramid::isComplete() const
+{
+    return mNumRowsWritten == mDims.row;
+}
+
+void OverviewPyramid::convertRows(const UByte* data, size_t numRows)
+{
+    mNumRowsWritten += numRows;
+    if (mLevels.empty())
+    {
+        return;
+    }
+
+    const size_t numPixels = numRows * mDims.col;
+    std::vector<float> samples(numPixels * mNumChannels);
+    switch (mPixelType)
+    {
+    case PixelType::MONO16I:
+        readSamples<sys::Uint16_T>(data, samples.size(), &samples[0]);
+        break;
+    case PixelType::RE16I_IM16I:
+        detectSamples<sys::Int16_T>(data, numPixels, &samples[0]);
+        break;
+    case PixelType::RE32F_IM32F:
+        detectSamples<float>(data, numPixels, &samples[0]);
+        break;
+    default:
+        readSamples<sys::ubyte>(data, samples.size(), &samples[0]);
+        break;
+    }
+
+    addRows(0, &samples[0], numRows);
+}
+
+void OverviewPyramid::addRows(size_t levelNumber,
+                              const float* rows,
+                              size_t numRows)
+{
+    Level& level(mLevels[levelNumber]);
+    const size_t inputStride = level.inputDims.col * mNumChannels;
+    level.rows.insert(level.rows.end(), rows, rows + numRows * inputStride);
+    level.numRows += numRows;
+
+    // Compute every output row whose inputs have all arrived
+    const Taps taps(mFilter);
+    const size_t lastRow = level.firstRow + level.numRows - 1;
+    size_t endRow = level.nextRow;
+    while (endRow < level.outputDims.row &&
+           taps.getLastIndex(endRow, level.inputDims.row) <= lastRow)
+    {
+        ++endRow;
+    }
+    const size_t numOutputRows = endRow - level.nextRow;
+    if (numOutputRows == 0)
+    {
+        return;
+    }
+
+    const size_t outputStride = level.outputDims.col * mNumChannels;
+    std::vector<float> output(numOutputRows * outputStride);
+    const float maxValue = (mSampleType == UINT8) ? 255.0f : 65535.0f;
+    const size_t numThreads = std::min(mNumThreads, numOutputRows);
+    sys::AtomicCounter nextRow;
+    FilterRunnable filter(&level.rows[0], level.firstRow, level.inputDims,
+                          level.outputDims, mNumChannels, mFilter, maxValue,
+                          level.nextRow, numOutputRows, nextRow, &output[0]);
+    if (numThreads <= 1)
+    {
+        filter.run();
+    }
+    else
+    {
+        if (mWorkers.get() == NULL)
+        {
+            mWorkers.reset(new Workers(mNumThreads - 1));
+        }
+        mWorkers->run(filter, numThreads - 1);
+    }
+    level.nextRow = endRow;
+
+    switch (mSampleType)
+    {
+    case UINT8:
+        writeSamples<sys::ubyte>(&output[0], output.size(), *level.output);
+        break;
+    case UINT16:
+        writeSamples<sys::Uint16_T>(&output[0], output.size(),
+                                    *level.output);
+        break;
+    }
+    if (level.nextRow == level.outputDims.row)
+    {
+        level.output->flush();
+    }
+
+    // Drop the input rows no remaining output row needs
+    const size_t firstNeeded = (level.nextRow == level.outputDims.row) ?
+            level.firstRow + level.numRows :
+            taps.getFirstIndex(level.nextRow, level.inputDims.row);
+    if (firstNeeded > level.firstRow)
+    {
+        const size_t numDropped = firstNeeded - level.firstRow;
+        level.rows.erase(level.rows.begin(),
+                         level.rows.begin() + numDropped * inputStride);
+        level.firstRow = firstNeeded;
+        level.numRows -= numDropped;
+    }
+
+    if (levelNumber + 1 < mLevels.size())
+    {
+        addRows(levelNumber + 1, &output[0], numOutputRows);
+    }
+}
+
+types::RowCol<size_t>
+OverviewPyramid::getDims(const types::RowCol<size_t>& dims, size_t level)
+{
+    types::RowCol<size_t> levelDims(dims);
+    for (size_t ii = 0; ii < level; ++ii)
+    {
+        levelDims.row = (levelDims.row + 1) / 2;
+        levelDims.col = (levelDims.col + 1) / 2;
+    }
+    return levelDims;
+}
+
+size_t OverviewPyramid::getMaxNumLevels(const types::RowCol<size_t>& dims)
+{
+    size_t numLevels = 0;
+    while (true)
+    {
+        const types::RowCol<size_t> levelDims(getDims(dims, numLevels + 1));
+        if (levelDims.row < 2 || levelDims.col < 2)
+        {
+            return numLevels;
+        }
+        ++numLevels;
+    }
+}
+
+PixelType OverviewPyramid::getOverviewPixelType(PixelType pixelType)
+{
+    switch (pixelType)
+    {
+    case PixelType::RE16I_IM16I:
+    case PixelType::RE32F_IM32F:
+        return PixelType::MONO16I;
+    default:
+        return pixelType;
+    }
+}
+
+size_t OverviewPyramid::getNumBytesPerPixel(PixelType pixelType)
+{
+    return getNumInputBytesPerPixel(getOverviewPixelType(pixelType));
+}
+
+std::auto_ptr<DerivedData>
+OverviewPyramid::createOverviewData(const DerivedData& data, size_t level)
+{
+    const types::RowCol<size_t> fullDims(data.getNumRows(),
+                                         data.getNumCols());
+    if (level == 0 || level > getMaxNumLevels(fullDims))
+    {
+        std::ostringstream ostr;
+        ostr << "Invalid overview level " << level;
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+
+    std::auto_ptr<DerivedData> overview(
+            static_cast<DerivedData*>(data.clone()));
+    const types::RowCol<size_t> dims(getDims(fullDims, level));
+    overview->setNumRows(dims.row);
+    overview->setNumCols(dims.col);
+    overview->setPixelType(getOverviewPixelType(data.getPixelType()));
+
+    // Each overview pixel is centered on the 2^level x 2^level block of
+    // pixels it covers.  If this product is already a chip, those are in
+    // turn mapped back to the original product.
+    const double scale = static_cast<double>(1 << level);
+    const double offset = (scale - 1) / 2;
+    const GeometricChip* const parentChip =
+            data.downstreamReprocessing.get() ?
+                    data.downstreamReprocessing->geometricChip.get() : NULL;
+
+    RowColDouble corners[4];
+    corners[0] = RowColDouble(offset, offset);
+    corners[1] = RowColDouble(offset, (dims.col - 1) * scale + offset);
+    corners[2] = RowColDouble((dims.row - 1) * scale + offset,
+                              (dims.col - 1) * scale + offset);
+    corners[3] = RowColDouble((dims.row - 1) * scale + offset, offset);
+    if (parentChip)
+    {
+        for (size_t ii = 0; ii < 4; ++ii)
+        {
+            corners[ii] =
+                    parentChip->getFullImageCoordinateFromChip(corners[ii]);
+        }
+    }
+
+    GeometricChip chip;
+    chip.chipSize.row = static_cast<int>(dims.row);
+    chip.chipSize.col = static_cast<int>(dims.col);
+    chip.originalUpperLeftCoordinate = corners[0];
+    chip.originalUpperRightCoordinate = corners[1];
+    chip.originalLowerRightCoordinate = corners[2];
+    chip.originalLowerLeftCoordinate = corners[3];
+
+    if (overview->downstreamReprocessing.get() == NULL)
+    {
+        overview->downstreamReprocessing.reset(new DownstreamReprocessing());
+    }
+    overview->downstreamReprocessing->geometricChip.reset(
+            new GeometricChip(chip));
+
+    return overview;
+}
+
+void OverviewPyramid::save(const DerivedData& data,
+                           io::InputStream& image,
+                           size_t numLevels,
+                           WriteControl& writer,
+                           const std::string& pathname,
+                           const std::vector<std::string>& schemaPaths,
+                           Filter filter,
+                           size_t numThreads)
+{
+    mem::SharedPtr<Container> container(new Container(DataType::DERIVED));
+    container->addData(std::auto_ptr<Data>(data.clone()));
+    for (size_t level = 1; level <= numLevels; ++level)
+    {
+        container->addData(std::auto_ptr<Data>(
+                createOverviewData(data, level).release()));
+    }
+    writer.initialize(container);
+
+    // Stage the overviews next to the output file
+    std::string dirname = sys::Path::splitPath(pathname).first;
+    if (dirname.empty())
+    {
+        dirname = ".";
+    }
+
+    std::vector<mem::SharedPtr<LevelStream> > levelStreams;
+    std::vector<io::OutputStream*> outputs;
+    for (size_t level = 1; level <= numLevels; ++level)
+    {
+        levelStreams.push_back(mem::SharedPtr<LevelStream>(
+                new LevelStream(dirname)));
+        outputs.push_back(&levelStreams.back()->getOutput());
+    }
+
+    OverviewPyramid pyramid(
+            types::RowCol<size_t>(data.getNumRows(), data.getNumCols()),
+            data.getPixelType(), outputs, filter, numThreads);
+    TeeInputStream tee(image, pyramid);
+
+    SourceList sources;
+    sources.push_back(&tee);
+    for (size_t ii = 0; ii < levelStreams.size(); ++ii)
+    {
+        sources.push_back(levelStreams[ii].get());
+    }
+    writer.save(sources, pathname, schemaPaths);
+}
+}
+}
@@ -20,9 +20,75 @@
  *
  */
 
+#include <algorithm>
+
+#include <mt/ThreadGroup.h>
+#include <sys/AtomicCounter.h>
+#include <sys/OS.h>
+#include <sys/Runnable.h>
 #include <six/sidd/DerivedXMLControl.h>
 #include <six/sidd/SIDDByteProvider.h>
 
+namespace
+{
+//! One block of the image, copied by one thread
+struct BlockJob
+{
+    const sys::byte* input;
+    sys::byte* output;
+    size_t numRowsPerBlock;
+    size_t numValidRows;
+    size_t numValidCols;
+};
+
+class BlockRunnable : public sys::Runnable
+{
+public:
+    BlockRunnable(const std::vector<BlockJob>& jobs,
+                  size_t numBytesPerPixel,
+                  size_t numCols,
+                  size_t numColsPerBlock,
+                  sys::AtomicCounter& nextJob) :
+        mJobs(jobs),
+        mNumBytesPerPixel(numBytesPerPixel),
+        mNumCols(numCols),
+        mNumColsPerBlock(numColsPerBlock),
+        mNextJob(nextJob)
+    {
+    }
+
+    virtual void run()
+    {
+        while (true)
+        {
+            const size_t index =
+                    static_cast<size_t>(mNextJob.getThenIncrement());
+            if (index >= mJobs.size())
+            {
+                break;
+            }
+
+            const BlockJob& job = mJobs[index];
+            nitf::ImageBlocker::block(job.input,
+                                      mNumBytesPerPixel,
+                                      mNumCols,
+                                      job.numRowsPerBlock,
+                                      mNumColsPerBlock,
+                                      job.numValidRows,
+                                      job.numValidCols,
+                                      job.output);
+        }
+    }
+
+private:
+    const std::vector<BlockJob>& mJobs;
+    const size_t mNumBytesPerPixel;
+    const size_t mNumCols;
+    const size_t mNumColsPerBlock;
+    sys::AtomicCounter& mNextJob;
+};
+}
+
 namespace six
 {
 namespace sidd
@@ -47,12 +113,147 @@ SIDDByteProvider::SIDDByteProvider(
 
     initialize(container, xmlRegistry, schemaPaths,
                maxProductSize, numRowsPerBlock, numColsPerBlock);
+    initializeBlocker();
 }
 
 SIDDByteProvider::SIDDByteProvider(const NITFWriteControl& writer,
                                    const std::vector<std::string>& schemaPaths)
 {
     initialize(writer, schemaPaths);
+    initializeBlocker();
+}
+
+void SIDDByteProvider::initializeBlocker()
+{
+    if (isBlocked())
+    {
+        mImageBlocker.reset(getImageBlocker().release());
+    }
+}
+
+bool SIDDByteProvider::isBlocked() const
+{
+    return mOverallNumRowsPerBlock != 0 || mNumColsPerBlock != mNumCols;
+}
+
+size_t SIDDByteProvider::getNumBlockedBytes(size_t startRow,
+                                            size_t numRows) const
+{
+    if (!isBlocked())
+    {
+        return 0;
+    }
+    return mImageBlocker->getNumBytesRequired(startRow, numRows,
+                                              mNumBytesPerPixel);
+}
+
+void SIDDByteProvider::getBlockedBytes(const void* imageData,
+                                       size_t startRow,
+                                       size_t numRows,
+                                       void* blockedData,
+                                       nitf::Off& fileOffset,
+                                       nitf::NITFBufferList& buffers,
+                                       size_t numThreads) const
+{
+    if (!isBlocked())
+    {
+        getBytes(imageData, startRow, numRows, fileOffset, buffers);
+        return;
+    }
+
+    // Make sure the rows line up with the blocks before doing any work
+    const nitf::ImageBlocker& blocker = *mImageBlocker;
+    blocker.getNumBytesRequired(startRow, numRows, mNumBytesPerPixel);
+
+    // Lay out every block up front, going a row of blocks at a time since
+    // the number of rows per block can change from segment to segment
+    const std::vector<size_t> numRowsPerBlock = blocker.getNumRowsPerBlock();
+    const size_t numColsPerBlock = blocker.getNumColsPerBlock();
+    const size_t numColsOfBlocks = blocker.getNumColsOfBlocks();
+    const size_t inputStride = mNumCols * mNumBytesPerPixel;
+
+    std::vector<BlockJob> jobs;
+    const sys::byte* input = static_cast<const sys::byte*>(imageData);
+    sys::byte* output = static_cast<sys::byte*>(blockedData);
+    const size_t endRow = startRow + numRows;
+    size_t seg = 0;
+    for (size_t row = startRow; row < endRow; )
+    {
+        while (row >= blocker.getStartRow(seg) + blocker.getNumRows(seg))
+        {
+            ++seg;
+        }
+        const size_t segEndRow =
+                blocker.getStartRow(seg) + blocker.getNumRows(seg);
+        const size_t numValidRows = std::min(
+                std::min(numRowsPerBlock[seg], segEndRow - row),
+                endRow - row);
+
+        const size_t numBytesThisRow = blocker.getNumBytesRequired(
+                row, numValidRows, mNumBytesPerPixel);
+        const size_t numBytesPerBlock = numBytesThisRow / numColsOfBlocks;
+
+        for (size_t col = 0; col < numColsOfBlocks; ++col)
+        {
+            BlockJob job;
+            job.input = input + col * numColsPerBlock * mNumBytesPerPixel;
+            job.output = output + col * numBytesPerBlock;
+            job.numRowsPerBlock = numRowsPerBlock[seg];
+            job.numValidRows = numValidRows;
+            job.numValidCols = std::min(numColsPerBlock,
+                                        mNumCols - col * numColsPerBlock);
+            jobs.push_back(job);
+        }
+
+        input += numValidRows * inputStride;
+        output += numBytesThisRow;
+        row += numValidRows;
+    }
+
+    if (numThreads == 0)
+    {
+        numThreads = sys::OS().getNumCPUsAvailable();
+    }
+    numThreads = std::min(numThreads, jobs.size());
+
+    sys::AtomicCounter nextJob;
+    if (numThreads <= 1)
+    {
+        BlockRunnable(jobs, mNumBytesPerPixel, mNumCols, numColsPerBlock,
+                      nextJob).run();
+    }
+    else
+    {
+        mt::ThreadGroup threads;
+        for (size_t ii = 0; ii < numThreads; ++ii)
+        {
+            std::auto_ptr<sys::Runnable> runnable(new BlockRunnable(
+                    jobs, mNumBytesPerPixel, mNumCols, numColsPerBlock,
+                    nextJob));
+            threads.createThread(runnable);
+        }
+        threads.joinAll();
+    }
+
+    getBytes(blockedData, startRow, numRows, fileOffset, buffers);
+}
+
+void SIDDByteProvider::getBlockedBytes(const void* imageData,
+                                       size_t startRow,
+                                       size_t numRows,
+                                       std::vector<sys::byte>& blockedData,
+                                       nitf::Off& fileOffset,
+                                       nitf::NITFBufferList& buffers,
+                                       size_t numThreads) const
+{
+    const size_t numBytes = getNumBlockedBytes(startRow, numRows);
+    if (blockedData.size() < numBytes)
+    {
+        blockedData.resize(numBytes);
+    }
+    getBlockedBytes(imageData, startRow, numRows,
+                    blockedData.empty() ? NULL : &blockedData[0],
+                    fileOffset, buffers, numThreads);
 }
 }
 }
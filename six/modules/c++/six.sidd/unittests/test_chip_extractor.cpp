@@ -0,0 +1,200 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <string>
+#include <vector>
+
+#include "TestCase.h"
+
+#include <io/TempFile.h>
+#include <six/NITFReadControl.h>
+#include <six/XMLControlFactory.h>
+#include <six/sidd/ChipExtractor.h>
+#include <six/sidd/CropUtils.h>
+#include <six/sidd/DerivedXMLControl.h>
+#include <sys/OS.h>
+#include <sys/Path.h>
+
+namespace
+{
+typedef six::ChipExtractor::Chip Chip;
+
+sys::Path exePath;
+
+std::string findSixHome()
+{
+    sys::Path sixHome = exePath.join("..");
+    do
+    {
+        const sys::Path croppedNitfs = sixHome.join("croppedNitfs");
+        if (sys::OS().isDirectory(croppedNitfs.getAbsolutePath()))
+        {
+            return sixHome;
+        }
+        sixHome = sixHome.join("..");
+    } while (sixHome.getAbsolutePath() != sixHome.join("..").getAbsolutePath());
+    return "";
+}
+
+std::string getSIDDPathname()
+{
+    const std::string sixHome = findSixHome();
+    if (sixHome.empty())
+    {
+        throw except::Exception(Ctxt(
+                "Environment error: Cannot determine source tree root"));
+    }
+    return sys::Path(sixHome).join("croppedNitfs").join("SIDD").
+            join("cropped_sidd.nitf").getAbsolutePath();
+}
+
+std::vector<six::UByte> readChip(six::NITFReadControl& reader,
+                                 const Chip& chip)
+{
+    const size_t numBytesPerPixel =
+            reader.getContainer()->getData(0)->getNumBytesPerPixel();
+    std::vector<six::UByte> buffer(chip.dims.area() * numBytesPerPixel);
+
+    six::Region region;
+    region.setStartRow(chip.offset.row);
+    region.setStartCol(chip.offset.col);
+    region.setNumRows(chip.dims.row);
+    region.setNumCols(chip.dims.col);
+    region.setBuffer(&buffer[0]);
+    reader.interleaved(region, 0);
+    return buffer;
+}
+
+const six::sidd::DerivedData& getDerivedData(six::NITFReadControl& reader)
+{
+    return *reinterpret_cast<const six::sidd::DerivedData*>(
+            reader.getContainer()->getData(0));
+}
+
+std::vector<Chip> getChips()
+{
+    std::vector<Chip> chips;
+    chips.push_back(Chip(types::RowCol<size_t>(2, 1),
+                         types::RowCol<size_t>(3, 3)));
+    chips.push_back(Chip(types::RowCol<size_t>(0, 0),
+                         types::RowCol<size_t>(5, 5)));
+    chips.push_back(Chip(types::RowCol<size_t>(1, 2),
+                         types::RowCol<size_t>(1, 3)));
+    return chips;
+}
+
+TEST_CASE(testExtractToMemory)
+{
+    six::NITFReadControl reader;
+    reader.load(getSIDDPathname(), std::vector<std::string>());
+    const std::vector<Chip> chips = getChips();
+
+    for (size_t blockSize = 1; blockSize <= 100; blockSize *= 10)
+    {
+        const six::sidd::ChipExtractor extractor(reader, 0, 2, blockSize);
+        std::vector<std::vector<six::UByte> > buffers;
+        extractor.extract(chips, buffers);
+        for (size_t ii = 0; ii < chips.size(); ++ii)
+        {
+            TEST_ASSERT(buffers[ii] == readChip(reader, chips[ii]));
+        }
+    }
+
+    TEST_EXCEPTION(six::sidd::ChipExtractor(reader, 1));
+}
+
+TEST_CASE(testExtractToFiles)
+{
+    const std::vector<std::string> schemaPaths;
+    six::NITFReadControl reader;
+    reader.load(getSIDDPathname(), schemaPaths);
+    const std::vector<Chip> chips = getChips();
+
+    std::vector<mem::SharedPtr<io::TempFile> > files;
+    std::vector<std::string> pathnames;
+    for (size_t ii = 0; ii < chips.size(); ++ii)
+    {
+        files.push_back(mem::SharedPtr<io::TempFile>(new io::TempFile()));
+        pathnames.push_back(files.back()->pathname());
+    }
+    six::sidd::ChipExtractor(reader).extract(chips, pathnames, schemaPaths);
+
+    // Same as cropping each chip on its own
+    for (size_t ii = 0; ii < chips.size(); ++ii)
+    {
+        const io::TempFile cropped;
+        six::sidd::cropSIDD(getSIDDPathname(), schemaPaths, chips[ii].offset,
+                            chips[ii].dims, cropped.pathname());
+
+        six::NITFReadControl chipReader;
+        chipReader.load(pathnames[ii], schemaPaths);
+        six::NITFReadControl croppedReader;
+        croppedReader.load(cropped.pathname(), schemaPaths);
+
+        TEST_ASSERT(getDerivedData(chipReader) ==
+                    getDerivedData(croppedReader));
+        const Chip wholeChip(types::RowCol<size_t>(0, 0), chips[ii].dims);
+        TEST_ASSERT(readChip(chipReader, wholeChip) ==
+                    readChip(reader, chips[ii]));
+    }
+}
+
+TEST_CASE(testChipOfChip)
+{
+    const std::vector<std::string> schemaPaths;
+    const io::TempFile cropped;
+    six::sidd::cropSIDD(getSIDDPathname(), schemaPaths,
+                        types::RowCol<size_t>(1, 2),
+                        types::RowCol<size_t>(4, 3),
+                        cropped.pathname());
+
+    six::NITFReadControl reader;
+    reader.load(cropped.pathname(), schemaPaths);
+    const six::sidd::ChipExtractor extractor(reader);
+    const std::auto_ptr<six::Data> data = extractor.cropMetadata(
+            Chip(types::RowCol<size_t>(1, 1), types::RowCol<size_t>(2, 2)));
+
+    // Coordinates are still relative to the full image
+    const six::sidd::GeometricChip& chip =
+            *reinterpret_cast<const six::sidd::DerivedData*>(data.get())->
+                    downstreamReprocessing->geometricChip;
+    TEST_ASSERT_EQ(chip.chipSize.row, 2);
+    TEST_ASSERT_EQ(chip.chipSize.col, 2);
+    TEST_ASSERT_EQ(chip.originalUpperLeftCoordinate.row, 2.0);
+    TEST_ASSERT_EQ(chip.originalUpperLeftCoordinate.col, 3.0);
+    TEST_ASSERT_EQ(chip.originalLowerRightCoordinate.row, 3.0);
+    TEST_ASSERT_EQ(chip.originalLowerRightCoordinate.col, 4.0);
+}
+}
+
+int main(int, char** argv)
+{
+    exePath = sys::Path(argv[0]).getAbsolutePath();
+
+    six::XMLControlFactory::getInstance().addCreator(
+            six::DataType::DERIVED,
+            new six::XMLControlCreatorT<six::sidd::DerivedXMLControl>());
+
+    TEST_CHECK(testExtractToMemory);
+    TEST_CHECK(testExtractToFiles);
+    TEST_CHECK(testChipOfChip);
+    return 0;
+}
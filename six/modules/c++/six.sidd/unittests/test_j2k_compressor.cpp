@@ -0,0 +1,269 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cstdlib>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "TestCase.h"
+
+#include <nitf/NITFBufferList.hpp>
+#include <six/sidd/CompressedSIDDByteProvider.h>
+#include <six/sidd/J2KCompressor.h>
+#include <six/sidd/Utilities.h>
+
+namespace
+{
+std::vector<sys::ubyte> createImage(const types::RowCol<size_t>& dims,
+                                    size_t numBytesPerPixel)
+{
+    // Smooth enough to compress, with some texture so blocks differ
+    std::vector<sys::ubyte> image(dims.area() * numBytesPerPixel);
+    for (size_t ii = 0; ii < image.size(); ++ii)
+    {
+        const size_t row = ii / (dims.col * numBytesPerPixel);
+        const size_t col = ii % (dims.col * numBytesPerPixel);
+        image[ii] = static_cast<sys::ubyte>(row / 3 + col / 5 + ii % 7);
+    }
+    return image;
+}
+
+size_t sum(const std::vector<size_t>& values)
+{
+    return std::accumulate(values.begin(), values.end(),
+                           static_cast<size_t>(0));
+}
+
+bool isCodestream(const sys::ubyte* bytes, size_t numBytes)
+{
+    return numBytes >= 4 &&
+           bytes[0] == 0xFF && bytes[1] == 0x4F &&
+           bytes[numBytes - 2] == 0xFF && bytes[numBytes - 1] == 0xD9;
+}
+
+/*
+ * Compressing blocks separately has to give back exactly what compressing
+ * the whole segment at once does
+ */
+bool threadCountsMatch(const types::RowCol<size_t>& dims,
+                       size_t numBytesPerPixel,
+                       const types::RowCol<size_t>& blockDims)
+{
+    const std::vector<sys::ubyte> image = createImage(dims, numBytesPerPixel);
+
+    std::vector<sys::ubyte> serial;
+    std::vector<size_t> serialBytesPerBlock;
+    six::sidd::J2KCompressor(1).compress(&image[0], dims, numBytesPerPixel,
+                                         blockDims, serial,
+                                         serialBytesPerBlock);
+
+    std::vector<sys::ubyte> parallel;
+    std::vector<size_t> parallelBytesPerBlock;
+    six::sidd::J2KCompressor(4).compress(&image[0], dims, numBytesPerPixel,
+                                         blockDims, parallel,
+                                         parallelBytesPerBlock);
+
+    return isCodestream(&serial[0], serial.size()) &&
+           sum(serialBytesPerBlock) == serial.size() &&
+           serial == parallel &&
+           serialBytesPerBlock == parallelBytesPerBlock;
+}
+
+TEST_CASE(testNotAvailable)
+{
+    if (six::sidd::J2KCompressor::isAvailable())
+    {
+        return;
+    }
+
+    const types::RowCol<size_t> dims(16, 16);
+    const std::vector<sys::ubyte> image = createImage(dims, 1);
+    std::vector<sys::ubyte> compressed;
+    std::vector<size_t> bytesPerBlock;
+    TEST_EXCEPTION(six::sidd::J2KCompressor().compress(
+            &image[0], dims, 1, types::RowCol<size_t>(0, 0),
+            compressed, bytesPerBlock));
+}
+
+TEST_CASE(testBlocksMatchWholeSegment)
+{
+    if (!six::sidd::J2KCompressor::isAvailable())
+    {
+        return;
+    }
+
+    // Power of two blocks, with partial blocks on the bottom and right
+    TEST_ASSERT(threadCountsMatch(types::RowCol<size_t>(300, 200), 1,
+                                  types::RowCol<size_t>(128, 64)));
+    TEST_ASSERT(threadCountsMatch(types::RowCol<size_t>(300, 200), 2,
+                                  types::RowCol<size_t>(64, 128)));
+
+    // Single row blocks at the bottom that come out bigger than their
+    // pixels
+    TEST_ASSERT(threadCountsMatch(types::RowCol<size_t>(257, 200), 1,
+                                  types::RowCol<size_t>(128, 64)));
+
+    // Blocked in only one direction
+    TEST_ASSERT(threadCountsMatch(types::RowCol<size_t>(300, 75), 1,
+                                  types::RowCol<size_t>(64, 0)));
+
+    // Not a power of two, so these are compressed whole
+    TEST_ASSERT(threadCountsMatch(types::RowCol<size_t>(300, 200), 1,
+                                  types::RowCol<size_t>(100, 100)));
+
+    // Unblocked
+    TEST_ASSERT(threadCountsMatch(types::RowCol<size_t>(100, 90), 1,
+                                  types::RowCol<size_t>(0, 0)));
+}
+
+TEST_CASE(testIncompressible)
+{
+    if (!six::sidd::J2KCompressor::isAvailable())
+    {
+        return;
+    }
+
+    // The J2K headers alone are bigger than these images, and noise
+    // doesn't compress, so the codestreams are bigger than the pixels
+    std::srand(0);
+    const types::RowCol<size_t> tinyDims(2, 3);
+    std::vector<sys::ubyte> tiny(tinyDims.area());
+    const types::RowCol<size_t> noiseDims(64, 64);
+    std::vector<sys::ubyte> noise(noiseDims.area() * 2);
+    for (size_t ii = 0; ii < tiny.size(); ++ii)
+    {
+        tiny[ii] = static_cast<sys::ubyte>(std::rand());
+    }
+    for (size_t ii = 0; ii < noise.size(); ++ii)
+    {
+        noise[ii] = static_cast<sys::ubyte>(std::rand());
+    }
+
+    std::vector<sys::ubyte> compressed;
+    std::vector<size_t> bytesPerBlock;
+    six::sidd::J2KCompressor(2).compress(&tiny[0], tinyDims, 1,
+                                         types::RowCol<size_t>(0, 0),
+                                         compressed, bytesPerBlock);
+    TEST_ASSERT(isCodestream(&compressed[0], compressed.size()));
+    TEST_ASSERT(compressed.size() > tiny.size());
+
+    six::sidd::J2KCompressor(2).compress(&noise[0], noiseDims, 2,
+                                         types::RowCol<size_t>(32, 32),
+                                         compressed, bytesPerBlock);
+    TEST_ASSERT(isCodestream(&compressed[0], compressed.size()));
+    TEST_ASSERT_EQ(sum(bytesPerBlock), compressed.size());
+}
+
+TEST_CASE(testBytesPerBlock)
+{
+    if (!six::sidd::J2KCompressor::isAvailable())
+    {
+        return;
+    }
+
+    const types::RowCol<size_t> dims(300, 200);
+    const std::vector<sys::ubyte> image = createImage(dims, 1);
+
+    std::vector<sys::ubyte> compressed;
+    std::vector<size_t> bytesPerBlock;
+    six::sidd::J2KCompressor(2).compress(&image[0], dims, 1,
+                                         types::RowCol<size_t>(128, 128),
+                                         compressed, bytesPerBlock);
+
+    // Each block after the first starts with its SOT marker
+    TEST_ASSERT_EQ(bytesPerBlock.size(), 6);
+    size_t offset = 0;
+    for (size_t ii = 0; ii < bytesPerBlock.size(); ++ii)
+    {
+        if (ii > 0)
+        {
+            TEST_ASSERT_EQ(compressed[offset], 0xFF);
+            TEST_ASSERT_EQ(compressed[offset + 1], 0x90);
+            const size_t tileIndex =
+                    (compressed[offset + 4] << 8) | compressed[offset + 5];
+            TEST_ASSERT_EQ(tileIndex, ii);
+        }
+        offset += bytesPerBlock[ii];
+    }
+    TEST_ASSERT_EQ(offset, compressed.size());
+}
+
+TEST_CASE(testMultipleSegments)
+{
+    if (!six::sidd::J2KCompressor::isAvailable())
+    {
+        return;
+    }
+
+    const types::RowCol<size_t> dims(256, 128);
+    const size_t numRowsPerBlock = 32;
+    const size_t numColsPerBlock = 64;
+
+    std::auto_ptr<six::sidd::DerivedData> data =
+            six::sidd::Utilities::createFakeDerivedData();
+    data->setNumRows(dims.row);
+    data->setNumCols(dims.col);
+    data->setPixelType(six::PixelType::MONO8I);
+    const std::vector<sys::ubyte> image = createImage(dims, 1);
+
+    // Segments of 96 rows, so the last one is shorter than the rest
+    const size_t maxProductSize = 96 * dims.col;
+    std::vector<sys::ubyte> compressed;
+    std::vector<std::vector<size_t> > bytesPerBlock;
+    six::sidd::J2KCompressor().compress(*data, &image[0],
+                                        numRowsPerBlock, numColsPerBlock,
+                                        maxProductSize,
+                                        compressed, bytesPerBlock);
+    TEST_ASSERT_EQ(bytesPerBlock.size(), 3);
+
+    size_t offset = 0;
+    for (size_t ii = 0; ii < bytesPerBlock.size(); ++ii)
+    {
+        const size_t numBytes = sum(bytesPerBlock[ii]);
+        TEST_ASSERT(isCodestream(&compressed[offset], numBytes));
+        offset += numBytes;
+    }
+    TEST_ASSERT_EQ(offset, compressed.size());
+
+    // And it's laid out the way the byte provider expects
+    const six::sidd::CompressedSIDDByteProvider byteProvider(
+            *data, std::vector<std::string>(), bytesPerBlock, true,
+            numRowsPerBlock, numColsPerBlock, maxProductSize);
+    nitf::Off fileOffset;
+    nitf::NITFBufferList buffers;
+    byteProvider.getBytes(&compressed[0], 0, dims.row, fileOffset, buffers);
+    TEST_ASSERT_EQ(fileOffset, 0);
+    TEST_ASSERT_EQ(buffers.getTotalNumBytes(),
+                   static_cast<size_t>(byteProvider.getNumBytes(0, dims.row)));
+}
+}
+
+int main(int, char**)
+{
+    TEST_CHECK(testNotAvailable);
+    TEST_CHECK(testBlocksMatchWholeSegment);
+    TEST_CHECK(testIncompressible);
+    TEST_CHECK(testBytesPerBlock);
+    TEST_CHECK(testMultipleSegments);
+    return 0;
+}
@@ -0,0 +1,289 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+#include <vector>
+
+#include "TestCase.h"
+
+#include <io/FileOutputStream.h>
+#include <io/TempFile.h>
+#include <logging/NullLogger.h>
+#include <nitf/NITFBufferList.hpp>
+#include <six/NITFReadControl.h>
+#include <six/XMLControlFactory.h>
+#include <six/sidd/CompressedSIDDByteProvider.h>
+#include <six/sidd/DerivedXMLControl.h>
+#include <six/sidd/J2KCompressor.h>
+#include <six/sidd/J2KDecompressor.h>
+#include <six/sidd/Utilities.h>
+
+namespace
+{
+// Blocks big enough for J2KCompressor to use two decomposition levels
+const types::RowCol<size_t> DIMS(600, 512);
+const size_t NUM_ROWS_PER_BLOCK = 256;
+const size_t NUM_COLS_PER_BLOCK = 256;
+
+// Segments of 256 rows, so the last one is shorter than the rest
+const size_t MAX_PRODUCT_SIZE = 256 * DIMS.col;
+
+std::vector<sys::ubyte> createImage()
+{
+    std::vector<sys::ubyte> image(DIMS.area());
+    for (size_t row = 0, idx = 0; row < DIMS.row; ++row)
+    {
+        for (size_t col = 0; col < DIMS.col; ++col, ++idx)
+        {
+            image[idx] = static_cast<sys::ubyte>(row / 2 + col / 16);
+        }
+    }
+    return image;
+}
+
+void writeSIDD(const std::string& pathname,
+               const std::vector<sys::ubyte>& image)
+{
+    std::auto_ptr<six::sidd::DerivedData> data =
+            six::sidd::Utilities::createFakeDerivedData();
+    data->setNumRows(DIMS.row);
+    data->setNumCols(DIMS.col);
+    data->setPixelType(six::PixelType::MONO8I);
+
+    std::vector<sys::ubyte> compressed;
+    std::vector<std::vector<size_t> > bytesPerBlock;
+    six::sidd::J2KCompressor().compress(*data, &image[0],
+                                        NUM_ROWS_PER_BLOCK,
+                                        NUM_COLS_PER_BLOCK,
+                                        MAX_PRODUCT_SIZE,
+                                        compressed, bytesPerBlock);
+
+    const six::sidd::CompressedSIDDByteProvider byteProvider(
+            *data, std::vector<std::string>(), bytesPerBlock, true,
+            NUM_ROWS_PER_BLOCK, NUM_COLS_PER_BLOCK, MAX_PRODUCT_SIZE);
+    nitf::Off fileOffset;
+    nitf::NITFBufferList buffers;
+    byteProvider.getBytes(&compressed[0], 0, DIMS.row, fileOffset, buffers);
+
+    io::FileOutputStream outStream(pathname);
+    for (size_t ii = 0; ii < buffers.mBuffers.size(); ++ii)
+    {
+        outStream.write(
+                static_cast<const sys::byte*>(buffers.mBuffers[ii].mData),
+                buffers.mBuffers[ii].mNumBytes);
+    }
+    outStream.close();
+}
+
+/*
+ * Writes a J2K compressed SIDD once and loads it for the tests to share
+ */
+class CompressedSIDD
+{
+public:
+    CompressedSIDD() :
+        mImage(createImage())
+    {
+        writeSIDD(mFile.pathname(), mImage);
+
+        mXMLRegistry.addCreator(six::DataType::DERIVED,
+                                new six::XMLControlCreatorT<
+                                        six::sidd::DerivedXMLControl>());
+        mReader.setLogger(&mLog);
+        mReader.setXMLControlRegistry(&mXMLRegistry);
+        mReader.load(mFile.pathname(), std::vector<std::string>());
+    }
+
+    const std::vector<sys::ubyte>& getImage() const
+    {
+        return mImage;
+    }
+
+    const std::string getPathname() const
+    {
+        return mFile.pathname();
+    }
+
+    const six::NITFReadControl& getReader() const
+    {
+        return mReader;
+    }
+
+private:
+    const std::vector<sys::ubyte> mImage;
+    const io::TempFile mFile;
+    logging::NullLogger mLog;
+    six::XMLControlRegistry mXMLRegistry;
+    six::NITFReadControl mReader;
+};
+
+const CompressedSIDD& getCompressedSIDD()
+{
+    static const CompressedSIDD sidd;
+    return sidd;
+}
+
+bool readMatches(const types::RowCol<size_t>& offset,
+                 const types::RowCol<size_t>& dims,
+                 size_t numThreads)
+{
+    const CompressedSIDD& sidd = getCompressedSIDD();
+    const six::sidd::J2KDecompressor decompressor(sidd.getReader(),
+                                                  sidd.getPathname(),
+                                                  numThreads);
+
+    std::vector<sys::ubyte> buffer(dims.area());
+    six::Region region;
+    region.setStartRow(offset.row);
+    region.setStartCol(offset.col);
+    region.setNumRows(dims.row);
+    region.setNumCols(dims.col);
+    region.setBuffer(&buffer[0]);
+    decompressor.read(region, 0);
+
+    const std::vector<sys::ubyte>& image = sidd.getImage();
+    for (size_t row = 0; row < dims.row; ++row)
+    {
+        for (size_t col = 0; col < dims.col; ++col)
+        {
+            if (buffer[row * dims.col + col] !=
+                image[(offset.row + row) * DIMS.col + offset.col + col])
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+TEST_CASE(testNotAvailable)
+{
+    if (six::sidd::J2KDecompressor::isAvailable())
+    {
+        return;
+    }
+
+    const six::NITFReadControl reader;
+    TEST_EXCEPTION(six::sidd::J2KDecompressor(reader, "unused.nitf"));
+}
+
+TEST_CASE(testReadRegions)
+{
+    if (!six::sidd::J2KDecompressor::isAvailable())
+    {
+        return;
+    }
+
+    // Whole image, one tile, and regions crossing tiles and segments
+    for (size_t numThreads = 1; numThreads <= 4; numThreads += 3)
+    {
+        TEST_ASSERT(readMatches(types::RowCol<size_t>(0, 0), DIMS,
+                                numThreads));
+        TEST_ASSERT(readMatches(types::RowCol<size_t>(256, 256),
+                                types::RowCol<size_t>(256, 256),
+                                numThreads));
+        TEST_ASSERT(readMatches(types::RowCol<size_t>(100, 37),
+                                types::RowCol<size_t>(450, 400),
+                                numThreads));
+        TEST_ASSERT(readMatches(types::RowCol<size_t>(599, 511),
+                                types::RowCol<size_t>(1, 1),
+                                numThreads));
+    }
+}
+
+TEST_CASE(testReadWholeImage)
+{
+    if (!six::sidd::J2KDecompressor::isAvailable())
+    {
+        return;
+    }
+
+    const CompressedSIDD& sidd = getCompressedSIDD();
+    const six::sidd::J2KDecompressor decompressor(sidd.getReader(),
+                                                  sidd.getPathname());
+    TEST_ASSERT(decompressor.getDims(0) == DIMS);
+
+    six::Region region;
+    const std::auto_ptr<six::UByte> buffer(decompressor.read(region, 0));
+    TEST_ASSERT_EQ(region.getNumRows(), static_cast<sys::SSize_T>(DIMS.row));
+    TEST_ASSERT_EQ(region.getNumCols(), static_cast<sys::SSize_T>(DIMS.col));
+    TEST_ASSERT(std::equal(sidd.getImage().begin(), sidd.getImage().end(),
+                           buffer.get()));
+}
+
+TEST_CASE(testReducedResolution)
+{
+    if (!six::sidd::J2KDecompressor::isAvailable())
+    {
+        return;
+    }
+
+    const CompressedSIDD& sidd = getCompressedSIDD();
+    const six::sidd::J2KDecompressor decompressor(sidd.getReader(),
+                                                  sidd.getPathname(), 4);
+    const size_t numLevels = decompressor.getNumResolutionLevels(0);
+    TEST_ASSERT_EQ(numLevels, 3);
+
+    // Segments of 256, 256, and 88 rows are each halved, rounding up
+    TEST_ASSERT(decompressor.getDims(0, 1) ==
+                types::RowCol<size_t>(128 + 128 + 44, 256));
+    TEST_ASSERT(decompressor.getDims(0, 2) ==
+                types::RowCol<size_t>(64 + 64 + 22, 128));
+
+    six::Region region;
+    std::auto_ptr<six::UByte> buffer(decompressor.read(region, 0, 2));
+    TEST_ASSERT_EQ(region.getNumRows(), 150);
+    TEST_ASSERT_EQ(region.getNumCols(), 128);
+
+    region = six::Region();
+    TEST_EXCEPTION(decompressor.read(region, 0, numLevels));
+}
+
+TEST_CASE(testBadRegion)
+{
+    if (!six::sidd::J2KDecompressor::isAvailable())
+    {
+        return;
+    }
+
+    const CompressedSIDD& sidd = getCompressedSIDD();
+    const six::sidd::J2KDecompressor decompressor(sidd.getReader(),
+                                                  sidd.getPathname());
+    six::Region region;
+    region.setStartRow(DIMS.row - 10);
+    region.setNumRows(11);
+    TEST_EXCEPTION(decompressor.read(region, 0));
+
+    region = six::Region();
+    TEST_EXCEPTION(decompressor.read(region, 1));
+}
+}
+
+int main(int, char**)
+{
+    TEST_CHECK(testNotAvailable);
+    TEST_CHECK(testReadRegions);
+    TEST_CHECK(testReadWholeImage);
+    TEST_CHECK(testReducedResolution);
+    TEST_CHECK(testBadRegion);
+    return 0;
+}
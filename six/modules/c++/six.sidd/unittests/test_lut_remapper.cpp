@@ -0,0 +1,239 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "TestCase.h"
+
+#include <io/ByteStream.h>
+#include <six/sidd/LUTRemapper.h>
+#include <six/sidd/Utilities.h>
+
+namespace
+{
+typedef six::sidd::LUTRemapper LUTRemapper;
+
+six::LUT createLUT(size_t numEntries, size_t elementSize, size_t scale)
+{
+    six::LUT lut(numEntries, elementSize);
+    for (size_t ii = 0; ii < numEntries; ++ii)
+    {
+        const size_t value = ii * scale + 1;
+        if (elementSize == 2)
+        {
+            const sys::Uint16_T entry = static_cast<sys::Uint16_T>(value);
+            std::memcpy(lut[ii], &entry, sizeof(entry));
+        }
+        else
+        {
+            for (size_t jj = 0; jj < elementSize; ++jj)
+            {
+                lut[ii][jj] = static_cast<sys::ubyte>(value + jj);
+            }
+        }
+    }
+    return lut;
+}
+
+size_t lookUp(const six::LUT& lut, size_t value)
+{
+    const sys::ubyte* const entry = lut[std::min(value, lut.numEntries - 1)];
+    if (lut.elementSize == 2)
+    {
+        sys::Uint16_T result;
+        std::memcpy(&result, entry, sizeof(result));
+        return result;
+    }
+    return *entry;
+}
+
+TEST_CASE(testColorLUT)
+{
+    // RGB8LU --> RGB24I
+    const six::LUT lut(createLUT(256, 3, 7));
+    const LUTRemapper remapper(lut, 1);
+    TEST_ASSERT_EQ(remapper.getNumBands(), 1);
+    TEST_ASSERT_EQ(remapper.getNumInputBytesPerPixel(), 1);
+    TEST_ASSERT_EQ(remapper.getNumOutputBytesPerPixel(), 3);
+
+    std::vector<sys::ubyte> input(1000);
+    for (size_t ii = 0; ii < input.size(); ++ii)
+    {
+        input[ii] = static_cast<sys::ubyte>(ii * 13);
+    }
+    std::vector<sys::ubyte> output(input.size() * 3);
+    remapper.remap(&input[0], input.size(), &output[0]);
+    for (size_t ii = 0; ii < input.size(); ++ii)
+    {
+        TEST_ASSERT(std::equal(lut[input[ii]], lut[input[ii]] + 3,
+                               &output[ii * 3]));
+    }
+}
+
+TEST_CASE(test16BitTo8Bit)
+{
+    // Values past the end of the LUT use its last entry
+    const six::LUT lut(createLUT(1000, 1, 1));
+    const LUTRemapper remapper(lut, 2);
+    TEST_ASSERT_EQ(remapper.getNumInputBytesPerPixel(), 2);
+    TEST_ASSERT_EQ(remapper.getNumOutputBytesPerPixel(), 1);
+
+    const sys::Uint16_T input[] = { 0, 1, 254, 999, 1000, 65535 };
+    sys::ubyte output[6];
+    remapper.remap(reinterpret_cast<const six::UByte*>(input), 6, output);
+    for (size_t ii = 0; ii < 6; ++ii)
+    {
+        TEST_ASSERT_EQ(output[ii], lookUp(lut, input[ii]));
+    }
+}
+
+TEST_CASE(testChain)
+{
+    // 8-bit --> 16-bit --> 8-bit, composed into one table
+    const six::LUT first(createLUT(256, 2, 3));
+    const six::LUT second(createLUT(512, 1, 5));
+    LUTRemapper remapper(first);
+    remapper.append(second);
+    TEST_ASSERT_EQ(remapper.getNumInputBytesPerPixel(), 1);
+    TEST_ASSERT_EQ(remapper.getNumOutputBytesPerPixel(), 1);
+
+    std::vector<sys::ubyte> input(256);
+    for (size_t ii = 0; ii < input.size(); ++ii)
+    {
+        input[ii] = static_cast<sys::ubyte>(ii);
+    }
+    std::vector<sys::ubyte> output(input.size());
+    remapper.remap(&input[0], input.size(), &output[0]);
+    for (size_t ii = 0; ii < input.size(); ++ii)
+    {
+        TEST_ASSERT_EQ(output[ii], lookUp(second, lookUp(first, ii)));
+    }
+
+    // Nothing can follow a color LUT
+    remapper.append(createLUT(256, 3, 1));
+    TEST_EXCEPTION(remapper.append(second));
+}
+
+TEST_CASE(testBandLUTs)
+{
+    // Band equalization followed by one remap for all bands
+    six::sidd::LookupTable bandEqualization;
+    bandEqualization.custom.reset(new six::sidd::LookupTable::Custom(0, 0));
+    for (size_t band = 0; band < 3; ++band)
+    {
+        bandEqualization.custom->lutValues.push_back(
+                createLUT(256, 2, band + 1));
+    }
+    six::sidd::LookupTable dataRemapping;
+    dataRemapping.custom.reset(new six::sidd::LookupTable::Custom(0, 0));
+    dataRemapping.custom->lutValues.push_back(createLUT(1024, 1, 1));
+
+    LUTRemapper remapper(bandEqualization, 3);
+    remapper.append(dataRemapping);
+    TEST_ASSERT_EQ(remapper.getNumBands(), 3);
+    TEST_ASSERT_EQ(remapper.getNumInputBytesPerPixel(), 3);
+    TEST_ASSERT_EQ(remapper.getNumOutputBytesPerPixel(), 3);
+
+    // Enough pixels that every thread gets some
+    const size_t numPixels = 300 * 1000;
+    std::vector<sys::ubyte> input(numPixels * 3);
+    for (size_t ii = 0; ii < input.size(); ++ii)
+    {
+        input[ii] = static_cast<sys::ubyte>(ii * 7 + ii / 1000);
+    }
+    std::vector<sys::ubyte> output(input.size());
+    remapper.remap(&input[0], numPixels, &output[0]);
+    for (size_t ii = 0; ii < input.size(); ++ii)
+    {
+        const six::LUT& bandLUT =
+                bandEqualization.custom->lutValues[ii % 3];
+        TEST_ASSERT_EQ(output[ii],
+                       lookUp(dataRemapping.custom->lutValues[0],
+                              lookUp(bandLUT, input[ii])));
+    }
+
+    // Two LUTs for three bands is ambiguous
+    bandEqualization.custom->lutValues.pop_back();
+    TEST_EXCEPTION(remapper.append(bandEqualization));
+
+    six::sidd::LookupTable predefined;
+    predefined.predefined.reset(new six::sidd::LookupTable::Predefined());
+    TEST_EXCEPTION(LUTRemapper(predefined, 1));
+}
+
+TEST_CASE(testRemapRows)
+{
+    const types::RowCol<size_t> dims(37, 29);
+    const six::LUT lut(createLUT(70000 / 3, 2, 3));
+    const LUTRemapper remapper(lut, 2);
+
+    std::vector<sys::Uint16_T> input(dims.area());
+    for (size_t ii = 0; ii < input.size(); ++ii)
+    {
+        input[ii] = static_cast<sys::Uint16_T>(ii * 31);
+    }
+    std::vector<sys::Uint16_T> expected(input.size());
+    remapper.remap(reinterpret_cast<const six::UByte*>(&input[0]),
+                   input.size(),
+                   reinterpret_cast<six::UByte*>(&expected[0]));
+
+    io::ByteStream inStream;
+    inStream.write(&input[0], input.size() * sizeof(sys::Uint16_T));
+    inStream.seek(0, io::Seekable::START);
+    io::ByteStream outStream;
+    remapper.remapRows(inStream, dims.row, dims.col, outStream, 10);
+
+    std::vector<sys::Uint16_T> output(input.size());
+    outStream.seek(0, io::Seekable::START);
+    outStream.read(&output[0], output.size() * sizeof(sys::Uint16_T), true);
+    TEST_ASSERT(output == expected);
+    for (size_t ii = 0; ii < input.size(); ++ii)
+    {
+        TEST_ASSERT_EQ(output[ii], lookUp(lut, input[ii]));
+    }
+}
+
+TEST_CASE(testDisplayLUT)
+{
+    std::auto_ptr<six::sidd::DerivedData> data =
+            six::sidd::Utilities::createFakeDerivedData();
+    data->setVersion("2.0.0");
+    TEST_EXCEPTION(LUTRemapper(*data, 1));
+
+    data->nitfLUT.reset(new six::LUT(createLUT(256, 3, 1)));
+    const LUTRemapper remapper(*data);
+    TEST_ASSERT_EQ(remapper.getNumOutputBytesPerPixel(), 3);
+}
+}
+
+int main(int, char**)
+{
+    TEST_CHECK(testColorLUT);
+    TEST_CHECK(test16BitTo8Bit);
+    TEST_CHECK(testChain);
+    TEST_CHECK(testBandLUTs);
+    TEST_CHECK(testRemapRows);
+    TEST_CHECK(testDisplayLUT);
+    return 0;
+}
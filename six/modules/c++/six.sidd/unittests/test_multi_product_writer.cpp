@@ -0,0 +1,389 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "TestCase.h"
+
+#include <io/ByteStream.h>
+#include <io/TempFile.h>
+#include <logging/NullLogger.h>
+#include <six/NITFHeaderCreator.h>
+#include <six/NITFReadControl.h>
+#include <six/NITFWriteControl.h>
+#include <six/XMLControlFactory.h>
+#include <six/sidd/DerivedXMLControl.h>
+#include <six/sidd/MultiProductWriter.h>
+#include <six/sidd/OverviewPyramid.h>
+#include <six/sidd/Utilities.h>
+#include <sys/Path.h>
+
+namespace
+{
+typedef six::sidd::MultiProductWriter MultiProductWriter;
+typedef six::sidd::OverviewPyramid OverviewPyramid;
+
+// Odd sizes so the overviews have partial rows and columns
+const types::RowCol<size_t> DIMS(37, 23);
+
+class VectorOutputStream : public io::OutputStream
+{
+public:
+    virtual void write(const void* buffer, size_t len)
+    {
+        const sys::ubyte* const bytes =
+                static_cast<const sys::ubyte*>(buffer);
+        mBytes.insert(mBytes.end(), bytes, bytes + len);
+    }
+
+    using io::OutputStream::write;
+
+    const std::vector<sys::ubyte>& get() const
+    {
+        return mBytes;
+    }
+
+private:
+    std::vector<sys::ubyte> mBytes;
+};
+
+class Fixture
+{
+public:
+    Fixture(six::PixelType pixelType, size_t numLevels) :
+        mPixelType(pixelType),
+        mNumBytesPerPixel(pixelType == six::PixelType::MONO16I ? 2 : 1),
+        mNumLevels(numLevels)
+    {
+        for (size_t level = 1; level <= mNumLevels; ++level)
+        {
+            mLevels.push_back(level);
+        }
+
+        mXMLRegistry.addCreator(six::DataType::DERIVED,
+                                new six::XMLControlCreatorT<
+                                        six::sidd::DerivedXMLControl>());
+
+        mImage.resize(DIMS.area() * mNumBytesPerPixel);
+        for (size_t ii = 0; ii < mImage.size(); ++ii)
+        {
+            mImage[ii] = static_cast<sys::ubyte>((ii * 37) % 251);
+        }
+
+        std::vector<VectorOutputStream> levels(mNumLevels);
+        std::vector<io::OutputStream*> outputs;
+        for (size_t ii = 0; ii < mNumLevels; ++ii)
+        {
+            outputs.push_back(&levels[ii]);
+        }
+        OverviewPyramid pyramid(DIMS, mPixelType, outputs);
+        pyramid.write(&mImage[0], mImage.size());
+
+        mExpected.push_back(mImage);
+        for (size_t ii = 0; ii < mNumLevels; ++ii)
+        {
+            mExpected.push_back(levels[ii].get());
+        }
+    }
+
+    mem::SharedPtr<six::Container> createContainer() const
+    {
+        std::auto_ptr<six::sidd::DerivedData> data =
+                six::sidd::Utilities::createFakeDerivedData();
+        data->setNumRows(DIMS.row);
+        data->setNumCols(DIMS.col);
+        data->setPixelType(mPixelType);
+
+        mem::SharedPtr<six::Container> container(
+                new six::Container(six::DataType::DERIVED));
+        container->addData(std::auto_ptr<six::Data>(data->clone()));
+        for (size_t ii = 0; ii < mLevels.size(); ++ii)
+        {
+            container->addData(std::auto_ptr<six::Data>(
+                    OverviewPyramid::createOverviewData(*data, mLevels[ii])
+                            .release()));
+        }
+        return container;
+    }
+
+    void initialize(six::NITFWriteControl& writer,
+                    size_t maxProductSize = 0) const
+    {
+        six::Options options;
+        if (maxProductSize != 0)
+        {
+            options.setParameter(
+                    six::NITFHeaderCreator::OPT_MAX_PRODUCT_SIZE,
+                    maxProductSize);
+        }
+        writer.initialize(options, createContainer());
+        writer.setXMLControlRegistry(&mXMLRegistry);
+    }
+
+    //! Only write these overview levels
+    void setLevels(const std::vector<size_t>& levels)
+    {
+        mLevels = levels;
+    }
+
+    void save(const std::string& pathname,
+              size_t maxProductSize,
+              size_t numRowsPerBlock,
+              MultiProductWriter::Overviews* overviews = NULL)
+    {
+        six::NITFWriteControl writer;
+        initialize(writer, maxProductSize);
+
+        std::auto_ptr<MultiProductWriter::Overviews> ownOverviews;
+        if (overviews == NULL)
+        {
+            ownOverviews.reset(new MultiProductWriter::Overviews(
+                    DIMS, mPixelType, mNumLevels));
+            overviews = ownOverviews.get();
+        }
+
+        std::vector<MultiProductWriter::Product*> products;
+        MultiProductWriter::FullResolution fullResolution;
+        products.push_back(&fullResolution);
+        for (size_t ii = 0; ii < mLevels.size(); ++ii)
+        {
+            products.push_back(&overviews->getLevel(mLevels[ii]));
+        }
+
+        io::ByteStream source;
+        source.write(&mImage[0], mImage.size());
+        source.seek(0, io::Seekable::START);
+
+        MultiProductWriter(writer, numRowsPerBlock).save(
+                source, DIMS, mNumBytesPerPixel, products, pathname,
+                std::vector<std::string>());
+    }
+
+    // Writes the same products one after another the usual way
+    void saveSerially(const std::string& pathname, size_t maxProductSize)
+    {
+        six::NITFWriteControl writer;
+        initialize(writer, maxProductSize);
+
+        six::BufferList buffers;
+        for (size_t ii = 0; ii < mExpected.size(); ++ii)
+        {
+            buffers.push_back(&mExpected[ii][0]);
+        }
+        writer.save(buffers, pathname, std::vector<std::string>());
+    }
+
+    std::vector<std::vector<sys::ubyte> >
+    read(const std::string& pathname, size_t& numImageSegments) const
+    {
+        logging::NullLogger log;
+        six::NITFReadControl reader;
+        reader.setLogger(&log);
+        reader.setXMLControlRegistry(&mXMLRegistry);
+        reader.load(pathname, std::vector<std::string>());
+        numImageSegments = reader.getRecord().getNumImages();
+
+        std::vector<std::vector<sys::ubyte> > images;
+        for (size_t ii = 0; ii < reader.getContainer()->getNumData(); ++ii)
+        {
+            const six::Data* const data = reader.getContainer()->getData(ii);
+            images.push_back(std::vector<sys::ubyte>(
+                    data->getNumRows() * data->getNumCols() *
+                    data->getNumBytesPerPixel()));
+            six::Region region;
+            region.setBuffer(&images.back()[0]);
+            reader.interleaved(region, ii);
+        }
+        return images;
+    }
+
+    const std::vector<std::vector<sys::ubyte> >& getExpected() const
+    {
+        return mExpected;
+    }
+
+    const std::vector<sys::ubyte>& getImage() const
+    {
+        return mImage;
+    }
+
+private:
+    const six::PixelType mPixelType;
+    const size_t mNumBytesPerPixel;
+    const size_t mNumLevels;
+    std::vector<size_t> mLevels;
+    six::XMLControlRegistry mXMLRegistry;
+    std::vector<sys::ubyte> mImage;
+    std::vector<std::vector<sys::ubyte> > mExpected;
+};
+
+void compareToSerial(const std::string& testName,
+                     six::PixelType pixelType,
+                     size_t maxProductSize,
+                     size_t numRowsPerBlock)
+{
+    Fixture fixture(pixelType, 2);
+
+    const io::TempFile file;
+    fixture.save(file.pathname(), maxProductSize, numRowsPerBlock);
+    const io::TempFile serialFile;
+    fixture.saveSerially(serialFile.pathname(), maxProductSize);
+
+    size_t numImageSegments;
+    const std::vector<std::vector<sys::ubyte> > images =
+            fixture.read(file.pathname(), numImageSegments);
+    size_t numSerialImageSegments;
+    const std::vector<std::vector<sys::ubyte> > serialImages =
+            fixture.read(serialFile.pathname(), numSerialImageSegments);
+
+    TEST_ASSERT_EQ(numImageSegments, numSerialImageSegments);
+    TEST_ASSERT_EQ(images.size(), 3);
+    TEST_ASSERT(images == serialImages);
+    TEST_ASSERT_EQ(sys::Path(file.pathname()).length(),
+                   sys::Path(serialFile.pathname()).length());
+}
+
+TEST_CASE(testMono8)
+{
+    compareToSerial(testName, six::PixelType::MONO8I, 0, 5);
+
+    // The full resolution image comes back as is
+    Fixture fixture(six::PixelType::MONO8I, 2);
+    const io::TempFile file;
+    fixture.save(file.pathname(), 0, 4);
+    size_t numImageSegments;
+    const std::vector<std::vector<sys::ubyte> > images =
+            fixture.read(file.pathname(), numImageSegments);
+    TEST_ASSERT_EQ(numImageSegments, 3);
+    TEST_ASSERT(images == fixture.getExpected());
+}
+
+TEST_CASE(testMono16)
+{
+    compareToSerial(testName, six::PixelType::MONO16I, 0, 7);
+}
+
+TEST_CASE(testMultipleSegments)
+{
+    // Splits the full resolution image into several segments
+    compareToSerial(testName, six::PixelType::MONO16I, 500, 3);
+
+    // One block for the whole image
+    compareToSerial(testName, six::PixelType::MONO8I, 300, DIMS.row);
+}
+
+TEST_CASE(testSomeLevels)
+{
+    // Level 1 has to be built for level 2 even though it isn't written.
+    // The same levels can be written again.
+    Fixture fixture(six::PixelType::MONO8I, 2);
+    fixture.setLevels(std::vector<size_t>(1, 2));
+    MultiProductWriter::Overviews overviews(DIMS, six::PixelType::MONO8I, 2);
+    for (size_t ii = 0; ii < 2; ++ii)
+    {
+        const io::TempFile file;
+        fixture.save(file.pathname(), 0, 5, &overviews);
+
+        size_t numImageSegments;
+        const std::vector<std::vector<sys::ubyte> > images =
+                fixture.read(file.pathname(), numImageSegments);
+        TEST_ASSERT_EQ(images.size(), 2);
+        TEST_ASSERT(images[0] == fixture.getExpected()[0]);
+        TEST_ASSERT(images[1] == fixture.getExpected()[2]);
+    }
+}
+
+TEST_CASE(testBadProducts)
+{
+    Fixture fixture(six::PixelType::MONO8I, 1);
+    io::ByteStream source;
+    source.write(&fixture.getImage()[0], fixture.getImage().size());
+
+    six::NITFWriteControl writer;
+    fixture.initialize(writer);
+    const io::TempFile file;
+    MultiProductWriter multiWriter(writer, 10);
+
+    // One product short
+    MultiProductWriter::FullResolution fullResolution;
+    std::vector<MultiProductWriter::Product*> products(1, &fullResolution);
+    TEST_EXCEPTION(multiWriter.save(source, DIMS, 1, products, file.pathname(),
+                                    std::vector<std::string>()));
+
+    // Full resolution pixels where the overview goes
+    MultiProductWriter::FullResolution tooBig;
+    products.push_back(&tooBig);
+    source.seek(0, io::Seekable::START);
+    TEST_EXCEPTION(multiWriter.save(source, DIMS, 1, products, file.pathname(),
+                                    std::vector<std::string>()));
+
+    TEST_EXCEPTION(MultiProductWriter::Overviews(DIMS,
+                                                 six::PixelType::MONO8I, 0));
+    TEST_EXCEPTION(MultiProductWriter::Overviews(DIMS,
+                                                 six::PixelType::MONO8I, 5));
+    TEST_EXCEPTION(MultiProductWriter::Overviews(DIMS,
+                                                 six::PixelType::MONO8LU, 1));
+
+    MultiProductWriter::Overviews overviews(DIMS, six::PixelType::MONO8I, 2);
+    TEST_EXCEPTION(overviews.getLevel(0));
+    TEST_EXCEPTION(overviews.getLevel(3));
+}
+
+TEST_CASE(testUnsupportedOptions)
+{
+    // The pixels are streamed raw and unblocked, so headers describing
+    // compressed or blocked data can't be written
+    Fixture fixture(six::PixelType::MONO8I, 1);
+    const std::string optionNames[] =
+    {
+        six::NITFHeaderCreator::OPT_J2K_COMPRESSION_BYTERATE,
+        six::NITFHeaderCreator::OPT_NUM_ROWS_PER_BLOCK,
+        six::NITFHeaderCreator::OPT_NUM_COLS_PER_BLOCK
+    };
+    const io::TempFile file;
+    for (size_t ii = 0;
+         ii < sizeof(optionNames) / sizeof(optionNames[0]);
+         ++ii)
+    {
+        six::Options options;
+        options.setParameter(optionNames[ii], ii == 0 ? 0.5 : 64.0);
+
+        six::NITFWriteControl writer;
+        writer.initialize(options, fixture.createContainer());
+        TEST_EXCEPTION(writer.saveWithoutImageData(
+                file.pathname(), std::vector<std::string>()));
+    }
+}
+}
+
+int main(int, char**)
+{
+    TEST_CHECK(testMono8);
+    TEST_CHECK(testMono16);
+    TEST_CHECK(testMultipleSegments);
+    TEST_CHECK(testSomeLevels);
+    TEST_CHECK(testBadProducts);
+    TEST_CHECK(testUnsupportedOptions);
+    return 0;
+}
@@ -0,0 +1,370 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "TestCase.h"
+
+#include <io/ByteStream.h>
+#include <io/TempFile.h>
+#include <logging/NullLogger.h>
+#include <six/NITFReadControl.h>
+#include <six/NITFWriteControl.h>
+#include <six/XMLControlFactory.h>
+#include <six/sidd/DerivedXMLControl.h>
+#include <six/sidd/OverviewPyramid.h>
+#include <six/sidd/Utilities.h>
+
+namespace
+{
+typedef six::sidd::OverviewPyramid OverviewPyramid;
+
+// Odd sizes so the last row and column of each level are partial
+const types::RowCol<size_t> DIMS(37, 23);
+
+class VectorOutputStream : public io::OutputStream
+{
+public:
+    virtual void write(const void* buffer, size_t len)
+    {
+        const sys::ubyte* const bytes =
+                static_cast<const sys::ubyte*>(buffer);
+        mBytes.insert(mBytes.end(), bytes, bytes + len);
+    }
+
+    using io::OutputStream::write;
+
+    const std::vector<sys::ubyte>& get() const
+    {
+        return mBytes;
+    }
+
+private:
+    std::vector<sys::ubyte> mBytes;
+};
+
+std::vector<sys::ubyte> createImage(const types::RowCol<size_t>& dims)
+{
+    std::vector<sys::ubyte> image(dims.area());
+    for (size_t ii = 0; ii < image.size(); ++ii)
+    {
+        image[ii] = static_cast<sys::ubyte>((ii * 37) % 251);
+    }
+    return image;
+}
+
+// Straightforward box filter to check against
+std::vector<sys::ubyte> boxFilter(const std::vector<sys::ubyte>& image,
+                                  const types::RowCol<size_t>& dims)
+{
+    const types::RowCol<size_t> outDims(OverviewPyramid::getDims(dims, 1));
+    std::vector<sys::ubyte> output(outDims.area());
+    for (size_t row = 0; row < outDims.row; ++row)
+    {
+        const size_t row0 = 2 * row;
+        const size_t row1 = std::min(row0 + 1, dims.row - 1);
+        for (size_t col = 0; col < outDims.col; ++col)
+        {
+            const size_t col0 = 2 * col;
+            const size_t col1 = std::min(col0 + 1, dims.col - 1);
+            const size_t sum = image[row0 * dims.col + col0] +
+                    image[row0 * dims.col + col1] +
+                    image[row1 * dims.col + col0] +
+                    image[row1 * dims.col + col1];
+            output[row * outDims.col + col] =
+                    static_cast<sys::ubyte>((sum + 2) / 4);
+        }
+    }
+    return output;
+}
+
+std::vector<std::vector<sys::ubyte> >
+buildPyramid(const std::string& testName,
+             const void* image,
+             size_t numBytes,
+             const types::RowCol<size_t>& dims,
+             six::PixelType pixelType,
+             size_t numLevels,
+             OverviewPyramid::Filter filter,
+             size_t numThreads,
+             size_t chunkSize)
+{
+    std::vector<VectorOutputStream> streams(numLevels);
+    std::vector<io::OutputStream*> outputs;
+    for (size_t ii = 0; ii < numLevels; ++ii)
+    {
+        outputs.push_back(&streams[ii]);
+    }
+
+    OverviewPyramid pyramid(dims, pixelType, outputs, filter, numThreads);
+    const sys::ubyte* const bytes = static_cast<const sys::ubyte*>(image);
+    for (size_t offset = 0; offset < numBytes; offset += chunkSize)
+    {
+        TEST_ASSERT(!pyramid.isComplete());
+        pyramid.write(bytes + offset, std::min(chunkSize, numBytes - offset));
+    }
+    TEST_ASSERT(pyramid.isComplete());
+
+    std::vector<std::vector<sys::ubyte> > levels;
+    for (size_t ii = 0; ii < numLevels; ++ii)
+    {
+        levels.push_back(streams[ii].get());
+    }
+    return levels;
+}
+
+TEST_CASE(testDims)
+{
+    TEST_ASSERT(OverviewPyramid::getDims(DIMS, 0) == DIMS);
+    TEST_ASSERT(OverviewPyramid::getDims(DIMS, 1) ==
+                types::RowCol<size_t>(19, 12));
+    TEST_ASSERT(OverviewPyramid::getDims(DIMS, 3) ==
+                types::RowCol<size_t>(5, 3));
+    TEST_ASSERT_EQ(OverviewPyramid::getMaxNumLevels(DIMS), 4);
+    TEST_ASSERT_EQ(OverviewPyramid::getMaxNumLevels(
+            types::RowCol<size_t>(3, 1000)), 1);
+    TEST_ASSERT_EQ(OverviewPyramid::getNumBytesPerPixel(
+            six::PixelType::RE32F_IM32F), 2);
+    TEST_ASSERT_EQ(OverviewPyramid::getNumBytesPerPixel(
+            six::PixelType::RGB24I), 3);
+}
+
+TEST_CASE(testBoxFilter)
+{
+    const std::vector<sys::ubyte> image(createImage(DIMS));
+    const std::vector<sys::ubyte> level1(boxFilter(image, DIMS));
+    const std::vector<sys::ubyte> level2(
+            boxFilter(level1, OverviewPyramid::getDims(DIMS, 1)));
+
+    // Chunks that do and don't line up with rows
+    const size_t chunkSizes[] = { 1, 17, DIMS.col * 5, image.size() };
+    for (size_t ii = 0; ii < 4; ++ii)
+    {
+        for (size_t numThreads = 1; numThreads <= 3; numThreads += 2)
+        {
+            const std::vector<std::vector<sys::ubyte> > levels =
+                    buildPyramid(testName, &image[0], image.size(), DIMS,
+                                 six::PixelType::MONO8I, 2,
+                                 OverviewPyramid::BOX, numThreads,
+                                 chunkSizes[ii]);
+            TEST_ASSERT(levels[0] == level1);
+            TEST_ASSERT(levels[1] == level2);
+        }
+    }
+}
+
+TEST_CASE(testMaxFilter)
+{
+    // A single bright pixel survives every level
+    std::vector<sys::ubyte> image(DIMS.area(), 10);
+    image[21 * DIMS.col + 13] = 200;
+
+    const std::vector<std::vector<sys::ubyte> > levels =
+            buildPyramid(testName, &image[0], image.size(), DIMS,
+                         six::PixelType::MONO8I, 3,
+                         OverviewPyramid::MAX, 2, DIMS.col);
+    TEST_ASSERT_EQ(levels[0][10 * 12 + 6], 200);
+    TEST_ASSERT_EQ(levels[1][5 * 6 + 3], 200);
+    TEST_ASSERT_EQ(levels[2][2 * 3 + 1], 200);
+    TEST_ASSERT_EQ(std::count(levels[2].begin(), levels[2].end(), 200), 1);
+    TEST_ASSERT_EQ(std::count(levels[2].begin(), levels[2].end(), 10), 14);
+}
+
+TEST_CASE(testGaussianFilter)
+{
+    // Constant images stay constant, including along the edges
+    const std::vector<sys::Uint16_T> image(DIMS.area(), 1234);
+    const std::vector<std::vector<sys::ubyte> > levels =
+            buildPyramid(testName, &image[0], image.size() * 2, DIMS,
+                         six::PixelType::MONO16I, 2,
+                         OverviewPyramid::GAUSSIAN, 4, 100);
+
+    const types::RowCol<size_t> dims(OverviewPyramid::getDims(DIMS, 2));
+    TEST_ASSERT_EQ(levels[1].size(), dims.area() * 2);
+    const sys::Uint16_T* const pixels =
+            reinterpret_cast<const sys::Uint16_T*>(&levels[1][0]);
+    for (size_t ii = 0; ii < dims.area(); ++ii)
+    {
+        TEST_ASSERT_EQ(pixels[ii], 1234);
+    }
+}
+
+TEST_CASE(testComplex)
+{
+    // Complex images are detected to 16-bit magnitudes
+    std::vector<float> image(DIMS.area() * 2);
+    for (size_t ii = 0; ii < image.size(); ii += 2)
+    {
+        image[ii] = 3;
+        image[ii + 1] = -4;
+    }
+    image[0] = 1.0e6f;
+    const std::vector<std::vector<sys::ubyte> > levels =
+            buildPyramid(testName, &image[0], image.size() * sizeof(float),
+                         DIMS, six::PixelType::RE32F_IM32F, 1,
+                         OverviewPyramid::BOX, 1, 1000);
+
+    const types::RowCol<size_t> dims(OverviewPyramid::getDims(DIMS, 1));
+    TEST_ASSERT_EQ(levels[0].size(), dims.area() * sizeof(sys::Uint16_T));
+    const sys::Uint16_T* const pixels =
+            reinterpret_cast<const sys::Uint16_T*>(&levels[0][0]);
+    TEST_ASSERT_EQ(pixels[0], 65535);
+    for (size_t ii = 1; ii < dims.area(); ++ii)
+    {
+        TEST_ASSERT_EQ(pixels[ii], 5);
+    }
+}
+
+TEST_CASE(testBadInput)
+{
+    VectorOutputStream stream;
+    std::vector<io::OutputStream*> outputs(1, &stream);
+    TEST_EXCEPTION(OverviewPyramid(DIMS, six::PixelType::MONO8LU, outputs));
+    TEST_EXCEPTION(OverviewPyramid(DIMS, six::PixelType::AMP8I_PHS8I,
+                                   outputs));
+    TEST_EXCEPTION(OverviewPyramid(types::RowCol<size_t>(2, 100),
+                                   six::PixelType::MONO8I, outputs));
+
+    OverviewPyramid pyramid(DIMS, six::PixelType::MONO8I, outputs);
+    const std::vector<sys::ubyte> image(DIMS.area() + 1);
+    TEST_EXCEPTION(pyramid.write(&image[0], image.size()));
+}
+
+TEST_CASE(testOverviewData)
+{
+    std::auto_ptr<six::sidd::DerivedData> data =
+            six::sidd::Utilities::createFakeDerivedData();
+    data->setNumRows(DIMS.row);
+    data->setNumCols(DIMS.col);
+
+    TEST_EXCEPTION(OverviewPyramid::createOverviewData(*data, 0));
+    TEST_EXCEPTION(OverviewPyramid::createOverviewData(*data, 5));
+
+    const std::auto_ptr<six::sidd::DerivedData> overview =
+            OverviewPyramid::createOverviewData(*data, 2);
+    TEST_ASSERT_EQ(overview->getNumRows(), 10);
+    TEST_ASSERT_EQ(overview->getNumCols(), 6);
+    TEST_ASSERT_EQ(overview->getPixelType(), data->getPixelType());
+
+    // Overview pixels map to the center of the 4x4 pixels they cover
+    const six::sidd::GeometricChip& chip =
+            *overview->downstreamReprocessing->geometricChip;
+    TEST_ASSERT_EQ(chip.chipSize.row, 10);
+    TEST_ASSERT_EQ(chip.chipSize.col, 6);
+    const six::RowColDouble full = chip.getFullImageCoordinateFromChip(
+            six::RowColDouble(3, 5));
+    TEST_ASSERT_ALMOST_EQ(full.row, 13.5);
+    TEST_ASSERT_ALMOST_EQ(full.col, 21.5);
+
+    // Overviews of chips are mapped back to the original product
+    const std::auto_ptr<six::sidd::DerivedData> nested =
+            OverviewPyramid::createOverviewData(*overview, 1);
+    const six::RowColDouble nestedFull =
+            nested->downstreamReprocessing->geometricChip->
+                    getFullImageCoordinateFromChip(six::RowColDouble(1, 1));
+    TEST_ASSERT_ALMOST_EQ(nestedFull.row, 11.5);
+    TEST_ASSERT_ALMOST_EQ(nestedFull.col, 11.5);
+}
+
+TEST_CASE(testComplexOverviewData)
+{
+    // Overviews of complex images hold magnitudes, and their metadata has
+    // to say so for the image segments to be the right size
+    std::auto_ptr<six::sidd::DerivedData> data =
+            six::sidd::Utilities::createFakeDerivedData();
+    data->setNumRows(DIMS.row);
+    data->setNumCols(DIMS.col);
+    data->setPixelType(six::PixelType::RE32F_IM32F);
+
+    const std::auto_ptr<six::sidd::DerivedData> overview =
+            OverviewPyramid::createOverviewData(*data, 1);
+    TEST_ASSERT_EQ(overview->getPixelType(), six::PixelType::MONO16I);
+    TEST_ASSERT_EQ(overview->getNumBytesPerPixel(),
+                   OverviewPyramid::getNumBytesPerPixel(
+                           six::PixelType::RE32F_IM32F));
+}
+
+TEST_CASE(testSave)
+{
+    std::auto_ptr<six::sidd::DerivedData> data =
+            six::sidd::Utilities::createFakeDerivedData();
+    data->setNumRows(DIMS.row);
+    data->setNumCols(DIMS.col);
+    data->setPixelType(six::PixelType::MONO8I);
+
+    const std::vector<sys::ubyte> image(createImage(DIMS));
+    io::ByteStream imageStream;
+    imageStream.write(&image[0], image.size());
+    imageStream.seek(0, io::Seekable::START);
+
+    six::XMLControlRegistry xmlRegistry;
+    xmlRegistry.addCreator(six::DataType::DERIVED,
+                           new six::XMLControlCreatorT<
+                                   six::sidd::DerivedXMLControl>());
+    const io::TempFile file;
+    six::NITFWriteControl writer;
+    writer.setXMLControlRegistry(&xmlRegistry);
+    OverviewPyramid::save(*data, imageStream, 2, writer, file.pathname(),
+                          std::vector<std::string>());
+
+    logging::NullLogger log;
+    six::NITFReadControl reader;
+    reader.setLogger(&log);
+    reader.setXMLControlRegistry(&xmlRegistry);
+    reader.load(file.pathname(), std::vector<std::string>());
+    TEST_ASSERT_EQ(reader.getContainer()->getNumData(), 3);
+
+    const std::vector<sys::ubyte> level1(boxFilter(image, DIMS));
+    const std::vector<sys::ubyte> level2(
+            boxFilter(level1, OverviewPyramid::getDims(DIMS, 1)));
+    const std::vector<sys::ubyte>* expected[] = { &image, &level1, &level2 };
+    for (size_t ii = 0; ii < 3; ++ii)
+    {
+        const types::RowCol<size_t> dims(OverviewPyramid::getDims(DIMS, ii));
+        const six::Data* const levelData = reader.getContainer()->getData(ii);
+        TEST_ASSERT_EQ(levelData->getNumRows(), dims.row);
+        TEST_ASSERT_EQ(levelData->getNumCols(), dims.col);
+
+        std::vector<sys::ubyte> buffer(dims.area());
+        six::Region region;
+        region.setBuffer(&buffer[0]);
+        reader.interleaved(region, ii);
+        TEST_ASSERT(buffer == *expected[ii]);
+    }
+}
+}
+
+int main(int, char**)
+{
+    TEST_CHECK(testDims);
+    TEST_CHECK(testBoxFilter);
+    TEST_CHECK(testMaxFilter);
+    TEST_CHECK(testGaussianFilter);
+    TEST_CHECK(testComplex);
+    TEST_CHECK(testBadInput);
+    TEST_CHECK(testOverviewData);
+    TEST_CHECK(testComplexOverviewData);
+    TEST_CHECK(testSave);
+    return 0;
+}
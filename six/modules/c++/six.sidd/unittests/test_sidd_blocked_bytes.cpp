@@ -0,0 +1,235 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "TestCase.h"
+
+#include <nitf/ImageBlocker.hpp>
+#include <nitf/NITFBufferList.hpp>
+#include <six/sidd/SIDDByteProvider.h>
+#include <six/sidd/Utilities.h>
+
+namespace
+{
+const types::RowCol<size_t> DIMS(123, 77);
+
+std::auto_ptr<six::sidd::SIDDByteProvider>
+createProvider(size_t numRowsPerBlock,
+               size_t numColsPerBlock,
+               size_t maxProductSize = 0)
+{
+    std::auto_ptr<six::sidd::DerivedData> data =
+            six::sidd::Utilities::createFakeDerivedData();
+    data->setNumRows(DIMS.row);
+    data->setNumCols(DIMS.col);
+    data->setPixelType(six::PixelType::MONO16I);
+    return std::auto_ptr<six::sidd::SIDDByteProvider>(
+            new six::sidd::SIDDByteProvider(*data,
+                                            std::vector<std::string>(),
+                                            numRowsPerBlock,
+                                            numColsPerBlock,
+                                            maxProductSize));
+}
+
+std::vector<sys::Uint16_T> createImage()
+{
+    std::vector<sys::Uint16_T> image(DIMS.area());
+    for (size_t ii = 0; ii < image.size(); ++ii)
+    {
+        image[ii] = static_cast<sys::Uint16_T>(ii * 7 + 1);
+    }
+    return image;
+}
+
+void copyToFile(nitf::Off fileOffset,
+                const nitf::NITFBufferList& buffers,
+                std::vector<sys::byte>& file)
+{
+    for (size_t ii = 0; ii < buffers.mBuffers.size(); ++ii)
+    {
+        const nitf::NITFBuffer& buffer = buffers.mBuffers[ii];
+        const sys::byte* const data =
+                static_cast<const sys::byte*>(buffer.mData);
+        std::copy(data, data + buffer.mNumBytes, &file[fileOffset]);
+        fileOffset += buffer.mNumBytes;
+    }
+}
+
+//! Blocks the whole image serially, the way callers had to before
+std::vector<sys::byte>
+writeSerially(const six::sidd::SIDDByteProvider& provider,
+              const std::vector<sys::Uint16_T>& image)
+{
+    std::vector<sys::byte> blocked(image.size() * sizeof(sys::Uint16_T));
+    const void* imageData = &image[0];
+    if (provider.isBlocked())
+    {
+        const std::auto_ptr<const nitf::ImageBlocker> blocker =
+                provider.getImageBlocker();
+        blocked.resize(blocker->getNumBytesRequired<sys::Uint16_T>(
+                0, DIMS.row));
+        blocker->block(&image[0], 0, DIMS.row,
+                       reinterpret_cast<sys::Uint16_T*>(&blocked[0]));
+        imageData = &blocked[0];
+    }
+
+    std::vector<sys::byte> file(provider.getFileNumBytes());
+    nitf::Off fileOffset;
+    nitf::NITFBufferList buffers;
+    provider.getBytes(imageData, 0, DIMS.row, fileOffset, buffers);
+    copyToFile(fileOffset, buffers, file);
+    return file;
+}
+
+//! Writes a row of blocks at a time, reusing the blocked buffer
+std::vector<sys::byte>
+writeByRowsOfBlocks(const six::sidd::SIDDByteProvider& provider,
+                    const std::vector<sys::Uint16_T>& image,
+                    size_t numThreads)
+{
+    std::vector<sys::byte> file(provider.getFileNumBytes());
+    std::vector<sys::byte> blockedData;
+    nitf::Off fileOffset;
+    nitf::NITFBufferList buffers;
+
+    const std::auto_ptr<const nitf::ImageBlocker> blocker =
+            provider.getImageBlocker();
+    for (size_t seg = 0; seg < blocker->getNumSegments(); ++seg)
+    {
+        const size_t segEndRow =
+                blocker->getStartRow(seg) + blocker->getNumRows(seg);
+        const size_t numRowsPerBlock = blocker->getNumRowsPerBlock()[seg];
+        for (size_t row = blocker->getStartRow(seg);
+             row < segEndRow;
+             row += numRowsPerBlock)
+        {
+            const size_t numRows = std::min(numRowsPerBlock, segEndRow - row);
+            provider.getBlockedBytes(&image[row * DIMS.col], row, numRows,
+                                     blockedData, fileOffset, buffers,
+                                     numThreads);
+            copyToFile(fileOffset, buffers, file);
+        }
+    }
+    return file;
+}
+
+void testMatchesSerial(const std::string& testName,
+                       const six::sidd::SIDDByteProvider& provider)
+{
+    const std::vector<sys::Uint16_T> image(createImage());
+    const std::vector<sys::byte> expected(writeSerially(provider, image));
+
+    for (size_t numThreads = 1; numThreads <= 4; numThreads += 3)
+    {
+        // All at once into a caller-owned buffer
+        std::vector<sys::byte> blockedData(
+                provider.getNumBlockedBytes(0, DIMS.row));
+        std::vector<sys::byte> file(provider.getFileNumBytes());
+        nitf::Off fileOffset;
+        nitf::NITFBufferList buffers;
+        provider.getBlockedBytes(&image[0], 0, DIMS.row,
+                                 blockedData.empty() ? NULL : &blockedData[0],
+                                 fileOffset, buffers, numThreads);
+        copyToFile(fileOffset, buffers, file);
+        TEST_ASSERT(file == expected);
+
+        TEST_ASSERT(writeByRowsOfBlocks(provider, image, numThreads) ==
+                    expected);
+    }
+}
+
+TEST_CASE(testBlocked)
+{
+    // Partial blocks along the bottom and right
+    const std::auto_ptr<six::sidd::SIDDByteProvider> provider =
+            createProvider(20, 30);
+    TEST_ASSERT(provider->isBlocked());
+    TEST_ASSERT_EQ(provider->getNumBlockedBytes(0, 20), 20 * 90 * 2);
+    testMatchesSerial(testName, *provider);
+}
+
+TEST_CASE(testEvenlyBlocked)
+{
+    const std::auto_ptr<six::sidd::SIDDByteProvider> provider =
+            createProvider(41, 77);
+    testMatchesSerial(testName, *provider);
+}
+
+TEST_CASE(testMultipleSegments)
+{
+    const size_t maxProductSize = 50 * DIMS.col * sizeof(sys::Uint16_T);
+    const std::auto_ptr<six::sidd::SIDDByteProvider> provider =
+            createProvider(16, 32, maxProductSize);
+    TEST_ASSERT(provider->getImageBlocker()->getNumSegments() > 1);
+    testMatchesSerial(testName, *provider);
+}
+
+TEST_CASE(testUnblocked)
+{
+    const std::auto_ptr<six::sidd::SIDDByteProvider> provider =
+            createProvider(0, 0);
+    TEST_ASSERT(!provider->isBlocked());
+    TEST_ASSERT_EQ(provider->getNumBlockedBytes(0, DIMS.row), 0);
+
+    // The pixels go out as is
+    const std::vector<sys::Uint16_T> image(createImage());
+    std::vector<sys::byte> blockedData;
+    nitf::Off fileOffset;
+    nitf::NITFBufferList buffers;
+    provider->getBlockedBytes(&image[0], 0, DIMS.row, blockedData,
+                              fileOffset, buffers);
+    TEST_ASSERT(blockedData.empty());
+
+    std::vector<sys::byte> file(provider->getFileNumBytes());
+    copyToFile(fileOffset, buffers, file);
+    TEST_ASSERT(file == writeSerially(*provider, image));
+}
+
+TEST_CASE(testMisalignedRows)
+{
+    const std::auto_ptr<six::sidd::SIDDByteProvider> provider =
+            createProvider(20, 30);
+    const std::vector<sys::Uint16_T> image(createImage());
+    std::vector<sys::byte> blockedData;
+    nitf::Off fileOffset;
+    nitf::NITFBufferList buffers;
+    TEST_EXCEPTION(provider->getBlockedBytes(&image[0], 5, 20, blockedData,
+                                             fileOffset, buffers));
+    TEST_EXCEPTION(provider->getBlockedBytes(&image[0], 0, 25, blockedData,
+                                             fileOffset, buffers));
+}
+}
+
+int main(int, char**)
+{
+    TEST_CHECK(testBlocked);
+    TEST_CHECK(testEvenlyBlocked);
+    TEST_CHECK(testMultipleSegments);
+    TEST_CHECK(testUnblocked);
+    TEST_CHECK(testMisalignedRows);
+    return 0;
+}
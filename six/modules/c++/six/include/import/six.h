@@ -23,6 +23,8 @@
 #define __IMPORT_SIX_H__
 
 #include "six/Adapters.h"
+#include "six/AsyncFile.h"
+#include "six/ChipExtractor.h"
 #include "six/CollectionInformation.h"
 #include "six/Container.h"
 #include "six/Data.h"
@@ -32,6 +34,7 @@
 #include "six/GeoDataBase.h"
 #include "six/GeoInfo.h"
 #include "six/Mesh.h"
+#include "six/MetadataExtractor.h"
 #include "six/NITFImageInfo.h"
 #include "six/NITFImageInputStream.h"
 #include "six/NITFSegmentInfo.h"
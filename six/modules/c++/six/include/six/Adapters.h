@@ -153,6 +153,25 @@ public:
                        bool doByteSwap);
 };
 
+/*!
+ *  \class ReservedWriteHandler
+ *  \brief Leaves room for an image segment's pixels without writing them
+ *
+ *  This makes the file big enough to hold the pixels and records where
+ *  they start, so they can be written directly to the file later on,
+ *  for instance by several threads at once.
+ */
+class ReservedWriteHandler: public nitf::WriteHandler
+{
+public:
+    /*!
+     *  \param numBytes Number of bytes of pixels in the segment
+     *  \param[out] offset Set to the file offset of the pixels when the
+     *  segment is written.  This must stay valid until then.
+     */
+    ReservedWriteHandler(size_t numBytes, nitf::Off* offset);
+};
+
 }
 
 #endif
@@ -0,0 +1,189 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_ASYNC_FILE_H__
+#define __SIX_ASYNC_FILE_H__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/Conf.h>
+#include <sys/File.h>
+#include <sys/Mutex.h>
+
+namespace six
+{
+/*!
+ * \class AsyncFile
+ * \brief Reads batches of regions of a file, keeping many reads in flight
+ * at once
+ *
+ * Fast SSDs only reach full throughput when many requests are queued, but
+ * reading a stream issues one request at a time.  AsyncFile takes a whole
+ * batch of (offset, length, buffer) requests, keeps up to the queue depth
+ * of them outstanding, and returns when all of them are done.  Large
+ * requests are split into chunks so even a single read is queued deeply.
+ *
+ * On Linux, reads go through io_uring when the kernel supports it.
+ * Otherwise, or when asked to, threads issue positional reads
+ * (sys::File::readAt()), one per request in flight.  No threads are
+ * started until a batch needs them.  A batch of n requests runs up to
+ * n - 1 of them, capped by the queue depth, alongside the calling thread,
+ * and they're kept for later batches.
+ *
+ * read() may be called from several threads at once.  Calls take turns on
+ * the one ring or thread pool.
+ *
+ * The CPHD readers use AsyncFile for signal and support array reads.
+ * ChipExtractor, and so SICDCropper and cropSICD(), use it to read
+ * unblocked, uncompressed NITF image segments loaded from a pathname.
+ * NITFReadControl::interleaved() still reads through NITRO's image reader.
+ */
+class AsyncFile
+{
+public:
+    //! How reads are issued
+    enum Backend
+    {
+        //! io_uring if available, otherwise THREAD_POOL
+        AUTO,
+
+        //! Linux io_uring
+        IO_URING,
+
+        //! Threads doing positional reads
+        THREAD_POOL
+    };
+
+    //! Default number of reads kept in flight
+    static const size_t DEFAULT_QUEUE_DEPTH;
+
+    //! Default size requests are split into
+    static const size_t DEFAULT_CHUNK_SIZE;
+
+    //! One region of the file to read
+    struct Request
+    {
+        Request() :
+            offset(0),
+            length(0),
+            buffer(NULL)
+        {
+        }
+
+        Request(sys::Off_T requestOffset,
+                size_t requestLength,
+                void* requestBuffer) :
+            offset(requestOffset),
+            length(requestLength),
+            buffer(requestBuffer)
+        {
+        }
+
+        //! Offset from the beginning of the file
+        sys::Off_T offset;
+
+        //! Number of bytes to read
+        size_t length;
+
+        //! Where to put them.  Must hold 'length' bytes.
+        void* buffer;
+    };
+
+    /*!
+     * \param pathname File to read
+     * \param queueDepth Maximum number of reads in flight.  If 0, uses
+     * DEFAULT_QUEUE_DEPTH.
+     * \param backend How to issue reads
+     * \param chunkSize Requests longer than this are split into reads of
+     * this many bytes.  If 0, requests are never split.
+     *
+     * \throws except::Exception if the file can't be opened or
+     * IO_URING is asked for but isn't available
+     */
+    AsyncFile(const std::string& pathname,
+              size_t queueDepth = DEFAULT_QUEUE_DEPTH,
+              Backend backend = AUTO,
+              size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+    ~AsyncFile();
+
+    //! \return Whether this build and kernel can use io_uring
+    static bool isIoUringAvailable();
+
+    //! \return How reads are issued.  Never AUTO.
+    Backend getBackend() const
+    {
+        return mBackend;
+    }
+
+    //! \return Maximum number of reads in flight
+    size_t getQueueDepth() const
+    {
+        return mQueueDepth;
+    }
+
+    /*!
+     * \return Number of threads started to issue reads so far, besides
+     * the ones calling read().  Always 0 for io_uring.
+     */
+    size_t getNumThreads() const;
+
+    //! \return Size of the file in bytes
+    sys::Off_T getSize() const
+    {
+        return mSize;
+    }
+
+    /*!
+     * Reads every request, returning once all of them are done.  Requests
+     * may complete in any order.  Their buffers must not overlap.
+     *
+     * \throws except::Exception if any read fails or goes past the end of
+     * the file.  No reads are still in flight when this throws, but the
+     * contents of every buffer are unspecified.
+     */
+    void read(const std::vector<Request>& requests) const;
+
+    //! Same as above for a single request
+    void read(sys::Off_T offset, size_t length, void* buffer) const;
+
+private:
+    AsyncFile(const AsyncFile&);
+    AsyncFile& operator=(const AsyncFile&);
+
+private:
+    class IoUring;
+    class ThreadPool;
+
+    sys::File mFile;
+    const sys::Off_T mSize;
+    const size_t mQueueDepth;
+    const size_t mChunkSize;
+    Backend mBackend;
+    std::auto_ptr<IoUring> mIoUring;
+    mutable sys::Mutex mIoUringMutex;
+    std::auto_ptr<ThreadPool> mThreadPool;
+};
+}
+
+#endif
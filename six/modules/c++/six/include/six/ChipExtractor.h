@@ -0,0 +1,206 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_CHIP_EXTRACTOR_H__
+#define __SIX_CHIP_EXTRACTOR_H__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <types/RowCol.h>
+#include <six/AsyncFile.h>
+#include <six/Data.h>
+#include <six/NITFReadControl.h>
+#include <six/Types.h>
+
+namespace six
+{
+/*!
+ * \class ChipExtractor
+ * \brief Cuts many chips out of one open SICD or SIDD image
+ *
+ * The reader is loaded once and whatever geometry is needed to update
+ * each chip's metadata is built once, so a chip only costs its pixels and
+ * its output.  Chips are sorted by where they are in the file and chips
+ * whose rows are close together are read as a single region, so pixels
+ * are read in file order and pixels shared by overlapping chips are only
+ * read once.  Each region's chips are copied out, and their metadata
+ * updated and written, in parallel while the next region is read.
+ *
+ * When the image's pixels are unblocked and uncompressed, which is always
+ * the case for SICDs written by SIX, their big endian bytes are read
+ * straight from the image segments and chips are written to files with no
+ * byte swapping.  If the reader was loaded from a pathname, the rows of
+ * each region are read as one batch through an AsyncFile.  Otherwise
+ * they're read through NITFReadControl::interleaved().  A chip bigger than the block size that
+ * is written to a file is streamed to it a block of rows at a time, so it
+ * is never held in memory all at once.
+ *
+ * Subclasses provide the metadata of a chip.  See
+ * six::sicd::ChipExtractor and six::sidd::ChipExtractor.
+ */
+class ChipExtractor
+{
+public:
+    //! Default maximum number of bytes read at once
+    static const size_t DEFAULT_BLOCK_SIZE;
+
+    //! Area of the image to cut out, in pixels of the image
+    struct Chip
+    {
+        Chip() :
+            offset(0, 0),
+            dims(0, 0)
+        {
+        }
+
+        Chip(const types::RowCol<size_t>& chipOffset,
+             const types::RowCol<size_t>& chipDims) :
+            offset(chipOffset),
+            dims(chipDims)
+        {
+        }
+
+        //! Upper left corner
+        types::RowCol<size_t> offset;
+
+        //! Size
+        types::RowCol<size_t> dims;
+    };
+
+    /*!
+     * \param reader Reader for the file.  NITFReadControl::load() must be
+     * called prior to this.  It's only used by the thread calling
+     * extract().
+     * \param imageNumber Which of the file's images to cut chips from
+     * \param numThreads Number of threads to use.  If 0, uses the number
+     * of CPUs available.
+     * \param blockSize Maximum number of bytes of pixels to read at once.
+     * Twice this is held in memory while extracting.  A chip bigger than
+     * this is read by itself, a block of rows at a time if it's written to
+     * a file.  At least one row of a chip is always read.
+     *
+     * \throws except::Exception if there's no such image
+     */
+    ChipExtractor(NITFReadControl& reader,
+                  size_t imageNumber,
+                  size_t numThreads,
+                  size_t blockSize);
+
+    virtual ~ChipExtractor();
+
+    //! \return Metadata of the image chips are cut from
+    const Data& getData() const
+    {
+        return *mData;
+    }
+
+    /*!
+     * Metadata for a chip.  This is called concurrently for different
+     * chips.
+     *
+     * \param chip Chip, which is already known to be in bounds
+     *
+     * \return Copy of the image's metadata updated to describe the chip
+     */
+    virtual std::auto_ptr<Data> cropMetadata(const Chip& chip) const = 0;
+
+    /*!
+     * Cut chips into memory
+     *
+     * \param chips Chips to cut.  They may overlap.
+     * \param[out] buffers One buffer of pixels per chip, in the same order
+     * as the chips.  Pixels are in native byte order as
+     * NITFReadControl::interleaved() returns them.
+     *
+     * \throws except::Exception if any chip is empty or out of bounds.
+     * Chips are checked before any are read.
+     */
+    void extract(const std::vector<Chip>& chips,
+                 std::vector<std::vector<UByte> >& buffers) const;
+
+    /*!
+     * Cut chips into files, each a SICD or SIDD of one image
+     *
+     * \param chips Chips to cut.  They may overlap.
+     * \param outPathnames Output pathname of each chip
+     * \param schemaPaths Schema paths to use for writing
+     *
+     * \throws except::Exception if the number of pathnames doesn't match
+     * or any chip is empty or out of bounds.  Chips are checked before any
+     * are written.
+     */
+    void extract(const std::vector<Chip>& chips,
+                 const std::vector<std::string>& outPathnames,
+                 const std::vector<std::string>& schemaPaths) const;
+
+private:
+    //! Image segment whose pixels can be read as they are in the file
+    struct Segment
+    {
+        nitf::Off fileOffset;
+        size_t firstRow;
+        size_t numRows;
+    };
+
+    //! Streams a chip's pixels a block of rows at a time
+    class ChipInputStream;
+
+    ChipExtractor(const ChipExtractor&);
+    ChipExtractor& operator=(const ChipExtractor&);
+
+    //! \return The segments, or nothing if the pixels can't be read as is
+    std::vector<Segment> getRawSegments() const;
+
+    /*!
+     * Reads pixels of the image.  If there are raw segments and
+     * nativeByteOrder is false, the pixels are left big endian.
+     */
+    void read(const types::RowCol<size_t>& offset,
+              const types::RowCol<size_t>& dims,
+              bool nativeByteOrder,
+              UByte* buffer) const;
+
+    void readRaw(const types::RowCol<size_t>& offset,
+                 const types::RowCol<size_t>& dims,
+                 UByte* buffer) const;
+
+    void checkChips(const std::vector<Chip>& chips) const;
+
+    void extract(const std::vector<Chip>& chips,
+                 std::vector<std::vector<UByte> >* buffers,
+                 const std::vector<std::string>* outPathnames,
+                 const std::vector<std::string>& schemaPaths) const;
+
+private:
+    NITFReadControl& mReader;
+    const size_t mImageNumber;
+    const size_t mNumThreads;
+    const size_t mBlockSize;
+    DataType mDataType;
+    const Data* mData;
+    std::vector<Segment> mRawSegments;
+    std::auto_ptr<AsyncFile> mAsyncFile;
+};
+}
+
+#endif
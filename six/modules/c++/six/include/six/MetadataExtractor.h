@@ -0,0 +1,162 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_METADATA_EXTRACTOR_H__
+#define __SIX_METADATA_EXTRACTOR_H__
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <six/Types.h>
+
+namespace six
+{
+class XMLControlRegistry;
+
+/*!
+ * \struct MetadataSummary
+ * \brief Key metadata fields of a single SICD, SIDD, or CPHD
+ *
+ * This is a flattened view meant for cataloging many files at once; it
+ * is not a substitute for the full Data model.  Fields that a file type
+ * doesn't have, or that are optional and absent, are left empty.
+ */
+struct MetadataSummary
+{
+    MetadataSummary();
+
+    std::string pathname;
+
+    //! False if the file could not be read, in which case error describes
+    //! why and the remaining fields are unset
+    bool success;
+    std::string error;
+
+    //! SICD, SIDD, or CPHD
+    std::string fileType;
+    std::string version;
+
+    //! Core name for SICD/CPHD, product name for SIDD
+    std::string name;
+    std::string classification;
+
+    //! ISO 8601 timestamps
+    std::string collectionStart;
+    std::string creationTime;
+
+    //! Number of SIDD products or CPHD channels.  Always 1 for SICD.
+    size_t numImages;
+
+    //! Dimensions of the first image.  For CPHD these are the number of
+    //! vectors and samples in the first channel.
+    size_t numRows;
+    size_t numCols;
+
+    //! Pixel type for SICD/SIDD, signal array format for CPHD
+    std::string pixelType;
+
+    LatLonCorners corners;
+};
+
+/*!
+ * \class MetadataExtractor
+ * \brief Fills in a MetadataSummary for one file type
+ *
+ * Implementations must be safe to call concurrently from multiple threads
+ * as extractMetadata() shares a single instance between all of its
+ * threads.
+ */
+class MetadataExtractor
+{
+public:
+    virtual ~MetadataExtractor()
+    {
+    }
+
+    //! \return True if this extractor can read pathname
+    virtual bool supports(const std::string& pathname) const = 0;
+
+    /*!
+     * Read just the metadata of pathname.  Only summary.pathname is set on
+     * input.  Throws on failure.
+     */
+    virtual void extract(const std::string& pathname,
+                         MetadataSummary& summary) const = 0;
+};
+
+/*!
+ * \class NITFMetadataExtractor
+ * \brief Summarizes SICDs and SIDDs
+ *
+ * Files are opened with NITFReadControl::loadMetadata() so image data and
+ * other DES's are never read.
+ */
+class NITFMetadataExtractor : public MetadataExtractor
+{
+public:
+    /*!
+     * \param xmlRegistry XMLControls for the data types to support.  If
+     * NULL, XMLControlFactory is used.  Must outlive this object.
+     * \param schemaPaths Schemas to validate against, if any
+     */
+    NITFMetadataExtractor(
+            const XMLControlRegistry* xmlRegistry = NULL,
+            const std::vector<std::string>& schemaPaths =
+                    std::vector<std::string>());
+
+    virtual bool supports(const std::string& pathname) const;
+
+    virtual void extract(const std::string& pathname,
+                         MetadataSummary& summary) const;
+
+private:
+    const XMLControlRegistry* const mXMLRegistry;
+    const std::vector<std::string> mSchemaPaths;
+};
+
+/*!
+ * Summarize many files concurrently.  Files are handed out to threads one
+ * at a time as they finish so a few slow files don't hold up the rest.
+ * Failures are recorded in the corresponding summary rather than thrown.
+ *
+ * \param pathnames Files to summarize
+ * \param extractors Extractors to try, in order.  The first one that
+ * supports a file is used.
+ * \param numThreads Number of files to read at once.  Metadata reads are
+ * mostly waiting on I/O, so more threads than CPUs can help on network
+ * or parallel file systems.  If 0, uses the number of CPUs available.
+ * \param[out] summaries One summary per pathname, in the same order
+ */
+void extractMetadata(const std::vector<std::string>& pathnames,
+                     const std::vector<const MetadataExtractor*>& extractors,
+                     size_t numThreads,
+                     std::vector<MetadataSummary>& summaries);
+
+/*!
+ * Write summaries as CSV with a header row.  Fields are quoted where
+ * needed per RFC 4180.
+ */
+void writeMetadataCSV(const std::vector<MetadataSummary>& summaries,
+                      std::ostream& os);
+}
+
+#endif
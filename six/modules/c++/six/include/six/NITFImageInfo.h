@@ -147,7 +147,7 @@ public:
         return mData;
     }
 
-    std::vector<NITFSegmentInfo> getImageSegments() const
+    const std::vector<NITFSegmentInfo>& getImageSegments() const
     {
         return mImageSegments;
     }
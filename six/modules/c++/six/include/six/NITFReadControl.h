@@ -135,6 +135,41 @@ public:
     void load(mem::SharedPtr<nitf::IOInterface> ioInterface,
               const std::vector<std::string>& schemaPaths);
 
+    /*!
+     *  Loads only the SICD/SIDD XML metadata.  Image subheaders are not
+     *  validated, no NITFImageInfo's are built, legends are not read, and
+     *  non-SICD/SIDD DES's are skipped, so this is considerably cheaper
+     *  than load() when only the Data objects in the container are needed.
+     *  The NITF headers are read through a buffered reader to avoid many
+     *  small reads.
+     *
+     *  Since no image information is available, interleaved() will throw
+     *  after this call.  Call load() to read pixel data.
+     *
+     *  \param fromFile    Input filepath
+     *  \param schemaPaths Directories or files of schema locations
+     */
+    void loadMetadata(const std::string& fromFile,
+                      const std::vector<std::string>& schemaPaths);
+
+    void loadMetadata(mem::SharedPtr<nitf::IOInterface> ioInterface,
+                      const std::vector<std::string>& schemaPaths);
+
+    //! \return True if the last load was a loadMetadata()
+    bool isMetadataOnly() const
+    {
+        return mMetadataOnly;
+    }
+
+    /*!
+     * \return The pathname given to load(), or an empty string if the
+     * file was loaded from a stream or an IOInterface
+     */
+    const std::string& getPathname() const
+    {
+        return mPathname;
+    }
+
 
     using ReadControl::interleaved;
     /*!
@@ -171,6 +206,12 @@ public:
         return mReader;
     }
 
+    //! Get the infos, one per image.  Empty after loadMetadata().
+    const std::vector<NITFImageInfo*>& getInfos() const
+    {
+        return mInfos;
+    }
+
 protected:
     //! We keep a ref to the reader
     mutable nitf::Reader mReader;
@@ -227,6 +268,12 @@ private:
     NITFReadControl& operator=(const NITFReadControl& other);
 
 private:
+    // Reads the record and parses the SICD/SIDD DES's into the container.
+    // If metadataOnly, other DES's and legends are skipped.
+    void loadRecord(mem::SharedPtr<nitf::IOInterface> ioInterface,
+                    const std::vector<std::string>& schemaPaths,
+                    bool metadataOnly);
+
     std::auto_ptr<Legend> findLegend(size_t productNum);
 
     void readLegendPixelData(nitf::ImageSubheader& subheader,
@@ -247,6 +294,9 @@ private:
     // The issue occurs from the explicit destructor of
     // IOControl
     mem::SharedPtr<nitf::IOInterface> mInterface;
+
+    bool mMetadataOnly;
+    std::string mPathname;
 };
 
 
@@ -240,6 +240,31 @@ public:
         save(convertBufferList(list), outputFile, schemaPaths);
     }
 
+    /*!
+     *  Writes everything but the pixels, leaving room for each image
+     *  segment's pixels so they can be written straight to the file
+     *  afterwards, in any order and from several threads at once.  The
+     *  pixels must be written unblocked and uncompressed, byte swapped
+     *  if shouldByteSwap() says so.  Throws if the J2K compression or
+     *  blocking options are set.
+     *
+     *  \param outputFile  Output path to write
+     *  \param schemaPaths Directories or files of schema locations
+     *
+     *  \return File offset of the pixels of each image segment, in the
+     *  order of the segments in the record
+     */
+    std::vector<nitf::Off> saveWithoutImageData(
+            const std::string& outputFile,
+            const std::vector<std::string>& schemaPaths);
+
+    std::vector<nitf::Off> saveWithoutImageData(
+            nitf::IOInterface& outputFile,
+            const std::vector<std::string>& schemaPaths);
+
+    //! \return Whether pixels are byte swapped when they're written
+    bool shouldByteSwap() const;
+
     /*!
      *  This function sets the organization ID (the 40 character DESSHRP field
      *  in the DES's user-defined subheader).
@@ -427,8 +452,6 @@ protected:
     {
     }
 
-    bool shouldByteSwap() const;
-
     void setXMLControlRegistryImpl(const XMLControlRegistry* xmlRegistry);
 
 private:
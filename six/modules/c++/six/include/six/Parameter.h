@@ -22,6 +22,9 @@
 #ifndef __SIX_PARAMETER_H__
 #define __SIX_PARAMETER_H__
 
+#include <complex>
+#include <limits>
+
 #include "six/Types.h"
 #include <import/str.h>
 
@@ -35,36 +38,35 @@ namespace six
  *  for use with the Options object and allows the developer to set
  *  and get parameters directly from native types without string
  *  conversion.
+ *
+ *  Floating point, integer and complex values are stored natively.  Setting
+ *  one and reading it back as the type it was set with (or an integer as
+ *  any type that holds it) involves no text conversion.  The value is only
+ *  formatted with str::toString() the first time its string is needed, and
+ *  that string is kept until the value changes.  All other conversions (e.g.
+ *  reading a double back as an int, or a float as a double) parse the
+ *  string, as they always have.  Any other type is stored as its string.
  */
 class Parameter
 {
 public:
     //!  Constructor
-    Parameter()
-    {
-    }
-    //!  Destructor
-    ~Parameter()
+    Parameter() :
+        mType(STRING),
+        mFormatted(false)
     {
+        clearNumeric();
     }
 
-    Parameter(const Parameter & other)
-      : mValue(other.mValue),
-        mName(other.mName)
-    {
-    }
+    Parameter(const Parameter& other);
+
+    Parameter& operator=(const Parameter& other);
 
     //!  Templated constructor, constructs from given value
     template<typename T>
     Parameter(T value)
     {
-        mValue = str::toString<T>(value);
-    }
-
-    template<typename T>
-    Parameter(std::complex<T> value)
-    {
-        mValue = str::toString<std::complex<T> >(mValue);
+        set(value);
     }
 
      /*!
@@ -75,14 +77,17 @@ public:
     template<typename T>
     inline operator T() const
     {
-        return str::toType<T>(mValue);
+        T value;
+        get(value);
+        return value;
     }
 
     //!  Get a string as a string
-    inline std::string str() const
+    std::string str() const
     {
-        return mValue;
+        return getString();
     }
+
     //!  Get the parameter's name
     inline std::string getName() const
     {
@@ -93,7 +98,14 @@ public:
     template<typename T>
     inline std::complex<T> getComplex() const
     {
-        return str::toType<std::complex<T> >(mValue);
+        // Integer and floating point complex values are kept apart so
+        // that, as with the string form, "(1.5,2)" can't be read as ints
+        if (mType == getComplexType(T()))
+        {
+            return std::complex<T>(static_cast<T>(mReal),
+                                   static_cast<T>(mImag));
+        }
+        return str::toType<std::complex<T> >(getString());
     }
 
     //!  Set the parameters' name
@@ -106,26 +118,27 @@ public:
     template<typename T>
     void setValue(T value)
     {
-        mValue = str::toString<T>(value);
+        set(value);
     }
 
     //! Overload templated setValue function
     template<typename T>
     void setValue(const std::complex<T>& value)
     {
-        mValue = str::toString<std::complex<T> >(value);
+        set(value);
     }
 
-    //!  Get back const char*
+    /*!
+     *  Get back const char*
+     *
+     *  The pointer is valid until the parameter is next modified.
+     */
     operator const char*() const
     {
-        return mValue.c_str();
+        return getString().c_str();
     }
 
-    bool operator==(const Parameter& o) const
-    {
-        return mName == o.mName && mValue == o.mValue;
-    }
+    bool operator==(const Parameter& o) const;
 
     bool operator!=(const Parameter& o) const
     {
@@ -133,9 +146,252 @@ public:
     }
 
 protected:
-    std::string mValue;
+    //! The value as a string.  For numeric values, empty until formatted.
+    mutable std::string mValue;
     std::string mName;
 
+private:
+    enum StorageType
+    {
+        STRING,
+        FLOAT,
+        DOUBLE,
+        INT,
+        UINT,
+        COMPLEX_FLOAT,
+        COMPLEX_DOUBLE,
+        COMPLEX_INT
+    };
+
+    void clearNumeric()
+    {
+        mReal = 0.0;
+        mImag = 0.0;
+        mInt = 0;
+        mUint = 0;
+    }
+
+    void setString(const std::string& value)
+    {
+        mType = STRING;
+        clearNumeric();
+        mValue = value;
+        mFormatted = false;
+    }
+
+    void setFloatingPoint(StorageType type, double real, double imag = 0.0);
+    void setSigned(sys::Int64_T value);
+    void setUnsigned(sys::Uint64_T value);
+
+    // Native storage type read directly by getComplex<T>()
+    template<typename T>
+    static StorageType getComplexType(T)
+    {
+        return STRING;
+    }
+    static StorageType getComplexType(float)
+    {
+        return COMPLEX_FLOAT;
+    }
+    static StorageType getComplexType(double)
+    {
+        return COMPLEX_DOUBLE;
+    }
+    static StorageType getComplexType(int)
+    {
+        return COMPLEX_INT;
+    }
+
+    // Types without an exact overload below are stored as strings
+    template<typename T>
+    void set(const T& value)
+    {
+        setString(str::toString<T>(value));
+    }
+
+    void set(const std::string& value)
+    {
+        setString(value);
+    }
+    void set(const char* value)
+    {
+        setString(value);
+    }
+    void set(float value)
+    {
+        setFloatingPoint(FLOAT, value);
+    }
+    void set(double value)
+    {
+        setFloatingPoint(DOUBLE, value);
+    }
+    void set(short value)
+    {
+        setSigned(value);
+    }
+    void set(int value)
+    {
+        setSigned(value);
+    }
+    void set(long value)
+    {
+        setSigned(value);
+    }
+    void set(long long value)
+    {
+        setSigned(value);
+    }
+    void set(unsigned short value)
+    {
+        setUnsigned(value);
+    }
+    void set(unsigned int value)
+    {
+        setUnsigned(value);
+    }
+    void set(unsigned long value)
+    {
+        setUnsigned(value);
+    }
+    void set(unsigned long long value)
+    {
+        setUnsigned(value);
+    }
+    void set(const std::complex<float>& value)
+    {
+        setFloatingPoint(COMPLEX_FLOAT, value.real(), value.imag());
+    }
+    void set(const std::complex<double>& value)
+    {
+        setFloatingPoint(COMPLEX_DOUBLE, value.real(), value.imag());
+    }
+    void set(const std::complex<int>& value)
+    {
+        setFloatingPoint(COMPLEX_INT, value.real(), value.imag());
+    }
+
+    // Types without an exact overload below are parsed from the string
+    template<typename T>
+    void get(T& value) const
+    {
+        value = str::toType<T>(getString());
+    }
+
+    void get(std::string& value) const
+    {
+        value = getString();
+    }
+    void get(float& value) const
+    {
+        getFloatingPoint(FLOAT, value);
+    }
+    void get(double& value) const
+    {
+        getFloatingPoint(DOUBLE, value);
+    }
+    void get(short& value) const
+    {
+        getInteger(value);
+    }
+    void get(int& value) const
+    {
+        getInteger(value);
+    }
+    void get(long& value) const
+    {
+        getInteger(value);
+    }
+    void get(long long& value) const
+    {
+        getInteger(value);
+    }
+    void get(unsigned short& value) const
+    {
+        getInteger(value);
+    }
+    void get(unsigned int& value) const
+    {
+        getInteger(value);
+    }
+    void get(unsigned long& value) const
+    {
+        getInteger(value);
+    }
+    void get(unsigned long long& value) const
+    {
+        getInteger(value);
+    }
+
+    // A float read as a double (or vice versa) goes through the string,
+    // which doesn't give the same value as a cast
+    template<typename T>
+    void getFloatingPoint(StorageType type, T& value) const
+    {
+        if (mType == type)
+        {
+            value = static_cast<T>(mReal);
+            return;
+        }
+
+        switch (mType)
+        {
+        case INT:
+            value = static_cast<T>(mInt);
+            break;
+        case UINT:
+            value = static_cast<T>(mUint);
+            break;
+        default:
+            value = str::toType<T>(getString());
+        }
+    }
+
+    // Out of range values, and floating point values which the string
+    // conversion would truncate, go through the string to keep its
+    // behavior
+    template<typename T>
+    void getInteger(T& value) const
+    {
+        if (mType == INT)
+        {
+            if (mInt < 0 ?
+                    (std::numeric_limits<T>::is_signed &&
+                     mInt >= static_cast<sys::Int64_T>(
+                             std::numeric_limits<T>::min())) :
+                    static_cast<sys::Uint64_T>(mInt) <=
+                            static_cast<sys::Uint64_T>(
+                                    std::numeric_limits<T>::max()))
+            {
+                value = static_cast<T>(mInt);
+                return;
+            }
+        }
+        else if (mType == UINT)
+        {
+            if (mUint <= static_cast<sys::Uint64_T>(
+                    std::numeric_limits<T>::max()))
+            {
+                value = static_cast<T>(mUint);
+                return;
+            }
+        }
+        value = str::toType<T>(getString());
+    }
+
+    /*!
+     * Formats a numeric value the first time it's needed.  Parameters
+     * are read from several threads at once, so this is thread-safe.
+     */
+    const std::string& getString() const;
+
+    std::string format() const;
+
+    StorageType mType;
+    double mReal;
+    double mImag;
+    sys::Int64_T mInt;
+    sys::Uint64_T mUint;
+    mutable bool mFormatted;
 };
 
 }
@@ -24,7 +24,9 @@
 
 #include <vector>
 #include <algorithm>
+#include <cstring>
 #include <iterator>
+#include <limits>
 
 #include <sys/Conf.h>
 
@@ -88,6 +90,98 @@ struct Serializer
     }
 };
 
+/*!
+ * \struct BlockSerializer
+ * \tparam T Type of the values
+ * \tparam IsScalar Whether T is an arithmetic type
+ * \brief Implements serialization and deserialization for contiguous
+ *  arrays of values, one value at a time
+ */
+template<typename T, bool IsScalar = std::numeric_limits<T>::is_specialized>
+struct BlockSerializer
+{
+    static void serializeImpl(const T* values,
+                              size_t length,
+                              bool swapBytes,
+                              std::vector<sys::byte>& buffer)
+    {
+        for (size_t ii = 0; ii < length; ++ii)
+        {
+            Serializer<T>::serializeImpl(values[ii], swapBytes, buffer);
+        }
+    }
+
+    static void deserializeImpl(const sys::byte*& buffer,
+                                bool swapBytes,
+                                size_t length,
+                                T* values)
+    {
+        for (size_t ii = 0; ii < length; ++ii)
+        {
+            Serializer<T>::deserializeImpl(buffer, swapBytes, values[ii]);
+        }
+    }
+};
+
+/*!
+ * \struct BlockSerializer
+ * \tparam T Scalar type
+ * \brief Serializes arrays of scalars as one block of bytes.  The output
+ *  is identical to serializing one value at a time, but the buffer is
+ *  grown once and the bytes are copied and swapped in a single pass.
+ */
+template<typename T>
+struct BlockSerializer<T, true>
+{
+    static void serializeImpl(const T* values,
+                              size_t length,
+                              bool swapBytes,
+                              std::vector<sys::byte>& buffer)
+    {
+        const size_t numBytes = length * sizeof(T);
+        if (numBytes == 0)
+        {
+            return;
+        }
+
+        // There's nothing to swap in single byte values
+        const size_t prevLength = buffer.size();
+        buffer.resize(prevLength + numBytes);
+        if (swapBytes && sizeof(T) > 1)
+        {
+            sys::byteSwap(values,
+                          static_cast<unsigned short>(sizeof(T)),
+                          length,
+                          &buffer[prevLength]);
+        }
+        else
+        {
+            std::memcpy(&buffer[prevLength], values, numBytes);
+        }
+    }
+
+    static void deserializeImpl(const sys::byte*& buffer,
+                                bool swapBytes,
+                                size_t length,
+                                T* values)
+    {
+        const size_t numBytes = length * sizeof(T);
+        if (numBytes == 0)
+        {
+            return;
+        }
+
+        std::memcpy(values, buffer, numBytes);
+        if (swapBytes && sizeof(T) > 1)
+        {
+            sys::byteSwap(values,
+                          static_cast<unsigned short>(sizeof(T)),
+                          length);
+        }
+        buffer += numBytes;
+    }
+};
+
 /*!
  * \struct Serializer
  * \tparam T Scalar type
@@ -110,9 +204,10 @@ struct Serializer<std::vector<T> >
         const size_t length = val.size();
 
         Serializer<size_t>::serializeImpl(length, swapBytes, buffer);
-        for (size_t ii = 0; ii < length; ++ii)
+        if (length > 0)
         {
-            Serializer<T>::serializeImpl(val[ii], swapBytes, buffer);
+            BlockSerializer<T>::serializeImpl(&val[0], length, swapBytes,
+                                              buffer);
         }
     }
 
@@ -133,10 +228,185 @@ struct Serializer<std::vector<T> >
         Serializer<size_t>::deserializeImpl(buffer, swapBytes, length);
         val.resize(currentVectorLength + length);
 
+        if (length > 0)
+        {
+            BlockSerializer<T>::deserializeImpl(buffer, swapBytes, length,
+                                                &val[currentVectorLength]);
+        }
+    }
+};
+
+/*!
+ * \struct Serializer
+ * \brief Implements serialization and deserialization for vectors of
+ *  bools.  std::vector<bool> packs its values into bits, so they're
+ *  serialized one at a time rather than as a block.
+ */
+template<>
+struct Serializer<std::vector<bool> >
+{
+    static void serializeImpl(const std::vector<bool>& val,
+                              bool swapBytes,
+                              std::vector<sys::byte>& buffer)
+    {
+        const size_t length = val.size();
+
+        Serializer<size_t>::serializeImpl(length, swapBytes, buffer);
+        for (size_t ii = 0; ii < length; ++ii)
+        {
+            Serializer<bool>::serializeImpl(val[ii], swapBytes, buffer);
+        }
+    }
+
+    static void deserializeImpl(const sys::byte*& buffer,
+                                bool swapBytes,
+                                std::vector<bool>& val)
+    {
+        const size_t currentVectorLength = val.size();
+        size_t length;
+        Serializer<size_t>::deserializeImpl(buffer, swapBytes, length);
+        val.resize(currentVectorLength + length);
+
         for (size_t ii = 0; ii < length; ++ii)
         {
-            Serializer<T>::deserializeImpl(buffer, swapBytes,
-                val[currentVectorLength + ii]);
+            bool value;
+            Serializer<bool>::deserializeImpl(buffer, swapBytes, value);
+            val[currentVectorLength + ii] = value;
+        }
+    }
+};
+
+/*!
+ * \class VectorView
+ * \tparam T Scalar type
+ * \brief Read-only view of a vector serialized by
+ *  Serializer<std::vector<T> >
+ *
+ * When no byte swapping is needed and the serialized values are aligned,
+ * the view points straight into the serialized buffer, so nothing is
+ * copied and the buffer must outlive the view.  Otherwise the values are
+ * deserialized into storage owned by the view.
+ */
+template<typename T>
+class VectorView
+{
+public:
+    VectorView() :
+        mData(NULL),
+        mSize(0)
+    {
+    }
+
+    const T* data() const
+    {
+        return mData;
+    }
+
+    size_t size() const
+    {
+        return mSize;
+    }
+
+    bool empty() const
+    {
+        return mSize == 0;
+    }
+
+    const T& operator[](size_t idx) const
+    {
+        return mData[idx];
+    }
+
+    const T* begin() const
+    {
+        return mData;
+    }
+
+    const T* end() const
+    {
+        return mData + mSize;
+    }
+
+    //! \return True if the view points into the serialized buffer
+    bool isInPlace() const
+    {
+        return mStorage.empty() && mSize > 0;
+    }
+
+    std::vector<T> toVector() const
+    {
+        return std::vector<T>(begin(), end());
+    }
+
+private:
+    friend struct Serializer<VectorView<T> >;
+
+    // Noncopyable since mData may point at mStorage
+    VectorView(const VectorView&);
+    VectorView& operator=(const VectorView&);
+
+private:
+    const T* mData;
+    size_t mSize;
+    std::vector<T> mStorage;
+};
+
+/*!
+ * \struct Serializer
+ * \tparam T Scalar type
+ * \brief Implements deserialization of vectors of scalar types into a
+ *  VectorView.  The serialized form is the same as std::vector<T>'s.
+ */
+template<typename T>
+struct Serializer<VectorView<T> >
+{
+    /*!
+     * Serialize the values the view holds.
+     * \param val The view to serialize.
+     * \param swapBytes Should byte-swapping be applied?
+     * \param[out] values The serialized data.
+     */
+    static void serializeImpl(const VectorView<T>& val,
+                              bool swapBytes,
+                              std::vector<sys::byte>& buffer)
+    {
+        Serializer<size_t>::serializeImpl(val.size(), swapBytes, buffer);
+        BlockSerializer<T, true>::serializeImpl(val.data(), val.size(),
+                                                swapBytes, buffer);
+    }
+
+    /*!
+     * Deserialize a byte array into a view, replacing what it held
+     * \param buffer The data to deserialize. Pointer is incremented
+     *  by sizeof(size_t) + vector_length * sizeof(T) after calling
+     *  this function.
+     * \param swapBytes Should byte-swapping be applied?
+     * \param[out] val The view to deserialize into.
+     */
+    static void deserializeImpl(const sys::byte*& buffer,
+                                bool swapBytes,
+                                VectorView<T>& val)
+    {
+        size_t length;
+        Serializer<size_t>::deserializeImpl(buffer, swapBytes, length);
+
+        val.mStorage.clear();
+        val.mSize = length;
+        if (!swapBytes &&
+            reinterpret_cast<size_t>(buffer) % sizeof(T) == 0)
+        {
+            val.mData = reinterpret_cast<const T*>(buffer);
+            buffer += length * sizeof(T);
+        }
+        else
+        {
+            val.mStorage.resize(length);
+            if (length > 0)
+            {
+                BlockSerializer<T, true>::deserializeImpl(
+                        buffer, swapBytes, length, &val.mStorage[0]);
+            }
+            val.mData = val.mStorage.empty() ? NULL : &val.mStorage[0];
         }
     }
 };
@@ -161,7 +431,7 @@ struct Serializer<std::string>
     {
         const size_t length = val.size();
         Serializer<size_t>::serializeImpl(length, swapBytes, buffer);
-        std::copy(val.begin(), val.end(), std::back_inserter(buffer));
+        buffer.insert(buffer.end(), val.begin(), val.end());
     }
 
     /*!
@@ -82,8 +82,24 @@ template<typename T> T toType(const std::string& s)
     return str::toType<T>(s);
 }
 
+/*!
+ * Floating point values are written in the scientific notation used by the
+ * SICD/SIDD XML, e.g. "-1.25E-03", with the fewest significant digits that
+ * parse back to exactly the same value.  The output doesn't depend on the
+ * locale.
+ */
 template<> std::string toString(const float& value);
 template<> std::string toString(const double& value);
+
+/*!
+ * Writes value the way toString() did before it switched to the shortest
+ * form: always max_digits10 digits after the point, e.g.
+ * "1.00000000000000000E00".  For callers that need output byte for byte
+ * identical to older versions of six.
+ */
+std::string toFullPrecisionString(double value);
+std::string toFullPrecisionString(float value);
+
 template<> std::string toString(const six::Vector3 & v);
 template<> std::string toString(const six::PolyXYZ & p);
 template<> six::EarthModelType
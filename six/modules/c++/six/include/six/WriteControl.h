@@ -72,6 +72,14 @@ public:
      */
     static const char OPT_BUFFER_SIZE[];
 
+    /*!
+     *  If nonzero, doubles in the XML are written byte for byte the way
+     *  older versions of six wrote them, with max_digits10 digits after the
+     *  point.  By default they're written with the fewest digits that read
+     *  back exactly.
+     */
+    static const char OPT_FULL_PRECISION_NUMBERS[];
+
     //!  Constructor.  Null-sets the Container
     WriteControl() :
         mContainer(NULL), mLog(NULL), mOwnLog(false), mXMLRegistry(NULL)
@@ -22,6 +22,9 @@
 #ifndef __SIX_XML_CONTROL_H__
 #define __SIX_XML_CONTROL_H__
 
+#include <string>
+#include <vector>
+
 #include <logging/Logger.h>
 #include <six/Data.h>
 #include <xml/lite/Document.h>
@@ -62,18 +65,69 @@ class XMLControl
 
     void setLogger(logging::Logger* log, bool ownLog = false);
 
+    /*!
+     * By default toXML() writes doubles with the fewest digits that read
+     * back exactly.  If fullPrecision is true, it writes them byte for byte
+     * the way older versions of six did instead.
+     */
+    void setFullPrecisionNumbers(bool fullPrecision)
+    {
+        mFullPrecisionNumbers = fullPrecision;
+    }
+
     /*
      *  \func validate
      *  \brief Validate the xml and log any errors
      *
+     *  Compiled schemas are cached for the life of the process, keyed by
+     *  the set of schema paths, so only the first validation against a
+     *  given set of paths pays to load them.  Each set keeps a small pool
+     *  of validators, one per thread validating against it at once, so
+     *  concurrent calls don't wait on each other.
+     *
      *  \param doc XML document
      *  \param schemaPaths  Directories or files of schema locations
      *  \param log Logs validation errors
+     *  \param prettyPrint If true, the document is pretty-printed before
+     *  validation.  If false, it is printed compactly, which is faster, and
+     *  only pretty-printed again if it turns out to be invalid so that the
+     *  line numbers in the logged errors are meaningful.
      */
     static void validate(const xml::lite::Document* doc,
+                         const std::vector<std::string>& schemaPaths,
+                         logging::Logger* log,
+                         bool prettyPrint = false);
+
+    /*
+     *  \func validate
+     *  \brief Validate serialized xml (e.g. the original bytes read from a
+     *  file) and log any errors.  This avoids re-serializing a DOM.
+     *
+     *  \param xml XML document
+     *  \param uri Namespace URI of the document's root element
+     *  \param schemaPaths  Directories or files of schema locations
+     *  \param log Logs validation errors
+     */
+    static void validate(const std::string& xml,
+                         const std::string& uri,
                          const std::vector<std::string>& schemaPaths,
                          logging::Logger* log);
 
+    /*!
+     * Drops all cached schema validators.  Only needed if the schemas on
+     * disk change while the process is running.
+     */
+    static void clearValidatorCache();
+
+    /*!
+     * \param schemaPaths Schema paths, as passed to validate()
+     * \return Number of validators compiled and cached for this set of
+     * paths.  0 if nothing has been validated against them since the cache
+     * was last cleared.
+     */
+    static size_t getNumCachedValidators(
+            const std::vector<std::string>& schemaPaths);
+
     /*!
      * Retrieve the proper schema paths for validation.
      * Schema paths can come from three sources, in
@@ -126,6 +180,7 @@ class XMLControl
     protected:
     logging::Logger* mLog;
     bool mOwnLog;
+    bool mFullPrecisionNumbers;
 
     /*!
      *  Convert a document from a DOM into a Data model
@@ -147,6 +202,21 @@ class XMLControl
 
     static void getVersionFromURI(const xml::lite::Document* doc,
                                   std::vector<std::string>& version);
+
+private:
+    static std::vector<std::string>
+    getValidationPaths(const std::vector<std::string>& schemaPaths,
+                       logging::Logger* log);
+
+    static void validateImpl(const std::string& xml,
+                             const std::string& uri,
+                             const std::vector<std::string>& paths,
+                             logging::Logger* log,
+                             std::vector<xml::lite::ValidationInfo>& errors);
+
+    static void reportErrors(
+            const std::vector<xml::lite::ValidationInfo>& errors,
+            logging::Logger* log);
 };
 }
 
@@ -160,12 +160,17 @@ std::string toXMLString(const Data* data,
 /*!
  *  Additionally performs schema validation --
  *  This function must must receive a valid logger to print validation errors
+ *
+ *  If fullPrecisionNumbers is true, doubles are written byte for byte the
+ *  way older versions of six wrote them rather than in their shortest form.
+ *  See XMLControl::setFullPrecisionNumbers().
  */
 std::string toValidXMLString(
         const Data* data,
         const std::vector<std::string>& schemaPaths,
         logging::Logger* log,
-        const XMLControlRegistry *xmlRegistry = NULL);
+        const XMLControlRegistry *xmlRegistry = NULL,
+        bool fullPrecisionNumbers = false);
 
 
 //!  Singleton declaration of our XMLControlRegistry
@@ -45,6 +45,13 @@ public:
 
     void setLogger(logging::Logger* log, bool ownLog = false);
 
+    /*!
+     * By default doubles are written with the fewest digits that read back
+     * exactly.  If fullPrecision is true, they're written the way older
+     * versions of six wrote them instead.  See six::toFullPrecisionString().
+     */
+    virtual void setFullPrecisionNumbers(bool fullPrecision);
+
     typedef xml::lite::Element* XMLElem;
 
 protected:
@@ -180,6 +187,7 @@ protected:
 private:
     const std::string mDefaultURI;
     const bool mAddClassAttributes;
+    bool mFullPrecisionNumbers;
 
     logging::Logger* mLog;
     bool mOwnLog;
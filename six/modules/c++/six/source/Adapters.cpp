@@ -32,6 +32,10 @@ NITF_BOOL __six_StreamWriteHandler_write(NITF_DATA * data,
 void __six_MemoryWriteHandler_destruct(NITF_DATA * data);
 NITF_BOOL __six_MemoryWriteHandler_write(NITF_DATA * data,
         nitf_IOInterface* io, nitf_Error * error);
+
+void __six_ReservedWriteHandler_destruct(NITF_DATA * data);
+NITF_BOOL __six_ReservedWriteHandler_write(NITF_DATA * data,
+        nitf_IOInterface* io, nitf_Error * error);
 }
 
 typedef struct _MemoryWriteHandlerImpl
@@ -217,3 +221,77 @@ StreamWriteHandler::StreamWriteHandler(const NITFSegmentInfo& info,
 }
 
 
+
+//
+// ReservedWriteHandler
+//
+
+typedef struct _ReservedWriteHandlerImpl
+{
+    size_t numBytes;
+    nitf::Off* offset;
+} ReservedWriteHandlerImpl;
+
+extern "C" void __six_ReservedWriteHandler_destruct(NITF_DATA * data)
+{
+    ReservedWriteHandlerImpl *impl = (ReservedWriteHandlerImpl *) data;
+    if (impl)
+        NITF_FREE(impl);
+}
+
+extern "C" NITF_BOOL __six_ReservedWriteHandler_write(NITF_DATA * data,
+        nitf_IOInterface* io, nitf_Error * error)
+{
+    ReservedWriteHandlerImpl *impl = (ReservedWriteHandlerImpl *) data;
+
+    const nitf_Off offset = nitf_IOInterface_tell(io, error);
+    if (!NITF_IO_SUCCESS(offset))
+        return NITF_FAILURE;
+    *impl->offset = offset;
+
+    if (impl->numBytes == 0)
+        return NITF_SUCCESS;
+
+    // Writing the last byte makes the file big enough to hold the rest.
+    // Seeking again flushes buffered IO so its size is up to date.
+    const char zero = 0;
+    const nitf_Off end = offset + static_cast<nitf_Off>(impl->numBytes);
+    if (!NITF_IO_SUCCESS(nitf_IOInterface_seek(io, end - 1, NITF_SEEK_SET,
+                                               error)) ||
+        !nitf_IOInterface_write(io, &zero, 1, error) ||
+        !NITF_IO_SUCCESS(nitf_IOInterface_seek(io, end, NITF_SEEK_SET,
+                                               error)))
+    {
+        return NITF_FAILURE;
+    }
+    return NITF_SUCCESS;
+}
+
+ReservedWriteHandler::ReservedWriteHandler(size_t numBytes,
+                                           nitf::Off* offset)
+{
+    static nitf_IWriteHandler iWriteHandler =
+            { &__six_ReservedWriteHandler_write,
+              &__six_ReservedWriteHandler_destruct };
+
+    ReservedWriteHandlerImpl *impl =
+            (ReservedWriteHandlerImpl *) NITF_MALLOC(
+                    sizeof(ReservedWriteHandlerImpl));
+    if (!impl)
+        throw nitf::NITFException(Ctxt("Out of memory"));
+    impl->numBytes = numBytes;
+    impl->offset = offset;
+
+    nitf_SegmentWriter *segmentWriter =
+            (nitf_SegmentWriter *) NITF_MALLOC(sizeof(nitf_SegmentWriter));
+    if (!segmentWriter)
+    {
+        NITF_FREE(impl);
+        throw nitf::NITFException(Ctxt("Out of memory"));
+    }
+    segmentWriter->data = impl;
+    segmentWriter->iface = &iWriteHandler;
+
+    setNative(segmentWriter);
+    setManaged(false);
+}
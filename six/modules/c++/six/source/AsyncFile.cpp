@@ -0,0 +1,605 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <algorithm>
+#include <cstring>
+
+#include <except/Exception.h>
+#include <mt/CriticalSection.h>
+#include <mt/ThreadGroup.h>
+#include <str/Convert.h>
+#include <sys/ConditionVar.h>
+#include <sys/Runnable.h>
+#include <six/AsyncFile.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <linux/io_uring.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define SIX_HAVE_IO_URING
+#endif
+#endif
+#endif
+
+namespace
+{
+std::vector<six::AsyncFile::Request>
+splitRequests(const std::vector<six::AsyncFile::Request>& requests,
+              size_t chunkSize)
+{
+    std::vector<six::AsyncFile::Request> chunks;
+    chunks.reserve(requests.size());
+    for (size_t ii = 0; ii < requests.size(); ++ii)
+    {
+        const six::AsyncFile::Request& request(requests[ii]);
+        if (request.offset < 0)
+        {
+            throw except::Exception(Ctxt(
+                    "Invalid offset " + str::toString(request.offset)));
+        }
+
+        sys::byte* const buffer = static_cast<sys::byte*>(request.buffer);
+        for (size_t done = 0; done < request.length; )
+        {
+            const size_t length = (chunkSize == 0) ?
+                    request.length : std::min(chunkSize,
+                                              request.length - done);
+            chunks.push_back(six::AsyncFile::Request(
+                    request.offset + static_cast<sys::Off_T>(done),
+                    length,
+                    buffer + done));
+            done += length;
+        }
+    }
+    return chunks;
+}
+}
+
+namespace six
+{
+#ifdef SIX_HAVE_IO_URING
+/*
+ * A minimal io_uring of our own rather than a dependency on liburing.
+ * Only the thread holding mIoUringMutex touches the rings, so the only
+ * ordering that matters is with the kernel.
+ */
+class AsyncFile::IoUring
+{
+public:
+    IoUring(int fd, size_t queueDepth) :
+        mFileFd(fd),
+        mRingFd(-1),
+        mSqRing(MAP_FAILED),
+        mCqRing(MAP_FAILED),
+        mSqes(MAP_FAILED)
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        mRingFd = static_cast<int>(syscall(__NR_io_uring_setup,
+                                           static_cast<unsigned>(queueDepth),
+                                           &params));
+        if (mRingFd < 0)
+        {
+            throw except::Exception(Ctxt(
+                    std::string("io_uring_setup failed: ") +
+                    std::strerror(errno)));
+        }
+
+        mSqRingSize = params.sq_off.array +
+                params.sq_entries * sizeof(unsigned);
+        mCqRingSize = params.cq_off.cqes +
+                params.cq_entries * sizeof(io_uring_cqe);
+        mSqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        mSqRing = mmap(NULL, mSqRingSize, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, mRingFd, IORING_OFF_SQ_RING);
+        mCqRing = mmap(NULL, mCqRingSize, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, mRingFd, IORING_OFF_CQ_RING);
+        mSqes = mmap(NULL, mSqesSize, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, mRingFd, IORING_OFF_SQES);
+        if (mSqRing == MAP_FAILED || mCqRing == MAP_FAILED ||
+            mSqes == MAP_FAILED)
+        {
+            const std::string message(std::strerror(errno));
+            release();
+            throw except::Exception(Ctxt(
+                    "Mapping the io_uring failed: " + message));
+        }
+
+        sys::byte* const sqRing = static_cast<sys::byte*>(mSqRing);
+        mSqHead = reinterpret_cast<unsigned*>(sqRing + params.sq_off.head);
+        mSqTail = reinterpret_cast<unsigned*>(sqRing + params.sq_off.tail);
+        mSqMask = *reinterpret_cast<unsigned*>(
+                sqRing + params.sq_off.ring_mask);
+        mSqArray = reinterpret_cast<unsigned*>(sqRing + params.sq_off.array);
+        mNumEntries = params.sq_entries;
+
+        sys::byte* const cqRing = static_cast<sys::byte*>(mCqRing);
+        mCqHead = reinterpret_cast<unsigned*>(cqRing + params.cq_off.head);
+        mCqTail = reinterpret_cast<unsigned*>(cqRing + params.cq_off.tail);
+        mCqMask = *reinterpret_cast<unsigned*>(
+                cqRing + params.cq_off.ring_mask);
+        mCqes = reinterpret_cast<io_uring_cqe*>(cqRing + params.cq_off.cqes);
+    }
+
+    ~IoUring()
+    {
+        release();
+    }
+
+    void read(const std::vector<Request>& requests)
+    {
+        // Short reads are resubmitted for what's left, so keep track of
+        // how much of each request is done.  The kernel reads each iovec
+        // when it starts the read, but they live until we return anyway.
+        std::vector<size_t> numRead(requests.size(), 0);
+        std::vector<iovec> iovecs(requests.size());
+        std::vector<size_t> toResubmit;
+        size_t nextRequest = 0;
+        size_t numInFlight = 0;
+        size_t numUnsubmitted = 0;
+        std::string error;
+
+        while (nextRequest < requests.size() || !toResubmit.empty() ||
+               numInFlight > 0 || numUnsubmitted > 0)
+        {
+            // Queue up as many reads as there's room for
+            unsigned tail = *mSqTail;
+            while (error.empty() &&
+                   numInFlight + numUnsubmitted < mNumEntries &&
+                   (nextRequest < requests.size() || !toResubmit.empty()))
+            {
+                size_t ii;
+                if (!toResubmit.empty())
+                {
+                    ii = toResubmit.back();
+                    toResubmit.pop_back();
+                }
+                else
+                {
+                    ii = nextRequest++;
+                }
+
+                const Request& request(requests[ii]);
+                iovecs[ii].iov_base =
+                        static_cast<sys::byte*>(request.buffer) + numRead[ii];
+                iovecs[ii].iov_len = request.length - numRead[ii];
+
+                const unsigned index = tail & mSqMask;
+                io_uring_sqe& sqe = static_cast<io_uring_sqe*>(mSqes)[index];
+                std::memset(&sqe, 0, sizeof(sqe));
+                sqe.opcode = IORING_OP_READV;
+                sqe.fd = mFileFd;
+                sqe.off = request.offset + numRead[ii];
+                sqe.addr = reinterpret_cast<sys::Uint64_T>(&iovecs[ii]);
+                sqe.len = 1;
+                sqe.user_data = ii;
+                mSqArray[index] = index;
+                ++tail;
+                ++numUnsubmitted;
+            }
+            __atomic_store_n(mSqTail, tail, __ATOMIC_RELEASE);
+
+            // Submit them and wait for at least one to finish
+            const long numSubmitted = syscall(
+                    __NR_io_uring_enter, mRingFd,
+                    static_cast<unsigned>(numUnsubmitted),
+                    1U, IORING_ENTER_GETEVENTS, NULL, 0);
+            if (numSubmitted < 0)
+            {
+                if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+                {
+                    // We can't tell whether anything's still in flight,
+                    // so the buffers can't be handed back
+                    throw except::Exception(Ctxt(
+                            std::string("io_uring_enter failed: ") +
+                            std::strerror(errno)));
+                }
+            }
+            else
+            {
+                numUnsubmitted -= static_cast<size_t>(numSubmitted);
+                numInFlight += static_cast<size_t>(numSubmitted);
+            }
+
+            unsigned head = *mCqHead;
+            const unsigned cqTail = __atomic_load_n(mCqTail, __ATOMIC_ACQUIRE);
+            for (; head != cqTail; ++head)
+            {
+                const io_uring_cqe& cqe = mCqes[head & mCqMask];
+                const size_t ii = static_cast<size_t>(cqe.user_data);
+                --numInFlight;
+
+                if (cqe.res == -EAGAIN || cqe.res == -EINTR)
+                {
+                    toResubmit.push_back(ii);
+                }
+                else if (cqe.res < 0)
+                {
+                    error = std::strerror(-cqe.res);
+                }
+                else if (cqe.res == 0)
+                {
+                    error = "Unexpected end of file";
+                }
+                else
+                {
+                    numRead[ii] += static_cast<size_t>(cqe.res);
+                    if (numRead[ii] < requests[ii].length)
+                    {
+                        toResubmit.push_back(ii);
+                    }
+                }
+            }
+            __atomic_store_n(mCqHead, head, __ATOMIC_RELEASE);
+
+            // Once something fails, just wait for what's in flight
+            if (!error.empty())
+            {
+                nextRequest = requests.size();
+                toResubmit.clear();
+            }
+        }
+
+        if (!error.empty())
+        {
+            throw except::Exception(Ctxt("Reading from file: " + error));
+        }
+    }
+
+private:
+    void release()
+    {
+        if (mSqes != MAP_FAILED)
+        {
+            munmap(mSqes, mSqesSize);
+        }
+        if (mCqRing != MAP_FAILED)
+        {
+            munmap(mCqRing, mCqRingSize);
+        }
+        if (mSqRing != MAP_FAILED)
+        {
+            munmap(mSqRing, mSqRingSize);
+        }
+        if (mRingFd >= 0)
+        {
+            close(mRingFd);
+        }
+    }
+
+private:
+    const int mFileFd;
+    int mRingFd;
+    void* mSqRing;
+    size_t mSqRingSize;
+    void* mCqRing;
+    size_t mCqRingSize;
+    void* mSqes;
+    size_t mSqesSize;
+    unsigned mNumEntries;
+
+    unsigned* mSqHead;
+    unsigned* mSqTail;
+    unsigned mSqMask;
+    unsigned* mSqArray;
+
+    unsigned* mCqHead;
+    unsigned* mCqTail;
+    unsigned mCqMask;
+    io_uring_cqe* mCqes;
+};
+#else
+// Never constructed, but AsyncFile needs a complete type to destroy
+class AsyncFile::IoUring
+{
+public:
+    void read(const std::vector<Request>& )
+    {
+    }
+};
+#endif
+
+/*
+ * Threads doing positional reads.  The thread calling read() reads
+ * alongside the workers.  Workers are only started when a batch has more
+ * requests than the threads already running, up to one per read in
+ * flight, and then wait for later batches.  Batches are read one at a
+ * time.
+ */
+class AsyncFile::ThreadPool
+{
+public:
+    ThreadPool(const sys::File& file, size_t maxNumReads) :
+        mFile(file),
+        mMaxNumReads(maxNumReads),
+        mNumWorkers(0),
+        mWorkReady(&mMutex),
+        mBatchDone(&mMutex),
+        mRequests(NULL),
+        mNextRequest(0),
+        mNumRemaining(0),
+        mFailed(false),
+        mShutdown(false)
+    {
+    }
+
+    ~ThreadPool()
+    {
+        shutdown();
+    }
+
+    size_t getNumWorkers() const
+    {
+        mt::CriticalSection<sys::Mutex> crit(&mBatchMutex);
+        return mNumWorkers;
+    }
+
+    void read(const std::vector<Request>& requests)
+    {
+        mt::CriticalSection<sys::Mutex> batchCrit(&mBatchMutex);
+
+        // Each worker is one more read in flight on top of the caller
+        const size_t numWorkers =
+                std::min(mMaxNumReads, requests.size()) - 1;
+        for (; mNumWorkers < numWorkers; ++mNumWorkers)
+        {
+            mThreads.createThread(new Worker(*this));
+        }
+
+        mt::CriticalSection<sys::Mutex> crit(&mMutex);
+        mRequests = &requests;
+        mNextRequest = 0;
+        mNumRemaining = requests.size();
+        mFailed = false;
+        mWorkReady.broadcast();
+
+        while (hasWork())
+        {
+            readNext(crit);
+        }
+        while (mNumRemaining > 0)
+        {
+            mBatchDone.wait();
+        }
+        mRequests = NULL;
+
+        if (mFailed)
+        {
+            throw except::Exception(mError, Ctxt("Unable to read file"));
+        }
+    }
+
+private:
+    class Worker : public sys::Runnable
+    {
+    public:
+        Worker(ThreadPool& pool) :
+            mPool(pool)
+        {
+        }
+
+        virtual void run()
+        {
+            mPool.work();
+        }
+
+    private:
+        ThreadPool& mPool;
+    };
+
+    void work()
+    {
+        mt::CriticalSection<sys::Mutex> crit(&mMutex);
+        while (true)
+        {
+            while (!mShutdown && !hasWork())
+            {
+                mWorkReady.wait();
+            }
+            if (mShutdown)
+            {
+                return;
+            }
+            readNext(crit);
+        }
+    }
+
+    //! Must hold mMutex
+    bool hasWork() const
+    {
+        return mRequests != NULL && mNextRequest < mRequests->size();
+    }
+
+    //! Called holding mMutex, which is dropped during the read
+    void readNext(mt::CriticalSection<sys::Mutex>& crit)
+    {
+        const Request& request = (*mRequests)[mNextRequest++];
+
+        // Once a read fails, the rest of the batch is skipped
+        bool failed = mFailed;
+        except::Exception error;
+        if (!failed)
+        {
+            crit.manualUnlock();
+            try
+            {
+                mFile.readAt(request.offset, request.buffer, request.length);
+            }
+            catch (const except::Exception& ex)
+            {
+                failed = true;
+                error = ex;
+            }
+            catch (const std::exception& ex)
+            {
+                failed = true;
+                error = except::Exception(Ctxt(ex.what()));
+            }
+            catch (...)
+            {
+                failed = true;
+                error = except::Exception(Ctxt("Unknown error reading file"));
+            }
+            crit.manualLock();
+        }
+
+        if (failed && !mFailed)
+        {
+            mFailed = true;
+            mError = error;
+        }
+        if (--mNumRemaining == 0)
+        {
+            mBatchDone.broadcast();
+        }
+    }
+
+    void shutdown()
+    {
+        {
+            mt::CriticalSection<sys::Mutex> crit(&mMutex);
+            mShutdown = true;
+            mWorkReady.broadcast();
+        }
+        mThreads.joinAll();
+    }
+
+private:
+    const sys::File& mFile;
+    const size_t mMaxNumReads;
+    mt::ThreadGroup mThreads;
+    size_t mNumWorkers;
+
+    //! Held for a whole batch so that batches don't interleave
+    mutable sys::Mutex mBatchMutex;
+
+    sys::Mutex mMutex;
+    sys::ConditionVar mWorkReady;
+    sys::ConditionVar mBatchDone;
+    const std::vector<Request>* mRequests;
+    size_t mNextRequest;
+    size_t mNumRemaining;
+    bool mFailed;
+    except::Exception mError;
+    bool mShutdown;
+};
+
+const size_t AsyncFile::DEFAULT_QUEUE_DEPTH = 32;
+const size_t AsyncFile::DEFAULT_CHUNK_SIZE = 1024 * 1024;
+
+AsyncFile::AsyncFile(const std::string& pathname,
+                     size_t queueDepth,
+                     Backend backend,
+                     size_t chunkSize) :
+    mFile(pathname),
+    mSize(mFile.length()),
+    mQueueDepth(queueDepth == 0 ? DEFAULT_QUEUE_DEPTH : queueDepth),
+    mChunkSize(chunkSize),
+    mBackend(backend)
+{
+#ifdef SIX_HAVE_IO_URING
+    if (mBackend != THREAD_POOL)
+    {
+        try
+        {
+            mIoUring.reset(new IoUring(mFile.getHandle(), mQueueDepth));
+            mBackend = IO_URING;
+        }
+        catch (const except::Exception&)
+        {
+            // The kernel may be too old or io_uring may be disabled
+            if (mBackend == IO_URING)
+            {
+                throw;
+            }
+            mBackend = THREAD_POOL;
+        }
+    }
+#else
+    if (mBackend == IO_URING)
+    {
+        throw except::Exception(Ctxt(
+                "SIX was built without io_uring support"));
+    }
+    mBackend = THREAD_POOL;
+#endif
+
+    if (mBackend == THREAD_POOL)
+    {
+        mThreadPool.reset(new ThreadPool(mFile, mQueueDepth));
+    }
+}
+
+AsyncFile::~AsyncFile()
+{
+}
+
+bool AsyncFile::isIoUringAvailable()
+{
+#ifdef SIX_HAVE_IO_URING
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    const int fd = static_cast<int>(syscall(__NR_io_uring_setup, 1U, &params));
+    if (fd < 0)
+    {
+        return false;
+    }
+    close(fd);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void AsyncFile::read(const std::vector<Request>& requests) const
+{
+    const std::vector<Request> chunks = splitRequests(requests, mChunkSize);
+    if (chunks.empty())
+    {
+        return;
+    }
+
+    if (mBackend == IO_URING)
+    {
+        mt::CriticalSection<sys::Mutex> crit(&mIoUringMutex);
+        mIoUring->read(chunks);
+    }
+    else
+    {
+        mThreadPool->read(chunks);
+    }
+}
+
+void AsyncFile::read(sys::Off_T offset, size_t length, void* buffer) const
+{
+    read(std::vector<Request>(1, Request(offset, length, buffer)));
+}
+
+size_t AsyncFile::getNumThreads() const
+{
+    return mThreadPool.get() ? mThreadPool->getNumWorkers() : 0;
+}
+}
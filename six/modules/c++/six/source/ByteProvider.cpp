@@ -147,6 +147,10 @@ void ByteProvider::populateInitArgs(
     // This memory must stay around until the call to the
     // base class's initialize() method
     logging::NullLogger logger;
+    const bool fullPrecisionNumbers = static_cast<int>(
+            headerCreator.getOptions().getParameter(
+                    WriteControl::OPT_FULL_PRECISION_NUMBERS,
+                    Parameter(0))) != 0;
     xmlStrings.resize(container->getNumData());
     desData.resize(xmlStrings.size());
     for (size_t ii = 0; ii < xmlStrings.size(); ++ii)
@@ -155,7 +159,8 @@ void ByteProvider::populateInitArgs(
         xmlString = six::toValidXMLString(container->getData(ii),
                                           schemaPaths,
                                           &logger,
-                                          headerCreator.getXMLControlRegistry());
+                                          headerCreator.getXMLControlRegistry(),
+                                          fullPrecisionNumbers);
         desData[ii].first = xmlString.c_str();
         desData[ii].second = xmlString.length();
     }
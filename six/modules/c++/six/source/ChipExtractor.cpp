@@ -0,0 +1,616 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include <except/Exception.h>
+#include <io/InputStream.h>
+#include <mt/ThreadGroup.h>
+#include <str/Manip.h>
+#include <sys/AtomicCounter.h>
+#include <sys/Conf.h>
+#include <sys/OS.h>
+#include <sys/Runnable.h>
+#include <six/ChipExtractor.h>
+#include <six/NITFWriteControl.h>
+
+namespace
+{
+typedef six::ChipExtractor::Chip Chip;
+
+// Region of the image read at once and the chips inside it
+struct Band
+{
+    Band(const Chip& chip, size_t index) :
+        offset(chip.offset),
+        dims(chip.dims),
+        chips(1, index)
+    {
+    }
+
+    types::RowCol<size_t> offset;
+    types::RowCol<size_t> dims;
+    std::vector<size_t> chips;
+};
+
+// Orders chip indices by where the chips start in the file
+class ChipIndexLess
+{
+public:
+    ChipIndexLess(const std::vector<Chip>& chips) :
+        mChips(chips)
+    {
+    }
+
+    bool operator()(size_t lhs, size_t rhs) const
+    {
+        const types::RowCol<size_t>& lhsOffset(mChips[lhs].offset);
+        const types::RowCol<size_t>& rhsOffset(mChips[rhs].offset);
+        return lhsOffset.row < rhsOffset.row ||
+                (lhsOffset.row == rhsOffset.row &&
+                 lhsOffset.col < rhsOffset.col);
+    }
+
+private:
+    const std::vector<Chip>& mChips;
+};
+
+std::vector<Band> makeBands(const std::vector<Chip>& chips,
+                            size_t numBytesPerPixel,
+                            size_t blockSize)
+{
+    std::vector<size_t> order(chips.size());
+    for (size_t ii = 0; ii < order.size(); ++ii)
+    {
+        order[ii] = ii;
+    }
+    std::sort(order.begin(), order.end(), ChipIndexLess(chips));
+
+    std::vector<Band> bands;
+    for (size_t ii = 0; ii < order.size(); ++ii)
+    {
+        const Chip& chip = chips[order[ii]];
+        if (!bands.empty())
+        {
+            // Chips are sorted by row so this can only grow down and out
+            Band& band = bands.back();
+            const size_t endRow = std::max(band.offset.row + band.dims.row,
+                                           chip.offset.row + chip.dims.row);
+            const size_t firstCol = std::min(band.offset.col,
+                                             chip.offset.col);
+            const size_t endCol = std::max(band.offset.col + band.dims.col,
+                                           chip.offset.col + chip.dims.col);
+            const size_t numRows = endRow - band.offset.row;
+            const size_t numCols = endCol - firstCol;
+            if (numRows * numCols * numBytesPerPixel <= blockSize)
+            {
+                band.offset.col = firstCol;
+                band.dims.row = numRows;
+                band.dims.col = numCols;
+                band.chips.push_back(order[ii]);
+                continue;
+            }
+        }
+        bands.push_back(Band(chip, order[ii]));
+    }
+    return bands;
+}
+
+// Writes a one-image SICD or SIDD
+template <typename ImagesT>
+void writeChip(const six::ChipExtractor& extractor,
+               six::DataType dataType,
+               const six::Options& options,
+               const Chip& chip,
+               const ImagesT& images,
+               const std::string& outPathname,
+               const std::vector<std::string>& schemaPaths)
+{
+    mem::SharedPtr<six::Container> container(new six::Container(dataType));
+    container->addData(extractor.cropMetadata(chip));
+
+    six::NITFWriteControl writer(options, container);
+    writer.save(images, outPathname, schemaPaths);
+}
+
+class ChipRunnable : public sys::Runnable
+{
+public:
+    ChipRunnable(const six::ChipExtractor& extractor,
+                 six::DataType dataType,
+                 const six::Options& options,
+                 const std::vector<Chip>& chips,
+                 const Band& band,
+                 const std::vector<six::UByte>& bandPixels,
+                 std::vector<std::vector<six::UByte> >* buffers,
+                 const std::vector<std::string>* outPathnames,
+                 const std::vector<std::string>& schemaPaths,
+                 sys::AtomicCounter& nextIndex) :
+        mExtractor(extractor),
+        mDataType(dataType),
+        mOptions(options),
+        mChips(chips),
+        mBand(band),
+        mBandPixels(bandPixels),
+        mBuffers(buffers),
+        mOutPathnames(outPathnames),
+        mSchemaPaths(schemaPaths),
+        mNumBytesPerPixel(extractor.getData().getNumBytesPerPixel()),
+        mNextIndex(nextIndex)
+    {
+    }
+
+    virtual void run()
+    {
+        std::vector<six::UByte> buffer;
+        while (true)
+        {
+            const size_t index =
+                    static_cast<size_t>(mNextIndex.getThenIncrement());
+            if (index >= mBand.chips.size())
+            {
+                break;
+            }
+
+            const size_t chipIndex = mBand.chips[index];
+            if (mBuffers)
+            {
+                copyChip(mChips[chipIndex], (*mBuffers)[chipIndex]);
+            }
+            else
+            {
+                copyChip(mChips[chipIndex], buffer);
+                writeChip(mExtractor, mDataType, mOptions, mChips[chipIndex],
+                          six::BufferList(1, &buffer[0]),
+                          (*mOutPathnames)[chipIndex], mSchemaPaths);
+            }
+        }
+    }
+
+private:
+    void copyChip(const Chip& chip, std::vector<six::UByte>& buffer) const
+    {
+        const size_t numBytesPerRow = chip.dims.col * mNumBytesPerPixel;
+        const size_t numBytesPerBandRow = mBand.dims.col * mNumBytesPerPixel;
+        buffer.resize(chip.dims.row * numBytesPerRow);
+
+        const six::UByte* src = &mBandPixels[0] +
+                (chip.offset.row - mBand.offset.row) * numBytesPerBandRow +
+                (chip.offset.col - mBand.offset.col) * mNumBytesPerPixel;
+        six::UByte* dest = &buffer[0];
+        for (size_t row = 0; row < chip.dims.row; ++row)
+        {
+            std::memcpy(dest, src, numBytesPerRow);
+            src += numBytesPerBandRow;
+            dest += numBytesPerRow;
+        }
+    }
+
+private:
+    const six::ChipExtractor& mExtractor;
+    const six::DataType mDataType;
+    const six::Options& mOptions;
+    const std::vector<Chip>& mChips;
+    const Band& mBand;
+    const std::vector<six::UByte>& mBandPixels;
+    std::vector<std::vector<six::UByte> >* const mBuffers;
+    const std::vector<std::string>* const mOutPathnames;
+    const std::vector<std::string>& mSchemaPaths;
+    const size_t mNumBytesPerPixel;
+    sys::AtomicCounter& mNextIndex;
+};
+}
+
+namespace six
+{
+/*
+ * Reads the rows of a chip a block at a time, as the chip is written.
+ * Pixels are left as they are in the file.
+ */
+class ChipExtractor::ChipInputStream : public io::InputStream
+{
+public:
+    ChipInputStream(const ChipExtractor& extractor, const Chip& chip) :
+        mExtractor(extractor),
+        mChip(chip),
+        mNumBytesPerRow(chip.dims.col *
+                        extractor.getData().getNumBytesPerPixel()),
+        mNumRowsPerBlock(std::max<size_t>(
+                extractor.mBlockSize / mNumBytesPerRow, 1)),
+        mNextRow(0),
+        mBlockPos(0)
+    {
+    }
+
+    virtual sys::Off_T available()
+    {
+        return static_cast<sys::Off_T>(
+                (mChip.dims.row - mNextRow) * mNumBytesPerRow +
+                mBlock.size() - mBlockPos);
+    }
+
+protected:
+    virtual sys::SSize_T readImpl(void* buffer, size_t len)
+    {
+        sys::ubyte* const bytes = static_cast<sys::ubyte*>(buffer);
+        size_t numBytesRead = 0;
+        while (numBytesRead < len)
+        {
+            if (mBlockPos == mBlock.size())
+            {
+                if (mNextRow == mChip.dims.row)
+                {
+                    break;
+                }
+                readBlock();
+            }
+
+            const size_t numBytes =
+                    std::min(len - numBytesRead, mBlock.size() - mBlockPos);
+            std::memcpy(bytes + numBytesRead, &mBlock[mBlockPos], numBytes);
+            mBlockPos += numBytes;
+            numBytesRead += numBytes;
+        }
+
+        return numBytesRead == 0 && len > 0 ?
+                static_cast<sys::SSize_T>(io::InputStream::IS_EOF) :
+                static_cast<sys::SSize_T>(numBytesRead);
+    }
+
+private:
+    void readBlock()
+    {
+        const size_t numRows =
+                std::min(mNumRowsPerBlock, mChip.dims.row - mNextRow);
+        mBlock.resize(numRows * mNumBytesPerRow);
+        mBlockPos = 0;
+
+        mExtractor.read(types::RowCol<size_t>(mChip.offset.row + mNextRow,
+                                              mChip.offset.col),
+                        types::RowCol<size_t>(numRows, mChip.dims.col),
+                        false,
+                        &mBlock[0]);
+        mNextRow += numRows;
+    }
+
+private:
+    const ChipExtractor& mExtractor;
+    const Chip mChip;
+    const size_t mNumBytesPerRow;
+    const size_t mNumRowsPerBlock;
+
+    size_t mNextRow;
+    std::vector<sys::ubyte> mBlock;
+    size_t mBlockPos;
+};
+
+const size_t ChipExtractor::DEFAULT_BLOCK_SIZE = 32 * 1024 * 1024;
+
+ChipExtractor::ChipExtractor(NITFReadControl& reader,
+                             size_t imageNumber,
+                             size_t numThreads,
+                             size_t blockSize) :
+    mReader(reader),
+    mImageNumber(imageNumber),
+    mNumThreads(numThreads == 0 ?
+            sys::OS().getNumCPUsAvailable() : numThreads),
+    mBlockSize(blockSize),
+    mData(NULL)
+{
+    // SIDDs may carry SICD metadata too, which has no image
+    const mem::SharedPtr<const Container> container = reader.getContainer();
+    mDataType = container->getDataType();
+    for (size_t ii = 0, imageNum = 0; ii < container->getNumData(); ++ii)
+    {
+        const Data* const data = container->getData(ii);
+        if (data->getDataType() == mDataType && imageNum++ == imageNumber)
+        {
+            mData = data;
+            break;
+        }
+    }
+
+    if (mData == NULL)
+    {
+        std::ostringstream ostr;
+        ostr << "Image " << imageNumber << " doesn't exist";
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+
+    mRawSegments = getRawSegments();
+    if (!mRawSegments.empty() && !reader.getPathname().empty())
+    {
+        mAsyncFile.reset(new AsyncFile(reader.getPathname()));
+    }
+}
+
+ChipExtractor::~ChipExtractor()
+{
+}
+
+std::vector<ChipExtractor::Segment> ChipExtractor::getRawSegments() const
+{
+    std::vector<Segment> segments;
+    const std::vector<NITFImageInfo*>& infos = mReader.getInfos();
+    if (mImageNumber >= infos.size())
+    {
+        return segments;
+    }
+
+    const NITFImageInfo& info = *infos[mImageNumber];
+    const std::vector<NITFSegmentInfo> imageSegments =
+            info.getImageSegments();
+    nitf::List images = mReader.getRecord().getImages();
+    for (size_t ii = 0; ii < imageSegments.size(); ++ii)
+    {
+        nitf::ImageSegment image = images[info.getStartIndex() + ii];
+        nitf::ImageSubheader subheader = image.getSubheader();
+
+        std::string compression =
+                subheader.getImageCompression().toString();
+        str::trim(compression);
+        std::string mode = subheader.getImageMode().toString();
+        str::trim(mode);
+        const size_t numBitsPerPixel =
+                static_cast<nitf::Uint32>(subheader.getNumBitsPerPixel());
+        const size_t numBlocksPerRow = subheader.getNumBlocksPerRow();
+        const size_t numBlocksPerCol = subheader.getNumBlocksPerCol();
+        const size_t numPixelsPerHorizBlock =
+                subheader.getNumPixelsPerHorizBlock();
+
+        // Rows have to be one after another in the file
+        if (compression != "NC" ||
+            (mode != "P" && subheader.getBandCount() > 1) ||
+            numBitsPerPixel != info.getNumBitsPerPixel() ||
+            numBlocksPerRow != 1 ||
+            numBlocksPerCol != 1 ||
+            (numPixelsPerHorizBlock != 0 &&
+             numPixelsPerHorizBlock != mData->getNumCols()))
+        {
+            return std::vector<Segment>();
+        }
+
+        Segment segment;
+        segment.fileOffset = static_cast<nitf::Off>(image.getImageOffset());
+        segment.firstRow = imageSegments[ii].firstRow;
+        segment.numRows = imageSegments[ii].numRows;
+        segments.push_back(segment);
+    }
+    return segments;
+}
+
+void ChipExtractor::read(const types::RowCol<size_t>& offset,
+                         const types::RowCol<size_t>& dims,
+                         bool nativeByteOrder,
+                         UByte* buffer) const
+{
+    if (mRawSegments.empty())
+    {
+        six::Region region;
+        region.setStartRow(offset.row);
+        region.setStartCol(offset.col);
+        region.setNumRows(dims.row);
+        region.setNumCols(dims.col);
+        region.setBuffer(buffer);
+        mReader.interleaved(region, mImageNumber);
+        return;
+    }
+
+    readRaw(offset, dims, buffer);
+    if (nativeByteOrder && !sys::isBigEndianSystem())
+    {
+        // Complex pixels are swapped a component at a time
+        const size_t numBytesPerElement =
+                mData->getNumBytesPerPixel() / mData->getNumChannels();
+        sys::byteSwap(buffer,
+                      static_cast<unsigned short>(numBytesPerElement),
+                      dims.area() * mData->getNumChannels());
+    }
+}
+
+void ChipExtractor::readRaw(const types::RowCol<size_t>& offset,
+                            const types::RowCol<size_t>& dims,
+                            UByte* buffer) const
+{
+    const size_t numBytesPerPixel = mData->getNumBytesPerPixel();
+    const size_t numBytesPerRow = dims.col * numBytesPerPixel;
+    const size_t numBytesPerImageRow = mData->getNumCols() * numBytesPerPixel;
+    const size_t colOffset = offset.col * numBytesPerPixel;
+    const bool fullWidth = (numBytesPerRow == numBytesPerImageRow);
+
+    std::vector<AsyncFile::Request> requests;
+    size_t startRow = offset.row;
+    size_t numRows = dims.row;
+    for (size_t seg = 0; seg < mRawSegments.size() && numRows > 0; ++seg)
+    {
+        const Segment& segment = mRawSegments[seg];
+        const size_t segEndRow = segment.firstRow + segment.numRows;
+        if (startRow >= segEndRow)
+        {
+            continue;
+        }
+
+        const size_t numSegRows = std::min(numRows, segEndRow - startRow);
+        sys::Off_T fileOffset = segment.fileOffset +
+                static_cast<sys::Off_T>((startRow - segment.firstRow) *
+                                        numBytesPerImageRow + colOffset);
+        if (fullWidth)
+        {
+            // Rows are contiguous within a segment
+            requests.push_back(AsyncFile::Request(
+                    fileOffset, numSegRows * numBytesPerRow, buffer));
+            buffer += numSegRows * numBytesPerRow;
+        }
+        else
+        {
+            for (size_t row = 0; row < numSegRows; ++row)
+            {
+                requests.push_back(AsyncFile::Request(
+                        fileOffset, numBytesPerRow, buffer));
+                buffer += numBytesPerRow;
+                fileOffset += static_cast<sys::Off_T>(numBytesPerImageRow);
+            }
+        }
+
+        startRow += numSegRows;
+        numRows -= numSegRows;
+    }
+
+    if (mAsyncFile.get())
+    {
+        mAsyncFile->read(requests);
+        return;
+    }
+
+    nitf::IOInterface input = mReader.getReader().getInput();
+    for (size_t ii = 0; ii < requests.size(); ++ii)
+    {
+        input.seek(static_cast<nitf::Off>(requests[ii].offset),
+                   NITF_SEEK_SET);
+        input.read(requests[ii].buffer, requests[ii].length);
+    }
+}
+
+void ChipExtractor::checkChips(const std::vector<Chip>& chips) const
+{
+    const types::RowCol<size_t> dims(mData->getNumRows(),
+                                     mData->getNumCols());
+    for (size_t ii = 0; ii < chips.size(); ++ii)
+    {
+        const Chip& chip = chips[ii];
+        if (chip.offset.row + chip.dims.row > dims.row ||
+            chip.offset.col + chip.dims.col > dims.col)
+        {
+            std::ostringstream ostr;
+            ostr << "Chip " << ii << " is out of bounds";
+            throw except::Exception(Ctxt(ostr.str()));
+        }
+
+        if (chip.dims.row < 1 || chip.dims.col < 1)
+        {
+            std::ostringstream ostr;
+            ostr << "Chip " << ii << " is empty";
+            throw except::Exception(Ctxt(ostr.str()));
+        }
+    }
+}
+
+void ChipExtractor::extract(const std::vector<Chip>& chips,
+                            std::vector<std::vector<UByte> >& buffers) const
+{
+    checkChips(chips);
+    buffers.resize(chips.size());
+    extract(chips, &buffers, NULL, std::vector<std::string>());
+}
+
+void ChipExtractor::extract(const std::vector<Chip>& chips,
+                            const std::vector<std::string>& outPathnames,
+                            const std::vector<std::string>& schemaPaths) const
+{
+    if (outPathnames.size() != chips.size())
+    {
+        std::ostringstream ostr;
+        ostr << "Require " << chips.size() << " pathnames, received "
+             << outPathnames.size();
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+    checkChips(chips);
+    extract(chips, NULL, &outPathnames, schemaPaths);
+}
+
+void ChipExtractor::extract(const std::vector<Chip>& chips,
+                            std::vector<std::vector<UByte> >* buffers,
+                            const std::vector<std::string>* outPathnames,
+                            const std::vector<std::string>& schemaPaths) const
+{
+    const size_t numBytesPerPixel = mData->getNumBytesPerPixel();
+    const std::vector<Band> bands =
+            makeBands(chips, numBytesPerPixel, mBlockSize);
+
+    // Raw pixels are already big endian
+    six::Options options;
+    if (!mRawSegments.empty())
+    {
+        options.setParameter(six::WriteControl::OPT_BYTE_SWAP,
+                             six::Parameter(static_cast<int>(
+                                     six::ByteSwapping::SWAP_OFF)));
+    }
+
+    // A band only holds more than one chip if it fits in a block, so a
+    // band bigger than a block is a lone chip that can be streamed
+    const bool nativeByteOrder = (buffers != NULL);
+    std::vector<bool> streamed(bands.size());
+    for (size_t ii = 0; ii < bands.size(); ++ii)
+    {
+        streamed[ii] = outPathnames != NULL &&
+                bands[ii].dims.area() * numBytesPerPixel > mBlockSize;
+    }
+
+    // Read the next band while this band's chips are cut out
+    std::vector<UByte> pixels[2];
+    bool isRead = false;
+    for (size_t ii = 0; ii < bands.size(); ++ii)
+    {
+        const Band& band = bands[ii];
+        if (streamed[ii])
+        {
+            const Chip& chip = chips[band.chips[0]];
+            ChipInputStream input(*this, chip);
+            writeChip(*this, mDataType, options, chip,
+                      six::SourceList(1, &input),
+                      (*outPathnames)[band.chips[0]], schemaPaths);
+            continue;
+        }
+
+        std::vector<UByte>& bandPixels = pixels[ii % 2];
+        if (!isRead)
+        {
+            bandPixels.resize(band.dims.area() * numBytesPerPixel);
+            read(band.offset, band.dims, nativeByteOrder, &bandPixels[0]);
+        }
+
+        sys::AtomicCounter nextIndex;
+        mt::ThreadGroup threads;
+        const size_t numThreads = std::min(mNumThreads, band.chips.size());
+        for (size_t jj = 0; jj < numThreads; ++jj)
+        {
+            std::auto_ptr<sys::Runnable> runnable(new ChipRunnable(
+                    *this, mDataType, options, chips, band, bandPixels,
+                    buffers, outPathnames, schemaPaths, nextIndex));
+            threads.createThread(runnable);
+        }
+
+        isRead = (ii + 1 < bands.size() && !streamed[ii + 1]);
+        if (isRead)
+        {
+            const Band& nextBand = bands[ii + 1];
+            std::vector<UByte>& nextPixels = pixels[(ii + 1) % 2];
+            nextPixels.resize(nextBand.dims.area() * numBytesPerPixel);
+            read(nextBand.offset, nextBand.dims, nativeByteOrder,
+                 &nextPixels[0]);
+        }
+
+        threads.joinAll();
+    }
+}
+}
@@ -0,0 +1,296 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <algorithm>
+#include <memory>
+
+#include <mt/ThreadGroup.h>
+#include <sys/AtomicCounter.h>
+#include <sys/OS.h>
+#include <sys/Runnable.h>
+#include <six/MetadataExtractor.h>
+#include <six/NITFReadControl.h>
+#include <six/Utilities.h>
+
+namespace
+{
+// Creation and collection times are optional in some versions of the specs
+// and their getters throw when they're missing
+std::string getCreationTime(const six::Data& data)
+{
+    try
+    {
+        return six::toString(data.getCreationTime());
+    }
+    catch (const except::Exception&)
+    {
+        return "";
+    }
+}
+
+std::string getCollectionStart(const six::Data& data)
+{
+    try
+    {
+        return six::toString(data.getCollectionStartDateTime());
+    }
+    catch (const except::Exception&)
+    {
+        return "";
+    }
+}
+
+void extractOne(const std::vector<const six::MetadataExtractor*>& extractors,
+                six::MetadataSummary& summary)
+{
+    try
+    {
+        if (!sys::OS().isFile(summary.pathname))
+        {
+            summary.error = "File not found";
+            return;
+        }
+
+        for (size_t ii = 0; ii < extractors.size(); ++ii)
+        {
+            if (extractors[ii]->supports(summary.pathname))
+            {
+                extractors[ii]->extract(summary.pathname, summary);
+                summary.success = true;
+                return;
+            }
+        }
+        summary.error = "Unsupported file type";
+    }
+    catch (const except::Exception& ex)
+    {
+        summary.error = ex.getMessage();
+    }
+    catch (const std::exception& ex)
+    {
+        summary.error = ex.what();
+    }
+    catch (...)
+    {
+        summary.error = "Unknown exception";
+    }
+}
+
+class ExtractMetadataRunnable : public sys::Runnable
+{
+public:
+    ExtractMetadataRunnable(
+            const std::vector<const six::MetadataExtractor*>& extractors,
+            sys::AtomicCounter& nextIndex,
+            std::vector<six::MetadataSummary>& summaries) :
+        mExtractors(extractors),
+        mNextIndex(nextIndex),
+        mSummaries(summaries)
+    {
+    }
+
+    virtual void run()
+    {
+        while (true)
+        {
+            const size_t index =
+                    static_cast<size_t>(mNextIndex.getThenIncrement());
+            if (index >= mSummaries.size())
+            {
+                break;
+            }
+            extractOne(mExtractors, mSummaries[index]);
+        }
+    }
+
+private:
+    const std::vector<const six::MetadataExtractor*>& mExtractors;
+    sys::AtomicCounter& mNextIndex;
+    std::vector<six::MetadataSummary>& mSummaries;
+};
+
+void writeCSVField(const std::string& field, std::ostream& os)
+{
+    if (field.find_first_of(",\"\r\n") == std::string::npos)
+    {
+        os << field;
+        return;
+    }
+
+    os << '"';
+    for (size_t ii = 0; ii < field.length(); ++ii)
+    {
+        if (field[ii] == '"')
+        {
+            os << '"';
+        }
+        os << field[ii];
+    }
+    os << '"';
+}
+}
+
+namespace six
+{
+MetadataSummary::MetadataSummary() :
+    success(false),
+    numImages(0),
+    numRows(0),
+    numCols(0)
+{
+}
+
+NITFMetadataExtractor::NITFMetadataExtractor(
+        const XMLControlRegistry* xmlRegistry,
+        const std::vector<std::string>& schemaPaths) :
+    mXMLRegistry(xmlRegistry),
+    mSchemaPaths(schemaPaths)
+{
+}
+
+bool NITFMetadataExtractor::supports(const std::string& pathname) const
+{
+    try
+    {
+        return nitf::Reader::getNITFVersion(pathname) != NITF_VER_UNKNOWN;
+    }
+    catch (const except::Exception&)
+    {
+        return false;
+    }
+}
+
+void NITFMetadataExtractor::extract(const std::string& pathname,
+                                    MetadataSummary& summary) const
+{
+    NITFReadControl reader;
+    reader.setXMLControlRegistry(mXMLRegistry);
+    reader.loadMetadata(pathname, mSchemaPaths);
+
+    const mem::SharedPtr<Container> container = reader.getContainer();
+    const Data& data = *container->getData(0);
+
+    summary.fileType =
+            (container->getDataType() == DataType::COMPLEX) ? "SICD" : "SIDD";
+    summary.version = data.getVersion();
+    summary.name = data.getName();
+    summary.classification = data.getClassification().getLevel();
+    summary.collectionStart = getCollectionStart(data);
+    summary.creationTime = getCreationTime(data);
+    summary.numImages = container->getNumData();
+    summary.numRows = data.getNumRows();
+    summary.numCols = data.getNumCols();
+    summary.pixelType = data.getPixelType().toString();
+    summary.corners = data.getImageCorners();
+}
+
+void extractMetadata(const std::vector<std::string>& pathnames,
+                     const std::vector<const MetadataExtractor*>& extractors,
+                     size_t numThreads,
+                     std::vector<MetadataSummary>& summaries)
+{
+    summaries.clear();
+    summaries.resize(pathnames.size());
+    for (size_t ii = 0; ii < pathnames.size(); ++ii)
+    {
+        summaries[ii].pathname = pathnames[ii];
+    }
+
+    if (numThreads == 0)
+    {
+        numThreads = sys::OS().getNumCPUsAvailable();
+    }
+    numThreads = std::min(numThreads, pathnames.size());
+
+    sys::AtomicCounter nextIndex;
+    if (numThreads <= 1)
+    {
+        ExtractMetadataRunnable(extractors, nextIndex, summaries).run();
+    }
+    else
+    {
+        mt::ThreadGroup threads;
+        for (size_t ii = 0; ii < numThreads; ++ii)
+        {
+            std::auto_ptr<sys::Runnable> runnable(
+                    new ExtractMetadataRunnable(extractors,
+                                                nextIndex,
+                                                summaries));
+            threads.createThread(runnable);
+        }
+        threads.joinAll();
+    }
+}
+
+void writeMetadataCSV(const std::vector<MetadataSummary>& summaries,
+                      std::ostream& os)
+{
+    static const char* const CORNER_NAMES[] =
+    {
+        "UpperLeft", "UpperRight", "LowerRight", "LowerLeft"
+    };
+
+    os << "Pathname,Success,Error,FileType,Version,Name,Classification,"
+       << "CollectionStart,CreationTime,NumImages,NumRows,NumCols,PixelType";
+    for (size_t ii = 0; ii < LatLonCorners::NUM_CORNERS; ++ii)
+    {
+        os << "," << CORNER_NAMES[ii] << "Lat," << CORNER_NAMES[ii] << "Lon";
+    }
+    os << "\n";
+
+    const std::streamsize origPrecision = os.precision(12);
+    for (size_t ii = 0; ii < summaries.size(); ++ii)
+    {
+        const MetadataSummary& summary = summaries[ii];
+        writeCSVField(summary.pathname, os);
+        os << "," << (summary.success ? "true" : "false") << ",";
+        writeCSVField(summary.error, os);
+
+        if (summary.success)
+        {
+            os << "," << summary.fileType << ",";
+            writeCSVField(summary.version, os);
+            os << ",";
+            writeCSVField(summary.name, os);
+            os << ",";
+            writeCSVField(summary.classification, os);
+            os << "," << summary.collectionStart
+               << "," << summary.creationTime
+               << "," << summary.numImages
+               << "," << summary.numRows
+               << "," << summary.numCols
+               << "," << summary.pixelType;
+            for (size_t jj = 0; jj < LatLonCorners::NUM_CORNERS; ++jj)
+            {
+                const LatLon& corner = summary.corners.getCorner(jj);
+                os << "," << corner.getLat() << "," << corner.getLon();
+            }
+        }
+        else
+        {
+            // Keep the column count constant so the file loads as a table
+            os << std::string(10 + 2 * LatLonCorners::NUM_CORNERS, ',');
+        }
+        os << "\n";
+    }
+    os.precision(origPrecision);
+}
+}
@@ -20,6 +20,7 @@
  *
  */
 
+#include <algorithm>
 #include <memory>
 #include <sstream>
 #include <limits>
@@ -141,7 +142,9 @@ void NITFImageInfo::computeSegmentCorners()
     Vector3 icp4 = scene::Utilities::latLonToECEF(corners.lowerLeft);
 
     size_t numIS = mImageSegments.size();
-    double total = mData->getNumRows() - 1.0;
+
+    // A single row image has a single segment whose weights would be 0/0
+    double total = std::max(mData->getNumRows() - 1.0, 1.0);
 
     Vector3 ecef;
     size_t i;
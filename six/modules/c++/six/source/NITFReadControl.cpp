@@ -22,6 +22,7 @@
 
 #include <sstream>
 
+#include <nitf/BufferedReader.hpp>
 #include <six/NITFReadControl.h>
 #include <six/XMLControlFactory.h>
 #include <six/Utilities.h>
@@ -38,6 +39,10 @@ types::RowCol<size_t> parseILOC(const std::string& str)
     return iLoc;
 }
 
+// Large enough to hold the NITF file header and SICD/SIDD image subheaders
+// in a single read
+const size_t METADATA_READ_BUFFER_SIZE = 64 * 1024;
+
 void assignLUT(nitf::ImageSubheader& subheader, six::Legend& legend)
 {
     nitf::LookupTable lut =
@@ -81,7 +86,8 @@ six::PixelType getPixelType(nitf::ImageSubheader& subheader)
 
 namespace six
 {
-NITFReadControl::NITFReadControl()
+NITFReadControl::NITFReadControl() :
+    mMetadataOnly(false)
 {
     // Make sure that if we use XML_DATA_CONTENT that we've loaded it into the
     // singleton PluginRegistry
@@ -241,6 +247,7 @@ void NITFReadControl::load(const std::string& fromFile,
 {
     mem::SharedPtr<nitf::IOInterface> handle(new nitf::IOHandle(fromFile));
     load(handle, schemaPaths);
+    mPathname = fromFile;
 }
 
 void NITFReadControl::load(io::SeekableInputStream& stream,
@@ -255,11 +262,28 @@ void NITFReadControl::load(mem::SharedPtr<nitf::IOInterface> ioInterface)
     load(ioInterface, std::vector<std::string>());
 }
 
-void NITFReadControl::load(mem::SharedPtr<nitf::IOInterface> ioInterface,
-                           const std::vector<std::string>& schemaPaths)
+void NITFReadControl::loadMetadata(const std::string& fromFile,
+                                   const std::vector<std::string>& schemaPaths)
+{
+    mem::SharedPtr<nitf::IOInterface> handle(
+            new nitf::BufferedReader(fromFile, METADATA_READ_BUFFER_SIZE));
+    loadMetadata(handle, schemaPaths);
+}
+
+void NITFReadControl::loadMetadata(
+        mem::SharedPtr<nitf::IOInterface> ioInterface,
+        const std::vector<std::string>& schemaPaths)
+{
+    loadRecord(ioInterface, schemaPaths, true);
+}
+
+void NITFReadControl::loadRecord(mem::SharedPtr<nitf::IOInterface> ioInterface,
+                                 const std::vector<std::string>& schemaPaths,
+                                 bool metadataOnly)
 {
     reset();
     mInterface = ioInterface;
+    mMetadataOnly = metadataOnly;
 
     mRecord = mReader.readIO(*ioInterface);
     const DataType dataType = getDataType(mRecord);
@@ -273,14 +297,18 @@ void NITFReadControl::load(mem::SharedPtr<nitf::IOInterface> ioInterface,
     {
         nitf::DESegment segment = (nitf::DESegment) *desIter;
         nitf::DESubheader subheader = segment.getSubheader();
-        nitf::SegmentReader deReader = mReader.newDEReader(i);
 
         if (getDataType(segment) == DataType::NOT_SET)
         {
-            mContainer->addDESSource(nitf::SegmentReaderSource(deReader));
+            if (!metadataOnly)
+            {
+                mContainer->addDESSource(
+                        nitf::SegmentReaderSource(mReader.newDEReader(i)));
+            }
         }
         else
         {
+            nitf::SegmentReader deReader = mReader.newDEReader(i);
             SegmentInputStreamAdapter ioAdapter(deReader);
             std::auto_ptr<Data> data(parseData(*mXMLRegistry,
                                                ioAdapter,
@@ -296,7 +324,8 @@ void NITFReadControl::load(mem::SharedPtr<nitf::IOInterface> ioInterface,
             // is one DES per data, so it's safe to do this
             addDEClassOptions(subheader, data->getClassification());
 
-            if (data->getDataType() == six::DataType::DERIVED)
+            if (data->getDataType() == six::DataType::DERIVED &&
+                !metadataOnly)
             {
                 mContainer->addData(data, findLegend(productNum));
             }
@@ -318,6 +347,20 @@ void NITFReadControl::load(mem::SharedPtr<nitf::IOInterface> ioInterface,
                 "SICD/SIDD files must have at least one image"));
     }
 
+    if (mContainer->getDataType() == DataType::COMPLEX &&
+        mContainer->getNumData() != 1)
+    {
+        throw except::Exception(Ctxt(
+                "SICD file must have exactly 1 SICD DES but got " +
+                str::toString(mContainer->getNumData())));
+    }
+}
+
+void NITFReadControl::load(mem::SharedPtr<nitf::IOInterface> ioInterface,
+                           const std::vector<std::string>& schemaPaths)
+{
+    loadRecord(ioInterface, schemaPaths, false);
+
     // For SICD, we'll have exactly one DES
     // For SIDD, we'll have one SIDD DES per image product
     // We may also have some SICD DES's (this occurs if the SIDD was generated
@@ -325,13 +368,6 @@ void NITFReadControl::load(mem::SharedPtr<nitf::IOInterface> ioInterface,
     // over these when saving off NITFImageInfo's
     if (mContainer->getDataType() == DataType::COMPLEX)
     {
-        if (mContainer->getNumData() != 1)
-        {
-            throw except::Exception(Ctxt(
-                    "SICD file must have exactly 1 SICD DES but got " +
-                    str::toString(mContainer->getNumData())));
-        }
-
         mInfos.push_back(new NITFImageInfo(mContainer->getData(0)));
     }
     else
@@ -402,7 +438,7 @@ void NITFReadControl::load(mem::SharedPtr<nitf::IOInterface> ioInterface,
         NITFSegmentInfo si;
         si.numRows = numRowsSeg;
 
-        std::vector < NITFSegmentInfo > imageSegments
+        const std::vector<NITFSegmentInfo>& imageSegments
                 = currentInfo->getImageSegments();
 
         if (productSegmentIdx == 0)
@@ -601,6 +637,12 @@ NITFReadControl::getIndices(nitf::ImageSubheader& subheader) const
 
 UByte* NITFReadControl::interleaved(Region& region, size_t imageNumber)
 {
+    if (mMetadataOnly)
+    {
+        throw except::Exception(Ctxt(
+                "Only metadata was loaded; call load() to read pixel data"));
+    }
+
     NITFImageInfo* thisImage = mInfos[imageNumber];
 
     size_t numRowsTotal = thisImage->getData()->getNumRows();
@@ -653,7 +695,7 @@ UByte* NITFReadControl::interleaved(Region& region, size_t imageNumber)
     sw.setNumBands(1);
     sw.setBandList(&bandList);
 
-    std::vector < NITFSegmentInfo > imageSegments
+    const std::vector<NITFSegmentInfo>& imageSegments
             = thisImage->getImageSegments();
     size_t numIS = imageSegments.size();
     size_t startOff = 0;
@@ -789,6 +831,7 @@ void NITFReadControl::reset()
     }
     mInfos.clear();
     mInterface.reset();
+    mPathname.clear();
 }
 
 
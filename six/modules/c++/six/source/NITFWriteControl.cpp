@@ -226,6 +226,71 @@ void NITFWriteControl::save(const SourceList& imageData,
     addDataAndWrite(schemaPaths);
 }
 
+std::vector<nitf::Off> NITFWriteControl::saveWithoutImageData(
+        const std::string& outputFile,
+        const std::vector<std::string>& schemaPaths)
+{
+    const size_t bufferSize = getOptions().getParameter(
+            WriteControl::OPT_BUFFER_SIZE,
+            Parameter(NITFHeaderCreator::DEFAULT_BUFFER_SIZE));
+    nitf::BufferedWriter bufferedIO(outputFile, bufferSize);
+
+    const std::vector<nitf::Off> offsets =
+            saveWithoutImageData(bufferedIO, schemaPaths);
+    bufferedIO.close();
+    return offsets;
+}
+
+std::vector<nitf::Off> NITFWriteControl::saveWithoutImageData(
+        nitf::IOInterface& outputFile,
+        const std::vector<std::string>& schemaPaths)
+{
+    // The pixels are written raw and unblocked, so the image subheaders
+    // must not describe them as anything else
+    const six::Options& options = getOptions();
+    if (options.hasParameter(NITFHeaderCreator::OPT_J2K_COMPRESSION_BYTERATE))
+    {
+        throw except::Exception(Ctxt(
+                "J2K compression is not supported when writing without "
+                "image data"));
+    }
+    if (options.hasParameter(NITFHeaderCreator::OPT_NUM_ROWS_PER_BLOCK) ||
+        options.hasParameter(NITFHeaderCreator::OPT_NUM_COLS_PER_BLOCK))
+    {
+        throw except::Exception(Ctxt(
+                "Blocking is not supported when writing without image data"));
+    }
+
+    nitf::Record& record = getRecord();
+    mWriter.prepareIO(outputFile, record);
+
+    std::vector<nitf::Off> offsets(record.getNumImages());
+    const std::vector<mem::SharedPtr<NITFImageInfo> >& infos = getInfos();
+    for (size_t ii = 0; ii < infos.size(); ++ii)
+    {
+        const NITFImageInfo& info = *(infos[ii]);
+        const std::vector<NITFSegmentInfo> imageSegments =
+                info.getImageSegments();
+        const size_t numBytesPerRow = info.getData()->getNumCols() *
+                info.getData()->getNumBytesPerPixel();
+
+        for (size_t jj = 0; jj < imageSegments.size(); ++jj)
+        {
+            const size_t index = info.getStartIndex() + jj;
+            mem::SharedPtr< ::nitf::WriteHandler> writeHandler(
+                    new ReservedWriteHandler(
+                            imageSegments[jj].numRows * numBytesPerRow,
+                            &offsets.at(index)));
+
+            mWriter.setImageWriteHandler(static_cast<int>(index),
+                                         writeHandler);
+        }
+    }
+
+    addDataAndWrite(schemaPaths);
+    return offsets;
+}
+
 void NITFWriteControl::save(const BufferList& imageData,
                             const std::string& outputFile,
                             const std::vector<std::string>& schemaPaths)
@@ -387,12 +452,18 @@ void NITFWriteControl::addDataAndWrite(
     // SegmentMemorySource's will be pointing to them
     const mem::ScopedArray<std::string> desStrs(new std::string[numDES]);
 
+    const bool fullPrecisionNumbers = static_cast<int>(
+            getOptions().getParameter(
+                    six::WriteControl::OPT_FULL_PRECISION_NUMBERS,
+                    Parameter(0))) != 0;
+
     for (size_t ii = 0; ii < getContainer()->getNumData(); ++ii)
     {
         const Data* data = getContainer()->getData(ii);
         std::string& desStr(desStrs[ii]);
 
-        desStr = six::toValidXMLString(data, schemaPaths, mLog, mXMLRegistry);
+        desStr = six::toValidXMLString(data, schemaPaths, mLog, mXMLRegistry,
+                                       fullPrecisionNumbers);
         nitf::SegmentWriter deWriter =
                 mWriter.newDEWriter(static_cast<int>(ii));
         nitf::SegmentMemorySource segSource(
@@ -0,0 +1,170 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <mt/CriticalSection.h>
+#include <sys/Mutex.h>
+#include <six/Parameter.h>
+
+namespace
+{
+// Formatting is rare, so parameters share a few mutexes instead of each
+// carrying its own
+sys::Mutex& getFormatMutex(const void* parameter)
+{
+    static sys::Mutex mutexes[16];
+    return mutexes[(reinterpret_cast<size_t>(parameter) / sizeof(void*)) % 16];
+}
+}
+
+namespace six
+{
+Parameter::Parameter(const Parameter& other) :
+    mName(other.mName),
+    mType(other.mType),
+    mReal(other.mReal),
+    mImag(other.mImag),
+    mInt(other.mInt),
+    mUint(other.mUint),
+    mFormatted(false)
+{
+    // A numeric value's string may be getting formatted by another thread,
+    // so it's left to be formatted again if needed
+    if (mType == STRING)
+    {
+        mValue = other.mValue;
+    }
+}
+
+Parameter& Parameter::operator=(const Parameter& other)
+{
+    if (this != &other)
+    {
+        mName = other.mName;
+        mType = other.mType;
+        mReal = other.mReal;
+        mImag = other.mImag;
+        mInt = other.mInt;
+        mUint = other.mUint;
+        mFormatted = false;
+        if (mType == STRING)
+        {
+            mValue = other.mValue;
+        }
+        else
+        {
+            mValue.clear();
+        }
+    }
+    return *this;
+}
+
+bool Parameter::operator==(const Parameter& o) const
+{
+    if (mName != o.mName)
+    {
+        return false;
+    }
+
+    // Identical numeric values always format identically, but different
+    // values may too (e.g. a float and the double nearest to it), so
+    // only a match can be decided without formatting
+    if (mType == o.mType && mType != STRING &&
+        mReal == o.mReal && mImag == o.mImag &&
+        mInt == o.mInt && mUint == o.mUint)
+    {
+        return true;
+    }
+    return getString() == o.getString();
+}
+
+const std::string& Parameter::getString() const
+{
+    // Strings are never modified through a const Parameter
+    if (mType == STRING)
+    {
+        return mValue;
+    }
+
+    // Once formatted, mValue doesn't change until the value is set again
+    mt::CriticalSection<sys::Mutex> crit(&getFormatMutex(this));
+    if (!mFormatted)
+    {
+        mValue = format();
+        mFormatted = true;
+    }
+    return mValue;
+}
+
+std::string Parameter::format() const
+{
+    // Format the way the value would have been formatted when set, so
+    // this is identical to having stored the string up front
+    switch (mType)
+    {
+    case FLOAT:
+        return str::toString(static_cast<float>(mReal));
+    case DOUBLE:
+        return str::toString(mReal);
+    case INT:
+        return str::toString(mInt);
+    case UINT:
+        return str::toString(mUint);
+    case COMPLEX_FLOAT:
+        return str::toString(std::complex<float>(static_cast<float>(mReal),
+                                                 static_cast<float>(mImag)));
+    case COMPLEX_DOUBLE:
+        return str::toString(std::complex<double>(mReal, mImag));
+    case COMPLEX_INT:
+        return str::toString(std::complex<int>(static_cast<int>(mReal),
+                                               static_cast<int>(mImag)));
+    default:
+        return mValue;
+    }
+}
+
+void Parameter::setFloatingPoint(StorageType type, double real, double imag)
+{
+    mType = type;
+    clearNumeric();
+    mReal = real;
+    mImag = imag;
+    mValue.clear();
+    mFormatted = false;
+}
+
+void Parameter::setSigned(sys::Int64_T value)
+{
+    mType = INT;
+    clearNumeric();
+    mInt = value;
+    mValue.clear();
+    mFormatted = false;
+}
+
+void Parameter::setUnsigned(sys::Uint64_T value)
+{
+    mType = UINT;
+    clearNumeric();
+    mUint = value;
+    mValue.clear();
+    mFormatted = false;
+}
+}
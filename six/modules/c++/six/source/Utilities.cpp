@@ -20,7 +20,13 @@
  *
  */
 
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iomanip>
+#include <limits>
 #include <sstream>
 
 #include <logging/NullLogger.h>
@@ -33,6 +39,244 @@ namespace
 {
 NITF_TRE_STATIC_HANDLER_REF(XML_DATA_CONTENT);
 
+// Formats value as [-]d.dddE[-]xx with 'precision' digits after the point,
+// exactly as an ostringstream with std::scientific would, minus the '+' in
+// the exponent to meet the SICD XML standard.  sprintf() is much cheaper
+// than a stream, but it follows LC_NUMERIC, so whatever decimal point the
+// locale uses is replaced with '.'.
+std::string toScientific(double value, int precision)
+{
+    char buffer[64];
+    std::sprintf(buffer, "%.*E", precision, value);
+
+    const char* ptr = buffer;
+    std::string result;
+    result.reserve(precision + 8);
+    if (*ptr == '-')
+    {
+        result += *ptr++;
+    }
+    if (!std::isdigit(static_cast<unsigned char>(*ptr)))
+    {
+        // NAN or INF
+        return buffer;
+    }
+    result += *ptr++;
+
+    if (*ptr != 'E')
+    {
+        result += '.';
+        while (!std::isdigit(static_cast<unsigned char>(*ptr)))
+        {
+            ++ptr;
+        }
+    }
+    const char* exponent = std::strchr(ptr, 'E');
+    result.append(ptr, exponent);
+
+    result += 'E';
+    ++exponent;
+    if (*exponent == '+')
+    {
+        ++exponent;
+    }
+    result.append(exponent);
+    return result;
+}
+
+double parse(const char* str, double)
+{
+    return std::strtod(str, NULL);
+}
+
+float parse(const char* str, float)
+{
+    return std::strtof(str, NULL);
+}
+
+// strtod() follows LC_NUMERIC just like sprintf(), so the candidate is
+// checked with the locale's decimal point swapped in for the '.'
+template <typename T>
+bool roundTrips(const std::string& str, const std::string& localePoint, T value)
+{
+    if (localePoint == ".")
+    {
+        return parse(str.c_str(), value) == value;
+    }
+
+    std::string localeStr(str);
+    const size_t pointPos = localeStr.find('.');
+    if (pointPos != std::string::npos)
+    {
+        localeStr.replace(pointPos, 1, localePoint);
+    }
+    return parse(localeStr.c_str(), value) == value;
+}
+
+// Writes [-]d[.ddd]E[-]xx, the scientific notation used throughout the
+// SICD/SIDD/CPHD XML, dropping any trailing zeros from the mantissa
+std::string formatScientific(bool negative,
+                             const char* digits,
+                             size_t numDigits,
+                             int exponent)
+{
+    while (numDigits > 1 && digits[numDigits - 1] == '0')
+    {
+        --numDigits;
+    }
+
+    std::string result;
+    result.reserve(numDigits + 8);
+    if (negative)
+    {
+        result += '-';
+    }
+    result += digits[0];
+    if (numDigits > 1)
+    {
+        result += '.';
+        result.append(digits + 1, numDigits - 1);
+    }
+
+    // No + in the exponent to meet the SICD XML standard, but always at
+    // least two digits
+    result += 'E';
+    if (exponent < 0)
+    {
+        result += '-';
+        exponent = -exponent;
+    }
+    char exponentDigits[8];
+    size_t numExponentDigits = 0;
+    do
+    {
+        exponentDigits[numExponentDigits++] =
+                static_cast<char>('0' + exponent % 10);
+        exponent /= 10;
+    } while (exponent > 0);
+    if (numExponentDigits < 2)
+    {
+        result += '0';
+    }
+    while (numExponentDigits > 0)
+    {
+        result += exponentDigits[--numExponentDigits];
+    }
+    return result;
+}
+
+// Rounds the first numDigits of digits, up or down, and formats the result
+std::string roundDigits(bool negative,
+                        const char* digits,
+                        size_t numDigits,
+                        int exponent,
+                        bool roundUp)
+{
+    char rounded[32];
+    std::memcpy(rounded, digits, numDigits);
+    if (roundUp)
+    {
+        size_t ii = numDigits;
+        while (ii > 0 && rounded[ii - 1] == '9')
+        {
+            rounded[--ii] = '0';
+        }
+        if (ii == 0)
+        {
+            // 9.99... rounded up to 1.00...E(n+1)
+            rounded[0] = '1';
+            ++exponent;
+        }
+        else
+        {
+            ++rounded[ii - 1];
+        }
+    }
+    return formatScientific(negative, rounded, numDigits, exponent);
+}
+
+bool isHalfway(const char* digits, size_t numDigits)
+{
+    if (digits[0] != '5')
+    {
+        return false;
+    }
+    for (size_t ii = 1; ii < numDigits; ++ii)
+    {
+        if (digits[ii] != '0')
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Formats value with the fewest significant digits that parse back to
+// exactly the same value.  Formatting once with maxDigits and rounding that
+// down is much cheaper than reformatting at each candidate length.
+template <typename T>
+std::string toShortestScientific(T value, size_t minDigits, size_t maxDigits)
+{
+    // Sign, maxDigits digits, point, and a 3 digit exponent fit with room to
+    // spare, even if the locale's decimal point is several bytes
+    char buffer[64];
+    std::sprintf(buffer, "%.*E", static_cast<int>(maxDigits - 1),
+                 static_cast<double>(value));
+
+    const bool negative = (buffer[0] == '-');
+    const char* const mantissa = buffer + (negative ? 1 : 0);
+    if (!std::isdigit(static_cast<unsigned char>(mantissa[0])))
+    {
+        // NAN or INF
+        return buffer;
+    }
+
+    // Whatever sits between the first digit and the rest is the locale's
+    // decimal point
+    const char* fraction = mantissa + 1;
+    while (!std::isdigit(static_cast<unsigned char>(*fraction)))
+    {
+        ++fraction;
+    }
+    const std::string localePoint(mantissa + 1, fraction);
+
+    char digits[32];
+    digits[0] = mantissa[0];
+    std::memcpy(digits + 1, fraction, maxDigits - 1);
+    const int exponent = std::atoi(fraction + maxDigits);
+
+    // Subnormals carry fewer bits, so they can need far fewer digits
+    if (value != 0 && std::abs(value) < std::numeric_limits<T>::min())
+    {
+        minDigits = 1;
+    }
+
+    for (size_t numDigits = minDigits; numDigits < maxDigits; ++numDigits)
+    {
+        const bool roundUp = (digits[numDigits] >= '5');
+        std::string candidate =
+                roundDigits(negative, digits, numDigits, exponent, roundUp);
+        if (roundTrips(candidate, localePoint, value))
+        {
+            return candidate;
+        }
+
+        // The digits are already rounded once, so if the ones dropped read
+        // exactly 5000..., value may really have been just under halfway
+        if (roundUp && isHalfway(digits + numDigits, maxDigits - numDigits))
+        {
+            candidate =
+                    roundDigits(negative, digits, numDigits, exponent, false);
+            if (roundTrips(candidate, localePoint, value))
+            {
+                return candidate;
+            }
+        }
+    }
+
+    return formatScientific(negative, digits, maxDigits, exponent);
+}
+
 void assign(math::linear::MatrixMxN<7, 7>& sensorCovar,
             size_t row,
             size_t col,
@@ -106,23 +350,26 @@ std::string six::toString<float>(const float& value)
                 Ctxt("Attempted use of uninitialized float value"));
     }
 
-    std::ostringstream os;
-    size_t precision = std::numeric_limits<float>::max_digits10;
-    os << std::uppercase << std::scientific << std::setprecision(precision)
-       << value;
-    std::string strValue = os.str();
+    return toShortestScientific(value,
+                                std::numeric_limits<float>::digits10,
+                                std::numeric_limits<float>::max_digits10);
+}
 
-    // remove any + in scientific notation to meet SICD XML standard
-    size_t plusPos = strValue.find("+");
-    if (plusPos != std::string::npos)
+template <>
+std::string six::toString<double>(const double& value)
+{
+    if (six::Init::isUndefined(value))
     {
-        strValue.erase(plusPos, 1);
+        throw six::UninitializedValueException(
+                Ctxt("Attempted use of uninitialized double value"));
     }
-    return strValue;
+
+    return toShortestScientific(value,
+                                std::numeric_limits<double>::digits10,
+                                std::numeric_limits<double>::max_digits10);
 }
 
-template <>
-std::string six::toString<double>(const double& value)
+std::string six::toFullPrecisionString(double value)
 {
     if (six::Init::isUndefined(value))
     {
@@ -130,19 +377,18 @@ std::string six::toString<double>(const double& value)
                 Ctxt("Attempted use of uninitialized double value"));
     }
 
-    std::ostringstream os;
-    size_t precision = std::numeric_limits<double>::max_digits10;
-    os << std::uppercase << std::scientific << std::setprecision(precision)
-       << value;
-    std::string strValue = os.str();
+    return toScientific(value, std::numeric_limits<double>::max_digits10);
+}
 
-    // remove any + in scientific notation to meet SICD XML standard
-    size_t plusPos = strValue.find("+");
-    if (plusPos != std::string::npos)
+std::string six::toFullPrecisionString(float value)
+{
+    if (six::Init::isUndefined(value))
     {
-        strValue.erase(plusPos, 1);
+        throw six::UninitializedValueException(
+                Ctxt("Attempted use of uninitialized float value"));
     }
-    return strValue;
+
+    return toScientific(value, std::numeric_limits<float>::max_digits10);
 }
 
 template <>
@@ -23,4 +23,6 @@
 
 const char six::WriteControl::OPT_BYTE_SWAP[] = "ByteSwap";
 const char six::WriteControl::OPT_BUFFER_SIZE[] = "BufferSize";
+const char six::WriteControl::OPT_FULL_PRECISION_NUMBERS[] =
+        "FullPrecisionNumbers";
 
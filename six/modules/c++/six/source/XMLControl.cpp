@@ -20,14 +20,164 @@
  *
  */
 
+#include <algorithm>
+#include <map>
+
 #include <logging/NullLogger.h>
+#include <mem/SharedPtr.h>
+#include <mt/CriticalSection.h>
+#include <str/Manip.h>
+#include <sys/Mutex.h>
 #include <six/XMLControl.h>
 
+namespace
+{
+// Validators compiled from one set of schema paths.  The underlying parser
+// isn't reentrant, so each validation checks out a validator of its own and
+// hands it back afterwards.  The pool grows to the number of threads that
+// have validated against these paths at once.
+class ValidatorPool
+{
+public:
+    explicit ValidatorPool(const std::vector<std::string>& paths) :
+        mPaths(paths),
+        mNumValidators(0)
+    {
+    }
+
+    ~ValidatorPool()
+    {
+        for (size_t ii = 0; ii < mIdle.size(); ++ii)
+        {
+            delete mIdle[ii];
+        }
+    }
+
+    xml::lite::Validator* checkOut(logging::Logger* log)
+    {
+        {
+            mt::CriticalSection<sys::Mutex> crit(&mMutex);
+            if (!mIdle.empty())
+            {
+                xml::lite::Validator* const validator = mIdle.back();
+                mIdle.pop_back();
+                return validator;
+            }
+        }
+
+        // Compile outside of the lock so validations that already have a
+        // validator aren't held up
+        std::auto_ptr<xml::lite::Validator> validator(
+                new xml::lite::Validator(mPaths, log, true));
+
+        mt::CriticalSection<sys::Mutex> crit(&mMutex);
+        mIdle.reserve(mNumValidators + 1);
+        ++mNumValidators;
+        return validator.release();
+    }
+
+    void checkIn(xml::lite::Validator* validator)
+    {
+        // There's room for every validator handed out, so this can't throw
+        mt::CriticalSection<sys::Mutex> crit(&mMutex);
+        mIdle.push_back(validator);
+    }
+
+    size_t getNumValidators() const
+    {
+        mt::CriticalSection<sys::Mutex> crit(&mMutex);
+        return mNumValidators;
+    }
+
+private:
+    ValidatorPool(const ValidatorPool&);
+    ValidatorPool& operator=(const ValidatorPool&);
+
+private:
+    const std::vector<std::string> mPaths;
+    std::vector<xml::lite::Validator*> mIdle;
+    size_t mNumValidators;
+    mutable sys::Mutex mMutex;
+};
+
+// Holds a validator checked out of a pool for one validation
+class PooledValidator
+{
+public:
+    PooledValidator(const mem::SharedPtr<ValidatorPool>& pool,
+                    logging::Logger* log) :
+        mPool(pool),
+        mValidator(pool->checkOut(log))
+    {
+    }
+
+    ~PooledValidator()
+    {
+        mPool->checkIn(mValidator);
+    }
+
+    const xml::lite::Validator* operator->() const
+    {
+        return mValidator;
+    }
+
+private:
+    PooledValidator(const PooledValidator&);
+    PooledValidator& operator=(const PooledValidator&);
+
+private:
+    const mem::SharedPtr<ValidatorPool> mPool;
+    xml::lite::Validator* const mValidator;
+};
+
+struct ValidatorCache
+{
+    typedef std::map<std::string, mem::SharedPtr<ValidatorPool> > Map;
+
+    Map pools;
+    sys::Mutex mutex;
+};
+
+ValidatorCache& getValidatorCache()
+{
+    static ValidatorCache cache;
+    return cache;
+}
+
+// Every schema under the paths is loaded into the validator's pool
+// regardless of the document's URI, so the path set alone determines what
+// gets compiled.  Order doesn't matter.
+std::string getCacheKey(const std::vector<std::string>& paths)
+{
+    std::vector<std::string> sortedPaths(paths);
+    std::sort(sortedPaths.begin(), sortedPaths.end());
+    return str::join(sortedPaths, "\n");
+}
+
+mem::SharedPtr<ValidatorPool>
+getValidatorPool(const std::vector<std::string>& paths)
+{
+    const std::string key = getCacheKey(paths);
+
+    ValidatorCache& cache(getValidatorCache());
+    mt::CriticalSection<sys::Mutex> crit(&cache.mutex);
+    ValidatorCache::Map::iterator iter = cache.pools.find(key);
+    if (iter == cache.pools.end())
+    {
+        iter = cache.pools.insert(ValidatorCache::Map::value_type(
+                key,
+                mem::SharedPtr<ValidatorPool>(new ValidatorPool(paths)))).first;
+    }
+    return iter->second;
+}
+}
+
 namespace six
 {
 XMLControl::XMLControl(logging::Logger* log, bool ownLog) :
     mLog(NULL),
-    mOwnLog(false)
+    mOwnLog(false),
+    mFullPrecisionNumbers(false)
 {
     setLogger(log, ownLog);
 }
@@ -60,11 +210,9 @@ void XMLControl::loadSchemaPaths(std::vector<std::string>& schemaPaths)
     }
 }
 
-//  NOTE: Errors are treated as detriments to valid processing
-//        and fail accordingly
-void XMLControl::validate(const xml::lite::Document* doc,
-                          const std::vector<std::string>& schemaPaths,
-                          logging::Logger* log)
+std::vector<std::string>
+XMLControl::getValidationPaths(const std::vector<std::string>& schemaPaths,
+                               logging::Logger* log)
 {
     // attempt to get the schema location from the
     // environment if nothing is specified
@@ -92,49 +240,137 @@ void XMLControl::validate(const xml::lite::Document* doc,
         }
     }
 
+    return paths;
+}
+
+//  NOTE: Errors are treated as detriments to valid processing
+//        and fail accordingly
+void XMLControl::validate(const xml::lite::Document* doc,
+                          const std::vector<std::string>& schemaPaths,
+                          logging::Logger* log,
+                          bool prettyPrint)
+{
+    const std::vector<std::string> paths =
+            getValidationPaths(schemaPaths, log);
+
     // validate against any specified schemas
     if (!paths.empty())
     {
-        xml::lite::Validator validator(paths, log, true);
+        const std::string& uri = doc->getRootElement()->getUri();
+        if (uri.empty())
+        {
+            throw six::DESValidationException(Ctxt(
+                    "INVALID XML: URI is empty so document version cannot be "
+                    "determined to use for validation"));
+        }
+
+        io::StringStream xmlStream;
+        if (prettyPrint)
+        {
+            doc->getRootElement()->prettyPrint(xmlStream);
+        }
+        else
+        {
+            doc->getRootElement()->print(xmlStream);
+        }
 
         std::vector<xml::lite::ValidationInfo> errors;
+        validateImpl(xmlStream.stream().str(), uri, paths, log, errors);
 
-        if (doc->getRootElement()->getUri().empty())
+        // Everything is on one line when printed compactly, so validate
+        // again pretty-printed to get line numbers worth logging
+        if (!errors.empty() && !prettyPrint)
+        {
+            io::StringStream prettyStream;
+            doc->getRootElement()->prettyPrint(prettyStream);
+            errors.clear();
+            validateImpl(prettyStream.stream().str(), uri, paths, log, errors);
+        }
+
+        reportErrors(errors, log);
+    }
+}
+
+void XMLControl::validate(const std::string& xml,
+                          const std::string& uri,
+                          const std::vector<std::string>& schemaPaths,
+                          logging::Logger* log)
+{
+    const std::vector<std::string> paths =
+            getValidationPaths(schemaPaths, log);
+
+    if (!paths.empty())
+    {
+        if (uri.empty())
         {
             throw six::DESValidationException(Ctxt(
                     "INVALID XML: URI is empty so document version cannot be "
                     "determined to use for validation"));
         }
 
-        // Pretty-print so that lines numbers are useful
-        io::StringStream xmlStream;
-        doc->getRootElement()->prettyPrint(xmlStream);
+        std::vector<xml::lite::ValidationInfo> errors;
+        validateImpl(xml, uri, paths, log, errors);
+        reportErrors(errors, log);
+    }
+}
 
-        validator.validate(xmlStream, doc->getRootElement()->getUri(), errors);
+void XMLControl::validateImpl(const std::string& xml,
+                              const std::string& uri,
+                              const std::vector<std::string>& paths,
+                              logging::Logger* log,
+                              std::vector<xml::lite::ValidationInfo>& errors)
+{
+    const PooledValidator validator(getValidatorPool(paths), log);
+    validator->validate(xml, uri, errors);
+}
 
-        // log any error found and throw
-        if (!errors.empty())
+void XMLControl::reportErrors(
+        const std::vector<xml::lite::ValidationInfo>& errors,
+        logging::Logger* log)
+{
+    // log any error found and throw
+    if (!errors.empty())
+    {
+        if (log)
         {
-            if (log)
+            for (size_t i = 0; i < errors.size(); ++i)
             {
-                for (size_t i = 0; i < errors.size(); ++i)
-                {
-                    log->critical(errors[i].toString());
-                }
+                log->critical(errors[i].toString());
             }
-
-            //! this is a unique error thrown only in this location --
-            //  if the user wants a file written regardless of the consequences
-            //  they can catch this error, clear the vector and SIX_SCHEMA_PATH
-            //  and attempt to rewrite the file. Continuing in this manner is
-            //  highly discouraged
-            throw six::DESValidationException(
-                    Ctxt("INVALID XML: Check both the XML being "
-                         "produced and the schemas available"));
         }
+
+        //! this is a unique error thrown only in this location --
+        //  if the user wants a file written regardless of the consequences
+        //  they can catch this error, clear the vector and SIX_SCHEMA_PATH
+        //  and attempt to rewrite the file. Continuing in this manner is
+        //  highly discouraged
+        throw six::DESValidationException(
+                Ctxt("INVALID XML: Check both the XML being "
+                     "produced and the schemas available"));
     }
 }
 
+void XMLControl::clearValidatorCache()
+{
+    // Validations in progress keep their pools alive until they finish
+    ValidatorCache& cache(getValidatorCache());
+    mt::CriticalSection<sys::Mutex> crit(&cache.mutex);
+    cache.pools.clear();
+}
+
+size_t XMLControl::getNumCachedValidators(
+        const std::vector<std::string>& schemaPaths)
+{
+    std::vector<std::string> paths(schemaPaths);
+    loadSchemaPaths(paths);
+    const std::string key = getCacheKey(paths);
+
+    ValidatorCache& cache(getValidatorCache());
+    mt::CriticalSection<sys::Mutex> crit(&cache.mutex);
+    const ValidatorCache::Map::const_iterator iter = cache.pools.find(key);
+    return (iter == cache.pools.end()) ? 0 : iter->second->getNumValidators();
+}
+
 void XMLControl::setLogger(logging::Logger* log, bool own)
 {
     if (mLog && mOwnLog && log != mLog)
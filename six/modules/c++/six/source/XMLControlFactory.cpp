@@ -81,7 +81,8 @@ std::string six::toXMLString(const Data* data,
 std::string six::toValidXMLString(const Data* data,
                                   const std::vector<std::string>& schemaPaths,
                                   logging::Logger* log,
-                                  const six::XMLControlRegistry *xmlRegistry)
+                                  const six::XMLControlRegistry *xmlRegistry,
+                                  bool fullPrecisionNumbers)
 {
     if (!xmlRegistry)
     {
@@ -90,6 +91,7 @@ std::string six::toValidXMLString(const Data* data,
 
     const std::auto_ptr<XMLControl>
         xmlControl(xmlRegistry->newXMLControl(data->getDataType(), log));
+    xmlControl->setFullPrecisionNumbers(fullPrecisionNumbers);
 
     // this will validate if SIX_SCHEMA_PATH EnvVar is set
     const std::auto_ptr<xml::lite::Document> doc(
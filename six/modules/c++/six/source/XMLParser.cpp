@@ -20,6 +20,14 @@
  *
  */
 
+#include <cstdlib>
+#include <cstring>
+#include <locale.h>
+#include <stdlib.h>
+#if defined(__APPLE__)
+#include <xlocale.h>
+#endif
+
 #include <sys/Conf.h>
 #include <except/Exception.h>
 #include <str/Convert.h>
@@ -30,6 +38,74 @@
 namespace
 {
 typedef xml::lite::Element* XMLElem;
+
+// Counts the direct children of parent named tag, returning the first one
+// found (or NULL).  Cheaper than getElementsByTagName() for the common case
+// of looking up a single child since nothing is allocated.
+XMLElem findChild(XMLElem parent, const std::string& tag, size_t& numFound)
+{
+    XMLElem found = NULL;
+    numFound = 0;
+
+    const std::vector<XMLElem>& children = parent->getChildren();
+    for (size_t ii = 0; ii < children.size(); ++ii)
+    {
+        if (children[ii]->getLocalName() == tag)
+        {
+            if (numFound++ == 0)
+            {
+                found = children[ii];
+            }
+        }
+    }
+    return found;
+}
+
+#if defined(_WIN32) || defined(__GLIBC__) || defined(__APPLE__) || \
+        defined(__FreeBSD__)
+#define SIX_HAVE_STRTOD_L 1
+
+// strtod() follows LC_NUMERIC, so it would misread "1.5" under a locale
+// with a comma decimal separator.  Always parse in the "C" locale.
+double strtodClassic(const char* str, char** end)
+{
+#if defined(_WIN32)
+    static const _locale_t cLocale = _create_locale(LC_NUMERIC, "C");
+    return _strtod_l(str, end, cLocale);
+#else
+    static const locale_t cLocale =
+            newlocale(LC_NUMERIC_MASK, "C", static_cast<locale_t>(0));
+    return strtod_l(str, end, cLocale);
+#endif
+}
+#endif
+
+// strtod() is much faster than str::toType(), which goes through a
+// stringstream.  Anything it doesn't handle the same way (no digits,
+// hex, inf/nan, overflow) is left for str::toType() to accept or reject,
+// as is everything on platforms without a locale-independent strtod().
+bool parseDoubleFast(const std::string& str, double& value)
+{
+#ifdef SIX_HAVE_STRTOD_L
+    const char* const begin = str.c_str();
+    if (std::strpbrk(begin, "xXnN") != NULL)
+    {
+        return false;
+    }
+
+    char* end = NULL;
+    const double result = strtodClassic(begin, &end);
+    if (end == begin || result - result != 0.0)
+    {
+        return false;
+    }
+
+    value = result;
+    return true;
+#else
+    return false;
+#endif
+}
 }
 
 namespace six
@@ -40,6 +116,7 @@ XMLParser::XMLParser(const std::string& defaultURI,
                      bool ownLog) :
     mDefaultURI(defaultURI),
     mAddClassAttributes(addClassAttributes),
+    mFullPrecisionNumbers(false),
     mLog(NULL),
     mOwnLog(false)
 {
@@ -74,6 +151,11 @@ void XMLParser::setLogger(logging::Logger* log, bool own)
     }
 }
 
+void XMLParser::setFullPrecisionNumbers(bool fullPrecision)
+{
+    mFullPrecisionNumbers = fullPrecision;
+}
+
 XMLElem XMLParser::newElement(const std::string& name, XMLElem parent) const
 {
     return newElement(name, mDefaultURI, parent);
@@ -171,7 +253,8 @@ XMLElem XMLParser::createDouble(const std::string& name,
     std::string elementValue;
     try
     {
-        elementValue = six::toString<double>(p);
+        elementValue = mFullPrecisionNumbers ?
+                six::toFullPrecisionString(p) : six::toString<double>(p);
     }
     catch (const except::Exception& ex)
     {
@@ -284,23 +367,23 @@ XMLElem XMLParser::createDate(const std::string& name, const DateTime& p,
 
 XMLElem XMLParser::getFirstAndOnly(XMLElem parent, const std::string& tag)
 {
-    std::vector < XMLElem > children;
-    parent->getElementsByTagName(tag, children);
-    if (children.size() != 1)
+    size_t numFound;
+    XMLElem child = findChild(parent, tag, numFound);
+    if (numFound != 1)
     {
         throw except::Exception(Ctxt(
                  "Expected exactly one " + tag + " but got " +
-                    str::toString(children.size())));
+                    str::toString(numFound)));
     }
-    return children[0];
+    return child;
 }
 XMLElem XMLParser::getOptional(XMLElem parent, const std::string& tag)
 {
-    std::vector < XMLElem > children;
-    parent->getElementsByTagName(tag, children);
-    if (children.size() != 1)
+    size_t numFound;
+    XMLElem child = findChild(parent, tag, numFound);
+    if (numFound != 1)
         return NULL;
-    return children[0];
+    return child;
 }
 
 XMLElem XMLParser::require(XMLElem element, const std::string& name)
@@ -325,9 +408,15 @@ void XMLParser::setAttribute(XMLElem e, const std::string& name,
 
 void XMLParser::parseDouble(XMLElem element, double& value) const
 {
+    const std::string& charData = element->getCharacterData();
+    if (parseDoubleFast(charData, value))
+    {
+        return;
+    }
+
     try
     {
-        value = str::toType<double>(element->getCharacterData());
+        value = str::toType<double>(charData);
     }
     catch (const except::BadCastException& ex)
     {
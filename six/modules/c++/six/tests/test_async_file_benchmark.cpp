@@ -0,0 +1,157 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Times random reads from a file with six::AsyncFile at queue depths from
+ * 1 to 64, with each backend that's available, against reading the same
+ * regions one at a time from an io::FileInputStream.
+ *
+ * The OS caches what's read, so to measure the disk rather than memory,
+ * use a file bigger than RAM or drop the page cache between runs.
+ *
+ * Usage: test_async_file_benchmark <pathname> [read size in KB]
+ *                                             [number of reads]
+ */
+
+#include <stdlib.h>
+
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <except/Exception.h>
+#include <io/FileInputStream.h>
+#include <str/Convert.h>
+#include <sys/StopWatch.h>
+#include <six/AsyncFile.h>
+
+namespace
+{
+void printRate(const std::string& name,
+               size_t queueDepth,
+               size_t numReads,
+               size_t readSize,
+               double seconds)
+{
+    std::cout << std::fixed << std::setprecision(1)
+              << std::setw(12) << name
+              << std::setw(8) << queueDepth
+              << std::setw(12) << numReads * readSize / seconds / 1.0e6
+              << std::setw(12) << numReads / seconds << std::endl;
+}
+
+std::string toString(six::AsyncFile::Backend backend)
+{
+    return (backend == six::AsyncFile::IO_URING) ? "io_uring" : "Threads";
+}
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        if (argc < 2 || argc > 4)
+        {
+            std::cerr << "Usage: " << argv[0]
+                      << " <pathname> [read size in KB] [number of reads]\n";
+            return 1;
+        }
+        const std::string pathname(argv[1]);
+        const size_t readSize = (argc > 2) ?
+                str::toType<size_t>(argv[2]) * 1024 : 64 * 1024;
+        const size_t numReads = (argc > 3) ?
+                str::toType<size_t>(argv[3]) : 4096;
+
+        const six::AsyncFile sizeCheck(pathname);
+        const size_t numSlots = static_cast<size_t>(sizeCheck.getSize()) /
+                readSize;
+        if (numSlots == 0)
+        {
+            throw except::Exception(Ctxt(
+                    "File is smaller than one read"));
+        }
+
+        // Random, read-sized pieces of the file, each into its own buffer
+        std::vector<sys::ubyte> buffer(numReads * readSize);
+        std::vector<six::AsyncFile::Request> requests(numReads);
+        srand(1);
+        for (size_t ii = 0; ii < numReads; ++ii)
+        {
+            const size_t slot = static_cast<size_t>(rand()) % numSlots;
+            requests[ii] = six::AsyncFile::Request(
+                    static_cast<sys::Off_T>(slot * readSize),
+                    readSize,
+                    &buffer[ii * readSize]);
+        }
+
+        std::cout << numReads << " reads of " << readSize << " bytes\n"
+                  << std::setw(12) << "Backend"
+                  << std::setw(8) << "Depth"
+                  << std::setw(12) << "MB/s"
+                  << std::setw(12) << "IOPS" << std::endl;
+
+        {
+            io::FileInputStream input(pathname);
+            sys::RealTimeStopWatch stopWatch;
+            stopWatch.start();
+            for (size_t ii = 0; ii < numReads; ++ii)
+            {
+                input.seek(requests[ii].offset, io::Seekable::START);
+                input.read(requests[ii].buffer, readSize, true);
+            }
+            printRate("Stream", 1, numReads, readSize,
+                      stopWatch.stop() / 1000);
+        }
+
+        std::vector<six::AsyncFile::Backend> backends;
+        backends.push_back(six::AsyncFile::THREAD_POOL);
+        if (six::AsyncFile::isIoUringAvailable())
+        {
+            backends.push_back(six::AsyncFile::IO_URING);
+        }
+
+        for (size_t ii = 0; ii < backends.size(); ++ii)
+        {
+            for (size_t queueDepth = 1; queueDepth <= 64; queueDepth *= 2)
+            {
+                // Don't split reads so the queue depth is what's measured
+                const six::AsyncFile file(pathname, queueDepth, backends[ii],
+                                          0);
+                sys::RealTimeStopWatch stopWatch;
+                stopWatch.start();
+                file.read(requests);
+                printRate(toString(backends[ii]), queueDepth, numReads,
+                          readSize, stopWatch.stop() / 1000);
+            }
+        }
+        return 0;
+    }
+    catch (const except::Exception& ex)
+    {
+        std::cerr << ex.toString() << std::endl;
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+    }
+    return 1;
+}
@@ -0,0 +1,301 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <stdlib.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <io/FileOutputStream.h>
+#include <io/TempFile.h>
+#include <mt/ThreadGroup.h>
+#include <six/AsyncFile.h>
+#include "TestCase.h"
+
+namespace
+{
+const size_t FILE_SIZE = 1024 * 1024 + 123;
+
+sys::ubyte valueAt(size_t offset)
+{
+    return static_cast<sys::ubyte>((offset * 13) ^ (offset >> 10));
+}
+
+void writeFile(const std::string& pathname)
+{
+    std::vector<sys::ubyte> contents(FILE_SIZE);
+    for (size_t ii = 0; ii < contents.size(); ++ii)
+    {
+        contents[ii] = valueAt(ii);
+    }
+    io::FileOutputStream output(pathname);
+    output.write(&contents[0], contents.size());
+    output.close();
+}
+
+std::vector<six::AsyncFile::Backend> getBackends()
+{
+    std::vector<six::AsyncFile::Backend> backends;
+    backends.push_back(six::AsyncFile::THREAD_POOL);
+    if (six::AsyncFile::isIoUringAvailable())
+    {
+        backends.push_back(six::AsyncFile::IO_URING);
+    }
+    return backends;
+}
+
+// rand() isn't thread-safe, so each thread has its own generator
+size_t nextRandom(unsigned int& seed)
+{
+    seed = seed * 1664525U + 1013904223U;
+    return seed >> 8;
+}
+
+// Reads batches of random requests, checking what comes back
+class ReadBatches : public sys::Runnable
+{
+public:
+    ReadBatches(const six::AsyncFile& file,
+                unsigned int seed,
+                bool& success) :
+        mFile(file),
+        mSeed(seed),
+        mSuccess(success)
+    {
+    }
+
+    virtual void run()
+    {
+        mSuccess = true;
+        for (size_t batch = 0; batch < 20; ++batch)
+        {
+            std::vector<six::AsyncFile::Request> requests;
+            std::vector<std::vector<sys::ubyte> > buffers(50);
+            for (size_t ii = 0; ii < buffers.size(); ++ii)
+            {
+                const size_t length = 1 + nextRandom(mSeed) % 3000;
+                const size_t offset = nextRandom(mSeed) % (FILE_SIZE - length);
+                buffers[ii].resize(length);
+                requests.push_back(six::AsyncFile::Request(
+                        offset, length, &buffers[ii][0]));
+            }
+
+            mFile.read(requests);
+
+            for (size_t ii = 0; ii < buffers.size(); ++ii)
+            {
+                for (size_t jj = 0; jj < buffers[ii].size(); ++jj)
+                {
+                    if (buffers[ii][jj] != valueAt(requests[ii].offset + jj))
+                    {
+                        mSuccess = false;
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    const six::AsyncFile& mFile;
+    unsigned int mSeed;
+    bool& mSuccess;
+};
+
+TEST_CASE(testBackend)
+{
+    const io::TempFile tempFile;
+    writeFile(tempFile.pathname());
+
+    const six::AsyncFile autoFile(tempFile.pathname());
+    TEST_ASSERT(autoFile.getBackend() != six::AsyncFile::AUTO);
+    TEST_ASSERT_EQ(autoFile.getQueueDepth(),
+                   six::AsyncFile::DEFAULT_QUEUE_DEPTH);
+    TEST_ASSERT_EQ(autoFile.getSize(), static_cast<sys::Off_T>(FILE_SIZE));
+
+    const six::AsyncFile threadedFile(tempFile.pathname(), 4,
+                                      six::AsyncFile::THREAD_POOL);
+    TEST_ASSERT_EQ(threadedFile.getBackend(), six::AsyncFile::THREAD_POOL);
+
+    if (!six::AsyncFile::isIoUringAvailable())
+    {
+        TEST_EXCEPTION(six::AsyncFile(tempFile.pathname(), 4,
+                                      six::AsyncFile::IO_URING));
+    }
+
+    TEST_EXCEPTION(six::AsyncFile(tempFile.pathname() + ".missing"));
+}
+
+TEST_CASE(testReadBatch)
+{
+    const io::TempFile tempFile;
+    writeFile(tempFile.pathname());
+
+    const std::vector<six::AsyncFile::Backend> backends(getBackends());
+    for (size_t backend = 0; backend < backends.size(); ++backend)
+    {
+        // A small queue and chunk size so requests are split and there
+        // are more of them than fit in the queue
+        const six::AsyncFile file(tempFile.pathname(), 3, backends[backend],
+                                  1000);
+        TEST_ASSERT_EQ(file.getBackend(), backends[backend]);
+
+        srand(42);
+        std::vector<six::AsyncFile::Request> requests;
+        std::vector<std::vector<sys::ubyte> > buffers(200);
+        for (size_t ii = 0; ii < buffers.size(); ++ii)
+        {
+            const size_t length = (ii == 0) ? 0 : rand() % 5000;
+            const size_t offset = rand() % (FILE_SIZE - length);
+            buffers[ii].resize(length + 1);
+            requests.push_back(six::AsyncFile::Request(
+                    offset, length, &buffers[ii][0]));
+        }
+        // And the whole file at once
+        std::vector<sys::ubyte> wholeFile(FILE_SIZE);
+        requests.push_back(six::AsyncFile::Request(
+                0, wholeFile.size(), &wholeFile[0]));
+
+        file.read(requests);
+
+        for (size_t ii = 0; ii < buffers.size(); ++ii)
+        {
+            const six::AsyncFile::Request& request(requests[ii]);
+            for (size_t jj = 0; jj < request.length; ++jj)
+            {
+                TEST_ASSERT_EQ(buffers[ii][jj],
+                               valueAt(request.offset + jj));
+            }
+        }
+        for (size_t ii = 0; ii < wholeFile.size(); ++ii)
+        {
+            TEST_ASSERT_EQ(wholeFile[ii], valueAt(ii));
+        }
+
+        // Nothing to read is fine
+        file.read(std::vector<six::AsyncFile::Request>());
+    }
+}
+
+TEST_CASE(testReadPastEnd)
+{
+    const io::TempFile tempFile;
+    writeFile(tempFile.pathname());
+
+    const std::vector<six::AsyncFile::Backend> backends(getBackends());
+    for (size_t backend = 0; backend < backends.size(); ++backend)
+    {
+        const six::AsyncFile file(tempFile.pathname(), 4, backends[backend]);
+        std::vector<sys::ubyte> buffer(100);
+        TEST_EXCEPTION(file.read(FILE_SIZE - 50, buffer.size(), &buffer[0]));
+        TEST_EXCEPTION(file.read(-1, buffer.size(), &buffer[0]));
+
+        // One bad read in a batch fails the whole batch
+        std::vector<std::vector<sys::ubyte> > buffers(
+                20, std::vector<sys::ubyte>(100));
+        std::vector<six::AsyncFile::Request> requests;
+        for (size_t ii = 0; ii < buffers.size(); ++ii)
+        {
+            const sys::Off_T offset = (ii == 10) ? FILE_SIZE - 50 : ii * 100;
+            requests.push_back(six::AsyncFile::Request(
+                    offset, buffers[ii].size(), &buffers[ii][0]));
+        }
+        TEST_EXCEPTION(file.read(requests));
+
+        // The file is still usable afterwards
+        file.read(FILE_SIZE - 100, buffer.size(), &buffer[0]);
+        TEST_ASSERT_EQ(buffer[99], valueAt(FILE_SIZE - 1));
+    }
+}
+
+TEST_CASE(testThreadsStartedLazily)
+{
+    const io::TempFile tempFile;
+    writeFile(tempFile.pathname());
+
+    const six::AsyncFile file(tempFile.pathname(), 8,
+                              six::AsyncFile::THREAD_POOL);
+    TEST_ASSERT_EQ(file.getNumThreads(), 0);
+
+    // The caller does single reads by itself
+    std::vector<sys::ubyte> buffer(100);
+    file.read(0, buffer.size(), &buffer[0]);
+    TEST_ASSERT_EQ(file.getNumThreads(), 0);
+
+    // Threads are added as batches need them, up to the queue depth
+    std::vector<std::vector<sys::ubyte> > buffers(
+            20, std::vector<sys::ubyte>(100));
+    std::vector<six::AsyncFile::Request> requests;
+    for (size_t ii = 0; ii < buffers.size(); ++ii)
+    {
+        requests.push_back(six::AsyncFile::Request(
+                ii * 100, buffers[ii].size(), &buffers[ii][0]));
+    }
+    file.read(std::vector<six::AsyncFile::Request>(requests.begin(),
+                                                   requests.begin() + 3));
+    TEST_ASSERT_EQ(file.getNumThreads(), 2);
+
+    file.read(requests);
+    TEST_ASSERT_EQ(file.getNumThreads(), 7);
+    TEST_ASSERT_EQ(buffers[19][99], valueAt(1999));
+
+    file.read(std::vector<six::AsyncFile::Request>(requests.begin(),
+                                                   requests.begin() + 2));
+    TEST_ASSERT_EQ(file.getNumThreads(), 7);
+}
+
+TEST_CASE(testConcurrentReads)
+{
+    const io::TempFile tempFile;
+    writeFile(tempFile.pathname());
+
+    const std::vector<six::AsyncFile::Backend> backends(getBackends());
+    for (size_t backend = 0; backend < backends.size(); ++backend)
+    {
+        // The same file and its readers are shared by every batch
+        const six::AsyncFile file(tempFile.pathname(), 4, backends[backend],
+                                  1000);
+        const size_t numThreads = 4;
+        bool success[numThreads];
+        mt::ThreadGroup threads;
+        for (size_t ii = 0; ii < numThreads; ++ii)
+        {
+            threads.createThread(new ReadBatches(
+                    file, static_cast<unsigned int>(ii), success[ii]));
+        }
+        threads.joinAll();
+
+        for (size_t ii = 0; ii < numThreads; ++ii)
+        {
+            TEST_ASSERT(success[ii]);
+        }
+    }
+}
+}
+
+int main(int, char**)
+{
+    TEST_CHECK(testBackend);
+    TEST_CHECK(testReadBatch);
+    TEST_CHECK(testReadPastEnd);
+    TEST_CHECK(testThreadsStartedLazily);
+    TEST_CHECK(testConcurrentReads);
+    return 0;
+}
@@ -0,0 +1,293 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <cctype>
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include "TestCase.h"
+
+#include <six/Utilities.h>
+
+namespace
+{
+// xs:double lexical form the way SICD writes it: an optional sign, a
+// mantissa with at most one digit before the point, and an exponent with no
+// '+' sign
+bool isSICDScientific(const std::string& str)
+{
+    size_t pos = 0;
+    if (pos < str.length() && str[pos] == '-')
+    {
+        ++pos;
+    }
+    if (pos >= str.length() || !std::isdigit(str[pos]))
+    {
+        return false;
+    }
+    ++pos;
+    if (pos < str.length() && str[pos] == '.')
+    {
+        ++pos;
+        while (pos < str.length() && std::isdigit(str[pos]))
+        {
+            ++pos;
+        }
+    }
+    if (pos >= str.length() || str[pos] != 'E')
+    {
+        return false;
+    }
+    ++pos;
+    if (pos < str.length() && str[pos] == '-')
+    {
+        ++pos;
+    }
+    const size_t exponentStart = pos;
+    while (pos < str.length() && std::isdigit(str[pos]))
+    {
+        ++pos;
+    }
+    return pos == str.length() && pos - exponentStart >= 2;
+}
+
+// Number of significant digits written in str's mantissa
+size_t countDigits(const std::string& str)
+{
+    size_t numDigits = 0;
+    for (size_t ii = 0; ii < str.length() && str[ii] != 'E'; ++ii)
+    {
+        if (std::isdigit(str[ii]))
+        {
+            ++numDigits;
+        }
+    }
+    return numDigits;
+}
+
+double parse(const char* str, double)
+{
+    return std::strtod(str, NULL);
+}
+
+float parse(const char* str, float)
+{
+    return std::strtof(str, NULL);
+}
+
+// True if value, rounded to one digit fewer than str has, no longer reads
+// back exactly
+template <typename T>
+bool isShortest(T value, const std::string& str)
+{
+    const size_t numDigits = countDigits(str);
+    if (numDigits <= 1)
+    {
+        return true;
+    }
+
+    char shorter[64];
+    std::sprintf(shorter, "%.*E", static_cast<int>(numDigits - 2),
+                 static_cast<double>(value));
+    return parse(shorter, value) != value;
+}
+
+template <typename T>
+void checkFormat(const std::string& testName, T value)
+{
+    const std::string str = six::toString(value);
+    TEST_ASSERT(isSICDScientific(str));
+    TEST_ASSERT_EQ(parse(str.c_str(), value), value);
+    TEST_ASSERT(isShortest(value, str));
+}
+
+// What toString() produced when it formatted through an ostringstream
+template <typename T>
+std::string streamFormat(T value)
+{
+    std::ostringstream os;
+    os << std::uppercase << std::scientific
+       << std::setprecision(std::numeric_limits<T>::max_digits10) << value;
+    std::string str = os.str();
+    const size_t plusPos = str.find('+');
+    if (plusPos != std::string::npos)
+    {
+        str.erase(plusPos, 1);
+    }
+    return str;
+}
+
+TEST_CASE(testShortestForm)
+{
+    TEST_ASSERT_EQ(six::toString(1.0), "1E00");
+    TEST_ASSERT_EQ(six::toString(0.0), "0E00");
+    TEST_ASSERT_EQ(six::toString(0.1), "1E-01");
+    TEST_ASSERT_EQ(six::toString(-1.25e-3), "-1.25E-03");
+    TEST_ASSERT_EQ(six::toString(123456.789), "1.23456789E05");
+    TEST_ASSERT_EQ(six::toString(9.9999999999999999e22), "1E23");
+    TEST_ASSERT_EQ(six::toString(1.0e300), "1E300");
+    TEST_ASSERT_EQ(six::toString(std::numeric_limits<double>::denorm_min()),
+                   "5E-324");
+
+    // Needs all 17 significant digits
+    TEST_ASSERT_EQ(six::toString(0.1 + 0.2), "3.0000000000000004E-01");
+
+    TEST_ASSERT_EQ(six::toString(1.5f), "1.5E00");
+    TEST_ASSERT_EQ(six::toString(0.1f), "1E-01");
+}
+
+TEST_CASE(testFullPrecision)
+{
+    TEST_ASSERT_EQ(six::toFullPrecisionString(1.0), "1.00000000000000000E00");
+    TEST_ASSERT_EQ(six::toFullPrecisionString(0.0), "0.00000000000000000E00");
+    TEST_ASSERT_EQ(six::toFullPrecisionString(-1.25e-3),
+                   "-1.25000000000000003E-03");
+    TEST_ASSERT_EQ(six::toFullPrecisionString(1.0e300),
+                   "1.00000000000000005E300");
+    TEST_ASSERT_EQ(six::toFullPrecisionString(1.5f), "1.500000000E00");
+    TEST_ASSERT_EQ(six::toFullPrecisionString(0.1f), "1.000000015E-01");
+
+    std::srand(0);
+    for (size_t ii = 0; ii < 1000; ++ii)
+    {
+        const double value = std::ldexp(
+                static_cast<double>(std::rand()) / RAND_MAX - 0.5,
+                std::rand() % 200 - 100);
+        TEST_ASSERT_EQ(six::toFullPrecisionString(value), streamFormat(value));
+
+        const float floatValue = static_cast<float>(value);
+        TEST_ASSERT_EQ(six::toFullPrecisionString(floatValue),
+                       streamFormat(floatValue));
+    }
+}
+
+TEST_CASE(testDoublesRoundTrip)
+{
+    const double specialValues[] =
+    {
+        1.0 / 3.0,
+        std::numeric_limits<double>::min(),
+        std::numeric_limits<double>::max(),
+        std::numeric_limits<double>::denorm_min(),
+        std::numeric_limits<double>::epsilon(),
+        -4.45303008e6,
+        5.75153322e3
+    };
+    for (size_t ii = 0;
+         ii < sizeof(specialValues) / sizeof(specialValues[0]);
+         ++ii)
+    {
+        checkFormat(testName, specialValues[ii]);
+    }
+
+    std::srand(0);
+    for (size_t ii = 0; ii < 10000; ++ii)
+    {
+        const double mantissa =
+                static_cast<double>(std::rand()) / RAND_MAX - 0.5;
+        const int exponent = std::rand() % 200 - 100;
+        checkFormat(testName, std::ldexp(mantissa, exponent));
+    }
+}
+
+TEST_CASE(testShortDecimals)
+{
+    // Values read from text with only a few digits must be written back
+    // with no more than that
+    std::srand(0);
+    for (size_t ii = 0; ii < 10000; ++ii)
+    {
+        char decimal[32];
+        std::sprintf(decimal, "%dE%d", std::rand() % 100000 - 50000,
+                     std::rand() % 60 - 30);
+
+        const double value = std::strtod(decimal, NULL);
+        checkFormat(testName, value);
+        TEST_ASSERT(countDigits(six::toString(value)) <= 5);
+
+        const float floatValue = std::strtof(decimal, NULL);
+        checkFormat(testName, floatValue);
+        TEST_ASSERT(countDigits(six::toString(floatValue)) <= 5);
+    }
+}
+
+TEST_CASE(testFloatsRoundTrip)
+{
+    checkFormat(testName, std::numeric_limits<float>::min());
+    checkFormat(testName, std::numeric_limits<float>::max());
+    checkFormat(testName, std::numeric_limits<float>::denorm_min());
+
+    std::srand(0);
+    for (size_t ii = 0; ii < 10000; ++ii)
+    {
+        const float mantissa =
+                static_cast<float>(std::rand()) / RAND_MAX - 0.5f;
+        const int exponent = std::rand() % 60 - 30;
+        checkFormat(testName, std::ldexp(mantissa, exponent));
+    }
+}
+
+TEST_CASE(testLocale)
+{
+    // Only meaningful where one of these locales is installed
+    const char* const locales[] =
+    {
+        "de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "fr_FR.utf8", "German"
+    };
+    bool haveLocale = false;
+    for (size_t ii = 0;
+         ii < sizeof(locales) / sizeof(locales[0]) && !haveLocale;
+         ++ii)
+    {
+        haveLocale = (std::setlocale(LC_NUMERIC, locales[ii]) != NULL);
+    }
+    if (!haveLocale)
+    {
+        return;
+    }
+
+    const std::string shortest = six::toString(-1.25e-3);
+    const std::string fullPrecision = six::toFullPrecisionString(1.5);
+    const std::string mostDigits = six::toString(0.1 + 0.2);
+    std::setlocale(LC_NUMERIC, "C");
+
+    TEST_ASSERT_EQ(shortest, "-1.25E-03");
+    TEST_ASSERT_EQ(fullPrecision, "1.50000000000000000E00");
+    TEST_ASSERT_EQ(mostDigits, "3.0000000000000004E-01");
+}
+}
+
+int main(int, char**)
+{
+    TEST_CHECK(testShortestForm);
+    TEST_CHECK(testFullPrecision);
+    TEST_CHECK(testDoublesRoundTrip);
+    TEST_CHECK(testShortDecimals);
+    TEST_CHECK(testFloatsRoundTrip);
+    TEST_CHECK(testLocale);
+    return 0;
+}
@@ -0,0 +1,250 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "TestCase.h"
+
+#include <mt/ThreadGroup.h>
+#include <six/Parameter.h>
+
+namespace
+{
+// Exposes whether the value has been formatted as a string
+class InspectableParameter : public six::Parameter
+{
+public:
+    template<typename T>
+    explicit InspectableParameter(T value) :
+        six::Parameter(value)
+    {
+    }
+
+    bool isFormatted() const
+    {
+        return !mValue.empty();
+    }
+};
+
+class GetString : public sys::Runnable
+{
+public:
+    GetString(const six::Parameter& param, std::string& value) :
+        mParam(param),
+        mValue(value)
+    {
+    }
+
+    virtual void run()
+    {
+        mValue = static_cast<const char*>(mParam);
+    }
+
+private:
+    const six::Parameter& mParam;
+    std::string& mValue;
+};
+
+TEST_CASE(testStringFormsUnchanged)
+{
+    // str() has to match what storing str::toString() used to produce
+    const float floatValue = 1.1f;
+    const double doubleValue = 0.1 + 0.2;
+    const int intValue = -42;
+    const sys::Uint64_T uintValue = std::numeric_limits<sys::Uint64_T>::max();
+    const std::complex<float> complexFloat(1.5f, -0.1f);
+    const std::complex<double> complexDouble(1.0 / 3.0, 2.5);
+    const std::complex<int> complexInt(3, -4);
+
+    TEST_ASSERT_EQ(six::Parameter(floatValue).str(),
+                   str::toString(floatValue));
+    TEST_ASSERT_EQ(six::Parameter(doubleValue).str(),
+                   str::toString(doubleValue));
+    TEST_ASSERT_EQ(six::Parameter(intValue).str(), str::toString(intValue));
+    TEST_ASSERT_EQ(six::Parameter(uintValue).str(),
+                   str::toString(uintValue));
+    TEST_ASSERT_EQ(six::Parameter(complexFloat).str(),
+                   str::toString(complexFloat));
+    TEST_ASSERT_EQ(six::Parameter(complexDouble).str(),
+                   str::toString(complexDouble));
+    TEST_ASSERT_EQ(six::Parameter(complexInt).str(),
+                   str::toString(complexInt));
+    TEST_ASSERT_EQ(six::Parameter(true).str(), "true");
+    TEST_ASSERT_EQ(six::Parameter("text").str(), "text");
+    TEST_ASSERT_EQ(six::Parameter(std::string("text")).str(), "text");
+
+    const six::Parameter param(doubleValue);
+    TEST_ASSERT_EQ(std::strcmp(static_cast<const char*>(param),
+                               str::toString(doubleValue).c_str()), 0);
+}
+
+TEST_CASE(testNumericRoundTrip)
+{
+    six::Parameter param;
+    param.setValue(0.1 + 0.2);
+    TEST_ASSERT_EQ(static_cast<double>(param), 0.1 + 0.2);
+
+    param.setValue(1.1f);
+    TEST_ASSERT_EQ(static_cast<float>(param), 1.1f);
+
+    param.setValue(static_cast<sys::Int64_T>(-1234567890123LL));
+    TEST_ASSERT_EQ(static_cast<sys::Int64_T>(param), -1234567890123LL);
+
+    param.setValue(static_cast<size_t>(4096));
+    TEST_ASSERT_EQ(static_cast<size_t>(param), static_cast<size_t>(4096));
+    TEST_ASSERT_EQ(static_cast<int>(param), 4096);
+    TEST_ASSERT_EQ(static_cast<double>(param), 4096.0);
+
+    param.setValue(std::complex<double>(1.25, -2.5));
+    TEST_ASSERT_EQ(param.getComplex<double>(),
+                   std::complex<double>(1.25, -2.5));
+
+    param.setValue(std::complex<int>(7, -8));
+    TEST_ASSERT_EQ(param.getComplex<int>(), std::complex<int>(7, -8));
+    TEST_ASSERT_EQ(param.getComplex<double>(), std::complex<double>(7, -8));
+}
+
+TEST_CASE(testNumbersAreNotFormatted)
+{
+    InspectableParameter doubleParam(0.1 + 0.2);
+    TEST_ASSERT(!doubleParam.isFormatted());
+    TEST_ASSERT_EQ(static_cast<double>(doubleParam), 0.1 + 0.2);
+    TEST_ASSERT(!doubleParam.isFormatted());
+
+    const InspectableParameter intParam(static_cast<size_t>(4096));
+    TEST_ASSERT_EQ(static_cast<int>(intParam), 4096);
+    TEST_ASSERT_EQ(static_cast<double>(intParam), 4096.0);
+    TEST_ASSERT(!intParam.isFormatted());
+
+    const InspectableParameter complexParam(std::complex<double>(1.5, -2.0));
+    TEST_ASSERT_EQ(complexParam.getComplex<double>(),
+                   std::complex<double>(1.5, -2.0));
+    TEST_ASSERT(!complexParam.isFormatted());
+
+    // Copies don't format either
+    const InspectableParameter copy(doubleParam);
+    TEST_ASSERT_EQ(static_cast<double>(copy), 0.1 + 0.2);
+    TEST_ASSERT(!copy.isFormatted());
+    TEST_ASSERT(!doubleParam.isFormatted());
+
+    // The string is made when asked for, and kept
+    TEST_ASSERT_EQ(doubleParam.str(), str::toString(0.1 + 0.2));
+    TEST_ASSERT(doubleParam.isFormatted());
+    const char* const formatted = doubleParam;
+    TEST_ASSERT_EQ(static_cast<const char*>(doubleParam), formatted);
+
+    // And dropped when the value changes
+    doubleParam.setValue(2.5);
+    TEST_ASSERT(!doubleParam.isFormatted());
+    TEST_ASSERT_EQ(doubleParam.str(), str::toString(2.5));
+}
+
+TEST_CASE(testConcurrentFormatting)
+{
+    const std::complex<double> value(1.0 / 3.0, -2.0 / 3.0);
+    const std::string expected = str::toString(value);
+    for (size_t trial = 0; trial < 20; ++trial)
+    {
+        const six::Parameter param(value);
+        const size_t numThreads = 8;
+        std::vector<std::string> strings(numThreads);
+        mt::ThreadGroup threads;
+        for (size_t ii = 0; ii < numThreads; ++ii)
+        {
+            threads.createThread(new GetString(param, strings[ii]));
+        }
+        threads.joinAll();
+
+        for (size_t ii = 0; ii < numThreads; ++ii)
+        {
+            TEST_ASSERT_EQ(strings[ii], expected);
+        }
+    }
+}
+
+TEST_CASE(testConversionsMatchStrings)
+{
+    // Conversions the native value can't represent directly must behave
+    // as they did when everything went through the string
+    const six::Parameter fromDouble(2.75);
+    TEST_ASSERT_EQ(static_cast<int>(fromDouble),
+                   str::toType<int>(str::toString(2.75)));
+
+    const six::Parameter tooBig(
+            static_cast<sys::Uint64_T>(std::numeric_limits<int>::max()) + 1);
+    TEST_EXCEPTION(static_cast<int>(tooBig));
+
+    const six::Parameter complexDouble(std::complex<double>(1.5, 2.0));
+    TEST_EXCEPTION(complexDouble.getComplex<int>());
+
+    // Widening a float gives a different double than parsing its string
+    const six::Parameter fromFloat(1.1f);
+    TEST_ASSERT_EQ(static_cast<double>(fromFloat),
+                   str::toType<double>(str::toString(1.1f)));
+    TEST_ASSERT_EQ(static_cast<float>(six::Parameter(0.1 + 0.2)),
+                   str::toType<float>(str::toString(0.1 + 0.2)));
+
+    const six::Parameter complexFloat(std::complex<float>(1.1f, -0.3f));
+    TEST_ASSERT_EQ(complexFloat.getComplex<double>(),
+                   str::toType<std::complex<double> >(
+                           str::toString(std::complex<float>(1.1f, -0.3f))));
+
+    const six::Parameter fromString("12.5");
+    TEST_ASSERT_EQ(static_cast<double>(fromString), 12.5);
+    TEST_ASSERT_EQ(fromString.str(), "12.5");
+
+    const six::Parameter realString("3");
+    TEST_ASSERT_EQ(realString.getComplex<double>(),
+                   std::complex<double>(3.0, 0.0));
+}
+
+TEST_CASE(testEquality)
+{
+    six::Parameter lhs(25.0);
+    six::Parameter rhs(25.0);
+    TEST_ASSERT(lhs == rhs);
+
+    // Same string form, different storage
+    rhs = std::string("25");
+    TEST_ASSERT(lhs == rhs);
+
+    rhs = 25.5;
+    TEST_ASSERT(lhs != rhs);
+
+    rhs = 25.0;
+    rhs.setName("name");
+    TEST_ASSERT(lhs != rhs);
+}
+}
+
+int main(int , char** )
+{
+    TEST_CHECK(testStringFormsUnchanged);
+    TEST_CHECK(testNumericRoundTrip);
+    TEST_CHECK(testNumbersAreNotFormatted);
+    TEST_CHECK(testConcurrentFormatting);
+    TEST_CHECK(testConversionsMatchStrings);
+    TEST_CHECK(testEquality);
+    return 0;
+}
@@ -23,6 +23,10 @@
 #include <stdlib.h>
 #include <time.h>
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 #include "TestCase.h"
 #include <six/Serialize.h>
 
@@ -82,6 +86,44 @@ bool testVector(size_t length, bool byteSwap)
     return val == valCopy;
 }
 
+// Serializes the values one at a time, as the vector serializer used to
+template<typename T>
+std::vector<sys::byte> serializeEachValue(const std::vector<T>& val,
+                                          bool byteSwap)
+{
+    std::vector<sys::byte> serializedData;
+    six::serialize<size_t>(val.size(), byteSwap, serializedData);
+    for (size_t ii = 0; ii < val.size(); ++ii)
+    {
+        six::serialize<T>(val[ii], byteSwap, serializedData);
+    }
+    return serializedData;
+}
+
+template<typename T>
+bool testBulkMatches(size_t length, bool byteSwap)
+{
+    const std::vector<T> val = getRandomVector<T>(length);
+    std::vector<sys::byte> serializedData;
+    six::serialize<std::vector<T> >(val, byteSwap, serializedData);
+    return serializedData == serializeEachValue(val, byteSwap);
+}
+
+template<typename T>
+bool testView(size_t length, bool byteSwap, size_t offset, bool inPlace)
+{
+    const std::vector<T> val = getRandomVector<T>(length);
+    std::vector<sys::byte> serializedData(offset);
+    six::serialize<std::vector<T> >(val, byteSwap, serializedData);
+
+    const sys::byte* buffer = &serializedData[offset];
+    six::VectorView<T> view;
+    six::deserialize<six::VectorView<T> >(buffer, byteSwap, view);
+    return buffer == &serializedData[0] + serializedData.size() &&
+            view.isInPlace() == inPlace &&
+            view.toVector() == val;
+}
+
 bool testString(const std::string& str, bool byteSwap)
 {
     std::vector<sys::byte> serializedData;
@@ -139,10 +181,88 @@ TEST_CASE(VectorSerialize)
     TEST_ASSERT_TRUE(testVector<double>(length, true));
 }
 
+TEST_CASE(BulkVectorSerialize)
+{
+    const size_t length = 213;
+
+    // Scalars are serialized in one block, but the bytes are the same
+    TEST_ASSERT_TRUE(testBulkMatches<int>(length, false));
+    TEST_ASSERT_TRUE(testBulkMatches<int>(length, true));
+    TEST_ASSERT_TRUE(testBulkMatches<float>(length, true));
+    TEST_ASSERT_TRUE(testBulkMatches<double>(length, false));
+    TEST_ASSERT_TRUE(testBulkMatches<double>(length, true));
+    TEST_ASSERT_TRUE(testBulkMatches<sys::byte>(length, false));
+    TEST_ASSERT_TRUE(testBulkMatches<sys::byte>(length, true));
+
+    TEST_ASSERT_TRUE(testVector<double>(0, false));
+    TEST_ASSERT_TRUE(testVector<double>(0, true));
+
+    // Deserializing appends to what's already in the vector
+    const std::vector<double> first = getRandomVector<double>(length);
+    const std::vector<double> second = getRandomVector<double>(7);
+    std::vector<sys::byte> serializedData;
+    six::serialize<std::vector<double> >(first, true, serializedData);
+    six::serialize<std::vector<double> >(second, true, serializedData);
+    const sys::byte* buffer = &serializedData[0];
+    std::vector<double> valCopy;
+    six::deserialize<std::vector<double> >(buffer, true, valCopy);
+    six::deserialize<std::vector<double> >(buffer, true, valCopy);
+    TEST_ASSERT_EQ(valCopy.size(), first.size() + second.size());
+    TEST_ASSERT_TRUE(std::equal(first.begin(), first.end(), valCopy.begin()));
+    TEST_ASSERT_TRUE(std::equal(second.begin(), second.end(),
+                                valCopy.begin() + first.size()));
+
+    // Vectors of non-scalars are still serialized one value at a time
+    std::vector<std::string> strings;
+    strings.push_back("FIRST");
+    strings.push_back("");
+    strings.push_back("THIRD");
+    serializedData.clear();
+    six::serialize<std::vector<std::string> >(strings, true, serializedData);
+    buffer = &serializedData[0];
+    std::vector<std::string> stringsCopy;
+    six::deserialize<std::vector<std::string> >(buffer, true, stringsCopy);
+    TEST_ASSERT_TRUE(strings == stringsCopy);
+
+    // vector<bool> has no contiguous storage to copy from
+    std::vector<bool> bools;
+    for (size_t ii = 0; ii < 11; ++ii)
+    {
+        bools.push_back(ii % 3 == 0);
+    }
+    serializedData.clear();
+    six::serialize<std::vector<bool> >(bools, true, serializedData);
+    TEST_ASSERT_EQ(serializedData.size(), sizeof(size_t) + sizeof(bool) * bools.size());
+    buffer = &serializedData[0];
+    std::vector<bool> boolsCopy;
+    six::deserialize<std::vector<bool> >(buffer, true, boolsCopy);
+    TEST_ASSERT_TRUE(bools == boolsCopy);
+}
+
+TEST_CASE(VectorViewSerialize)
+{
+    const size_t length = 213;
+
+    // Points into the buffer when the values can be used as-is
+    TEST_ASSERT_TRUE(testView<double>(length, false, 0, true));
+    TEST_ASSERT_TRUE(testView<float>(length, false, 0, true));
+    TEST_ASSERT_TRUE(testView<sys::byte>(length, false, 3, true));
+
+    // Copies when the values need swapping or aren't aligned
+    TEST_ASSERT_TRUE(testView<double>(length, true, 0, false));
+    TEST_ASSERT_TRUE(testView<double>(length, false, 1, false));
+    TEST_ASSERT_TRUE(testView<int>(length, true, 3, false));
+
+    TEST_ASSERT_TRUE(testView<double>(0, false, 0, false));
+    TEST_ASSERT_TRUE(testView<double>(0, true, 0, false));
+}
+
 int main(int, char**)
 {
     srand(time(NULL));
     TEST_CHECK(ScalarSerialize);
     TEST_CHECK(VectorSerialize);
     TEST_CHECK(StringSerialize);
+    TEST_CHECK(BulkVectorSerialize);
+    TEST_CHECK(VectorViewSerialize);
 }
@@ -23,8 +23,99 @@
 #include <six/XMLControl.h>
 #include <string>
 #include <vector>
+#include <io/FileOutputStream.h>
+#include <io/StringStream.h>
+#include <io/TempFile.h>
+#include <logging/NullLogger.h>
+#include <mt/ThreadGroup.h>
+#include <sys/Path.h>
+#include <xml/lite/MinidomParser.h>
 #include "TestCase.h"
 
+namespace
+{
+// A directory holding one schema for a document with a single double
+class SchemaDirectory
+{
+public:
+    explicit SchemaDirectory(const std::string& uri)
+    {
+        // Use the temp file's name for a directory instead
+        const sys::OS os;
+        os.remove(mDirectory.pathname());
+        os.makeDirectory(mDirectory.pathname());
+        io::FileOutputStream schema(
+                sys::Path(mDirectory.pathname()).join("test.xsd"));
+        schema.write(
+                "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                "<xs:schema xmlns:xs=\"http://www.w3.org/2001/XMLSchema\"\n"
+                "           targetNamespace=\"" + uri + "\"\n"
+                "           elementFormDefault=\"qualified\">\n"
+                "  <xs:element name=\"Test\" type=\"xs:double\"/>\n"
+                "</xs:schema>\n");
+        schema.close();
+    }
+
+    std::string pathname() const
+    {
+        return mDirectory.pathname();
+    }
+
+private:
+    const io::TempFile mDirectory;
+};
+
+std::string makeXML(const std::string& uri, const std::string& value)
+{
+    return "<Test xmlns=\"" + uri + "\">" + value + "</Test>";
+}
+
+void validateDocument(const std::string& xml,
+                      const std::vector<std::string>& schemaPaths)
+{
+    io::StringStream stream;
+    stream.write(xml);
+    xml::lite::MinidomParser parser;
+    parser.parse(stream);
+    logging::NullLogger log;
+    six::XMLControl::validate(parser.getDocument(), schemaPaths, &log);
+}
+
+class ValidateDocuments : public sys::Runnable
+{
+public:
+    ValidateDocuments(const std::string& xml,
+                      const std::vector<std::string>& schemaPaths,
+                      bool& success) :
+        mXML(xml),
+        mSchemaPaths(schemaPaths),
+        mSuccess(success)
+    {
+    }
+
+    virtual void run()
+    {
+        mSuccess = true;
+        try
+        {
+            for (size_t ii = 0; ii < 20; ++ii)
+            {
+                validateDocument(mXML, mSchemaPaths);
+            }
+        }
+        catch (...)
+        {
+            mSuccess = false;
+        }
+    }
+
+private:
+    const std::string mXML;
+    const std::vector<std::string> mSchemaPaths;
+    bool& mSuccess;
+};
+}
+
 TEST_CASE(loadCompiledSchemaPath)
 {
     sys::OS().unsetEnv("SIX_SCHEMA_PATH");
@@ -60,11 +151,97 @@ TEST_CASE(ignoreEmptyEnvVariable)
     TEST_ASSERT_EQ(schemaPaths[0], DEFAULT_SCHEMA_PATH);
 }
 
+TEST_CASE(validatorCacheHits)
+{
+    six::XMLControl::clearValidatorCache();
+    const std::string uri = "urn:TEST:1.0";
+    const SchemaDirectory schemas(uri);
+    const std::vector<std::string> schemaPaths(1, schemas.pathname());
+    TEST_ASSERT_EQ(six::XMLControl::getNumCachedValidators(schemaPaths), 0);
+
+    validateDocument(makeXML(uri, "1.5"), schemaPaths);
+    TEST_ASSERT_EQ(six::XMLControl::getNumCachedValidators(schemaPaths), 1);
+
+    // Same paths and URI, through the DOM and the serialized overloads
+    validateDocument(makeXML(uri, "2.5"), schemaPaths);
+    logging::NullLogger log;
+    six::XMLControl::validate(makeXML(uri, "3.5"), uri, schemaPaths, &log);
+    TEST_ASSERT_EQ(six::XMLControl::getNumCachedValidators(schemaPaths), 1);
+
+    // Invalid documents are still caught
+    TEST_EXCEPTION(validateDocument(makeXML(uri, "abc"), schemaPaths));
+    TEST_ASSERT_EQ(six::XMLControl::getNumCachedValidators(schemaPaths), 1);
+}
+
+TEST_CASE(validatorCachePathSets)
+{
+    six::XMLControl::clearValidatorCache();
+    const std::string uri = "urn:TEST:1.0";
+    const std::string otherURI = "urn:OTHER:1.0";
+    const SchemaDirectory schemas(uri);
+    const SchemaDirectory otherSchemas(otherURI);
+    const std::vector<std::string> schemaPaths(1, schemas.pathname());
+    std::vector<std::string> bothPaths(schemaPaths);
+    bothPaths.push_back(otherSchemas.pathname());
+
+    validateDocument(makeXML(uri, "1.5"), schemaPaths);
+    validateDocument(makeXML(uri, "1.5"), bothPaths);
+    TEST_ASSERT_EQ(six::XMLControl::getNumCachedValidators(schemaPaths), 1);
+    TEST_ASSERT_EQ(six::XMLControl::getNumCachedValidators(bothPaths), 1);
+
+    // The order of the paths doesn't matter, and neither does the URI since
+    // every schema under the paths is compiled
+    const std::vector<std::string> reversedPaths(bothPaths.rbegin(),
+                                                 bothPaths.rend());
+    validateDocument(makeXML(otherURI, "2.5"), reversedPaths);
+    TEST_ASSERT_EQ(six::XMLControl::getNumCachedValidators(reversedPaths), 1);
+    TEST_ASSERT_EQ(six::XMLControl::getNumCachedValidators(schemaPaths), 1);
+
+    six::XMLControl::clearValidatorCache();
+    TEST_ASSERT_EQ(six::XMLControl::getNumCachedValidators(schemaPaths), 0);
+    TEST_ASSERT_EQ(six::XMLControl::getNumCachedValidators(bothPaths), 0);
+
+    validateDocument(makeXML(uri, "1.5"), schemaPaths);
+    TEST_ASSERT_EQ(six::XMLControl::getNumCachedValidators(schemaPaths), 1);
+}
+
+TEST_CASE(concurrentValidation)
+{
+    six::XMLControl::clearValidatorCache();
+    const std::string uri = "urn:TEST:1.0";
+    const SchemaDirectory schemas(uri);
+    const std::vector<std::string> schemaPaths(1, schemas.pathname());
+
+    const size_t numThreads = 8;
+    bool success[numThreads];
+    mt::ThreadGroup threads;
+    for (size_t ii = 0; ii < numThreads; ++ii)
+    {
+        threads.createThread(new ValidateDocuments(
+                makeXML(uri, str::toString(ii)), schemaPaths, success[ii]));
+    }
+    threads.joinAll();
+
+    for (size_t ii = 0; ii < numThreads; ++ii)
+    {
+        TEST_ASSERT(success[ii]);
+    }
+
+    // At most one validator per thread was compiled
+    const size_t numValidators =
+            six::XMLControl::getNumCachedValidators(schemaPaths);
+    TEST_ASSERT_GREATER_EQ(numValidators, 1);
+    TEST_ASSERT_LESSER_EQ(numValidators, numThreads);
+}
+
 int main(int, char**)
 {
     TEST_CHECK(loadCompiledSchemaPath);
     TEST_CHECK(respectGivenPaths);
     TEST_CHECK(loadFromEnvVariable);
     TEST_CHECK(ignoreEmptyEnvVariable);
+    TEST_CHECK(validatorCacheHits);
+    TEST_CHECK(validatorCachePathSets);
+    TEST_CHECK(concurrentValidation);
     return 0;
 }
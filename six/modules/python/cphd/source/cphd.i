@@ -27,6 +27,7 @@
 
 %include <std_string.i>
 %include <std_vector.i>
+%include "release_gil.i"
 
 %import "sys.i"
 %import "types.i"
@@ -43,9 +44,69 @@
 #include "import/six.h"
 #include "import/six/sicd.h"
 #include "import/sys.h"
+#include <str/Convert.h>
 #include <numpyutils/numpyutils.h>
 
 using six::Vector3;
+
+/*
+ * Appends (name, byte offset, NumPy type) for a parameter in the buffer
+ * PVPBlock::getPVPdata() fills, if the parameter is present
+ */
+void appendPVPField(PyObject* fields,
+                    const std::string& name,
+                    const cphd::PVPType& param,
+                    const std::string& type)
+{
+    if (six::Init::isUndefined<size_t>(param.getOffset()))
+    {
+        return;
+    }
+
+    PyObject* const field = Py_BuildValue(
+            "(sns)",
+            name.c_str(),
+            static_cast<Py_ssize_t>(param.getByteOffset()),
+            type.c_str());
+    if (field == NULL)
+    {
+        throw except::Exception(Ctxt("Unable to create PVP field"));
+    }
+    PyList_Append(fields, field);
+    Py_DECREF(field);
+}
+
+/*
+ * NumPy type of an added parameter in the buffer PVPBlock::getPVPdata()
+ * fills.  This follows how PVPBlock::PVPSet::read() writes them, which
+ * depends on the kind of format but not its size.
+ */
+std::string getAddedPVPType(const cphd::APVPType& param)
+{
+    const std::string format = param.getFormat();
+    if (format == "F4" || format == "F8")
+    {
+        return "f8";
+    }
+    if (format == "U1" || format == "U2" || format == "U4" || format == "U8")
+    {
+        return "u4";
+    }
+    if (format == "I1" || format == "I2" || format == "I4" || format == "I8")
+    {
+        return "i4";
+    }
+    if (format == "CI2" || format == "CI4" ||
+        format == "CI8" || format == "CI16")
+    {
+        return "2i4";
+    }
+    if (format == "CF8" || format == "CF16")
+    {
+        return "c16";
+    }
+    return "S" + str::toString(param.getByteSize());
+}
 %}
 
 %ignore cphd::CPHDXMLControl::toXML(const Metadata& metadata);
@@ -139,10 +200,61 @@ using six::Vector3;
     void getPVPdata(size_t channel, size_t data)
     {
         void* buffer = reinterpret_cast<void*>(data);
+        ReleaseGIL releaseGIL;
         $self->getPVPdata(channel, buffer);
     }
 }
 
+%extend cphd::Pvp
+{
+    // (name, byte offset, NumPy type) of each parameter in the buffer
+    // PVPBlock::getPVPdata() fills
+    PyObject* getPVPdataFields() const
+    {
+        PyObject* const fields = PyList_New(0);
+        try
+        {
+            appendPVPField(fields, "txTime", $self->txTime, "f8");
+            appendPVPField(fields, "txPos", $self->txPos, "3f8");
+            appendPVPField(fields, "txVel", $self->txVel, "3f8");
+            appendPVPField(fields, "rcvTime", $self->rcvTime, "f8");
+            appendPVPField(fields, "rcvPos", $self->rcvPos, "3f8");
+            appendPVPField(fields, "rcvVel", $self->rcvVel, "3f8");
+            appendPVPField(fields, "srpPos", $self->srpPos, "3f8");
+            appendPVPField(fields, "ampSF", $self->ampSF, "f8");
+            appendPVPField(fields, "aFDOP", $self->aFDOP, "f8");
+            appendPVPField(fields, "aFRR1", $self->aFRR1, "f8");
+            appendPVPField(fields, "aFRR2", $self->aFRR2, "f8");
+            appendPVPField(fields, "fx1", $self->fx1, "f8");
+            appendPVPField(fields, "fx2", $self->fx2, "f8");
+            appendPVPField(fields, "fxN1", $self->fxN1, "f8");
+            appendPVPField(fields, "fxN2", $self->fxN2, "f8");
+            appendPVPField(fields, "toa1", $self->toa1, "f8");
+            appendPVPField(fields, "toa2", $self->toa2, "f8");
+            appendPVPField(fields, "toaE1", $self->toaE1, "f8");
+            appendPVPField(fields, "toaE2", $self->toaE2, "f8");
+            appendPVPField(fields, "tdTropoSRP", $self->tdTropoSRP, "f8");
+            appendPVPField(fields, "tdIonoSRP", $self->tdIonoSRP, "f8");
+            appendPVPField(fields, "sc0", $self->sc0, "f8");
+            appendPVPField(fields, "scss", $self->scss, "f8");
+            appendPVPField(fields, "signal", $self->signal, "f8");
+            for (auto it = $self->addedPVP.begin();
+                 it != $self->addedPVP.end();
+                 ++it)
+            {
+                appendPVPField(fields, it->first, it->second,
+                               getAddedPVPType(it->second));
+            }
+        }
+        catch (...)
+        {
+            Py_DECREF(fields);
+            throw;
+        }
+        return fields;
+    }
+}
+
 %extend cphd::Wideband
 {
     // We need to expose a way to read into a raw buffer
@@ -155,6 +267,7 @@ using six::Vector3;
                   const types::RowCol<size_t>& dims,
                   long long data)
     {
+        ReleaseGIL releaseGIL;
         $self->read(channel,
                     firstVector,
                     lastVector,
@@ -166,31 +279,6 @@ using six::Vector3;
     }
 }
 
-%extend cphd::CPHDReader
-{
-    PyObject* getPHD(size_t channel)
-    {
-        const auto& wb = self->getWideband();
-        const types::RowCol<size_t> dims =
-            wb.getBufferDims(channel,
-                             0,
-                             cphd::Wideband::ALL,
-                             0,
-                             cphd::Wideband::ALL);
-        std::vector<std::complex<float>> buffer(dims.area());
-        wb.read(channel,
-                0,
-                cphd::Wideband::ALL,
-                0,
-                cphd::Wideband::ALL,
-                1,
-                dims,
-                buffer.data());
-        return numpyutils::toNumpyArray(
-            dims.row, dims.col, NPY_COMPLEX64, buffer.data());
-    }
-}
-
 %extend cphd::CPHDWriter
 {
 %pythoncode
@@ -212,7 +300,11 @@ def read(self,
          lastVector = Wideband.ALL,
          firstSample = 0,
          lastSample = Wideband.ALL,
-         numThreads = multiprocessing.cpu_count()):
+         numThreads = multiprocessing.cpu_count(),
+         out = None):
+    """Read signal data into 'out', or a new array if it's None.  'out'
+    must be a writeable, C-contiguous array of the region's shape.
+    Returns the array read into."""
 
     dims = self.getBufferDims(channel, firstVector, lastVector, firstSample, lastSample)
     sampleTypeSize = self.getElementSize()
@@ -223,12 +315,46 @@ def read(self,
     else:
         raise Exception('Unknown element type')
 
-    numpyArray = numpy.empty(shape = (dims.row, dims.col), dtype = dtype)
-    pointer, ro = numpyArray.__array_interface__['data']
+    if out is None:
+        out = numpy.empty(shape = (dims.row, dims.col), dtype = dtype)
+    elif (out.dtype != numpy.dtype(dtype) or
+            out.shape != (dims.row, dims.col) or
+            not out.flags['C_CONTIGUOUS'] or
+            not out.flags['WRITEABLE']):
+        raise ValueError('Output must be a writeable, C-contiguous '
+                         '{0} array of shape ({1}, {2})'.format(
+                             dtype, dims.row, dims.col))
+
+    pointer, ro = out.__array_interface__['data']
     self.readImpl(channel, firstVector, lastVector, firstSample, lastSample, numThreads, dims, pointer)
-    return numpyArray
+    return out
 
 Wideband.read = read
+
+def getPHD(self, channel = 0, numThreads = multiprocessing.cpu_count()):
+    """Read a whole channel of signal data"""
+    return self.getWideband().read(channel, numThreads = numThreads)
+
+def getPVPArrays(self, channel = 0):
+    """Get a channel's per vector parameters as a dict from parameter name
+    (e.g. 'txPos') to an array with an entry per vector"""
+    pvpBlock = self.getPVPBlock()
+    fields = self.getMetadata().pvp.getPVPdataFields()
+    dtype = numpy.dtype({'names': [field[0] for field in fields],
+                         'offsets': [field[1] for field in fields],
+                         'formats': [field[2] for field in fields],
+                         'itemsize': pvpBlock.getNumBytesPVPSet()})
+
+    # Read every parameter at once, then copy each out of the block
+    block = numpy.empty(pvpBlock.getPVPsize(channel), dtype = 'uint8')
+    pointer, ro = block.__array_interface__['data']
+    pvpBlock.getPVPdata(channel, pointer)
+    vectors = block.view(dtype)
+    return dict((name, numpy.ascontiguousarray(vectors[name]))
+                for name in dtype.names)
+
+CPHDReader.getPHD = getPHD
+CPHDReader.getPVPArrays = getPVPArrays
 %}
 
 %extend cphd::CPHDXMLControl {
@@ -0,0 +1,84 @@
+#!/usr/bin/env python
+
+#
+# =========================================================================
+# This file is part of cphd-python
+# =========================================================================
+#
+# (C) Copyright 2004 - 2020, MDA Information Systems LLC
+#
+# cphd-python is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program; If not,
+# see <http://www.gnu.org/licenses/>.
+#
+
+# Compares the NumPy readers against reading a vector at a time
+
+import sys
+
+import numpy
+
+from pysix.cphd import CPHDReader, Wideband
+
+
+def testChannel(reader, channel):
+    wideband = reader.getWideband()
+    pvpBlock = reader.getPVPBlock()
+    numVectors = reader.getMetadata().data.getNumVectors(channel)
+
+    # Signal data, whole and one vector at a time into our own array
+    phd = reader.getPHD(channel)
+    assert phd.shape[0] == numVectors
+    out = numpy.zeros_like(phd)
+    assert wideband.read(channel, 0, Wideband.ALL, 0, Wideband.ALL,
+                         2, out) is out
+    assert (out == phd).all()
+    for vector in range(numVectors):
+        row = wideband.read(channel, vector, vector, 0, Wideband.ALL, 1)
+        assert (row[0] == phd[vector]).all()
+
+    # A parameter from each array matches its getter
+    pvps = reader.getPVPArrays(channel)
+    getters = {'txTime': pvpBlock.getTxTime,
+               'txPos': pvpBlock.getTxPos,
+               'rcvTime': pvpBlock.getRcvTime,
+               'srpPos': pvpBlock.getSRPPos,
+               'toa1': pvpBlock.getTOA1,
+               'sc0': pvpBlock.getSC0}
+    for name, getter in getters.items():
+        values = pvps[name]
+        assert values.shape[0] == numVectors
+        assert values.flags['C_CONTIGUOUS']
+        for vector in range(numVectors):
+            expected = getter(channel, vector)
+            if values.ndim == 1:
+                assert values[vector] == expected
+            else:
+                assert all(values[vector][ii] == expected[ii]
+                           for ii in range(3))
+
+
+if __name__ == '__main__':
+    if len(sys.argv) != 2:
+        print('Usage: {0} <CPHD pathname>'.format(sys.argv[0]))
+        sys.exit(1)
+
+    reader = CPHDReader(sys.argv[1], 1)
+    try:
+        for channel in range(reader.getMetadata().data.getNumChannels()):
+            testChannel(reader, channel)
+    except AssertionError:
+        print('NumPy reads differ from per-vector reads. Test failed')
+        sys.exit(1)
+    print('Test passed')
+    sys.exit(0)
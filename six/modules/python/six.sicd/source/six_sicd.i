@@ -25,12 +25,16 @@
 %feature("autodoc", "1");
 
 %include <std_string.i>
+%include "release_gil.i"
 
 %{
 
 #include <complex>
 #include <utility>
 
+#include <mt/CriticalSection.h>
+#include <sys/Mutex.h>
+
 
 #include "import/mem.h"
 #include "import/six.h"
@@ -127,6 +131,83 @@ Data* readNITF(const std::string& pathname,
     return reinterpret_cast<Data*>(reader.interleaved(region, 0));
 }
 
+/*
+ * Keeps a SICD open so any number of regions can be read from it without
+ * reopening the NITF and reparsing its XML.  The GIL is released while
+ * reading.  Reads through one reader take turns since they share a file
+ * handle, so use a reader per thread to read in parallel.
+ */
+class SICDReader
+{
+public:
+    SICDReader(const std::string& pathname,
+               const std::vector<std::string>& schemaPaths)
+    {
+        mXMLRegistry.addCreator(six::DataType::COMPLEX,
+                                new six::XMLControlCreatorT<
+                                        six::sicd::ComplexXMLControl>());
+        mReader.setLogger(&mLog);
+        mReader.setXMLControlRegistry(&mXMLRegistry);
+        {
+            ReleaseGIL releaseGIL;
+            mReader.load(pathname, schemaPaths);
+        }
+        mComplexData = Utilities::getComplexData(mReader);
+    }
+
+    std::auto_ptr<six::sicd::ComplexData> getComplexData() const
+    {
+        return std::auto_ptr<six::sicd::ComplexData>(
+                static_cast<six::sicd::ComplexData*>(mComplexData->clone()));
+    }
+
+    long long getNumRows() const
+    {
+        return mComplexData->getNumRows();
+    }
+
+    long long getNumCols() const
+    {
+        return mComplexData->getNumCols();
+    }
+
+    void readRegionImpl(long long startRow, long long numRows,
+                        long long startCol, long long numCols,
+                        long long arrayBuffer)
+    {
+        if (startRow < 0 || numRows <= 0 ||
+            startRow + numRows > getNumRows() ||
+            startCol < 0 || numCols <= 0 ||
+            startCol + numCols > getNumCols())
+        {
+            throw except::Exception(Ctxt(
+                    "Region must be a non-empty part of the image"));
+        }
+
+        const types::RowCol<size_t> offset(startRow, startCol);
+        const types::RowCol<size_t> extent(numRows, numCols);
+        std::complex<float>* const buffer =
+                reinterpret_cast<std::complex<float>*>(arrayBuffer);
+
+        // Wait for the lock without the GIL so we can't deadlock with a
+        // thread that has the lock and wants the GIL back
+        ReleaseGIL releaseGIL;
+        mt::CriticalSection<sys::Mutex> lock(&mMutex);
+        Utilities::getWidebandData(mReader, *mComplexData, offset, extent,
+                                   buffer);
+    }
+
+private:
+    SICDReader(const SICDReader&);
+    SICDReader& operator=(const SICDReader&);
+
+    logging::NullLogger mLog;
+    six::XMLControlRegistry mXMLRegistry;
+    six::NITFReadControl mReader;
+    std::auto_ptr<six::sicd::ComplexData> mComplexData;
+    sys::Mutex mMutex;
+};
+
 %}
 
 %ignore six::sicd::cropSICD;
@@ -378,6 +459,49 @@ SCOPED_COPYABLE(six::sicd, InterPulsePeriod)
 void getWidebandData(std::string sicdPathname, const std::vector<std::string>& schemaPaths, six::sicd::ComplexData* complexData, long long arrayBuffer);
 void getWidebandRegion(std::string sicdPathname, const std::vector<std::string>& schemaPaths, six::sicd::ComplexData* complexData, long long startRow, long long numRows, long long startCol, long long numCols, long long arrayBuffer);
 
+class SICDReader
+{
+public:
+    SICDReader(const std::string& pathname,
+               const std::vector<std::string>& schemaPaths);
+
+    std::auto_ptr<six::sicd::ComplexData> getComplexData() const;
+    long long getNumRows() const;
+    long long getNumCols() const;
+    void readRegionImpl(long long startRow, long long numRows,
+                        long long startCol, long long numCols,
+                        long long arrayBuffer);
+};
+
+%extend SICDReader
+{
+%pythoncode
+%{
+    def readRegion(self, startRow, numRows, startCol, numCols, out = None):
+        """Read a region into 'out', or a new array if it's None.  'out'
+        must be a writeable, C-contiguous complex64 array of the region's
+        shape.  Returns the array read into."""
+        if out is None:
+            out = np.empty(shape = (numRows, numCols), dtype = "complex64")
+        elif (out.dtype != np.complex64 or
+                out.shape != (numRows, numCols) or
+                not out.flags["C_CONTIGUOUS"] or
+                not out.flags["WRITEABLE"]):
+            raise ValueError("Output must be a writeable, C-contiguous "
+                             "complex64 array of shape ({0}, {1})".format(
+                                 numRows, numCols))
+
+        buffer, ro = out.__array_interface__["data"]
+        self.readRegionImpl(startRow, numRows, startCol, numCols, buffer)
+        return out
+
+    def read(self, out = None):
+        """Read the whole image into 'out', or a new array if it's None"""
+        return self.readRegion(0, self.getNumRows(), 0, self.getNumCols(),
+                               out)
+%}
+}
+
 %pythoncode %{
 import numpy as np
 from coda.coda_types import VectorString
@@ -385,25 +509,14 @@ from coda.coda_io import FileOutputStream
 from coda.xml_lite import *
 
 def read(inputPathname, schemaPaths = VectorString()):
-    complexData = SixSicdUtilities.getComplexData(inputPathname, schemaPaths)
-
     #Numpy has no concept of complex integers, so dtype will always be complex64
-    widebandData = np.empty(shape = (complexData.getNumRows(), complexData.getNumCols()), dtype = "complex64")
-    widebandBuffer, ro = widebandData.__array_interface__["data"]
-
-    getWidebandData(inputPathname, schemaPaths, complexData, widebandBuffer)
-
-    return widebandData, complexData
+    reader = SICDReader(inputPathname, schemaPaths)
+    return reader.read(), reader.getComplexData()
 
 def readRegion(inputPathname, startRow, numRows, startCol, numCols, schemaPaths = VectorString()):
-    complexData = SixSicdUtilities.getComplexData(inputPathname, schemaPaths)
-
-    widebandData = np.empty(shape = (numRows, numCols), dtype = "complex64")
-    widebandBuffer, ro = widebandData.__array_interface__["data"]
-
-    getWidebandRegion(inputPathname, schemaPaths, complexData, startRow, numRows, startCol, numCols, widebandBuffer)
-
-    return widebandData, complexData
+    reader = SICDReader(inputPathname, schemaPaths)
+    return (reader.readRegion(startRow, numRows, startCol, numCols),
+            reader.getComplexData())
 
 def readRecord(pathname):
     record = _readRecord(pathname)
@@ -0,0 +1,106 @@
+#!/usr/bin/env python
+
+#
+# =========================================================================
+# This file is part of six.sicd-python
+# =========================================================================
+#
+# (C) Copyright 2004 - 2019, MDA Information Systems LLC
+#
+# six.sicd-python is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program; If not,
+# see <http://www.gnu.org/licenses/>.
+#
+
+import sys
+import threading
+
+import numpy as np
+
+from pysix.six_sicd import SICDReader, read
+from coda.coda_types import VectorString
+
+
+def tiles(numRows, numCols, tileSize):
+    for startRow in range(0, numRows, tileSize):
+        for startCol in range(0, numCols, tileSize):
+            yield (startRow, min(tileSize, numRows - startRow),
+                   startCol, min(tileSize, numCols - startCol))
+
+
+def readTiles(reader, expected, tileSize, failures):
+    numRows, numCols = expected.shape
+    for startRow, rows, startCol, cols in tiles(numRows, numCols, tileSize):
+        tile = reader.readRegion(startRow, rows, startCol, cols)
+        if not (tile == expected[startRow:startRow + rows,
+                                 startCol:startCol + cols]).all():
+            failures.append((startRow, startCol))
+
+
+def testReader(pathname):
+    expectedArray, expectedData = read(pathname)
+    numRows, numCols = expectedArray.shape
+
+    reader = SICDReader(pathname, VectorString())
+    assert reader.getComplexData() == expectedData
+    assert reader.getNumRows() == numRows
+    assert reader.getNumCols() == numCols
+
+    # Read everything into an array we provide
+    out = np.zeros(shape = (numRows, numCols), dtype = 'complex64')
+    assert reader.read(out) is out
+    assert (out == expectedArray).all()
+
+    # Tiles from one reader, and from several threads sharing it
+    failures = []
+    tileSize = max(1, min(numRows, numCols) // 3)
+    readTiles(reader, expectedArray, tileSize, failures)
+    threads = [threading.Thread(target = readTiles,
+                                args = (reader, expectedArray,
+                                        tileSize, failures))
+               for ii in range(4)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    assert not failures
+
+    # Bad output arrays and regions
+    for badOut in [np.zeros(shape = (numRows, numCols), dtype = 'complex128'),
+                   np.zeros(shape = (numRows, numCols + 1), dtype = 'complex64'),
+                   np.zeros(shape = (numCols, numRows * 2),
+                            dtype = 'complex64').T[:numRows, :numCols]]:
+        try:
+            reader.read(badOut)
+            assert False
+        except ValueError:
+            pass
+    try:
+        reader.readRegion(numRows, 1, 0, 1)
+        assert False
+    except RuntimeError:
+        pass
+
+
+if __name__ == '__main__':
+    if len(sys.argv) != 2:
+        print('Usage: {0} <SICD pathname>'.format(sys.argv[0]))
+        sys.exit(1)
+
+    try:
+        testReader(sys.argv[1])
+    except AssertionError:
+        print('SICDReader read the wrong data. Test failed')
+        sys.exit(1)
+    print('Test passed')
+    sys.exit(0)
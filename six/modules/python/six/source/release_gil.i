@@ -0,0 +1,53 @@
+/* =========================================================================
+ * This file is part of six-python
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2020, MDA Information Systems LLC
+ *
+ * six-python is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * %include this (rather than %import it) into a module's interface file
+ * before any code that uses ReleaseGIL
+ */
+
+%{
+/*
+ * Releases the GIL for as long as it's in scope, so other Python threads
+ * can run while we're doing I/O.  Python objects can't be touched until
+ * it's destroyed.
+ */
+class ReleaseGIL
+{
+public:
+    ReleaseGIL() :
+        mState(PyEval_SaveThread())
+    {
+    }
+
+    ~ReleaseGIL()
+    {
+        PyEval_RestoreThread(mState);
+    }
+
+private:
+    ReleaseGIL(const ReleaseGIL&);
+    ReleaseGIL& operator=(const ReleaseGIL&);
+
+    PyThreadState* const mState;
+};
+%}
@@ -31,20 +31,20 @@ import utils
 from runner import PythonTestRunner
 
 
-def createSampleCPHD():
+def createSampleCPHD(module):
     programPathname = os.path.join(utils.installPath(), 'tests',
-            'cphd03', 'test_cphd_write_simple')
+            module, 'test_cphd_write_simple')
     if not os.path.exists(programPathname):
         programPathname += '.exe'
     if not os.path.exists(programPathname):
         raise IOError('Unable to find ' + programPathname)
-    cphd03Handle, cphd03Pathname = tempfile.mkstemp()
-    os.close(cphd03Handle)
-    os.remove(cphd03Pathname)
-    success = subprocess.check_call([programPathname, cphd03Pathname])
+    cphdHandle, cphdPathname = tempfile.mkstemp()
+    os.close(cphdHandle)
+    os.remove(cphdPathname)
+    success = subprocess.check_call([programPathname, cphdPathname])
     if success != 0:
         raise OSError('An error occured while executing ' + programPathname)
-    return cphd03Pathname
+    return cphdPathname
 
 
 def run():
@@ -64,6 +64,7 @@ def run():
     sicdRunner = PythonTestRunner(testsDir)
     result = (result and sicdRunner.run('test_streaming_sicd_write.py') and
         sicdRunner.run('test_read_region.py') and
+        sicdRunner.run('test_sicd_reader.py', sampleNITF) and
         sicdRunner.run('test_read_sicd_xml.py', sampleNITF) and
         sicdRunner.run('test_six_sicd.py', sampleNITF) and
         sicdRunner.run('test_create_sicd_xml.py', '-v', '1.2.0') and
@@ -71,7 +72,14 @@ def run():
         sicdRunner.run('test_read_complex_data.py', sampleNITF))
 
     # CPHD tests
-    cphd03Pathname = createSampleCPHD()
+    cphdPathname = createSampleCPHD('cphd')
+    testsDir = os.path.join(utils.findSixHome(), 'six',
+            'modules', 'python', 'cphd', 'tests')
+    cphdRunner = PythonTestRunner(testsDir)
+    result = result and cphdRunner.run('test_read_cphd.py', cphdPathname)
+    os.remove(cphdPathname)
+
+    cphd03Pathname = createSampleCPHD('cphd03')
     testsDir = os.path.join(utils.findSixHome(), 'six',
             'modules', 'python', 'cphd03', 'tests')
     cphd03Runner = PythonTestRunner(testsDir)